@@ -0,0 +1,143 @@
+#include "BenchFramework.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace library::bench
+{
+    namespace
+    {
+        constexpr const UINT MIN_RUNS = 5u;
+        constexpr const DOUBLE MIN_TOTAL_SECONDS = 0.5;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Benchmark
+
+          Summary:  Registered benchmark
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Benchmark
+        {
+            PCSTR pszName;
+            BenchmarkFunction pfnBenchmark;
+        };
+
+        // Function local so registrars of other translation units can
+        // run before main in any order
+        std::vector<Benchmark>& getBenchmarks()
+        {
+            static std::vector<Benchmark> s_aBenchmarks;
+            return s_aBenchmarks;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BenchmarkRegistrar::BenchmarkRegistrar
+
+      Summary:  Constructor. Registers the benchmark
+
+      Args:     PCSTR pszName
+                  Name of the benchmark, the filter of RunBenchmarks
+                  matches it
+                BenchmarkFunction pfnBenchmark
+                  Body of the benchmark
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BenchmarkRegistrar::BenchmarkRegistrar(_In_z_ PCSTR pszName, _In_ BenchmarkFunction pfnBenchmark)
+    {
+        getBenchmarks().push_back({ .pszName = pszName, .pfnBenchmark = pfnBenchmark });
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MeasureSeconds
+
+      Summary:  Runs the function once to warm the caches, then at
+                least MIN_RUNS times and for at least MIN_TOTAL_SECONDS,
+                and keeps the fastest run
+
+      Args:     const std::function<void()>& function
+                  Work to time
+
+      Returns:  DOUBLE
+                  Seconds of the fastest run
+    -----------------------------------------------------------------F-F*/
+    DOUBLE MeasureSeconds(_In_ const std::function<void()>& function)
+    {
+        function();
+
+        DOUBLE best = 0.0;
+        DOUBLE total = 0.0;
+        for (UINT uRun = 0u; uRun < MIN_RUNS || total < MIN_TOTAL_SECONDS; ++uRun)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            function();
+            DOUBLE seconds = std::chrono::duration<DOUBLE>(std::chrono::steady_clock::now() - start).count();
+
+            best = uRun == 0u ? seconds : std::min(best, seconds);
+            total += seconds;
+        }
+
+        return best;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ReportMeasurement
+
+      Summary:  Prints the time of a run and the throughput it implies,
+                scaled to the largest of k, M and G that keeps it above 1
+
+      Args:     PCSTR pszCase
+                  What was timed
+                DOUBLE seconds
+                  Seconds of the run
+                DOUBLE numItems
+                  Items processed by the run
+                PCSTR pszItems
+                  Name of the items, e.g. "vertices"
+    -----------------------------------------------------------------F-F*/
+    void ReportMeasurement(_In_z_ PCSTR pszCase, _In_ DOUBLE seconds, _In_ DOUBLE numItems, _In_z_ PCSTR pszItems)
+    {
+        constexpr const CHAR* PREFIXES[] = { "", "k", "M", "G" };
+
+        DOUBLE throughput = numItems / seconds;
+        UINT uPrefix = 0u;
+        while (throughput >= 1000.0 && uPrefix + 1u < ARRAYSIZE(PREFIXES))
+        {
+            throughput /= 1000.0;
+            ++uPrefix;
+        }
+
+        std::printf("  %-40s %10.3f ms %10.2f %s%s/s\n", pszCase, seconds * 1000.0, throughput, PREFIXES[uPrefix], pszItems);
+        std::fflush(stdout);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: RunBenchmarks
+
+      Summary:  Runs the registered benchmarks whose name contains the
+                filter
+
+      Args:     PCSTR pszFilter
+                  Part of the names of the benchmarks to run, nullptr
+                  runs every benchmark
+
+      Returns:  INT
+                  Number of benchmarks run
+    -----------------------------------------------------------------F-F*/
+    INT RunBenchmarks(_In_opt_z_ PCSTR pszFilter)
+    {
+        INT iNumRun = 0;
+        for (const Benchmark& benchmark : getBenchmarks())
+        {
+            if (pszFilter && !std::strstr(benchmark.pszName, pszFilter))
+            {
+                continue;
+            }
+
+            std::printf("%s\n", benchmark.pszName);
+            benchmark.pfnBenchmark();
+            ++iNumRun;
+        }
+        return iNumRun;
+    }
+}
@@ -0,0 +1,50 @@
+/*+===================================================================
+  File:      BENCHFRAMEWORK.H
+
+  Summary:   BenchFramework header file contains the macro that
+             registers the benchmarks of the library, and declarations
+             of the functions that time, report and run them.
+
+  Classes: BenchmarkRegistrar
+
+  Functions: MeasureSeconds, ReportMeasurement, RunBenchmarks
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <functional>
+
+namespace library::bench
+{
+    using BenchmarkFunction = void (*)();
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BenchmarkRegistrar
+
+      Summary:  Adds a benchmark to the list RunBenchmarks goes
+                through. One static instance per benchmark, created by
+                BENCHMARK
+
+      Methods:  BenchmarkRegistrar
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BenchmarkRegistrar final
+    {
+    public:
+        BenchmarkRegistrar(_In_z_ PCSTR pszName, _In_ BenchmarkFunction pfnBenchmark);
+    };
+
+    DOUBLE MeasureSeconds(_In_ const std::function<void()>& function);
+    void ReportMeasurement(_In_z_ PCSTR pszCase, _In_ DOUBLE seconds, _In_ DOUBLE numItems, _In_z_ PCSTR pszItems);
+
+    INT RunBenchmarks(_In_opt_z_ PCSTR pszFilter);
+}
+
+// Defines and registers a benchmark, the body follows the macro
+#define BENCHMARK(Name) \
+    static void Name(); \
+    static const ::library::bench::BenchmarkRegistrar s_##Name##Registrar(#Name, Name); \
+    static void Name()
@@ -0,0 +1,40 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Runs the benchmarks of the library. Build in Release,
+             every benchmark reports the fastest of several runs
+
+  Usage:     Bench [name filter]
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <cstdio>
+#include <thread>
+
+#include "BenchFramework.h"
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Entry point of the benchmarks. Runs every benchmark, or the
+            ones whose name contains the first argument
+
+  Args:     INT argc
+              Number of arguments
+            CHAR* argv[]
+              Arguments
+
+  Returns:  INT
+              0 if a benchmark ran, 1 if the filter matched none
+-----------------------------------------------------------------F-F*/
+INT main(_In_ INT argc, _In_reads_(argc) CHAR* argv[])
+{
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+
+    INT iNumRun = library::bench::RunBenchmarks(argc > 1 ? argv[1] : nullptr);
+
+    return iNumRun > 0 ? 0 : 1;
+}
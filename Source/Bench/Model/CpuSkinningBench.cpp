@@ -0,0 +1,87 @@
+#include "BenchFramework.h"
+
+#include "Model/BoneWeights.h"
+#include "Model/CpuSkinning.h"
+#include "Utility/ThreadPool.h"
+
+#include <random>
+
+namespace library
+{
+    // Skins a 250k vertex mesh with four influences per vertex and all
+    // output streams, the scalar reference against the SIMD kernel
+    BENCHMARK(CpuSkinning)
+    {
+        const UINT uNumVertices = 250000u;
+        const UINT uNumBones = 128u;
+
+        std::mt19937 generator(27u);
+        std::uniform_real_distribution<FLOAT> unitDistribution(-1.0f, 1.0f);
+        std::uniform_int_distribution<UINT> boneDistribution(0u, uNumBones - 1u);
+
+        std::vector<XMMATRIX> aBoneTransforms;
+        for (UINT i = 0u; i < uNumBones; ++i)
+        {
+            XMVECTOR rotation = XMQuaternionNormalize(XMVectorSet(unitDistribution(generator), unitDistribution(generator), unitDistribution(generator), 1.5f));
+            aBoneTransforms.push_back(XMMatrixAffineTransformation(XMVectorReplicate(1.0f), g_XMZero, rotation, XMVectorSet(unitDistribution(generator), 0.0f, 0.0f, 0.0f)));
+        }
+
+        std::vector<SimpleVertex> aVertices(uNumVertices);
+        std::vector<NormalData> aNormalData(uNumVertices);
+        std::vector<AnimationData> aAnimationData(uNumVertices);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aVertices[i].Position = XMFLOAT3(unitDistribution(generator), unitDistribution(generator), unitDistribution(generator));
+            aVertices[i].Normal = XMFLOAT3(0.0f, 0.0f, 1.0f);
+            aNormalData[i].Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+            UINT aBoneIds[NUM_BONE_INFLUENCES];
+            FLOAT aWeights[NUM_BONE_INFLUENCES];
+            for (UINT j = 0u; j < NUM_BONE_INFLUENCES; ++j)
+            {
+                aBoneIds[j] = boneDistribution(generator);
+                aWeights[j] = unitDistribution(generator) + 1.0f;
+            }
+            aAnimationData[i] = PackBoneWeights(aBoneIds, aWeights, NUM_BONE_INFLUENCES);
+        }
+
+        std::vector<FLOAT> aOutput(uNumVertices * 9u);
+        SkinnedVertexStreams streams = {};
+        FLOAT** aStreams[] =
+        {
+            &streams.aPositionX, &streams.aPositionY, &streams.aPositionZ,
+            &streams.aNormalX, &streams.aNormalY, &streams.aNormalZ,
+            &streams.aTangentX, &streams.aTangentY, &streams.aTangentZ
+        };
+        for (UINT i = 0u; i < 9u; ++i)
+        {
+            *aStreams[i] = aOutput.data() + static_cast<SIZE_T>(i) * uNumVertices;
+        }
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                SkinVerticesReference(aVertices.data(), aNormalData.data(), aAnimationData.data(), uNumVertices, aBoneTransforms.data(), uNumBones, streams);
+            }
+        );
+        bench::ReportMeasurement("scalar reference", seconds, uNumVertices, "vertices");
+
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                SkinVertices(aVertices.data(), aNormalData.data(), aAnimationData.data(), uNumVertices, aBoneTransforms.data(), uNumBones, streams, nullptr);
+            }
+        );
+        bench::ReportMeasurement("SIMD, calling thread", seconds, uNumVertices, "vertices");
+
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                SkinVertices(aVertices.data(), aNormalData.data(), aAnimationData.data(), uNumVertices, aBoneTransforms.data(), uNumBones, streams, &threadPool);
+            }
+        );
+        bench::ReportMeasurement("SIMD, thread pool", seconds, uNumVertices, "vertices");
+    }
+}
@@ -0,0 +1,59 @@
+#include "BenchFramework.h"
+
+#include "Model/Model.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace library
+{
+    namespace
+    {
+        // Relative to Source/Bench, the working directory of the project
+        constexpr const WCHAR CYBORG_PATH[] = L"../Game/Content/cyborg/cyborg.obj";
+
+        // Imports a new model each run, like a fresh launch of the game
+        HRESULT importCyborg(_Out_opt_ UINT* puNumVertices)
+        {
+            Model model(CYBORG_PATH);
+            HRESULT hr = model.Import();
+            if (puNumVertices)
+            {
+                *puNumVertices = model.GetNumVertices();
+            }
+            return hr;
+        }
+    }
+
+    // Loads cyborg.obj cold through Assimp, which also writes the cooked
+    // mesh, and warm from the memory mapped cooked mesh. Both include
+    // reading the texture files
+    BENCHMARK(MeshCache)
+    {
+        std::filesystem::path cookedMeshPath = Model(CYBORG_PATH).GetCookedMeshPath();
+
+        UINT uNumVertices = 0u;
+        if (FAILED(importCyborg(&uNumVertices)))
+        {
+            std::printf("  could not import %ls, run from Source/Bench\n", CYBORG_PATH);
+            return;
+        }
+
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                std::filesystem::remove(cookedMeshPath);
+                importCyborg(nullptr);
+            }
+        );
+        bench::ReportMeasurement("cold, Assimp and cook", seconds, uNumVertices, "vertices");
+
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                importCyborg(nullptr);
+            }
+        );
+        bench::ReportMeasurement("warm, cooked mesh", seconds, uNumVertices, "vertices");
+    }
+}
@@ -0,0 +1,96 @@
+#include "BenchFramework.h"
+
+#include "Model/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // A grid of uSize x uSize quads with its triangles in the order
+        // given, shuffled or row by row
+        void createGrid(_In_ UINT uSize, _In_ BOOL bShuffle, _Out_ std::vector<XMFLOAT3>& outPositions, _Out_ std::vector<UINT>& outIndices)
+        {
+            outPositions.clear();
+            outIndices.clear();
+            for (UINT z = 0u; z <= uSize; ++z)
+            {
+                for (UINT x = 0u; x <= uSize; ++x)
+                {
+                    outPositions.push_back(XMFLOAT3(static_cast<FLOAT>(x), std::sin(static_cast<FLOAT>(x + z) * 0.1f), static_cast<FLOAT>(z)));
+                }
+            }
+
+            std::vector<std::array<UINT, 3>> aTriangles;
+            for (UINT z = 0u; z < uSize; ++z)
+            {
+                for (UINT x = 0u; x < uSize; ++x)
+                {
+                    UINT uCorner = z * (uSize + 1u) + x;
+                    aTriangles.push_back({ uCorner, uCorner + uSize + 1u, uCorner + 1u });
+                    aTriangles.push_back({ uCorner + 1u, uCorner + uSize + 1u, uCorner + uSize + 2u });
+                }
+            }
+            if (bShuffle)
+            {
+                std::shuffle(aTriangles.begin(), aTriangles.end(), std::mt19937(30u));
+            }
+            for (const std::array<UINT, 3>& triangle : aTriangles)
+            {
+                outIndices.insert(outIndices.end(), triangle.begin(), triangle.end());
+            }
+        }
+    }
+
+    // Runs the import pipeline, vertex cache then overdraw then vertex
+    // fetch, on a 256x256 quad grid with shuffled and with row by row
+    // triangles, and prints the ACMR and ATVR of a 16 entry FIFO before
+    // and after. Throughput counts triangles
+    BENCHMARK(MeshOptimizer)
+    {
+        const UINT uGridSize = 256u;
+
+        for (BOOL bShuffle : { TRUE, FALSE })
+        {
+            std::vector<XMFLOAT3> aPositions;
+            std::vector<UINT> aIndices;
+            createGrid(uGridSize, bShuffle, aPositions, aIndices);
+            const UINT uNumVertices = static_cast<UINT>(aPositions.size());
+            const UINT uNumIndices = static_cast<UINT>(aIndices.size());
+
+            std::vector<UINT> aCacheIndices(uNumIndices);
+            std::vector<UINT> aOutIndices(uNumIndices);
+            std::vector<UINT> aClusters;
+            std::vector<UINT> aRemap;
+            DOUBLE seconds = bench::MeasureSeconds(
+                [&]()
+                {
+                    OptimizeVertexCache(aIndices.data(), uNumIndices, uNumVertices, VERTEX_CACHE_SIZE, aCacheIndices.data(), &aClusters);
+                    OptimizeOverdraw(
+                        aCacheIndices.data(),
+                        uNumIndices,
+                        aPositions.data(),
+                        sizeof(XMFLOAT3),
+                        uNumVertices,
+                        aClusters,
+                        VERTEX_CACHE_SIZE,
+                        OVERDRAW_THRESHOLD,
+                        aOutIndices.data()
+                    );
+                    OptimizeVertexFetch(aOutIndices.data(), uNumIndices, uNumVertices, aRemap);
+                }
+            );
+
+            PCSTR pszOrder = bShuffle ? "shuffled" : "row by row";
+            bench::ReportMeasurement(pszOrder, seconds, uNumIndices / 3u, "triangles");
+
+            VertexCacheStats before = AnalyzeVertexCache(aIndices.data(), uNumIndices, uNumVertices, VERTEX_CACHE_SIZE);
+            VertexCacheStats after = AnalyzeVertexCache(aOutIndices.data(), uNumIndices, uNumVertices, VERTEX_CACHE_SIZE);
+            std::printf("    ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", before.Acmr, after.Acmr, before.Atvr, after.Atvr);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "BenchFramework.h"
+
+#include "Model/Meshlet.h"
+
+#include <cstdio>
+
+namespace library
+{
+    namespace
+    {
+        // Closed unit sphere with outward facing triangles
+        void createSphere(_In_ UINT uSlices, _In_ UINT uStacks, _Out_ std::vector<XMFLOAT3>& outPositions, _Out_ std::vector<UINT>& outIndices)
+        {
+            outPositions.clear();
+            outIndices.clear();
+            for (UINT uStack = 0u; uStack <= uStacks; ++uStack)
+            {
+                FLOAT phi = XM_PI * static_cast<FLOAT>(uStack) / static_cast<FLOAT>(uStacks);
+                for (UINT uSlice = 0u; uSlice <= uSlices; ++uSlice)
+                {
+                    FLOAT theta = XM_2PI * static_cast<FLOAT>(uSlice) / static_cast<FLOAT>(uSlices);
+                    outPositions.push_back(XMFLOAT3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)));
+                }
+            }
+            for (UINT uStack = 0u; uStack < uStacks; ++uStack)
+            {
+                for (UINT uSlice = 0u; uSlice < uSlices; ++uSlice)
+                {
+                    UINT uCorner = uStack * (uSlices + 1u) + uSlice;
+                    outIndices.insert(outIndices.end(), { uCorner, uCorner + 1u, uCorner + uSlices + 1u });
+                    outIndices.insert(outIndices.end(), { uCorner + 1u, uCorner + uSlices + 2u, uCorner + uSlices + 1u });
+                }
+            }
+        }
+    }
+
+    // Culls the meshlets of a 256x256 unit sphere the way
+    // Model::CullMeshlets does, with the whole sphere in view, with half
+    // of it off screen, and from close up where most of it is outside
+    // the frustum. Throughput counts meshlets, and the share of
+    // triangles rejected by the frustum and the cone test is printed
+    BENCHMARK(MeshletCull)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createSphere(256u, 256u, aPositions, aIndices);
+
+        std::vector<UINT> aMeshletIndices(aIndices.size());
+        std::vector<Meshlet> aMeshlets;
+        BuildMeshlets(
+            aIndices.data(),
+            static_cast<UINT>(aIndices.size()),
+            aPositions.data(),
+            sizeof(XMFLOAT3),
+            static_cast<UINT>(aPositions.size()),
+            aMeshletIndices.data(),
+            aMeshlets
+        );
+        const UINT uNumMeshlets = static_cast<UINT>(aMeshlets.size());
+        const XMMATRIX projection = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.01f, 100.0f);
+        const XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+        struct ViewCase
+        {
+            PCSTR pszName;
+            XMFLOAT3 Eye;
+            XMFLOAT3 At;
+        };
+        const ViewCase aCases[] =
+        {
+            { "whole sphere in view", XMFLOAT3(0.0f, 0.5f, -2.5f), XMFLOAT3(0.0f, 0.0f, 0.0f) },
+            { "half off screen", XMFLOAT3(0.0f, 0.5f, -2.5f), XMFLOAT3(1.5f, 0.0f, 0.0f) },
+            { "close up", XMFLOAT3(0.0f, 0.0f, -1.2f), XMFLOAT3(0.0f, 0.0f, 0.0f) },
+        };
+        for (const ViewCase& viewCase : aCases)
+        {
+            XMVECTOR eye = XMLoadFloat3(&viewCase.Eye);
+            XMVECTOR aPlanes[6];
+            ComputeFrustumPlanes(XMMatrixLookAtLH(eye, XMLoadFloat3(&viewCase.At), up) * projection, aPlanes);
+
+            UINT uNumTriangles = 0u;
+            UINT uNumCulledTriangles = 0u;
+            UINT uNumCulledMeshlets = 0u;
+            DOUBLE seconds = bench::MeasureSeconds(
+                [&]()
+                {
+                    uNumTriangles = 0u;
+                    uNumCulledTriangles = 0u;
+                    uNumCulledMeshlets = 0u;
+                    for (const Meshlet& meshlet : aMeshlets)
+                    {
+                        uNumTriangles += meshlet.uNumIndices / 3u;
+                        if (!IsMeshletVisible(meshlet, aPlanes, eye, TRUE))
+                        {
+                            ++uNumCulledMeshlets;
+                            uNumCulledTriangles += meshlet.uNumIndices / 3u;
+                        }
+                    }
+                }
+            );
+
+            bench::ReportMeasurement(viewCase.pszName, seconds, uNumMeshlets, "meshlets");
+            std::printf(
+                "    %u of %u meshlets culled, %.1f%% of triangles rejected\n",
+                uNumCulledMeshlets,
+                uNumMeshlets,
+                100.0 * static_cast<DOUBLE>(uNumCulledTriangles) / static_cast<DOUBLE>(uNumTriangles)
+            );
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include "BenchFramework.h"
+
+#include "Model/Model.h"
+#include "Utility/ThreadPool.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT NUM_IMPORTED_MODELS = 8u;
+
+        // Relative to Source/Bench, the working directory of the project
+        constexpr const PCWSTR MODEL_DIRECTORIES[] = { L"../Game/Content/cyborg", L"../Game/Content/Common" };
+        constexpr const PCWSTR MODEL_FILES[] = { L"cyborg.obj", L"Sphere.obj" };
+
+        // Copies the model directories once per imported model, so every
+        // model has its own cooked mesh and no import can reuse another's
+        HRESULT copyModels(_In_ const std::filesystem::path& directory, _Out_ std::vector<std::filesystem::path>& outModelPaths)
+        {
+            outModelPaths.clear();
+            for (UINT i = 0u; i < NUM_IMPORTED_MODELS; ++i)
+            {
+                UINT uSource = i % ARRAYSIZE(MODEL_DIRECTORIES);
+                std::filesystem::path copyDirectory = directory / std::to_wstring(i);
+
+                std::error_code error;
+                std::filesystem::create_directories(copyDirectory, error);
+                std::filesystem::copy(MODEL_DIRECTORIES[uSource], copyDirectory, std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, error);
+                if (error)
+                {
+                    return E_FAIL;
+                }
+                outModelPaths.push_back(copyDirectory / MODEL_FILES[uSource]);
+            }
+
+            return S_OK;
+        }
+
+        HRESULT importModel(_In_ const std::filesystem::path& modelPath)
+        {
+            Model model(modelPath);
+            std::filesystem::remove(model.GetCookedMeshPath());
+            return model.Import();
+        }
+    }
+
+    // Imports 8 models, alternating cyborg.obj and Sphere.obj, with
+    // Assimp each time: one after another as with the single static
+    // importer, and at once on the pool with an importer per thread
+    BENCHMARK(ModelImport)
+    {
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(error) / L"ModelImportBench";
+        std::filesystem::remove_all(directory, error);
+
+        std::vector<std::filesystem::path> aModelPaths;
+        if (FAILED(copyModels(directory, aModelPaths)))
+        {
+            std::printf("  could not copy the models, run from Source/Bench\n");
+            return;
+        }
+
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                for (const std::filesystem::path& modelPath : aModelPaths)
+                {
+                    importModel(modelPath);
+                }
+            }
+        );
+        bench::ReportMeasurement("serial", seconds, NUM_IMPORTED_MODELS, "models");
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                threadPool.ParallelFor(
+                    NUM_IMPORTED_MODELS,
+                    1u,
+                    [&](UINT uBegin, UINT uEnd)
+                    {
+                        for (UINT i = uBegin; i < uEnd; ++i)
+                        {
+                            importModel(aModelPaths[i]);
+                        }
+                    }
+                );
+            }
+        );
+        bench::ReportMeasurement("thread pool", seconds, NUM_IMPORTED_MODELS, "models");
+
+        std::filesystem::remove_all(directory, error);
+    }
+}
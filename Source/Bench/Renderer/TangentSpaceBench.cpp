@@ -0,0 +1,122 @@
+#include "BenchFramework.h"
+
+#include "Renderer/TangentSpace.h"
+#include "Utility/ThreadPool.h"
+
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        // Copy of Renderable::calculateTangentBitangent before the tangent
+        // frames moved to TangentSpace
+        void calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& outTangent, _Out_ XMFLOAT3& outBitangent)
+        {
+            XMFLOAT3 vector1(v2.Position.x - v1.Position.x, v2.Position.y - v1.Position.y, v2.Position.z - v1.Position.z);
+            XMFLOAT3 vector2(v3.Position.x - v1.Position.x, v3.Position.y - v1.Position.y, v3.Position.z - v1.Position.z);
+            XMFLOAT2 tuVector(v2.TexCoord.x - v1.TexCoord.x, v3.TexCoord.x - v1.TexCoord.x);
+            XMFLOAT2 tvVector(v2.TexCoord.y - v1.TexCoord.y, v3.TexCoord.y - v1.TexCoord.y);
+
+            FLOAT den = 1.0f / (tuVector.x * tvVector.y - tuVector.y * tvVector.x);
+
+            outTangent = XMFLOAT3(
+                (tvVector.y * vector1.x - tvVector.x * vector2.x) * den,
+                (tvVector.y * vector1.y - tvVector.x * vector2.y) * den,
+                (tvVector.y * vector1.z - tvVector.x * vector2.z) * den
+            );
+            outBitangent = XMFLOAT3(
+                (tuVector.x * vector2.x - tuVector.y * vector1.x) * den,
+                (tuVector.x * vector2.y - tuVector.y * vector1.y) * den,
+                (tuVector.x * vector2.z - tuVector.y * vector1.z) * den
+            );
+
+            FLOAT length = std::sqrt(outTangent.x * outTangent.x + outTangent.y * outTangent.y + outTangent.z * outTangent.z);
+            outTangent = XMFLOAT3(outTangent.x / length, outTangent.y / length, outTangent.z / length);
+
+            length = std::sqrt(outBitangent.x * outBitangent.x + outBitangent.y * outBitangent.y + outBitangent.z * outBitangent.z);
+            outBitangent = XMFLOAT3(outBitangent.x / length, outBitangent.y / length, outBitangent.z / length);
+        }
+
+        // Copy of Renderable::calculateNormalMapVectors, every face
+        // overwrites the frames of its three vertices
+        void calculateNormalMapVectors(_In_ const SimpleVertex* aVertices, _In_ const WORD* aIndices, _In_ UINT uNumIndices, _Out_ NormalData* aOutNormalData)
+        {
+            for (UINT i = 0u; i < uNumIndices / 3u; ++i)
+            {
+                XMFLOAT3 tangent;
+                XMFLOAT3 bitangent;
+                calculateTangentBitangent(aVertices[aIndices[i * 3u]], aVertices[aIndices[i * 3u + 1u]], aVertices[aIndices[i * 3u + 2u]], tangent, bitangent);
+
+                for (UINT k = 0u; k < 3u; ++k)
+                {
+                    aOutNormalData[aIndices[i * 3u + k]].Tangent = tangent;
+                    aOutNormalData[aIndices[i * 3u + k]].Bitangent = bitangent;
+                }
+            }
+        }
+    }
+
+    // Tangent frames of a 65k vertex sphere, the largest a WORD index
+    // buffer allows: the old per face overwrite, the angle weighted
+    // accumulation on the calling thread and on the pool
+    BENCHMARK(TangentFrames)
+    {
+        const UINT uSlices = 255u;
+        const UINT uStacks = 254u;
+
+        std::vector<SimpleVertex> aVertices;
+        for (UINT uStack = 0u; uStack <= uStacks; ++uStack)
+        {
+            FLOAT v = static_cast<FLOAT>(uStack) / static_cast<FLOAT>(uStacks);
+            for (UINT uSlice = 0u; uSlice <= uSlices; ++uSlice)
+            {
+                FLOAT u = static_cast<FLOAT>(uSlice) / static_cast<FLOAT>(uSlices);
+                XMFLOAT3 position(std::sin(XM_PI * v) * std::cos(XM_2PI * u), std::cos(XM_PI * v), std::sin(XM_PI * v) * std::sin(XM_2PI * u));
+                aVertices.push_back({ .Position = position, .TexCoord = XMFLOAT2(u, v), .Normal = position });
+            }
+        }
+
+        // Skips the pole rows, whose faces have no area
+        std::vector<WORD> aIndices;
+        for (UINT uStack = 1u; uStack < uStacks - 1u; ++uStack)
+        {
+            for (UINT uSlice = 0u; uSlice < uSlices; ++uSlice)
+            {
+                WORD uCorner = static_cast<WORD>(uStack * (uSlices + 1u) + uSlice);
+                WORD uBelow = static_cast<WORD>(uCorner + uSlices + 1u);
+                aIndices.insert(aIndices.end(), { uCorner, static_cast<WORD>(uCorner + 1u), uBelow });
+                aIndices.insert(aIndices.end(), { static_cast<WORD>(uCorner + 1u), static_cast<WORD>(uBelow + 1u), uBelow });
+            }
+        }
+
+        const UINT uNumVertices = static_cast<UINT>(aVertices.size());
+        const UINT uNumIndices = static_cast<UINT>(aIndices.size());
+        std::vector<NormalData> aNormalData(uNumVertices);
+
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                calculateNormalMapVectors(aVertices.data(), aIndices.data(), uNumIndices, aNormalData.data());
+            }
+        );
+        bench::ReportMeasurement("per face overwrite", seconds, uNumVertices, "vertices");
+
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                CalculateTangentFrames(aVertices.data(), uNumVertices, aIndices.data(), uNumIndices, aNormalData.data(), nullptr);
+            }
+        );
+        bench::ReportMeasurement("angle weighted, calling thread", seconds, uNumVertices, "vertices");
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                CalculateTangentFrames(aVertices.data(), uNumVertices, aIndices.data(), uNumIndices, aNormalData.data(), &threadPool);
+            }
+        );
+        bench::ReportMeasurement("angle weighted, thread pool", seconds, uNumVertices, "vertices");
+    }
+}
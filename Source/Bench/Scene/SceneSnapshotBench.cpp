@@ -0,0 +1,218 @@
+#include "BenchFramework.h"
+
+#include "Light/PointLight.h"
+#include "Model/Model.h"
+#include "Scene/Scene.h"
+#include "Scene/SceneSnapshot.h"
+#include "Shader/PixelShader.h"
+#include "Shader/ShaderPermutation.h"
+#include "Shader/VertexShader.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT MAP_SIZE = 64u;
+
+        // Relative to Source/Bench, the working directory of the project
+        constexpr const PCWSTR MODEL_DIRECTORY = L"../Game/Content/cyborg";
+        constexpr const PCWSTR PHONG_SHADER_PATH = L"../Game/Shaders/PhongShaders.fxh";
+        constexpr const PCWSTR VOXEL_SHADER_PATH = L"../Game/Shaders/VoxelShaders.fxh";
+
+        // Writes a MAP_SIZE x MAP_SIZE height map in the format of the
+        // game's, one block type per height band
+        HRESULT writeHeightMap(_In_ const std::filesystem::path& filePath)
+        {
+            std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return E_FAIL;
+            }
+
+            const UINT uNumColors = static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND);
+            file << MAP_SIZE << ' ' << MAP_SIZE << ' ' << MAP_SIZE << ' ' << uNumColors << '\n';
+            for (UINT i = 0u; i < uNumColors; ++i)
+            {
+                file << 0.5f << ' ' << 0.5f << ' ' << 0.5f << '\n';
+            }
+
+            for (UINT z = 0u; z < MAP_SIZE; ++z)
+            {
+                for (UINT x = 0u; x < MAP_SIZE; ++x)
+                {
+                    FLOAT height = Scene::GetPerlin2d(static_cast<FLOAT>(x), static_cast<FLOAT>(z), 0.1f, 4u);
+
+                    eBlockType blockType = eBlockType::SNOW;
+                    if (height < 0.3f)
+                    {
+                        blockType = eBlockType::OCEAN;
+                    }
+                    else if (height < 0.4f)
+                    {
+                        blockType = eBlockType::SAND;
+                    }
+                    else if (height < 0.7f)
+                    {
+                        blockType = eBlockType::GRASSLAND;
+                    }
+
+                    file << static_cast<CHAR>(blockType) << height << ' ';
+                }
+                file << '\n';
+            }
+            file << std::endl;
+
+            return file.good() ? S_OK : E_FAIL;
+        }
+
+        // Builds the scene as the game does, with shaders and a model of
+        // its own so nothing is shared between runs, and initializes it
+        HRESULT loadScene(
+            _In_ const std::filesystem::path& directory,
+            _In_ BOOL bUseSnapshot,
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext
+        )
+        {
+            Scene scene(directory / L"HeightMap.txt", bUseSnapshot);
+
+            HRESULT hr = scene.AddVertexShader(L"PhongShader", std::make_shared<VertexShader>(PHONG_SHADER_PATH, "VSPhong", "vs_5_0"));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.AddPixelShader(L"PhongShader", std::make_shared<PixelShader>(PHONG_SHADER_PATH, "PSPhong", "ps_5_0"));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.AddVertexShader(L"VoxelShader", std::make_shared<VertexShader>(VOXEL_SHADER_PATH, "VSVoxel", "vs_5_0", SHADER_FEATURE_NORMAL_MAP));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.AddPixelShader(L"VoxelShader", std::make_shared<PixelShader>(VOXEL_SHADER_PATH, "PSVoxel", "ps_5_0", SHADER_FEATURE_NORMAL_MAP));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.SetVertexShaderOfVoxel(L"VoxelShader");
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.SetPixelShaderOfVoxel(L"VoxelShader");
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.AddModel(L"Cyborg", std::make_shared<Model>(directory / L"cyborg" / L"cyborg.obj"));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.SetVertexShaderOfModel(L"Cyborg", L"PhongShader");
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.SetPixelShaderOfModel(L"Cyborg", L"PhongShader");
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.AddPointLight(0u, std::make_shared<PointLight>(XMFLOAT4(0.0f, 30.0f, 0.0f, 1.0f), XMFLOAT4(1.0f, 0.647f, 0.0f, 1.0f), 20.0f));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = scene.AddPointLight(1u, std::make_shared<PointLight>(XMFLOAT4(0.0f, 300.0f, 0.0f, 1.0f), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), 100.0f));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            return scene.Initialize(pDevice, pImmediateContext);
+        }
+    }
+
+    // Starts a scene with a 64x64 height map, the Phong and voxel
+    // shaders and the cyborg model on a device that draws nothing: cold,
+    // as with "-nosnapshot", and from the snapshot the first run wrote.
+    // The cold start still hits the shader and mesh caches, so the gap
+    // is what the snapshot saves over an already cooked tree
+    BENCHMARK(SnapshotStartup)
+    {
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(error) / L"SceneSnapshotBench";
+        std::filesystem::remove_all(directory, error);
+        std::filesystem::create_directories(directory / L"cyborg", error);
+        std::filesystem::copy(MODEL_DIRECTORY, directory / L"cyborg", std::filesystem::copy_options::recursive, error);
+        if (error || FAILED(writeHeightMap(directory / L"HeightMap.txt")))
+        {
+            std::printf("  could not write the scene, run from Source/Bench\n");
+            return;
+        }
+
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE_NULL,
+            nullptr,
+            0u,
+            nullptr,
+            0u,
+            D3D11_SDK_VERSION,
+            device.GetAddressOf(),
+            nullptr,
+            immediateContext.GetAddressOf()
+        );
+        if (FAILED(hr))
+        {
+            std::printf("  could not create a null device\n");
+            return;
+        }
+
+        const DOUBLE numColumns = static_cast<DOUBLE>(MAP_SIZE) * MAP_SIZE;
+        for (BOOL bUseSnapshot : { FALSE, TRUE })
+        {
+            hr = S_OK;
+            DOUBLE seconds = bench::MeasureSeconds(
+                [&]()
+                {
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = loadScene(directory, bUseSnapshot, device.Get(), immediateContext.Get());
+                    }
+                }
+            );
+            if (FAILED(hr))
+            {
+                std::printf("  the scene failed to load, 0x%08lX\n", static_cast<ULONG>(hr));
+                return;
+            }
+
+            bench::ReportMeasurement(bUseSnapshot ? "snapshot" : "cold", seconds, numColumns, "columns");
+        }
+
+        if (!std::filesystem::exists(GetSceneSnapshotPath(directory / L"HeightMap.txt")))
+        {
+            std::printf("  no snapshot was written, every run loaded cold\n");
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "BenchFramework.h"
+
+#include "Scene/TransformHierarchy.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+namespace library
+{
+    // Updates a 100k node hierarchy with four children per node: all of
+    // it on the calling thread and on the pool, one 341 node subtree,
+    // and with nothing dirty. Throughput counts all the nodes
+    BENCHMARK(TransformHierarchyUpdate)
+    {
+        constexpr const UINT NUM_NODES = 100000u;
+        constexpr const UINT NUM_CHILDREN = 4u;
+
+        TransformHierarchy hierarchy;
+        for (UINT i = 0u; i < NUM_NODES; ++i)
+        {
+            UINT uNode = hierarchy.AddNode(i == 0u ? TransformHierarchy::INVALID_NODE : static_cast<INT>((i - 1u) / NUM_CHILDREN));
+            hierarchy.SetTranslation(uNode, XMFLOAT3(1.0f, 0.0f, 0.0f));
+            hierarchy.SetRotation(uNode, XMFLOAT4(0.0f, 0.0998f, 0.0f, 0.995f));
+        }
+        hierarchy.Update();
+
+        // Node 341 is at depth 5, its subtree holds 341 nodes
+        const UINT uSubtreeRoot = std::min(341u, NUM_NODES - 1u);
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        struct UpdateCase
+        {
+            PCSTR pszName;
+            UINT uDirtyNode;
+            ThreadPool* pThreadPool;
+        };
+        const UpdateCase aCases[] =
+        {
+            { "all, calling thread", 0u, nullptr },
+            { "all, thread pool", 0u, &threadPool },
+            { "one subtree", uSubtreeRoot, &threadPool },
+            { "nothing dirty", UINT_MAX, &threadPool },
+        };
+        for (const UpdateCase& updateCase : aCases)
+        {
+            DOUBLE seconds = bench::MeasureSeconds(
+                [&]()
+                {
+                    if (updateCase.uDirtyNode < NUM_NODES)
+                    {
+                        hierarchy.SetScale(updateCase.uDirtyNode, XMFLOAT3(1.0f, 1.0f, 1.0f));
+                    }
+                    hierarchy.Update(updateCase.pThreadPool);
+                }
+            );
+
+            CHAR szCase[64];
+            std::snprintf(szCase, ARRAYSIZE(szCase), "%s, %u updated", updateCase.pszName, hierarchy.GetNumUpdatedNodes());
+            bench::ReportMeasurement(szCase, seconds, NUM_NODES, "nodes");
+        }
+    }
+}
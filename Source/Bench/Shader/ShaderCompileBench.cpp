@@ -0,0 +1,135 @@
+#include "BenchFramework.h"
+
+#include "Shader/ShaderCompiler.h"
+#include "Shader/ShaderPermutation.h"
+#include "Utility/ThreadPool.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace library
+{
+    namespace
+    {
+        // Relative to Source/Bench, the working directory of the project
+        constexpr const PCWSTR SHADER_MANIFEST_PATH = L"../Game/Shaders/Shaders.txt";
+
+        // Reads the variants the game compiles, the way ShaderCooker does
+        // but without its diagnostics
+        std::vector<ShaderCompileDesc> readManifest(_In_ const std::filesystem::path& manifestPath)
+        {
+            std::vector<ShaderCompileDesc> aDescs;
+            std::ifstream manifestFile(manifestPath);
+            std::string szLine;
+            while (std::getline(manifestFile, szLine))
+            {
+                std::istringstream lineStream(szLine);
+                ShaderCompileDesc desc =
+                {
+                    .FilePath = std::filesystem::path(),
+                    .szEntryPoint = std::string(),
+                    .szTarget = std::string(),
+                    .aDefines = std::vector<ShaderDefine>(),
+                    .uFlags = GetDefaultShaderCompileFlags()
+                };
+                std::string szFileName;
+                if (!(lineStream >> szFileName) || szFileName.starts_with('#') || !(lineStream >> desc.szEntryPoint >> desc.szTarget))
+                {
+                    continue;
+                }
+                desc.FilePath = manifestPath.parent_path() / szFileName;
+
+                UINT uVariantKey = 0u;
+                std::vector<ShaderDefine> aExtraDefines;
+                std::string szDefine;
+                while (lineStream >> szDefine)
+                {
+                    SIZE_T uEquals = szDefine.find('=');
+                    UINT uFeature = uEquals == std::string::npos ? GetShaderVariantKeyFromName(szDefine) : 0u;
+                    if (uFeature != 0u)
+                    {
+                        uVariantKey |= uFeature;
+                        continue;
+                    }
+                    aExtraDefines.push_back({ .szName = szDefine.substr(0u, uEquals), .szValue = uEquals == std::string::npos ? "1" : szDefine.substr(uEquals + 1u) });
+                }
+                desc.aDefines = GetShaderVariantDefines(uVariantKey);
+                desc.aDefines.insert(desc.aDefines.end(), aExtraDefines.begin(), aExtraDefines.end());
+                aDescs.push_back(std::move(desc));
+            }
+
+            return aDescs;
+        }
+
+        // Compiles the given variants, keeping the messages of each apart
+        // so the failures can be reported together as the scene does
+        UINT compile(_In_ const std::vector<ShaderCompileDesc>& aDescs, _In_ UINT uBegin, _In_ UINT uEnd, _Inout_ std::vector<std::string>& aMessages)
+        {
+            D3DShaderCompiler compiler;
+            UINT uNumFailed = 0u;
+            for (UINT i = uBegin; i < uEnd; ++i)
+            {
+                std::vector<BYTE> aBytecode;
+                std::vector<std::filesystem::path> aIncludes;
+                if (FAILED(compiler.Compile(aDescs[i], aBytecode, aIncludes, aMessages[i])))
+                {
+                    ++uNumFailed;
+                }
+            }
+
+            return uNumFailed;
+        }
+    }
+
+    // Compiles every shader variant of the game's manifest with the D3D
+    // compiler, bypassing the cache: one after another as the scene did,
+    // and as a job per variant on the pool as it does now
+    BENCHMARK(ShaderCompile)
+    {
+        std::vector<ShaderCompileDesc> aDescs = readManifest(SHADER_MANIFEST_PATH);
+        if (aDescs.empty())
+        {
+            std::printf("  could not read the shader manifest, run from Source/Bench\n");
+            return;
+        }
+
+        const UINT uNumShaders = static_cast<UINT>(aDescs.size());
+        std::vector<std::string> aMessages(uNumShaders);
+        UINT uNumFailed = 0u;
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                uNumFailed = compile(aDescs, 0u, uNumShaders, aMessages);
+            }
+        );
+        bench::ReportMeasurement("1 thread", seconds, uNumShaders, "shaders");
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        std::atomic<UINT> uNumPoolFailed = 0u;
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                uNumPoolFailed = 0u;
+                threadPool.ParallelFor(
+                    uNumShaders,
+                    1u,
+                    [&](UINT uBegin, UINT uEnd)
+                    {
+                        uNumPoolFailed += compile(aDescs, uBegin, uEnd, aMessages);
+                    }
+                );
+            }
+        );
+
+        CHAR szCase[64];
+        std::snprintf(szCase, ARRAYSIZE(szCase), "%u threads", threadPool.GetNumThreads());
+        bench::ReportMeasurement(szCase, seconds, uNumShaders, "shaders");
+
+        if (uNumFailed > 0u || uNumPoolFailed > 0u)
+        {
+            std::printf("  %u of %u variants failed to compile\n", uNumFailed, uNumShaders);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include "BenchFramework.h"
+
+#include "Texture/BlockCompression.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // Photo like RGBA image, low frequency waves per channel with a
+        // little noise on top
+        std::vector<BYTE> createImage(_In_ UINT uSize)
+        {
+            std::mt19937 generator(40u);
+            std::uniform_int_distribution<INT> noise(-6, 6);
+            std::vector<BYTE> aRgba(static_cast<SIZE_T>(uSize) * uSize * 4u);
+            for (UINT y = 0u; y < uSize; ++y)
+            {
+                for (UINT x = 0u; x < uSize; ++x)
+                {
+                    for (UINT c = 0u; c < 4u; ++c)
+                    {
+                        FLOAT value = 0.5f + 0.25f * std::sin(static_cast<FLOAT>(x) * (0.011f + 0.004f * c)) + 0.2f * std::cos(static_cast<FLOAT>(x + 2u * y) * (0.007f + 0.003f * c));
+                        INT iValue = static_cast<INT>(value * 255.0f + 0.5f) + noise(generator);
+                        aRgba[(static_cast<SIZE_T>(y) * uSize + x) * 4u + c] = static_cast<BYTE>(std::clamp(iValue, 0, 255));
+                    }
+                }
+            }
+            return aRgba;
+        }
+    }
+
+    // Encodes a 1024x1024 image to each format, on the calling thread
+    // and on the pool, and prints the PSNR of the decoded image against
+    // the source over the channels the format stores. BC1 gets the
+    // image opaque. Throughput counts pixels
+    BENCHMARK(BlockCompression)
+    {
+        const UINT uSize = 1024u;
+        const UINT uNumPixels = uSize * uSize;
+        const std::vector<BYTE> aRgba = createImage(uSize);
+        std::vector<BYTE> aOpaque = aRgba;
+        for (UINT i = 0u; i < uNumPixels; ++i)
+        {
+            aOpaque[i * 4u + 3u] = 255u;
+        }
+
+        const SIZE_T uNumBlocks = static_cast<SIZE_T>(uSize / BC_BLOCK_SIZE) * (uSize / BC_BLOCK_SIZE);
+        std::vector<BYTE> aBlocks(uNumBlocks * 16u);
+        std::vector<BYTE> aDecoded(aRgba.size());
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        const PCSTR apszFormats[] = { "BC1", "BC3", "BC4", "BC5", "BC7" };
+        for (UINT uFormat = 0u; uFormat < static_cast<UINT>(eCompressedFormat::COUNT); ++uFormat)
+        {
+            eCompressedFormat format = static_cast<eCompressedFormat>(uFormat);
+            const std::vector<BYTE>& aSource = format == eCompressedFormat::BC1 ? aOpaque : aRgba;
+
+            for (ThreadPool* pThreadPool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+            {
+                DOUBLE seconds = bench::MeasureSeconds(
+                    [&]()
+                    {
+                        CompressImage(format, aSource.data(), uSize, uSize, aBlocks.data(), pThreadPool);
+                    }
+                );
+
+                CHAR szCase[64];
+                std::snprintf(szCase, ARRAYSIZE(szCase), "%s, %s", apszFormats[uFormat], pThreadPool ? "thread pool" : "calling thread");
+                bench::ReportMeasurement(szCase, seconds, uNumPixels, "pixels");
+            }
+
+            DecompressImage(format, aBlocks.data(), uSize, uSize, aDecoded.data());
+            std::printf("    PSNR %.2f dB\n", ComputePsnr(aSource.data(), aDecoded.data(), uNumPixels, GetBlockNumChannels(format)));
+        }
+    }
+}
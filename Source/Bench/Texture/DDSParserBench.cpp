@@ -0,0 +1,114 @@
+#include "BenchFramework.h"
+
+#include "Texture/DDSParser.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT NUM_PARSED_FILES = 32u;
+
+        template <class T>
+        void appendBytes(_Inout_ std::vector<uint8_t>& aFile, _In_ const T& value)
+        {
+            const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(&value);
+            aFile.insert(aFile.end(), pBytes, pBytes + sizeof(T));
+        }
+
+        // A BC7 texture array with every mip, laid out as the cooker
+        // writes it
+        std::vector<uint8_t> createDds(_In_ UINT uSize, _In_ UINT uArraySize)
+        {
+            UINT uNumMips = 1u;
+            while ((uSize >> uNumMips) > 0u)
+            {
+                ++uNumMips;
+            }
+
+            DirectX::DDS_HEADER header = {};
+            header.size = sizeof(DirectX::DDS_HEADER);
+            header.flags = 0x000A1007u;
+            header.width = uSize;
+            header.height = uSize;
+            header.mipMapCount = uNumMips;
+            header.ddspf.size = sizeof(DirectX::DDS_PIXELFORMAT);
+            header.ddspf.flags = 0x00000004u;
+            header.ddspf.fourCC = 0x30315844u;
+            header.caps = 0x00401008u;
+
+            DirectX::DDS_HEADER_DXT10 headerDx10 =
+            {
+                .dxgiFormat = DXGI_FORMAT_BC7_UNORM,
+                .resourceDimension = DirectX::DDS_RESOURCE_DIMENSION_TEXTURE2D,
+                .miscFlag = 0u,
+                .arraySize = uArraySize,
+                .miscFlags2 = 0u
+            };
+
+            std::vector<uint8_t> aFile;
+            aFile.reserve(sizeof(UINT) + sizeof(header) + sizeof(headerDx10));
+            appendBytes(aFile, 0x20534444u);
+            appendBytes(aFile, header);
+            appendBytes(aFile, headerDx10);
+            for (UINT uItem = 0u; uItem < uArraySize; ++uItem)
+            {
+                for (UINT uMip = 0u; uMip < uNumMips; ++uMip)
+                {
+                    size_t numBytes = 0u;
+                    DirectX::GetDDSSurfaceInfo(std::max(uSize >> uMip, 1u), std::max(uSize >> uMip, 1u), DXGI_FORMAT_BC7_UNORM, &numBytes, nullptr, nullptr);
+                    aFile.resize(aFile.size() + numBytes, static_cast<uint8_t>(uMip));
+                }
+            }
+            return aFile;
+        }
+
+        HRESULT parse(_In_reads_bytes_(size) const uint8_t* pData, _In_ size_t size, _Inout_ std::vector<DirectX::DDS_SUBRESOURCE>& aSubresources)
+        {
+            DirectX::DDS_TEXTURE_DESC desc;
+            HRESULT hr = DirectX::ParseDDSTexture(pData, size, desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            aSubresources.resize(desc.mipCount * desc.arraySize);
+            size_t width;
+            size_t height;
+            size_t depth;
+            size_t skipMip;
+            return DirectX::GetDDSSubresources(desc, 0u, width, height, depth, skipMip, aSubresources.data());
+        }
+    }
+
+    // Parses a 2048x2048 BC7 array of 4 with all mips, 22 MB, 32 times:
+    // copied into a heap buffer first as the loader did before, and in
+    // place as it does from the mapped file now
+    BENCHMARK(DDSParse)
+    {
+        std::vector<uint8_t> aFile = createDds(2048u, 4u);
+        std::vector<DirectX::DDS_SUBRESOURCE> aSubresources;
+
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                for (UINT i = 0u; i < NUM_PARSED_FILES; ++i)
+                {
+                    std::vector<uint8_t> aCopy(aFile);
+                    parse(aCopy.data(), aCopy.size(), aSubresources);
+                }
+            }
+        );
+        bench::ReportMeasurement("copy, then parse", seconds, NUM_PARSED_FILES, "files");
+
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                for (UINT i = 0u; i < NUM_PARSED_FILES; ++i)
+                {
+                    parse(aFile.data(), aFile.size(), aSubresources);
+                }
+            }
+        );
+        bench::ReportMeasurement("in place", seconds, NUM_PARSED_FILES, "files");
+    }
+}
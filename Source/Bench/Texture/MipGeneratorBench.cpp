@@ -0,0 +1,48 @@
+#include "BenchFramework.h"
+
+#include "Texture/MipGenerator.h"
+#include "Utility/ThreadPool.h"
+
+#include <random>
+
+namespace library
+{
+    // Builds the full mip chain of a 4096x4096 sRGB image with each
+    // filter, on the calling thread and on the pool. Throughput counts
+    // the texels of the top mip
+    BENCHMARK(MipGenerator)
+    {
+        const UINT uSize = 4096u;
+        const UINT uNumTexels = uSize * uSize;
+
+        std::mt19937 generator(42u);
+        std::vector<BYTE> aPixels(static_cast<SIZE_T>(uNumTexels) * 4u);
+        for (BYTE& pixel : aPixels)
+        {
+            pixel = static_cast<BYTE>(generator());
+        }
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        std::vector<MipLevel> aMips;
+        for (eMipFilter filter : { eMipFilter::BOX, eMipFilter::KAISER })
+        {
+            MipChainOptions options = DEFAULT_MIP_CHAIN_OPTIONS;
+            options.Filter = filter;
+            PCSTR pszFilter = filter == eMipFilter::BOX ? "box" : "Kaiser";
+
+            for (ThreadPool* pThreadPool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+            {
+                DOUBLE seconds = bench::MeasureSeconds(
+                    [&]()
+                    {
+                        GenerateMipChain(eMipFormat::RGBA8_UNORM_SRGB, aPixels.data(), uSize, uSize, options, pThreadPool, aMips);
+                    }
+                );
+
+                CHAR szCase[64];
+                std::snprintf(szCase, ARRAYSIZE(szCase), "%s, %s", pszFilter, pThreadPool ? "thread pool" : "calling thread");
+                bench::ReportMeasurement(szCase, seconds, uNumTexels, "texels");
+            }
+        }
+    }
+}
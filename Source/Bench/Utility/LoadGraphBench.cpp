@@ -0,0 +1,85 @@
+#include "BenchFramework.h"
+
+#include "Utility/LoadGraph.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT NUM_MODELS = 24u;
+        constexpr const UINT NUM_SHADERS = 16u;
+
+        std::atomic<UINT> s_uSink{ 0u };
+
+        // Stands in for parsing, decoding or compiling, keeps one core busy
+        HRESULT burnMicroseconds(_In_ UINT uMicroseconds)
+        {
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::microseconds(uMicroseconds);
+            UINT uHash = 2166136261u;
+            while (std::chrono::steady_clock::now() < end)
+            {
+                for (UINT i = 0u; i < 256u; ++i)
+                {
+                    uHash = (uHash ^ i) * 16777619u;
+                }
+            }
+            s_uSink += uHash;
+
+            return S_OK;
+        }
+
+        // A scene startup shaped like Scene::Initialize: every model is
+        // imported on a worker and then created on the device, shaders are
+        // compiled on workers and their objects created once all are done
+        void buildStartupGraph(_Inout_ LoadGraph& graph)
+        {
+            for (UINT i = 0u; i < NUM_MODELS; ++i)
+            {
+                UINT uImport = graph.AddTask(L"import", eLoadQueue::WORKER, []() { return burnMicroseconds(4000u); });
+                UINT uCreate = graph.AddTask(L"create buffers", eLoadQueue::DEVICE, []() { return burnMicroseconds(300u); });
+                graph.AddDependency(uCreate, uImport);
+            }
+
+            std::vector<UINT> aCompiles;
+            for (UINT i = 0u; i < NUM_SHADERS; ++i)
+            {
+                aCompiles.push_back(graph.AddTask(L"compile", eLoadQueue::WORKER, []() { return burnMicroseconds(2500u); }));
+            }
+            UINT uCreateShaders = graph.AddTask(L"create shaders", eLoadQueue::DEVICE, []() { return burnMicroseconds(500u); });
+            for (UINT uCompile : aCompiles)
+            {
+                graph.AddDependency(uCreateShaders, uCompile);
+            }
+        }
+    }
+
+    // Runs a synthetic startup graph of 24 models and 16 shaders, about
+    // 144 ms of work of which 7.7 ms is on the device queue, once all on
+    // the calling thread as before the load graph and once with workers
+    BENCHMARK(SceneStartup)
+    {
+        LoadGraph graph;
+        buildStartupGraph(graph);
+        const UINT uNumTasks = graph.GetNumTasks();
+
+        DOUBLE seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                graph.Run(nullptr, nullptr);
+            }
+        );
+        bench::ReportMeasurement("serial, calling thread", seconds, uNumTasks, "tasks");
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        seconds = bench::MeasureSeconds(
+            [&]()
+            {
+                graph.Run(&threadPool, nullptr);
+            }
+        );
+        bench::ReportMeasurement("thread pool", seconds, uNumTasks, "tasks");
+    }
+}
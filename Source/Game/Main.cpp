@@ -13,7 +13,9 @@
 
 #include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <sstream>
 
 #include "Cube/Cube.h"
 #include "Cube/RotatingCube.h"
@@ -21,9 +23,13 @@
 #include "Light/RotatingPointLight.h"
 #include "Model/Model.h"
 #include "Renderer/Skybox.h"
+#include "Scene/AssetManager.h"
 #include "Scene/Scene.h"
 #include "Scene/Voxel.h"
+#include "Shader/ShaderPermutation.h"
 #include "Shader/SkyMapVertexShader.h"
+#include "Texture/TextureResidency.h"
+#include "Texture/TextureStreamer.h"
 
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   Function: wWinMain
@@ -49,12 +55,18 @@
 INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ INT nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
+
+    LARGE_INTEGER startingTime = {};
+    LARGE_INTEGER endingTime = {};
+    LARGE_INTEGER frequency = {};
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&startingTime);
 
     std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
 
-    std::ofstream sceneFile;
-    sceneFile.open("HeightMap.txt");
+    // The height map is an input of the scene snapshot, so it is only
+    // rewritten when its contents change
+    std::ostringstream sceneFile;
     constexpr const UINT MAP_WIDTH = 0;
     constexpr const UINT MAP_HEIGHT = 0;
     constexpr const UINT MAP_DEPTH = 0;
@@ -207,67 +219,94 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         sceneFile << '\n';
     }
     sceneFile << std::endl;
-    sceneFile.close();
 
-    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.txt");
+    std::ifstream existingSceneFile("HeightMap.txt", std::ios::binary);
+    std::string szExistingScene((std::istreambuf_iterator<CHAR>(existingSceneFile)), std::istreambuf_iterator<CHAR>());
+    existingSceneFile.close();
+    if (szExistingScene != sceneFile.str())
+    {
+        std::ofstream outSceneFile("HeightMap.txt", std::ios::binary);
+        outSceneFile << sceneFile.str();
+    }
+
+    // Textures show their lowest mips until the full detail is loaded
+    // in the background, so the first frame does not wait for them
+    library::TextureStreamer::GetDefault().SetEnabled(TRUE);
+
+    // Textures not drawn for a while lose their top mips past this
+    library::TextureResidency::GetDefault().SetBudget(256ull * 1024ull * 1024ull);
+
+    // "-nosnapshot" loads the scene cold, without reading or writing
+    // its snapshot, for the baseline of the startup time
+    BOOL bUseSnapshot = wcsstr(lpCmdLine, L"-nosnapshot") == nullptr;
+    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.txt", bUseSnapshot);
+
+    // "-loadthreads N" loads the scene on N threads, 1 for the serial
+    // baseline of the startup time
+    UINT uNumLoadingThreads = 0u;
+    PCWSTR pszLoadThreads = wcsstr(lpCmdLine, L"-loadthreads");
+    if (pszLoadThreads && swscanf_s(pszLoadThreads, L"-loadthreads %u", &uNumLoadingThreads) == 1)
+    {
+        mainScene->SetNumLoadingThreads(uNumLoadingThreads);
+    }
 
     // Phong
-    std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
+    std::shared_ptr<library::VertexShader> phongVertexShader = library::AssetManager::GetDefault().GetShader<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
     if (FAILED(mainScene->AddVertexShader(L"PhongShader", phongVertexShader)))
     {
         return 0;
     }
     // Voxel
-    std::shared_ptr<library::VertexShader> voxelVertexShader = std::make_shared<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxel", "vs_5_0");
+    std::shared_ptr<library::VertexShader> voxelVertexShader = library::AssetManager::GetDefault().GetShader<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxel", "vs_5_0", library::SHADER_FEATURE_NORMAL_MAP);
     if (FAILED(mainScene->AddVertexShader(L"VoxelShader", voxelVertexShader)))
     {
         return 0;
     }
     // Light Cube
-    std::shared_ptr<library::VertexShader> lightVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
+    std::shared_ptr<library::VertexShader> lightVertexShader = library::AssetManager::GetDefault().GetShader<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
     if (FAILED(mainScene->AddVertexShader(L"LightShader", lightVertexShader)))
     {
         return 0;
     }
     // Cube Map
-    std::shared_ptr<library::SkyMapVertexShader> cubeMapVertexShader = std::make_shared<library::SkyMapVertexShader>(L"Shaders/CubeMap.fxh", "VSCubeMap", "vs_5_0");
+    std::shared_ptr<library::SkyMapVertexShader> cubeMapVertexShader = library::AssetManager::GetDefault().GetShader<library::SkyMapVertexShader>(L"Shaders/CubeMap.fxh", "VSCubeMap", "vs_5_0");
     if (FAILED(mainScene->AddVertexShader(L"CubeMapShader", cubeMapVertexShader)))
     {
         return 0;
     }
     // Environment Map
-    std::shared_ptr<library::VertexShader> environmentMapVertexShader = std::make_shared<library::VertexShader>(L"Shaders/EnvironmentShaders.fxh", "VSEnvironmentMap", "vs_5_0");
+    std::shared_ptr<library::VertexShader> environmentMapVertexShader = library::AssetManager::GetDefault().GetShader<library::VertexShader>(L"Shaders/EnvironmentShaders.fxh", "VSEnvironmentMap", "vs_5_0");
     if (FAILED(mainScene->AddVertexShader(L"EnvironmentMapShader", environmentMapVertexShader)))
     {
         return 0;
     }
 
     // Phong
-    std::shared_ptr<library::PixelShader> phongPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
+    std::shared_ptr<library::PixelShader> phongPixelShader = library::AssetManager::GetDefault().GetShader<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
     if (FAILED(mainScene->AddPixelShader(L"PhongShader", phongPixelShader)))
     {
         return 0;
     }
     // Voxel
-    std::shared_ptr<library::PixelShader> voxelPixelShader = std::make_shared<library::PixelShader>(L"Shaders/VoxelShaders.fxh", "PSVoxel", "ps_5_0");
+    std::shared_ptr<library::PixelShader> voxelPixelShader = library::AssetManager::GetDefault().GetShader<library::PixelShader>(L"Shaders/VoxelShaders.fxh", "PSVoxel", "ps_5_0", library::SHADER_FEATURE_NORMAL_MAP);
     if (FAILED(mainScene->AddPixelShader(L"VoxelShader", voxelPixelShader)))
     {
         return 0;
     }
     // Light Cube
-    std::shared_ptr<library::PixelShader> lightPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCube", "ps_5_0");
+    std::shared_ptr<library::PixelShader> lightPixelShader = library::AssetManager::GetDefault().GetShader<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCube", "ps_5_0");
     if (FAILED(mainScene->AddPixelShader(L"LightShader", lightPixelShader)))
     {
         return 0;
     }
     // Cube Map
-    std::shared_ptr<library::PixelShader> cubeMapPixelShader = std::make_shared<library::PixelShader>(L"Shaders/CubeMap.fxh", "PSCubeMap", "ps_5_0");
+    std::shared_ptr<library::PixelShader> cubeMapPixelShader = library::AssetManager::GetDefault().GetShader<library::PixelShader>(L"Shaders/CubeMap.fxh", "PSCubeMap", "ps_5_0");
     if (FAILED(mainScene->AddPixelShader(L"CubeMapShader", cubeMapPixelShader)))
     {
         return 0;
     }
     // Environment Map
-    std::shared_ptr<library::PixelShader> environmentMapPixelShader = std::make_shared<library::PixelShader>(L"Shaders/EnvironmentShaders.fxh", "PSEnvironmentMap", "ps_5_0");
+    std::shared_ptr<library::PixelShader> environmentMapPixelShader = library::AssetManager::GetDefault().GetShader<library::PixelShader>(L"Shaders/EnvironmentShaders.fxh", "PSEnvironmentMap", "ps_5_0");
     if (FAILED(mainScene->AddPixelShader(L"EnvironmentMapShader", environmentMapPixelShader)))
     {
         return 0;
@@ -312,7 +351,7 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     }
 
     std::shared_ptr<library::Material> floorMaterial = std::make_shared<library::Material>(L"FloorMat");
-    floorMaterial->pDiffuse = std::make_shared<library::Texture>("Content/plane.jpg");
+    floorMaterial->pDiffuse = library::AssetManager::GetDefault().GetTexture(L"Content/plane.jpg");
     
     if (FAILED(mainScene->AddMaterial(floorMaterial)))
     {
@@ -387,5 +426,15 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    QueryPerformanceCounter(&endingTime);
+    WCHAR szMessage[256];
+    swprintf_s(
+        szMessage,
+        L"Startup took %.2f ms%s\n",
+        static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart),
+        bUseSnapshot ? L"" : L" without the snapshot"
+    );
+    OutputDebugString(szMessage);
+
     return game->Run();
 }
\ No newline at end of file
@@ -19,6 +19,10 @@
 #define WIN32_LEAN_AND_MEAN
 #endif // ! WIN32_LEAN_AND_MEAN
 
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // ! NOMINMAX
+
 #include <windows.h>
 #include <wincodec.h>
 #include <wrl.h>
@@ -16,25 +16,41 @@ namespace library
                 FLOAT attenuationDistance
                   Attenuation distance
 
-      Modifies: [m_position, m_color, m_attenuationDistance].
+      Modifies: [m_position, m_color, m_attenuationDistance,
+                 m_parentWorld, m_bHasParent].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     PointLight::PointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color, _In_ FLOAT attenuationDistance) :
         m_color(color),
         m_position(position),
-        m_attenuationDistance(attenuationDistance)
-    {}
+        m_attenuationDistance(attenuationDistance),
+        m_parentWorld(),
+        m_bHasParent(FALSE)
+    {
+        XMStoreFloat4x4(&m_parentWorld, XMMatrixIdentity());
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PointLight::GetPosition
 
-      Summary:  Returns the position of the light
+      Summary:  Returns the position of the light in world space.
+                m_position is relative to the parent once the light is
+                attached to one
 
-      Returns:  const XMFLOAT4&
+      Returns:  XMFLOAT4
                   Position of the light
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const XMFLOAT4& PointLight::GetPosition() const
+    XMFLOAT4 PointLight::GetPosition() const
     {
-        return m_position;
+        if (!m_bHasParent)
+        {
+            return m_position;
+        }
+
+        XMFLOAT4 position;
+        XMStoreFloat4(&position, XMVector3TransformCoord(XMLoadFloat4(&m_position), XMLoadFloat4x4(&m_parentWorld)));
+        position.w = m_position.w;
+
+        return position;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -63,6 +79,36 @@ namespace library
         return m_attenuationDistance;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PointLight::SetParentWorldMatrix
+
+      Summary:  Attaches the light to a parent, its position is then
+                placed by the parent's world matrix
+
+      Args:     FXMMATRIX parentWorld
+                  World matrix of the parent
+
+      Modifies: [m_parentWorld, m_bHasParent].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PointLight::SetParentWorldMatrix(_In_ FXMMATRIX parentWorld)
+    {
+        XMStoreFloat4x4(&m_parentWorld, parentWorld);
+        m_bHasParent = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PointLight::ClearParentWorldMatrix
+
+      Summary:  Detaches the light from its parent
+
+      Modifies: [m_parentWorld, m_bHasParent].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PointLight::ClearParentWorldMatrix()
+    {
+        XMStoreFloat4x4(&m_parentWorld, XMMatrixIdentity());
+        m_bHasParent = FALSE;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PointLight::Update
 
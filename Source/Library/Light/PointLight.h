@@ -13,7 +13,12 @@ namespace library
                 every direction
 
       Methods:  GetPosition
-                  Returns the position of the light
+                  Returns the position of the light, placed by the
+                  parent when the light is attached to one
+                SetParentWorldMatrix
+                  Places the light under a parent's world matrix
+                ClearParentWorldMatrix
+                  Detaches the light from its parent
                 GetColor
                   Returns the color of the light
                 Update
@@ -34,15 +39,20 @@ namespace library
         PointLight& operator=(PointLight&& other) = default;
         virtual ~PointLight() = default;
 
-        const XMFLOAT4& GetPosition() const;
+        XMFLOAT4 GetPosition() const;
         const XMFLOAT4& GetColor() const;
         FLOAT GetAttenuationDistance() const;
 
+        void SetParentWorldMatrix(_In_ FXMMATRIX parentWorld);
+        void ClearParentWorldMatrix();
+
         virtual void Update(_In_ FLOAT deltaTime);
 
     protected:
         XMFLOAT4 m_position;
         XMFLOAT4 m_color;
         FLOAT m_attenuationDistance;
+        XMFLOAT4X4 m_parentWorld;
+        BOOL m_bHasParent;
     };
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "Model/BoneWeights.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: PackBoneWeights
+
+      Summary:  Keeps the NUM_BONE_INFLUENCES largest influences of a
+                vertex, renormalizes them so that they sum up to one and
+                quantizes them to 8-bit indices and 16-bit unorm
+                weights. The quantized weights always sum up to exactly
+                PACKED_BONE_WEIGHT_ONE unless the vertex has no weight
+
+      Args:     const UINT* aBoneIds
+                  Bone indices of the influences
+                const FLOAT* aWeights
+                  Weights of the influences
+                UINT uNumBones
+                  Number of influences
+
+      Returns:  AnimationData
+                  Packed skinning data of the vertex
+    -----------------------------------------------------------------F-F*/
+    AnimationData PackBoneWeights(
+        _In_reads_(uNumBones) const UINT* aBoneIds,
+        _In_reads_(uNumBones) const FLOAT* aWeights,
+        _In_ UINT uNumBones
+    )
+    {
+        AnimationData packed = {};
+
+        // Sort the influences by descending weight, ties broken by bone id
+        // so that the result does not depend on the import order
+        UINT aOrder[MAX_NUM_BONES_PER_VERTEX];
+        uNumBones = std::min(uNumBones, static_cast<UINT>(MAX_NUM_BONES_PER_VERTEX));
+        std::iota(aOrder, aOrder + uNumBones, 0u);
+
+        UINT uNumKept = std::min(uNumBones, static_cast<UINT>(NUM_BONE_INFLUENCES));
+        std::partial_sort(aOrder, aOrder + uNumKept, aOrder + uNumBones,
+            [aBoneIds, aWeights](UINT a, UINT b)
+            {
+                if (aWeights[a] != aWeights[b])
+                {
+                    return aWeights[a] > aWeights[b];
+                }
+                return aBoneIds[a] < aBoneIds[b];
+            }
+        );
+
+        FLOAT sum = 0.0f;
+        for (UINT i = 0u; i < uNumKept; ++i)
+        {
+            sum += std::max(aWeights[aOrder[i]], 0.0f);
+        }
+
+        if (sum <= 0.0f)
+        {
+            // Vertex is not skinned, keep it all zero as the shaders expect
+            return packed;
+        }
+
+        UINT uTotal = 0u;
+        for (UINT i = 0u; i < uNumKept; ++i)
+        {
+            assert(aBoneIds[aOrder[i]] < MAX_NUM_BONES);
+
+            FLOAT normalized = std::max(aWeights[aOrder[i]], 0.0f) / sum;
+            UINT uQuantized = static_cast<UINT>(normalized * static_cast<FLOAT>(PACKED_BONE_WEIGHT_ONE) + 0.5f);
+            uQuantized = std::min(uQuantized, static_cast<UINT>(PACKED_BONE_WEIGHT_ONE));
+
+            packed.aBoneIndices[i] = static_cast<BYTE>(aBoneIds[aOrder[i]]);
+            packed.aBoneWeights[i] = static_cast<USHORT>(uQuantized);
+            uTotal += uQuantized;
+        }
+
+        // Rounding may leave the sum a few units off, give the difference
+        // to the dominant influence so the weights sum up to exactly one
+        INT iError = static_cast<INT>(PACKED_BONE_WEIGHT_ONE) - static_cast<INT>(uTotal);
+        packed.aBoneWeights[0] = static_cast<USHORT>(static_cast<INT>(packed.aBoneWeights[0]) + iError);
+
+        return packed;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: UnpackBoneWeights
+
+      Summary:  Expands packed skinning data back into bone indices and
+                floating point weights, the same way the input assembler
+                does for the skinning vertex shader
+
+      Args:     const AnimationData& packed
+                  Packed skinning data
+                UINT* aOutBoneIds
+                  Receives NUM_BONE_INFLUENCES bone indices
+                FLOAT* aOutWeights
+                  Receives NUM_BONE_INFLUENCES weights
+    -----------------------------------------------------------------F-F*/
+    void UnpackBoneWeights(
+        _In_ const AnimationData& packed,
+        _Out_writes_(NUM_BONE_INFLUENCES) UINT* aOutBoneIds,
+        _Out_writes_(NUM_BONE_INFLUENCES) FLOAT* aOutWeights
+    )
+    {
+        for (UINT i = 0u; i < NUM_BONE_INFLUENCES; ++i)
+        {
+            aOutBoneIds[i] = packed.aBoneIndices[i];
+            aOutWeights[i] = static_cast<FLOAT>(packed.aBoneWeights[i]) / static_cast<FLOAT>(PACKED_BONE_WEIGHT_ONE);
+        }
+    }
+}
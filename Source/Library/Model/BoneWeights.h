@@ -0,0 +1,33 @@
+/*+===================================================================
+  File:      BONEWEIGHTS.H
+
+  Summary:   BoneWeights header file contains declarations of the
+             functions that reduce, renormalize and pack per-vertex
+             bone influences at import time.
+
+  Functions: PackBoneWeights, UnpackBoneWeights
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    constexpr const USHORT PACKED_BONE_WEIGHT_ONE = 0xFFFFu;
+
+    AnimationData PackBoneWeights(
+        _In_reads_(uNumBones) const UINT* aBoneIds,
+        _In_reads_(uNumBones) const FLOAT* aWeights,
+        _In_ UINT uNumBones
+    );
+
+    void UnpackBoneWeights(
+        _In_ const AnimationData& packed,
+        _Out_writes_(NUM_BONE_INFLUENCES) UINT* aOutBoneIds,
+        _Out_writes_(NUM_BONE_INFLUENCES) FLOAT* aOutWeights
+    );
+}
@@ -0,0 +1,286 @@
+#include "Model/CpuSkinning.h"
+
+#include "Model/BoneWeights.h"
+#include "Utility/ThreadPool.h"
+
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT SKINNING_GRAIN_SIZE = 1024u;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: skinVertexRange
+
+          Summary:  SIMD kernel. Blends the bone matrices of each vertex
+                    with their weights and transforms the position, normal
+                    and tangent by the blended matrix, the same way the
+                    skinning vertex shader does
+
+          Args:     const SimpleVertex* aVertices
+                      Bind pose vertices
+                    const NormalData* aNormalData
+                      Bind pose tangents, may be nullptr
+                    const AnimationData* aAnimationData
+                      Packed bone indices and weights
+                    const XMMATRIX* aBoneTransforms
+                      Bone palette
+                    UINT uNumBones
+                      Number of bones in the palette
+                    const SkinnedVertexStreams& outStreams
+                      Receives the skinned vertices
+                    UINT uBegin
+                      First vertex of the range
+                    UINT uEnd
+                      One past the last vertex of the range
+        -----------------------------------------------------------------F-F*/
+        void skinVertexRange(
+            _In_ const SimpleVertex* aVertices,
+            _In_opt_ const NormalData* aNormalData,
+            _In_ const AnimationData* aAnimationData,
+            _In_ const XMMATRIX* aBoneTransforms,
+            _In_ UINT uNumBones,
+            _In_ const SkinnedVertexStreams& outStreams,
+            _In_ UINT uBegin,
+            _In_ UINT uEnd
+        )
+        {
+            UNREFERENCED_PARAMETER(uNumBones);
+
+            BOOL bWriteNormals = outStreams.aNormalX && outStreams.aNormalY && outStreams.aNormalZ;
+            BOOL bWriteTangents = aNormalData && outStreams.aTangentX && outStreams.aTangentY && outStreams.aTangentZ;
+
+            XMFLOAT3 result;
+            for (UINT i = uBegin; i < uEnd; ++i)
+            {
+                UINT aBoneIds[NUM_BONE_INFLUENCES];
+                FLOAT aWeights[NUM_BONE_INFLUENCES];
+                UnpackBoneWeights(aAnimationData[i], aBoneIds, aWeights);
+
+                XMMATRIX skinTransform(g_XMZero, g_XMZero, g_XMZero, g_XMZero);
+                for (UINT j = 0u; j < NUM_BONE_INFLUENCES; ++j)
+                {
+                    if (aWeights[j] == 0.0f)
+                    {
+                        continue;
+                    }
+                    assert(aBoneIds[j] < uNumBones);
+
+                    XMVECTOR weight = XMVectorReplicate(aWeights[j]);
+                    const XMMATRIX& bone = aBoneTransforms[aBoneIds[j]];
+                    skinTransform.r[0] = XMVectorMultiplyAdd(bone.r[0], weight, skinTransform.r[0]);
+                    skinTransform.r[1] = XMVectorMultiplyAdd(bone.r[1], weight, skinTransform.r[1]);
+                    skinTransform.r[2] = XMVectorMultiplyAdd(bone.r[2], weight, skinTransform.r[2]);
+                    skinTransform.r[3] = XMVectorMultiplyAdd(bone.r[3], weight, skinTransform.r[3]);
+                }
+
+                XMStoreFloat3(&result, XMVector3Transform(XMLoadFloat3(&aVertices[i].Position), skinTransform));
+                outStreams.aPositionX[i] = result.x;
+                outStreams.aPositionY[i] = result.y;
+                outStreams.aPositionZ[i] = result.z;
+
+                if (bWriteNormals)
+                {
+                    XMStoreFloat3(&result, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&aVertices[i].Normal), skinTransform)));
+                    outStreams.aNormalX[i] = result.x;
+                    outStreams.aNormalY[i] = result.y;
+                    outStreams.aNormalZ[i] = result.z;
+                }
+
+                if (bWriteTangents)
+                {
+                    XMStoreFloat3(&result, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&aNormalData[i].Tangent), skinTransform)));
+                    outStreams.aTangentX[i] = result.x;
+                    outStreams.aTangentY[i] = result.y;
+                    outStreams.aTangentZ[i] = result.z;
+                }
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: transformReference
+
+          Summary:  Scalar row vector times matrix product
+
+          Args:     const XMFLOAT4X4& m
+                      Matrix
+                    const XMFLOAT3& v
+                      Vector
+                    FLOAT w
+                      1 for points, 0 for directions
+                    FLOAT* aOut
+                      Receives x, y and z
+        -----------------------------------------------------------------F-F*/
+        void transformReference(_In_ const XMFLOAT4X4& m, _In_ const XMFLOAT3& v, _In_ FLOAT w, _Out_writes_(3) FLOAT* aOut)
+        {
+            for (UINT c = 0u; c < 3u; ++c)
+            {
+                aOut[c] = v.x * m.m[0][c] + v.y * m.m[1][c] + v.z * m.m[2][c] + w * m.m[3][c];
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: normalizeReference
+
+          Summary:  Scalar normalization, zero vectors stay zero
+
+          Args:     FLOAT* aVector
+                      x, y and z to normalize in place
+        -----------------------------------------------------------------F-F*/
+        void normalizeReference(_Inout_updates_(3) FLOAT* aVector)
+        {
+            FLOAT length = std::sqrt(aVector[0] * aVector[0] + aVector[1] * aVector[1] + aVector[2] * aVector[2]);
+            if (length > 0.0f)
+            {
+                aVector[0] /= length;
+                aVector[1] /= length;
+                aVector[2] /= length;
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: SkinVertices
+
+      Summary:  Skins the vertices with DirectXMath SIMD math, splitting
+                the vertices into ranges processed on the thread pool.
+                Vertices without weight collapse to the origin exactly
+                as they do in the skinning vertex shader
+
+      Args:     const SimpleVertex* aVertices
+                  Bind pose vertices
+                const NormalData* aNormalData
+                  Bind pose tangents, may be nullptr
+                const AnimationData* aAnimationData
+                  Packed bone indices and weights
+                UINT uNumVertices
+                  Number of vertices
+                const XMMATRIX* aBoneTransforms
+                  Bone palette, as returned by Model::GetBoneTransforms
+                UINT uNumBones
+                  Number of bones in the palette
+                const SkinnedVertexStreams& outStreams
+                  Receives the skinned vertices
+                ThreadPool* pThreadPool
+                  Pool to split the work on, runs on the calling thread
+                  if nullptr
+    -----------------------------------------------------------------F-F*/
+    void SkinVertices(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_reads_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumBones) const XMMATRIX* aBoneTransforms,
+        _In_ UINT uNumBones,
+        _In_ const SkinnedVertexStreams& outStreams,
+        _In_opt_ ThreadPool* pThreadPool
+    )
+    {
+        if (!pThreadPool)
+        {
+            skinVertexRange(aVertices, aNormalData, aAnimationData, aBoneTransforms, uNumBones, outStreams, 0u, uNumVertices);
+            return;
+        }
+
+        pThreadPool->ParallelFor(uNumVertices, SKINNING_GRAIN_SIZE,
+            [aVertices, aNormalData, aAnimationData, aBoneTransforms, uNumBones, &outStreams](UINT uBegin, UINT uEnd)
+            {
+                skinVertexRange(aVertices, aNormalData, aAnimationData, aBoneTransforms, uNumBones, outStreams, uBegin, uEnd);
+            }
+        );
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: SkinVerticesReference
+
+      Summary:  Single threaded scalar version of SkinVertices used to
+                validate the SIMD kernel. Produces the same result within
+                floating point rounding
+
+      Args:     const SimpleVertex* aVertices
+                  Bind pose vertices
+                const NormalData* aNormalData
+                  Bind pose tangents, may be nullptr
+                const AnimationData* aAnimationData
+                  Packed bone indices and weights
+                UINT uNumVertices
+                  Number of vertices
+                const XMMATRIX* aBoneTransforms
+                  Bone palette
+                UINT uNumBones
+                  Number of bones in the palette
+                const SkinnedVertexStreams& outStreams
+                  Receives the skinned vertices
+    -----------------------------------------------------------------F-F*/
+    void SkinVerticesReference(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_reads_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumBones) const XMMATRIX* aBoneTransforms,
+        _In_ UINT uNumBones,
+        _In_ const SkinnedVertexStreams& outStreams
+    )
+    {
+        std::vector<XMFLOAT4X4> aBones(uNumBones);
+        for (UINT i = 0u; i < uNumBones; ++i)
+        {
+            XMStoreFloat4x4(&aBones[i], aBoneTransforms[i]);
+        }
+
+        BOOL bWriteNormals = outStreams.aNormalX && outStreams.aNormalY && outStreams.aNormalZ;
+        BOOL bWriteTangents = aNormalData && outStreams.aTangentX && outStreams.aTangentY && outStreams.aTangentZ;
+
+        FLOAT aResult[3];
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            UINT aBoneIds[NUM_BONE_INFLUENCES];
+            FLOAT aWeights[NUM_BONE_INFLUENCES];
+            UnpackBoneWeights(aAnimationData[i], aBoneIds, aWeights);
+
+            XMFLOAT4X4 skinTransform;
+            ZeroMemory(&skinTransform, sizeof(skinTransform));
+            for (UINT j = 0u; j < NUM_BONE_INFLUENCES; ++j)
+            {
+                if (aWeights[j] == 0.0f)
+                {
+                    continue;
+                }
+                assert(aBoneIds[j] < uNumBones);
+
+                for (UINT r = 0u; r < 4u; ++r)
+                {
+                    for (UINT c = 0u; c < 4u; ++c)
+                    {
+                        skinTransform.m[r][c] += aWeights[j] * aBones[aBoneIds[j]].m[r][c];
+                    }
+                }
+            }
+
+            transformReference(skinTransform, aVertices[i].Position, 1.0f, aResult);
+            outStreams.aPositionX[i] = aResult[0];
+            outStreams.aPositionY[i] = aResult[1];
+            outStreams.aPositionZ[i] = aResult[2];
+
+            if (bWriteNormals)
+            {
+                transformReference(skinTransform, aVertices[i].Normal, 0.0f, aResult);
+                normalizeReference(aResult);
+                outStreams.aNormalX[i] = aResult[0];
+                outStreams.aNormalY[i] = aResult[1];
+                outStreams.aNormalZ[i] = aResult[2];
+            }
+
+            if (bWriteTangents)
+            {
+                transformReference(skinTransform, aNormalData[i].Tangent, 0.0f, aResult);
+                normalizeReference(aResult);
+                outStreams.aTangentX[i] = aResult[0];
+                outStreams.aTangentY[i] = aResult[1];
+                outStreams.aTangentZ[i] = aResult[2];
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*+===================================================================
+  File:      CPUSKINNING.H
+
+  Summary:   CpuSkinning header file contains declarations of the
+             functions that deform skinned vertices on the CPU, for
+             tools and passes that cannot read back the skinning
+             vertex shader output.
+
+  Functions: SkinVertices, SkinVerticesReference
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    class ThreadPool;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SkinnedVertexStreams
+
+      Summary:  Caller owned structure of arrays receiving the skinned
+                vertices. Every array holds at least as many elements as
+                there are vertices. Normal and tangent arrays may be
+                nullptr to skip them
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SkinnedVertexStreams
+    {
+        FLOAT* aPositionX;
+        FLOAT* aPositionY;
+        FLOAT* aPositionZ;
+        FLOAT* aNormalX;
+        FLOAT* aNormalY;
+        FLOAT* aNormalZ;
+        FLOAT* aTangentX;
+        FLOAT* aTangentY;
+        FLOAT* aTangentZ;
+    };
+
+    void SkinVertices(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_reads_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumBones) const XMMATRIX* aBoneTransforms,
+        _In_ UINT uNumBones,
+        _In_ const SkinnedVertexStreams& outStreams,
+        _In_opt_ ThreadPool* pThreadPool
+    );
+
+    void SkinVerticesReference(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_reads_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumBones) const XMMATRIX* aBoneTransforms,
+        _In_ UINT uNumBones,
+        _In_ const SkinnedVertexStreams& outStreams
+    );
+}
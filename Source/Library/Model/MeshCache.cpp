@@ -0,0 +1,348 @@
+#include "Model/MeshCache.h"
+
+#include "Utility/Hash.h"
+
+#include <fstream>
+
+namespace library
+{
+    constexpr const UINT64 MESH_CACHE_SECTION_ALIGNMENT = 16ull;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeMeshCacheKey
+
+      Summary:  Hashes the contents of the source model and combines it
+                with the import flags and the cook variant
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the model file
+                UINT uImportFlags
+                  Assimp post processing flags of the import
+                PCSTR pszVariant
+                  Name of the cook variant, e.g. when a subclass builds
+                  the meshes differently from the same file
+                MeshCacheKey& outKey
+                  Receives the key
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT ComputeMeshCacheKey(
+        _In_ const std::filesystem::path& sourcePath,
+        _In_ UINT uImportFlags,
+        _In_ PCSTR pszVariant,
+        _Out_ MeshCacheKey& outKey
+    )
+    {
+        outKey = {};
+
+        MappedFile sourceFile;
+        HRESULT hr = sourceFile.Open(sourcePath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        outKey.ullSourceHash = HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+        outKey.uImportFlags = uImportFlags;
+        outKey.uVariant = static_cast<UINT>(HashString(pszVariant));
+
+        return S_OK;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetMeshCachePath
+
+      Summary:  Returns the path of the cooked mesh, next to the source
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the model file
+                PCSTR pszVariant
+                  Name of the cook variant
+
+      Returns:  std::filesystem::path
+                  Path to the cooked mesh
+    -----------------------------------------------------------------F-F*/
+    std::filesystem::path GetMeshCachePath(_In_ const std::filesystem::path& sourcePath, _In_ PCSTR pszVariant)
+    {
+        std::filesystem::path cachePath = sourcePath;
+        cachePath += ".";
+        cachePath += pszVariant;
+        cachePath += ".mesh";
+
+        return cachePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheWriter::MeshCacheWriter
+
+      Summary:  Constructor
+
+      Args:     const MeshCacheKey& key
+                  Key of the import being cooked
+
+      Modifies: [m_key, m_globalInverseTransform, m_aSections].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshCacheWriter::MeshCacheWriter(_In_ const MeshCacheKey& key)
+        : m_key(key)
+        , m_globalInverseTransform()
+        , m_aSections()
+    {
+        XMStoreFloat4x4(&m_globalInverseTransform, XMMatrixIdentity());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheWriter::SetGlobalInverseTransform
+
+      Summary:  Sets the inverse of the root node transformation
+
+      Args:     const XMMATRIX& globalInverseTransform
+                  Inverse root transformation
+
+      Modifies: [m_globalInverseTransform].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshCacheWriter::SetGlobalInverseTransform(_In_ const XMMATRIX& globalInverseTransform)
+    {
+        XMStoreFloat4x4(&m_globalInverseTransform, globalInverseTransform);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheWriter::SetSection
+
+      Summary:  Copies the data of a section, replacing previous data
+
+      Args:     MeshCacheSection section
+                  Section to set
+                const void* pData
+                  Data of the section
+                SIZE_T uSize
+                  Size of the data in bytes
+
+      Modifies: [m_aSections].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshCacheWriter::SetSection(_In_ MeshCacheSection section, _In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize)
+    {
+        assert(section != MeshCacheSection::Strings);
+
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        m_aSections[static_cast<UINT>(section)].assign(pBytes, pBytes + uSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheWriter::AddString
+
+      Summary:  Appends a null terminated string to the Strings section
+
+      Args:     const std::string& szString
+                  String to add
+
+      Modifies: [m_aSections].
+
+      Returns:  UINT
+                  Offset of the string in the Strings section
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT MeshCacheWriter::AddString(_In_ const std::string& szString)
+    {
+        std::vector<BYTE>& aStrings = m_aSections[static_cast<UINT>(MeshCacheSection::Strings)];
+        UINT uOffset = static_cast<UINT>(aStrings.size());
+        aStrings.insert(aStrings.end(), szString.begin(), szString.end());
+        aStrings.push_back('\0');
+
+        return uOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheWriter::Save
+
+      Summary:  Writes the header and the aligned sections. The file is
+                written under a temporary name of the calling thread and
+                renamed at the end, so a cooked mesh is never seen half
+                written, even when two threads cook the same model
+
+      Args:     const std::filesystem::path& cachePath
+                  Path to write to
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MeshCacheWriter::Save(_In_ const std::filesystem::path& cachePath) const
+    {
+        MeshCacheHeader header =
+        {
+            .uMagic = MESH_CACHE_MAGIC,
+            .uVersion = MESH_CACHE_VERSION,
+            .Key = m_key,
+            .GlobalInverseTransform = m_globalInverseTransform,
+            .aSections = {}
+        };
+
+        UINT64 ullOffset = sizeof(MeshCacheHeader);
+        for (UINT i = 0u; i < static_cast<UINT>(MeshCacheSection::Count); ++i)
+        {
+            ullOffset = (ullOffset + MESH_CACHE_SECTION_ALIGNMENT - 1ull) & ~(MESH_CACHE_SECTION_ALIGNMENT - 1ull);
+            header.aSections[i].ullOffset = ullOffset;
+            header.aSections[i].ullSize = m_aSections[i].size();
+            ullOffset += m_aSections[i].size();
+        }
+
+        std::filesystem::path tempPath = cachePath;
+        tempPath += L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+        {
+            std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+            if (!cacheFile.is_open())
+            {
+                return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+            }
+
+            const CHAR aPadding[MESH_CACHE_SECTION_ALIGNMENT] = {};
+            cacheFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+            UINT64 ullWritten = sizeof(header);
+            for (UINT i = 0u; i < static_cast<UINT>(MeshCacheSection::Count); ++i)
+            {
+                cacheFile.write(aPadding, static_cast<std::streamsize>(header.aSections[i].ullOffset - ullWritten));
+                cacheFile.write(reinterpret_cast<const CHAR*>(m_aSections[i].data()), static_cast<std::streamsize>(m_aSections[i].size()));
+                ullWritten = header.aSections[i].ullOffset + header.aSections[i].ullSize;
+            }
+
+            if (!cacheFile.good())
+            {
+                cacheFile.close();
+                std::error_code error;
+                std::filesystem::remove(tempPath, error);
+                return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, cachePath, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheReader::MeshCacheReader
+
+      Summary:  Constructor
+
+      Modifies: [m_file, m_pHeader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshCacheReader::MeshCacheReader()
+        : m_file()
+        , m_pHeader(nullptr)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheReader::Open
+
+      Summary:  Maps a cooked mesh and checks that it was made by this
+                version from the same import and that every section
+                lies within the file. The cooked mesh may be a range of
+                a bigger file, e.g. of a scene snapshot
+
+      Args:     const std::filesystem::path& cachePath
+                  Path to the cooked mesh
+                const MeshCacheKey& key
+                  Key of the import the cooked mesh has to match
+                UINT64 ullOffset
+                  Offset of the cooked mesh in the file
+                SIZE_T uSize
+                  Size of the cooked mesh, 0 for the rest of the file
+
+      Modifies: [m_file, m_pHeader].
+
+      Returns:  HRESULT
+                  Status code, HRESULT_FROM_WIN32(ERROR_FILE_INVALID)
+                  if the cooked mesh is stale or corrupt
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MeshCacheReader::Open(_In_ const std::filesystem::path& cachePath, _In_ const MeshCacheKey& key, _In_opt_ UINT64 ullOffset, _In_opt_ SIZE_T uSize)
+    {
+        m_pHeader = nullptr;
+
+        HRESULT hr = m_file.Open(cachePath, ullOffset, uSize);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        if (m_file.GetSize() < sizeof(MeshCacheHeader))
+        {
+            m_file.Close();
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+
+        const MeshCacheHeader* pHeader = reinterpret_cast<const MeshCacheHeader*>(m_file.GetData());
+        if (pHeader->uMagic != MESH_CACHE_MAGIC ||
+            pHeader->uVersion != MESH_CACHE_VERSION ||
+            pHeader->Key.ullSourceHash != key.ullSourceHash ||
+            pHeader->Key.uImportFlags != key.uImportFlags ||
+            pHeader->Key.uVariant != key.uVariant)
+        {
+            m_file.Close();
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+
+        for (UINT i = 0u; i < static_cast<UINT>(MeshCacheSection::Count); ++i)
+        {
+            const MeshCacheSectionEntry& entry = pHeader->aSections[i];
+            if (entry.ullOffset > m_file.GetSize() || entry.ullSize > m_file.GetSize() - entry.ullOffset)
+            {
+                m_file.Close();
+                return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+            }
+        }
+
+        const MeshCacheSectionEntry& strings = pHeader->aSections[static_cast<UINT>(MeshCacheSection::Strings)];
+        if (strings.ullSize > 0ull && m_file.GetData()[strings.ullOffset + strings.ullSize - 1ull] != '\0')
+        {
+            m_file.Close();
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+
+        m_pHeader = pHeader;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheReader::GetString
+
+      Summary:  Returns a string of the Strings section
+
+      Args:     UINT uOffset
+                  Offset of the string
+
+      Returns:  PCSTR
+                  String in the mapped file, empty when uOffset is
+                  MESH_CACHE_NO_STRING or out of range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCSTR MeshCacheReader::GetString(_In_ UINT uOffset) const
+    {
+        const MeshCacheSectionEntry& strings = m_pHeader->aSections[static_cast<UINT>(MeshCacheSection::Strings)];
+        if (uOffset == MESH_CACHE_NO_STRING || uOffset >= strings.ullSize)
+        {
+            return "";
+        }
+
+        return reinterpret_cast<PCSTR>(m_file.GetData() + strings.ullOffset + uOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshCacheReader::GetGlobalInverseTransform
+
+      Summary:  Returns the inverse of the root node transformation
+
+      Returns:  XMMATRIX
+                  Inverse root transformation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX MeshCacheReader::GetGlobalInverseTransform() const
+    {
+        return XMLoadFloat4x4(&m_pHeader->GlobalInverseTransform);
+    }
+}
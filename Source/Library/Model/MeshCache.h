@@ -0,0 +1,228 @@
+/*+===================================================================
+  File:      MESHCACHE.H
+
+  Summary:   MeshCache header file contains the layout of cooked mesh
+             files and the classes writing and memory mapping them.
+             A cooked mesh holds everything a Model builds from an
+             Assimp scene, so warm loads skip the importer.
+
+  Classes: MeshCacheWriter, MeshCacheReader
+
+  Functions: ComputeMeshCacheKey, GetMeshCachePath
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Utility/MappedFile.h"
+
+namespace library
+{
+    constexpr const UINT MESH_CACHE_MAGIC = 0x4853454Du; // "MESH"
+    constexpr const UINT MESH_CACHE_VERSION = 6u;
+    constexpr const UINT MESH_CACHE_NO_STRING = 0xFFFFFFFFu;
+
+    enum class MeshCacheSection : UINT
+    {
+        Vertices,
+        NormalData,
+        AnimationData,
+        Indices,
+        Meshes,
+        Meshlets,
+        Materials,
+        Bones,
+        Nodes,
+        Clips,
+        Channels,
+        VectorKeys,
+        QuaternionKeys,
+        Strings,
+        Count
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshCacheKey
+
+      Summary:  Identifies the import a cooked mesh was made from. A
+                cooked mesh is only used when all fields match
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshCacheKey
+    {
+        UINT64 ullSourceHash;
+        UINT uImportFlags;
+        UINT uVariant;
+    };
+
+    struct MeshCacheSectionEntry
+    {
+        UINT64 ullOffset;
+        UINT64 ullSize;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshCacheHeader
+
+      Summary:  First bytes of a cooked mesh file. Section offsets are
+                relative to the start of the file and 16 byte aligned
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshCacheHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        MeshCacheKey Key;
+        XMFLOAT4X4 GlobalInverseTransform;
+        MeshCacheSectionEntry aSections[static_cast<UINT>(MeshCacheSection::Count)];
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedMaterial, CookedBone, CookedNode, CookedClip,
+                CookedChannel
+
+      Summary:  Fixed size records of the cooked sections. Names and
+                paths are offsets into the Strings section, key and
+                channel ranges index the VectorKeys, QuaternionKeys and
+                Channels sections
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedMaterial
+    {
+        UINT uDiffusePath;
+        UINT uSpecularPath;
+        UINT uNormalPath;
+    };
+
+    struct CookedBone
+    {
+        UINT uName;
+        XMFLOAT4X4 OffsetMatrix;
+    };
+
+    struct CookedNode
+    {
+        UINT uName;
+        INT iParent;
+        INT iBoneIndex;
+        XMFLOAT4X4 Transformation;
+    };
+
+    struct CookedClip
+    {
+        FLOAT Duration;
+        FLOAT TicksPerSecond;
+        UINT uFirstChannel;
+        UINT uNumChannels;
+    };
+
+    struct CookedChannel
+    {
+        UINT uNodeIndex;
+        UINT uFirstPositionKey;
+        UINT uNumPositionKeys;
+        UINT uFirstRotationKey;
+        UINT uNumRotationKeys;
+        UINT uFirstScalingKey;
+        UINT uNumScalingKeys;
+    };
+
+    HRESULT ComputeMeshCacheKey(
+        _In_ const std::filesystem::path& sourcePath,
+        _In_ UINT uImportFlags,
+        _In_ PCSTR pszVariant,
+        _Out_ MeshCacheKey& outKey
+    );
+    std::filesystem::path GetMeshCachePath(_In_ const std::filesystem::path& sourcePath, _In_ PCSTR pszVariant);
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshCacheWriter
+
+      Summary:  Gathers the sections of a cooked mesh and writes them
+
+      Methods:  SetGlobalInverseTransform
+                  Sets the inverse of the root node transformation
+                SetSection
+                  Copies the data of a section
+                AddString
+                  Appends a string to the Strings section
+                Save
+                  Writes the cooked mesh file
+                MeshCacheWriter
+                  Constructor.
+                ~MeshCacheWriter
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshCacheWriter final
+    {
+    public:
+        MeshCacheWriter() = delete;
+        MeshCacheWriter(_In_ const MeshCacheKey& key);
+        MeshCacheWriter(const MeshCacheWriter& other) = delete;
+        MeshCacheWriter(MeshCacheWriter&& other) = delete;
+        MeshCacheWriter& operator=(const MeshCacheWriter& other) = delete;
+        MeshCacheWriter& operator=(MeshCacheWriter&& other) = delete;
+        ~MeshCacheWriter() = default;
+
+        void SetGlobalInverseTransform(_In_ const XMMATRIX& globalInverseTransform);
+        void SetSection(_In_ MeshCacheSection section, _In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize);
+        template <typename T>
+        void SetSection(_In_ MeshCacheSection section, _In_ const std::vector<T>& aData)
+        {
+            SetSection(section, aData.data(), aData.size() * sizeof(T));
+        }
+        UINT AddString(_In_ const std::string& szString);
+
+        HRESULT Save(_In_ const std::filesystem::path& cachePath) const;
+
+    private:
+        MeshCacheKey m_key;
+        XMFLOAT4X4 m_globalInverseTransform;
+        std::vector<BYTE> m_aSections[static_cast<UINT>(MeshCacheSection::Count)];
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshCacheReader
+
+      Summary:  Memory maps a cooked mesh and hands out typed views of
+                its sections without parsing them
+
+      Methods:  Open
+                  Maps and validates a cooked mesh file
+                GetSection
+                  Returns a typed view of a section
+                GetString
+                  Returns a string of the Strings section
+                GetGlobalInverseTransform
+                  Returns the inverse of the root node transformation
+                MeshCacheReader
+                  Constructor.
+                ~MeshCacheReader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshCacheReader final
+    {
+    public:
+        MeshCacheReader();
+        MeshCacheReader(const MeshCacheReader& other) = delete;
+        MeshCacheReader(MeshCacheReader&& other) = delete;
+        MeshCacheReader& operator=(const MeshCacheReader& other) = delete;
+        MeshCacheReader& operator=(MeshCacheReader&& other) = delete;
+        ~MeshCacheReader() = default;
+
+        HRESULT Open(_In_ const std::filesystem::path& cachePath, _In_ const MeshCacheKey& key, _In_opt_ UINT64 ullOffset = 0ull, _In_opt_ SIZE_T uSize = 0u);
+
+        template <typename T>
+        const T* GetSection(_In_ MeshCacheSection section, _Out_ UINT& uOutCount) const
+        {
+            const MeshCacheSectionEntry& entry = m_pHeader->aSections[static_cast<UINT>(section)];
+            uOutCount = static_cast<UINT>(entry.ullSize / sizeof(T));
+            return reinterpret_cast<const T*>(m_file.GetData() + entry.ullOffset);
+        }
+        PCSTR GetString(_In_ UINT uOffset) const;
+        XMMATRIX GetGlobalInverseTransform() const;
+
+    private:
+        MappedFile m_file;
+        const MeshCacheHeader* m_pHeader;
+    };
+}
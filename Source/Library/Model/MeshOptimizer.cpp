@@ -0,0 +1,460 @@
+#include "Model/MeshOptimizer.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: AnalyzeVertexCache
+
+      Summary:  Runs a triangle list through a FIFO post-transform
+                cache of a given size and counts the vertex shader
+                invocations
+
+      Args:     const UINT* aIndices
+                  Mesh local indices of a triangle list
+                UINT uNumIndices
+                  Number of indices, a multiple of 3
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                UINT uCacheSize
+                  Number of entries of the simulated cache
+
+      Returns:  VertexCacheStats
+                  Number of transforms, ACMR and ATVR
+    -----------------------------------------------------------------F-F*/
+    VertexCacheStats AnalyzeVertexCache(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _In_ UINT uCacheSize
+    )
+    {
+        assert(uNumIndices % 3u == 0u);
+
+        VertexCacheStats stats = {};
+
+        // A vertex is in the FIFO if it was pushed less than
+        // uCacheSize pushes ago, so the cache is a timestamp per vertex
+        std::vector<UINT> aTimestamps(uNumVertices, 0u);
+        std::vector<BOOL> aReferenced(uNumVertices, FALSE);
+        UINT uTimestamp = uCacheSize + 1u;
+        UINT uNumReferenced = 0u;
+
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            UINT uVertex = aIndices[i];
+            assert(uVertex < uNumVertices);
+            if (uTimestamp - aTimestamps[uVertex] > uCacheSize)
+            {
+                aTimestamps[uVertex] = uTimestamp++;
+                ++stats.uNumTransforms;
+            }
+            if (!aReferenced[uVertex])
+            {
+                aReferenced[uVertex] = TRUE;
+                ++uNumReferenced;
+            }
+        }
+
+        UINT uNumTriangles = uNumIndices / 3u;
+        stats.Acmr = uNumTriangles ? static_cast<FLOAT>(stats.uNumTransforms) / static_cast<FLOAT>(uNumTriangles) : 0.0f;
+        stats.Atvr = uNumReferenced ? static_cast<FLOAT>(stats.uNumTransforms) / static_cast<FLOAT>(uNumReferenced) : 0.0f;
+
+        return stats;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: OptimizeVertexCache
+
+      Summary:  Reorders triangles for a FIFO post-transform cache
+                with Tipsify (Sander, Nehab and Barczak 2007). Triangles
+                are fanned around a vertex, and the next fanning vertex
+                is the one that is still in the cache and has live
+                triangles left. When no such vertex exists the fan
+                jumps, which is where a hard cluster boundary is put
+
+      Args:     const UINT* aIndices
+                  Mesh local indices of a triangle list
+                UINT uNumIndices
+                  Number of indices, a multiple of 3
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                UINT uCacheSize
+                  Number of entries of the targeted cache
+                UINT* aOutIndices
+                  Receives the reordered indices, must not alias
+                  aIndices
+                std::vector<UINT>* pOutClusters
+                  Optionally receives the first triangle of every hard
+                  cluster
+    -----------------------------------------------------------------F-F*/
+    void OptimizeVertexCache(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _In_ UINT uCacheSize,
+        _Out_writes_(uNumIndices) UINT* aOutIndices,
+        _Out_opt_ std::vector<UINT>* pOutClusters
+    )
+    {
+        assert(uNumIndices % 3u == 0u);
+        assert(aIndices != aOutIndices);
+
+        UINT uNumTriangles = uNumIndices / 3u;
+        if (pOutClusters)
+        {
+            pOutClusters->clear();
+        }
+        if (uNumTriangles == 0u)
+        {
+            return;
+        }
+
+        // Vertex to triangle adjacency, aLiveTriangles doubles as the
+        // running count while it is filled
+        std::vector<UINT> aLiveTriangles(uNumVertices, 0u);
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            assert(aIndices[i] < uNumVertices);
+            ++aLiveTriangles[aIndices[i]];
+        }
+
+        std::vector<UINT> aAdjacencyOffsets(uNumVertices + 1u, 0u);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aAdjacencyOffsets[i + 1u] = aAdjacencyOffsets[i] + aLiveTriangles[i];
+        }
+
+        std::vector<UINT> aAdjacency(uNumIndices);
+        std::vector<UINT> aFill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            aAdjacency[aFill[aIndices[i]]++] = i / 3u;
+        }
+
+        std::vector<UINT> aTimestamps(uNumVertices, 0u);
+        std::vector<BOOL> aEmitted(uNumTriangles, FALSE);
+        std::vector<UINT> aDeadEnds;
+        std::vector<UINT> aCandidates;
+        aDeadEnds.reserve(uNumIndices);
+
+        UINT uTimestamp = uCacheSize + 1u;
+        UINT uCursor = 0u;
+        UINT uNumOutIndices = 0u;
+        BOOL bNewCluster = TRUE;
+        INT iFanningVertex = static_cast<INT>(aIndices[0]);
+
+        while (iFanningVertex >= 0)
+        {
+            UINT uFanningVertex = static_cast<UINT>(iFanningVertex);
+            aCandidates.clear();
+
+            for (UINT i = aAdjacencyOffsets[uFanningVertex]; i < aAdjacencyOffsets[uFanningVertex + 1u]; ++i)
+            {
+                UINT uTriangle = aAdjacency[i];
+                if (aEmitted[uTriangle])
+                {
+                    continue;
+                }
+
+                if (bNewCluster && pOutClusters)
+                {
+                    pOutClusters->push_back(uNumOutIndices / 3u);
+                }
+                bNewCluster = FALSE;
+
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    UINT uVertex = aIndices[uTriangle * 3u + j];
+                    aOutIndices[uNumOutIndices++] = uVertex;
+                    aDeadEnds.push_back(uVertex);
+                    aCandidates.push_back(uVertex);
+                    --aLiveTriangles[uVertex];
+                    if (uTimestamp - aTimestamps[uVertex] > uCacheSize)
+                    {
+                        aTimestamps[uVertex] = uTimestamp++;
+                    }
+                }
+                aEmitted[uTriangle] = TRUE;
+            }
+
+            // Prefer the candidate that stays in the cache longest while
+            // its remaining triangles are emitted
+            iFanningVertex = -1;
+            INT iBestPriority = -1;
+            for (UINT uVertex : aCandidates)
+            {
+                if (aLiveTriangles[uVertex] == 0u)
+                {
+                    continue;
+                }
+
+                INT iPriority = 0;
+                UINT uAge = uTimestamp - aTimestamps[uVertex];
+                if (uAge + 2u * aLiveTriangles[uVertex] <= uCacheSize)
+                {
+                    iPriority = static_cast<INT>(uAge);
+                }
+                if (iPriority > iBestPriority)
+                {
+                    iBestPriority = iPriority;
+                    iFanningVertex = static_cast<INT>(uVertex);
+                }
+            }
+
+            if (iFanningVertex >= 0)
+            {
+                continue;
+            }
+
+            // Dead end, fall back to recently used vertices and then to
+            // input order, the cache locality is lost either way
+            bNewCluster = TRUE;
+            while (!aDeadEnds.empty())
+            {
+                UINT uVertex = aDeadEnds.back();
+                aDeadEnds.pop_back();
+                if (aLiveTriangles[uVertex] > 0u)
+                {
+                    iFanningVertex = static_cast<INT>(uVertex);
+                    break;
+                }
+            }
+            while (iFanningVertex < 0 && uCursor < uNumVertices)
+            {
+                if (aLiveTriangles[uCursor] > 0u)
+                {
+                    iFanningVertex = static_cast<INT>(uCursor);
+                }
+                ++uCursor;
+            }
+        }
+
+        assert(uNumOutIndices == uNumIndices);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: OptimizeOverdraw
+
+      Summary:  Reorders the clusters of a cache optimized triangle
+                list so that outward facing clusters come first, which
+                lets early depth testing reject more of the clusters
+                behind them (Sander, Nehab and Barczak 2007). Hard
+                clusters are split further wherever their running ACMR
+                is within threshold times their own ACMR, so the cache
+                efficiency is mostly kept
+
+      Args:     const UINT* aIndices
+                  Cache optimized mesh local indices
+                UINT uNumIndices
+                  Number of indices, a multiple of 3
+                const XMFLOAT3* aPositions
+                  Position of the first vertex
+                UINT uPositionStride
+                  Distance in bytes between two positions
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                const std::vector<UINT>& aHardClusters
+                  First triangle of every cluster from
+                  OptimizeVertexCache
+                UINT uCacheSize
+                  Number of entries of the targeted cache
+                FLOAT threshold
+                  Allowed ACMR increase of a cluster, 1.05 is a good
+                  trade-off
+                UINT* aOutIndices
+                  Receives the reordered indices, must not alias
+                  aIndices
+    -----------------------------------------------------------------F-F*/
+    void OptimizeOverdraw(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumVertices,
+        _In_ const std::vector<UINT>& aHardClusters,
+        _In_ UINT uCacheSize,
+        _In_ FLOAT threshold,
+        _Out_writes_(uNumIndices) UINT* aOutIndices
+    )
+    {
+        assert(uNumIndices % 3u == 0u);
+        assert(aIndices != aOutIndices);
+
+        UINT uNumTriangles = uNumIndices / 3u;
+        if (uNumTriangles == 0u)
+        {
+            return;
+        }
+
+        auto getPosition = [aPositions, uPositionStride](UINT uVertex) -> const XMFLOAT3&
+        {
+            return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(aPositions) + static_cast<SIZE_T>(uVertex) * uPositionStride);
+        };
+
+        std::vector<UINT> aClusters;
+        if (aHardClusters.empty())
+        {
+            aClusters.push_back(0u);
+        }
+
+        // Soft boundaries, each hard cluster is replayed from a flushed
+        // cache and cut as soon as the piece is about as cache friendly
+        // as the whole cluster
+        std::vector<UINT> aTimestamps(uNumVertices, 0u);
+        UINT uTimestamp = uCacheSize + 1u;
+        for (UINT i = 0u; i < aHardClusters.size(); ++i)
+        {
+            UINT uBegin = aHardClusters[i];
+            UINT uEnd = i + 1u < aHardClusters.size() ? aHardClusters[i + 1u] : uNumTriangles;
+            VertexCacheStats stats = AnalyzeVertexCache(&aIndices[uBegin * 3u], (uEnd - uBegin) * 3u, uNumVertices, uCacheSize);
+            FLOAT clusterThreshold = stats.Acmr * threshold;
+
+            aClusters.push_back(uBegin);
+            uTimestamp += uCacheSize + 1u;
+            UINT uClusterStart = uBegin;
+            UINT uClusterMisses = 0u;
+            for (UINT uTriangle = uBegin; uTriangle < uEnd; ++uTriangle)
+            {
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    UINT uVertex = aIndices[uTriangle * 3u + j];
+                    if (uTimestamp - aTimestamps[uVertex] > uCacheSize)
+                    {
+                        aTimestamps[uVertex] = uTimestamp++;
+                        ++uClusterMisses;
+                    }
+                }
+
+                UINT uClusterTriangles = uTriangle + 1u - uClusterStart;
+                if (uTriangle + 1u < uEnd &&
+                    static_cast<FLOAT>(uClusterMisses) <= clusterThreshold * static_cast<FLOAT>(uClusterTriangles))
+                {
+                    aClusters.push_back(uTriangle + 1u);
+                    uTimestamp += uCacheSize + 1u;
+                    uClusterStart = uTriangle + 1u;
+                    uClusterMisses = 0u;
+                }
+            }
+        }
+
+        // Area weighted centroid and normal of every cluster
+        XMVECTOR meshCentroid = XMVectorZero();
+        FLOAT meshArea = 0.0f;
+        std::vector<XMFLOAT3> aClusterCentroids(aClusters.size());
+        std::vector<XMFLOAT3> aClusterNormals(aClusters.size());
+        for (UINT i = 0u; i < aClusters.size(); ++i)
+        {
+            UINT uBegin = aClusters[i];
+            UINT uEnd = i + 1u < aClusters.size() ? aClusters[i + 1u] : uNumTriangles;
+
+            XMVECTOR centroid = XMVectorZero();
+            XMVECTOR normal = XMVectorZero();
+            FLOAT clusterArea = 0.0f;
+            for (UINT uTriangle = uBegin; uTriangle < uEnd; ++uTriangle)
+            {
+                XMVECTOR a = XMLoadFloat3(&getPosition(aIndices[uTriangle * 3u]));
+                XMVECTOR b = XMLoadFloat3(&getPosition(aIndices[uTriangle * 3u + 1u]));
+                XMVECTOR c = XMLoadFloat3(&getPosition(aIndices[uTriangle * 3u + 2u]));
+
+                // The cross product is twice the area along the normal
+                XMVECTOR areaNormal = XMVector3Cross(b - a, c - a);
+                FLOAT area = XMVectorGetX(XMVector3Length(areaNormal));
+
+                centroid += (a + b + c) * (area / 3.0f);
+                normal += areaNormal;
+                clusterArea += area;
+            }
+
+            meshCentroid += centroid;
+            meshArea += clusterArea;
+            XMStoreFloat3(&aClusterCentroids[i], clusterArea > 0.0f ? centroid / clusterArea : centroid);
+            XMStoreFloat3(&aClusterNormals[i], XMVector3Normalize(normal));
+        }
+        if (meshArea > 0.0f)
+        {
+            meshCentroid /= meshArea;
+        }
+
+        std::vector<FLOAT> aSortKeys(aClusters.size());
+        for (UINT i = 0u; i < aClusters.size(); ++i)
+        {
+            XMVECTOR offset = XMLoadFloat3(&aClusterCentroids[i]) - meshCentroid;
+            aSortKeys[i] = XMVectorGetX(XMVector3Dot(offset, XMLoadFloat3(&aClusterNormals[i])));
+        }
+
+        std::vector<UINT> aOrder(aClusters.size());
+        for (UINT i = 0u; i < aOrder.size(); ++i)
+        {
+            aOrder[i] = i;
+        }
+        std::stable_sort(aOrder.begin(), aOrder.end(), [&aSortKeys](UINT uLeft, UINT uRight)
+            {
+                return aSortKeys[uLeft] > aSortKeys[uRight];
+            }
+        );
+
+        UINT uNumOutIndices = 0u;
+        for (UINT uCluster : aOrder)
+        {
+            UINT uBegin = aClusters[uCluster];
+            UINT uEnd = uCluster + 1u < aClusters.size() ? aClusters[uCluster + 1u] : uNumTriangles;
+            std::copy(&aIndices[uBegin * 3u], &aIndices[uEnd * 3u], &aOutIndices[uNumOutIndices]);
+            uNumOutIndices += (uEnd - uBegin) * 3u;
+        }
+
+        assert(uNumOutIndices == uNumIndices);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: OptimizeVertexFetch
+
+      Summary:  Renumbers the vertices in the order the triangles first
+                use them, so vertex fetch walks the vertex buffer
+                mostly forward. Unreferenced vertices are moved to the
+                end
+
+      Args:     UINT* aIndices
+                  Mesh local indices, rewritten to the new numbering
+                UINT uNumIndices
+                  Number of indices
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                std::vector<UINT>& outRemap
+                  Receives the source vertex of every new vertex
+    -----------------------------------------------------------------F-F*/
+    void OptimizeVertexFetch(
+        _Inout_updates_(uNumIndices) UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _Out_ std::vector<UINT>& outRemap
+    )
+    {
+        constexpr const UINT UNASSIGNED = ~0u;
+
+        std::vector<UINT> aNewIndex(uNumVertices, UNASSIGNED);
+        outRemap.clear();
+        outRemap.reserve(uNumVertices);
+
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            UINT uVertex = aIndices[i];
+            assert(uVertex < uNumVertices);
+            if (aNewIndex[uVertex] == UNASSIGNED)
+            {
+                aNewIndex[uVertex] = static_cast<UINT>(outRemap.size());
+                outRemap.push_back(uVertex);
+            }
+            aIndices[i] = aNewIndex[uVertex];
+        }
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            if (aNewIndex[i] == UNASSIGNED)
+            {
+                outRemap.push_back(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*+===================================================================
+  File:      MESHOPTIMIZER.H
+
+  Summary:   MeshOptimizer header file contains declarations of the
+             functions that reorder the triangles and vertices of an
+             imported mesh for the post-transform vertex cache,
+             overdraw and vertex fetch, and of the FIFO cache
+             simulator used to measure them.
+
+  Structs:   VertexCacheStats
+
+  Functions: AnalyzeVertexCache, OptimizeVertexCache,
+             OptimizeOverdraw, OptimizeVertexFetch
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    constexpr const UINT VERTEX_CACHE_SIZE = 16u;
+    constexpr const FLOAT OVERDRAW_THRESHOLD = 1.05f;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VertexCacheStats
+
+      Summary:  Result of running an index stream through a FIFO
+                post-transform cache. Acmr is the number of vertex
+                shader invocations per triangle, Atvr the number of
+                invocations per referenced vertex (1.0 is optimal)
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VertexCacheStats
+    {
+        UINT uNumTransforms;
+        FLOAT Acmr;
+        FLOAT Atvr;
+    };
+
+    VertexCacheStats AnalyzeVertexCache(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _In_ UINT uCacheSize
+    );
+
+    void OptimizeVertexCache(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _In_ UINT uCacheSize,
+        _Out_writes_(uNumIndices) UINT* aOutIndices,
+        _Out_opt_ std::vector<UINT>* pOutClusters
+    );
+
+    void OptimizeOverdraw(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumVertices,
+        _In_ const std::vector<UINT>& aHardClusters,
+        _In_ UINT uCacheSize,
+        _In_ FLOAT threshold,
+        _Out_writes_(uNumIndices) UINT* aOutIndices
+    );
+
+    void OptimizeVertexFetch(
+        _Inout_updates_(uNumIndices) UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _Out_ std::vector<UINT>& outRemap
+    );
+}
@@ -0,0 +1,377 @@
+#include "Model/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Quadric
+
+          Summary:  Symmetric 4x4 matrix of the sum of squared distances
+                    to a set of planes, weighted by triangle area.
+                    Doubles keep the sums stable for large meshes
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Quadric
+        {
+            DOUBLE a2, ab, ac, ad;
+            DOUBLE b2, bc, bd;
+            DOUBLE c2, cd;
+            DOUBLE d2;
+            DOUBLE Weight;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Collapse
+
+          Summary:  Candidate that moves every use of uVertex to
+                    uTarget, which is the wedge of the other end of the
+                    edge as seen from uVertex's side
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Collapse
+        {
+            UINT uVertex;
+            UINT uTarget;
+            FLOAT Error;
+        };
+
+        void AddQuadric(_Inout_ Quadric& q, _In_ const Quadric& other)
+        {
+            q.a2 += other.a2; q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+            q.b2 += other.b2; q.bc += other.bc; q.bd += other.bd;
+            q.c2 += other.c2; q.cd += other.cd;
+            q.d2 += other.d2;
+            q.Weight += other.Weight;
+        }
+
+        FLOAT EvaluateQuadric(_In_ const Quadric& q, _In_ const XMFLOAT3& p)
+        {
+            DOUBLE x = p.x;
+            DOUBLE y = p.y;
+            DOUBLE z = p.z;
+            DOUBLE error =
+                q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x +
+                q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y +
+                q.c2 * z * z + 2.0 * q.cd * z +
+                q.d2;
+
+            return q.Weight > 0.0 ? static_cast<FLOAT>(std::abs(error) / q.Weight) : 0.0f;
+        }
+
+        XMFLOAT3 TriangleNormal(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b, _In_ const XMFLOAT3& c)
+        {
+            XMFLOAT3 e0(b.x - a.x, b.y - a.y, b.z - a.z);
+            XMFLOAT3 e1(c.x - a.x, c.y - a.y, c.z - a.z);
+            return XMFLOAT3(e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: SimplifyMesh
+
+      Summary:  Reduces a triangle list with edge collapses ordered by
+                the quadric error metric (Garland and Heckbert 1997).
+                Collapses keep one of the two vertices, so no new
+                vertices or attributes are made and the result indexes
+                the same vertex buffer. Vertices on attribute seams,
+                open borders and non-manifold edges are locked, which
+                keeps texture seams and silhouettes of open meshes
+                intact. Every pass sorts all candidates and performs
+                the independent ones, rejecting collapses that would
+                flip a triangle
+
+      Args:     const UINT* aIndices
+                  Mesh local indices of a triangle list
+                UINT uNumIndices
+                  Number of indices, a multiple of 3
+                const XMFLOAT3* aPositions
+                  Position of the first vertex
+                UINT uPositionStride
+                  Distance in bytes between two positions
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                UINT uTargetNumIndices
+                  Number of indices to stop at
+                FLOAT maxError
+                  Largest distance a collapse may move the surface
+                std::vector<UINT>& outIndices
+                  Receives the simplified indices, may stop above the
+                  target when no collapse is within maxError
+                FLOAT* pOutError
+                  Optionally receives the largest error of a
+                  performed collapse
+    -----------------------------------------------------------------F-F*/
+    void SimplifyMesh(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumVertices,
+        _In_ UINT uTargetNumIndices,
+        _In_ FLOAT maxError,
+        _Out_ std::vector<UINT>& outIndices,
+        _Out_opt_ FLOAT* pOutError
+    )
+    {
+        assert(uNumIndices % 3u == 0u);
+
+        outIndices.assign(aIndices, aIndices + uNumIndices);
+        if (pOutError)
+        {
+            *pOutError = 0.0f;
+        }
+
+        auto getPosition = [aPositions, uPositionStride](UINT uVertex) -> const XMFLOAT3&
+        {
+            return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(aPositions) + static_cast<SIZE_T>(uVertex) * uPositionStride);
+        };
+
+        // Vertices that only differ in attributes are wedges of the same
+        // corner, aCorners maps each of them to the first one
+        std::vector<UINT> aSorted(uNumVertices);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aSorted[i] = i;
+        }
+        auto positionLess = [&getPosition](UINT uLeft, UINT uRight)
+        {
+            const XMFLOAT3& left = getPosition(uLeft);
+            const XMFLOAT3& right = getPosition(uRight);
+            return left.x != right.x ? left.x < right.x : left.y != right.y ? left.y < right.y : left.z < right.z;
+        };
+        std::sort(aSorted.begin(), aSorted.end(), positionLess);
+
+        std::vector<UINT> aCorners(uNumVertices);
+        std::vector<BOOL> aLocked(uNumVertices, FALSE);
+        for (UINT i = 0u; i < uNumVertices; )
+        {
+            UINT uEnd = i + 1u;
+            while (uEnd < uNumVertices && !positionLess(aSorted[i], aSorted[uEnd]))
+            {
+                ++uEnd;
+            }
+
+            UINT uCorner = *std::min_element(aSorted.begin() + i, aSorted.begin() + uEnd);
+            for (UINT j = i; j < uEnd; ++j)
+            {
+                aCorners[aSorted[j]] = uCorner;
+            }
+            aLocked[uCorner] = uEnd - i > 1u;
+            i = uEnd;
+        }
+
+        // Edges used by anything but exactly two triangles are borders or
+        // non-manifold, their corners must not move
+        std::unordered_map<UINT64, UINT> edgeUseCounts;
+        edgeUseCounts.reserve(uNumIndices);
+        for (UINT i = 0u; i < uNumIndices; i += 3u)
+        {
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                UINT uA = aCorners[aIndices[i + j]];
+                UINT uB = aCorners[aIndices[i + (j + 1u) % 3u]];
+                UINT64 ullKey = (static_cast<UINT64>(std::min(uA, uB)) << 32u) | std::max(uA, uB);
+                ++edgeUseCounts[ullKey];
+            }
+        }
+        for (const auto& [ullKey, uCount] : edgeUseCounts)
+        {
+            if (uCount != 2u)
+            {
+                aLocked[static_cast<UINT>(ullKey >> 32u)] = TRUE;
+                aLocked[static_cast<UINT>(ullKey & 0xFFFFFFFFu)] = TRUE;
+            }
+        }
+
+        std::vector<Quadric> aQuadrics(uNumVertices, Quadric());
+        for (UINT i = 0u; i < uNumIndices; i += 3u)
+        {
+            const XMFLOAT3& a = getPosition(aIndices[i]);
+            XMFLOAT3 normal = TriangleNormal(a, getPosition(aIndices[i + 1u]), getPosition(aIndices[i + 2u]));
+            DOUBLE length = std::sqrt(static_cast<DOUBLE>(normal.x) * normal.x + static_cast<DOUBLE>(normal.y) * normal.y + static_cast<DOUBLE>(normal.z) * normal.z);
+            if (length <= 0.0)
+            {
+                continue;
+            }
+
+            DOUBLE nx = normal.x / length;
+            DOUBLE ny = normal.y / length;
+            DOUBLE nz = normal.z / length;
+            DOUBLE d = -(nx * a.x + ny * a.y + nz * a.z);
+            DOUBLE area = length * 0.5;
+            Quadric plane =
+            {
+                area * nx * nx, area * nx * ny, area * nx * nz, area * nx * d,
+                area * ny * ny, area * ny * nz, area * ny * d,
+                area * nz * nz, area * nz * d,
+                area * d * d,
+                area
+            };
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                AddQuadric(aQuadrics[aCorners[aIndices[i + j]]], plane);
+            }
+        }
+
+        FLOAT maxErrorSquared = maxError * maxError;
+        FLOAT largestError = 0.0f;
+        std::vector<Collapse> aCollapses;
+        std::vector<UINT> aAdjacencyOffsets(uNumVertices + 1u);
+        std::vector<UINT> aAdjacency;
+        std::vector<UINT> aRemap(uNumVertices);
+        std::vector<BOOL> aTouched(uNumVertices);
+
+        while (outIndices.size() > uTargetNumIndices)
+        {
+            UINT uNumTriangles = static_cast<UINT>(outIndices.size() / 3u);
+
+            // Triangles around every corner
+            std::fill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end(), 0u);
+            for (UINT uVertex : outIndices)
+            {
+                ++aAdjacencyOffsets[aCorners[uVertex] + 1u];
+            }
+            for (UINT i = 0u; i < uNumVertices; ++i)
+            {
+                aAdjacencyOffsets[i + 1u] += aAdjacencyOffsets[i];
+            }
+            aAdjacency.resize(outIndices.size());
+            std::vector<UINT> aFill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+            for (UINT i = 0u; i < outIndices.size(); ++i)
+            {
+                aAdjacency[aFill[aCorners[outIndices[i]]]++] = i / 3u;
+            }
+
+            aCollapses.clear();
+            for (UINT i = 0u; i < outIndices.size(); i += 3u)
+            {
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    UINT uVertex = outIndices[i + j];
+                    UINT uTarget = outIndices[i + (j + 1u) % 3u];
+                    for (UINT k = 0u; k < 2u; ++k, std::swap(uVertex, uTarget))
+                    {
+                        UINT uCorner = aCorners[uVertex];
+                        if (aLocked[uCorner])
+                        {
+                            continue;
+                        }
+
+                        Quadric q = aQuadrics[uCorner];
+                        AddQuadric(q, aQuadrics[aCorners[uTarget]]);
+                        FLOAT error = EvaluateQuadric(q, getPosition(uTarget));
+                        if (error <= maxErrorSquared)
+                        {
+                            aCollapses.push_back({ uVertex, uTarget, error });
+                        }
+                    }
+                }
+            }
+            if (aCollapses.empty())
+            {
+                break;
+            }
+            std::sort(aCollapses.begin(), aCollapses.end(), [](const Collapse& left, const Collapse& right)
+                {
+                    return left.Error < right.Error;
+                }
+            );
+
+            // An interior collapse removes two triangles
+            UINT uCollapseBudget = std::max((uNumTriangles - uTargetNumIndices / 3u) / 2u, 1u);
+            UINT uNumCollapsed = 0u;
+            for (UINT i = 0u; i < uNumVertices; ++i)
+            {
+                aRemap[i] = i;
+            }
+            std::fill(aTouched.begin(), aTouched.end(), FALSE);
+
+            for (const Collapse& collapse : aCollapses)
+            {
+                if (uNumCollapsed >= uCollapseBudget)
+                {
+                    break;
+                }
+
+                UINT uCorner = aCorners[collapse.uVertex];
+                UINT uTargetCorner = aCorners[collapse.uTarget];
+                if (aTouched[uCorner] || aTouched[uTargetCorner])
+                {
+                    continue;
+                }
+
+                // Reject the collapse if a remaining triangle would flip
+                const XMFLOAT3& target = getPosition(collapse.uTarget);
+                BOOL bFlips = FALSE;
+                for (UINT k = aAdjacencyOffsets[uCorner]; k < aAdjacencyOffsets[uCorner + 1u] && !bFlips; ++k)
+                {
+                    const UINT* aTriangle = &outIndices[aAdjacency[k] * 3u];
+                    XMFLOAT3 aCurrent[3];
+                    XMFLOAT3 aMoved[3];
+                    BOOL bCollapses = FALSE;
+                    for (UINT j = 0u; j < 3u; ++j)
+                    {
+                        aCurrent[j] = getPosition(aTriangle[j]);
+                        aMoved[j] = aCorners[aTriangle[j]] == uCorner ? target : aCurrent[j];
+                        bCollapses |= aCorners[aTriangle[j]] == uTargetCorner;
+                    }
+                    if (bCollapses)
+                    {
+                        continue;
+                    }
+
+                    XMFLOAT3 before = TriangleNormal(aCurrent[0], aCurrent[1], aCurrent[2]);
+                    XMFLOAT3 after = TriangleNormal(aMoved[0], aMoved[1], aMoved[2]);
+                    bFlips = before.x * after.x + before.y * after.y + before.z * after.z <= 0.0f;
+                }
+                if (bFlips)
+                {
+                    continue;
+                }
+
+                // The one-ring is about to change, keep the rest of this
+                // pass away from it so the flip test above stays valid
+                for (UINT k = aAdjacencyOffsets[uCorner]; k < aAdjacencyOffsets[uCorner + 1u]; ++k)
+                {
+                    const UINT* aTriangle = &outIndices[aAdjacency[k] * 3u];
+                    aTouched[aCorners[aTriangle[0]]] = TRUE;
+                    aTouched[aCorners[aTriangle[1]]] = TRUE;
+                    aTouched[aCorners[aTriangle[2]]] = TRUE;
+                }
+
+                aRemap[collapse.uVertex] = collapse.uTarget;
+                AddQuadric(aQuadrics[uTargetCorner], aQuadrics[uCorner]);
+                largestError = std::max(largestError, collapse.Error);
+                ++uNumCollapsed;
+            }
+
+            if (uNumCollapsed == 0u)
+            {
+                break;
+            }
+
+            // Remap and drop the triangles that became degenerate
+            UINT uNumOutIndices = 0u;
+            for (UINT i = 0u; i < outIndices.size(); i += 3u)
+            {
+                UINT uA = aRemap[outIndices[i]];
+                UINT uB = aRemap[outIndices[i + 1u]];
+                UINT uC = aRemap[outIndices[i + 2u]];
+                if (aCorners[uA] != aCorners[uB] && aCorners[uB] != aCorners[uC] && aCorners[uC] != aCorners[uA])
+                {
+                    outIndices[uNumOutIndices++] = uA;
+                    outIndices[uNumOutIndices++] = uB;
+                    outIndices[uNumOutIndices++] = uC;
+                }
+            }
+            outIndices.resize(uNumOutIndices);
+        }
+
+        if (pOutError)
+        {
+            *pOutError = std::sqrt(largestError);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+/*+===================================================================
+  File:      MESHSIMPLIFIER.H
+
+  Summary:   MeshSimplifier header file contains declarations of the
+             quadric error metric simplifier used to build the LOD
+             chain of imported meshes.
+
+  Functions: SimplifyMesh
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    void SimplifyMesh(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumVertices,
+        _In_ UINT uTargetNumIndices,
+        _In_ FLOAT maxError,
+        _Out_ std::vector<UINT>& outIndices,
+        _Out_opt_ FLOAT* pOutError
+    );
+}
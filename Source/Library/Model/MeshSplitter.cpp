@@ -0,0 +1,105 @@
+#include "Model/MeshSplitter.h"
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: NeedsIndex32
+
+      Summary:  Returns whether any index of a mesh does not fit in a
+                16-bit index
+
+      Args:     const UINT* aIndices
+                  Mesh local indices
+                UINT uNumIndices
+                  Number of indices
+
+      Returns:  BOOL
+                  TRUE if the mesh needs 32-bit indices
+    -----------------------------------------------------------------F-F*/
+    BOOL NeedsIndex32(_In_reads_(uNumIndices) const UINT* aIndices, _In_ UINT uNumIndices)
+    {
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            if (aIndices[i] >= MAX_INDEX16_VERTICES)
+            {
+                return TRUE;
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: SplitMeshForIndex16
+
+      Summary:  Splits a triangle list into submeshes of at most
+                MAX_INDEX16_VERTICES vertices each. Triangles are taken
+                in order and a new submesh starts when the next triangle
+                would not fit, so vertices shared across a split are
+                duplicated and triangle order is preserved
+
+      Args:     const UINT* aIndices
+                  Mesh local indices of a triangle list
+                UINT uNumIndices
+                  Number of indices, a multiple of 3
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                std::vector<Submesh>& outSubmeshes
+                  Receives the submeshes
+    -----------------------------------------------------------------F-F*/
+    void SplitMeshForIndex16(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _Out_ std::vector<Submesh>& outSubmeshes
+    )
+    {
+        assert(uNumIndices % 3u == 0u);
+
+        outSubmeshes.clear();
+
+        // aLocalIndex is only valid where aSubmeshStamp matches the
+        // current submesh, so it never has to be cleared between submeshes
+        std::vector<UINT> aLocalIndex(uNumVertices, 0u);
+        std::vector<UINT> aSubmeshStamp(uNumVertices, 0u);
+        UINT uStamp = 0u;
+
+        for (UINT i = 0u; i < uNumIndices; i += 3u)
+        {
+            UINT uNumNewVertices = 0u;
+            if (!outSubmeshes.empty())
+            {
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    UINT uVertex = aIndices[i + j];
+                    BOOL bRepeated = (j > 0u && aIndices[i] == uVertex) || (j > 1u && aIndices[i + 1u] == uVertex);
+                    if (aSubmeshStamp[uVertex] != uStamp && !bRepeated)
+                    {
+                        ++uNumNewVertices;
+                    }
+                }
+            }
+
+            if (outSubmeshes.empty() ||
+                outSubmeshes.back().aVertexRemap.size() + uNumNewVertices > MAX_INDEX16_VERTICES)
+            {
+                outSubmeshes.emplace_back();
+                ++uStamp;
+            }
+
+            Submesh& submesh = outSubmeshes.back();
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                UINT uVertex = aIndices[i + j];
+                assert(uVertex < uNumVertices);
+                if (aSubmeshStamp[uVertex] != uStamp)
+                {
+                    aSubmeshStamp[uVertex] = uStamp;
+                    aLocalIndex[uVertex] = static_cast<UINT>(submesh.aVertexRemap.size());
+                    submesh.aVertexRemap.push_back(uVertex);
+                }
+                submesh.aIndices.push_back(aLocalIndex[uVertex]);
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/*+===================================================================
+  File:      MESHSPLITTER.H
+
+  Summary:   MeshSplitter header file contains declarations of the
+             functions that pick the index format of a mesh and split
+             meshes too large for 16-bit indices into submeshes.
+
+  Functions: NeedsIndex32, SplitMeshForIndex16
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    constexpr const UINT MAX_INDEX16_VERTICES = 0x10000u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Submesh
+
+      Summary:  Part of a split mesh. aVertexRemap maps every submesh
+                vertex to its vertex in the source mesh, aIndices index
+                into aVertexRemap and always fit in 16 bits
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Submesh
+    {
+        std::vector<UINT> aVertexRemap;
+        std::vector<UINT> aIndices;
+    };
+
+    BOOL NeedsIndex32(_In_reads_(uNumIndices) const UINT* aIndices, _In_ UINT uNumIndices);
+
+    void SplitMeshForIndex16(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _Out_ std::vector<Submesh>& outSubmeshes
+    );
+}
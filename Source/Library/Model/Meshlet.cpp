@@ -0,0 +1,363 @@
+#include "Model/Meshlet.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        // Score of a candidate triangle is the number of vertices it adds
+        // to the meshlet plus this weight times how far its normal turns
+        // away from the meshlet's average normal, so meshlets stay flat
+        // enough for the cone test
+        constexpr const FLOAT MESHLET_CONE_WEIGHT = 1.0f;
+
+        // Below this spread the normals cover more than a hemisphere
+        // and the cone test is disabled
+        constexpr const FLOAT MESHLET_MIN_CONE_DOT = 0.1f;
+
+        constexpr const UINT NO_TRIANGLE = ~0u;
+
+        const XMFLOAT3& GetPosition(_In_ const XMFLOAT3* aPositions, _In_ UINT uPositionStride, _In_ UINT uVertex)
+        {
+            return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(aPositions) + static_cast<SIZE_T>(uVertex) * uPositionStride);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: ComputeMeshletBounds
+
+          Summary:  Fits a sphere around the box of the meshlet's
+                    vertices and a cone around its triangle normals
+
+          Args:     const UINT* aIndices
+                      Indices of the meshlet
+                    UINT uNumIndices
+                      Number of indices, a multiple of 3
+                    const XMFLOAT3* aPositions
+                      First vertex position
+                    UINT uPositionStride
+                      Bytes between two positions
+                    const XMFLOAT3* aNormals
+                      Unit normal of every triangle of the meshlet,
+                      zero for degenerate triangles
+                    Meshlet& outMeshlet
+                      Receives the sphere and the cone
+        -----------------------------------------------------------------F-F*/
+        void ComputeMeshletBounds(
+            _In_reads_(uNumIndices) const UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_ const XMFLOAT3* aPositions,
+            _In_ UINT uPositionStride,
+            _In_reads_(uNumIndices / 3) const XMFLOAT3* aNormals,
+            _Inout_ Meshlet& outMeshlet
+        )
+        {
+            XMVECTOR minimum = XMLoadFloat3(&GetPosition(aPositions, uPositionStride, aIndices[0]));
+            XMVECTOR maximum = minimum;
+            for (UINT i = 1u; i < uNumIndices; ++i)
+            {
+                XMVECTOR position = XMLoadFloat3(&GetPosition(aPositions, uPositionStride, aIndices[i]));
+                minimum = XMVectorMin(minimum, position);
+                maximum = XMVectorMax(maximum, position);
+            }
+
+            XMVECTOR center = (minimum + maximum) * 0.5f;
+            FLOAT radiusSquared = 0.0f;
+            for (UINT i = 0u; i < uNumIndices; ++i)
+            {
+                XMVECTOR position = XMLoadFloat3(&GetPosition(aPositions, uPositionStride, aIndices[i]));
+                radiusSquared = std::max(radiusSquared, XMVectorGetX(XMVector3LengthSq(position - center)));
+            }
+            XMStoreFloat3(&outMeshlet.Center, center);
+            outMeshlet.Radius = std::sqrt(radiusSquared);
+
+            XMVECTOR axis = XMVectorZero();
+            for (UINT i = 0u; i < uNumIndices / 3u; ++i)
+            {
+                axis += XMLoadFloat3(&aNormals[i]);
+            }
+
+            outMeshlet.ConeAxis = XMFLOAT3(0.0f, 0.0f, 0.0f);
+            outMeshlet.ConeCutoff = 1.0f;
+            if (XMVectorGetX(XMVector3LengthSq(axis)) < 1e-12f)
+            {
+                return;
+            }
+            axis = XMVector3Normalize(axis);
+
+            FLOAT minDot = 1.0f;
+            for (UINT i = 0u; i < uNumIndices / 3u; ++i)
+            {
+                XMVECTOR normal = XMLoadFloat3(&aNormals[i]);
+                if (XMVectorGetX(XMVector3LengthSq(normal)) > 0.0f)
+                {
+                    minDot = std::min(minDot, XMVectorGetX(XMVector3Dot(normal, axis)));
+                }
+            }
+
+            XMStoreFloat3(&outMeshlet.ConeAxis, axis);
+            if (minDot > MESHLET_MIN_CONE_DOT)
+            {
+                outMeshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: BuildMeshlets
+
+      Summary:  Reorders the triangles of a mesh into meshlets of at
+                most MAX_MESHLET_VERTICES vertices and
+                MAX_MESHLET_TRIANGLES triangles. A meshlet starts at the
+                first triangle not yet emitted, in input order, and
+                grows over triangles sharing its vertices, preferring
+                the ones that add the fewest vertices and face the same
+                way. A meshlet ends when it is full or none of its
+                neighbours fit
+
+      Args:     const UINT* aIndices
+                  Mesh local indices of a triangle list
+                UINT uNumIndices
+                  Number of indices, a multiple of 3
+                const XMFLOAT3* aPositions
+                  First vertex position
+                UINT uPositionStride
+                  Bytes between two positions
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                UINT* aOutIndices
+                  Receives the triangles in meshlet order, may not
+                  alias aIndices
+                std::vector<Meshlet>& outMeshlets
+                  Receives the meshlets with their bounds
+    -----------------------------------------------------------------F-F*/
+    void BuildMeshlets(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumVertices,
+        _Out_writes_(uNumIndices) UINT* aOutIndices,
+        _Out_ std::vector<Meshlet>& outMeshlets
+    )
+    {
+        assert(uNumIndices % 3u == 0u);
+        assert(aIndices != aOutIndices);
+
+        outMeshlets.clear();
+
+        UINT uNumTriangles = uNumIndices / 3u;
+        std::vector<XMFLOAT3> aNormals(uNumTriangles);
+        for (UINT i = 0u; i < uNumTriangles; ++i)
+        {
+            XMVECTOR p0 = XMLoadFloat3(&GetPosition(aPositions, uPositionStride, aIndices[i * 3u]));
+            XMVECTOR p1 = XMLoadFloat3(&GetPosition(aPositions, uPositionStride, aIndices[i * 3u + 1u]));
+            XMVECTOR p2 = XMLoadFloat3(&GetPosition(aPositions, uPositionStride, aIndices[i * 3u + 2u]));
+            XMVECTOR normal = XMVector3Cross(p1 - p0, p2 - p0);
+            FLOAT length = XMVectorGetX(XMVector3Length(normal));
+            XMStoreFloat3(&aNormals[i], length > 0.0f ? normal / length : XMVectorZero());
+        }
+
+        // Triangles using each vertex
+        std::vector<UINT> aTriangleOffsets(uNumVertices + 1u, 0u);
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            assert(aIndices[i] < uNumVertices);
+            ++aTriangleOffsets[aIndices[i] + 1u];
+        }
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aTriangleOffsets[i + 1u] += aTriangleOffsets[i];
+        }
+        std::vector<UINT> aVertexTriangles(uNumIndices);
+        {
+            std::vector<UINT> aFill(aTriangleOffsets.begin(), aTriangleOffsets.end() - 1);
+            for (UINT i = 0u; i < uNumIndices; ++i)
+            {
+                aVertexTriangles[aFill[aIndices[i]]++] = i / 3u;
+            }
+        }
+
+        // Stamps are the index of the meshlet being built, so nothing
+        // has to be cleared between meshlets
+        std::vector<BOOL> aEmitted(uNumTriangles, FALSE);
+        std::vector<UINT> aVertexStamps(uNumVertices, NO_TRIANGLE);
+        std::vector<UINT> aCandidateStamps(uNumTriangles, NO_TRIANGLE);
+        std::vector<UINT> aCandidates;
+        std::vector<XMFLOAT3> aMeshletNormals;
+        aMeshletNormals.reserve(MAX_MESHLET_TRIANGLES);
+
+        UINT uNumEmitted = 0u;
+        UINT uNextSeed = 0u;
+        while (uNumEmitted < uNumTriangles)
+        {
+            UINT uStamp = static_cast<UINT>(outMeshlets.size());
+            UINT uBaseIndex = uNumEmitted * 3u;
+            UINT uNumMeshletVertices = 0u;
+            UINT uNumMeshletTriangles = 0u;
+            XMVECTOR normalSum = XMVectorZero();
+            aCandidates.clear();
+            aMeshletNormals.clear();
+
+            while (uNextSeed < uNumTriangles && aEmitted[uNextSeed])
+            {
+                ++uNextSeed;
+            }
+            UINT uTriangle = uNextSeed;
+
+            while (uTriangle != NO_TRIANGLE)
+            {
+                aEmitted[uTriangle] = TRUE;
+                aMeshletNormals.push_back(aNormals[uTriangle]);
+                normalSum += XMLoadFloat3(&aNormals[uTriangle]);
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    UINT uVertex = aIndices[uTriangle * 3u + j];
+                    aOutIndices[uNumEmitted * 3u + j] = uVertex;
+                    if (aVertexStamps[uVertex] != uStamp)
+                    {
+                        aVertexStamps[uVertex] = uStamp;
+                        ++uNumMeshletVertices;
+                        for (UINT k = aTriangleOffsets[uVertex]; k < aTriangleOffsets[uVertex + 1u]; ++k)
+                        {
+                            UINT uNeighbour = aVertexTriangles[k];
+                            if (!aEmitted[uNeighbour] && aCandidateStamps[uNeighbour] != uStamp)
+                            {
+                                aCandidateStamps[uNeighbour] = uStamp;
+                                aCandidates.push_back(uNeighbour);
+                            }
+                        }
+                    }
+                }
+                ++uNumEmitted;
+                ++uNumMeshletTriangles;
+
+                uTriangle = NO_TRIANGLE;
+                if (uNumMeshletTriangles == MAX_MESHLET_TRIANGLES)
+                {
+                    break;
+                }
+
+                XMVECTOR axis = XMVector3Normalize(normalSum);
+                FLOAT bestScore = FLT_MAX;
+                for (size_t c = 0u; c < aCandidates.size();)
+                {
+                    UINT uCandidate = aCandidates[c];
+                    if (aEmitted[uCandidate])
+                    {
+                        aCandidates[c] = aCandidates.back();
+                        aCandidates.pop_back();
+                        continue;
+                    }
+
+                    UINT uNumNewVertices = 0u;
+                    for (UINT j = 0u; j < 3u; ++j)
+                    {
+                        uNumNewVertices += aVertexStamps[aIndices[uCandidate * 3u + j]] != uStamp ? 1u : 0u;
+                    }
+                    if (uNumMeshletVertices + uNumNewVertices <= MAX_MESHLET_VERTICES)
+                    {
+                        FLOAT score = static_cast<FLOAT>(uNumNewVertices) +
+                            MESHLET_CONE_WEIGHT * (1.0f - XMVectorGetX(XMVector3Dot(XMLoadFloat3(&aNormals[uCandidate]), axis)));
+                        if (score < bestScore)
+                        {
+                            bestScore = score;
+                            uTriangle = uCandidate;
+                        }
+                    }
+                    ++c;
+                }
+            }
+
+            Meshlet meshlet =
+            {
+                .Center = XMFLOAT3(),
+                .Radius = 0.0f,
+                .ConeAxis = XMFLOAT3(),
+                .ConeCutoff = 1.0f,
+                .uBaseIndex = uBaseIndex,
+                .uNumIndices = uNumEmitted * 3u - uBaseIndex
+            };
+            ComputeMeshletBounds(&aOutIndices[uBaseIndex], meshlet.uNumIndices, aPositions, uPositionStride, aMeshletNormals.data(), meshlet);
+            outMeshlets.push_back(meshlet);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeFrustumPlanes
+
+      Summary:  Extracts the six clip planes of a view projection
+                matrix (Gribb and Hartmann). With a world view
+                projection matrix the planes are in object space
+
+      Args:     const XMMATRIX& viewProjection
+                  Matrix to clip space, row vector convention
+                XMVECTOR aOutPlanes[6]
+                  Receives the normalized left, right, bottom, top,
+                  near and far planes, facing inwards
+    -----------------------------------------------------------------F-F*/
+    void ComputeFrustumPlanes(_In_ const XMMATRIX& viewProjection, _Out_writes_(6) XMVECTOR aOutPlanes[6])
+    {
+        XMMATRIX columns = XMMatrixTranspose(viewProjection);
+        aOutPlanes[0] = columns.r[3] + columns.r[0];
+        aOutPlanes[1] = columns.r[3] - columns.r[0];
+        aOutPlanes[2] = columns.r[3] + columns.r[1];
+        aOutPlanes[3] = columns.r[3] - columns.r[1];
+        aOutPlanes[4] = columns.r[2];
+        aOutPlanes[5] = columns.r[3] - columns.r[2];
+        for (UINT i = 0u; i < 6u; ++i)
+        {
+            aOutPlanes[i] = XMPlaneNormalize(aOutPlanes[i]);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: IsMeshletVisible
+
+      Summary:  Tests the bounding sphere of a meshlet against the
+                frustum and its normal cone against the eye
+
+      Args:     const Meshlet& meshlet
+                  Meshlet to test
+                const XMVECTOR aPlanes[6]
+                  Frustum planes in the space of the meshlet
+                const XMVECTOR& eye
+                  Eye position in the space of the meshlet
+                BOOL bConeCulling
+                  FALSE when the space of the meshlet does not keep
+                  angles, e.g. under non-uniform scaling
+
+      Returns:  BOOL
+                  FALSE if no triangle of the meshlet can be seen
+    -----------------------------------------------------------------F-F*/
+    BOOL IsMeshletVisible(
+        _In_ const Meshlet& meshlet,
+        _In_reads_(6) const XMVECTOR aPlanes[6],
+        _In_ const XMVECTOR& eye,
+        _In_ BOOL bConeCulling
+    )
+    {
+        XMVECTOR center = XMLoadFloat3(&meshlet.Center);
+        for (UINT i = 0u; i < 6u; ++i)
+        {
+            if (XMVectorGetX(XMPlaneDotCoord(aPlanes[i], center)) < -meshlet.Radius)
+            {
+                return FALSE;
+            }
+        }
+
+        if (bConeCulling && meshlet.ConeCutoff < 1.0f)
+        {
+            XMVECTOR view = center - eye;
+            FLOAT distance = XMVectorGetX(XMVector3Length(view));
+            if (XMVectorGetX(XMVector3Dot(view, XMLoadFloat3(&meshlet.ConeAxis))) >= meshlet.ConeCutoff * distance + meshlet.Radius)
+            {
+                return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+}
@@ -0,0 +1,61 @@
+/*+===================================================================
+  File:      MESHLET.H
+
+  Summary:   Meshlet header file contains declarations of the
+             functions that cluster the triangles of an imported mesh
+             into meshlets with bounding spheres and normal cones, and
+             of the tests that cull them against the view.
+
+  Structs:   Meshlet
+
+  Functions: BuildMeshlets, ComputeFrustumPlanes, IsMeshletVisible
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    constexpr const UINT MAX_MESHLET_VERTICES = 64u;
+    constexpr const UINT MAX_MESHLET_TRIANGLES = 124u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Meshlet
+
+      Summary:  Contiguous run of triangles of a mesh. uBaseIndex
+                counts from the first index of the mesh. The meshlet is
+                backfacing for every eye with
+                dot(Center - eye, ConeAxis) >= ConeCutoff * |Center - eye| + Radius,
+                a ConeCutoff of 1 disables the test
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Meshlet
+    {
+        XMFLOAT3 Center;
+        FLOAT Radius;
+        XMFLOAT3 ConeAxis;
+        FLOAT ConeCutoff;
+        UINT uBaseIndex;
+        UINT uNumIndices;
+    };
+
+    void BuildMeshlets(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumVertices,
+        _Out_writes_(uNumIndices) UINT* aOutIndices,
+        _Out_ std::vector<Meshlet>& outMeshlets
+    );
+
+    void ComputeFrustumPlanes(_In_ const XMMATRIX& viewProjection, _Out_writes_(6) XMVECTOR aOutPlanes[6]);
+
+    BOOL IsMeshletVisible(
+        _In_ const Meshlet& meshlet,
+        _In_reads_(6) const XMVECTOR aPlanes[6],
+        _In_ const XMVECTOR& eye,
+        _In_ BOOL bConeCulling
+    );
+}
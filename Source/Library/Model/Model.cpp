@@ -1,11 +1,42 @@
 #include "Model/Model.h"
 
+#include "Model/BoneWeights.h"
+#include "Model/MeshOptimizer.h"
+#include "Model/MeshSimplifier.h"
+#include "Model/MeshSplitter.h"
+#include "Scene/AssetManager.h"
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
 
+#include <algorithm>
+#include <cmath>
+
 namespace library
 {
+    constexpr const UINT MODEL_IMPORT_FLAGS =
+        aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+        aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices |
+        aiProcess_ConvertToLeftHanded;
+
+    // A LOD is kept if it has at most this fraction of the indices of
+    // the previous one, and may move the surface by this fraction of
+    // the mesh extent
+    constexpr const FLOAT LOD_MIN_REDUCTION = 0.9f;
+    constexpr const FLOAT LOD_MAX_RELATIVE_ERROR = 0.05f;
+
+    // Projected radius over half the viewport height below which LOD
+    // i + 1 is used instead of LOD i, and the band around it in which
+    // the current LOD is kept so that models do not pop back and forth
+    constexpr const FLOAT LOD_SCREEN_SIZES[Renderable::MAX_MESH_LODS] = { 0.5f, 0.25f, 0.125f };
+    constexpr const FLOAT LOD_HYSTERESIS = 0.1f;
+
+    // Poses per second of animation that the clip bounds are taken
+    // over, and the most poses sampled for a single clip
+    constexpr const FLOAT CLIP_BOUNDS_SAMPLE_RATE = 30.0f;
+    constexpr const UINT MAX_CLIP_BOUNDS_SAMPLES = 1024u;
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   ConvertMatrix
      Summary:  Convert aiMatrix4x4 to XMMATRIX
@@ -54,7 +85,30 @@ namespace library
         return XMLoadFloat4(&float4);
     }
 
-    std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GetTexturePath
+      Summary:  Returns the path of the first texture of the given type,
+                relative to the model, or an empty string
+      Returns:  std::string
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::string GetTexturePath(_In_ const aiMaterial* pMaterial, _In_ aiTextureType textureType)
+    {
+        aiString aiPath;
+        if (pMaterial->GetTextureCount(textureType) == 0u ||
+            pMaterial->GetTexture(textureType, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) != AI_SUCCESS)
+        {
+            return std::string();
+        }
+
+        std::string szPath(aiPath.data);
+        if (szPath.substr(0ull, 2ull) == ".\\")
+        {
+            szPath = szPath.substr(2ull, szPath.size() - 2ull);
+        }
+
+        return szPath;
+    }
+
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Model
@@ -62,36 +116,158 @@ namespace library
       Args:     const std::filesystem::path& filePath
                   Path to the model to load
       Modifies: [m_filePath, m_animationBuffer, m_skinningConstantBuffer,
-                 m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
-                 m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
-                 m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-                 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+                 m_quantizedVertexBuffer, m_quantizationConstantBuffer,
+                 m_aVertices, m_aAnimationData, m_aIndices, m_aIndexData,
+                 m_aBoneData, m_aBoneInfo, m_aTransforms,
+                 m_boneNameToIndexMap, m_aMaterialTextures,
+                 m_aSkeletonNodes, m_aAnimations, m_aNodeTransforms,
+                 m_aMeshlets, m_aDrawRanges, m_aDrawRangeOffsets,
+                 m_aClipBoundingBoxes, m_timeSinceLoaded, m_bSplitLargeMeshes,
+                 m_bQuantizeVertices, m_bGenerateLods, m_uLod,
+                 m_bBuildMeshlets, m_bImported, m_cookedMeshKey,
+                 m_snapshotPath, m_ullSnapshotOffset, m_uSnapshotSize,
+                 m_globalInverseTransform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Model::Model(_In_ const std::filesystem::path& filePath) :
         Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)),
         m_filePath(filePath),
         m_animationBuffer(nullptr),
         m_skinningConstantBuffer(nullptr),
+        m_quantizedVertexBuffer(nullptr),
+        m_quantizationConstantBuffer(nullptr),
         m_aVertices(std::vector<SimpleVertex>()),
         m_aAnimationData(std::vector<AnimationData>()),
-        m_aIndices(std::vector<WORD>()),
+        m_aIndices(std::vector<UINT>()),
+        m_aIndexData(std::vector<BYTE>()),
         m_aBoneData(std::vector<VertexBoneData>()),
         m_aBoneInfo(std::vector<BoneInfo>()),
         m_aTransforms(std::vector<XMMATRIX>()),
         m_boneNameToIndexMap(std::unordered_map<std::string, UINT>()),
-        m_pScene(nullptr),
+        m_aMaterialTextures(std::vector<MaterialTextures>()),
+        m_aSkeletonNodes(std::vector<SkeletonNode>()),
+        m_aAnimations(std::vector<AnimationClip>()),
+        m_aNodeTransforms(std::vector<XMMATRIX>()),
+        m_aMeshlets(std::vector<Meshlet>()),
+        m_aDrawRanges(std::vector<IndexRange>()),
+        m_aDrawRangeOffsets(std::vector<UINT>()),
+        m_aClipBoundingBoxes(std::vector<BoundingBox>()),
         m_timeSinceLoaded(0.0f),
+        m_bSplitLargeMeshes(TRUE),
+        m_bQuantizeVertices(FALSE),
+        m_bGenerateLods(TRUE),
+        m_uLod(0u),
+        m_bBuildMeshlets(TRUE),
+        m_bImported(FALSE),
+        m_cookedMeshKey(),
+        m_snapshotPath(),
+        m_ullSnapshotOffset(0ull),
+        m_uSnapshotSize(0u),
         m_globalInverseTransform(XMMATRIX())
     {}
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::Import
+      Summary:  Loads the 3d model from the scene snapshot, the cooked
+                mesh or with Assimp and reads the files of its textures.
+                The snapshot was checked by the scene, so the source is
+                not hashed for it. Does not touch the device, so models
+                can be imported on worker threads
+      Modifies: [m_globalInverseTransform, m_aMaterials, m_bImported,
+                 m_cookedMeshKey].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::Import()
+    {
+        HRESULT hr = S_OK;
+
+        LARGE_INTEGER startingTime = {};
+        LARGE_INTEGER endingTime = {};
+        LARGE_INTEGER frequency = {};
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        std::string szCookVariant = getCookVariantName();
+        std::filesystem::path cachePath = GetMeshCachePath(m_filePath, szCookVariant.c_str());
+
+        BOOL bLoadedFromSnapshot = !m_snapshotPath.empty() &&
+            SUCCEEDED(loadFromCache(m_snapshotPath, m_cookedMeshKey, m_ullSnapshotOffset, m_uSnapshotSize));
+        BOOL bLoadedFromCache = bLoadedFromSnapshot;
+        if (!bLoadedFromSnapshot)
+        {
+            hr = ComputeMeshCacheKey(m_filePath, MODEL_IMPORT_FLAGS, szCookVariant.c_str(), m_cookedMeshKey);
+            if (FAILED(hr))
+            {
+                OutputDebugString(L"Error reading ");
+                OutputDebugString(m_filePath.c_str());
+                OutputDebugString(L"\n");
+                return hr;
+            }
+
+            bLoadedFromCache = SUCCEEDED(loadFromCache(cachePath, m_cookedMeshKey));
+        }
+        if (!bLoadedFromCache)
+        {
+            Assimp::Importer& importer = getImporter();
+            const aiScene* pScene = importer.ReadFile(m_filePath.string().c_str(), MODEL_IMPORT_FLAGS);
+            if (!pScene)
+            {
+                OutputDebugString(L"Error parsing ");
+                OutputDebugString(m_filePath.c_str());
+                OutputDebugString(L": ");
+                OutputDebugStringA(importer.GetErrorString());
+                OutputDebugString(L"\n");
+                return E_FAIL;
+            }
+
+            initFromScene(pScene);
+
+            // Everything needed was copied out, the scene can go
+            importer.FreeScene();
+
+            if (FAILED(saveToCache(cachePath, m_cookedMeshKey)))
+            {
+                OutputDebugString(L"Could not write cooked mesh ");
+                OutputDebugString(cachePath.c_str());
+                OutputDebugString(L"\n");
+            }
+        }
+
+        QueryPerformanceCounter(&endingTime);
+        FLOAT elapsedMilliseconds = static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart);
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Loaded %s %s in %.2f ms\n",
+            m_filePath.filename().c_str(),
+            bLoadedFromSnapshot ? L"from the scene snapshot" : bLoadedFromCache ? L"from the cooked mesh" : L"with Assimp",
+            elapsedMilliseconds
+        );
+        OutputDebugString(szMessage);
+
+        initBounds();
+        initClipBounds();
+
+        hr = initMaterials(m_filePath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_bImported = TRUE;
+
+        return hr;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Initialize
-      Summary:  Load and initialize the 3d model and create buffers
+      Summary:  Imports the 3d model unless Import was called already,
+                creates its textures and buffers
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
-      Modifies: [m_pScene, m_globalInverseTransform, m_animationBuffer,
+      Modifies: [m_aMaterials, m_animationBuffer,
                  m_skinningConstantBuffer].
       Returns:  HRESULT
                   Status code
@@ -100,31 +276,30 @@ namespace library
     {
         HRESULT hr = S_OK;
 
-        // Create the buffers for the vertices attributes
-        
-
-        m_pScene = sm_pImporter->ReadFile(m_filePath.string().c_str(),
-            aiProcess_Triangulate | aiProcess_GenSmoothNormals |
-            aiProcess_CalcTangentSpace | aiProcess_ConvertToLeftHanded
-        );
+        if (!m_bImported)
+        {
+            hr = Import();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
 
-        if (m_pScene)
+        for (const std::shared_ptr<Material>& material : m_aMaterials)
         {
-            XMMATRIX rootNodeTransform = ConvertMatrix(m_pScene->mRootNode->mTransformation);
-            XMVECTOR det = XMMatrixDeterminant(rootNodeTransform);
-            m_globalInverseTransform = XMMatrixInverse(&det, rootNodeTransform);;
-            hr = initFromScene(pDevice, pImmediateContext, m_pScene, m_filePath);
+            hr = material->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
         }
-        else
+
+        hr = initialize(pDevice, pImmediateContext);
+        if (FAILED(hr))
         {
-            hr = E_FAIL;
-            OutputDebugString(L"Error parsing ");
-            OutputDebugString(m_filePath.c_str());
-            OutputDebugString(L": ");
-            OutputDebugStringA(sm_pImporter->GetErrorString());
-            OutputDebugString(L"\n");
             return hr;
         }
+
         D3D11_BUFFER_DESC animationBd = {
             .ByteWidth = sizeof(AnimationData) * (UINT)m_aAnimationData.size(),
             .Usage = D3D11_USAGE_DEFAULT,
@@ -154,6 +329,15 @@ namespace library
         {
             return hr;
         }
+
+        if (m_bQuantizeVertices)
+        {
+            hr = initQuantizedVertices(pDevice);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
         return hr;
     }
 
@@ -167,25 +351,19 @@ namespace library
     void Model::Update(_In_ FLOAT deltaTime)
     {
         m_timeSinceLoaded += deltaTime;
-        if (m_pScene->HasAnimations())
+        if (!m_aAnimations.empty() && !m_aSkeletonNodes.empty())
         {
-            FLOAT ticksPerSecond =
-                static_cast<FLOAT>(m_pScene->mAnimations[0]->mTicksPerSecond !=
-                    0.0 ? m_pScene->mAnimations[0]->mTicksPerSecond : 25.0f);
+            const AnimationClip& clip = m_aAnimations[0];
+            FLOAT ticksPerSecond = clip.TicksPerSecond != 0.0f ? clip.TicksPerSecond : 25.0f;
             FLOAT timeInTicks = m_timeSinceLoaded * ticksPerSecond;
-            FLOAT animationTimeTicks = fmod(timeInTicks,
-                static_cast<FLOAT>(m_pScene->mAnimations[0]->mDuration));
-            if (m_pScene->mRootNode)
+            FLOAT animationTimeTicks = fmod(timeInTicks, clip.Duration);
+
+            readNodeHierarchy(animationTimeTicks, clip);
+            m_aTransforms.resize(m_aBoneInfo.size());
+            for (UINT i = 0; i < m_aTransforms.size(); i++)
             {
-                XMMATRIX identity = XMMatrixIdentity();
-                readNodeHierarchy(animationTimeTicks, m_pScene->mRootNode, identity);
-                m_aTransforms.resize(m_aBoneInfo.size());
-                for (UINT i = 0; i < m_aTransforms.size(); i++)
-                {
-                    m_aTransforms[i] = m_aBoneInfo[i].FinalTransformation;
-                }
+                m_aTransforms[i] = m_aBoneInfo[i].FinalTransformation;
             }
-
         }
     }
 
@@ -209,6 +387,26 @@ namespace library
         return m_skinningConstantBuffer;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetQuantizedVertexBuffer
+      Summary:  Returns the QuantizedVertex buffer
+      Returns:  ComPtr<ID3D11Buffer>&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetQuantizedVertexBuffer()
+    {
+        return m_quantizedVertexBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetQuantizationConstantBuffer
+      Summary:  Returns the constant buffer with the quantization box
+      Returns:  ComPtr<ID3D11Buffer>&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetQuantizationConstantBuffer()
+    {
+        return m_quantizationConstantBuffer;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::GetNumVertices
       Summary:  Returns the number of vetices
@@ -226,7 +424,13 @@ namespace library
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     UINT Model::GetNumIndices() const
     {
-        return static_cast<UINT>(m_aIndices.size());
+        UINT uNumIndices = 0u;
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            uNumIndices += mesh.uNumIndices;
+        }
+
+        return uNumIndices;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -249,6 +453,321 @@ namespace library
         return m_boneNameToIndexMap;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SkinVerticesOnCpu
+        Summary:  Skins the vertices with the bone transforms of the
+                  last Update, bind pose if the model was never updated
+        Args:     const SkinnedVertexStreams& outStreams
+                    Receives GetNumVertices skinned vertices
+                  ThreadPool* pThreadPool
+                    Pool to split the work on, may be nullptr
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SkinVerticesOnCpu(_In_ const SkinnedVertexStreams& outStreams, _In_opt_ ThreadPool* pThreadPool) const
+    {
+        std::vector<XMMATRIX> aBindPose;
+        const std::vector<XMMATRIX>* pBoneTransforms = &m_aTransforms;
+        if (m_aTransforms.empty())
+        {
+            aBindPose.resize(m_aBoneInfo.empty() ? 1u : m_aBoneInfo.size(), XMMatrixIdentity());
+            pBoneTransforms = &aBindPose;
+        }
+
+        SkinVertices(
+            m_aVertices.data(),
+            m_aNormalData.empty() ? nullptr : m_aNormalData.data(),
+            m_aAnimationData.data(),
+            GetNumVertices(),
+            pBoneTransforms->data(),
+            static_cast<UINT>(pBoneTransforms->size()),
+            outStreams,
+            pThreadPool
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetSplitLargeMeshes
+        Summary:  Chooses how meshes with more than MAX_INDEX16_VERTICES
+                  vertices are imported. Has to be called before
+                  Initialize
+        Args:     BOOL bSplitLargeMeshes
+                    TRUE to split them into 16-bit addressable submeshes,
+                    FALSE to draw them with 32-bit indices
+        Modifies: [m_bSplitLargeMeshes].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetSplitLargeMeshes(_In_ BOOL bSplitLargeMeshes)
+    {
+        m_bSplitLargeMeshes = bSplitLargeMeshes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetQuantizeVertices
+        Summary:  Chooses whether Initialize also creates a
+                  QuantizedVertex buffer, to be drawn with a
+                  QuantizedVertexShader
+        Args:     BOOL bQuantizeVertices
+                    TRUE to create the quantized vertices
+        Modifies: [m_bQuantizeVertices].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetQuantizeVertices(_In_ BOOL bQuantizeVertices)
+    {
+        m_bQuantizeVertices = bQuantizeVertices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::HasQuantizedVertices
+        Summary:  Returns whether the QuantizedVertex buffer exists
+        Returns:  BOOL
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::HasQuantizedVertices() const
+    {
+        return m_quantizedVertexBuffer != nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetGenerateLods
+        Summary:  Chooses whether Initialize builds a LOD chain for
+                  every mesh. Has to be called before Initialize
+        Args:     BOOL bGenerateLods
+                    TRUE to build the LODs
+        Modifies: [m_bGenerateLods].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetGenerateLods(_In_ BOOL bGenerateLods)
+    {
+        m_bGenerateLods = bGenerateLods;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SelectLod
+        Summary:  Picks the LOD from the projected size of the bounding
+                  sphere. A LOD is only left once the size is
+                  LOD_HYSTERESIS past its threshold
+        Args:     const XMVECTOR& eye
+                    Position of the camera
+                  FLOAT projectionScale
+                    Cotangent of half the vertical field of view
+        Modifies: [m_uLod].
+        Returns:  UINT
+                    Selected LOD, meshes clamp it to their own chain
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::SelectLod(_In_ const XMVECTOR& eye, _In_ FLOAT projectionScale)
+    {
+        XMMATRIX world = GetWorldMatrix();
+        XMVECTOR center = XMVector3Transform(XMLoadFloat3(&m_boundingBox.Center), world);
+        FLOAT scale = std::max({
+            XMVectorGetX(XMVector3Length(world.r[0])),
+            XMVectorGetX(XMVector3Length(world.r[1])),
+            XMVectorGetX(XMVector3Length(world.r[2]))
+        });
+        FLOAT distance = std::max(XMVectorGetX(XMVector3Length(center - eye)), 1e-4f);
+        FLOAT radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&m_boundingBox.Extents)));
+        FLOAT screenSize = radius * scale * projectionScale / distance;
+
+        while (m_uLod < MAX_MESH_LODS && screenSize < LOD_SCREEN_SIZES[m_uLod] * (1.0f - LOD_HYSTERESIS))
+        {
+            ++m_uLod;
+        }
+        while (m_uLod > 0u && screenSize > LOD_SCREEN_SIZES[m_uLod - 1u] * (1.0f + LOD_HYSTERESIS))
+        {
+            --m_uLod;
+        }
+
+        return m_uLod;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetLod
+        Summary:  Returns the LOD picked by the last SelectLod
+        Returns:  UINT
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetLod() const
+    {
+        return m_uLod;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetBuildMeshlets
+        Summary:  Chooses whether Initialize splits every mesh into
+                  meshlets that CullMeshlets can reject. Has to be
+                  called before Initialize
+        Args:     BOOL bBuildMeshlets
+                    TRUE to build the meshlets
+        Modifies: [m_bBuildMeshlets].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetBuildMeshlets(_In_ BOOL bBuildMeshlets)
+    {
+        m_bBuildMeshlets = bBuildMeshlets;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::CullMeshlets
+        Summary:  Tests the meshlets of every mesh against the frustum
+                  and their normal cones against the eye, and merges
+                  the survivors that are adjacent in the index buffer
+                  into draw ranges. Only LOD 0 is clustered and
+                  animated models move away from their bind pose
+                  bounds, otherwise every mesh gets the single range
+                  of the LOD picked by SelectLod. Has to be called
+                  after SelectLod every frame
+        Args:     const XMMATRIX& viewProjection
+                    View projection matrix of the camera
+                  const XMVECTOR& eye
+                    Position of the camera
+        Modifies: [m_aDrawRanges, m_aDrawRangeOffsets].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::CullMeshlets(_In_ const XMMATRIX& viewProjection, _In_ const XMVECTOR& eye)
+    {
+        m_aDrawRanges.clear();
+        m_aDrawRangeOffsets.resize(m_aMeshes.size() + 1u);
+
+        // The meshlets are tested in object space, the frustum of the
+        // world view projection matrix and the eye are brought there
+        XMMATRIX world = GetWorldMatrix();
+        XMVECTOR aPlanes[6];
+        ComputeFrustumPlanes(world * viewProjection, aPlanes);
+        XMVECTOR localEye = XMVector3Transform(eye, XMMatrixInverse(nullptr, world));
+
+        // Normals only keep their angles under uniform scaling
+        FLOAT aScales[3] =
+        {
+            XMVectorGetX(XMVector3Length(world.r[0])),
+            XMVectorGetX(XMVector3Length(world.r[1])),
+            XMVectorGetX(XMVector3Length(world.r[2]))
+        };
+        BOOL bConeCulling = *std::max_element(aScales, aScales + 3) <= *std::min_element(aScales, aScales + 3) * 1.01f;
+        BOOL bCullMeshlets = m_uLod == 0u && m_aAnimations.empty();
+
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            m_aDrawRangeOffsets[i] = static_cast<UINT>(m_aDrawRanges.size());
+            if (!bCullMeshlets || mesh.uNumMeshlets == 0u)
+            {
+                m_aDrawRanges.push_back(mesh.GetLodRange(m_uLod));
+                continue;
+            }
+
+            for (UINT j = 0u; j < mesh.uNumMeshlets; ++j)
+            {
+                const Meshlet& meshlet = m_aMeshlets[mesh.uBaseMeshlet + j];
+                if (!IsMeshletVisible(meshlet, aPlanes, localEye, bConeCulling))
+                {
+                    continue;
+                }
+
+                UINT uBaseIndex = mesh.uBaseIndex + meshlet.uBaseIndex;
+                if (m_aDrawRanges.size() > m_aDrawRangeOffsets[i] &&
+                    m_aDrawRanges.back().uBaseIndex + m_aDrawRanges.back().uNumIndices == uBaseIndex)
+                {
+                    m_aDrawRanges.back().uNumIndices += meshlet.uNumIndices;
+                }
+                else
+                {
+                    m_aDrawRanges.push_back({ meshlet.uNumIndices, uBaseIndex });
+                }
+            }
+        }
+
+        m_aDrawRangeOffsets.back() = static_cast<UINT>(m_aDrawRanges.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetDrawRanges
+        Summary:  Returns the ranges of a mesh gathered by the last
+                  CullMeshlets
+        Args:     UINT uMeshIndex
+                    Index of the mesh
+                  UINT& uOutNumRanges
+                    Receives the number of ranges, 0 if the whole mesh
+                    was culled or CullMeshlets was not called yet
+        Returns:  const IndexRange*
+                    Ranges to draw with the index format of the mesh
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Model::IndexRange* Model::GetDrawRanges(_In_ UINT uMeshIndex, _Out_ UINT& uOutNumRanges) const
+    {
+        if (uMeshIndex + 1u >= m_aDrawRangeOffsets.size())
+        {
+            uOutNumRanges = 0u;
+            return nullptr;
+        }
+
+        uOutNumRanges = m_aDrawRangeOffsets[uMeshIndex + 1u] - m_aDrawRangeOffsets[uMeshIndex];
+        return m_aDrawRanges.data() + m_aDrawRangeOffsets[uMeshIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetClipBoundingBox
+        Summary:  Returns the object space box holding the skinned
+                  vertices in every sampled pose of a clip
+        Args:     UINT uClip
+                    Index of the animation clip
+        Returns:  const BoundingBox&
+                    Bounding box of the clip
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& Model::GetClipBoundingBox(_In_ UINT uClip) const
+    {
+        assert(uClip < m_aClipBoundingBoxes.size());
+        return m_aClipBoundingBoxes[uClip];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetFilePath
+      Summary:  Returns the path of the model file
+      Returns:  const std::filesystem::path&
+                  Path given to the constructor
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Model::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetCookedMeshPath
+      Summary:  Returns the path of the cooked mesh Import reads and
+                writes with the current settings
+      Returns:  std::filesystem::path
+                  Path to the cooked mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path Model::GetCookedMeshPath() const
+    {
+        return GetMeshCachePath(m_filePath, getCookVariantName().c_str());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetCookedMeshKey
+      Summary:  Returns the key of the cooked mesh the last Import
+                loaded or wrote
+      Returns:  const MeshCacheKey&
+                  Key of the import
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const MeshCacheKey& Model::GetCookedMeshKey() const
+    {
+        return m_cookedMeshKey;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetSnapshotSource
+      Summary:  Makes the next Import read the cooked mesh from a range
+                of a scene snapshot. Falls back to the cooked mesh file
+                or Assimp if the range does not hold the given key
+      Args:     const std::filesystem::path& snapshotPath
+                  Path to the scene snapshot
+                UINT64 ullOffset
+                  Offset of the cooked mesh in the snapshot
+                SIZE_T uSize
+                  Size of the cooked mesh
+                const MeshCacheKey& key
+                  Key of the import the cooked mesh was made from
+      Modifies: [m_snapshotPath, m_ullSnapshotOffset, m_uSnapshotSize,
+                 m_cookedMeshKey].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetSnapshotSource(_In_ const std::filesystem::path& snapshotPath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize, _In_ const MeshCacheKey& key)
+    {
+        m_snapshotPath = snapshotPath;
+        m_ullSnapshotOffset = ullOffset;
+        m_uSnapshotSize = uSize;
+        m_cookedMeshKey = key;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::countVerticesAndIndices
         Summary:  Fill the BasicMeshEntry information
@@ -274,50 +793,23 @@ namespace library
         }
     }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::findNodeAnimOrNull
-        Summary:  Find the aiNodeAnim with the givne node name in the given animation
-        Args:     const aiAnimation* pAnimation
-                    Pointer to an assimp animation object
-                  PCSTR pszNodeName
-                    Node name to find
-
-        Returns:  aiNodeAnim* or nullptr
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const aiNodeAnim* Model::findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName)
-    {
-        for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
-        {
-            const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
-
-            if (strncmp(pNodeAnim->mNodeName.data, pszNodeName, pNodeAnim->mNodeName.length) == 0)
-            {
-                return pNodeAnim;
-            }
-        }
-
-        return nullptr;
-    }
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::findPosition
         Summary:  Find the index of the position key right before the given animation time
         Args:     FLOAT animationTimeTicks
                     Animation time
-                  const aiNodeAnim* pNodeAnim
-                     Pointer to an assimp node anim object
+                  const AnimationChannel& channel
+                     Key frames of the node
         Returns:  UINT
                     Index of the key
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    UINT Model::findPosition(_In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel)
     {
-        assert(pNodeAnim->mNumPositionKeys > 0);
+        assert(!channel.aPositionKeys.empty());
 
-        for (UINT i = 0; i < pNodeAnim->mNumPositionKeys - 1; ++i)
+        for (UINT i = 0; i < channel.aPositionKeys.size() - 1; ++i)
         {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mPositionKeys[i + 1].mTime);
-
-            if (animationTimeTicks < t)
+            if (animationTimeTicks < channel.aPositionKeys[i + 1].Time)
             {
                 return i;
             }
@@ -331,20 +823,18 @@ namespace library
         Summary:  Find the index of the rotation key right before the given animation time
         Args:     FLOAT animationTimeTicks
                     Animation time
-                  const aiNodeAnim* pNodeAnim
-                     Pointer to an assimp node anim object
+                  const AnimationChannel& channel
+                     Key frames of the node
         Returns:  UINT
                     Index of the key
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    UINT Model::findRotation(_In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel)
     {
-        assert(pNodeAnim->mNumRotationKeys > 0);
+        assert(!channel.aRotationKeys.empty());
 
-        for (UINT i = 0u; i < pNodeAnim->mNumRotationKeys - 1; ++i)
+        for (UINT i = 0u; i < channel.aRotationKeys.size() - 1; ++i)
         {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mRotationKeys[i + 1].mTime);
-
-            if (animationTimeTicks < t)
+            if (animationTimeTicks < channel.aRotationKeys[i + 1].Time)
             {
                 return i;
             }
@@ -358,20 +848,18 @@ namespace library
         Summary:  Find the index of the scaling key right before the given animation time
         Args:     FLOAT animationTimeTicks
                     Animation time
-                  const aiNodeAnim* pNodeAnim
-                     Pointer to an assimp node anim object
+                  const AnimationChannel& channel
+                     Key frames of the node
         Returns:  UINT
                     Index of the key
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    UINT Model::findScaling(_In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel)
     {
-        assert(pNodeAnim->mNumScalingKeys > 0);
+        assert(!channel.aScalingKeys.empty());
 
-        for (UINT i = 0u; i < pNodeAnim->mNumScalingKeys - 1; ++i)
+        for (UINT i = 0u; i < channel.aScalingKeys.size() - 1; ++i)
         {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mScalingKeys[i + 1].mTime);
-
-            if (animationTimeTicks < t)
+            if (animationTimeTicks < channel.aScalingKeys[i + 1].Time)
             {
                 return i;
             }
@@ -407,6 +895,59 @@ namespace library
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getImporter
+      Summary:  Returns the importer of the calling thread. An importer
+                owns the scene it returns and frees it on the next
+                ReadFile, so every thread that imports needs its own
+      Returns:  Assimp::Importer&
+                  Importer of this thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Assimp::Importer& Model::getImporter()
+    {
+        thread_local Assimp::Importer s_importer;
+        return s_importer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getCookVariant
+      Summary:  Returns the name of the cook variant, subclasses that
+                build their meshes differently return their own so they
+                do not share cooked meshes with Model
+      Returns:  PCSTR
+                  Name of the variant
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCSTR Model::getCookVariant() const
+    {
+        return "model";
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getCookVariantName
+      Summary:  Returns the cook variant with the import settings that
+                change the cooked mesh appended
+      Returns:  std::string
+                  Name of the variant
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::string Model::getCookVariantName() const
+    {
+        std::string szCookVariant = getCookVariant();
+        if (!m_bSplitLargeMeshes)
+        {
+            szCookVariant += ".index32";
+        }
+        if (!m_bGenerateLods)
+        {
+            szCookVariant += ".nolod";
+        }
+        if (!m_bBuildMeshlets)
+        {
+            szCookVariant += ".nomeshlet";
+        }
+
+        return szCookVariant;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::getVertices
       Summary:  Returns the vertices data
@@ -420,13 +961,53 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::getIndices
-      Summary:  Returns the indices data
+      Summary:  Returns the 16-bit indices, which are stored at the
+                start of the index data
       Returns:  const WORD*
                   Array of indices
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     const WORD* Model::getIndices() const
     {
-        return m_aIndices.data();
+        return reinterpret_cast<const WORD*>(m_aIndexData.data());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getIndexData
+      Summary:  Returns the packed 16-bit and 32-bit indices
+      Returns:  const void*
+                  Index buffer data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* Model::getIndexData() const
+    {
+        return m_aIndexData.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getIndexDataSize
+      Summary:  Returns the size of the packed indices
+      Returns:  UINT
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::getIndexDataSize() const
+    {
+        return static_cast<UINT>(m_aIndexData.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getNumMeshVertices
+      Summary:  Returns the number of vertices of a mesh while
+                importing, meshes own consecutive vertex ranges
+      Args:     UINT uMeshIndex
+                  Index of the mesh
+      Returns:  UINT
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::getNumMeshVertices(_In_ UINT uMeshIndex) const
+    {
+        UINT uEndVertex = uMeshIndex + 1u < m_aMeshes.size() ?
+            m_aMeshes[uMeshIndex + 1u].uBaseVertex : static_cast<UINT>(m_aVertices.size());
+
+        return uEndVertex - m_aMeshes[uMeshIndex].uBaseVertex;
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Model::initAllMeshes
@@ -444,30 +1025,87 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::initFromScene
+      Method:   Model::initAnimations
 
-      Summary:  Initialize all meshes in a given assimp scene
+      Summary:  Copies the animations of a given assimp scene into clips
+                indexed by skeleton node
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const aiScene* pScene
+      Args:     const aiScene* pScene
                   Assimp scene
-                const std::filesystem::path& filePath
-                  Path to the model
 
-      Returns:  HRESULT
-                  Status code
+      Modifies: [m_aAnimations].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::initFromScene(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const aiScene* pScene,
-        _In_ const std::filesystem::path& filePath
-    )
+    void Model::initAnimations(_In_ const aiScene* pScene)
     {
-        HRESULT hr = S_OK;
+        std::unordered_map<std::string, UINT> nodeNameToIndexMap;
+        for (UINT i = 0u; i < m_aSkeletonNodes.size(); ++i)
+        {
+            nodeNameToIndexMap.emplace(m_aSkeletonNodes[i].szName, i);
+        }
+
+        m_aAnimations.resize(pScene->mNumAnimations);
+        for (UINT i = 0u; i < pScene->mNumAnimations; ++i)
+        {
+            const aiAnimation* pAnimation = pScene->mAnimations[i];
+            AnimationClip& clip = m_aAnimations[i];
+            clip.Duration = static_cast<FLOAT>(pAnimation->mDuration);
+            clip.TicksPerSecond = static_cast<FLOAT>(pAnimation->mTicksPerSecond);
+            clip.aNodeChannels.assign(m_aSkeletonNodes.size(), -1);
+
+            for (UINT j = 0u; j < pAnimation->mNumChannels; ++j)
+            {
+                const aiNodeAnim* pNodeAnim = pAnimation->mChannels[j];
+                auto iNodeIndex = nodeNameToIndexMap.find(pNodeAnim->mNodeName.C_Str());
+                if (iNodeIndex == nodeNameToIndexMap.end() ||
+                    pNodeAnim->mNumPositionKeys == 0u || pNodeAnim->mNumRotationKeys == 0u || pNodeAnim->mNumScalingKeys == 0u)
+                {
+                    continue;
+                }
+
+                AnimationChannel channel;
+                channel.uNodeIndex = iNodeIndex->second;
+                channel.aPositionKeys.reserve(pNodeAnim->mNumPositionKeys);
+                for (UINT k = 0u; k < pNodeAnim->mNumPositionKeys; ++k)
+                {
+                    const aiVectorKey& key = pNodeAnim->mPositionKeys[k];
+                    channel.aPositionKeys.push_back({ static_cast<FLOAT>(key.mTime), ConvertVector3dToFloat3(key.mValue) });
+                }
+                channel.aRotationKeys.reserve(pNodeAnim->mNumRotationKeys);
+                for (UINT k = 0u; k < pNodeAnim->mNumRotationKeys; ++k)
+                {
+                    const aiQuatKey& key = pNodeAnim->mRotationKeys[k];
+                    channel.aRotationKeys.push_back({ static_cast<FLOAT>(key.mTime), XMFLOAT4(key.mValue.x, key.mValue.y, key.mValue.z, key.mValue.w) });
+                }
+                channel.aScalingKeys.reserve(pNodeAnim->mNumScalingKeys);
+                for (UINT k = 0u; k < pNodeAnim->mNumScalingKeys; ++k)
+                {
+                    const aiVectorKey& key = pNodeAnim->mScalingKeys[k];
+                    channel.aScalingKeys.push_back({ static_cast<FLOAT>(key.mTime), ConvertVector3dToFloat3(key.mValue) });
+                }
+
+                clip.aNodeChannels[channel.uNodeIndex] = static_cast<INT>(clip.aChannels.size());
+                clip.aChannels.push_back(std::move(channel));
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initFromScene
+
+      Summary:  Copies the meshes, material textures, skeleton and
+                animations of a given assimp scene, so that the scene
+                is not needed after importing
+
+      Args:     const aiScene* pScene
+                  Assimp scene
+
+      Modifies: [m_aMeshes, m_globalInverseTransform].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initFromScene(_In_ const aiScene* pScene)
+    {
+        XMMATRIX rootNodeTransform = ConvertMatrix(pScene->mRootNode->mTransformation);
+        XMVECTOR det = XMMatrixDeterminant(rootNodeTransform);
+        m_globalInverseTransform = XMMatrixInverse(&det, rootNodeTransform);
 
         m_aMeshes.resize(pScene->mNumMeshes);
 
@@ -480,56 +1118,50 @@ namespace library
 
         initAllMeshes(pScene);
 
-        hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
-        if (FAILED(hr))
+        if (m_bSplitLargeMeshes)
         {
-            return hr;
+            splitLargeMeshes();
         }
 
-        for (size_t i = 0; i < m_aVertices.size(); ++i)
+        optimizeMeshes();
+
+        if (m_bGenerateLods)
         {
-            m_aAnimationData.push_back(
-                AnimationData
-                {
-                    .aBoneIndices = XMUINT4(m_aBoneData.at(i).aBoneIds),
-                    .aBoneWeights = XMFLOAT4(m_aBoneData.at(i).aWeights)
-                }
-            );
+            buildLods();
         }
 
-        hr = initialize(pDevice, pImmediateContext);
-        if (FAILED(hr))
+        if (m_bBuildMeshlets)
         {
-            return hr;
+            buildMeshlets();
         }
 
-        return hr;
+        initIndexData();
+
+        initMaterialTextures(pScene);
+
+        initAnimationData();
+
+        initSkeleton(pScene->mRootNode, -1);
+
+        initAnimations(pScene);
     }
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initMaterials
 
-      Summary:  Initialize all materials in a given assimp scene
+      Summary:  Creates the materials and reads the files of their
+                textures
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const aiScene* pScene
-                  Assimp scene
-                const std::filesystem::path& filePath
+      Args:     const std::filesystem::path& filePath
                   Path to the model
 
+      Modifies: [m_aMaterials].
+
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::initMaterials(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const aiScene* pScene,
-        _In_ const std::filesystem::path& filePath
-    )
+    HRESULT Model::initMaterials(_In_ const std::filesystem::path& filePath)
     {
         HRESULT hr = S_OK;
 
@@ -537,22 +1169,477 @@ namespace library
         std::filesystem::path parentDirectory = filePath.parent_path();
 
         // Initialize the materials
-        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
+        for (UINT i = 0u; i < m_aMaterialTextures.size(); ++i)
         {
-            const aiMaterial* pMaterial = pScene->mMaterials[i];
-
             std::string szName = filePath.string() + std::to_string(i);
             std::wstring pwszName(szName.length(), L' ');
             std::copy(szName.begin(), szName.end(), pwszName.begin());
             m_aMaterials.push_back(std::make_shared<Material>(pwszName));
 
-            loadTextures(pDevice, pImmediateContext, parentDirectory, pMaterial, i);
+            loadTextures(parentDirectory, i);
         }
 
         return hr;
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initAnimationData
+
+      Summary:  Reduces the gathered bone influences of every vertex to
+                NUM_BONE_INFLUENCES renormalized weights, packs them into
+                the vertex stream and releases the import-time bone data
+
+      Modifies: [m_aAnimationData, m_aBoneData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initAnimationData()
+    {
+        m_aAnimationData.resize(m_aBoneData.size());
+        for (size_t i = 0; i < m_aBoneData.size(); ++i)
+        {
+            const VertexBoneData& boneData = m_aBoneData[i];
+            m_aAnimationData[i] = PackBoneWeights(boneData.aBoneIds, boneData.aWeights, boneData.uNumBones);
+        }
+
+        // The unpacked influences are only needed while importing
+        std::vector<VertexBoneData>().swap(m_aBoneData);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::buildLods
+
+      Summary:  Builds up to MAX_MESH_LODS simplified index ranges for
+                every mesh, each from the previous one at half its
+                triangles. The chain stops when the simplifier cannot
+                reduce a LOD within LOD_MAX_RELATIVE_ERROR. Reports the
+                triangles per LOD and the simplification throughput
+
+      Modifies: [m_aMeshes, m_aIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::buildLods()
+    {
+        LARGE_INTEGER startingTime = {};
+        LARGE_INTEGER endingTime = {};
+        LARGE_INTEGER frequency = {};
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        UINT uNumSimplifiedTriangles = 0u;
+        std::vector<UINT> aLodIndices;
+        std::vector<UINT> aOptimizedIndices;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            BasicMeshEntry& mesh = m_aMeshes[i];
+            UINT uNumVertices = getNumMeshVertices(i);
+            if (uNumVertices == 0u || mesh.uNumIndices == 0u)
+            {
+                continue;
+            }
+
+            const SimpleVertex* aMeshVertices = &m_aVertices[mesh.uBaseVertex];
+            QuantizationBounds bounds = ComputeQuantizationBounds(aMeshVertices, uNumVertices);
+            FLOAT maxError = std::max({ bounds.Extent.x, bounds.Extent.y, bounds.Extent.z }) * LOD_MAX_RELATIVE_ERROR;
+
+            UINT uSourceBaseIndex = mesh.uBaseIndex;
+            UINT uSourceNumIndices = mesh.uNumIndices;
+            while (mesh.uNumLods < MAX_MESH_LODS)
+            {
+                UINT uTargetNumIndices = (mesh.uNumIndices >> (mesh.uNumLods + 1u)) / 3u * 3u;
+                SimplifyMesh(
+                    &m_aIndices[uSourceBaseIndex],
+                    uSourceNumIndices,
+                    &aMeshVertices[0].Position,
+                    sizeof(SimpleVertex),
+                    uNumVertices,
+                    uTargetNumIndices,
+                    maxError,
+                    aLodIndices,
+                    nullptr
+                );
+                uNumSimplifiedTriangles += uSourceNumIndices / 3u;
+                if (aLodIndices.empty() || aLodIndices.size() > uSourceNumIndices * LOD_MIN_REDUCTION)
+                {
+                    break;
+                }
+
+                aOptimizedIndices.resize(aLodIndices.size());
+                OptimizeVertexCache(aLodIndices.data(), static_cast<UINT>(aLodIndices.size()), uNumVertices, VERTEX_CACHE_SIZE, aOptimizedIndices.data(), nullptr);
+
+                IndexRange& lod = mesh.aLods[mesh.uNumLods++];
+                lod.uNumIndices = static_cast<UINT>(aOptimizedIndices.size());
+                lod.uBaseIndex = static_cast<UINT>(m_aIndices.size());
+                m_aIndices.insert(m_aIndices.end(), aOptimizedIndices.begin(), aOptimizedIndices.end());
+
+                uSourceBaseIndex = lod.uBaseIndex;
+                uSourceNumIndices = lod.uNumIndices;
+            }
+
+            WCHAR szMessage[256];
+            INT iLength = swprintf_s(szMessage, L"%s mesh %u LOD triangles: %u", m_filePath.filename().c_str(), i, mesh.uNumIndices / 3u);
+            for (UINT j = 0u; j < mesh.uNumLods && iLength > 0; ++j)
+            {
+                iLength += swprintf_s(szMessage + iLength, ARRAYSIZE(szMessage) - iLength, L" / %u", mesh.aLods[j].uNumIndices / 3u);
+            }
+            OutputDebugString(szMessage);
+            OutputDebugString(L"\n");
+        }
+
+        QueryPerformanceCounter(&endingTime);
+        FLOAT elapsedSeconds = static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<FLOAT>(frequency.QuadPart);
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"%s LODs built in %.2f ms, %.2f M source triangles/s\n",
+            m_filePath.filename().c_str(),
+            elapsedSeconds * 1000.0f,
+            elapsedSeconds > 0.0f ? static_cast<FLOAT>(uNumSimplifiedTriangles) / elapsedSeconds / 1e6f : 0.0f
+        );
+        OutputDebugString(szMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::buildMeshlets
+
+      Summary:  Reorders the triangles of every mesh into meshlets and
+                keeps their bounds for CullMeshlets. The LODs are drawn
+                whole and are left as they are. Reports the meshlets
+                per mesh and what the reordering does to the vertex
+                cache
+
+      Modifies: [m_aMeshes, m_aIndices, m_aMeshlets].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::buildMeshlets()
+    {
+        m_aMeshlets.clear();
+
+        std::vector<UINT> aMeshletIndices;
+        std::vector<Meshlet> aMeshMeshlets;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            BasicMeshEntry& mesh = m_aMeshes[i];
+            UINT uNumVertices = getNumMeshVertices(i);
+            if (uNumVertices == 0u || mesh.uNumIndices == 0u)
+            {
+                continue;
+            }
+
+            UINT* aMeshIndices = &m_aIndices[mesh.uBaseIndex];
+            VertexCacheStats before = AnalyzeVertexCache(aMeshIndices, mesh.uNumIndices, uNumVertices, VERTEX_CACHE_SIZE);
+
+            aMeshletIndices.resize(mesh.uNumIndices);
+            BuildMeshlets(
+                aMeshIndices,
+                mesh.uNumIndices,
+                &m_aVertices[mesh.uBaseVertex].Position,
+                sizeof(SimpleVertex),
+                uNumVertices,
+                aMeshletIndices.data(),
+                aMeshMeshlets
+            );
+            std::copy(aMeshletIndices.begin(), aMeshletIndices.end(), aMeshIndices);
+
+            mesh.uBaseMeshlet = static_cast<UINT>(m_aMeshlets.size());
+            mesh.uNumMeshlets = static_cast<UINT>(aMeshMeshlets.size());
+            m_aMeshlets.insert(m_aMeshlets.end(), aMeshMeshlets.begin(), aMeshMeshlets.end());
+
+            VertexCacheStats after = AnalyzeVertexCache(aMeshIndices, mesh.uNumIndices, uNumVertices, VERTEX_CACHE_SIZE);
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"%s mesh %u: %u meshlets, %.1f triangles each, ACMR %.3f -> %.3f\n",
+                m_filePath.filename().c_str(),
+                i,
+                mesh.uNumMeshlets,
+                static_cast<FLOAT>(mesh.uNumIndices / 3u) / static_cast<FLOAT>(mesh.uNumMeshlets),
+                before.Acmr,
+                after.Acmr
+            );
+            OutputDebugString(szMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initClipBounds
+
+      Summary:  Bounds every animation clip. Each bone gets the box of
+                the vertices it moves in its own space, and the clip
+                box is the union of those boxes posed at
+                CLIP_BOUNDS_SAMPLE_RATE samples per second. A skinned
+                vertex is a weighted mean of its posed bones, so it
+                stays inside the union. The model box becomes the
+                union of all clips, as the rest pose is never drawn
+
+      Modifies: [m_aClipBoundingBoxes, m_aBoneInfo, m_aNodeTransforms,
+                 m_boundingBox, m_boundingSphere].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initClipBounds()
+    {
+        m_aClipBoundingBoxes.clear();
+        if (m_aAnimations.empty() || m_aBoneInfo.empty() || m_aAnimationData.size() != m_aVertices.size())
+        {
+            return;
+        }
+
+        const UINT uNumBones = static_cast<UINT>(m_aBoneInfo.size());
+        std::vector<XMVECTOR> aMin(uNumBones, g_XMFltMax);
+        std::vector<XMVECTOR> aMax(uNumBones, -g_XMFltMax);
+        BOOL bHasUnskinnedVertices = FALSE;
+        for (UINT i = 0u; i < m_aVertices.size(); ++i)
+        {
+            UINT aBoneIds[NUM_BONE_INFLUENCES];
+            FLOAT aWeights[NUM_BONE_INFLUENCES];
+            UnpackBoneWeights(m_aAnimationData[i], aBoneIds, aWeights);
+
+            XMVECTOR position = XMLoadFloat3(&m_aVertices[i].Position);
+            BOOL bSkinned = FALSE;
+            for (UINT j = 0u; j < NUM_BONE_INFLUENCES; ++j)
+            {
+                if (aWeights[j] == 0.0f || aBoneIds[j] >= uNumBones)
+                {
+                    continue;
+                }
+
+                XMVECTOR bonePosition = XMVector3Transform(position, m_aBoneInfo[aBoneIds[j]].OffsetMatrix);
+                aMin[aBoneIds[j]] = XMVectorMin(aMin[aBoneIds[j]], bonePosition);
+                aMax[aBoneIds[j]] = XMVectorMax(aMax[aBoneIds[j]], bonePosition);
+                bSkinned = TRUE;
+            }
+
+            // Without weights the skinning matrix is zero
+            bHasUnskinnedVertices |= !bSkinned;
+        }
+
+        std::vector<UINT> aUsedBones;
+        std::vector<BoundingBox> aBoneBoxes;
+        std::vector<XMMATRIX> aInverseOffsets;
+        for (UINT i = 0u; i < uNumBones; ++i)
+        {
+            if (XMVector3LessOrEqual(aMin[i], aMax[i]))
+            {
+                BoundingBox box;
+                XMStoreFloat3(&box.Center, (aMin[i] + aMax[i]) * 0.5f);
+                XMStoreFloat3(&box.Extents, (aMax[i] - aMin[i]) * 0.5f);
+                aUsedBones.push_back(i);
+                aBoneBoxes.push_back(box);
+                aInverseOffsets.push_back(XMMatrixInverse(nullptr, m_aBoneInfo[i].OffsetMatrix));
+            }
+        }
+
+        std::vector<BoundingBox> aPoseBoxes(aUsedBones.size() + 1u);
+        for (const AnimationClip& clip : m_aAnimations)
+        {
+            FLOAT ticksPerSecond = clip.TicksPerSecond != 0.0f ? clip.TicksPerSecond : 25.0f;
+            UINT uNumSamples = static_cast<UINT>(std::ceil(clip.Duration / ticksPerSecond * CLIP_BOUNDS_SAMPLE_RATE));
+            uNumSamples = std::clamp(uNumSamples, 1u, MAX_CLIP_BOUNDS_SAMPLES);
+
+            BoundingBox clipBox;
+            for (UINT uSample = 0u; uSample <= uNumSamples; ++uSample)
+            {
+                readNodeHierarchy(clip.Duration * static_cast<FLOAT>(uSample) / static_cast<FLOAT>(uNumSamples), clip);
+                for (UINT i = 0u; i < aUsedBones.size(); ++i)
+                {
+                    aBoneBoxes[i].Transform(aPoseBoxes[i], aInverseOffsets[i] * m_aBoneInfo[aUsedBones[i]].FinalTransformation);
+                }
+                aPoseBoxes.back() = bHasUnskinnedVertices ? BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f)) : aPoseBoxes.front();
+
+                BoundingBox poseBox = MergeBoundingBoxes(aPoseBoxes.data(), static_cast<UINT>(aPoseBoxes.size()));
+                if (uSample == 0u)
+                {
+                    clipBox = poseBox;
+                }
+                else
+                {
+                    BoundingBox::CreateMerged(clipBox, clipBox, poseBox);
+                }
+            }
+
+            m_aClipBoundingBoxes.push_back(clipBox);
+        }
+
+        m_boundingBox = MergeBoundingBoxes(m_aClipBoundingBoxes.data(), static_cast<UINT>(m_aClipBoundingBoxes.size()));
+        BoundingSphere::CreateFromBoundingBox(m_boundingSphere, m_boundingBox);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initIndexData
+
+      Summary:  Chooses the index format of every mesh and packs the
+                indices into the index buffer data. 16-bit meshes come
+                first, followed by a 4 byte aligned region of 32-bit
+                meshes, and the LODs of a mesh follow it. Releases the
+                import-time indices
+
+      Modifies: [m_aMeshes, m_aIndexData, m_aIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initIndexData()
+    {
+        std::vector<BOOL> aUseIndex32(m_aMeshes.size(), FALSE);
+        UINT uNumIndices16 = 0u;
+        UINT uNumIndices32 = 0u;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            aUseIndex32[i] = NeedsIndex32(&m_aIndices[mesh.uBaseIndex], mesh.uNumIndices);
+
+            // The LODs only use vertices of the full mesh, so they share its format
+            UINT uNumMeshIndices = mesh.uNumIndices;
+            for (UINT j = 0u; j < mesh.uNumLods; ++j)
+            {
+                uNumMeshIndices += mesh.aLods[j].uNumIndices;
+            }
+            (aUseIndex32[i] ? uNumIndices32 : uNumIndices16) += uNumMeshIndices;
+        }
+
+        UINT uIndex32Offset = (uNumIndices16 * static_cast<UINT>(sizeof(WORD)) + 3u) & ~3u;
+        m_aIndexData.assign(uIndex32Offset + uNumIndices32 * sizeof(UINT), 0u);
+
+        WORD* aIndices16 = reinterpret_cast<WORD*>(m_aIndexData.data());
+        UINT* aIndices32 = reinterpret_cast<UINT*>(m_aIndexData.data() + uIndex32Offset);
+        UINT uBaseIndex16 = 0u;
+        UINT uBaseIndex32 = 0u;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            BasicMeshEntry& mesh = m_aMeshes[i];
+            auto packRange = [&](UINT uNumIndices, UINT& uBaseIndex)
+            {
+                const UINT* aSource = &m_aIndices[uBaseIndex];
+                if (aUseIndex32[i])
+                {
+                    std::copy(aSource, aSource + uNumIndices, aIndices32 + uBaseIndex32);
+                    uBaseIndex = uBaseIndex32;
+                    uBaseIndex32 += uNumIndices;
+                }
+                else
+                {
+                    for (UINT j = 0u; j < uNumIndices; ++j)
+                    {
+                        aIndices16[uBaseIndex16 + j] = static_cast<WORD>(aSource[j]);
+                    }
+                    uBaseIndex = uBaseIndex16;
+                    uBaseIndex16 += uNumIndices;
+                }
+            };
+
+            mesh.IndexFormat = aUseIndex32[i] ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+            mesh.uIndexOffset = aUseIndex32[i] ? uIndex32Offset : 0u;
+            packRange(mesh.uNumIndices, mesh.uBaseIndex);
+            for (UINT j = 0u; j < mesh.uNumLods; ++j)
+            {
+                packRange(mesh.aLods[j].uNumIndices, mesh.aLods[j].uBaseIndex);
+            }
+        }
+
+        std::vector<UINT>().swap(m_aIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initQuantizedVertices
+
+      Summary:  Compresses the vertices and normal data into a single
+                QuantizedVertex stream and creates the constant buffer
+                that decodes its positions
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+
+      Modifies: [m_quantizedVertexBuffer, m_quantizationConstantBuffer].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initQuantizedVertices(_In_ ID3D11Device* pDevice)
+    {
+        QuantizationBounds bounds = ComputeQuantizationBounds(m_aVertices.data(), GetNumVertices());
+
+        std::vector<QuantizedVertex> aQuantizedVertices(m_aVertices.size());
+        QuantizeVertices(
+            m_aVertices.data(),
+            m_aNormalData.size() == m_aVertices.size() ? m_aNormalData.data() : nullptr,
+            GetNumVertices(),
+            bounds,
+            aQuantizedVertices.data()
+        );
+
+        D3D11_BUFFER_DESC vertexBd = {
+            .ByteWidth = sizeof(QuantizedVertex) * GetNumVertices(),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+        D3D11_SUBRESOURCE_DATA vertexInitData = {
+            .pSysMem = aQuantizedVertices.data(),
+            .SysMemPitch = 0,
+            .SysMemSlicePitch = 0
+        };
+        HRESULT hr = pDevice->CreateBuffer(&vertexBd, &vertexInitData, m_quantizedVertexBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        CBQuantization cbQuantization = {
+            .PositionOffset = XMFLOAT4(bounds.Min.x, bounds.Min.y, bounds.Min.z, 0.0f),
+            .PositionScale = XMFLOAT4(bounds.Extent.x, bounds.Extent.y, bounds.Extent.z, 0.0f)
+        };
+        D3D11_BUFFER_DESC constantBd = {
+            .ByteWidth = sizeof(CBQuantization),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+        D3D11_SUBRESOURCE_DATA constantInitData = {
+            .pSysMem = &cbQuantization,
+            .SysMemPitch = 0,
+            .SysMemSlicePitch = 0
+        };
+        hr = pDevice->CreateBuffer(&constantBd, &constantInitData, m_quantizationConstantBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            m_quantizedVertexBuffer.Reset();
+            return hr;
+        }
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"%s: %u bytes per vertex quantized to %u\n",
+            m_filePath.filename().c_str(),
+            static_cast<UINT>(sizeof(SimpleVertex) + sizeof(NormalData)),
+            static_cast<UINT>(sizeof(QuantizedVertex))
+        );
+        OutputDebugString(szMessage);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initMaterialTextures
+
+      Summary:  Collects the texture paths of all materials in a given
+                assimp scene
+
+      Args:     const aiScene* pScene
+                  Assimp scene
+
+      Modifies: [m_aMaterialTextures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initMaterialTextures(_In_ const aiScene* pScene)
+    {
+        m_aMaterialTextures.resize(pScene->mNumMaterials);
+        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
+        {
+            const aiMaterial* pMaterial = pScene->mMaterials[i];
+
+            m_aMaterialTextures[i].szDiffusePath = GetTexturePath(pMaterial, aiTextureType_DIFFUSE);
+            m_aMaterialTextures[i].szSpecularPath = GetTexturePath(pMaterial, aiTextureType_SHININESS);
+            m_aMaterialTextures[i].szNormalPath = GetTexturePath(pMaterial, aiTextureType_HEIGHT);
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Model::initMeshBones
      Summary:  Initialize all bones in a given aiMesh
@@ -594,6 +1681,44 @@ namespace library
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initSkeleton
+      Summary:  Flattens the node hierarchy depth first, so that every
+                parent is stored before its children
+      Args:     const aiNode* pNode
+                  Pointer to an assimp node object
+                INT iParent
+                  Index of the parent node, -1 for the root
+      Modifies: [m_aSkeletonNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initSkeleton(_In_ const aiNode* pNode, _In_ INT iParent)
+    {
+        assert(pNode);
+
+        SkeletonNode node =
+        {
+            .szName = pNode->mName.C_Str(),
+            .iParent = iParent,
+            .iBoneIndex = -1,
+            .Transformation = XMFLOAT4X4()
+        };
+        XMStoreFloat4x4(&node.Transformation, ConvertMatrix(pNode->mTransformation));
+
+        auto iBoneIndex = m_boneNameToIndexMap.find(node.szName);
+        if (iBoneIndex != m_boneNameToIndexMap.end())
+        {
+            node.iBoneIndex = static_cast<INT>(iBoneIndex->second);
+        }
+
+        INT iNodeIndex = static_cast<INT>(m_aSkeletonNodes.size());
+        m_aSkeletonNodes.push_back(std::move(node));
+
+        for (UINT i = 0u; i < pNode->mNumChildren; ++i)
+        {
+            initSkeleton(pNode->mChildren[i], iNodeIndex);
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initSingleMesh
       Summary:  Initialize single mesh from a given assimp mesh
@@ -631,11 +1756,11 @@ namespace library
         {
             const aiFace& face = pMesh->mFaces[i];
             assert(face.mNumIndices == 3u);
-            WORD aIndices[3] =
+            UINT aIndices[3] =
             {
-                static_cast<WORD>(face.mIndices[0]),
-                static_cast<WORD>(face.mIndices[1]),
-                static_cast<WORD>(face.mIndices[2]),
+                face.mIndices[0],
+                face.mIndices[1],
+                face.mIndices[2],
             };
             m_aIndices.push_back(aIndices[0]);
             m_aIndices.push_back(aIndices[1]);
@@ -651,31 +1776,30 @@ namespace library
                   Translate vector
                 FLOAT animationTimeTicks
                   Animation time
-                const aiNodeAnim* pNodeAnim
-                  Pointer to an assimp node anim object
+                const AnimationChannel& channel
+                  Key frames of the node
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel)
     {
-        if (pNodeAnim->mNumPositionKeys == 1)
+        if (channel.aPositionKeys.size() == 1)
         {
-            outTranslate = ConvertVector3dToFloat3(pNodeAnim->mPositionKeys[0].mValue);
+            outTranslate = channel.aPositionKeys[0].Value;
             return;
         }
 
-        UINT uPositionIndex = findPosition(animationTimeTicks, pNodeAnim);
+        UINT uPositionIndex = findPosition(animationTimeTicks, channel);
         UINT uNextPositionIndex = uPositionIndex + 1u;
-        assert(uNextPositionIndex < pNodeAnim->mNumPositionKeys);
+        assert(uNextPositionIndex < channel.aPositionKeys.size());
 
-        FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mPositionKeys[uPositionIndex].mTime);
-        FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mPositionKeys[uNextPositionIndex].mTime);
+        FLOAT t1 = channel.aPositionKeys[uPositionIndex].Time;
+        FLOAT t2 = channel.aPositionKeys[uNextPositionIndex].Time;
         FLOAT deltaTime = t2 - t1;
 
         FLOAT factor = (animationTimeTicks - t1) / deltaTime;
         assert(factor >= 0.0f && factor <= 1.0f);
-        const aiVector3D& start = pNodeAnim->mPositionKeys[uPositionIndex].mValue;
-        const aiVector3D& end = pNodeAnim->mPositionKeys[uNextPositionIndex].mValue;
-        aiVector3D delta = end - start;
-        outTranslate = ConvertVector3dToFloat3(start + factor * delta);
+        XMVECTOR start = XMLoadFloat3(&channel.aPositionKeys[uPositionIndex].Value);
+        XMVECTOR end = XMLoadFloat3(&channel.aPositionKeys[uNextPositionIndex].Value);
+        XMStoreFloat3(&outTranslate, XMVectorLerp(start, end, factor));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -685,36 +1809,33 @@ namespace library
                   Quaternion vector
                 FLOAT animationTimeTicks
                   Animation time
-                const aiNodeAnim* pNodeAnim
-                  Pointer to an assimp node anim object
+                const AnimationChannel& channel
+                  Key frames of the node
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel)
     {
-        if (pNodeAnim->mNumRotationKeys == 1)
+        if (channel.aRotationKeys.size() == 1)
         {
-            outQuaternion = ConvertQuaternionToVector(pNodeAnim->mRotationKeys[0].mValue);
+            outQuaternion = XMLoadFloat4(&channel.aRotationKeys[0].Value);
             return;
         }
 
-        UINT uRotationIndex = findRotation(animationTimeTicks, pNodeAnim);
+        UINT uRotationIndex = findRotation(animationTimeTicks, channel);
         UINT uNextRotationIndex = uRotationIndex + 1u;
-        assert(uNextRotationIndex < pNodeAnim->mNumRotationKeys);
+        assert(uNextRotationIndex < channel.aRotationKeys.size());
 
 
-        FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mRotationKeys[uRotationIndex].mTime);
-        FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mRotationKeys[uNextRotationIndex].mTime);
+        FLOAT t1 = channel.aRotationKeys[uRotationIndex].Time;
+        FLOAT t2 = channel.aRotationKeys[uNextRotationIndex].Time;
         FLOAT deltaTime = t2 - t1;
 
         FLOAT factor = (animationTimeTicks - t1) / deltaTime;
         assert(factor >= 0.0f && factor <= 1.0f);
 
-        const aiQuaternion& start = pNodeAnim->mRotationKeys[uRotationIndex].mValue;
-        const aiQuaternion& end = pNodeAnim->mRotationKeys[uNextRotationIndex].mValue;
+        XMVECTOR start = XMLoadFloat4(&channel.aRotationKeys[uRotationIndex].Value);
+        XMVECTOR end = XMLoadFloat4(&channel.aRotationKeys[uNextRotationIndex].Value);
 
-        aiQuaternion out = aiQuaternion();
-        aiQuaternion::Interpolate(out, start, end, factor);
-        out.Normalize();
-        outQuaternion = ConvertQuaternionToVector(out);
+        outQuaternion = XMQuaternionNormalize(XMQuaternionSlerp(start, end, factor));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -724,153 +1845,260 @@ namespace library
                   Scaling vector
                 FLOAT animationTimeTicks
                   Animation time
-                const aiNodeAnim* pNodeAnim
-                  Pointer to an assimp node anim object
+                const AnimationChannel& channel
+                  Key frames of the node
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel)
     {
-        if (pNodeAnim->mNumScalingKeys == 1)
+        if (channel.aScalingKeys.size() == 1)
         {
-            outScale = ConvertVector3dToFloat3(pNodeAnim->mScalingKeys[0].mValue);
+            outScale = channel.aScalingKeys[0].Value;
             return;
         }
 
-        UINT uScalingIndex = findScaling(animationTimeTicks, pNodeAnim);;
+        UINT uScalingIndex = findScaling(animationTimeTicks, channel);
         UINT uNextScalingIndex = uScalingIndex + 1u;
-        assert(uNextScalingIndex < pNodeAnim->mNumScalingKeys);
+        assert(uNextScalingIndex < channel.aScalingKeys.size());
 
 
-        FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mScalingKeys[uScalingIndex].mTime);
-        FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mScalingKeys[uNextScalingIndex].mTime);
+        FLOAT t1 = channel.aScalingKeys[uScalingIndex].Time;
+        FLOAT t2 = channel.aScalingKeys[uNextScalingIndex].Time;
         FLOAT deltaTime = t2 - t1;
 
 
         FLOAT factor = (animationTimeTicks - t1) / deltaTime;
         assert(factor >= 0.0f && factor <= 1.0f);
-        const aiVector3D& start = pNodeAnim->mScalingKeys[uScalingIndex].mValue;
-        const aiVector3D& end = pNodeAnim->mScalingKeys[uNextScalingIndex].mValue;
-        aiVector3D delta = end - start;
-        outScale = ConvertVector3dToFloat3(start + factor * delta);
+        XMVECTOR start = XMLoadFloat3(&channel.aScalingKeys[uScalingIndex].Value);
+        XMVECTOR end = XMLoadFloat3(&channel.aScalingKeys[uNextScalingIndex].Value);
+        XMStoreFloat3(&outScale, XMVectorLerp(start, end, factor));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::loadDiffuseTexture
-      Summary:  Load a diffuse texture from given path
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
+      Summary:  Creates the diffuse texture of a material and reads
+                its file
+      Args:     const std::filesystem::path& parentDirectory
                   Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
                 UINT uIndex
                   Index to a material
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Model::loadDiffuseTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
         _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
         _In_ UINT uIndex
     )
     {
         HRESULT hr = S_OK;
         m_aMaterials[uIndex]->pDiffuse = nullptr;
 
-        if (pMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        const std::string& szPath = m_aMaterialTextures[uIndex].szDiffusePath;
+        if (!szPath.empty())
         {
-            aiString aiPath;
+            std::filesystem::path fullPath = parentDirectory / szPath;
+
+            m_aMaterials[uIndex]->pDiffuse = AssetManager::GetDefault().GetTexture(fullPath);
 
-            if (pMaterial->GetTexture(aiTextureType_DIFFUSE, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
+            hr = m_aMaterials[uIndex]->pDiffuse->Prefetch();
+            if (FAILED(hr))
             {
-                std::string szPath(aiPath.data);
+                OutputDebugString(L"Error loading diffuse texture \"");
+                OutputDebugString(fullPath.c_str());
+                OutputDebugString(L"\"\n");
 
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
+                return hr;
+            }
+
+            OutputDebugString(L"Loaded diffuse texture \"");
+            OutputDebugString(fullPath.c_str());
+            OutputDebugString(L"\"\n");
+        }
 
-                std::filesystem::path fullPath = parentDirectory / szPath;
+        return hr;
+    }
 
-                m_aMaterials[uIndex]->pDiffuse = std::make_shared<Texture>(fullPath);
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::loadFromCache
 
-                hr = m_aMaterials[uIndex]->pDiffuse->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading diffuse texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
+      Summary:  Fills the model from a cooked mesh. The sections are
+                copied straight out of the mapped file
 
-                    return hr;
-                }
+      Args:     const std::filesystem::path& cachePath
+                  Path to the cooked mesh
+                const MeshCacheKey& key
+                  Key the cooked mesh has to match
+                UINT64 ullOffset
+                  Offset of the cooked mesh in the file
+                SIZE_T uSize
+                  Size of the cooked mesh, 0 for the rest of the file
 
-                OutputDebugString(L"Loaded diffuse texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
+      Modifies: [m_aVertices, m_aNormalData, m_aAnimationData,
+                 m_aIndexData, m_aMeshes, m_aMeshlets, m_aMaterialTextures,
+                 m_aBoneInfo, m_boneNameToIndexMap, m_aSkeletonNodes,
+                 m_aAnimations, m_globalInverseTransform].
+
+      Returns:  HRESULT
+                  Status code, fails if there is no valid cooked mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::loadFromCache(_In_ const std::filesystem::path& cachePath, _In_ const MeshCacheKey& key, _In_opt_ UINT64 ullOffset, _In_opt_ SIZE_T uSize)
+    {
+        MeshCacheReader reader;
+        HRESULT hr = reader.Open(cachePath, key, ullOffset, uSize);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // Validate the animation ranges before touching the model, so a
+        // corrupt cooked mesh falls back to importing a clean model
+        UINT uNumClips = 0u;
+        UINT uNumChannels = 0u;
+        UINT uNumVectorKeys = 0u;
+        UINT uNumQuaternionKeys = 0u;
+        UINT uNumNodes = 0u;
+        const CookedClip* aClips = reader.GetSection<CookedClip>(MeshCacheSection::Clips, uNumClips);
+        const CookedChannel* aChannels = reader.GetSection<CookedChannel>(MeshCacheSection::Channels, uNumChannels);
+        const VectorKey* aVectorKeys = reader.GetSection<VectorKey>(MeshCacheSection::VectorKeys, uNumVectorKeys);
+        const QuaternionKey* aQuaternionKeys = reader.GetSection<QuaternionKey>(MeshCacheSection::QuaternionKeys, uNumQuaternionKeys);
+        const CookedNode* aNodes = reader.GetSection<CookedNode>(MeshCacheSection::Nodes, uNumNodes);
+        for (UINT i = 0u; i < uNumClips; ++i)
+        {
+            if (static_cast<UINT64>(aClips[i].uFirstChannel) + aClips[i].uNumChannels > uNumChannels)
+            {
+                return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+            }
+        }
+        for (UINT i = 0u; i < uNumChannels; ++i)
+        {
+            const CookedChannel& cooked = aChannels[i];
+            if (cooked.uNodeIndex >= uNumNodes ||
+                static_cast<UINT64>(cooked.uFirstPositionKey) + cooked.uNumPositionKeys > uNumVectorKeys ||
+                static_cast<UINT64>(cooked.uFirstScalingKey) + cooked.uNumScalingKeys > uNumVectorKeys ||
+                static_cast<UINT64>(cooked.uFirstRotationKey) + cooked.uNumRotationKeys > uNumQuaternionKeys)
+            {
+                return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
             }
         }
 
-        return hr;
-    }
+        UINT uNumMeshes = 0u;
+        UINT uNumMeshlets = 0u;
+        const BasicMeshEntry* aMeshes = reader.GetSection<BasicMeshEntry>(MeshCacheSection::Meshes, uNumMeshes);
+        const Meshlet* aMeshlets = reader.GetSection<Meshlet>(MeshCacheSection::Meshlets, uNumMeshlets);
+        for (UINT i = 0u; i < uNumMeshes; ++i)
+        {
+            if (static_cast<UINT64>(aMeshes[i].uBaseMeshlet) + aMeshes[i].uNumMeshlets > uNumMeshlets)
+            {
+                return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+            }
+        }
+
+        UINT uCount = 0u;
+        const SimpleVertex* aVertices = reader.GetSection<SimpleVertex>(MeshCacheSection::Vertices, uCount);
+        m_aVertices.assign(aVertices, aVertices + uCount);
+
+        const NormalData* aNormalData = reader.GetSection<NormalData>(MeshCacheSection::NormalData, uCount);
+        m_aNormalData.assign(aNormalData, aNormalData + uCount);
+
+        const AnimationData* aAnimationData = reader.GetSection<AnimationData>(MeshCacheSection::AnimationData, uCount);
+        m_aAnimationData.assign(aAnimationData, aAnimationData + uCount);
+
+        const BYTE* aIndexData = reader.GetSection<BYTE>(MeshCacheSection::Indices, uCount);
+        m_aIndexData.assign(aIndexData, aIndexData + uCount);
+
+        m_aMeshes.assign(aMeshes, aMeshes + uNumMeshes);
+        m_aMeshlets.assign(aMeshlets, aMeshlets + uNumMeshlets);
+
+        const CookedMaterial* aMaterials = reader.GetSection<CookedMaterial>(MeshCacheSection::Materials, uCount);
+        m_aMaterialTextures.resize(uCount);
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            m_aMaterialTextures[i].szDiffusePath = reader.GetString(aMaterials[i].uDiffusePath);
+            m_aMaterialTextures[i].szSpecularPath = reader.GetString(aMaterials[i].uSpecularPath);
+            m_aMaterialTextures[i].szNormalPath = reader.GetString(aMaterials[i].uNormalPath);
+        }
+
+        const CookedBone* aBones = reader.GetSection<CookedBone>(MeshCacheSection::Bones, uCount);
+        m_aBoneInfo.clear();
+        m_aBoneInfo.reserve(uCount);
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            m_aBoneInfo.push_back(BoneInfo(XMLoadFloat4x4(&aBones[i].OffsetMatrix)));
+            m_boneNameToIndexMap[reader.GetString(aBones[i].uName)] = i;
+        }
+
+        m_aSkeletonNodes.resize(uNumNodes);
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            m_aSkeletonNodes[i] =
+            {
+                .szName = reader.GetString(aNodes[i].uName),
+                .iParent = aNodes[i].iParent,
+                .iBoneIndex = aNodes[i].iBoneIndex,
+                .Transformation = aNodes[i].Transformation
+            };
+        }
+
+        m_aAnimations.resize(uNumClips);
+        for (UINT i = 0u; i < uNumClips; ++i)
+        {
+            AnimationClip& clip = m_aAnimations[i];
+            clip.Duration = aClips[i].Duration;
+            clip.TicksPerSecond = aClips[i].TicksPerSecond;
+            clip.aNodeChannels.assign(m_aSkeletonNodes.size(), -1);
+            clip.aChannels.resize(aClips[i].uNumChannels);
+
+            for (UINT j = 0u; j < aClips[i].uNumChannels; ++j)
+            {
+                const CookedChannel& cooked = aChannels[aClips[i].uFirstChannel + j];
+                AnimationChannel& channel = clip.aChannels[j];
+                channel.uNodeIndex = cooked.uNodeIndex;
+                channel.aPositionKeys.assign(aVectorKeys + cooked.uFirstPositionKey, aVectorKeys + cooked.uFirstPositionKey + cooked.uNumPositionKeys);
+                channel.aRotationKeys.assign(aQuaternionKeys + cooked.uFirstRotationKey, aQuaternionKeys + cooked.uFirstRotationKey + cooked.uNumRotationKeys);
+                channel.aScalingKeys.assign(aVectorKeys + cooked.uFirstScalingKey, aVectorKeys + cooked.uFirstScalingKey + cooked.uNumScalingKeys);
+                clip.aNodeChannels[channel.uNodeIndex] = static_cast<INT>(j);
+            }
+        }
+
+        m_globalInverseTransform = reader.GetGlobalInverseTransform();
 
+        return S_OK;
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
        Method:   Model::loadSpecularTexture
-       Summary:  Load a specular texture from given path
-       Args:     ID3D11Device* pDevice
-                   The Direct3D device to create the buffers
-                 ID3D11DeviceContext* pImmediateContext
-                   The Direct3D context to set buffers
-                 const std::filesystem::path& parentDirectory
+       Summary:  Creates the specular texture of a material and reads
+                 its file
+       Args:     const std::filesystem::path& parentDirectory
                    Parent path to the model
-                 const aiMaterial* pMaterial
-                   Pointer to an assimp material object
                  UINT uIndex
                    Index to a material
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Model::loadSpecularTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
         _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
         _In_ UINT uIndex
     )
     {
         HRESULT hr = S_OK;
         m_aMaterials[uIndex]->pSpecularExponent = nullptr;
 
-        if (pMaterial->GetTextureCount(aiTextureType_SHININESS) > 0)
+        const std::string& szPath = m_aMaterialTextures[uIndex].szSpecularPath;
+        if (!szPath.empty())
         {
-            aiString aiPath;
-
-            if (pMaterial->GetTexture(aiTextureType_SHININESS, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-            {
-                std::string szPath(aiPath.data);
-
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
-
-                std::filesystem::path fullPath = parentDirectory / szPath;
-               
-                m_aMaterials[uIndex]->pSpecularExponent = std::make_shared<Texture>(fullPath);
+            std::filesystem::path fullPath = parentDirectory / szPath;
 
-                hr = m_aMaterials[uIndex]->pSpecularExponent->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading specular texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
+            m_aMaterials[uIndex]->pSpecularExponent = AssetManager::GetDefault().GetTexture(fullPath);
 
-                    return hr;
-                }
-
-                OutputDebugString(L"Loaded specular texture \"");
+            hr = m_aMaterials[uIndex]->pSpecularExponent->Prefetch();
+            if (FAILED(hr))
+            {
+                OutputDebugString(L"Error loading specular texture \"");
                 OutputDebugString(fullPath.c_str());
                 OutputDebugString(L"\"\n");
+
+                return hr;
             }
+
+            OutputDebugString(L"Loaded specular texture \"");
+            OutputDebugString(fullPath.c_str());
+            OutputDebugString(L"\"\n");
         }
 
         return hr;
@@ -881,55 +2109,40 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::loadNormalTexture
 
-      Summary:  Load a normal texture from given path
+      Summary:  Creates the normal texture of a material and reads
+                its file
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
+      Args:     const std::filesystem::path& parentDirectory
                   Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
                 UINT uIndex
                   Index to a material
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadNormalTexture(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const std::filesystem::path& parentDirectory, _In_ const aiMaterial* pMaterial, _In_ UINT uIndex)
+    HRESULT Model::loadNormalTexture(_In_ const std::filesystem::path& parentDirectory, _In_ UINT uIndex)
     {
         HRESULT hr = S_OK;
         m_aMaterials[uIndex]->pNormal = nullptr;
 
-        if (pMaterial->GetTextureCount(aiTextureType_HEIGHT) > 0)
+        const std::string& szPath = m_aMaterialTextures[uIndex].szNormalPath;
+        if (!szPath.empty())
         {
-            aiString aiPath;
-
-            if (pMaterial->GetTexture(aiTextureType_HEIGHT, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-            {
-                std::string szPath(aiPath.data);
-
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
-
-                std::filesystem::path fullPath = parentDirectory / szPath;
-
-                m_aMaterials[uIndex]->pNormal = std::make_shared<Texture>(fullPath);
-                m_bHasNormalMap = true;
-
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading normal texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
+            std::filesystem::path fullPath = parentDirectory / szPath;
 
-                    return hr;
-                }
+            m_aMaterials[uIndex]->pNormal = AssetManager::GetDefault().GetTexture(fullPath);
+            m_bHasNormalMap = true;
 
-                OutputDebugString(L"Loaded normal texture \"");
+            hr = m_aMaterials[uIndex]->pNormal->Prefetch();
+            if (FAILED(hr))
+            {
+                OutputDebugString(L"Error loading normal texture \"");
                 OutputDebugString(fullPath.c_str());
                 OutputDebugString(L"\"\n");
+
+                return hr;
             }
+
+            OutputDebugString(L"Loaded normal texture \"");
+            OutputDebugString(fullPath.c_str());
+            OutputDebugString(L"\"\n");
         }
 
         return hr;
@@ -939,34 +2152,29 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::loadTextures
 
-      Summary:  Load a specular texture from given path
+      Summary:  Creates the textures of a material and reads their
+                files, Initialize creates them on the device
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
+      Args:     const std::filesystem::path& parentDirectory
                   Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
                 UINT uIndex
                   Index to a material
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadTextures(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const std::filesystem::path& parentDirectory, _In_ const aiMaterial* pMaterial, _In_ UINT uIndex)
+    HRESULT Model::loadTextures(_In_ const std::filesystem::path& parentDirectory, _In_ UINT uIndex)
     {
-        HRESULT hr = loadDiffuseTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
+        HRESULT hr = loadDiffuseTexture(parentDirectory, uIndex);
         if (FAILED(hr))
         {
             return hr;
         }
 
-        hr = loadSpecularTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
+        hr = loadSpecularTexture(parentDirectory, uIndex);
         if (FAILED(hr))
         {
             return hr;
         }
 
-        hr = loadNormalTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
+        hr = loadNormalTexture(parentDirectory, uIndex);
         if (FAILED(hr))
         {
             return hr;
@@ -976,52 +2184,54 @@ namespace library
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Model::readNodeHierarchy
-     Summary:  Calculate bone transformation of the given assimp node
+     Summary:  Calculate bone transformations of the skeleton. Parents
+               are stored before their children, so a single pass over
+               the nodes is enough
      Args:     FLOAT animationTimeTicks
                  Animation time
-              const aiNode* pNode
-                 Pointer to an assimp node object
-               const XMMATRIX& parentTransform
-                 Parent transform in hierarchy
+               const AnimationClip& clip
+                 Animation to sample
+     Modifies: [m_aNodeTransforms, m_aBoneInfo].
    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform)
+    void Model::readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const AnimationClip& clip)
     {
-        assert(pNode);
-        const aiNodeAnim* pNodeAnim = findNodeAnimOrNull(m_pScene->mAnimations[0], pNode->mName.C_Str());
-        XMMATRIX nodeTransformation = ConvertMatrix(pNode->mTransformation);
-        if (pNodeAnim)
+        m_aNodeTransforms.resize(m_aSkeletonNodes.size());
+        for (UINT i = 0u; i < m_aSkeletonNodes.size(); ++i)
         {
+            const SkeletonNode& node = m_aSkeletonNodes[i];
+            XMMATRIX nodeTransformation = XMLoadFloat4x4(&node.Transformation);
+            INT iChannel = clip.aNodeChannels[i];
+            if (iChannel >= 0)
+            {
+                const AnimationChannel& channel = clip.aChannels[iChannel];
 
-            XMMATRIX scalingMatrix = XMMATRIX();
-            XMFLOAT3 scalingFloat = XMFLOAT3();
-            interpolateScaling(scalingFloat, animationTimeTicks, pNodeAnim);
-            scalingMatrix = XMMatrixScaling(scalingFloat.x, scalingFloat.y, scalingFloat.z);
+                XMMATRIX scalingMatrix = XMMATRIX();
+                XMFLOAT3 scalingFloat = XMFLOAT3();
+                interpolateScaling(scalingFloat, animationTimeTicks, channel);
+                scalingMatrix = XMMatrixScaling(scalingFloat.x, scalingFloat.y, scalingFloat.z);
 
-            XMMATRIX rotationMatrix = XMMATRIX();
-            XMVECTOR rotationQuaternion = XMVECTOR();
-            interpolateRotation(rotationQuaternion, animationTimeTicks, pNodeAnim);
-            rotationMatrix = XMMatrixRotationQuaternion(rotationQuaternion);
+                XMMATRIX rotationMatrix = XMMATRIX();
+                XMVECTOR rotationQuaternion = XMVECTOR();
+                interpolateRotation(rotationQuaternion, animationTimeTicks, channel);
+                rotationMatrix = XMMatrixRotationQuaternion(rotationQuaternion);
 
-            XMMATRIX translationMatrix = XMMATRIX();
-            XMFLOAT3 translationFloat = XMFLOAT3();
-            interpolatePosition(translationFloat, animationTimeTicks, pNodeAnim);
-            translationMatrix = XMMatrixTranslation(translationFloat.x, translationFloat.y, translationFloat.z);
+                XMMATRIX translationMatrix = XMMATRIX();
+                XMFLOAT3 translationFloat = XMFLOAT3();
+                interpolatePosition(translationFloat, animationTimeTicks, channel);
+                translationMatrix = XMMatrixTranslation(translationFloat.x, translationFloat.y, translationFloat.z);
 
-            nodeTransformation = scalingMatrix * rotationMatrix * translationMatrix;
-        }
-        XMMATRIX globalTransformation = nodeTransformation * parentTransform;
+                nodeTransformation = scalingMatrix * rotationMatrix * translationMatrix;
+            }
 
-        auto iBoneIndex = m_boneNameToIndexMap.find(pNode->mName.C_Str());
-        if (iBoneIndex != m_boneNameToIndexMap.end())
-        {
-            UINT boneIndex = 0u;
-            boneIndex = iBoneIndex->second;
-            m_aBoneInfo[boneIndex].FinalTransformation = m_aBoneInfo[boneIndex].OffsetMatrix * globalTransformation *
-                m_globalInverseTransform;
-        }
-        for (UINT i = 0u; i < pNode->mNumChildren; ++i)
-        {
-            readNodeHierarchy(animationTimeTicks, pNode->mChildren[i], globalTransformation);
+            XMMATRIX globalTransformation = node.iParent < 0 ?
+                nodeTransformation : nodeTransformation * m_aNodeTransforms[node.iParent];
+            m_aNodeTransforms[i] = globalTransformation;
+
+            if (node.iBoneIndex >= 0)
+            {
+                m_aBoneInfo[node.iBoneIndex].FinalTransformation = m_aBoneInfo[node.iBoneIndex].OffsetMatrix * globalTransformation *
+                    m_globalInverseTransform;
+            }
         }
     }
 
@@ -1039,4 +2249,247 @@ namespace library
         m_aIndices.reserve(uNumIndices);
         m_aBoneData.resize(uNumVertices);
     }
-}
\ No newline at end of file
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::saveToCache
+
+      Summary:  Writes the imported model as a cooked mesh
+
+      Args:     const std::filesystem::path& cachePath
+                  Path to write to
+                const MeshCacheKey& key
+                  Key of the import
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::saveToCache(_In_ const std::filesystem::path& cachePath, _In_ const MeshCacheKey& key) const
+    {
+        MeshCacheWriter writer(key);
+        writer.SetGlobalInverseTransform(m_globalInverseTransform);
+        writer.SetSection(MeshCacheSection::Vertices, m_aVertices);
+        writer.SetSection(MeshCacheSection::NormalData, m_aNormalData);
+        writer.SetSection(MeshCacheSection::AnimationData, m_aAnimationData);
+        writer.SetSection(MeshCacheSection::Indices, m_aIndexData);
+        writer.SetSection(MeshCacheSection::Meshes, m_aMeshes);
+        writer.SetSection(MeshCacheSection::Meshlets, m_aMeshlets);
+
+        auto addPath = [&writer](const std::string& szPath)
+        {
+            return szPath.empty() ? MESH_CACHE_NO_STRING : writer.AddString(szPath);
+        };
+        std::vector<CookedMaterial> aMaterials;
+        aMaterials.reserve(m_aMaterialTextures.size());
+        for (const MaterialTextures& textures : m_aMaterialTextures)
+        {
+            aMaterials.push_back({ addPath(textures.szDiffusePath), addPath(textures.szSpecularPath), addPath(textures.szNormalPath) });
+        }
+        writer.SetSection(MeshCacheSection::Materials, aMaterials);
+
+        std::vector<CookedBone> aBones(m_aBoneInfo.size());
+        for (const auto& [szName, uBoneIndex] : m_boneNameToIndexMap)
+        {
+            aBones[uBoneIndex].uName = writer.AddString(szName);
+            XMStoreFloat4x4(&aBones[uBoneIndex].OffsetMatrix, m_aBoneInfo[uBoneIndex].OffsetMatrix);
+        }
+        writer.SetSection(MeshCacheSection::Bones, aBones);
+
+        std::vector<CookedNode> aNodes;
+        aNodes.reserve(m_aSkeletonNodes.size());
+        for (const SkeletonNode& node : m_aSkeletonNodes)
+        {
+            aNodes.push_back({ writer.AddString(node.szName), node.iParent, node.iBoneIndex, node.Transformation });
+        }
+        writer.SetSection(MeshCacheSection::Nodes, aNodes);
+
+        std::vector<CookedClip> aClips;
+        std::vector<CookedChannel> aChannels;
+        std::vector<VectorKey> aVectorKeys;
+        std::vector<QuaternionKey> aQuaternionKeys;
+        for (const AnimationClip& clip : m_aAnimations)
+        {
+            aClips.push_back({ clip.Duration, clip.TicksPerSecond, static_cast<UINT>(aChannels.size()), static_cast<UINT>(clip.aChannels.size()) });
+            for (const AnimationChannel& channel : clip.aChannels)
+            {
+                CookedChannel cooked =
+                {
+                    .uNodeIndex = channel.uNodeIndex,
+                    .uFirstPositionKey = static_cast<UINT>(aVectorKeys.size()),
+                    .uNumPositionKeys = static_cast<UINT>(channel.aPositionKeys.size()),
+                    .uFirstRotationKey = static_cast<UINT>(aQuaternionKeys.size()),
+                    .uNumRotationKeys = static_cast<UINT>(channel.aRotationKeys.size()),
+                    .uFirstScalingKey = static_cast<UINT>(aVectorKeys.size() + channel.aPositionKeys.size()),
+                    .uNumScalingKeys = static_cast<UINT>(channel.aScalingKeys.size())
+                };
+                aVectorKeys.insert(aVectorKeys.end(), channel.aPositionKeys.begin(), channel.aPositionKeys.end());
+                aVectorKeys.insert(aVectorKeys.end(), channel.aScalingKeys.begin(), channel.aScalingKeys.end());
+                aQuaternionKeys.insert(aQuaternionKeys.end(), channel.aRotationKeys.begin(), channel.aRotationKeys.end());
+                aChannels.push_back(cooked);
+            }
+        }
+        writer.SetSection(MeshCacheSection::Clips, aClips);
+        writer.SetSection(MeshCacheSection::Channels, aChannels);
+        writer.SetSection(MeshCacheSection::VectorKeys, aVectorKeys);
+        writer.SetSection(MeshCacheSection::QuaternionKeys, aQuaternionKeys);
+
+        return writer.Save(cachePath);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::optimizeMeshes
+
+      Summary:  Reorders the triangles of every mesh for the
+                post-transform vertex cache and then for overdraw, and
+                its vertices for fetch locality. Reports the ACMR and
+                ATVR of every mesh before and after
+
+      Modifies: [m_aIndices, m_aVertices, m_aNormalData, m_aBoneData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::optimizeMeshes()
+    {
+        std::vector<UINT> aCacheIndices;
+        std::vector<UINT> aClusters;
+        std::vector<UINT> aRemap;
+        std::vector<SimpleVertex> aVertices;
+        std::vector<NormalData> aNormalData;
+        std::vector<VertexBoneData> aBoneData;
+
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            UINT uNumVertices = getNumMeshVertices(i);
+            if (uNumVertices == 0u || mesh.uNumIndices == 0u)
+            {
+                continue;
+            }
+
+            UINT* aMeshIndices = &m_aIndices[mesh.uBaseIndex];
+            SimpleVertex* aMeshVertices = &m_aVertices[mesh.uBaseVertex];
+
+            VertexCacheStats before = AnalyzeVertexCache(aMeshIndices, mesh.uNumIndices, uNumVertices, VERTEX_CACHE_SIZE);
+
+            aCacheIndices.resize(mesh.uNumIndices);
+            OptimizeVertexCache(aMeshIndices, mesh.uNumIndices, uNumVertices, VERTEX_CACHE_SIZE, aCacheIndices.data(), &aClusters);
+            OptimizeOverdraw(
+                aCacheIndices.data(),
+                mesh.uNumIndices,
+                &aMeshVertices[0].Position,
+                sizeof(SimpleVertex),
+                uNumVertices,
+                aClusters,
+                VERTEX_CACHE_SIZE,
+                OVERDRAW_THRESHOLD,
+                aMeshIndices
+            );
+            OptimizeVertexFetch(aMeshIndices, mesh.uNumIndices, uNumVertices, aRemap);
+
+            aVertices.assign(aMeshVertices, aMeshVertices + uNumVertices);
+            aNormalData.assign(&m_aNormalData[mesh.uBaseVertex], &m_aNormalData[mesh.uBaseVertex] + uNumVertices);
+            aBoneData.assign(&m_aBoneData[mesh.uBaseVertex], &m_aBoneData[mesh.uBaseVertex] + uNumVertices);
+            for (UINT j = 0u; j < uNumVertices; ++j)
+            {
+                m_aVertices[mesh.uBaseVertex + j] = aVertices[aRemap[j]];
+                m_aNormalData[mesh.uBaseVertex + j] = aNormalData[aRemap[j]];
+                m_aBoneData[mesh.uBaseVertex + j] = aBoneData[aRemap[j]];
+            }
+
+            VertexCacheStats after = AnalyzeVertexCache(aMeshIndices, mesh.uNumIndices, uNumVertices, VERTEX_CACHE_SIZE);
+
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"%s mesh %u: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+                m_filePath.filename().c_str(),
+                i,
+                before.Acmr,
+                after.Acmr,
+                before.Atvr,
+                after.Atvr
+            );
+            OutputDebugString(szMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::splitLargeMeshes
+
+      Summary:  Replaces every mesh whose indices do not fit in 16 bits
+                by submeshes that do. Submeshes keep the material of
+                their mesh, the vertices they share are duplicated
+
+      Modifies: [m_aMeshes, m_aVertices, m_aNormalData, m_aBoneData,
+                 m_aIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::splitLargeMeshes()
+    {
+        BOOL bHasLargeMesh = FALSE;
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            bHasLargeMesh |= NeedsIndex32(&m_aIndices[mesh.uBaseIndex], mesh.uNumIndices);
+        }
+
+        if (!bHasLargeMesh)
+        {
+            return;
+        }
+
+        std::vector<BasicMeshEntry> aMeshes;
+        std::vector<SimpleVertex> aVertices;
+        std::vector<NormalData> aNormalData;
+        std::vector<VertexBoneData> aBoneData;
+        std::vector<UINT> aIndices;
+        aMeshes.reserve(m_aMeshes.size());
+        aVertices.reserve(m_aVertices.size());
+        aNormalData.reserve(m_aNormalData.size());
+        aBoneData.reserve(m_aBoneData.size());
+        aIndices.reserve(m_aIndices.size());
+
+        std::vector<Submesh> aSubmeshes;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            UINT uNumVertices = getNumMeshVertices(i);
+            const UINT* aMeshIndices = &m_aIndices[mesh.uBaseIndex];
+
+            if (NeedsIndex32(aMeshIndices, mesh.uNumIndices))
+            {
+                SplitMeshForIndex16(aMeshIndices, mesh.uNumIndices, uNumVertices, aSubmeshes);
+            }
+            else
+            {
+                // Keep the mesh as a single submesh with an identity remap
+                aSubmeshes.resize(1u);
+                aSubmeshes[0].aVertexRemap.resize(uNumVertices);
+                for (UINT j = 0u; j < uNumVertices; ++j)
+                {
+                    aSubmeshes[0].aVertexRemap[j] = j;
+                }
+                aSubmeshes[0].aIndices.assign(aMeshIndices, aMeshIndices + mesh.uNumIndices);
+            }
+
+            for (const Submesh& submesh : aSubmeshes)
+            {
+                BasicMeshEntry entry;
+                entry.uNumIndices = static_cast<UINT>(submesh.aIndices.size());
+                entry.uBaseVertex = static_cast<UINT>(aVertices.size());
+                entry.uBaseIndex = static_cast<UINT>(aIndices.size());
+                entry.uMaterialIndex = mesh.uMaterialIndex;
+                aMeshes.push_back(entry);
+
+                for (UINT uVertex : submesh.aVertexRemap)
+                {
+                    aVertices.push_back(m_aVertices[mesh.uBaseVertex + uVertex]);
+                    aNormalData.push_back(m_aNormalData[mesh.uBaseVertex + uVertex]);
+                    aBoneData.push_back(m_aBoneData[mesh.uBaseVertex + uVertex]);
+                }
+                aIndices.insert(aIndices.end(), submesh.aIndices.begin(), submesh.aIndices.end());
+            }
+        }
+
+        m_aMeshes = std::move(aMeshes);
+        m_aVertices = std::move(aVertices);
+        m_aNormalData = std::move(aNormalData);
+        m_aBoneData = std::move(aBoneData);
+        m_aIndices = std::move(aIndices);
+    }
+}
@@ -12,6 +12,11 @@
 #pragma once
 
 #include "Common.h"
+#include "Model/CpuSkinning.h"
+#include "Model/MeshCache.h"
+#include "Model/Meshlet.h"
+#include "Model/Skeleton.h"
+#include "Model/VertexQuantization.h"
 #include "Renderer/DataTypes.h"
 #include "Renderer/Renderable.h"
 #include "Shader/PixelShader.h"
@@ -21,10 +26,8 @@
 struct aiScene;
 struct aiMesh;
 struct aiMaterial;
-struct aiAnimation;
 struct aiBone;
 struct aiNode;
-struct aiNodeAnim;
 
 namespace Assimp
 {
@@ -38,7 +41,10 @@ namespace library
 
       Summary:  Model class is a renderable from model files
 
-      Methods:  Initialize
+      Methods:  Import
+                  Loads the model and the files of its textures
+                  without the device
+                Initialize
                   Pure virtual function that initializes the object
                 Update
                   Pure virtual function that updates the object each
@@ -57,6 +63,47 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                SkinVerticesOnCpu
+                  Skins the vertices with the current bone transforms
+                  into caller provided buffers
+                SetSplitLargeMeshes
+                  Chooses between splitting meshes too large for 16-bit
+                  indices and drawing them with 32-bit indices
+                SetQuantizeVertices
+                  Chooses whether a QuantizedVertex buffer is created
+                HasQuantizedVertices
+                  Returns whether the model is drawn from the
+                  QuantizedVertex buffer
+                GetQuantizedVertexBuffer
+                  Returns the QuantizedVertex buffer
+                GetQuantizationConstantBuffer
+                  Returns the constant buffer decoding the positions
+                SetGenerateLods
+                  Chooses whether a LOD chain is built at import
+                SelectLod
+                  Picks the LOD from the projected size of the model
+                GetLod
+                  Returns the LOD picked by SelectLod
+                SetBuildMeshlets
+                  Chooses whether the meshes are split into meshlets
+                  at import
+                CullMeshlets
+                  Culls the meshlets against the view and gathers the
+                  draw ranges of the survivors
+                GetDrawRanges
+                  Returns the draw ranges of a mesh for this frame
+                GetClipBoundingBox
+                  Returns the box holding every pose of a clip
+                GetFilePath
+                  Returns the path of the model file
+                GetCookedMeshPath
+                  Returns the path of the cooked mesh of the current
+                  import settings
+                GetCookedMeshKey
+                  Returns the key of the cooked mesh Import used
+                SetSnapshotSource
+                  Makes Import read the cooked mesh from a range of a
+                  scene snapshot
                 Model
                   Constructor.
                 ~Model
@@ -73,11 +120,14 @@ namespace library
         Model& operator=(Model&& other) = delete;
         virtual ~Model() = default;
 
+        HRESULT Import();
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         virtual void Update(_In_ FLOAT deltaTime) override;
 
         ComPtr<ID3D11Buffer>& GetAnimationBuffer();
         ComPtr<ID3D11Buffer>& GetSkinningConstantBuffer();
+        ComPtr<ID3D11Buffer>& GetQuantizedVertexBuffer();
+        ComPtr<ID3D11Buffer>& GetQuantizationConstantBuffer();
 
         virtual UINT GetNumVertices() const override;
         virtual UINT GetNumIndices() const override;
@@ -85,6 +135,27 @@ namespace library
         std::vector<XMMATRIX>& GetBoneTransforms();
         const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
 
+        void SkinVerticesOnCpu(_In_ const SkinnedVertexStreams& outStreams, _In_opt_ ThreadPool* pThreadPool) const;
+
+        void SetSplitLargeMeshes(_In_ BOOL bSplitLargeMeshes);
+        void SetQuantizeVertices(_In_ BOOL bQuantizeVertices);
+        BOOL HasQuantizedVertices() const;
+
+        void SetGenerateLods(_In_ BOOL bGenerateLods);
+        UINT SelectLod(_In_ const XMVECTOR& eye, _In_ FLOAT projectionScale);
+        UINT GetLod() const;
+
+        void SetBuildMeshlets(_In_ BOOL bBuildMeshlets);
+        void CullMeshlets(_In_ const XMMATRIX& viewProjection, _In_ const XMVECTOR& eye);
+        const IndexRange* GetDrawRanges(_In_ UINT uMeshIndex, _Out_ UINT& uOutNumRanges) const;
+
+        const BoundingBox& GetClipBoundingBox(_In_ UINT uClip) const;
+
+        const std::filesystem::path& GetFilePath() const;
+        std::filesystem::path GetCookedMeshPath() const;
+        const MeshCacheKey& GetCookedMeshKey() const;
+        void SetSnapshotSource(_In_ const std::filesystem::path& snapshotPath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize, _In_ const MeshCacheKey& key);
+
     protected:
         struct VertexBoneData
         {
@@ -99,16 +170,29 @@ namespace library
 
             void AddBoneData(_In_ UINT uBoneId, _In_ FLOAT weight)
             {
-                assert(uNumBones < ARRAYSIZE(aBoneIds));
+                if (uNumBones < ARRAYSIZE(aBoneIds))
+                {
+                    aBoneIds[uNumBones] = uBoneId;
+                    aWeights[uNumBones] = weight;
+                    ++uNumBones;
+                    return;
+                }
 
-                aBoneIds[uNumBones] = uBoneId;
-                aWeights[uNumBones] = weight;
+                // Out of slots, replace the weakest influence if this one is stronger
+                UINT uWeakest = 0u;
+                for (UINT i = 1u; i < uNumBones; ++i)
+                {
+                    if (aWeights[i] < aWeights[uWeakest])
+                    {
+                        uWeakest = i;
+                    }
+                }
 
-                static CHAR szDebugMessage[256];
-                sprintf_s(szDebugMessage, "\t\t\tBone %d, weight: %f, index %u\n", uBoneId, weight, uNumBones);
-                OutputDebugStringA(szDebugMessage);
-
-                ++uNumBones;
+                if (weight > aWeights[uWeakest])
+                {
+                    aBoneIds[uWeakest] = uBoneId;
+                    aWeights[uWeakest] = weight;
+                }
             }
 
             UINT aBoneIds[MAX_NUM_BONES_PER_VERTEX];
@@ -116,6 +200,13 @@ namespace library
             UINT uNumBones;
         };
 
+        struct MaterialTextures
+        {
+            std::string szDiffusePath;
+            std::string szSpecularPath;
+            std::string szNormalPath;
+        };
+
         struct BoneInfo
         {
             BoneInfo() = default;
@@ -130,83 +221,85 @@ namespace library
         };
 
         void countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene);
-        const aiNodeAnim* findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName);
-        UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+        UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel);
+        UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel);
+        UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel);
         UINT getBoneId(_In_ const aiBone* pBone);
+        virtual PCSTR getCookVariant() const;
+        std::string getCookVariantName() const;
         const virtual SimpleVertex* getVertices() const override;
         virtual const WORD* getIndices() const override;
+        virtual const void* getIndexData() const override;
+        virtual UINT getIndexDataSize() const override;
+        UINT getNumMeshVertices(_In_ UINT uMeshIndex) const;
         void initAllMeshes(_In_ const aiScene* pScene);
-        HRESULT initFromScene(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const aiScene* pScene,
-            _In_ const std::filesystem::path& filePath
-        );
-        HRESULT initMaterials(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const aiScene* pScene,
-            _In_ const std::filesystem::path& filePath
-        );
+        void initAnimations(_In_ const aiScene* pScene);
+        void initFromScene(_In_ const aiScene* pScene);
+        HRESULT initMaterials(_In_ const std::filesystem::path& filePath);
+        void buildLods();
+        void buildMeshlets();
+        void initAnimationData();
+        void initClipBounds();
+        void initIndexData();
+        void initMaterialTextures(_In_ const aiScene* pScene);
         void initMeshBones(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
+        HRESULT initQuantizedVertices(_In_ ID3D11Device* pDevice);
         void initMeshSingleBone(_In_ UINT uBoneIndex, _In_ const aiBone* pBone);
+        void initSkeleton(_In_ const aiNode* pNode, _In_ INT iParent);
         virtual void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
-        void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        HRESULT loadDiffuseTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        HRESULT loadSpecularTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        HRESULT loadNormalTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        HRESULT loadTextures(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform);
+        void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel);
+        void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel);
+        void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const AnimationChannel& channel);
+        HRESULT loadDiffuseTexture(_In_ const std::filesystem::path& parentDirectory, _In_ UINT uIndex);
+        HRESULT loadFromCache(_In_ const std::filesystem::path& cachePath, _In_ const MeshCacheKey& key, _In_opt_ UINT64 ullOffset = 0ull, _In_opt_ SIZE_T uSize = 0u);
+        HRESULT loadSpecularTexture(_In_ const std::filesystem::path& parentDirectory, _In_ UINT uIndex);
+        HRESULT loadNormalTexture(_In_ const std::filesystem::path& parentDirectory, _In_ UINT uIndex);
+        HRESULT loadTextures(_In_ const std::filesystem::path& parentDirectory, _In_ UINT uIndex);
+        void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const AnimationClip& clip);
+        void optimizeMeshes();
         void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
+        HRESULT saveToCache(_In_ const std::filesystem::path& cachePath, _In_ const MeshCacheKey& key) const;
+        void splitLargeMeshes();
 
     protected:
-        static std::unique_ptr<Assimp::Importer> sm_pImporter;
+        static Assimp::Importer& getImporter();
 
     protected:
         std::filesystem::path m_filePath;
 
         ComPtr<ID3D11Buffer> m_animationBuffer;
         ComPtr<ID3D11Buffer> m_skinningConstantBuffer;
+        ComPtr<ID3D11Buffer> m_quantizedVertexBuffer;
+        ComPtr<ID3D11Buffer> m_quantizationConstantBuffer;
 
         std::vector<SimpleVertex> m_aVertices;
         std::vector<AnimationData> m_aAnimationData;
-        std::vector<WORD> m_aIndices;
+        std::vector<UINT> m_aIndices;
+        std::vector<BYTE> m_aIndexData;
         std::vector<VertexBoneData> m_aBoneData;
         std::vector<BoneInfo> m_aBoneInfo;
         std::vector<XMMATRIX> m_aTransforms;
         std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
-
-        const aiScene* m_pScene;
+        std::vector<MaterialTextures> m_aMaterialTextures;
+        std::vector<SkeletonNode> m_aSkeletonNodes;
+        std::vector<AnimationClip> m_aAnimations;
+        std::vector<XMMATRIX> m_aNodeTransforms;
+        std::vector<Meshlet> m_aMeshlets;
+        std::vector<IndexRange> m_aDrawRanges;
+        std::vector<UINT> m_aDrawRangeOffsets;
+        std::vector<BoundingBox> m_aClipBoundingBoxes;
 
         float m_timeSinceLoaded;
+        BOOL m_bSplitLargeMeshes;
+        BOOL m_bQuantizeVertices;
+        BOOL m_bGenerateLods;
+        UINT m_uLod;
+        BOOL m_bBuildMeshlets;
+        BOOL m_bImported;
+        MeshCacheKey m_cookedMeshKey;
+        std::filesystem::path m_snapshotPath;
+        UINT64 m_ullSnapshotOffset;
+        SIZE_T m_uSnapshotSize;
 
         XMMATRIX m_globalInverseTransform;
 
@@ -0,0 +1,74 @@
+/*+===================================================================
+  File:      SKELETON.H
+
+  Summary:   Skeleton header file contains the node hierarchy and
+             animation clip types a Model keeps after importing, so
+             that animating does not depend on the Assimp scene.
+
+  Structs: SkeletonNode, VectorKey, QuaternionKey, AnimationChannel,
+           AnimationClip
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SkeletonNode
+
+      Summary:  Node of the flattened scene hierarchy. Nodes are stored
+                depth first, so a parent always comes before its
+                children. iParent and iBoneIndex are -1 when the node
+                is the root or does not drive a bone
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SkeletonNode
+    {
+        std::string szName;
+        INT iParent;
+        INT iBoneIndex;
+        XMFLOAT4X4 Transformation;
+    };
+
+    struct VectorKey
+    {
+        FLOAT Time;
+        XMFLOAT3 Value;
+    };
+
+    struct QuaternionKey
+    {
+        FLOAT Time;
+        XMFLOAT4 Value;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationChannel
+
+      Summary:  Key frames animating a single skeleton node
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationChannel
+    {
+        UINT uNodeIndex;
+        std::vector<VectorKey> aPositionKeys;
+        std::vector<QuaternionKey> aRotationKeys;
+        std::vector<VectorKey> aScalingKeys;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationClip
+
+      Summary:  Animation of the skeleton. aNodeChannels maps every
+                skeleton node to its channel, -1 if the node keeps its
+                bind transformation
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationClip
+    {
+        FLOAT Duration;
+        FLOAT TicksPerSecond;
+        std::vector<AnimationChannel> aChannels;
+        std::vector<INT> aNodeChannels;
+    };
+}
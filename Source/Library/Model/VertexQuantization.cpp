@@ -0,0 +1,304 @@
+#include "Model/VertexQuantization.h"
+
+#include <DirectXPackedVector.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const FLOAT UNORM16_MAX = 65535.0f;
+        constexpr const FLOAT UNORM10_MAX = 1023.0f;
+        constexpr const FLOAT TWO_PI = 6.28318530718f;
+
+        FLOAT Dot(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        XMFLOAT3 Cross(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b)
+        {
+            return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+        }
+
+        XMFLOAT3 Normalize(_In_ const XMFLOAT3& v)
+        {
+            FLOAT length = std::sqrt(Dot(v, v));
+            return length > 0.0f ? XMFLOAT3(v.x / length, v.y / length, v.z / length) : XMFLOAT3(0.0f, 0.0f, 1.0f);
+        }
+
+        UINT QuantizeUnorm(_In_ FLOAT value, _In_ FLOAT maxValue)
+        {
+            return static_cast<UINT>(std::clamp(value, 0.0f, 1.0f) * maxValue + 0.5f);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: EncodeOctahedral
+
+          Summary:  Projects a unit vector on the octahedron and unfolds
+                    it into the [0, 1] square (Cigolle et al. 2014)
+        -----------------------------------------------------------------F-F*/
+        XMFLOAT2 EncodeOctahedral(_In_ const XMFLOAT3& n)
+        {
+            FLOAT l1Norm = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            FLOAT x = n.x / l1Norm;
+            FLOAT y = n.y / l1Norm;
+            if (n.z < 0.0f)
+            {
+                FLOAT foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                FLOAT foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x = foldedX;
+                y = foldedY;
+            }
+
+            return XMFLOAT2(x * 0.5f + 0.5f, y * 0.5f + 0.5f);
+        }
+
+        XMFLOAT3 DecodeOctahedral(_In_ FLOAT u, _In_ FLOAT v)
+        {
+            XMFLOAT3 n(u * 2.0f - 1.0f, v * 2.0f - 1.0f, 0.0f);
+            n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+            FLOAT t = std::max(-n.z, 0.0f);
+            n.x += n.x >= 0.0f ? -t : t;
+            n.y += n.y >= 0.0f ? -t : t;
+
+            return Normalize(n);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: BuildOrthonormalBasis
+
+          Summary:  Branchless basis around a unit normal (Duff et al.
+                    2017). The tangent angle is measured in this basis,
+                    so the shader has to build the exact same one
+        -----------------------------------------------------------------F-F*/
+        void BuildOrthonormalBasis(_In_ const XMFLOAT3& n, _Out_ XMFLOAT3& outB0, _Out_ XMFLOAT3& outB1)
+        {
+            FLOAT sign = n.z >= 0.0f ? 1.0f : -1.0f;
+            FLOAT a = -1.0f / (sign + n.z);
+            FLOAT b = n.x * n.y * a;
+            outB0 = XMFLOAT3(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+            outB1 = XMFLOAT3(b, sign + n.y * n.y * a, -n.y);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeQuantizationBounds
+
+      Summary:  Returns the bounding box of the vertex positions. Flat
+                axes get a tiny extent so that decoding stays finite
+
+      Args:     const SimpleVertex* aVertices
+                  Vertices to bound
+                UINT uNumVertices
+                  Number of vertices
+
+      Returns:  QuantizationBounds
+                  Minimum corner and extent of the box
+    -----------------------------------------------------------------F-F*/
+    QuantizationBounds ComputeQuantizationBounds(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices
+    )
+    {
+        XMFLOAT3 minimum(0.0f, 0.0f, 0.0f);
+        XMFLOAT3 maximum(0.0f, 0.0f, 0.0f);
+        if (uNumVertices > 0u)
+        {
+            minimum = maximum = aVertices[0].Position;
+        }
+        for (UINT i = 1u; i < uNumVertices; ++i)
+        {
+            const XMFLOAT3& position = aVertices[i].Position;
+            minimum = XMFLOAT3(std::min(minimum.x, position.x), std::min(minimum.y, position.y), std::min(minimum.z, position.z));
+            maximum = XMFLOAT3(std::max(maximum.x, position.x), std::max(maximum.y, position.y), std::max(maximum.z, position.z));
+        }
+
+        constexpr const FLOAT MIN_EXTENT = 1e-6f;
+        QuantizationBounds bounds =
+        {
+            .Min = minimum,
+            .Extent = XMFLOAT3(
+                std::max(maximum.x - minimum.x, MIN_EXTENT),
+                std::max(maximum.y - minimum.y, MIN_EXTENT),
+                std::max(maximum.z - minimum.z, MIN_EXTENT)
+            )
+        };
+
+        return bounds;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: PackTangentFrame
+
+      Summary:  Packs a tangent frame into 32 bits. The normal is
+                stored as a 10:10 octahedral vector, the tangent as its
+                10-bit angle around the decoded normal and the
+                bitangent as the 2-bit handedness of the frame
+
+      Args:     const XMFLOAT3& normal
+                  Normal of the vertex
+                const XMFLOAT3& tangent
+                  Tangent of the vertex, may be zero
+                const XMFLOAT3& bitangent
+                  Bitangent of the vertex, may be zero
+
+      Returns:  UINT
+                  Frame in DXGI_FORMAT_R10G10B10A2_UNORM layout
+    -----------------------------------------------------------------F-F*/
+    UINT PackTangentFrame(
+        _In_ const XMFLOAT3& normal,
+        _In_ const XMFLOAT3& tangent,
+        _In_ const XMFLOAT3& bitangent
+    )
+    {
+        XMFLOAT2 octahedral = EncodeOctahedral(Normalize(normal));
+        UINT uNormalX = QuantizeUnorm(octahedral.x, UNORM10_MAX);
+        UINT uNormalY = QuantizeUnorm(octahedral.y, UNORM10_MAX);
+
+        // Measure the angle against the normal the shader will see, not
+        // the exact one, so the tangent stays perpendicular after decoding
+        XMFLOAT3 decodedNormal = DecodeOctahedral(static_cast<FLOAT>(uNormalX) / UNORM10_MAX, static_cast<FLOAT>(uNormalY) / UNORM10_MAX);
+        XMFLOAT3 b0;
+        XMFLOAT3 b1;
+        BuildOrthonormalBasis(decodedNormal, b0, b1);
+
+        FLOAT angle = std::atan2(Dot(tangent, b1), Dot(tangent, b0));
+        if (angle < 0.0f)
+        {
+            angle += TWO_PI;
+        }
+        UINT uAngle = QuantizeUnorm(angle / TWO_PI, UNORM10_MAX) & 0x3FFu;
+
+        BOOL bRightHanded = Dot(Cross(decodedNormal, tangent), bitangent) >= 0.0f;
+
+        return uNormalX | (uNormalY << 10u) | (uAngle << 20u) | ((bRightHanded ? 3u : 0u) << 30u);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: UnpackTangentFrame
+
+      Summary:  Decodes a frame packed by PackTangentFrame the way
+                QuantizedShaders.fxh does
+
+      Args:     UINT uTangentFrame
+                  Packed frame
+                XMFLOAT3& outNormal
+                  Receives the unit normal
+                XMFLOAT3& outTangent
+                  Receives the unit tangent
+                XMFLOAT3& outBitangent
+                  Receives the unit bitangent
+    -----------------------------------------------------------------F-F*/
+    void UnpackTangentFrame(
+        _In_ UINT uTangentFrame,
+        _Out_ XMFLOAT3& outNormal,
+        _Out_ XMFLOAT3& outTangent,
+        _Out_ XMFLOAT3& outBitangent
+    )
+    {
+        FLOAT u = static_cast<FLOAT>(uTangentFrame & 0x3FFu) / UNORM10_MAX;
+        FLOAT v = static_cast<FLOAT>((uTangentFrame >> 10u) & 0x3FFu) / UNORM10_MAX;
+        FLOAT angle = static_cast<FLOAT>((uTangentFrame >> 20u) & 0x3FFu) / UNORM10_MAX * TWO_PI;
+        FLOAT handedness = (uTangentFrame >> 30u) >= 2u ? 1.0f : -1.0f;
+
+        outNormal = DecodeOctahedral(u, v);
+
+        XMFLOAT3 b0;
+        XMFLOAT3 b1;
+        BuildOrthonormalBasis(outNormal, b0, b1);
+        FLOAT cosine = std::cos(angle);
+        FLOAT sine = std::sin(angle);
+        outTangent = XMFLOAT3(
+            b0.x * cosine + b1.x * sine,
+            b0.y * cosine + b1.y * sine,
+            b0.z * cosine + b1.z * sine
+        );
+
+        XMFLOAT3 bitangent = Cross(outNormal, outTangent);
+        outBitangent = XMFLOAT3(bitangent.x * handedness, bitangent.y * handedness, bitangent.z * handedness);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: QuantizeVertices
+
+      Summary:  Compresses vertices into QuantizedVertex
+
+      Args:     const SimpleVertex* aVertices
+                  Vertices to compress
+                const NormalData* aNormalData
+                  Tangents and bitangents of the vertices, may be
+                  nullptr
+                UINT uNumVertices
+                  Number of vertices
+                const QuantizationBounds& bounds
+                  Box the positions are quantized in
+                QuantizedVertex* aOutVertices
+                  Receives the compressed vertices
+    -----------------------------------------------------------------F-F*/
+    void QuantizeVertices(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_ UINT uNumVertices,
+        _In_ const QuantizationBounds& bounds,
+        _Out_writes_(uNumVertices) QuantizedVertex* aOutVertices
+    )
+    {
+        const XMFLOAT3 zero(0.0f, 0.0f, 0.0f);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            const SimpleVertex& vertex = aVertices[i];
+            QuantizedVertex& quantized = aOutVertices[i];
+
+            quantized.aPosition[0] = static_cast<USHORT>(QuantizeUnorm((vertex.Position.x - bounds.Min.x) / bounds.Extent.x, UNORM16_MAX));
+            quantized.aPosition[1] = static_cast<USHORT>(QuantizeUnorm((vertex.Position.y - bounds.Min.y) / bounds.Extent.y, UNORM16_MAX));
+            quantized.aPosition[2] = static_cast<USHORT>(QuantizeUnorm((vertex.Position.z - bounds.Min.z) / bounds.Extent.z, UNORM16_MAX));
+            quantized.aPosition[3] = static_cast<USHORT>(UNORM16_MAX);
+
+            quantized.aTexCoord[0] = PackedVector::XMConvertFloatToHalf(vertex.TexCoord.x);
+            quantized.aTexCoord[1] = PackedVector::XMConvertFloatToHalf(vertex.TexCoord.y);
+
+            quantized.uTangentFrame = PackTangentFrame(
+                vertex.Normal,
+                aNormalData ? aNormalData[i].Tangent : zero,
+                aNormalData ? aNormalData[i].Bitangent : zero
+            );
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: DequantizeVertex
+
+      Summary:  Decodes a QuantizedVertex the way QuantizedShaders.fxh
+                does, used to measure the quantization error
+
+      Args:     const QuantizedVertex& vertex
+                  Compressed vertex
+                const QuantizationBounds& bounds
+                  Box the position was quantized in
+                SimpleVertex& outVertex
+                  Receives the position, texture coordinate and normal
+                NormalData& outNormalData
+                  Receives the tangent and bitangent
+    -----------------------------------------------------------------F-F*/
+    void DequantizeVertex(
+        _In_ const QuantizedVertex& vertex,
+        _In_ const QuantizationBounds& bounds,
+        _Out_ SimpleVertex& outVertex,
+        _Out_ NormalData& outNormalData
+    )
+    {
+        outVertex.Position = XMFLOAT3(
+            bounds.Min.x + static_cast<FLOAT>(vertex.aPosition[0]) / UNORM16_MAX * bounds.Extent.x,
+            bounds.Min.y + static_cast<FLOAT>(vertex.aPosition[1]) / UNORM16_MAX * bounds.Extent.y,
+            bounds.Min.z + static_cast<FLOAT>(vertex.aPosition[2]) / UNORM16_MAX * bounds.Extent.z
+        );
+        outVertex.TexCoord = XMFLOAT2(
+            PackedVector::XMConvertHalfToFloat(vertex.aTexCoord[0]),
+            PackedVector::XMConvertHalfToFloat(vertex.aTexCoord[1])
+        );
+        UnpackTangentFrame(vertex.uTangentFrame, outVertex.Normal, outNormalData.Tangent, outNormalData.Bitangent);
+    }
+}
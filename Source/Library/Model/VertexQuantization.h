@@ -0,0 +1,68 @@
+/*+===================================================================
+  File:      VERTEXQUANTIZATION.H
+
+  Summary:   VertexQuantization header file contains declarations of
+             the functions that compress SimpleVertex and NormalData
+             into QuantizedVertex and decode them back the same way
+             the quantized vertex shader does.
+
+  Structs:   QuantizationBounds
+
+  Functions: ComputeQuantizationBounds, PackTangentFrame,
+             UnpackTangentFrame, QuantizeVertices, DequantizeVertex
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   QuantizationBounds
+
+      Summary:  Box the quantized positions are relative to. A 16-bit
+                unorm position p decodes to Min + p * Extent
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct QuantizationBounds
+    {
+        XMFLOAT3 Min;
+        XMFLOAT3 Extent;
+    };
+
+    QuantizationBounds ComputeQuantizationBounds(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices
+    );
+
+    UINT PackTangentFrame(
+        _In_ const XMFLOAT3& normal,
+        _In_ const XMFLOAT3& tangent,
+        _In_ const XMFLOAT3& bitangent
+    );
+
+    void UnpackTangentFrame(
+        _In_ UINT uTangentFrame,
+        _Out_ XMFLOAT3& outNormal,
+        _Out_ XMFLOAT3& outTangent,
+        _Out_ XMFLOAT3& outBitangent
+    );
+
+    void QuantizeVertices(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_ UINT uNumVertices,
+        _In_ const QuantizationBounds& bounds,
+        _Out_writes_(uNumVertices) QuantizedVertex* aOutVertices
+    );
+
+    void DequantizeVertex(
+        _In_ const QuantizedVertex& vertex,
+        _In_ const QuantizationBounds& bounds,
+        _Out_ SimpleVertex& outVertex,
+        _Out_ NormalData& outNormalData
+    );
+}
@@ -0,0 +1,187 @@
+#include "Renderer/Bounds.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeBoundingBox
+
+      Summary:  Returns the axis aligned box of the positions. Four
+                independent min/max accumulators keep the SIMD units
+                busy, an empty range gives an empty box at the origin
+
+      Args:     const XMFLOAT3* aPositions
+                  First position
+                UINT uPositionStride
+                  Bytes between two positions
+                UINT uNumPositions
+                  Number of positions
+
+      Returns:  BoundingBox
+                  Box of the positions
+    -----------------------------------------------------------------F-F*/
+    BoundingBox ComputeBoundingBox(
+        _In_reads_bytes_(uNumPositions * uPositionStride) const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumPositions
+    )
+    {
+        if (uNumPositions == 0u)
+        {
+            return BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+        }
+
+        const BYTE* pPosition = reinterpret_cast<const BYTE*>(aPositions);
+        auto load = [pPosition, uPositionStride](UINT i)
+        {
+            return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(pPosition + static_cast<SIZE_T>(i) * uPositionStride));
+        };
+
+        XMVECTOR aMin[4] = { load(0u), load(0u), load(0u), load(0u) };
+        XMVECTOR aMax[4] = { aMin[0], aMin[0], aMin[0], aMin[0] };
+
+        UINT i = 0u;
+        for (; i + 4u <= uNumPositions; i += 4u)
+        {
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                XMVECTOR position = load(i + j);
+                aMin[j] = XMVectorMin(aMin[j], position);
+                aMax[j] = XMVectorMax(aMax[j], position);
+            }
+        }
+        for (; i < uNumPositions; ++i)
+        {
+            XMVECTOR position = load(i);
+            aMin[0] = XMVectorMin(aMin[0], position);
+            aMax[0] = XMVectorMax(aMax[0], position);
+        }
+
+        XMVECTOR minimum = XMVectorMin(XMVectorMin(aMin[0], aMin[1]), XMVectorMin(aMin[2], aMin[3]));
+        XMVECTOR maximum = XMVectorMax(XMVectorMax(aMax[0], aMax[1]), XMVectorMax(aMax[2], aMax[3]));
+
+        BoundingBox box;
+        XMStoreFloat3(&box.Center, (minimum + maximum) * 0.5f);
+        XMStoreFloat3(&box.Extents, (maximum - minimum) * 0.5f);
+
+        return box;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeBoundingSphere
+
+      Summary:  Returns the smallest sphere around the given center
+                holding every position. With the center of the bounding
+                box this is at most as large as the sphere around the
+                box and usually much tighter
+
+      Args:     const XMFLOAT3* aPositions
+                  First position
+                UINT uPositionStride
+                  Bytes between two positions
+                UINT uNumPositions
+                  Number of positions
+                const XMFLOAT3& center
+                  Center of the sphere
+
+      Returns:  BoundingSphere
+                  Sphere around the positions
+    -----------------------------------------------------------------F-F*/
+    BoundingSphere ComputeBoundingSphere(
+        _In_reads_bytes_(uNumPositions * uPositionStride) const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumPositions,
+        _In_ const XMFLOAT3& center
+    )
+    {
+        const BYTE* pPosition = reinterpret_cast<const BYTE*>(aPositions);
+        XMVECTOR sphereCenter = XMLoadFloat3(&center);
+        auto distanceSq = [pPosition, uPositionStride, sphereCenter](UINT i)
+        {
+            XMVECTOR position = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(pPosition + static_cast<SIZE_T>(i) * uPositionStride));
+            return XMVector3LengthSq(position - sphereCenter);
+        };
+
+        XMVECTOR aMax[4] = { g_XMZero, g_XMZero, g_XMZero, g_XMZero };
+
+        UINT i = 0u;
+        for (; i + 4u <= uNumPositions; i += 4u)
+        {
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                aMax[j] = XMVectorMax(aMax[j], distanceSq(i + j));
+            }
+        }
+        for (; i < uNumPositions; ++i)
+        {
+            aMax[0] = XMVectorMax(aMax[0], distanceSq(i));
+        }
+
+        XMVECTOR maximum = XMVectorMax(XMVectorMax(aMax[0], aMax[1]), XMVectorMax(aMax[2], aMax[3]));
+
+        return BoundingSphere(center, XMVectorGetX(XMVectorSqrt(maximum)));
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MergeBoundingBoxes
+
+      Summary:  Returns the box around all the given boxes, an empty
+                box at the origin when there are none
+
+      Args:     const BoundingBox* aBoxes
+                  Boxes to merge
+                UINT uNumBoxes
+                  Number of boxes
+
+      Returns:  BoundingBox
+                  Box around the boxes
+    -----------------------------------------------------------------F-F*/
+    BoundingBox MergeBoundingBoxes(_In_reads_(uNumBoxes) const BoundingBox* aBoxes, _In_ UINT uNumBoxes)
+    {
+        if (uNumBoxes == 0u)
+        {
+            return BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+        }
+
+        XMVECTOR minimum = XMLoadFloat3(&aBoxes[0].Center) - XMLoadFloat3(&aBoxes[0].Extents);
+        XMVECTOR maximum = XMLoadFloat3(&aBoxes[0].Center) + XMLoadFloat3(&aBoxes[0].Extents);
+        for (UINT i = 1u; i < uNumBoxes; ++i)
+        {
+            XMVECTOR center = XMLoadFloat3(&aBoxes[i].Center);
+            XMVECTOR extents = XMLoadFloat3(&aBoxes[i].Extents);
+            minimum = XMVectorMin(minimum, center - extents);
+            maximum = XMVectorMax(maximum, center + extents);
+        }
+
+        BoundingBox box;
+        XMStoreFloat3(&box.Center, (minimum + maximum) * 0.5f);
+        XMStoreFloat3(&box.Extents, (maximum - minimum) * 0.5f);
+
+        return box;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeScreenSize
+
+      Summary:  Returns the projected radius of a sphere relative to
+                half the height of the screen, the size the LODs and
+                the texture streaming go by
+
+      Args:     const BoundingSphere& sphere
+                  Sphere in world space
+                const XMVECTOR& eye
+                  Position of the camera
+                FLOAT projectionScale
+                  Cotangent of half the vertical field of view
+
+      Returns:  FLOAT
+                  Projected size, 1 covers the height of the screen
+    -----------------------------------------------------------------F-F*/
+    FLOAT ComputeScreenSize(_In_ const BoundingSphere& sphere, _In_ const XMVECTOR& eye, _In_ FLOAT projectionScale)
+    {
+        FLOAT distance = std::max(XMVectorGetX(XMVector3Length(XMLoadFloat3(&sphere.Center) - eye)), 1e-4f);
+
+        return sphere.Radius * projectionScale / distance;
+    }
+}
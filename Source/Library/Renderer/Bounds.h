@@ -0,0 +1,37 @@
+/*+===================================================================
+  File:      BOUNDS.H
+
+  Summary:   Bounds header file contains declarations of the functions
+             that compute the bounding boxes and spheres of vertex
+             ranges with vectorized min/max reductions.
+
+  Functions: ComputeBoundingBox, ComputeBoundingSphere,
+             MergeBoundingBoxes, ComputeScreenSize
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <DirectXCollision.h>
+
+namespace library
+{
+    BoundingBox ComputeBoundingBox(
+        _In_reads_bytes_(uNumPositions * uPositionStride) const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumPositions
+    );
+
+    BoundingSphere ComputeBoundingSphere(
+        _In_reads_bytes_(uNumPositions * uPositionStride) const XMFLOAT3* aPositions,
+        _In_ UINT uPositionStride,
+        _In_ UINT uNumPositions,
+        _In_ const XMFLOAT3& center
+    );
+
+    BoundingBox MergeBoundingBoxes(_In_reads_(uNumBoxes) const BoundingBox* aBoxes, _In_ UINT uNumBoxes);
+
+    FLOAT ComputeScreenSize(_In_ const BoundingSphere& sphere, _In_ const XMVECTOR& eye, _In_ FLOAT projectionScale);
+}
@@ -7,6 +7,8 @@ namespace library
 #define NUM_LIGHTS (2)
 #define MAX_NUM_BONES (256)
 #define MAX_NUM_BONES_PER_VERTEX (16)
+#define NUM_BONE_INFLUENCES (4)
+#define NUM_BLOCK_TYPES (15)
 
 	struct SimpleVertex
 	{
@@ -15,21 +17,54 @@ namespace library
 		XMFLOAT3 Normal;
 	};
 
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   InstanceData
+
+	  Summary:  Per instance data. BlockId selects the slice of the
+	            block texture arrays and the block color of a voxel
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
 	struct InstanceData
 	{
 		XMMATRIX Transformation;
+		UINT BlockId;
 	};
+	static_assert(NUM_BLOCK_TYPES == static_cast<INT>(eBlockType::COUNT) - static_cast<INT>(eBlockType::GRASSLAND), "Every block type needs a block id");
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   AnimationData
 
+	  Summary:  Packed skinning data of a vertex. Bone indices are
+	            stored as 8-bit integers (MAX_NUM_BONES fits in a byte)
+	            and the renormalized weights as 16-bit unorms
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
 	struct AnimationData
 	{
-		XMUINT4 aBoneIndices;
-		XMFLOAT4 aBoneWeights;
+		BYTE aBoneIndices[NUM_BONE_INFLUENCES];
+		USHORT aBoneWeights[NUM_BONE_INFLUENCES];
 	};
+	static_assert(MAX_NUM_BONES <= 256, "Bone indices are packed into 8 bits");
 	struct NormalData
 	{
 		XMFLOAT3 Tangent;
 		XMFLOAT3 Bitangent;
 	};
+
+	/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+	  Struct:   QuantizedVertex
+
+	  Summary:  Compressed replacement of SimpleVertex and NormalData.
+	            The position is a 16-bit unorm inside the bounds of the
+	            model, the texture coordinate is half precision and the
+	            tangent frame is an octahedral normal, a tangent angle
+	            around it and a bitangent sign in 10:10:10:2 unorm
+	S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+	struct QuantizedVertex
+	{
+		USHORT aPosition[4];
+		USHORT aTexCoord[2];
+		UINT uTangentFrame;
+	};
+	static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex has to match the input layout");
 	struct PointLightData
 	{
 		XMFLOAT4 Position;
@@ -51,13 +86,22 @@ namespace library
 	{
 		XMMATRIX World;
 		XMFLOAT4 OutputColor;
-		BOOL HasNormalMap;
 	};
 
 	struct CBSkinning
 	{
 		XMMATRIX BoneTransforms[MAX_NUM_BONES];
 	};
+
+	struct CBQuantization
+	{
+		XMFLOAT4 PositionOffset;
+		XMFLOAT4 PositionScale;
+	};
+	struct CBBlockMaterials
+	{
+		XMFLOAT4 BlockColors[NUM_BLOCK_TYPES];
+	};
 	struct CBLights
 	{
 		PointLightData PointLights[NUM_LIGHTS];
@@ -68,6 +112,5 @@ namespace library
 		XMMATRIX World;
 		XMMATRIX View;
 		XMMATRIX Projection;
-		BOOL IsVoxel;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Renderer/InstancedRenderable.h"
 
+#include "Shader/ShaderPermutation.h"
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -44,11 +46,12 @@ namespace library
       Args:     std::vector<InstanceData>&& aInstanceData
                   Instance data
 
-      Modifies: [m_aInstanceData].
+      Modifies: [m_aInstanceData, m_bWorldBoundsDirty].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void InstancedRenderable::SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData)
     {
         m_aInstanceData = aInstanceData;
+        m_bWorldBoundsDirty = TRUE;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -77,6 +80,59 @@ namespace library
         return m_aInstanceData.size();
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::GetInstanceData
+
+      Summary:  Returns the instance data
+
+      Returns:  const std::vector<InstanceData>&
+                  Instance data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<InstanceData>& InstancedRenderable::GetInstanceData() const
+    {
+        return m_aInstanceData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::GetShaderFeatures
+
+      Summary:  Returns the feature switches of the materials, and the
+                one reading the instance transform
+
+      Returns:  UINT
+                  SHADER_FEATURE_ bits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT InstancedRenderable::GetShaderFeatures() const
+    {
+        return Renderable::GetShaderFeatures() | SHADER_FEATURE_INSTANCED;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::updateWorldBounds
+
+      Summary:  Bounds every instance, placed by its transformation and
+                then the world matrix like the vertex shader does
+
+      Modifies: [m_worldBoundingBox, m_worldBoundingSphere].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedRenderable::updateWorldBounds()
+    {
+        if (m_aInstanceData.empty())
+        {
+            Renderable::updateWorldBounds();
+            return;
+        }
+
+        std::vector<BoundingBox> aBoxes(m_aInstanceData.size());
+        for (UINT i = 0u; i < m_aInstanceData.size(); ++i)
+        {
+            m_boundingBox.Transform(aBoxes[i], m_aInstanceData[i].Transformation * m_worldBoundsMatrix);
+        }
+
+        m_worldBoundingBox = MergeBoundingBoxes(aBoxes.data(), static_cast<UINT>(aBoxes.size()));
+        BoundingSphere::CreateFromBoundingBox(m_worldBoundingSphere, m_worldBoundingBox);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::initializeInstance
 
@@ -29,8 +29,14 @@ namespace library
                   Returns a instance buffer
                 GetNumInstances
                   Returns the number of instance data
+                GetInstanceData
+                  Returns the instance data
+                GetShaderFeatures
+                  Returns the feature switches, instancing included
                 initializeInstance
                   Initialize the instance buffer
+                updateWorldBounds
+                  Bounds all instances in world space
                 InstancedRenderable
                   Constructor.
                 ~InstancedRenderable
@@ -54,6 +60,9 @@ namespace library
 
         virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
         virtual UINT GetNumInstances() const;
+        const std::vector<InstanceData>& GetInstanceData() const;
+
+        UINT GetShaderFeatures() const override;
 
         UINT GetNumVertices() const override = 0;
         UINT GetNumIndices() const override = 0;
@@ -63,6 +72,7 @@ namespace library
         const WORD* getIndices() const override = 0;
 
         virtual HRESULT initializeInstance(_In_ ID3D11Device* pDevice);
+        void updateWorldBounds() override;
 
     protected:
         ComPtr<ID3D11Buffer> m_instanceBuffer;
@@ -4,7 +4,12 @@
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
 
+#include "Renderer/TangentSpace.h"
+#include "Shader/ShaderPermutation.h"
 #include "Texture/WICTextureLoader.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
 
 namespace library
 {
@@ -20,7 +25,10 @@ namespace library
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
                  m_normalBuffer, m_aMeshes, m_aMaterials, m_vertexShader,
                  m_pixelShader, m_outputColor, m_world, m_bHasNormalMap
-                 m_aNormalData].
+                 m_parentWorld, m_bHasParent, m_aNormalData,
+                 m_boundingBox, m_boundingSphere,
+                 m_bHasBounds, m_bWorldBoundsDirty, m_worldBoundsMatrix,
+                 m_worldBoundingBox, m_worldBoundingSphere].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderable::Renderable(_In_ const XMFLOAT4& outputColor) :
         m_vertexBuffer(nullptr),
@@ -34,14 +42,24 @@ namespace library
         m_outputColor(outputColor),
         m_padding(),
         m_world(XMMatrixIdentity()),
-        m_bHasNormalMap(false)
+        m_bHasNormalMap(false),
+        m_parentWorld(XMMatrixIdentity()),
+        m_bHasParent(FALSE),
+        m_boundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f)),
+        m_boundingSphere(XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f),
+        m_bHasBounds(FALSE),
+        m_bWorldBoundsDirty(TRUE),
+        m_worldBoundsMatrix(XMMatrixIdentity()),
+        m_worldBoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f)),
+        m_worldBoundingSphere(XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f)
     {}
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::initialize
 
-      Summary:  Initializes the buffers and the world matrix
+      Summary:  Initializes the buffers and the world matrix, and the
+                bounds unless the subclass computed them already
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
@@ -51,7 +69,8 @@ namespace library
                   File name of the texture to usen
 
       Modifies: [m_vertexBuffer, m_normalBuffer, m_indexBuffer
-                 m_constantBuffer].
+                 m_constantBuffer, m_aMeshes, m_boundingBox,
+                 m_boundingSphere, m_bHasBounds].
 
       Returns:  HRESULT
                   Status code
@@ -59,6 +78,11 @@ namespace library
     HRESULT Renderable::initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
         HRESULT hr = S_OK;
+        if (!m_bHasBounds)
+        {
+            initBounds();
+        }
+
         D3D11_BUFFER_DESC vertexBd = {
             .ByteWidth = sizeof(SimpleVertex) * GetNumVertices(),
             .Usage = D3D11_USAGE_DEFAULT,
@@ -77,7 +101,7 @@ namespace library
         if (FAILED(hr))
             return hr;
         D3D11_BUFFER_DESC indexBd = {
-            .ByteWidth = sizeof(WORD) * GetNumIndices(),
+            .ByteWidth = getIndexDataSize(),
             .Usage = D3D11_USAGE_DEFAULT,
             .BindFlags = D3D11_BIND_INDEX_BUFFER,
             .CPUAccessFlags = 0,
@@ -85,7 +109,7 @@ namespace library
             .StructureByteStride = 0
         };
         D3D11_SUBRESOURCE_DATA indexInitData = {
-            .pSysMem = getIndices(),
+            .pSysMem = getIndexData(),
             .SysMemPitch = 0,
             .SysMemSlicePitch = 0
         };
@@ -204,24 +228,24 @@ namespace library
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Renderable::GetVertexShader
-     Summary:  Returns the vertex shader
+     Summary:  Returns the vertex shader variant of the features
      Returns:  ComPtr<ID3D11VertexShader>&
                  Vertex shader. Could be a nullptr
    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     ComPtr<ID3D11VertexShader>& Renderable::GetVertexShader()
     {
-        return m_vertexShader->GetVertexShader();
+        return m_vertexShader->GetVertexShader(GetShaderFeatures());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetPixelShader
-      Summary:  Returns the vertex shader
+      Summary:  Returns the pixel shader variant of the features
       Returns:  ComPtr<ID3D11PixelShader>&
                   Pixel shader. Could be a nullptr
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     ComPtr<ID3D11PixelShader>& Renderable::GetPixelShader()
     {
-        return m_pixelShader->GetPixelShader();
+        return m_pixelShader->GetPixelShader(GetShaderFeatures());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -283,15 +307,55 @@ namespace library
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetWorldMatrix
-      Summary:  Returns the world matrix
-      Returns:  const XMMATRIX&
+      Summary:  Returns the world matrix. The transform methods and
+                subclasses write m_world, which is relative to the
+                parent once the object is attached to one
+      Returns:  XMMATRIX
                   World matrix
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const XMMATRIX& Renderable::GetWorldMatrix() const
+    XMMATRIX Renderable::GetWorldMatrix() const
+    {
+        return m_bHasParent ? XMMatrixMultiply(m_world, m_parentWorld) : m_world;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetLocalMatrix
+      Summary:  Returns the matrix the transform methods modify, the
+                world matrix unless the object is attached to a parent
+      Returns:  const XMMATRIX&
+                  Local matrix
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMMATRIX& Renderable::GetLocalMatrix() const
     {
         return m_world;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetParentWorldMatrix
+      Summary:  Attaches the object to a parent, its local matrix is
+                then placed by the parent's world matrix
+      Args:     FXMMATRIX parentWorld
+                  World matrix of the parent
+      Modifies: [m_parentWorld, m_bHasParent].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetParentWorldMatrix(_In_ FXMMATRIX parentWorld)
+    {
+        m_parentWorld = parentWorld;
+        m_bHasParent = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::ClearParentWorldMatrix
+      Summary:  Detaches the object from its parent, the local matrix
+                becomes the world matrix again
+      Modifies: [m_parentWorld, m_bHasParent].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::ClearParentWorldMatrix()
+    {
+        m_parentWorld = XMMatrixIdentity();
+        m_bHasParent = FALSE;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetOutputColor
       Summary:  Returns the output color
@@ -462,100 +526,226 @@ namespace library
     {
         return m_bHasNormalMap;
     }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderable::calculateNormalMapVectors
+      Method:   Renderable::GetShaderFeatures
 
-      Summary:  Calculate tangent and bitangent vectors of every vertex
+      Summary:  Returns the feature switches the materials and meshes
+                need. The shaders select their variant from the ones
+                they declare
 
-      Modifies: [m_aNormalData].
+      Returns:  UINT
+                  SHADER_FEATURE_ bits
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Renderable::calculateNormalMapVectors()
+    UINT Renderable::GetShaderFeatures() const
     {
-        UINT uNumFaces = GetNumIndices() / 3;
-        const SimpleVertex* aVertices = getVertices();
-        const WORD* aIndices = getIndices();
-        m_aNormalData.resize(GetNumVertices(), NormalData());
-        XMFLOAT3 tangent = XMFLOAT3(0.f,0.f,0.f);
-        XMFLOAT3 bitangent= XMFLOAT3(0.f, 0.f, 0.f);
-        for (UINT i = 0; i < uNumFaces; ++i)
+        return m_bHasNormalMap ? SHADER_FEATURE_NORMAL_MAP : 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::RequestShaderVariants
+
+      Summary:  Requests the variants of the shaders drawing the
+                object, so they are compiled when the shaders are. Has
+                to be called once the materials are known
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::RequestShaderVariants()
+    {
+        if (m_vertexShader)
+        {
+            m_vertexShader->RequestVariant(GetShaderFeatures());
+        }
+        if (m_pixelShader)
         {
-            calculateTangentBitangent(aVertices[aIndices[i * 3]], aVertices[aIndices[i * 3
-                + 1]], aVertices[aIndices[i * 3 + 2]], tangent, bitangent);
-            m_aNormalData[aIndices[i * 3]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3]].Bitangent = bitangent;
-            m_aNormalData[aIndices[i * 3 + 1]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3 + 1]].Bitangent = bitangent;
-            m_aNormalData[aIndices[i * 3 + 2]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3 + 2]].Bitangent = bitangent;
+            m_pixelShader->RequestVariant(GetShaderFeatures());
         }
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::UsesShader
+
+      Summary:  Returns whether the object is drawn with a shader
+
+      Args:     const Shader* pShader
+                  Shader to look for
+
+      Returns:  BOOL
+                  TRUE if it is the vertex or the pixel shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderable::UsesShader(_In_ const Shader* pShader) const
+    {
+        return m_vertexShader.get() == pShader || m_pixelShader.get() == pShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetBoundingBox
+      Summary:  Returns the object space box of all meshes
+      Returns:  const BoundingBox&
+                  Bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& Renderable::GetBoundingBox() const
+    {
+        return m_boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetBoundingSphere
+      Summary:  Returns the object space sphere of all meshes
+      Returns:  const BoundingSphere&
+                  Bounding sphere
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingSphere& Renderable::GetBoundingSphere() const
+    {
+        return m_boundingSphere;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetWorldBoundingBox
+      Summary:  Returns the world space box. Subclasses may write
+                m_world directly and parents move, so the matrix the
+                bounds were computed with is compared instead of
+                tracking setters
+      Modifies: [m_bWorldBoundsDirty, m_worldBoundsMatrix,
+                 m_worldBoundingBox, m_worldBoundingSphere].
+      Returns:  const BoundingBox&
+                  Bounding box in world space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& Renderable::GetWorldBoundingBox()
+    {
+        XMMATRIX world = GetWorldMatrix();
+        BOOL bWorldChanged = FALSE;
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            bWorldChanged |= !XMVector4Equal(world.r[i], m_worldBoundsMatrix.r[i]);
+        }
+
+        if (m_bWorldBoundsDirty || bWorldChanged)
+        {
+            m_worldBoundsMatrix = world;
+            updateWorldBounds();
+            m_bWorldBoundsDirty = FALSE;
+        }
+
+        return m_worldBoundingBox;
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderable::calculateTangentBitangent
+      Method:   Renderable::GetWorldBoundingSphere
+      Summary:  Returns the world space sphere, see GetWorldBoundingBox
+      Modifies: [m_bWorldBoundsDirty, m_worldBoundsMatrix,
+                 m_worldBoundingBox, m_worldBoundingSphere].
+      Returns:  const BoundingSphere&
+                  Bounding sphere in world space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingSphere& Renderable::GetWorldBoundingSphere()
+    {
+        GetWorldBoundingBox();
 
-      Summary:  Calculate tangent/bitangent vectors of the given face
+        return m_worldBoundingSphere;
+    }
 
-      Args:     SimpleVertex& v1
-                  The first vertex of the face
-                SimpleVertex& v2
-                  The second vertex of the face
-                SimpleVertex& v3
-                  The third vertex of the face
-                XMFLOAT3& tangent
-                  Calculated tangent vector
-                XMFLOAT3& bitangent
-                  Calculated bitangent vector
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::initBounds
+      Summary:  Computes the box and sphere of every mesh and of the
+                whole renderable. A mesh is bounded by the vertex range
+                its indices span, which is exact for meshes stored one
+                after another
+      Modifies: [m_aMeshes, m_boundingBox, m_boundingSphere,
+                 m_bHasBounds, m_bWorldBoundsDirty].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Renderable::calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent)
+    void Renderable::initBounds()
     {
-        XMFLOAT3 vector1 = XMFLOAT3(0.f, 0.f, 0.f);
-        XMFLOAT3 vector2 = XMFLOAT3(0.f,0.f,0.f);
-        XMFLOAT2 tuVector = XMFLOAT2(0.f, 0.f);
-        XMFLOAT2 tvVector = XMFLOAT2(0.f,0.f);
+        const SimpleVertex* aVertices = getVertices();
+        const BYTE* pIndexData = reinterpret_cast<const BYTE*>(getIndexData());
+        const UINT uStride = static_cast<UINT>(sizeof(SimpleVertex));
+
+        std::vector<BoundingBox> aBoxes;
+        aBoxes.reserve(m_aMeshes.size());
+        for (BasicMeshEntry& mesh : m_aMeshes)
+        {
+            if (mesh.uNumIndices == 0u)
+            {
+                continue;
+            }
+
+            UINT uMinIndex = ~0u;
+            UINT uMaxIndex = 0u;
+            for (UINT i = 0u; i < mesh.uNumIndices; ++i)
+            {
+                UINT uIndex = mesh.IndexFormat == DXGI_FORMAT_R32_UINT ?
+                    reinterpret_cast<const UINT*>(pIndexData + mesh.uIndexOffset)[mesh.uBaseIndex + i] :
+                    reinterpret_cast<const WORD*>(pIndexData + mesh.uIndexOffset)[mesh.uBaseIndex + i];
+                uMinIndex = std::min(uMinIndex, uIndex);
+                uMaxIndex = std::max(uMaxIndex, uIndex);
+            }
+
+            const XMFLOAT3* aPositions = &aVertices[mesh.uBaseVertex + uMinIndex].Position;
+            UINT uNumPositions = uMaxIndex - uMinIndex + 1u;
+            mesh.Box = ComputeBoundingBox(aPositions, uStride, uNumPositions);
+            mesh.Sphere = ComputeBoundingSphere(aPositions, uStride, uNumPositions, mesh.Box.Center);
+            aBoxes.push_back(mesh.Box);
+        }
 
-        // Calculate the two vectors for this face.
-        vector1.x = v2.Position.x - v1.Position.x;
-        vector1.y = v2.Position.y - v1.Position.y;
-        vector1.z = v2.Position.z - v1.Position.z;
+        const XMFLOAT3* aAllPositions = aVertices ? &aVertices[0].Position : nullptr;
+        UINT uNumVertices = aVertices ? GetNumVertices() : 0u;
+        m_boundingBox = aBoxes.empty() ?
+            ComputeBoundingBox(aAllPositions, uStride, uNumVertices) :
+            MergeBoundingBoxes(aBoxes.data(), static_cast<UINT>(aBoxes.size()));
+        m_boundingSphere = ComputeBoundingSphere(aAllPositions, uStride, uNumVertices, m_boundingBox.Center);
 
-        vector2.x = v3.Position.x - v1.Position.x;
-        vector2.y = v3.Position.y - v1.Position.y;
-        vector2.z = v3.Position.z - v1.Position.z;
+        m_bHasBounds = TRUE;
+        m_bWorldBoundsDirty = TRUE;
+    }
 
-        // Calculate the tu and tv texture space vectors.
-        tuVector.x = v2.TexCoord.x - v1.TexCoord.x;
-        tvVector.x = v2.TexCoord.y - v1.TexCoord.y;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::updateWorldBounds
+      Summary:  Transforms the object space bounds by the world matrix
+                they are computed for
+      Modifies: [m_worldBoundingBox, m_worldBoundingSphere].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::updateWorldBounds()
+    {
+        m_boundingBox.Transform(m_worldBoundingBox, m_worldBoundsMatrix);
+        m_boundingSphere.Transform(m_worldBoundingSphere, m_worldBoundsMatrix);
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::getIndexData
 
-        tuVector.y = v3.TexCoord.x - v1.TexCoord.x;
-        tvVector.y = v3.TexCoord.y - v1.TexCoord.y;
+      Summary:  Returns the contents of the index buffer. Renderables
+                using only 16-bit indices keep this default
 
-        // Calculate the denominator of the tangent/binormal equation.
-        float den = 1.0f / (tuVector.x * tvVector.y - tuVector.y * tvVector.x);
+      Returns:  const void*
+                  Index buffer data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* Renderable::getIndexData() const
+    {
+        return getIndices();
+    }
 
-        // Calculate the cross products and multiply by the coefficient to get the tangent and binormal.
-        tangent.x = (tvVector.y * vector1.x - tvVector.x * vector2.x) * den;
-        tangent.y = (tvVector.y * vector1.y - tvVector.x * vector2.y) * den;
-        tangent.z = (tvVector.y * vector1.z - tvVector.x * vector2.z) * den;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::getIndexDataSize
 
-        bitangent.x = (tuVector.x * vector2.x - tuVector.y * vector1.x) * den;
-        bitangent.y = (tuVector.x * vector2.y - tuVector.y * vector1.y) * den;
-        bitangent.z = (tuVector.x * vector2.z - tuVector.y * vector1.z) * den;
+      Summary:  Returns the size of the index buffer
 
-        // Calculate the length of this normal.
-        float length = sqrt((tangent.x * tangent.x) + (tangent.y * tangent.y) + (tangent.z * tangent.z));
+      Returns:  UINT
+                  Size of the index buffer in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::getIndexDataSize() const
+    {
+        return static_cast<UINT>(sizeof(WORD)) * GetNumIndices();
+    }
 
-        // Normalize the normal and then store it
-        tangent.x = tangent.x / length;
-        tangent.y = tangent.y / length;
-        tangent.z = tangent.z / length;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::calculateNormalMapVectors
 
-        // Calculate the length of this normal.
-        length = sqrt((bitangent.x * bitangent.x) + (bitangent.y * bitangent.y) + (bitangent.z * bitangent.z));
+      Summary:  Calculate tangent and bitangent vectors of every vertex
+                by accumulating the faces around it on the thread pool
 
-        // Normalize the normal and then store it
-        bitangent.x = bitangent.x / length;
-        bitangent.y = bitangent.y / length;
-        bitangent.z = bitangent.z / length;
+      Modifies: [m_aNormalData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::calculateNormalMapVectors()
+    {
+        m_aNormalData.resize(GetNumVertices(), NormalData());
+        CalculateTangentFrames(getVertices(), GetNumVertices(), getIndices(), GetNumIndices(), m_aNormalData.data(), &ThreadPool::GetDefault());
     }
 }
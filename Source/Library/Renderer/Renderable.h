@@ -13,6 +13,7 @@
 
 #include "Common.h"
 
+#include "Renderer/Bounds.h"
 #include "Renderer/DataTypes.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
@@ -38,13 +39,37 @@ namespace library
                 GetConstantBuffer
                   Returns the constant buffer
                 GetWorldMatrix
-                  Returns the world matrix
+                  Returns the world matrix, the local one placed by
+                  the parent when the object is attached to one
+                GetLocalMatrix
+                  Returns the matrix set by the transform methods
+                SetParentWorldMatrix
+                  Places the object under a parent's world matrix
+                ClearParentWorldMatrix
+                  Detaches the object from its parent
                 GetNumVertices
                   Pure virtual function that returns the number of
                   vertices
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetBoundingBox
+                  Returns the object space box of all meshes
+                GetBoundingSphere
+                  Returns the object space sphere of all meshes
+                GetWorldBoundingBox
+                  Returns the box in world space, recomputed after
+                  the world matrix changed
+                GetWorldBoundingSphere
+                  Returns the sphere in world space, recomputed after
+                  the world matrix changed
+                GetShaderFeatures
+                  Returns the feature switches the object is drawn
+                  with
+                RequestShaderVariants
+                  Requests the shader variants of the features
+                UsesShader
+                  Returns whether the object is drawn with a shader
                 Renderable
                   Constructor.
                 ~Renderable
@@ -54,8 +79,35 @@ namespace library
     {
     public:
         static constexpr const UINT INVALID_MATERIAL = (0xFFFFFFFF);
+        static constexpr const UINT MAX_MESH_LODS = 3u;
 
     protected:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   IndexRange
+
+          Summary:  Index range in the same index region as a mesh,
+                    e.g. a simplified level of detail of it or a run of
+                    its meshlets
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct IndexRange
+        {
+            UINT uNumIndices;
+            UINT uBaseIndex;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   BasicMeshEntry
+
+          Summary:  Draw range of a mesh. The index buffer may hold 16-bit
+                    and 32-bit regions, IndexFormat and uIndexOffset (in
+                    bytes) select the region the mesh is bound with and
+                    uBaseIndex counts indices from the start of it.
+                    LOD 0 is the full mesh, LOD i > 0 is drawn with
+                    aLods[i - 1]. The meshlets of LOD 0 are
+                    uNumMeshlets entries from uBaseMeshlet of the
+                    owner's meshlet array. Box and Sphere bound the
+                    mesh in object space
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
         struct BasicMeshEntry
         {
             BasicMeshEntry()
@@ -63,13 +115,35 @@ namespace library
                 , uBaseVertex(0u)
                 , uBaseIndex(0u)
                 , uMaterialIndex(INVALID_MATERIAL)
+                , IndexFormat(DXGI_FORMAT_R16_UINT)
+                , uIndexOffset(0u)
+                , uNumLods(0u)
+                , aLods{}
+                , uBaseMeshlet(0u)
+                , uNumMeshlets(0u)
+                , Box(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f))
+                , Sphere(XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f)
             {
             }
 
+            IndexRange GetLodRange(_In_ UINT uLod) const
+            {
+                uLod = uLod < uNumLods ? uLod : uNumLods;
+                return uLod == 0u ? IndexRange{ uNumIndices, uBaseIndex } : aLods[uLod - 1u];
+            }
+
             UINT uNumIndices;
             UINT uBaseVertex;
             UINT uBaseIndex;
             UINT uMaterialIndex;
+            DXGI_FORMAT IndexFormat;
+            UINT uIndexOffset;
+            UINT uNumLods;
+            IndexRange aLods[MAX_MESH_LODS];
+            UINT uBaseMeshlet;
+            UINT uNumMeshlets;
+            BoundingBox Box;
+            BoundingSphere Sphere;
         };
 
     public:
@@ -97,7 +171,10 @@ namespace library
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
         ComPtr<ID3D11Buffer>& GetNormalBuffer();
 
-        const XMMATRIX& GetWorldMatrix() const;
+        XMMATRIX GetWorldMatrix() const;
+        const XMMATRIX& GetLocalMatrix() const;
+        void SetParentWorldMatrix(_In_ FXMMATRIX parentWorld);
+        void ClearParentWorldMatrix();
         const XMFLOAT4& GetOutputColor() const;
         BOOL HasTexture() const;
         const std::shared_ptr<Material>& GetMaterial(UINT uIndex) const;
@@ -117,16 +194,29 @@ namespace library
         UINT GetNumMaterials() const;
         BOOL HasNormalMap() const;
 
+        virtual UINT GetShaderFeatures() const;
+        void RequestShaderVariants();
+        BOOL UsesShader(_In_ const Shader* pShader) const;
+
+        const BoundingBox& GetBoundingBox() const;
+        const BoundingSphere& GetBoundingSphere() const;
+        const BoundingBox& GetWorldBoundingBox();
+        const BoundingSphere& GetWorldBoundingSphere();
+
     protected:
         const virtual SimpleVertex* getVertices() const = 0;
         virtual const WORD* getIndices() const = 0;
+        virtual const void* getIndexData() const;
+        virtual UINT getIndexDataSize() const;
         virtual HRESULT initialize(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext
         );
 
+        void initBounds();
+        virtual void updateWorldBounds();
+
         void calculateNormalMapVectors();
-        void calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent);
 
     protected:
         ComPtr<ID3D11Buffer> m_vertexBuffer;
@@ -145,5 +235,15 @@ namespace library
         BYTE m_padding[8];
         XMMATRIX m_world;
         BOOL m_bHasNormalMap;
+        XMMATRIX m_parentWorld;
+        BOOL m_bHasParent;
+
+        BoundingBox m_boundingBox;
+        BoundingSphere m_boundingSphere;
+        BOOL m_bHasBounds;
+        BOOL m_bWorldBoundsDirty;
+        XMMATRIX m_worldBoundsMatrix;
+        BoundingBox m_worldBoundingBox;
+        BoundingSphere m_worldBoundingSphere;
     };
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "Renderer/Renderer.h"
 
+#include "Texture/TextureResidency.h"
+#include "Texture/TextureStreamer.h"
+
 namespace library
 {
 
@@ -408,7 +411,8 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Update
-      Summary:  Update the renderables each frame
+      Summary:  Update the renderables each frame, and swap in the
+                textures streamed since the last frame
       Args:     FLOAT deltaTime
                   Time difference of a frame
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -417,6 +421,9 @@ namespace library
         m_scenes[m_pszMainSceneName]->Update(deltaTime);
 
         m_camera.Update(deltaTime);
+
+        TextureStreamer::GetDefault().Update(m_d3dDevice.Get());
+        TextureResidency::GetDefault().Update(m_immediateContext.Get());
     }
 
 
@@ -435,6 +442,7 @@ namespace library
 
         XMFLOAT4 cameraPosition = XMFLOAT4();
         XMStoreFloat4(&cameraPosition, m_camera.GetEye());
+        FLOAT projectionScale = XMVectorGetY(m_projection.r[1]);
         CBChangeOnCameraMovement cbChangeOnCamera = {
                .View = XMMatrixTranspose(m_camera.GetView()),
                .CameraPosition = cameraPosition
@@ -482,13 +490,14 @@ namespace library
                 ComPtr<ID3D11Buffer> vertexNormalBuffers[2] = { iRenderable->second->GetVertexBuffer(), iRenderable->second->GetNormalBuffer() };
                 m_immediateContext->IASetVertexBuffers(0, 2, vertexNormalBuffers->GetAddressOf(), strides, offsets);
                 m_immediateContext->IASetIndexBuffer(iRenderable->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+                DXGI_FORMAT boundIndexFormat = DXGI_FORMAT_R16_UINT;
+                UINT uBoundIndexOffset = 0u;
                 m_immediateContext->IASetInputLayout(iRenderable->second->GetVertexLayout().Get());
                
                 
                 CBChangesEveryFrame cb = {
                     .World = XMMatrixTranspose(iRenderable->second->GetWorldMatrix()),
-                    .OutputColor = iRenderable->second->GetOutputColor(),
-                    .HasNormalMap = iRenderable->second->HasNormalMap()
+                    .OutputColor = iRenderable->second->GetOutputColor()
                 };
                 m_immediateContext->UpdateSubresource(
                     iRenderable->second->GetConstantBuffer().Get(),
@@ -514,6 +523,8 @@ namespace library
                 std::shared_ptr<Skybox> skybox = iScene->second->GetSkyBox();
                 if (skybox)
                 {
+                    // The sky covers the whole screen
+                    skybox->GetSkyboxTexture()->RequestDetail(1.0f);
                     eTextureSamplerType textureSamplerType = skybox->GetSkyboxTexture()->GetSamplerType();
                     m_immediateContext->PSSetShaderResources(2, 1, skybox->GetSkyboxTexture()->GetTextureResourceView().GetAddressOf());
                     m_immediateContext->PSSetSamplers(2, 1, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
@@ -522,18 +533,27 @@ namespace library
 
                 if (iRenderable->second->HasTexture())
                 {
+                    FLOAT screenSize = ComputeScreenSize(iRenderable->second->GetWorldBoundingSphere(), m_camera.GetEye(), projectionScale);
                     for (UINT i = 0; i < iRenderable->second->GetNumMeshes(); i++)
                     {
                         UINT materialIndex = iRenderable->second->GetMesh(i).uMaterialIndex;
+                        iRenderable->second->GetMaterial(materialIndex)->pDiffuse->RequestDetail(screenSize);
                         eTextureSamplerType textureSamplerType = iRenderable->second->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
                         m_immediateContext->PSSetShaderResources(0, 1, iRenderable->second->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
                         m_immediateContext->PSSetSamplers(0, 1, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                         if (iRenderable->second->HasNormalMap())
                         {
+                            iRenderable->second->GetMaterial(materialIndex)->pNormal->RequestDetail(screenSize);
                             textureSamplerType = iRenderable->second->GetMaterial(materialIndex)->pNormal->GetSamplerType();
                             m_immediateContext->PSSetShaderResources(1, 1, iRenderable->second->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
                             m_immediateContext->PSSetSamplers(1, 1, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                         }
+                        if (iRenderable->second->GetMesh(i).IndexFormat != boundIndexFormat || iRenderable->second->GetMesh(i).uIndexOffset != uBoundIndexOffset)
+                        {
+                            boundIndexFormat = iRenderable->second->GetMesh(i).IndexFormat;
+                            uBoundIndexOffset = iRenderable->second->GetMesh(i).uIndexOffset;
+                            m_immediateContext->IASetIndexBuffer(iRenderable->second->GetIndexBuffer().Get(), boundIndexFormat, uBoundIndexOffset);
+                        }
                         m_immediateContext->DrawIndexed(iRenderable->second->GetMesh(i).uNumIndices, iRenderable->second->GetMesh(i).uBaseIndex, iRenderable->second->GetMesh(i).uBaseVertex);
                     }
                 }
@@ -543,7 +563,21 @@ namespace library
                 }
 
             }
-            std::vector<std::shared_ptr<Voxel>> voxels = iScene->second->GetVoxels();
+            // Every block type is a slice of the same arrays, so they are
+            // bound once and each voxel is a single instanced draw
+            BlockMaterialTextures& blockMaterials = iScene->second->GetBlockMaterialTextures();
+            ComPtr<ID3D11ShaderResourceView> blockTextureArrays[2] = { blockMaterials.GetDiffuseTextureArray(), blockMaterials.GetNormalTextureArray() };
+            ComPtr<ID3D11SamplerState> blockSamplerStates[2] = {
+                Texture::s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)],
+                Texture::s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)]
+            };
+            std::vector<std::shared_ptr<Voxel>>& voxels = iScene->second->GetVoxels();
+            if (!voxels.empty())
+            {
+                m_immediateContext->PSSetShaderResources(0, 2, blockTextureArrays->GetAddressOf());
+                m_immediateContext->PSSetSamplers(0, 2, blockSamplerStates->GetAddressOf());
+                m_immediateContext->PSSetConstantBuffers(4, 1, blockMaterials.GetConstantBuffer().GetAddressOf());
+            }
             for (UINT i = 0u; i < voxels.size(); i++)
             {
                 UINT strides[3] = { static_cast<UINT>(sizeof(SimpleVertex)), static_cast<UINT>(sizeof(NormalData)), static_cast<UINT>(sizeof(InstanceData)) };
@@ -560,8 +594,7 @@ namespace library
                 m_immediateContext->IASetInputLayout(voxels[i]->GetVertexLayout().Get());
                 CBChangesEveryFrame cb = {
                     .World = XMMatrixTranspose(voxels[i]->GetWorldMatrix()),
-                    .OutputColor = voxels[i]->GetOutputColor(),
-                    .HasNormalMap = voxels[i]->HasNormalMap()
+                    .OutputColor = voxels[i]->GetOutputColor()
                 };
                 m_immediateContext->UpdateSubresource(
                     voxels[i]->GetConstantBuffer().Get(),
@@ -580,40 +613,38 @@ namespace library
                 m_immediateContext->PSSetConstantBuffers(2, 1, voxels[i]->GetConstantBuffer().GetAddressOf());
                 m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
                 m_immediateContext->PSSetShader(voxels[i]->GetPixelShader().Get(), nullptr, 0);
+                m_immediateContext->DrawIndexedInstanced(voxels[i]->GetNumIndices(), voxels[i]->GetNumInstances(), 0, 0, 0);
+            }
 
-                if (voxels[i]->HasTexture())
-                {
-                    ComPtr<ID3D11ShaderResourceView> shaderResources[2] = { voxels[i]->GetMaterial(0)->pDiffuse->GetTextureResourceView(),
-                                                    voxels[i]->GetMaterial(0)->pNormal->GetTextureResourceView() };
-                    ComPtr<ID3D11SamplerState> samplerStates[2] = { nullptr,nullptr};
-                    eTextureSamplerType textureSamplerType = voxels[i]->GetMaterial(0)->pDiffuse->GetSamplerType();
-                    samplerStates[0] = Texture::s_samplers[static_cast<size_t>(textureSamplerType)];
-                    textureSamplerType = voxels[i]->GetMaterial(0)->pNormal->GetSamplerType();
-                    samplerStates[1] = Texture::s_samplers[static_cast<size_t>(textureSamplerType)];
-                    m_immediateContext->PSSetShaderResources(0, 2, shaderResources->GetAddressOf());
-                    m_immediateContext->PSSetSamplers(0, 2, samplerStates->GetAddressOf());
-                    m_immediateContext->DrawIndexedInstanced(voxels[i]->GetNumIndices(), voxels[i]->GetNumInstances(), 0, 0, 0);
+            XMMATRIX viewProjection = m_camera.GetView() * m_projection;
+            for (auto iModel = iScene->second->GetModels().begin(); iModel != iScene->second->GetModels().end(); iModel++)
+            {
+                iModel->second->SelectLod(m_camera.GetEye(), projectionScale);
+                iModel->second->CullMeshlets(viewProjection, m_camera.GetEye());
 
+                if (iModel->second->HasQuantizedVertices())
+                {
+                    // A single QuantizedVertex stream replaces the vertex and normal streams
+                    UINT uStride = static_cast<UINT>(sizeof(QuantizedVertex));
+                    UINT uOffset = 0u;
+                    m_immediateContext->IASetVertexBuffers(0, 1, iModel->second->GetQuantizedVertexBuffer().GetAddressOf(), &uStride, &uOffset);
+                    m_immediateContext->VSSetConstantBuffers(5, 1, iModel->second->GetQuantizationConstantBuffer().GetAddressOf());
                 }
                 else
                 {
-                    m_immediateContext->DrawIndexedInstanced(voxels[i]->GetNumIndices(), voxels[i]->GetNumInstances(), 0, 0, 0);
-                }
-            }
+                    UINT aStrides[2] = { static_cast<UINT>(sizeof(SimpleVertex)), static_cast<UINT>(sizeof(NormalData)) };
+                    UINT aOffsets[2] = { 0u, 0u };
+                    ComPtr<ID3D11Buffer> aBuffers[2] = { iModel->second->GetVertexBuffer(),iModel->second->GetNormalBuffer() };
 
-            for (auto iModel = iScene->second->GetModels().begin(); iModel != iScene->second->GetModels().end(); iModel++)
-            {
-                UINT aStrides[2] = { static_cast<UINT>(sizeof(SimpleVertex)), static_cast<UINT>(sizeof(NormalData)) };
-                UINT aOffsets[2] = { 0u, 0u };
-                ComPtr<ID3D11Buffer> aBuffers[2] = { iModel->second->GetVertexBuffer(),iModel->second->GetNormalBuffer() };
-
-                m_immediateContext->IASetVertexBuffers(0, 2, aBuffers->GetAddressOf(), aStrides, aOffsets);
+                    m_immediateContext->IASetVertexBuffers(0, 2, aBuffers->GetAddressOf(), aStrides, aOffsets);
+                }
                 m_immediateContext->IASetIndexBuffer(iModel->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+                DXGI_FORMAT boundIndexFormat = DXGI_FORMAT_R16_UINT;
+                UINT uBoundIndexOffset = 0u;
                 m_immediateContext->IASetInputLayout(iModel->second->GetVertexLayout().Get());
                 CBChangesEveryFrame cbChangeEveryFrame = {
                     .World = XMMatrixTranspose(iModel->second->GetWorldMatrix()),
-                    .OutputColor = iModel->second->GetOutputColor(),
-                    .HasNormalMap = iModel->second->HasNormalMap()
+                    .OutputColor = iModel->second->GetOutputColor()
                 };
                 m_immediateContext->UpdateSubresource(
                     iModel->second->GetConstantBuffer().Get(),
@@ -652,27 +683,56 @@ namespace library
 
                 if (iModel->second->HasTexture())
                 {
+                    FLOAT screenSize = ComputeScreenSize(iModel->second->GetWorldBoundingSphere(), m_camera.GetEye(), projectionScale);
                     for (UINT i = 0; i < iModel->second->GetNumMeshes(); i++)
                     {
                         UINT materialIndex = iModel->second->GetMesh(i).uMaterialIndex;
                         if (iModel->second->GetMaterial(materialIndex)->pDiffuse)
                         {
+                            iModel->second->GetMaterial(materialIndex)->pDiffuse->RequestDetail(screenSize);
                             eTextureSamplerType textureSamplerType = iModel->second->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
                             m_immediateContext->PSSetShaderResources(0, 1, iModel->second->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
                             m_immediateContext->PSSetSamplers(0, 1, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                         }
                         if (iModel->second->GetMaterial(materialIndex)->pNormal)
                         {
+                            iModel->second->GetMaterial(materialIndex)->pNormal->RequestDetail(screenSize);
                             eTextureSamplerType textureSamplerType = iModel->second->GetMaterial(materialIndex)->pNormal->GetSamplerType();
                             m_immediateContext->PSSetShaderResources(1, 1, iModel->second->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
                             m_immediateContext->PSSetSamplers(1, 1, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                         }
-                        m_immediateContext->DrawIndexed(iModel->second->GetMesh(i).uNumIndices, iModel->second->GetMesh(i).uBaseIndex, iModel->second->GetMesh(i).uBaseVertex);
+                        if (iModel->second->GetMesh(i).IndexFormat != boundIndexFormat || iModel->second->GetMesh(i).uIndexOffset != uBoundIndexOffset)
+                        {
+                            boundIndexFormat = iModel->second->GetMesh(i).IndexFormat;
+                            uBoundIndexOffset = iModel->second->GetMesh(i).uIndexOffset;
+                            m_immediateContext->IASetIndexBuffer(iModel->second->GetIndexBuffer().Get(), boundIndexFormat, uBoundIndexOffset);
+                        }
+                        UINT uNumRanges = 0u;
+                        auto aRanges = iModel->second->GetDrawRanges(i, uNumRanges);
+                        for (UINT j = 0u; j < uNumRanges; ++j)
+                        {
+                            m_immediateContext->DrawIndexed(aRanges[j].uNumIndices, aRanges[j].uBaseIndex, iModel->second->GetMesh(i).uBaseVertex);
+                        }
                     }
                 }
                 else
                 {
-                    m_immediateContext->DrawIndexed(iModel->second->GetNumIndices(), 0, 0);
+                    // The LODs and meshlet runs of a mesh are ranges of its own region, so every mesh is drawn on its own
+                    for (UINT i = 0; i < iModel->second->GetNumMeshes(); i++)
+                    {
+                        if (iModel->second->GetMesh(i).IndexFormat != boundIndexFormat || iModel->second->GetMesh(i).uIndexOffset != uBoundIndexOffset)
+                        {
+                            boundIndexFormat = iModel->second->GetMesh(i).IndexFormat;
+                            uBoundIndexOffset = iModel->second->GetMesh(i).uIndexOffset;
+                            m_immediateContext->IASetIndexBuffer(iModel->second->GetIndexBuffer().Get(), boundIndexFormat, uBoundIndexOffset);
+                        }
+                        UINT uNumRanges = 0u;
+                        auto aRanges = iModel->second->GetDrawRanges(i, uNumRanges);
+                        for (UINT j = 0u; j < uNumRanges; ++j)
+                        {
+                            m_immediateContext->DrawIndexed(aRanges[j].uNumIndices, aRanges[j].uBaseIndex, iModel->second->GetMesh(i).uBaseVertex);
+                        }
+                    }
                 }
             }
             //render sky box
@@ -685,6 +745,8 @@ namespace library
 
                 m_immediateContext->IASetVertexBuffers(0, 1, aBuffers->GetAddressOf(), aStrides, aOffsets);
                 m_immediateContext->IASetIndexBuffer(skybox->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+                DXGI_FORMAT boundIndexFormat = DXGI_FORMAT_R16_UINT;
+                UINT uBoundIndexOffset = 0u;
                 m_immediateContext->IASetInputLayout(skybox->GetVertexLayout().Get());
 
                 XMVECTOR scale;
@@ -697,8 +759,7 @@ namespace library
 
                 CBChangesEveryFrame cbChangeEveryFrame = {
                     .World = XMMatrixTranspose(skyboxTransform),
-                    .OutputColor = skybox->GetOutputColor(),
-                    .HasNormalMap = skybox->HasNormalMap()
+                    .OutputColor = skybox->GetOutputColor()
                 };
                 m_immediateContext->UpdateSubresource(
                     skybox->GetConstantBuffer().Get(),
@@ -726,6 +787,12 @@ namespace library
                         samplerStates[0] = Texture::s_samplers[static_cast<size_t>(textureSamplerType)];
                         m_immediateContext->PSSetShaderResources(0, 1, shaderResources->GetAddressOf());
                         m_immediateContext->PSSetSamplers(0, 1, samplerStates->GetAddressOf());
+                        if (skybox->GetMesh(i).IndexFormat != boundIndexFormat || skybox->GetMesh(i).uIndexOffset != uBoundIndexOffset)
+                        {
+                            boundIndexFormat = skybox->GetMesh(i).IndexFormat;
+                            uBoundIndexOffset = skybox->GetMesh(i).uIndexOffset;
+                            m_immediateContext->IASetIndexBuffer(skybox->GetIndexBuffer().Get(), boundIndexFormat, uBoundIndexOffset);
+                        }
                         m_immediateContext->DrawIndexed(skybox->GetMesh(i).uNumIndices, skybox->GetMesh(i).uBaseIndex, skybox->GetMesh(i).uBaseVertex);
                     }
                 }
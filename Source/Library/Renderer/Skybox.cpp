@@ -1,5 +1,7 @@
 #include "Renderer/Skybox.h"
 
+#include "Scene/AssetManager.h"
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -16,13 +18,19 @@ namespace library
                 FLOAT scale
                   Scaling factor
 
-      Modifies: [m_cubeMapFileName, m_scale].
+      Modifies: [m_cubeMapFileName, m_scale, m_bGenerateLods,
+                 m_bBuildMeshlets].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Skybox::Skybox(_In_ const std::filesystem::path& cubeMapFilePath, _In_ FLOAT scale) :
         Model(L"Content/Common/Sphere.obj"),
         m_cubeMapFileName(cubeMapFilePath),
         m_scale(scale)
-    {}
+    {
+        // The sky surrounds the camera, it is always drawn whole and at
+        // full detail
+        SetGenerateLods(FALSE);
+        SetBuildMeshlets(FALSE);
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Skybox::Initialize
@@ -45,7 +53,7 @@ namespace library
         }
         Scale(m_scale, m_scale, m_scale);
         m_aMeshes[0].uMaterialIndex = 0;
-        m_aMaterials[0]->pDiffuse = std::make_shared<Texture>(m_cubeMapFileName);
+        m_aMaterials[0]->pDiffuse = AssetManager::GetDefault().GetTexture(m_cubeMapFileName);
         hr = m_aMaterials[0]->pDiffuse->Initialize(pDevice,pImmediateContext);
         if (FAILED(hr))
         {
@@ -67,6 +75,21 @@ namespace library
         return m_aMaterials[0]->pDiffuse;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Skybox::getCookVariant
+
+      Summary:  Returns the name of the cook variant. The skybox reverses
+                the winding of its mesh, so it must not share the cooked
+                mesh of a Model loaded from the same file
+
+      Returns:  PCSTR
+                  Name of the variant
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCSTR Skybox::getCookVariant() const
+    {
+        return "skybox";
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Skybox::initSingleMesh
 
@@ -108,11 +131,11 @@ namespace library
         {
             const aiFace& face = pMesh->mFaces[i];
             assert(face.mNumIndices == 3u);
-            WORD aIndices[3] =
+            UINT aIndices[3] =
             {
-                static_cast<WORD>(face.mIndices[0]),
-                static_cast<WORD>(face.mIndices[1]),
-                static_cast<WORD>(face.mIndices[2]),
+                face.mIndices[0],
+                face.mIndices[1],
+                face.mIndices[2],
             };
             m_aIndices.push_back(aIndices[2]);
             m_aIndices.push_back(aIndices[1]);
@@ -33,6 +33,7 @@ namespace library
         const std::shared_ptr<Texture>& GetSkyboxTexture() const;
 
     protected:
+        virtual PCSTR getCookVariant() const override;
         virtual void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh) override;
 
     protected:
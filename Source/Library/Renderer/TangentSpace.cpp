@@ -0,0 +1,361 @@
+#include "Renderer/TangentSpace.h"
+
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT TANGENT_GRAIN_SIZE = 1024u;
+        constexpr const FLOAT TANGENT_EPSILON = 1e-12f;
+
+        struct FaceTangent
+        {
+            XMFLOAT3 Tangent;
+            XMFLOAT3 Bitangent;
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: approximateAcos
+
+          Summary:  Arc cosine by the cubic of Abramowitz and Stegun
+                    4.4.45, within 7e-5 radians. The corner angles only
+                    weight the tangents, so std::acos is not worth its
+                    cost here
+
+          Args:     FLOAT cosine
+                      Cosine in [-1, 1]
+
+          Returns:  FLOAT
+                      Angle in [0, pi]
+        -----------------------------------------------------------------F-F*/
+        FLOAT approximateAcos(_In_ FLOAT cosine)
+        {
+            FLOAT x = std::fabs(cosine);
+            FLOAT angle = std::sqrt(1.0f - x) * (1.5707288f + x * (-0.2121144f + x * (0.0742610f - 0.0187293f * x)));
+
+            return cosine >= 0.0f ? angle : XM_PI - angle;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: computeFace
+
+          Summary:  Computes the texture space directions of a face and
+                    the angle at each of its corners. Faces with
+                    degenerate texture coordinates get zero directions
+
+          Args:     const SimpleVertex* aVertices
+                      Vertices of the mesh
+                    const WORD* aIndices
+                      Indices of the mesh
+                    UINT uFace
+                      Face to compute
+                    FaceTangent& outFace
+                      Receives the normalized tangent and bitangent
+                    FLOAT* aOutCornerAngles
+                      Receives the angles of the three corners
+        -----------------------------------------------------------------F-F*/
+        void computeFace(
+            _In_ const SimpleVertex* aVertices,
+            _In_ const WORD* aIndices,
+            _In_ UINT uFace,
+            _Out_ FaceTangent& outFace,
+            _Out_writes_(3) FLOAT* aOutCornerAngles
+        )
+        {
+            const SimpleVertex& v0 = aVertices[aIndices[uFace * 3u]];
+            const SimpleVertex& v1 = aVertices[aIndices[uFace * 3u + 1u]];
+            const SimpleVertex& v2 = aVertices[aIndices[uFace * 3u + 2u]];
+
+            XMVECTOR aPositions[3] =
+            {
+                XMLoadFloat3(&v0.Position),
+                XMLoadFloat3(&v1.Position),
+                XMLoadFloat3(&v2.Position)
+            };
+
+            for (UINT k = 0u; k < 3u; ++k)
+            {
+                XMVECTOR edge1 = XMVectorSubtract(aPositions[(k + 1u) % 3u], aPositions[k]);
+                XMVECTOR edge2 = XMVectorSubtract(aPositions[(k + 2u) % 3u], aPositions[k]);
+                FLOAT lengthSquared = XMVectorGetX(XMVector3LengthSq(edge1)) * XMVectorGetX(XMVector3LengthSq(edge2));
+
+                aOutCornerAngles[k] = 0.0f;
+                if (lengthSquared > TANGENT_EPSILON)
+                {
+                    FLOAT cosine = XMVectorGetX(XMVector3Dot(edge1, edge2)) / std::sqrt(lengthSquared);
+                    aOutCornerAngles[k] = approximateAcos(std::clamp(cosine, -1.0f, 1.0f));
+                }
+            }
+
+            XMVECTOR edge1 = XMVectorSubtract(aPositions[1], aPositions[0]);
+            XMVECTOR edge2 = XMVectorSubtract(aPositions[2], aPositions[0]);
+            FLOAT du1 = v1.TexCoord.x - v0.TexCoord.x;
+            FLOAT dv1 = v1.TexCoord.y - v0.TexCoord.y;
+            FLOAT du2 = v2.TexCoord.x - v0.TexCoord.x;
+            FLOAT dv2 = v2.TexCoord.y - v0.TexCoord.y;
+            FLOAT determinant = du1 * dv2 - du2 * dv1;
+
+            if (std::fabs(determinant) < TANGENT_EPSILON)
+            {
+                outFace.Tangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
+                outFace.Bitangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
+                return;
+            }
+
+            // The sign of the determinant tells mirrored texture space apart
+            XMVECTOR inverse = XMVectorReplicate(1.0f / determinant);
+            XMStoreFloat3(&outFace.Tangent, XMVector3Normalize(XMVectorMultiply(XMVectorSubtract(XMVectorScale(edge1, dv2), XMVectorScale(edge2, dv1)), inverse)));
+            XMStoreFloat3(&outFace.Bitangent, XMVector3Normalize(XMVectorMultiply(XMVectorSubtract(XMVectorScale(edge2, du1), XMVectorScale(edge1, du2)), inverse)));
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: accumulateCorner
+
+          Summary:  Adds the directions of a face to a vertex. Like
+                    MikkTSpace, the tangent is projected onto the plane
+                    of the vertex normal, normalized and weighted by the
+                    corner angle, so the result does not depend on how
+                    finely the surface around the vertex is split. The
+                    bitangent only decides the handedness, so it is
+                    summed as is
+
+          Args:     FXMVECTOR normal
+                      Normalized normal of the vertex, zero if it has none
+                    const FaceTangent& face
+                      Directions of the face
+                    FLOAT cornerAngle
+                      Angle of the face at the vertex
+                    XMVECTOR& tangentSum
+                      Tangent accumulated so far
+                    XMVECTOR& bitangentSum
+                      Bitangent accumulated so far
+        -----------------------------------------------------------------F-F*/
+        void accumulateCorner(
+            _In_ FXMVECTOR normal,
+            _In_ const FaceTangent& face,
+            _In_ FLOAT cornerAngle,
+            _Inout_ XMVECTOR& tangentSum,
+            _Inout_ XMVECTOR& bitangentSum
+        )
+        {
+            XMVECTOR tangent = XMLoadFloat3(&face.Tangent);
+            tangent = XMVectorSubtract(tangent, XMVectorMultiply(normal, XMVector3Dot(normal, tangent)));
+
+            FLOAT lengthSquared = XMVectorGetX(XMVector3LengthSq(tangent));
+            if (lengthSquared > TANGENT_EPSILON)
+            {
+                tangentSum = XMVectorAdd(tangentSum, XMVectorScale(tangent, cornerAngle / std::sqrt(lengthSquared)));
+            }
+
+            bitangentSum = XMVectorAdd(bitangentSum, XMVectorScale(XMLoadFloat3(&face.Bitangent), cornerAngle));
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: finalizeFrame
+
+          Summary:  Gram-Schmidt orthonormalizes the accumulated tangent
+                    against the vertex normal. The bitangent is the cross
+                    product, flipped to agree with the accumulated one.
+                    Vertices without usable texture space get an
+                    arbitrary frame around the normal
+
+          Args:     FXMVECTOR normal
+                      Normalized normal of the vertex, zero if it has none
+                    FXMVECTOR tangentSum
+                      Accumulated tangent
+                    FXMVECTOR bitangentSum
+                      Accumulated bitangent
+                    NormalData& outNormalData
+                      Receives the frame
+        -----------------------------------------------------------------F-F*/
+        void finalizeFrame(
+            _In_ FXMVECTOR normal,
+            _In_ FXMVECTOR tangentSum,
+            _In_ FXMVECTOR bitangentSum,
+            _Out_ NormalData& outNormalData
+        )
+        {
+            if (XMVectorGetX(XMVector3LengthSq(normal)) == 0.0f)
+            {
+                // Nothing to orthonormalize against
+                XMStoreFloat3(&outNormalData.Tangent, XMVector3Normalize(tangentSum));
+                XMStoreFloat3(&outNormalData.Bitangent, XMVector3Normalize(bitangentSum));
+                return;
+            }
+
+            XMVECTOR tangent = XMVectorSubtract(tangentSum, XMVectorMultiply(normal, XMVector3Dot(normal, tangentSum)));
+            if (XMVectorGetX(XMVector3LengthSq(tangent)) <= TANGENT_EPSILON)
+            {
+                XMVECTOR axis = std::fabs(XMVectorGetX(normal)) < 0.9f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+                tangent = XMVector3Cross(axis, normal);
+            }
+            tangent = XMVector3Normalize(tangent);
+
+            XMVECTOR bitangent = XMVector3Cross(normal, tangent);
+            if (XMVectorGetX(XMVector3Dot(bitangent, bitangentSum)) < 0.0f)
+            {
+                bitangent = XMVectorNegate(bitangent);
+            }
+
+            XMStoreFloat3(&outNormalData.Tangent, tangent);
+            XMStoreFloat3(&outNormalData.Bitangent, bitangent);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CalculateTangentFrames
+
+      Summary:  Accumulates the texture space directions of every face
+                around each vertex and orthonormalizes them. Faces are
+                processed in parallel, then each vertex gathers its
+                corners through a vertex to corner adjacency, so no two
+                threads write the same vertex and no atomics are needed.
+                Gives the same result as CalculateTangentFramesReference
+
+      Args:     const SimpleVertex* aVertices
+                  Vertices of the mesh
+                UINT uNumVertices
+                  Number of vertices
+                const WORD* aIndices
+                  Triangle list indices
+                UINT uNumIndices
+                  Number of indices
+                NormalData* aOutNormalData
+                  Receives the frame of every vertex
+                ThreadPool* pThreadPool
+                  Pool to split the work on, runs on the calling thread
+                  if nullptr
+    -----------------------------------------------------------------F-F*/
+    void CalculateTangentFrames(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumIndices) const WORD* aIndices,
+        _In_ UINT uNumIndices,
+        _Out_writes_(uNumVertices) NormalData* aOutNormalData,
+        _In_opt_ ThreadPool* pThreadPool
+    )
+    {
+        UINT uNumFaces = uNumIndices / 3u;
+        UINT uNumCorners = uNumFaces * 3u;
+
+        std::vector<FaceTangent> aFaceTangents(uNumFaces);
+        std::vector<FLOAT> aCornerAngles(uNumCorners);
+        auto computeFaces = [aVertices, aIndices, &aFaceTangents, &aCornerAngles](UINT uBegin, UINT uEnd)
+        {
+            for (UINT i = uBegin; i < uEnd; ++i)
+            {
+                computeFace(aVertices, aIndices, i, aFaceTangents[i], &aCornerAngles[i * 3u]);
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumFaces, TANGENT_GRAIN_SIZE, computeFaces);
+        }
+        else
+        {
+            computeFaces(0u, uNumFaces);
+        }
+
+        // Corners of each vertex in index order, so every vertex sums
+        // its faces in the same order as the reference
+        std::vector<UINT> aCornerOffsets(uNumVertices + 1u, 0u);
+        for (UINT i = 0u; i < uNumCorners; ++i)
+        {
+            assert(aIndices[i] < uNumVertices);
+            ++aCornerOffsets[aIndices[i] + 1u];
+        }
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aCornerOffsets[i + 1u] += aCornerOffsets[i];
+        }
+
+        std::vector<UINT> aCorners(uNumCorners);
+        std::vector<UINT> aNextCorner(aCornerOffsets.begin(), aCornerOffsets.end() - 1);
+        for (UINT i = 0u; i < uNumCorners; ++i)
+        {
+            aCorners[aNextCorner[aIndices[i]]++] = i;
+        }
+
+        auto gatherVertices = [aVertices, aOutNormalData, &aFaceTangents, &aCornerAngles, &aCornerOffsets, &aCorners](UINT uBegin, UINT uEnd)
+        {
+            for (UINT i = uBegin; i < uEnd; ++i)
+            {
+                XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&aVertices[i].Normal));
+                XMVECTOR tangentSum = XMVectorZero();
+                XMVECTOR bitangentSum = XMVectorZero();
+                for (UINT j = aCornerOffsets[i]; j < aCornerOffsets[i + 1u]; ++j)
+                {
+                    UINT uCorner = aCorners[j];
+                    accumulateCorner(normal, aFaceTangents[uCorner / 3u], aCornerAngles[uCorner], tangentSum, bitangentSum);
+                }
+
+                finalizeFrame(normal, tangentSum, bitangentSum, aOutNormalData[i]);
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumVertices, TANGENT_GRAIN_SIZE, gatherVertices);
+        }
+        else
+        {
+            gatherVertices(0u, uNumVertices);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CalculateTangentFramesReference
+
+      Summary:  Single threaded version of CalculateTangentFrames that
+                scatters every face into its vertices, used to validate
+                the parallel one
+
+      Args:     const SimpleVertex* aVertices
+                  Vertices of the mesh
+                UINT uNumVertices
+                  Number of vertices
+                const WORD* aIndices
+                  Triangle list indices
+                UINT uNumIndices
+                  Number of indices
+                NormalData* aOutNormalData
+                  Receives the frame of every vertex
+    -----------------------------------------------------------------F-F*/
+    void CalculateTangentFramesReference(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumIndices) const WORD* aIndices,
+        _In_ UINT uNumIndices,
+        _Out_writes_(uNumVertices) NormalData* aOutNormalData
+    )
+    {
+        std::vector<XMFLOAT3> aTangentSums(uNumVertices, XMFLOAT3(0.0f, 0.0f, 0.0f));
+        std::vector<XMFLOAT3> aBitangentSums(uNumVertices, XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+        FaceTangent face;
+        FLOAT aCornerAngles[3];
+        for (UINT i = 0u; i < uNumIndices / 3u; ++i)
+        {
+            computeFace(aVertices, aIndices, i, face, aCornerAngles);
+            for (UINT k = 0u; k < 3u; ++k)
+            {
+                UINT uVertex = aIndices[i * 3u + k];
+                XMVECTOR tangentSum = XMLoadFloat3(&aTangentSums[uVertex]);
+                XMVECTOR bitangentSum = XMLoadFloat3(&aBitangentSums[uVertex]);
+                accumulateCorner(XMVector3Normalize(XMLoadFloat3(&aVertices[uVertex].Normal)), face, aCornerAngles[k], tangentSum, bitangentSum);
+                XMStoreFloat3(&aTangentSums[uVertex], tangentSum);
+                XMStoreFloat3(&aBitangentSums[uVertex], bitangentSum);
+            }
+        }
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            finalizeFrame(XMVector3Normalize(XMLoadFloat3(&aVertices[i].Normal)), XMLoadFloat3(&aTangentSums[i]), XMLoadFloat3(&aBitangentSums[i]), aOutNormalData[i]);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+/*+===================================================================
+  File:      TANGENTSPACE.H
+
+  Summary:   TangentSpace header file contains declarations of the
+             functions that generate the per vertex tangent frames
+             used by normal mapping.
+
+  Functions: CalculateTangentFrames, CalculateTangentFramesReference
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    class ThreadPool;
+
+    void CalculateTangentFrames(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumIndices) const WORD* aIndices,
+        _In_ UINT uNumIndices,
+        _Out_writes_(uNumVertices) NormalData* aOutNormalData,
+        _In_opt_ ThreadPool* pThreadPool
+    );
+
+    void CalculateTangentFramesReference(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumIndices) const WORD* aIndices,
+        _In_ UINT uNumIndices,
+        _Out_writes_(uNumVertices) NormalData* aOutNormalData
+    );
+}
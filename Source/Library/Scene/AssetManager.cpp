@@ -0,0 +1,253 @@
+#include "Scene/AssetManager.h"
+
+#include <algorithm>
+#include <cwctype>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::GetDefault
+
+      Summary:  Returns the registry shared by the library
+
+      Returns:  AssetManager&
+                  Shared registry
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetManager& AssetManager::GetDefault()
+    {
+        static AssetManager s_assetManager;
+        return s_assetManager;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::AssetManager
+
+      Summary:  Constructor
+
+      Modifies: [m_mutex, m_textures, m_textureSources, m_shaders,
+                 m_uNumHits, m_uNumMisses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetManager::AssetManager()
+        : m_mutex()
+        , m_textures()
+        , m_textureSources()
+        , m_shaders()
+        , m_uNumHits(0u)
+        , m_uNumMisses(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::GetTexture
+
+      Summary:  Returns the texture of the given file, sampler and
+                options. Every user of a file gets the same texture,
+                which is read and created once. A new texture reads
+                the snapshot range set for its file, if any
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                eTextureSamplerType textureSamplerType
+                  Sampler type of the texture
+                const TextureOptions& options
+                  Decoding options of the texture
+
+      Modifies: [m_textures, m_uNumHits, m_uNumMisses].
+
+      Returns:  std::shared_ptr<Texture>
+                  Shared texture, not initialized on a miss
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Texture> AssetManager::GetTexture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType, _In_opt_ const TextureOptions& options)
+    {
+        std::wstring szPath = GetCanonicalPath(filePath);
+        std::wstring szKey = szPath
+            + L"|" + std::to_wstring(static_cast<size_t>(textureSamplerType))
+            + (options.bForceSrgb ? L"|srgb" : L"|linear")
+            + (options.bGenerateMips ? L"|mips" : L"|nomips");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TextureEntry& entry = m_textures[szKey];
+        std::shared_ptr<Texture> texture = entry.WeakTexture.lock();
+        if (texture)
+        {
+            ++m_uNumHits;
+            ++entry.uNumShares;
+            return texture;
+        }
+
+        ++m_uNumMisses;
+        texture = std::make_shared<Texture>(filePath, textureSamplerType, options);
+        entry = { .WeakTexture = texture, .uNumShares = 0u };
+
+        auto iSource = m_textureSources.find(szPath);
+        if (iSource != m_textureSources.end())
+        {
+            texture->SetSnapshotRange(iSource->second.SnapshotPath, iSource->second.ullOffset, iSource->second.uSize);
+        }
+
+        return texture;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::SetTextureSource
+
+      Summary:  Makes the textures of a file read their DDS bytes from a
+                range of a scene snapshot, the live ones that have not
+                read their file yet and the ones created later
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const std::filesystem::path& snapshotPath
+                  Path to the scene snapshot
+                UINT64 ullOffset
+                  Offset of the DDS bytes in the snapshot
+                SIZE_T uSize
+                  Size of the DDS bytes
+
+      Modifies: [m_textureSources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetManager::SetTextureSource(_In_ const std::filesystem::path& filePath, _In_ const std::filesystem::path& snapshotPath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize)
+    {
+        std::wstring szPath = GetCanonicalPath(filePath);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_textureSources[szPath] = { .SnapshotPath = snapshotPath, .ullOffset = ullOffset, .uSize = uSize };
+
+        std::wstring szPrefix = szPath + L"|";
+        for (const auto& [szKey, entry] : m_textures)
+        {
+            std::shared_ptr<Texture> texture = entry.WeakTexture.lock();
+            if (texture && szKey.starts_with(szPrefix))
+            {
+                texture->SetSnapshotRange(snapshotPath, ullOffset, uSize);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::GetTextures
+
+      Summary:  Returns the textures alive, each once
+
+      Returns:  std::vector<std::shared_ptr<Texture>>
+                  Live textures
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<Texture>> AssetManager::GetTextures()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::vector<std::shared_ptr<Texture>> aTextures;
+        for (const auto& [szKey, entry] : m_textures)
+        {
+            std::shared_ptr<Texture> texture = entry.WeakTexture.lock();
+            if (texture)
+            {
+                aTextures.push_back(std::move(texture));
+            }
+        }
+
+        return aTextures;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::GetStats
+
+      Summary:  Returns the hits and misses so far and the live assets.
+                Entries whose asset was freed are dropped
+
+      Modifies: [m_textures, m_shaders].
+
+      Returns:  AssetStats
+                  Current stats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetStats AssetManager::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        AssetStats stats =
+        {
+            .uNumHits = m_uNumHits,
+            .uNumMisses = m_uNumMisses,
+            .uNumTextures = 0u,
+            .uNumShaders = 0u,
+            .ullResidentBytes = 0ull,
+            .ullSharedBytes = 0ull
+        };
+
+        for (auto it = m_textures.begin(); it != m_textures.end();)
+        {
+            std::shared_ptr<Texture> texture = it->second.WeakTexture.lock();
+            if (!texture)
+            {
+                it = m_textures.erase(it);
+                continue;
+            }
+
+            ++stats.uNumTextures;
+            stats.ullResidentBytes += texture->GetResidentBytes();
+            stats.ullSharedBytes += texture->GetResidentBytes() * it->second.uNumShares;
+            ++it;
+        }
+
+        std::erase_if(m_shaders, [](const auto& entry) { return entry.second.expired(); });
+        stats.uNumShaders = static_cast<UINT>(m_shaders.size());
+
+        return stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::LogStats
+
+      Summary:  Writes the stats to the debug output
+
+      Modifies: [m_textures, m_shaders].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetManager::LogStats()
+    {
+        AssetStats stats = GetStats();
+        UINT uNumRequests = stats.uNumHits + stats.uNumMisses;
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Assets: %.1f%% hit rate (%u of %u), %u textures (%.2f MB, %.2f MB saved by sharing), %u shaders\n",
+            uNumRequests ? 100.0f * static_cast<FLOAT>(stats.uNumHits) / static_cast<FLOAT>(uNumRequests) : 0.0f,
+            stats.uNumHits,
+            uNumRequests,
+            stats.uNumTextures,
+            static_cast<FLOAT>(stats.ullResidentBytes) / (1024.0f * 1024.0f),
+            static_cast<FLOAT>(stats.ullSharedBytes) / (1024.0f * 1024.0f),
+            stats.uNumShaders
+        );
+        OutputDebugString(szMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::GetCanonicalPath
+
+      Summary:  Returns the path with ".." and links resolved and
+                lowercased, so every spelling of a file gives one key
+
+      Args:     const std::filesystem::path& filePath
+                  Path to a file
+
+      Returns:  std::wstring
+                  Key of the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::wstring AssetManager::GetCanonicalPath(_In_ const std::filesystem::path& filePath)
+    {
+        std::error_code error;
+        std::filesystem::path absolutePath = std::filesystem::absolute(filePath, error);
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(absolutePath, error);
+        if (error)
+        {
+            canonicalPath = absolutePath.lexically_normal();
+        }
+
+        // Windows paths are case insensitive
+        std::wstring szPath = canonicalPath.wstring();
+        std::transform(szPath.begin(), szPath.end(), szPath.begin(), [](WCHAR c) { return static_cast<WCHAR>(std::towlower(c)); });
+
+        return szPath;
+    }
+}
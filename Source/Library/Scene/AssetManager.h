@@ -0,0 +1,171 @@
+/*+===================================================================
+  File:      ASSETMANAGER.H
+
+  Summary:   AssetManager header file contains declarations of the
+             AssetManager class that shares textures and shaders
+             loaded from the same file between their users.
+
+  Classes: AssetManager
+
+  Structs: AssetStats
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/Shader.h"
+#include "Texture/Texture.h"
+
+#include <mutex>
+#include <typeinfo>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AssetStats
+
+      Summary:  Requests served from a live asset and requests that
+                created one, the video memory of the live textures, and
+                the video memory their extra users would have taken
+                with a copy each
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AssetStats
+    {
+        UINT uNumHits;
+        UINT uNumMisses;
+        UINT uNumTextures;
+        UINT uNumShaders;
+        UINT64 ullResidentBytes;
+        UINT64 ullSharedBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AssetManager
+
+      Summary:  Registry of the textures and shaders in use, keyed by
+                canonical path and import options. Holds weak
+                references, so an asset is freed with its last user and
+                loaded again on the next request. Thread safe
+
+      Methods:  GetDefault
+                  Returns the registry shared by the library
+                GetTexture
+                  Returns the texture of a file, creating it on a miss
+                GetShader
+                  Returns the shader of a file and entry point,
+                  creating it on a miss
+                SetTextureSource
+                  Makes the textures of a file read a range of a
+                  scene snapshot
+                GetTextures
+                  Returns the live textures
+                GetStats
+                  Returns the hits, misses and resident bytes
+                LogStats
+                  Writes the stats to the debug output
+                GetCanonicalPath
+                  Returns the key of a file path
+                AssetManager
+                  Constructor.
+                ~AssetManager
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AssetManager final
+    {
+    public:
+        static AssetManager& GetDefault();
+
+        AssetManager();
+        AssetManager(const AssetManager& other) = delete;
+        AssetManager(AssetManager&& other) = delete;
+        AssetManager& operator=(const AssetManager& other) = delete;
+        AssetManager& operator=(AssetManager&& other) = delete;
+        ~AssetManager() = default;
+
+        std::shared_ptr<Texture> GetTexture(
+            _In_ const std::filesystem::path& filePath,
+            _In_opt_ eTextureSamplerType textureSamplerType = eTextureSamplerType::TRILINEAR_WRAP,
+            _In_opt_ const TextureOptions& options = DEFAULT_TEXTURE_OPTIONS
+        );
+
+        template <class T>
+        std::shared_ptr<T> GetShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
+
+        void SetTextureSource(_In_ const std::filesystem::path& filePath, _In_ const std::filesystem::path& snapshotPath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize);
+        std::vector<std::shared_ptr<Texture>> GetTextures();
+
+        AssetStats GetStats();
+        void LogStats();
+
+        static std::wstring GetCanonicalPath(_In_ const std::filesystem::path& filePath);
+
+    private:
+        struct TextureEntry
+        {
+            std::weak_ptr<Texture> WeakTexture;
+            UINT uNumShares;
+        };
+
+        struct TextureSource
+        {
+            std::filesystem::path SnapshotPath;
+            UINT64 ullOffset;
+            SIZE_T uSize;
+        };
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<std::wstring, TextureEntry> m_textures;
+        std::unordered_map<std::wstring, TextureSource> m_textureSources;
+        std::unordered_map<std::wstring, std::weak_ptr<Shader>> m_shaders;
+        UINT m_uNumHits;
+        UINT m_uNumMisses;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetManager::GetShader
+
+      Summary:  Returns the shader compiled from the given file, entry
+                point and model. The shader class is part of the key,
+                since subclasses create different input layouts, and so
+                are the feature switches
+
+      Args:     PCWSTR pszFileName
+                  Name of the file, has to outlive the shader
+                PCSTR pszEntryPoint
+                  Entry point, has to outlive the shader
+                PCSTR pszShaderModel
+                  Shader model, has to outlive the shader
+                UINT uFeatures
+                  SHADER_FEATURE_ switches the shader tests with #if
+
+      Modifies: [m_shaders, m_uNumHits, m_uNumMisses].
+
+      Returns:  std::shared_ptr<T>
+                  Shared shader, not initialized on a miss
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class T>
+    std::shared_ptr<T> AssetManager::GetShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures)
+    {
+        static_assert(std::is_base_of_v<Shader, T>, "T has to be a shader");
+
+        std::string szOptions = std::string(typeid(T).name()) + "|" + pszEntryPoint + "|" + pszShaderModel + "|" + std::to_string(uFeatures);
+        std::wstring szKey = GetCanonicalPath(pszFileName) + L"|" + std::wstring(szOptions.begin(), szOptions.end());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::shared_ptr<Shader> shader = m_shaders[szKey].lock();
+        if (shader)
+        {
+            ++m_uNumHits;
+            return std::static_pointer_cast<T>(shader);
+        }
+
+        ++m_uNumMisses;
+        std::shared_ptr<T> newShader = std::make_shared<T>(pszFileName, pszEntryPoint, pszShaderModel, uFeatures);
+        m_shaders[szKey] = newShader;
+
+        return newShader;
+    }
+}
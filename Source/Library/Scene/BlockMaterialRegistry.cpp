@@ -0,0 +1,113 @@
+#include "Scene/BlockMaterialRegistry.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialRegistry::GetBlockId
+
+      Summary:  Returns the block id of a block type, its slice in the
+                texture arrays and its index in the block colors
+
+      Args:     eBlockType blockType
+                  Block type, GRASSLAND up to COUNT
+
+      Returns:  UINT
+                  Block id
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT BlockMaterialRegistry::GetBlockId(_In_ eBlockType blockType)
+    {
+        return static_cast<UINT>(static_cast<INT>(blockType) - static_cast<INT>(eBlockType::GRASSLAND));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialRegistry::BlockMaterialRegistry
+
+      Summary:  Constructor. Every block type starts white and untextured
+
+      Modifies: [m_aMaterials].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BlockMaterialRegistry::BlockMaterialRegistry()
+        : m_aMaterials()
+    {
+        for (BlockMaterial& material : m_aMaterials)
+        {
+            material.Color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialRegistry::SetColor
+
+      Summary:  Sets the color of a block type. Called before the
+                block textures are initialized
+
+      Args:     eBlockType blockType
+                  Block type
+                const XMFLOAT4& color
+                  Color the diffuse texture is multiplied by
+
+      Modifies: [m_aMaterials].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockMaterialRegistry::SetColor(_In_ eBlockType blockType, _In_ const XMFLOAT4& color)
+    {
+        m_aMaterials[GetBlockId(blockType)].Color = color;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialRegistry::SetTextures
+
+      Summary:  Sets the image files of a block type. Called before
+                the block textures are loaded
+
+      Args:     eBlockType blockType
+                  Block type
+                const std::filesystem::path& diffusePath
+                  Diffuse image, empty for none
+                const std::filesystem::path& normalPath
+                  Normal map, empty for none
+
+      Modifies: [m_aMaterials].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockMaterialRegistry::SetTextures(_In_ eBlockType blockType, _In_ const std::filesystem::path& diffusePath, _In_opt_ const std::filesystem::path& normalPath)
+    {
+        m_aMaterials[GetBlockId(blockType)].DiffusePath = diffusePath;
+        m_aMaterials[GetBlockId(blockType)].NormalPath = normalPath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialRegistry::GetMaterial
+
+      Summary:  Returns the material of a block type
+
+      Args:     eBlockType blockType
+                  Block type
+
+      Returns:  const BlockMaterial&
+                  Material
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BlockMaterial& BlockMaterialRegistry::GetMaterial(_In_ eBlockType blockType) const
+    {
+        return m_aMaterials[GetBlockId(blockType)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialRegistry::HasNormalMaps
+
+      Summary:  Returns whether any block type has a normal map. The
+                others get a flat slice
+
+      Returns:  BOOL
+                  TRUE if the normal array is worth sampling
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL BlockMaterialRegistry::HasNormalMaps() const
+    {
+        for (const BlockMaterial& material : m_aMaterials)
+        {
+            if (!material.NormalPath.empty())
+            {
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+}
@@ -0,0 +1,76 @@
+/*+===================================================================
+  File:      BLOCKMATERIALREGISTRY.H
+
+  Summary:   BlockMaterialRegistry header file contains declarations
+             of the BlockMaterialRegistry class that holds the color
+             and the textures of every voxel block type under the
+             block id of each instance. BlockMaterialTextures.h packs
+             them into the resources the whole voxel world draws with.
+
+  Classes: BlockMaterialRegistry
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   BlockMaterial
+
+      Summary:  Appearance of a block type. The diffuse texture is
+                tinted by Color, a block without one shows its color and
+                a block without a normal map is flat
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct BlockMaterial
+    {
+        XMFLOAT4 Color;
+        std::filesystem::path DiffusePath;
+        std::filesystem::path NormalPath;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BlockMaterialRegistry
+
+      Summary:  Materials of the block types, indexed by block id
+
+      Methods:  GetBlockId
+                  Returns the block id of a block type
+                SetColor
+                  Sets the color of a block type
+                SetTextures
+                  Sets the textures of a block type
+                GetMaterial
+                  Returns the material of a block type
+                HasNormalMaps
+                  Returns whether any block type has a normal map
+                BlockMaterialRegistry
+                  Constructor.
+                ~BlockMaterialRegistry
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BlockMaterialRegistry final
+    {
+    public:
+        static UINT GetBlockId(_In_ eBlockType blockType);
+
+        BlockMaterialRegistry();
+        BlockMaterialRegistry(const BlockMaterialRegistry& other) = delete;
+        BlockMaterialRegistry(BlockMaterialRegistry&& other) = delete;
+        BlockMaterialRegistry& operator=(const BlockMaterialRegistry& other) = delete;
+        BlockMaterialRegistry& operator=(BlockMaterialRegistry&& other) = delete;
+        ~BlockMaterialRegistry() = default;
+
+        void SetColor(_In_ eBlockType blockType, _In_ const XMFLOAT4& color);
+        void SetTextures(_In_ eBlockType blockType, _In_ const std::filesystem::path& diffusePath, _In_opt_ const std::filesystem::path& normalPath = std::filesystem::path());
+        const BlockMaterial& GetMaterial(_In_ eBlockType blockType) const;
+        BOOL HasNormalMaps() const;
+
+    private:
+        BlockMaterial m_aMaterials[NUM_BLOCK_TYPES];
+    };
+}
@@ -0,0 +1,232 @@
+#include "Scene/BlockMaterialTextures.h"
+
+#include "Texture/TextureArrayResource.h"
+#include "Texture/WICTextureLoader.h"
+#include "Utility/MappedFile.h"
+#include "Utility/ThreadPool.h"
+
+namespace library
+{
+    constexpr const UINT BLOCK_TEXTURE_SIZE = 256u;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::BlockMaterialTextures
+
+      Summary:  Constructor.
+
+      Modifies: [m_diffuseImage, m_normalImage, m_diffuseTextureArray,
+                 m_normalTextureArray, m_constantBuffer].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BlockMaterialTextures::BlockMaterialTextures()
+        : m_diffuseImage()
+        , m_normalImage()
+        , m_diffuseTextureArray()
+        , m_normalTextureArray()
+        , m_constantBuffer()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::Load
+
+      Summary:  Decodes the textures of every block type and packs them
+                into the diffuse and normal arrays. Runs on any thread,
+                WIC is created through COM so the thread joins it
+
+      Args:     const BlockMaterialRegistry& materials
+                  Materials of the block types
+
+      Modifies: [m_diffuseImage, m_normalImage].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BlockMaterialTextures::Load(_In_ const BlockMaterialRegistry& materials)
+    {
+        HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        HRESULT hr = packTextures(materials, FALSE, m_diffuseImage);
+        if (SUCCEEDED(hr))
+        {
+            hr = packTextures(materials, TRUE, m_normalImage);
+        }
+
+        if (SUCCEEDED(hrCom))
+        {
+            CoUninitialize();
+        }
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::Initialize
+
+      Summary:  Uploads the packed arrays and the block colors, loading
+                them first if Load was not called. The packed images are
+                released afterwards
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the resources
+                const BlockMaterialRegistry& materials
+                  Materials of the block types
+
+      Modifies: [m_diffuseImage, m_normalImage, m_diffuseTextureArray,
+                 m_normalTextureArray, m_constantBuffer].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BlockMaterialTextures::Initialize(_In_ ID3D11Device* pDevice, _In_ const BlockMaterialRegistry& materials)
+    {
+        HRESULT hr = S_OK;
+        if (m_diffuseImage.aSubresources.empty() || m_normalImage.aSubresources.empty())
+        {
+            hr = Load(materials);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        hr = CreateTextureArray(pDevice, m_diffuseImage, m_diffuseTextureArray);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = CreateTextureArray(pDevice, m_normalImage, m_normalTextureArray);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_diffuseImage = {};
+        m_normalImage = {};
+
+        CBBlockMaterials cbBlockMaterials = {};
+        for (UINT i = 0u; i < NUM_BLOCK_TYPES; ++i)
+        {
+            cbBlockMaterials.BlockColors[i] = materials.GetMaterial(static_cast<eBlockType>(static_cast<INT>(eBlockType::GRASSLAND) + static_cast<INT>(i))).Color;
+        }
+        D3D11_BUFFER_DESC constantBd = {
+            .ByteWidth = sizeof(CBBlockMaterials),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+        D3D11_SUBRESOURCE_DATA constantInitData = {
+            .pSysMem = &cbBlockMaterials,
+            .SysMemPitch = 0,
+            .SysMemSlicePitch = 0
+        };
+        return pDevice->CreateBuffer(&constantBd, &constantInitData, m_constantBuffer.GetAddressOf());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::GetDiffuseTextureArray
+
+      Summary:  Returns the view of the diffuse array, one slice per
+                block id
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Diffuse texture array
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& BlockMaterialTextures::GetDiffuseTextureArray()
+    {
+        return m_diffuseTextureArray;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::GetNormalTextureArray
+
+      Summary:  Returns the view of the normal array, one slice per
+                block id
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Normal texture array
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& BlockMaterialTextures::GetNormalTextureArray()
+    {
+        return m_normalTextureArray;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::GetConstantBuffer
+
+      Summary:  Returns the constant buffer of block colors
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& BlockMaterialTextures::GetConstantBuffer()
+    {
+        return m_constantBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockMaterialTextures::packTextures
+
+      Summary:  Decodes the diffuse or normal images of the block types
+                at most BLOCK_TEXTURE_SIZE wide and packs them into an
+                array of that size. Block types without an image get a
+                white or flat slice. An array with no image at all is
+                1x1, it only carries the fill colors
+
+      Args:     const BlockMaterialRegistry& materials
+                  Materials of the block types
+                BOOL bNormalMap
+                  TRUE to pack the normal maps
+                TextureArrayImage& outImage
+                  Receives the packed array
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BlockMaterialTextures::packTextures(_In_ const BlockMaterialRegistry& materials, _In_ BOOL bNormalMap, _Out_ TextureArrayImage& outImage)
+    {
+        std::vector<WICDecodedImage> aImages(NUM_BLOCK_TYPES);
+        std::vector<TextureArraySlice> aSlices(NUM_BLOCK_TYPES);
+        UINT uSize = 1u;
+        for (UINT i = 0u; i < NUM_BLOCK_TYPES; ++i)
+        {
+            aSlices[i] =
+            {
+                .pPixels = nullptr,
+                .uWidth = 0u,
+                .uHeight = 0u,
+                .FillColor = bNormalMap ? XMFLOAT4(0.5f, 0.5f, 1.0f, 1.0f) : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)
+            };
+
+            const BlockMaterial& material = materials.GetMaterial(static_cast<eBlockType>(static_cast<INT>(eBlockType::GRASSLAND) + static_cast<INT>(i)));
+            const std::filesystem::path& filePath = bNormalMap ? material.NormalPath : material.DiffusePath;
+            if (filePath.empty())
+            {
+                continue;
+            }
+
+            MappedFile file;
+            HRESULT hr = file.Open(filePath);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = DecodeWICTextureFromMemory(file.GetData(), file.GetSize(), BLOCK_TEXTURE_SIZE, false, aImages[i], true);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            aSlices[i].pPixels = aImages[i].Pixels.data();
+            aSlices[i].uWidth = aImages[i].Width;
+            aSlices[i].uHeight = aImages[i].Height;
+            uSize = BLOCK_TEXTURE_SIZE;
+        }
+
+        MipChainOptions options = DEFAULT_MIP_CHAIN_OPTIONS;
+        options.bNormalMap = bNormalMap;
+        return PackTextureArray(eMipFormat::RGBA8_UNORM, aSlices, uSize, uSize, options, &ThreadPool::GetDefault(), outImage);
+    }
+}
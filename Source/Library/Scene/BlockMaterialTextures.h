@@ -0,0 +1,73 @@
+/*+===================================================================
+  File:      BLOCKMATERIALTEXTURES.H
+
+  Summary:   BlockMaterialTextures header file contains declarations
+             of the BlockMaterialTextures class that packs the diffuse
+             and normal textures and the colors of a
+             BlockMaterialRegistry into texture arrays and a constant
+             buffer indexed by the block id of each instance, so the
+             whole voxel world draws with one set of resources.
+
+  Classes: BlockMaterialTextures
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/BlockMaterialRegistry.h"
+#include "Texture/TextureArray.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BlockMaterialTextures
+
+      Summary:  Device resources of the block materials. Load decodes
+                and packs the textures on the CPU, Initialize creates
+                the arrays and the color buffer on the device
+
+      Methods:  Load
+                  Decodes and packs the textures
+                Initialize
+                  Creates the texture arrays and the color buffer
+                GetDiffuseTextureArray
+                  Returns the view of the diffuse array
+                GetNormalTextureArray
+                  Returns the view of the normal array
+                GetConstantBuffer
+                  Returns the buffer of block colors
+                BlockMaterialTextures
+                  Constructor.
+                ~BlockMaterialTextures
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BlockMaterialTextures final
+    {
+    public:
+        BlockMaterialTextures();
+        BlockMaterialTextures(const BlockMaterialTextures& other) = delete;
+        BlockMaterialTextures(BlockMaterialTextures&& other) = delete;
+        BlockMaterialTextures& operator=(const BlockMaterialTextures& other) = delete;
+        BlockMaterialTextures& operator=(BlockMaterialTextures&& other) = delete;
+        ~BlockMaterialTextures() = default;
+
+        HRESULT Load(_In_ const BlockMaterialRegistry& materials);
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ const BlockMaterialRegistry& materials);
+
+        ComPtr<ID3D11ShaderResourceView>& GetDiffuseTextureArray();
+        ComPtr<ID3D11ShaderResourceView>& GetNormalTextureArray();
+        ComPtr<ID3D11Buffer>& GetConstantBuffer();
+
+    private:
+        static HRESULT packTextures(_In_ const BlockMaterialRegistry& materials, _In_ BOOL bNormalMap, _Out_ TextureArrayImage& outImage);
+
+    private:
+        TextureArrayImage m_diffuseImage;
+        TextureArrayImage m_normalImage;
+        ComPtr<ID3D11ShaderResourceView> m_diffuseTextureArray;
+        ComPtr<ID3D11ShaderResourceView> m_normalTextureArray;
+        ComPtr<ID3D11Buffer> m_constantBuffer;
+    };
+}
@@ -1,9 +1,42 @@
 #include "Scene/Scene.h"
 
+#include "Scene/AssetManager.h"
+#include "Shader/ShaderCache.h"
+#include "Shader/ShaderPermutation.h"
 #include "Shader/SkyMapVertexShader.h"
+#include "Texture/DDS.h"
+#include "Texture/TextureCache.h"
+#include "Texture/TextureCooker.h"
+#include "Texture/TextureResidency.h"
+#include "Utility/MappedFile.h"
+
+#include <algorithm>
+#include <climits>
+#include <mutex>
 
 namespace library
 {
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: toUtf8
+
+          Summary:  Converts a wide string to UTF-8, the encoding of the
+                    snapshot strings
+
+          Args:     const std::wstring& szString
+                      String to convert
+
+          Returns:  std::string
+                      UTF-8 string
+        -----------------------------------------------------------------F-F*/
+        std::string toUtf8(_In_ const std::wstring& szString)
+        {
+            std::u8string szUtf8 = std::filesystem::path(szString).u8string();
+            return std::string(szUtf8.begin(), szUtf8.end());
+        }
+    }
+
     FLOAT Scene::GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth)
     {
         FLOAT xa = x * frequency;
@@ -24,220 +57,400 @@ namespace library
         return fin / div;
     }
 
-    Scene::Scene(const std::filesystem::path& filePath)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Scene
+
+      Summary:  Constructor. Takes the block colors and voxels from the
+                snapshot of the scene when it is current, or else
+                parses the scene file
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the height map
+                BOOL bUseSnapshot
+                  Whether the snapshot of the scene is read and
+                  written, FALSE to always load cold
+
+      Modifies: [m_filePath, m_voxels, m_blockMaterials,
+                 m_blockMaterialTextures, m_renderables, m_aPointLights, m_vertexShaders, m_pixelShaders,
+                 m_skyBox, m_uNumLoadingThreads, m_loadProgressCallback,
+                 m_bUseSnapshot, m_snapshot, m_uNumFileVoxels,
+                 m_transforms, m_transformNodes, m_aNodeRenderables,
+                 m_aLightNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Scene::Scene(const std::filesystem::path& filePath, _In_opt_ BOOL bUseSnapshot)
         : m_filePath(filePath)
         , m_voxels()
+        , m_blockMaterials()
+        , m_blockMaterialTextures()
         , m_renderables()
         , m_aPointLights{ nullptr}
         , m_vertexShaders()
         , m_pixelShaders()
         , m_skyBox()
+        , m_uNumLoadingThreads(0u)
+        , m_loadProgressCallback([this](UINT uNumDone, UINT uNumTasks, PCWSTR pszTaskName)
+            {
+                WCHAR szMessage[256];
+                swprintf_s(szMessage, L"Loading %s: %u/%u %s\n", GetFileName(), uNumDone, uNumTasks, pszTaskName);
+                OutputDebugString(szMessage);
+            })
+        , m_bUseSnapshot(bUseSnapshot)
+        , m_snapshot()
+        , m_uNumFileVoxels(0u)
+        , m_transforms()
+        , m_transformNodes()
+        , m_aNodeRenderables()
+        , m_aLightNodes()
     {
-        std::ifstream inputFile;
-        inputFile.open(m_filePath.string());
+        if (!m_bUseSnapshot ||
+            FAILED(m_snapshot.Open(GetSceneSnapshotPath(m_filePath))) ||
+            !m_snapshot.IsCurrent() ||
+            FAILED(loadSnapshotVoxels()))
+        {
+            m_snapshot.Close();
+            m_voxels.clear();
+            parseFile();
+        }
 
-        std::string trash;
-        UINT aDimension[4] = { 0u, };
-        UINT uDimensionIdx = 0u;
-        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        // Voxels added later are made in code and not snapshotted
+        m_uNumFileVoxels = m_voxels.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Initialize
+
+      Summary:  Initializes the voxels, shaders, renderables, models, 
+                and skybox. Compiling shaders, importing models and
+                reading textures run on the thread pool, creating the
+                device objects runs on this thread once its inputs are
+                ready. Shaders compile only the variants the objects
+                drawn with them use, and their device objects are
+                created once all of them compiled, so the errors of
+                every shader are reported together. A current snapshot
+                supplies the cooked meshes, textures and bytecode,
+                otherwise one is saved once everything loaded
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_materials].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        LARGE_INTEGER startingTime = {};
+        LARGE_INTEGER endingTime = {};
+        LARGE_INTEGER frequency = {};
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        std::unique_ptr<ThreadPool> loadingThreadPool;
+        ThreadPool* pThreadPool = nullptr;
+        if (m_uNumLoadingThreads == 0u)
         {
-            inputFile >> aDimension[uDimensionIdx];
+            pThreadPool = &ThreadPool::GetDefault();
+        }
+        else if (m_uNumLoadingThreads > 1u)
+        {
+            loadingThreadPool = std::make_unique<ThreadPool>(m_uNumLoadingThreads - 1u);
+            pThreadPool = loadingThreadPool.get();
+        }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                ++uDimensionIdx;
-            }
+        // Models, textures and shaders read their ranges of the
+        // snapshot through their own mappings
+        BOOL bFromSnapshot = m_snapshot.IsOpen() && applySnapshot();
+        m_snapshot.Close();
+
+        LoadGraph graph;
+
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            graph.AddTask(L"voxel", eLoadQueue::DEVICE, [=]() { return voxel->Initialize(pDevice, pImmediateContext); });
         }
 
-        UINT uColorIdx = 0u;
-        XMFLOAT4 color;
-        while (!inputFile.eof() && uColorIdx < aDimension[3])
         {
-            inputFile >> color.x >> color.y >> color.z;
+            UINT uPack = graph.AddTask(L"block materials", eLoadQueue::WORKER, [this]() { return m_blockMaterialTextures.Load(m_blockMaterials); });
+            UINT uCreate = graph.AddTask(L"block materials", eLoadQueue::DEVICE, [=, this]() { return m_blockMaterialTextures.Initialize(pDevice, m_blockMaterials); });
+            graph.AddDependency(uCreate, uPack);
+        }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                color.w = 1.0f;
-                m_voxels.push_back(std::make_shared<Voxel>(color));
-                ++uColorIdx;
-            }
+        // Variants of the objects whose materials are known are
+        // requested now, the imported ones request theirs after import
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            voxel->SetHasNormalMap(m_blockMaterials.HasNormalMaps());
+            voxel->RequestShaderVariants();
         }
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
-        aInstanceData.reserve(m_voxels.size());
-        for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
+        for (const auto& [szName, renderable] : m_renderables)
         {
-            aInstanceData.push_back(std::vector<InstanceData>());
-            aInstanceData.back().reserve(
-                static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-            );
+            renderable->RequestShaderVariants();
         }
 
-        UINT uDepthIdx = 0u;
-        UINT uWidthIdx = 0u;
-        CHAR voxelType;
-        FLOAT height;
-        while (!inputFile.eof())
+        for (const auto& [szName, renderable] : m_renderables)
         {
-            inputFile >> voxelType >> height;
+            graph.AddTask(szName, eLoadQueue::DEVICE, [=]() { return renderable->Initialize(pDevice, pImmediateContext); });
+        }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
-            {
-                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
+        // Materials added by the models are initialized with them
+        std::vector<std::shared_ptr<Material>> aMaterials;
+        aMaterials.reserve(m_materials.size());
+        for (const auto& [szName, material] : m_materials)
+        {
+            aMaterials.push_back(material);
+        }
+
+        std::vector<std::pair<std::shared_ptr<Renderable>, UINT>> aImports;
+        for (const auto& [szName, model] : m_models)
+        {
+            UINT uImport = graph.AddTask(szName, eLoadQueue::WORKER, [=]()
                 {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-                        InstanceData
-                        {
-                            .Transformation = XMMatrixTranslation(
-                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-                                )
-                        }
-                    );
+                    HRESULT hr = model->Import();
+                    if (FAILED(hr))
+                    {
+                        return hr;
+                    }
+
+                    model->RequestShaderVariants();
+                    return S_OK;
                 }
-                ++uWidthIdx;
-                if (uWidthIdx >= aDimension[0])
+            );
+            UINT uCreate = graph.AddTask(szName, eLoadQueue::DEVICE, [=, this]()
                 {
-                    uWidthIdx -= aDimension[0];
-                    ++uDepthIdx;
+                    HRESULT hr = model->Initialize(pDevice, pImmediateContext);
+                    if (FAILED(hr))
+                    {
+                        return hr;
+                    }
 
-                    if (uDepthIdx >= aDimension[2])
+                    for (UINT i = 0u; i < model->GetNumMaterials(); ++i)
                     {
-                        uDepthIdx -= aDimension[2];
+                        AddMaterial(model->GetMaterial(i));
                     }
+
+                    return S_OK;
                 }
-            }
+            );
+            graph.AddDependency(uCreate, uImport);
+            aImports.push_back({ model, uImport });
         }
 
-        inputFile.close();
-
-        UINT uVoxelIdx = 0u;
-        auto it = m_voxels.begin();
-        while (it != m_voxels.end())
+        for (const std::shared_ptr<Material>& material : aMaterials)
         {
-            if (aInstanceData[uVoxelIdx].size() <= 0)
-            {
-                it = m_voxels.erase(it);
-            }
-            else
-            {
-                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-                ++it;
-            }
-            ++uVoxelIdx;
+            UINT uRead = graph.AddTask(material->GetName(), eLoadQueue::WORKER, [=]() { return material->Prefetch(); });
+            UINT uCreate = graph.AddTask(material->GetName(), eLoadQueue::DEVICE, [=]() { return material->Initialize(pDevice, pImmediateContext); });
+            graph.AddDependency(uCreate, uRead);
         }
-    }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::Initialize
+        if (m_skyBox)
+        {
+            std::shared_ptr<Skybox> skyBox = m_skyBox;
+            UINT uImport = graph.AddTask(L"skybox", eLoadQueue::WORKER, [=]()
+                {
+                    HRESULT hr = skyBox->Import();
+                    if (FAILED(hr))
+                    {
+                        return hr;
+                    }
 
-      Summary:  Initializes the voxels, shaders, renderables, models, 
-                and skybox
+                    skyBox->RequestShaderVariants();
+                    return S_OK;
+                }
+            );
+            UINT uCreate = graph.AddTask(L"skybox", eLoadQueue::DEVICE, [=]() { return skyBox->Initialize(pDevice, pImmediateContext); });
+            graph.AddDependency(uCreate, uImport);
+            aImports.push_back({ skyBox, uImport });
+        }
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
-    {
-        for (auto voxel : m_voxels)
+        // A shader compiles the variants in use, so it waits for the
+        // imports of the objects drawn with it. Its variants compile
+        // in parallel with each other and with the other shaders
+        std::vector<std::pair<std::wstring, std::shared_ptr<Shader>>> aShaders;
+        for (const auto& [szName, vertexShader] : m_vertexShaders)
         {
-            HRESULT hr = voxel->Initialize(pDevice, pImmediateContext);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            aShaders.push_back({ szName, vertexShader });
         }
-
-        for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
+        for (const auto& [szName, pixelShader] : m_pixelShaders)
         {
-            HRESULT hr = it->second->Initialize(pDevice);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            aShaders.push_back({ szName, pixelShader });
         }
 
-        for (auto it = m_pixelShaders.begin(); it != m_pixelShaders.end(); ++it)
+        // A failed compile does not stop the others, the errors are
+        // gathered once all of them finished
+        std::mutex compileMutex;
+        LONGLONG llFirstCompileTime = LLONG_MAX;
+        std::vector<UINT> aCompiles;
+        for (const auto& [szName, shader] : aShaders)
         {
-            HRESULT hr = it->second->Initialize(pDevice);
-            if (FAILED(hr))
+            UINT uCompile = graph.AddTask(szName, eLoadQueue::WORKER, [=, &compileMutex, &llFirstCompileTime]()
+                {
+                    LARGE_INTEGER compileTime = {};
+                    QueryPerformanceCounter(&compileTime);
+                    {
+                        std::lock_guard<std::mutex> lock(compileMutex);
+                        llFirstCompileTime = std::min(llFirstCompileTime, compileTime.QuadPart);
+                    }
+
+                    shader->Precompile(pThreadPool);
+                    return S_OK;
+                }
+            );
+            aCompiles.push_back(uCompile);
+
+            for (const auto& [renderable, uImport] : aImports)
             {
-                return hr;
+                if (renderable->UsesShader(shader.get()))
+                {
+                    graph.AddDependency(uCompile, uImport);
+                }
             }
         }
 
-        for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
-        {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
-            if (FAILED(hr))
+        FLOAT shaderMilliseconds = 0.0f;
+        UINT uReport = graph.AddTask(L"shaders", eLoadQueue::DEVICE, [&]()
             {
-                return hr;
+                if (llFirstCompileTime != LLONG_MAX)
+                {
+                    LARGE_INTEGER compileTime = {};
+                    QueryPerformanceCounter(&compileTime);
+                    shaderMilliseconds = static_cast<FLOAT>(compileTime.QuadPart - llFirstCompileTime) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart);
+                }
+
+                std::string szErrors;
+                for (const auto& [szName, shader] : aShaders)
+                {
+                    szErrors += shader->GetCompileErrors();
+                }
+                if (szErrors.empty())
+                {
+                    return S_OK;
+                }
+
+                OutputDebugStringA(szErrors.c_str());
+                MessageBoxA(nullptr, szErrors.c_str(), "Shader compile errors", MB_OK);
+                return E_FAIL;
             }
+        );
+        for (UINT uCompile : aCompiles)
+        {
+            graph.AddDependency(uReport, uCompile);
         }
 
-        for (auto it = m_models.begin(); it != m_models.end(); ++it)
+        for (const auto& [szName, shader] : aShaders)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            UINT uCreate = graph.AddTask(szName, eLoadQueue::DEVICE, [=]() { return shader->Initialize(pDevice); });
+            graph.AddDependency(uCreate, uReport);
+        }
 
-            for (int i = 0; i < it->second->GetNumMaterials(); ++i)
-            {
-                AddMaterial(it->second->GetMaterial(i));
-            }
+        HRESULT hr = graph.Run(pThreadPool, m_loadProgressCallback);
+        if (FAILED(hr))
+        {
+            return hr;
         }
 
-        for (auto it = m_materials.begin(); it != m_materials.end(); ++it)
+        QueryPerformanceCounter(&endingTime);
+        FLOAT elapsedMilliseconds = static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart);
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Loaded %s in %.2f ms (%s) on %u threads, %u tasks, %.2f ms of worker and %.2f ms of device work\n",
+            GetFileName(),
+            elapsedMilliseconds,
+            bFromSnapshot ? L"snapshot" : L"cold",
+            pThreadPool ? pThreadPool->GetNumThreads() : 1u,
+            graph.GetNumTasks(),
+            graph.GetQueueMilliseconds(eLoadQueue::WORKER),
+            graph.GetQueueMilliseconds(eLoadQueue::DEVICE)
+        );
+        OutputDebugString(szMessage);
+
+        UINT uNumVariants = 0u;
+        UINT uNumPossibleVariants = 0u;
+        FLOAT compileMilliseconds = 0.0f;
+        for (const auto& [szName, shader] : aShaders)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            uNumVariants += shader->GetNumVariants();
+            uNumPossibleVariants += GetNumShaderVariants(shader->GetFeatures());
+            compileMilliseconds += shader->GetCompileMilliseconds();
         }
-        if (m_skyBox)
+        swprintf_s(
+            szMessage,
+            L"Shader variants: %u of %u possible in %zu shaders, compiled in %.2f ms, %.2f ms of compile work\n",
+            uNumVariants,
+            uNumPossibleVariants,
+            aShaders.size(),
+            shaderMilliseconds,
+            compileMilliseconds
+        );
+        OutputDebugString(szMessage);
+
+        if (m_bUseSnapshot && !bFromSnapshot)
         {
-            HRESULT hr = m_skyBox->Initialize(pDevice, pImmediateContext);
-            if (FAILED(hr))
+            QueryPerformanceCounter(&startingTime);
+            hr = saveSnapshot();
+            QueryPerformanceCounter(&endingTime);
+            if (SUCCEEDED(hr))
             {
-                return hr;
+                swprintf_s(
+                    szMessage,
+                    L"Saved snapshot of %s in %.2f ms\n",
+                    GetFileName(),
+                    static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart)
+                );
             }
+            else
+            {
+                swprintf_s(szMessage, L"Could not save the snapshot of %s (0x%08X)\n", GetFileName(), static_cast<UINT>(hr));
+            }
+            OutputDebugString(szMessage);
         }
+
+        AssetManager::GetDefault().LogStats();
+        ShaderCache::GetDefault().LogStats();
+        TextureCache::GetDefault().LogStats();
+        TextureResidency::GetDefault().LogReport();
+
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetNumLoadingThreads
+
+      Summary:  Chooses the number of threads Initialize loads on,
+                the calling one included. Loading on one thread gives
+                the baseline for the startup time
+
+      Args:     UINT uNumThreads
+                  0 for the shared thread pool, 1 to load on the
+                  calling thread only, more for a pool of that size
+
+      Modifies: [m_uNumLoadingThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::SetNumLoadingThreads(_In_ UINT uNumThreads)
+    {
+        m_uNumLoadingThreads = uNumThreads;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetLoadProgressCallback
+
+      Summary:  Sets the function Initialize calls after every loading
+                step, on the thread that called Initialize
+
+      Args:     LoadGraph::ProgressCallback progressCallback
+                  Function to call, may be empty
+
+      Modifies: [m_loadProgressCallback].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::SetLoadProgressCallback(_In_ LoadGraph::ProgressCallback progressCallback)
+    {
+        m_loadProgressCallback = std::move(progressCallback);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::AddVoxel
 
@@ -434,13 +647,45 @@ namespace library
       Method:   Scene::Update
 
       Summary:  Update the renderables, models, point lights, skybox 
-                each frame
+                each frame. The local matrices of the attached objects
+                are pushed into the hierarchy, which recomputes the
+                subtrees that moved, and the objects are placed by
+                their parents' world matrices
 
       Args:     FLOAT deltaTime
                   Time difference of a frame
+
+      Modifies: [m_transforms, m_aNodeRenderables, m_aPointLights].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Scene::Update(_In_ FLOAT deltaTime)
     {
+        UNREFERENCED_PARAMETER(deltaTime);
+
+        if (m_aNodeRenderables.empty())
+        {
+            return;
+        }
+
+        for (UINT i = 0u; i < m_aNodeRenderables.size(); ++i)
+        {
+            m_transforms.SetLocalMatrix(i, m_aNodeRenderables[i]->GetLocalMatrix());
+        }
+
+        m_transforms.Update(&ThreadPool::GetDefault());
+
+        for (UINT i = 0u; i < m_aNodeRenderables.size(); ++i)
+        {
+            INT iParent = m_transforms.GetParent(i);
+            if (iParent != TransformHierarchy::INVALID_NODE)
+            {
+                m_aNodeRenderables[i]->SetParentWorldMatrix(m_transforms.GetWorldMatrix(static_cast<UINT>(iParent)));
+            }
+        }
+
+        for (const auto& [uLight, uNode] : m_aLightNodes)
+        {
+            m_aPointLights[uLight]->SetParentWorldMatrix(m_transforms.GetWorldMatrix(uNode));
+        }
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -456,6 +701,34 @@ namespace library
         return m_voxels;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetBlockMaterials
+
+      Summary:  Returns the materials of the voxel block types. Textures
+                are set on it before Initialize
+
+      Returns:  BlockMaterialRegistry&
+                  Block materials
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BlockMaterialRegistry& Scene::GetBlockMaterials()
+    {
+        return m_blockMaterials;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetBlockMaterialTextures
+
+      Summary:  Returns the texture arrays and the color buffer of the
+                block materials, created by Initialize
+
+      Returns:  BlockMaterialTextures&
+                  Block material resources
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BlockMaterialTextures& Scene::GetBlockMaterialTextures()
+    {
+        return m_blockMaterialTextures;
+    }
+
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetRenderables
@@ -734,6 +1007,695 @@ namespace library
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::AttachRenderable
+
+      Summary:  Attaches a renderable or model to another one, so it
+                follows its parent. Its own transform is kept and
+                becomes relative to the parent
+
+      Args:     PCWSTR pszName
+                  Key of the renderable or model to attach
+                PCWSTR pszParentName
+                  Key of the parent renderable or model
+
+      Modifies: [m_transforms, m_transformNodes, m_aNodeRenderables].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the parent is in the
+                  subtree of the object
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::AttachRenderable(_In_ PCWSTR pszName, _In_ PCWSTR pszParentName)
+    {
+        std::shared_ptr<Renderable> renderable = findTransformable(pszName);
+        std::shared_ptr<Renderable> parent = findTransformable(pszParentName);
+        if (!renderable || !parent)
+        {
+            return E_FAIL;
+        }
+
+        UINT uParentNode = getTransformNode(parent);
+        return m_transforms.SetParent(getTransformNode(renderable), static_cast<INT>(uParentNode));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::AttachPointLight
+
+      Summary:  Attaches a point light to a renderable or model, its
+                position becomes relative to the parent
+
+      Args:     size_t index
+                  Index of the point light
+                PCWSTR pszParentName
+                  Key of the parent renderable or model
+
+      Modifies: [m_transforms, m_transformNodes, m_aNodeRenderables,
+                 m_aLightNodes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::AttachPointLight(_In_ size_t index, _In_ PCWSTR pszParentName)
+    {
+        std::shared_ptr<Renderable> parent = findTransformable(pszParentName);
+        if (index >= NUM_LIGHTS || !m_aPointLights[index] || !parent)
+        {
+            return E_FAIL;
+        }
+
+        UINT uParentNode = getTransformNode(parent);
+        for (auto& [uLight, uNode] : m_aLightNodes)
+        {
+            if (uLight == index)
+            {
+                uNode = uParentNode;
+                return S_OK;
+            }
+        }
+        m_aLightNodes.push_back({ static_cast<UINT>(index), uParentNode });
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::findTransformable
+
+      Summary:  Looks up a renderable, or a model when no renderable
+                has the key
+
+      Args:     PCWSTR pszName
+                  Key of the renderable or model
+
+      Returns:  std::shared_ptr<Renderable>
+                  Renderable or model, nullptr if neither has the key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Renderable> Scene::findTransformable(_In_ PCWSTR pszName) const
+    {
+        auto iRenderable = m_renderables.find(pszName);
+        if (iRenderable != m_renderables.end())
+        {
+            return iRenderable->second;
+        }
+
+        auto iModel = m_models.find(pszName);
+        if (iModel != m_models.end())
+        {
+            return iModel->second;
+        }
+
+        return nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getTransformNode
+
+      Summary:  Returns the hierarchy node of a renderable, adding it as
+                a root the first time
+
+      Args:     const std::shared_ptr<Renderable>& renderable
+                  Renderable or model
+
+      Modifies: [m_transforms, m_transformNodes, m_aNodeRenderables].
+
+      Returns:  UINT
+                  Node of the renderable
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Scene::getTransformNode(_In_ const std::shared_ptr<Renderable>& renderable)
+    {
+        auto iNode = m_transformNodes.find(renderable.get());
+        if (iNode != m_transformNodes.end())
+        {
+            return iNode->second;
+        }
+
+        UINT uNode = m_transforms.AddNode();
+        m_transforms.SetLocalMatrix(uNode, renderable->GetLocalMatrix());
+        m_transformNodes[renderable.get()] = uNode;
+        m_aNodeRenderables.push_back(renderable);
+
+        return uNode;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::parseFile
+
+      Summary:  Reads the dimensions, block colors and heights of the
+                scene file and builds the voxel of its blocks
+
+      Modifies: [m_voxels, m_blockMaterials].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::parseFile()
+    {
+        std::ifstream inputFile;
+        inputFile.open(m_filePath.string());
+
+        std::string trash;
+        UINT aDimension[4] = { 0u, };
+        UINT uDimensionIdx = 0u;
+        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        UINT uColorIdx = 0u;
+        XMFLOAT4 color;
+        while (!inputFile.eof() && uColorIdx < aDimension[3])
+        {
+            inputFile >> color.x >> color.y >> color.z;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                color.w = 1.0f;
+                if (uColorIdx < NUM_BLOCK_TYPES)
+                {
+                    m_blockMaterials.SetColor(static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + uColorIdx), color);
+                }
+                ++uColorIdx;
+            }
+        }
+
+        // Every block type shares one voxel, the block id of an instance
+        // picks its color and textures
+        std::vector<InstanceData> aInstanceData;
+        aInstanceData.reserve(
+            static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
+        );
+
+        UINT uDepthIdx = 0u;
+        UINT uWidthIdx = 0u;
+        CHAR voxelType;
+        FLOAT height;
+        while (!inputFile.eof())
+        {
+            inputFile >> voxelType >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+            {
+                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
+                {
+                    aInstanceData.push_back(
+                        InstanceData
+                        {
+                            .Transformation = XMMatrixTranslation(
+                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
+                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
+                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
+                                ),
+                            .BlockId = BlockMaterialRegistry::GetBlockId(static_cast<eBlockType>(voxelType))
+                        }
+                    );
+                }
+                ++uWidthIdx;
+                if (uWidthIdx >= aDimension[0])
+                {
+                    uWidthIdx -= aDimension[0];
+                    ++uDepthIdx;
+
+                    if (uDepthIdx >= aDimension[2])
+                    {
+                        uDepthIdx -= aDimension[2];
+                    }
+                }
+            }
+        }
+
+        inputFile.close();
+
+        if (!aInstanceData.empty())
+        {
+            m_voxels.push_back(std::make_shared<Voxel>(std::move(aInstanceData), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::loadSnapshotVoxels
+
+      Summary:  Takes the block colors and the voxels of the scene file
+                from the mapped snapshot. The instances are copied
+                straight out of the file, nothing is parsed. Everything
+                is validated before the scene is touched
+
+      Modifies: [m_voxels, m_blockMaterials].
+
+      Returns:  HRESULT
+                  Status code, HRESULT_FROM_WIN32(ERROR_FILE_INVALID)
+                  if the sections are inconsistent
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::loadSnapshotVoxels()
+    {
+        UINT uNumBlockColors = 0u;
+        UINT uNumVoxels = 0u;
+        UINT uNumInstances = 0u;
+        const XMFLOAT4* aBlockColors = m_snapshot.GetSection<XMFLOAT4>(SceneSnapshotSection::BlockColors, uNumBlockColors);
+        const SnapshotVoxel* aVoxels = m_snapshot.GetSection<SnapshotVoxel>(SceneSnapshotSection::Voxels, uNumVoxels);
+        const InstanceData* aInstances = m_snapshot.GetSection<InstanceData>(SceneSnapshotSection::Instances, uNumInstances);
+        if (uNumBlockColors != NUM_BLOCK_TYPES)
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+        for (UINT i = 0u; i < uNumVoxels; ++i)
+        {
+            if (static_cast<UINT64>(aVoxels[i].uFirstInstance) + aVoxels[i].uNumInstances > uNumInstances)
+            {
+                return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+            }
+        }
+
+        for (UINT i = 0u; i < uNumBlockColors; ++i)
+        {
+            m_blockMaterials.SetColor(static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + i), aBlockColors[i]);
+        }
+
+        for (UINT i = 0u; i < uNumVoxels; ++i)
+        {
+            const InstanceData* pFirst = aInstances + aVoxels[i].uFirstInstance;
+            m_voxels.push_back(std::make_shared<Voxel>(std::vector<InstanceData>(pFirst, pFirst + aVoxels[i].uNumInstances), aVoxels[i].OutputColor));
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::applySnapshot
+
+      Summary:  Checks that the mapped snapshot covers the scene as it
+                was set up in code: a cooked mesh for every model, the
+                bytecode of every shader, and the same lights and
+                transforms, which no input file tracks. If it does, the
+                models and textures are pointed at their ranges of the
+                snapshot and the shaders are given their bytecode, so
+                Initialize neither hashes, decodes nor compiles
+
+      Modifies: [m_models, m_skyBox, m_vertexShaders, m_pixelShaders].
+
+      Returns:  BOOL
+                  TRUE if the snapshot was applied, FALSE if it is
+                  stale and nothing was changed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::applySnapshot()
+    {
+        UINT uCount = 0u;
+        const SnapshotLight* aLights = m_snapshot.GetSection<SnapshotLight>(SceneSnapshotSection::Lights, uCount);
+        std::vector<SnapshotLight> aSceneLights = getSnapshotLights();
+        if (uCount != aSceneLights.size() || memcmp(aLights, aSceneLights.data(), uCount * sizeof(SnapshotLight)) != 0)
+        {
+            return FALSE;
+        }
+
+        const SnapshotTransform* aTransforms = m_snapshot.GetSection<SnapshotTransform>(SceneSnapshotSection::Transforms, uCount);
+        std::vector<std::pair<std::string, XMFLOAT4X4>> aSceneTransforms = getSnapshotTransforms();
+        if (uCount != aSceneTransforms.size())
+        {
+            return FALSE;
+        }
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            if (aSceneTransforms[i].first != m_snapshot.GetString(aTransforms[i].uName) ||
+                memcmp(&aSceneTransforms[i].second, &aTransforms[i].World, sizeof(XMFLOAT4X4)) != 0)
+            {
+                return FALSE;
+            }
+        }
+
+        const SnapshotMesh* aMeshRecords = m_snapshot.GetSection<SnapshotMesh>(SceneSnapshotSection::Meshes, uCount);
+        std::unordered_map<std::string, const SnapshotMesh*> meshRecords;
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            if (m_snapshot.GetBlob(aMeshRecords[i].ullBlobOffset, aMeshRecords[i].ullBlobSize))
+            {
+                meshRecords[m_snapshot.GetString(aMeshRecords[i].uPath)] = &aMeshRecords[i];
+            }
+        }
+
+        std::vector<std::shared_ptr<Model>> aModels;
+        for (const auto& [szName, model] : m_models)
+        {
+            aModels.push_back(model);
+        }
+        if (m_skyBox)
+        {
+            aModels.push_back(m_skyBox);
+        }
+
+        std::vector<std::pair<std::shared_ptr<Model>, const SnapshotMesh*>> aMeshes;
+        for (const std::shared_ptr<Model>& model : aModels)
+        {
+            auto iRecord = meshRecords.find(toUtf8(AssetManager::GetCanonicalPath(model->GetCookedMeshPath())));
+            if (iRecord == meshRecords.end())
+            {
+                return FALSE;
+            }
+            aMeshes.push_back({ model, iRecord->second });
+        }
+
+        const SnapshotShader* aShaderRecords = m_snapshot.GetSection<SnapshotShader>(SceneSnapshotSection::Shaders, uCount);
+        std::unordered_map<UINT64, const SnapshotShader*> shaderRecords;
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            if (m_snapshot.GetBlob(aShaderRecords[i].ullBlobOffset, aShaderRecords[i].ullBlobSize))
+            {
+                shaderRecords[aShaderRecords[i].ullCompileKey] = &aShaderRecords[i];
+            }
+        }
+
+        std::vector<std::shared_ptr<Shader>> aShaders;
+        for (const auto& [szName, vertexShader] : m_vertexShaders)
+        {
+            aShaders.push_back(vertexShader);
+        }
+        for (const auto& [szName, pixelShader] : m_pixelShaders)
+        {
+            aShaders.push_back(pixelShader);
+        }
+
+        // Which variants are drawn is only known after the imports, so
+        // every variant the snapshot holds is taken
+        std::vector<std::pair<std::shared_ptr<Shader>, const SnapshotShader*>> aVariants;
+        for (const std::shared_ptr<Shader>& shader : aShaders)
+        {
+            BOOL bFound = FALSE;
+            UINT uFeatures = shader->GetFeatures();
+            for (UINT uVariantKey = uFeatures; ; uVariantKey = (uVariantKey - 1u) & uFeatures)
+            {
+                auto iRecord = shaderRecords.find(ComputeShaderCacheKey(shader->GetCompileDesc(uVariantKey)));
+                if (iRecord != shaderRecords.end() && iRecord->second->uVariantKey == uVariantKey)
+                {
+                    aVariants.push_back({ shader, iRecord->second });
+                    bFound = TRUE;
+                }
+
+                if (uVariantKey == 0u)
+                {
+                    break;
+                }
+            }
+
+            if (!bFound)
+            {
+                return FALSE;
+            }
+        }
+
+        std::filesystem::path snapshotPath = GetSceneSnapshotPath(m_filePath);
+        for (const auto& [model, pRecord] : aMeshes)
+        {
+            model->SetSnapshotSource(snapshotPath, m_snapshot.GetBlobFileOffset(pRecord->ullBlobOffset), static_cast<SIZE_T>(pRecord->ullBlobSize), pRecord->Key);
+        }
+
+        // A variant that can't be taken is compiled as usual
+        for (const auto& [shader, pRecord] : aVariants)
+        {
+            shader->AddPrecompiledVariant(pRecord->uVariantKey, m_snapshot.GetBlob(pRecord->ullBlobOffset, pRecord->ullBlobSize), static_cast<SIZE_T>(pRecord->ullBlobSize));
+        }
+
+        // Textures the snapshot does not hold, e.g. ones WIC decodes,
+        // are read from their files
+        const SnapshotTexture* aTextures = m_snapshot.GetSection<SnapshotTexture>(SceneSnapshotSection::Textures, uCount);
+        for (UINT i = 0u; i < uCount; ++i)
+        {
+            if (m_snapshot.GetBlob(aTextures[i].ullBlobOffset, aTextures[i].ullBlobSize))
+            {
+                AssetManager::GetDefault().SetTextureSource(
+                    std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(m_snapshot.GetString(aTextures[i].uPath)))),
+                    snapshotPath,
+                    m_snapshot.GetBlobFileOffset(aTextures[i].ullBlobOffset),
+                    static_cast<SIZE_T>(aTextures[i].ullBlobSize)
+                );
+            }
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::saveSnapshot
+
+      Summary:  Writes the snapshot of the loaded scene: the block
+                colors and voxels of the scene file, the cooked meshes
+                of the models, the DDS bytes of the textures, the
+                bytecode of the shader variants, the lights and the
+                transforms, with the size and write time of every file
+                they came from. Assets whose files can't be read are
+                left out, the next start then loads cold again
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::saveSnapshot()
+    {
+        SceneSnapshotWriter writer;
+        HRESULT hr = writer.AddInput(m_filePath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        std::vector<XMFLOAT4> aBlockColors;
+        aBlockColors.reserve(NUM_BLOCK_TYPES);
+        for (UINT i = 0u; i < NUM_BLOCK_TYPES; ++i)
+        {
+            aBlockColors.push_back(m_blockMaterials.GetMaterial(static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + i)).Color);
+        }
+        writer.SetSection(SceneSnapshotSection::BlockColors, aBlockColors);
+
+        std::vector<SnapshotVoxel> aVoxels;
+        std::vector<InstanceData> aInstances;
+        for (size_t i = 0u; i < m_uNumFileVoxels; ++i)
+        {
+            const std::vector<InstanceData>& aInstanceData = m_voxels[i]->GetInstanceData();
+            aVoxels.push_back(
+                SnapshotVoxel
+                {
+                    .OutputColor = m_voxels[i]->GetOutputColor(),
+                    .uFirstInstance = static_cast<UINT>(aInstances.size()),
+                    .uNumInstances = static_cast<UINT>(aInstanceData.size())
+                }
+            );
+            aInstances.insert(aInstances.end(), aInstanceData.begin(), aInstanceData.end());
+        }
+        writer.SetSection(SceneSnapshotSection::Voxels, aVoxels);
+        writer.SetSection(SceneSnapshotSection::Instances, aInstances);
+
+        std::vector<std::shared_ptr<Model>> aModels;
+        for (const auto& [szName, model] : m_models)
+        {
+            aModels.push_back(model);
+        }
+        if (m_skyBox)
+        {
+            aModels.push_back(m_skyBox);
+        }
+
+        std::vector<SnapshotMesh> aMeshes;
+        for (const std::shared_ptr<Model>& model : aModels)
+        {
+            std::filesystem::path cookedPath = model->GetCookedMeshPath();
+            MeshCacheReader reader;
+            MappedFile meshFile;
+            if (FAILED(reader.Open(cookedPath, model->GetCookedMeshKey())) ||
+                FAILED(meshFile.Open(cookedPath)) ||
+                FAILED(writer.AddInput(model->GetFilePath())))
+            {
+                continue;
+            }
+
+            aMeshes.push_back(
+                SnapshotMesh
+                {
+                    .Key = model->GetCookedMeshKey(),
+                    .ullBlobOffset = writer.AddBlob(meshFile.GetData(), meshFile.GetSize()),
+                    .ullBlobSize = meshFile.GetSize(),
+                    .uPath = writer.AddString(toUtf8(AssetManager::GetCanonicalPath(cookedPath)))
+                }
+            );
+        }
+        writer.SetSection(SceneSnapshotSection::Meshes, aMeshes);
+
+        // Only DDS bytes are ready to be created, images WIC decodes
+        // are left to their files
+        std::vector<SnapshotTexture> aTextures;
+        for (const std::shared_ptr<Texture>& texture : AssetManager::GetDefault().GetTextures())
+        {
+            const std::filesystem::path& sourcePath = texture->GetFilePath();
+            std::filesystem::path readPath = IsCookedTextureCurrent(sourcePath) ? GetCookedTexturePath(sourcePath) : sourcePath;
+            MappedFile textureFile;
+            if (FAILED(textureFile.Open(readPath)) ||
+                textureFile.GetSize() < sizeof(DDS_MAGIC_NUMBER) ||
+                *reinterpret_cast<const UINT*>(textureFile.GetData()) != DDS_MAGIC_NUMBER ||
+                FAILED(writer.AddInput(sourcePath)) ||
+                FAILED(writer.AddInput(readPath)))
+            {
+                continue;
+            }
+
+            aTextures.push_back(
+                SnapshotTexture
+                {
+                    .ullBlobOffset = writer.AddBlob(textureFile.GetData(), textureFile.GetSize()),
+                    .ullBlobSize = textureFile.GetSize(),
+                    .uPath = writer.AddString(toUtf8(AssetManager::GetCanonicalPath(sourcePath)))
+                }
+            );
+        }
+        writer.SetSection(SceneSnapshotSection::Textures, aTextures);
+
+        std::vector<std::shared_ptr<Shader>> aShaders;
+        for (const auto& [szName, vertexShader] : m_vertexShaders)
+        {
+            aShaders.push_back(vertexShader);
+        }
+        for (const auto& [szName, pixelShader] : m_pixelShaders)
+        {
+            aShaders.push_back(pixelShader);
+        }
+
+        std::vector<SnapshotShader> aShaderRecords;
+        for (const std::shared_ptr<Shader>& shader : aShaders)
+        {
+            for (const auto& [uVariantKey, blob] : shader->GetPrecompiledVariants())
+            {
+                // The cache entry names the includes the bytecode
+                // depends on, they are inputs as much as the source
+                ShaderCompileDesc desc = shader->GetCompileDesc(uVariantKey);
+                std::vector<std::filesystem::path> aIncludes;
+                if (FAILED(ShaderCache::GetDefault().GetIncludes(desc, aIncludes)) || FAILED(writer.AddInput(desc.FilePath)))
+                {
+                    continue;
+                }
+
+                BOOL bStamped = TRUE;
+                for (const std::filesystem::path& includePath : aIncludes)
+                {
+                    bStamped = bStamped && SUCCEEDED(writer.AddInput(desc.FilePath.parent_path() / includePath));
+                }
+                if (!bStamped)
+                {
+                    continue;
+                }
+
+                aShaderRecords.push_back(
+                    SnapshotShader
+                    {
+                        .ullCompileKey = ComputeShaderCacheKey(desc),
+                        .ullBlobOffset = writer.AddBlob(blob->GetBufferPointer(), blob->GetBufferSize()),
+                        .ullBlobSize = blob->GetBufferSize(),
+                        .uVariantKey = uVariantKey
+                    }
+                );
+            }
+        }
+        writer.SetSection(SceneSnapshotSection::Shaders, aShaderRecords);
+
+        writer.SetSection(SceneSnapshotSection::Lights, getSnapshotLights());
+
+        std::vector<SnapshotTransform> aTransforms;
+        for (const auto& [szName, world] : getSnapshotTransforms())
+        {
+            aTransforms.push_back(SnapshotTransform{ .World = world, .uName = writer.AddString(szName) });
+        }
+        writer.SetSection(SceneSnapshotSection::Transforms, aTransforms);
+
+        return writer.Save(GetSceneSnapshotPath(m_filePath));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getSnapshotLights
+
+      Summary:  Returns the point lights as snapshot records
+
+      Returns:  std::vector<SnapshotLight>
+                  Records of the lights set, in index order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<SnapshotLight> Scene::getSnapshotLights() const
+    {
+        std::vector<SnapshotLight> aLights;
+        for (UINT i = 0u; i < NUM_LIGHTS; ++i)
+        {
+            if (m_aPointLights[i])
+            {
+                aLights.push_back(
+                    SnapshotLight
+                    {
+                        .Position = m_aPointLights[i]->GetPosition(),
+                        .Color = m_aPointLights[i]->GetColor(),
+                        .AttenuationDistance = m_aPointLights[i]->GetAttenuationDistance(),
+                        .uIndex = i
+                    }
+                );
+            }
+        }
+
+        return aLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getSnapshotTransforms
+
+      Summary:  Returns the local matrices of the renderables and the
+                models with their names
+
+      Returns:  std::vector<std::pair<std::string, XMFLOAT4X4>>
+                  Names and local matrices, the renderables then the
+                  models, each sorted by name
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::pair<std::string, XMFLOAT4X4>> Scene::getSnapshotTransforms() const
+    {
+        std::vector<std::pair<std::string, XMFLOAT4X4>> aRenderableTransforms;
+        for (const auto& [szName, renderable] : m_renderables)
+        {
+            XMFLOAT4X4 world;
+            XMStoreFloat4x4(&world, renderable->GetLocalMatrix());
+            aRenderableTransforms.push_back({ toUtf8(szName), world });
+        }
+
+        std::vector<std::pair<std::string, XMFLOAT4X4>> aModelTransforms;
+        for (const auto& [szName, model] : m_models)
+        {
+            XMFLOAT4X4 world;
+            XMStoreFloat4x4(&world, model->GetLocalMatrix());
+            aModelTransforms.push_back({ toUtf8(szName), world });
+        }
+
+        auto byName = [](const auto& a, const auto& b) { return a.first < b.first; };
+        std::sort(aRenderableTransforms.begin(), aRenderableTransforms.end(), byName);
+        std::sort(aModelTransforms.begin(), aModelTransforms.end(), byName);
+        aRenderableTransforms.insert(aRenderableTransforms.end(), aModelTransforms.begin(), aModelTransforms.end());
+
+        return aRenderableTransforms;
+    }
+
     FLOAT Scene::getNoise2(UINT x, UINT y)
     {
         UINT temp = ms_aHashes[y % 256u];
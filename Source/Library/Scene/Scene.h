@@ -19,7 +19,12 @@
 #include "Light/PointLight.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Scene/BlockMaterialRegistry.h"
+#include "Scene/BlockMaterialTextures.h"
+#include "Scene/SceneSnapshot.h"
+#include "Scene/TransformHierarchy.h"
 #include "Scene/Voxel.h"
+#include "Utility/LoadGraph.h"
 
 namespace library
 {
@@ -28,7 +33,7 @@ namespace library
     public:
         static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
 
-        Scene(const std::filesystem::path& filePath);
+        Scene(const std::filesystem::path& filePath, _In_opt_ BOOL bUseSnapshot = TRUE);
         Scene(const Scene& other) = delete;
         Scene(Scene&& other) = delete;
         Scene& operator=(const Scene& other) = delete;
@@ -36,6 +41,8 @@ namespace library
         virtual ~Scene() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        void SetNumLoadingThreads(_In_ UINT uNumThreads);
+        void SetLoadProgressCallback(_In_ LoadGraph::ProgressCallback progressCallback);
 
         HRESULT AddVoxel(_In_ const std::shared_ptr<Voxel>& voxel);
         HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable);
@@ -49,6 +56,8 @@ namespace library
         void Update(_In_ FLOAT deltaTime);
 
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+        BlockMaterialRegistry& GetBlockMaterials();
+        BlockMaterialTextures& GetBlockMaterialTextures();
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
         std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
         std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
@@ -66,7 +75,20 @@ namespace library
         HRESULT SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName);
 
+        HRESULT AttachRenderable(_In_ PCWSTR pszName, _In_ PCWSTR pszParentName);
+        HRESULT AttachPointLight(_In_ size_t index, _In_ PCWSTR pszParentName);
+
     private:
+        std::shared_ptr<Renderable> findTransformable(_In_ PCWSTR pszName) const;
+        UINT getTransformNode(_In_ const std::shared_ptr<Renderable>& renderable);
+
+        void parseFile();
+        HRESULT loadSnapshotVoxels();
+        BOOL applySnapshot();
+        HRESULT saveSnapshot();
+        std::vector<SnapshotLight> getSnapshotLights() const;
+        std::vector<std::pair<std::string, XMFLOAT4X4>> getSnapshotTransforms() const;
+
         static FLOAT getNoise2(UINT x, UINT y);
         static FLOAT getNoise2d(FLOAT x, FLOAT y);
         static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
@@ -92,6 +114,8 @@ namespace library
     private:
         std::filesystem::path m_filePath;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
+        BlockMaterialRegistry m_blockMaterials;
+        BlockMaterialTextures m_blockMaterialTextures;
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
         std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
         std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
@@ -99,5 +123,14 @@ namespace library
         std::unordered_map<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders;
         std::unordered_map<std::wstring, std::shared_ptr<Material>> m_materials;
         std::shared_ptr<Skybox> m_skyBox;
+        UINT m_uNumLoadingThreads;
+        LoadGraph::ProgressCallback m_loadProgressCallback;
+        BOOL m_bUseSnapshot;
+        SceneSnapshotReader m_snapshot;
+        size_t m_uNumFileVoxels;
+        TransformHierarchy m_transforms;
+        std::unordered_map<const Renderable*, UINT> m_transformNodes;
+        std::vector<std::shared_ptr<Renderable>> m_aNodeRenderables;
+        std::vector<std::pair<UINT, UINT>> m_aLightNodes;
     };
 }
\ No newline at end of file
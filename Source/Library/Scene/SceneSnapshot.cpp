@@ -0,0 +1,474 @@
+#include "Scene/SceneSnapshot.h"
+
+#include <fstream>
+
+namespace library
+{
+    constexpr const UINT64 SCENE_SNAPSHOT_SECTION_ALIGNMENT = 16ull;
+
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: stampFile
+
+          Summary:  Reads the size and last write time of a file, which
+                    tell a changed input without reading it
+
+          Args:     const std::filesystem::path& filePath
+                      Path to the file
+                    UINT64& ullOutSize
+                      Receives the size in bytes
+                    INT64& llOutWriteTime
+                      Receives the last write time, in file clock ticks
+
+          Returns:  HRESULT
+                      Status code, fails if the file is missing
+        -----------------------------------------------------------------F-F*/
+        HRESULT stampFile(_In_ const std::filesystem::path& filePath, _Out_ UINT64& ullOutSize, _Out_ INT64& llOutWriteTime)
+        {
+            ullOutSize = 0ull;
+            llOutWriteTime = 0ll;
+
+            std::error_code error;
+            UINT64 ullSize = std::filesystem::file_size(filePath, error);
+            if (error)
+            {
+                return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+            }
+
+            std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(filePath, error);
+            if (error)
+            {
+                return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+            }
+
+            ullOutSize = ullSize;
+            llOutWriteTime = static_cast<INT64>(writeTime.time_since_epoch().count());
+            return S_OK;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetSceneSnapshotPath
+
+      Summary:  Returns the path of the snapshot of a scene, next to
+                the scene file
+
+      Args:     const std::filesystem::path& scenePath
+                  Path to the scene file
+
+      Returns:  std::filesystem::path
+                  Path to the snapshot
+    -----------------------------------------------------------------F-F*/
+    std::filesystem::path GetSceneSnapshotPath(_In_ const std::filesystem::path& scenePath)
+    {
+        std::filesystem::path snapshotPath = scenePath;
+        snapshotPath += ".snapshot";
+
+        return snapshotPath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotWriter::SceneSnapshotWriter
+
+      Summary:  Constructor
+
+      Modifies: [m_aSections, m_inputs].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SceneSnapshotWriter::SceneSnapshotWriter()
+        : m_aSections()
+        , m_inputs()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotWriter::SetSection
+
+      Summary:  Copies the data of a section, replacing what it held
+
+      Args:     SceneSnapshotSection section
+                  Section to set
+                const void* pData
+                  Data of the section
+                SIZE_T uSize
+                  Size of the data in bytes
+
+      Modifies: [m_aSections].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SceneSnapshotWriter::SetSection(_In_ SceneSnapshotSection section, _In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize)
+    {
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        m_aSections[static_cast<UINT>(section)].assign(pBytes, pBytes + uSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotWriter::AddString
+
+      Summary:  Appends a null terminated string to the Strings section
+
+      Args:     const std::string& szString
+                  String to add
+
+      Modifies: [m_aSections].
+
+      Returns:  UINT
+                  Offset of the string in the Strings section
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SceneSnapshotWriter::AddString(_In_ const std::string& szString)
+    {
+        std::vector<BYTE>& aStrings = m_aSections[static_cast<UINT>(SceneSnapshotSection::Strings)];
+        UINT uOffset = static_cast<UINT>(aStrings.size());
+        aStrings.insert(aStrings.end(), szString.begin(), szString.end());
+        aStrings.push_back('\0');
+
+        return uOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotWriter::AddBlob
+
+      Summary:  Appends bytes to the Blobs section at a 16 byte aligned
+                offset, so the sections of an embedded cooked mesh stay
+                aligned when mapped
+
+      Args:     const void* pData
+                  Bytes to add
+                SIZE_T uSize
+                  Number of bytes
+
+      Modifies: [m_aSections].
+
+      Returns:  UINT64
+                  Offset of the blob in the Blobs section
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 SceneSnapshotWriter::AddBlob(_In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize)
+    {
+        std::vector<BYTE>& aBlobs = m_aSections[static_cast<UINT>(SceneSnapshotSection::Blobs)];
+        UINT64 ullOffset = (aBlobs.size() + SCENE_SNAPSHOT_SECTION_ALIGNMENT - 1ull) & ~(SCENE_SNAPSHOT_SECTION_ALIGNMENT - 1ull);
+        aBlobs.resize(static_cast<SIZE_T>(ullOffset), 0u);
+
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        aBlobs.insert(aBlobs.end(), pBytes, pBytes + uSize);
+
+        return ullOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotWriter::AddInput
+
+      Summary:  Records a file the snapshot is made from with its size
+                and write time. The snapshot is stale once any of them
+                changes. A file added twice is recorded once
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file, as the loader opens it
+
+      Modifies: [m_aSections, m_inputs].
+
+      Returns:  HRESULT
+                  Status code, fails if the file is missing
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneSnapshotWriter::AddInput(_In_ const std::filesystem::path& filePath)
+    {
+        std::u8string szPath = filePath.lexically_normal().generic_u8string();
+        std::string szInput(szPath.begin(), szPath.end());
+        if (m_inputs.contains(szInput))
+        {
+            return S_OK;
+        }
+
+        SnapshotInput input = {};
+        HRESULT hr = stampFile(filePath, input.ullSize, input.llWriteTime);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        input.uPath = AddString(szInput);
+
+        std::vector<BYTE>& aInputs = m_aSections[static_cast<UINT>(SceneSnapshotSection::Inputs)];
+        const BYTE* pInput = reinterpret_cast<const BYTE*>(&input);
+        aInputs.insert(aInputs.end(), pInput, pInput + sizeof(input));
+        m_inputs.insert(std::move(szInput));
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotWriter::Save
+
+      Summary:  Writes the header and the aligned sections. The file is
+                written under a temporary name of the calling thread and
+                renamed at the end, so a snapshot is never seen half
+                written
+
+      Args:     const std::filesystem::path& snapshotPath
+                  Path to write to
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneSnapshotWriter::Save(_In_ const std::filesystem::path& snapshotPath) const
+    {
+        SceneSnapshotHeader header =
+        {
+            .uMagic = SCENE_SNAPSHOT_MAGIC,
+            .uVersion = SCENE_SNAPSHOT_VERSION,
+            .uMeshCacheVersion = MESH_CACHE_VERSION,
+            .uInstanceDataSize = sizeof(InstanceData),
+            .uNumBlockTypes = NUM_BLOCK_TYPES,
+            .uNumLights = NUM_LIGHTS,
+            .aSections = {}
+        };
+
+        UINT64 ullOffset = sizeof(SceneSnapshotHeader);
+        for (UINT i = 0u; i < static_cast<UINT>(SceneSnapshotSection::Count); ++i)
+        {
+            ullOffset = (ullOffset + SCENE_SNAPSHOT_SECTION_ALIGNMENT - 1ull) & ~(SCENE_SNAPSHOT_SECTION_ALIGNMENT - 1ull);
+            header.aSections[i].ullOffset = ullOffset;
+            header.aSections[i].ullSize = m_aSections[i].size();
+            ullOffset += m_aSections[i].size();
+        }
+
+        std::filesystem::path tempPath = snapshotPath;
+        tempPath += L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+        {
+            std::ofstream snapshotFile(tempPath, std::ios::binary | std::ios::trunc);
+            if (!snapshotFile.is_open())
+            {
+                return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+            }
+
+            const CHAR aPadding[SCENE_SNAPSHOT_SECTION_ALIGNMENT] = {};
+            snapshotFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+            UINT64 ullWritten = sizeof(header);
+            for (UINT i = 0u; i < static_cast<UINT>(SceneSnapshotSection::Count); ++i)
+            {
+                snapshotFile.write(aPadding, static_cast<std::streamsize>(header.aSections[i].ullOffset - ullWritten));
+                snapshotFile.write(reinterpret_cast<const CHAR*>(m_aSections[i].data()), static_cast<std::streamsize>(m_aSections[i].size()));
+                ullWritten = header.aSections[i].ullOffset + header.aSections[i].ullSize;
+            }
+
+            if (!snapshotFile.good())
+            {
+                snapshotFile.close();
+                std::error_code error;
+                std::filesystem::remove(tempPath, error);
+                return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, snapshotPath, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::SceneSnapshotReader
+
+      Summary:  Constructor
+
+      Modifies: [m_file, m_pHeader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SceneSnapshotReader::SceneSnapshotReader()
+        : m_file()
+        , m_pHeader(nullptr)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::Open
+
+      Summary:  Maps a scene snapshot and checks that it was written by
+                this version with the same record layouts, that every
+                section lies within the file and that the strings are
+                terminated. Does not check the inputs, see IsCurrent
+
+      Args:     const std::filesystem::path& snapshotPath
+                  Path to the snapshot
+
+      Modifies: [m_file, m_pHeader].
+
+      Returns:  HRESULT
+                  Status code, HRESULT_FROM_WIN32(ERROR_FILE_INVALID)
+                  if the snapshot is of another version or corrupt
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneSnapshotReader::Open(_In_ const std::filesystem::path& snapshotPath)
+    {
+        m_pHeader = nullptr;
+
+        HRESULT hr = m_file.Open(snapshotPath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        if (m_file.GetSize() < sizeof(SceneSnapshotHeader))
+        {
+            m_file.Close();
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+
+        const SceneSnapshotHeader* pHeader = reinterpret_cast<const SceneSnapshotHeader*>(m_file.GetData());
+        if (pHeader->uMagic != SCENE_SNAPSHOT_MAGIC ||
+            pHeader->uVersion != SCENE_SNAPSHOT_VERSION ||
+            pHeader->uMeshCacheVersion != MESH_CACHE_VERSION ||
+            pHeader->uInstanceDataSize != sizeof(InstanceData) ||
+            pHeader->uNumBlockTypes != NUM_BLOCK_TYPES ||
+            pHeader->uNumLights != NUM_LIGHTS)
+        {
+            m_file.Close();
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+
+        for (UINT i = 0u; i < static_cast<UINT>(SceneSnapshotSection::Count); ++i)
+        {
+            const MeshCacheSectionEntry& entry = pHeader->aSections[i];
+            if (entry.ullOffset > m_file.GetSize() || entry.ullSize > m_file.GetSize() - entry.ullOffset ||
+                entry.ullOffset % SCENE_SNAPSHOT_SECTION_ALIGNMENT != 0ull)
+            {
+                m_file.Close();
+                return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+            }
+        }
+
+        const MeshCacheSectionEntry& strings = pHeader->aSections[static_cast<UINT>(SceneSnapshotSection::Strings)];
+        if (strings.ullSize > 0ull && m_file.GetData()[strings.ullOffset + strings.ullSize - 1ull] != '\0')
+        {
+            m_file.Close();
+            return HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+        }
+
+        m_pHeader = pHeader;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::Close
+
+      Summary:  Unmaps the snapshot. Pointers into it are invalidated
+
+      Modifies: [m_file, m_pHeader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SceneSnapshotReader::Close()
+    {
+        m_pHeader = nullptr;
+        m_file.Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::IsOpen
+
+      Summary:  Returns whether a valid snapshot is mapped
+
+      Returns:  BOOL
+                  TRUE if Open succeeded and Close was not called since
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SceneSnapshotReader::IsOpen() const
+    {
+        return m_pHeader != nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::IsCurrent
+
+      Summary:  Returns whether every file the snapshot was made from
+                still has the size and write time it had then. Only
+                stats the files, none is read
+
+      Returns:  BOOL
+                  TRUE if no input changed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SceneSnapshotReader::IsCurrent() const
+    {
+        UINT uNumInputs = 0u;
+        const SnapshotInput* aInputs = GetSection<SnapshotInput>(SceneSnapshotSection::Inputs, uNumInputs);
+        for (UINT i = 0u; i < uNumInputs; ++i)
+        {
+            PCSTR pszPath = GetString(aInputs[i].uPath);
+            std::filesystem::path inputPath(std::u8string(reinterpret_cast<const char8_t*>(pszPath)));
+
+            UINT64 ullSize = 0ull;
+            INT64 llWriteTime = 0ll;
+            if (FAILED(stampFile(inputPath, ullSize, llWriteTime)) ||
+                ullSize != aInputs[i].ullSize ||
+                llWriteTime != aInputs[i].llWriteTime)
+            {
+                return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::GetString
+
+      Summary:  Returns a string of the Strings section
+
+      Args:     UINT uOffset
+                  Offset of the string
+
+      Returns:  PCSTR
+                  String in the mapped file, empty when out of range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCSTR SceneSnapshotReader::GetString(_In_ UINT uOffset) const
+    {
+        const MeshCacheSectionEntry& strings = m_pHeader->aSections[static_cast<UINT>(SceneSnapshotSection::Strings)];
+        if (uOffset >= strings.ullSize)
+        {
+            return "";
+        }
+
+        return reinterpret_cast<PCSTR>(m_file.GetData() + strings.ullOffset + uOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::GetBlob
+
+      Summary:  Returns the bytes of a blob in the mapped file
+
+      Args:     UINT64 ullOffset
+                  Offset of the blob in the Blobs section
+                UINT64 ullSize
+                  Size of the blob in bytes
+
+      Returns:  const BYTE*
+                  First byte of the blob, nullptr if the blob is empty
+                  or does not lie within the Blobs section
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BYTE* SceneSnapshotReader::GetBlob(_In_ UINT64 ullOffset, _In_ UINT64 ullSize) const
+    {
+        const MeshCacheSectionEntry& blobs = m_pHeader->aSections[static_cast<UINT>(SceneSnapshotSection::Blobs)];
+        if (ullSize == 0ull || ullOffset > blobs.ullSize || ullSize > blobs.ullSize - ullOffset)
+        {
+            return nullptr;
+        }
+
+        return m_file.GetData() + blobs.ullOffset + ullOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneSnapshotReader::GetBlobFileOffset
+
+      Summary:  Returns where a blob starts in the snapshot file, for
+                loaders that map the range on their own
+
+      Args:     UINT64 ullOffset
+                  Offset of the blob in the Blobs section
+
+      Returns:  UINT64
+                  Offset of the blob from the start of the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 SceneSnapshotReader::GetBlobFileOffset(_In_ UINT64 ullOffset) const
+    {
+        return m_pHeader->aSections[static_cast<UINT>(SceneSnapshotSection::Blobs)].ullOffset + ullOffset;
+    }
+}
@@ -0,0 +1,238 @@
+/*+===================================================================
+  File:      SCENESNAPSHOT.H
+
+  Summary:   SceneSnapshot header file contains the layout of scene
+             snapshot files and the classes writing and memory mapping
+             them. A snapshot holds the CPU side state a scene prepares
+             while loading: voxel instances, cooked meshes, cooked
+             textures, shader bytecode, lights and transforms, so a
+             warm start maps one file instead of parsing, importing,
+             decoding and compiling.
+
+  Classes: SceneSnapshotWriter, SceneSnapshotReader
+
+  Functions: GetSceneSnapshotPath
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Model/MeshCache.h"
+#include "Renderer/DataTypes.h"
+#include "Utility/MappedFile.h"
+
+#include <unordered_set>
+
+namespace library
+{
+    constexpr const UINT SCENE_SNAPSHOT_MAGIC = 0x50414E53u; // "SNAP"
+    constexpr const UINT SCENE_SNAPSHOT_VERSION = 1u;
+
+    enum class SceneSnapshotSection : UINT
+    {
+        Inputs,
+        BlockColors,
+        Voxels,
+        Instances,
+        Meshes,
+        Textures,
+        Shaders,
+        Lights,
+        Transforms,
+        Strings,
+        Blobs,
+        Count
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SceneSnapshotHeader
+
+      Summary:  First bytes of a scene snapshot. Section offsets are
+                relative to the start of the file and 16 byte aligned.
+                The versions and sizes of the embedded formats are
+                checked, since their records are used in place
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SceneSnapshotHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        UINT uMeshCacheVersion;
+        UINT uInstanceDataSize;
+        UINT uNumBlockTypes;
+        UINT uNumLights;
+        MeshCacheSectionEntry aSections[static_cast<UINT>(SceneSnapshotSection::Count)];
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SnapshotInput, SnapshotVoxel, SnapshotMesh,
+                SnapshotTexture, SnapshotShader, SnapshotLight,
+                SnapshotTransform
+
+      Summary:  Fixed size records of the snapshot sections. Paths and
+                names are offsets into the Strings section, blob
+                offsets are relative to the Blobs section and 16 byte
+                aligned, instance ranges index the Instances section.
+                An input is a file the snapshot was made from, with the
+                size and write time it had then
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SnapshotInput
+    {
+        UINT64 ullSize;
+        INT64 llWriteTime;
+        UINT uPath;
+    };
+
+    struct SnapshotVoxel
+    {
+        XMFLOAT4 OutputColor;
+        UINT uFirstInstance;
+        UINT uNumInstances;
+    };
+
+    struct SnapshotMesh
+    {
+        MeshCacheKey Key;
+        UINT64 ullBlobOffset;
+        UINT64 ullBlobSize;
+        UINT uPath;
+    };
+
+    struct SnapshotTexture
+    {
+        UINT64 ullBlobOffset;
+        UINT64 ullBlobSize;
+        UINT uPath;
+    };
+
+    struct SnapshotShader
+    {
+        UINT64 ullCompileKey;
+        UINT64 ullBlobOffset;
+        UINT64 ullBlobSize;
+        UINT uVariantKey;
+    };
+
+    struct SnapshotLight
+    {
+        XMFLOAT4 Position;
+        XMFLOAT4 Color;
+        FLOAT AttenuationDistance;
+        UINT uIndex;
+    };
+
+    struct SnapshotTransform
+    {
+        XMFLOAT4X4 World;
+        UINT uName;
+    };
+
+    std::filesystem::path GetSceneSnapshotPath(_In_ const std::filesystem::path& scenePath);
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SceneSnapshotWriter
+
+      Summary:  Gathers the sections of a scene snapshot and writes them
+
+      Methods:  SetSection
+                  Copies the data of a section
+                AddString
+                  Appends a string to the Strings section
+                AddBlob
+                  Appends aligned bytes to the Blobs section
+                AddInput
+                  Records the size and write time of a source file
+                Save
+                  Writes the snapshot file
+                SceneSnapshotWriter
+                  Constructor.
+                ~SceneSnapshotWriter
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SceneSnapshotWriter final
+    {
+    public:
+        SceneSnapshotWriter();
+        SceneSnapshotWriter(const SceneSnapshotWriter& other) = delete;
+        SceneSnapshotWriter(SceneSnapshotWriter&& other) = delete;
+        SceneSnapshotWriter& operator=(const SceneSnapshotWriter& other) = delete;
+        SceneSnapshotWriter& operator=(SceneSnapshotWriter&& other) = delete;
+        ~SceneSnapshotWriter() = default;
+
+        void SetSection(_In_ SceneSnapshotSection section, _In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize);
+        template <typename T>
+        void SetSection(_In_ SceneSnapshotSection section, _In_ const std::vector<T>& aData)
+        {
+            SetSection(section, aData.data(), aData.size() * sizeof(T));
+        }
+        UINT AddString(_In_ const std::string& szString);
+        UINT64 AddBlob(_In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize);
+        HRESULT AddInput(_In_ const std::filesystem::path& filePath);
+
+        HRESULT Save(_In_ const std::filesystem::path& snapshotPath) const;
+
+    private:
+        std::vector<BYTE> m_aSections[static_cast<UINT>(SceneSnapshotSection::Count)];
+        std::unordered_set<std::string> m_inputs;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SceneSnapshotReader
+
+      Summary:  Memory maps a scene snapshot and hands out typed views
+                of its sections and blobs without parsing them
+
+      Methods:  Open
+                  Maps and validates a snapshot file
+                Close
+                  Unmaps the snapshot
+                IsOpen
+                  Returns whether a snapshot is mapped
+                IsCurrent
+                  Returns whether every input is as it was when the
+                  snapshot was written
+                GetSection
+                  Returns a typed view of a section
+                GetString
+                  Returns a string of the Strings section
+                GetBlob
+                  Returns the bytes of a blob
+                GetBlobFileOffset
+                  Returns where a blob starts in the file
+                SceneSnapshotReader
+                  Constructor.
+                ~SceneSnapshotReader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SceneSnapshotReader final
+    {
+    public:
+        SceneSnapshotReader();
+        SceneSnapshotReader(const SceneSnapshotReader& other) = delete;
+        SceneSnapshotReader(SceneSnapshotReader&& other) = delete;
+        SceneSnapshotReader& operator=(const SceneSnapshotReader& other) = delete;
+        SceneSnapshotReader& operator=(SceneSnapshotReader&& other) = delete;
+        ~SceneSnapshotReader() = default;
+
+        HRESULT Open(_In_ const std::filesystem::path& snapshotPath);
+        void Close();
+        BOOL IsOpen() const;
+        BOOL IsCurrent() const;
+
+        template <typename T>
+        const T* GetSection(_In_ SceneSnapshotSection section, _Out_ UINT& uOutCount) const
+        {
+            const MeshCacheSectionEntry& entry = m_pHeader->aSections[static_cast<UINT>(section)];
+            uOutCount = static_cast<UINT>(entry.ullSize / sizeof(T));
+            return reinterpret_cast<const T*>(m_file.GetData() + entry.ullOffset);
+        }
+        PCSTR GetString(_In_ UINT uOffset) const;
+        const BYTE* GetBlob(_In_ UINT64 ullOffset, _In_ UINT64 ullSize) const;
+        UINT64 GetBlobFileOffset(_In_ UINT64 ullOffset) const;
+
+    private:
+        MappedFile m_file;
+        const SceneSnapshotHeader* m_pHeader;
+    };
+}
@@ -0,0 +1,506 @@
+#include "Scene/TransformHierarchy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::TransformHierarchy
+
+      Summary:  Constructor
+
+      Modifies: [m_aTranslations, m_aRotations, m_aScales,
+                 m_aLocalMatrices, m_aParents, m_aWorldMatrices, m_aDirty,
+                 m_aUpdateFrames, m_aDepths, m_aLevelOrder, m_aLevelStarts,
+                 m_bLevelsDirty, m_uFirstDirtyLevel, m_uFrame,
+                 m_uNumUpdatedNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformHierarchy::TransformHierarchy()
+        : m_aTranslations()
+        , m_aRotations()
+        , m_aScales()
+        , m_aLocalMatrices()
+        , m_aParents()
+        , m_aWorldMatrices()
+        , m_aDirty()
+        , m_aUpdateFrames()
+        , m_aDepths()
+        , m_aLevelOrder()
+        , m_aLevelStarts()
+        , m_bLevelsDirty(FALSE)
+        , m_uFirstDirtyLevel(UINT_MAX)
+        , m_uFrame(0u)
+        , m_uNumUpdatedNodes(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::AddNode
+
+      Summary:  Adds a node with the identity as its local transform
+
+      Args:     INT iParent
+                  Parent node, INVALID_NODE for a root
+
+      Modifies: [m_aTranslations, m_aRotations, m_aScales,
+                 m_aLocalMatrices, m_aParents, m_aWorldMatrices, m_aDirty,
+                 m_aUpdateFrames, m_aDepths, m_bLevelsDirty,
+                 m_uFirstDirtyLevel].
+
+      Returns:  UINT
+                  Index of the node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::AddNode(_In_opt_ INT iParent)
+    {
+        assert(iParent == INVALID_NODE || static_cast<UINT>(iParent) < m_aParents.size());
+
+        UINT uNode = static_cast<UINT>(m_aParents.size());
+        m_aTranslations.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+        m_aRotations.push_back(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+        m_aScales.push_back(XMFLOAT3(1.0f, 1.0f, 1.0f));
+        m_aLocalMatrices.push_back(XMFLOAT4X4A());
+        XMStoreFloat4x4A(&m_aLocalMatrices.back(), XMMatrixIdentity());
+        m_aParents.push_back(iParent);
+        m_aWorldMatrices.push_back(XMFLOAT4X4A());
+        XMStoreFloat4x4A(&m_aWorldMatrices.back(), XMMatrixIdentity());
+        m_aDirty.push_back(FALSE);
+        m_aUpdateFrames.push_back(0u);
+        m_aDepths.push_back(0u);
+
+        m_bLevelsDirty = TRUE;
+        markDirty(uNode);
+
+        return uNode;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetParent
+
+      Summary:  Moves a node, with its subtree, under another node or to
+                the roots. The local transform is kept, so the subtree
+                moves with its new parent
+
+      Args:     UINT uNode
+                  Node to move
+                INT iParent
+                  New parent, INVALID_NODE for a root
+
+      Modifies: [m_aParents, m_aDirty, m_bLevelsDirty,
+                 m_uFirstDirtyLevel].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if a node is out of range or
+                  the parent is in the subtree of the node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TransformHierarchy::SetParent(_In_ UINT uNode, _In_ INT iParent)
+    {
+        if (uNode >= m_aParents.size() || (iParent != INVALID_NODE && static_cast<UINT>(iParent) >= m_aParents.size()))
+        {
+            return E_INVALIDARG;
+        }
+
+        for (INT iAncestor = iParent; iAncestor != INVALID_NODE; iAncestor = m_aParents[iAncestor])
+        {
+            if (static_cast<UINT>(iAncestor) == uNode)
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        if (m_aParents[uNode] != iParent)
+        {
+            m_aParents[uNode] = iParent;
+            m_bLevelsDirty = TRUE;
+            markDirty(uNode);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetTranslation
+
+      Summary:  Sets the local translation of a node. The local matrix
+                is rebuilt from the translation, rotation and scale
+
+      Args:     UINT uNode
+                  Node
+                const XMFLOAT3& translation
+                  Translation relative to the parent
+
+      Modifies: [m_aTranslations, m_aLocalMatrices, m_aDirty,
+                 m_uFirstDirtyLevel].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetTranslation(_In_ UINT uNode, _In_ const XMFLOAT3& translation)
+    {
+        assert(uNode < m_aTranslations.size());
+
+        m_aTranslations[uNode] = translation;
+        composeLocalMatrix(uNode);
+        markDirty(uNode);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetRotation
+
+      Summary:  Sets the local rotation of a node. The local matrix is
+                rebuilt from the translation, rotation and scale
+
+      Args:     UINT uNode
+                  Node
+                const XMFLOAT4& rotation
+                  Normalized rotation quaternion relative to the parent
+
+      Modifies: [m_aRotations, m_aLocalMatrices, m_aDirty,
+                 m_uFirstDirtyLevel].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetRotation(_In_ UINT uNode, _In_ const XMFLOAT4& rotation)
+    {
+        assert(uNode < m_aRotations.size());
+
+        m_aRotations[uNode] = rotation;
+        composeLocalMatrix(uNode);
+        markDirty(uNode);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetScale
+
+      Summary:  Sets the local scale of a node. The local matrix is
+                rebuilt from the translation, rotation and scale
+
+      Args:     UINT uNode
+                  Node
+                const XMFLOAT3& scale
+                  Scale along the x-axis, y-axis and z-axis
+
+      Modifies: [m_aScales, m_aLocalMatrices, m_aDirty,
+                 m_uFirstDirtyLevel].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetScale(_In_ UINT uNode, _In_ const XMFLOAT3& scale)
+    {
+        assert(uNode < m_aScales.size());
+
+        m_aScales[uNode] = scale;
+        composeLocalMatrix(uNode);
+        markDirty(uNode);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetLocalMatrix
+
+      Summary:  Sets the local matrix of a node as given, so shear and
+                scales along rotated axes are kept. The node only
+                becomes dirty when the matrix differs, so callers can
+                push the matrices of their objects every frame. The
+                translation, rotation and scale are set to the nearest
+                decomposition, a later SetTranslation, SetRotation or
+                SetScale rebuilds the matrix from them and drops the
+                shear
+
+      Args:     UINT uNode
+                  Node
+                FXMMATRIX local
+                  Transform relative to the parent
+
+      Modifies: [m_aTranslations, m_aRotations, m_aScales,
+                 m_aLocalMatrices, m_aDirty, m_uFirstDirtyLevel].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetLocalMatrix(_In_ UINT uNode, _In_ FXMMATRIX local)
+    {
+        assert(uNode < m_aParents.size());
+
+        XMMATRIX previous = XMLoadFloat4x4A(&m_aLocalMatrices[uNode]);
+        if (XMVector4Equal(local.r[0], previous.r[0]) &&
+            XMVector4Equal(local.r[1], previous.r[1]) &&
+            XMVector4Equal(local.r[2], previous.r[2]) &&
+            XMVector4Equal(local.r[3], previous.r[3]))
+        {
+            return;
+        }
+
+        XMStoreFloat4x4A(&m_aLocalMatrices[uNode], local);
+
+        // A matrix with a zero scale has no rotation to recover, the
+        // previous one is kept
+        XMVECTOR scale;
+        XMVECTOR rotation;
+        XMVECTOR translation;
+        if (XMMatrixDecompose(&scale, &rotation, &translation, local))
+        {
+            XMStoreFloat4(&m_aRotations[uNode], rotation);
+        }
+        XMStoreFloat3(&m_aScales[uNode], scale);
+        XMStoreFloat3(&m_aTranslations[uNode], translation);
+        markDirty(uNode);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::Update
+
+      Summary:  Recomputes the world matrices of the dirty nodes and of
+                their descendants. Levels above the shallowest dirty
+                node are skipped, a level is processed once the one
+                above it is done, and levels of at least
+                PARALLEL_LEVEL_SIZE nodes are split across the pool
+
+      Args:     ThreadPool* pThreadPool
+                  Pool to split large levels on, nullptr to update on
+                  the calling thread only
+
+      Modifies: [m_aWorldMatrices, m_aDirty, m_aUpdateFrames,
+                 m_aDepths, m_aLevelOrder, m_aLevelStarts,
+                 m_bLevelsDirty, m_uFirstDirtyLevel, m_uFrame,
+                 m_uNumUpdatedNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::Update(_In_opt_ ThreadPool* pThreadPool)
+    {
+        if (m_bLevelsDirty)
+        {
+            buildLevels();
+        }
+
+        m_uNumUpdatedNodes = 0u;
+        UINT uNumLevels = m_aLevelStarts.empty() ? 0u : static_cast<UINT>(m_aLevelStarts.size()) - 1u;
+        if (m_uFirstDirtyLevel >= uNumLevels)
+        {
+            m_uFirstDirtyLevel = UINT_MAX;
+            return;
+        }
+
+        // Nodes recomputed in this update carry its frame, which is how
+        // their children find out without clearing flags afterwards
+        ++m_uFrame;
+
+        for (UINT uLevel = m_uFirstDirtyLevel; uLevel < uNumLevels; ++uLevel)
+        {
+            UINT uBegin = m_aLevelStarts[uLevel];
+            UINT uEnd = m_aLevelStarts[uLevel + 1u];
+            if (pThreadPool && uEnd - uBegin >= PARALLEL_LEVEL_SIZE)
+            {
+                std::atomic<UINT> uNumUpdated = 0u;
+                pThreadPool->ParallelFor(uEnd - uBegin, PARALLEL_GRAIN_SIZE, [&](UINT uChunkBegin, UINT uChunkEnd)
+                    {
+                        uNumUpdated += updateRange(uBegin + uChunkBegin, uBegin + uChunkEnd);
+                    }
+                );
+                m_uNumUpdatedNodes += uNumUpdated;
+            }
+            else
+            {
+                m_uNumUpdatedNodes += updateRange(uBegin, uEnd);
+            }
+        }
+
+        m_uFirstDirtyLevel = UINT_MAX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetParent
+
+      Summary:  Returns the parent of a node
+
+      Args:     UINT uNode
+                  Node
+
+      Returns:  INT
+                  Parent node, INVALID_NODE for a root
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT TransformHierarchy::GetParent(_In_ UINT uNode) const
+    {
+        assert(uNode < m_aParents.size());
+
+        return m_aParents[uNode];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetWorldMatrix
+
+      Summary:  Returns the world matrix of a node as of the last Update
+
+      Args:     UINT uNode
+                  Node
+
+      Returns:  XMMATRIX
+                  World matrix
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX TransformHierarchy::GetWorldMatrix(_In_ UINT uNode) const
+    {
+        assert(uNode < m_aWorldMatrices.size());
+
+        return XMLoadFloat4x4A(&m_aWorldMatrices[uNode]);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetNumNodes
+
+      Summary:  Returns the number of nodes
+
+      Returns:  UINT
+                  Number of nodes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::GetNumNodes() const
+    {
+        return static_cast<UINT>(m_aParents.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetNumUpdatedNodes
+
+      Summary:  Returns the number of world matrices the last Update
+                recomputed
+
+      Returns:  UINT
+                  Number of nodes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::GetNumUpdatedNodes() const
+    {
+        return m_uNumUpdatedNodes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::composeLocalMatrix
+
+      Summary:  Rebuilds the local matrix of a node from its scale,
+                rotation and translation
+
+      Args:     UINT uNode
+                  Node
+
+      Modifies: [m_aLocalMatrices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::composeLocalMatrix(_In_ UINT uNode)
+    {
+        XMMATRIX local = XMMatrixAffineTransformation(
+            XMLoadFloat3(&m_aScales[uNode]),
+            XMVectorZero(),
+            XMLoadFloat4(&m_aRotations[uNode]),
+            XMLoadFloat3(&m_aTranslations[uNode])
+        );
+        XMStoreFloat4x4A(&m_aLocalMatrices[uNode], local);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::markDirty
+
+      Summary:  Flags a node for the next Update. While the levels are
+                stale its depth is unknown, so the update starts at the
+                top
+
+      Args:     UINT uNode
+                  Node
+
+      Modifies: [m_aDirty, m_uFirstDirtyLevel].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::markDirty(_In_ UINT uNode)
+    {
+        m_aDirty[uNode] = TRUE;
+        m_uFirstDirtyLevel = m_bLevelsDirty ? 0u : std::min(m_uFirstDirtyLevel, m_aDepths[uNode]);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::buildLevels
+
+      Summary:  Computes the depth of every node and sorts the nodes by
+                depth, keeping their order within a level, so that
+                nodes added parent first are walked in memory order
+
+      Modifies: [m_aDepths, m_aLevelOrder, m_aLevelStarts,
+                 m_bLevelsDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::buildLevels()
+    {
+        UINT uNumNodes = static_cast<UINT>(m_aParents.size());
+        std::fill(m_aDepths.begin(), m_aDepths.end(), UINT_MAX);
+
+        // Every node is walked up to the first ancestor with a known
+        // depth, so each node is visited a constant number of times
+        UINT uNumLevels = 0u;
+        std::vector<UINT> aPath;
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            UINT uNode = i;
+            while (m_aDepths[uNode] == UINT_MAX && m_aParents[uNode] != INVALID_NODE)
+            {
+                aPath.push_back(uNode);
+                uNode = static_cast<UINT>(m_aParents[uNode]);
+            }
+            if (m_aDepths[uNode] == UINT_MAX)
+            {
+                m_aDepths[uNode] = 0u;
+            }
+
+            UINT uDepth = m_aDepths[uNode];
+            while (!aPath.empty())
+            {
+                m_aDepths[aPath.back()] = ++uDepth;
+                aPath.pop_back();
+            }
+            uNumLevels = std::max(uNumLevels, m_aDepths[i] + 1u);
+        }
+
+        m_aLevelStarts.assign(uNumNodes ? uNumLevels + 1u : 0u, 0u);
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            ++m_aLevelStarts[m_aDepths[i] + 1u];
+        }
+        for (UINT uLevel = 1u; uLevel < m_aLevelStarts.size(); ++uLevel)
+        {
+            m_aLevelStarts[uLevel] += m_aLevelStarts[uLevel - 1u];
+        }
+
+        m_aLevelOrder.resize(uNumNodes);
+        std::vector<UINT> aNextSlots(m_aLevelStarts.begin(), m_aLevelStarts.end());
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            m_aLevelOrder[aNextSlots[m_aDepths[i]]++] = i;
+        }
+
+        m_bLevelsDirty = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::updateRange
+
+      Summary:  Recomputes the nodes of a range of the level order that
+                are dirty or whose parent was recomputed in this
+                update. The range lies within one level, so the nodes
+                only read the matrices of the level above
+
+      Args:     UINT uBegin
+                  First entry of the level order
+                UINT uEnd
+                  Entry past the last one
+
+      Modifies: [m_aWorldMatrices, m_aDirty, m_aUpdateFrames].
+
+      Returns:  UINT
+                  Number of nodes recomputed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::updateRange(_In_ UINT uBegin, _In_ UINT uEnd)
+    {
+        UINT uNumUpdated = 0u;
+        for (UINT i = uBegin; i < uEnd; ++i)
+        {
+            UINT uNode = m_aLevelOrder[i];
+            INT iParent = m_aParents[uNode];
+            BOOL bParentUpdated = iParent != INVALID_NODE && m_aUpdateFrames[iParent] == m_uFrame;
+            if (!m_aDirty[uNode] && !bParentUpdated)
+            {
+                continue;
+            }
+
+            XMMATRIX local = XMLoadFloat4x4A(&m_aLocalMatrices[uNode]);
+            XMMATRIX world = iParent == INVALID_NODE ? local : XMMatrixMultiply(local, XMLoadFloat4x4A(&m_aWorldMatrices[iParent]));
+            XMStoreFloat4x4A(&m_aWorldMatrices[uNode], world);
+
+            m_aDirty[uNode] = FALSE;
+            m_aUpdateFrames[uNode] = m_uFrame;
+            ++uNumUpdated;
+        }
+
+        return uNumUpdated;
+    }
+}
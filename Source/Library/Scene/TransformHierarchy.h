@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      TRANSFORMHIERARCHY.H
+
+  Summary:   TransformHierarchy header file contains declarations of
+             the TransformHierarchy class that keeps the local
+             transforms and parents of scene nodes in parallel arrays
+             and recomputes the world matrices of the nodes that
+             changed, level by level.
+
+  Classes: TransformHierarchy
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Utility/ThreadPool.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TransformHierarchy
+
+      Summary:  Node hierarchy stored as arrays of translations,
+                rotations, scales, local matrices, parents and world
+                matrices indexed by node. A node is dirty once its local transform or
+                parent changed, Update then recomputes it and its
+                descendants only, walking the nodes breadth first so
+                a parent is done before its children. The nodes of a
+                level don't depend on each other, large levels are
+                split across the thread pool
+
+      Methods:  AddNode
+                  Adds a node and returns its index
+                SetParent
+                  Moves a node under another node or to the roots
+                SetTranslation
+                  Sets the local translation of a node
+                SetRotation
+                  Sets the local rotation quaternion of a node
+                SetScale
+                  Sets the local scale of a node
+                SetLocalMatrix
+                  Sets the local matrix of a node as given
+                Update
+                  Recomputes the world matrices of the dirty subtrees
+                GetParent
+                  Returns the parent of a node
+                GetWorldMatrix
+                  Returns the world matrix of a node
+                GetNumNodes
+                  Returns the number of nodes
+                GetNumUpdatedNodes
+                  Returns the number of nodes the last Update
+                  recomputed
+                TransformHierarchy
+                  Constructor.
+                ~TransformHierarchy
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TransformHierarchy final
+    {
+    public:
+        static constexpr const INT INVALID_NODE = -1;
+        static constexpr const UINT PARALLEL_LEVEL_SIZE = 4096u;
+        static constexpr const UINT PARALLEL_GRAIN_SIZE = 1024u;
+
+        TransformHierarchy();
+        TransformHierarchy(const TransformHierarchy& other) = delete;
+        TransformHierarchy(TransformHierarchy&& other) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy& other) = delete;
+        TransformHierarchy& operator=(TransformHierarchy&& other) = delete;
+        ~TransformHierarchy() = default;
+
+        UINT AddNode(_In_opt_ INT iParent = INVALID_NODE);
+        HRESULT SetParent(_In_ UINT uNode, _In_ INT iParent);
+
+        void SetTranslation(_In_ UINT uNode, _In_ const XMFLOAT3& translation);
+        void SetRotation(_In_ UINT uNode, _In_ const XMFLOAT4& rotation);
+        void SetScale(_In_ UINT uNode, _In_ const XMFLOAT3& scale);
+        void SetLocalMatrix(_In_ UINT uNode, _In_ FXMMATRIX local);
+
+        void Update(_In_opt_ ThreadPool* pThreadPool = nullptr);
+
+        INT GetParent(_In_ UINT uNode) const;
+        XMMATRIX GetWorldMatrix(_In_ UINT uNode) const;
+        UINT GetNumNodes() const;
+        UINT GetNumUpdatedNodes() const;
+
+    private:
+        void composeLocalMatrix(_In_ UINT uNode);
+        void markDirty(_In_ UINT uNode);
+        void buildLevels();
+        UINT updateRange(_In_ UINT uBegin, _In_ UINT uEnd);
+
+    private:
+        std::vector<XMFLOAT3> m_aTranslations;
+        std::vector<XMFLOAT4> m_aRotations;
+        std::vector<XMFLOAT3> m_aScales;
+        std::vector<XMFLOAT4X4A> m_aLocalMatrices;
+        std::vector<INT> m_aParents;
+        std::vector<XMFLOAT4X4A> m_aWorldMatrices;
+        std::vector<BYTE> m_aDirty;
+        std::vector<UINT> m_aUpdateFrames;
+        std::vector<UINT> m_aDepths;
+
+        std::vector<UINT> m_aLevelOrder;
+        std::vector<UINT> m_aLevelStarts;
+        BOOL m_bLevelsDirty;
+        UINT m_uFirstDirtyLevel;
+        UINT m_uFrame;
+        UINT m_uNumUpdatedNodes;
+    };
+}
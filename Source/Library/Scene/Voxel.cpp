@@ -77,6 +77,19 @@ namespace library
     void Voxel::Update(_In_ FLOAT deltaTime)
     {}
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::SetHasNormalMap
+      Summary:  Sets whether the block materials the voxel samples have
+                normal maps, which selects its shader variants
+      Args:     BOOL bHasNormalMap
+                  TRUE if any block type has a normal map
+      Modifies: [m_bHasNormalMap].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Voxel::SetHasNormalMap(_In_ BOOL bHasNormalMap)
+    {
+        m_bHasNormalMap = bHasNormalMap;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Voxel::GetNumVertices
       Summary:  Returns the number of vertices in the voxel
@@ -23,7 +23,9 @@ namespace library
 
       Summary:  Base class for renderable 3d cube object
 
-      Methods:  Voxel
+      Methods:  SetHasNormalMap
+                  Sets whether the block materials have normal maps
+                Voxel
                   Constructor.
                 ~Voxel
                   Destructor.
@@ -42,6 +44,8 @@ namespace library
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
         virtual void Update(_In_ FLOAT deltaTime) override;
 
+        void SetHasNormalMap(_In_ BOOL bHasNormalMap);
+
         UINT GetNumVertices() const override;
         UINT GetNumIndices() const override;
 
@@ -15,54 +15,71 @@ namespace library
                 PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
+                UINT uFeatures
+                  SHADER_FEATURE_ switches the shader tests with #if
 
-      Modifies: [m_pixelShader].
+      Modifies: [m_pixelShaders].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    PixelShader::PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
-        Shader(pszFileName,pszEntryPoint,pszShaderModel),
-        m_pixelShader(nullptr)
+    PixelShader::PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures) :
+        Shader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures),
+        m_pixelShaders()
     {}
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PixelShader::Initialize
 
-      Summary:  Initializes the pixel shader
+      Summary:  Initializes the requested variants of the pixel shader
+                that do not exist yet
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the pixel shader
 
+      Modifies: [m_pixelShaders].
+
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT PixelShader::Initialize(_In_ ID3D11Device* pDevice)
     {
-        ComPtr<ID3DBlob> PSBlob;
-        HRESULT hr = S_OK;
-        hr = compile(&PSBlob);
-        if (FAILED(hr))
+        for (UINT uVariantKey : getRequestedVariants())
         {
-            return hr;
+            if (m_pixelShaders[uVariantKey])
+            {
+                continue;
+            }
+
+            ComPtr<ID3DBlob> PSBlob;
+            HRESULT hr = compile(uVariantKey, PSBlob.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            // Create the pixel shader
+            hr = pDevice->CreatePixelShader(PSBlob->GetBufferPointer(),
+                PSBlob->GetBufferSize(),
+                nullptr,
+                m_pixelShaders[uVariantKey].GetAddressOf()
+            );
+            if (FAILED(hr))
+                return hr;
         }
-        // Create the pixel shader
-        hr = pDevice->CreatePixelShader(PSBlob->GetBufferPointer(), 
-            PSBlob->GetBufferSize(),
-            nullptr,
-            m_pixelShader.GetAddressOf()
-        );
-        if (FAILED(hr))
-            return hr;
         return S_OK;
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PixelShader::GetPixelShader
 
-      Summary:  Returns the pixel shader
+      Summary:  Returns the variant drawing an object with the given
+                features
+
+      Args:     UINT uFeatures
+                  SHADER_FEATURE_ bits of the object
 
       Returns:  ComPtr<ID3D11PixelShader>&
-                  Pixel shader. Could be a nullptr
+                  Pixel shader. A nullptr if the variant was not
+                  requested before Initialize
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11PixelShader>& PixelShader::GetPixelShader()
+    ComPtr<ID3D11PixelShader>& PixelShader::GetPixelShader(_In_opt_ UINT uFeatures)
     {
-        return m_pixelShader;
+        return m_pixelShaders[GetVariantKey(uFeatures)];
     }
 }
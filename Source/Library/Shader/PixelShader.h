@@ -23,9 +23,10 @@ namespace library
       Summary:  Pixel shader
 
       Methods:  Initialize
-                  Initializes and compiles the pixel shader
+                  Initializes and compiles the pixel shader variants
                 GetPixelShader
                   Returns the reference to the D3D11 pixel shader
+                  variant of given features
                 Game
                   Constructor.
                 ~Game
@@ -35,7 +36,7 @@ namespace library
     {
     public:
         PixelShader() = delete;
-        PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
         PixelShader(const PixelShader& other) = delete;
         PixelShader(PixelShader&& other) = delete;
         PixelShader& operator=(const PixelShader& other) = delete;
@@ -44,9 +45,9 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
 
-        ComPtr<ID3D11PixelShader>& GetPixelShader();
+        ComPtr<ID3D11PixelShader>& GetPixelShader(_In_opt_ UINT uFeatures = 0u);
 
     protected:
-        ComPtr<ID3D11PixelShader> m_pixelShader;
+        std::unordered_map<UINT, ComPtr<ID3D11PixelShader>> m_pixelShaders;
     };
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "Shader/QuantizedVertexShader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   QuantizedVertexShader::QuantizedVertexShader
+
+      Summary:  Constructor
+
+      Args:     PCWSTR pszFileName
+                  Name of the file that contains the shader code
+                PCSTR pszEntryPoint
+                  Name of the shader entry point functino where shader
+                  execution begins
+                PCSTR pszShaderModel
+                  Specifies the shader target or set of shader features
+                  to compile against
+                UINT uFeatures
+                  SHADER_FEATURE_ switches the shader tests with #if
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    QuantizedVertexShader::QuantizedVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures) :
+        VertexShader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   QuantizedVertexShader::Initialize
+
+      Summary:  Initializes the vertex shader and the input layout of
+                a single QuantizedVertex stream
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shader
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT QuantizedVertexShader::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        // Define the input layout, has to match QuantizedVertex
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TANGENTFRAME", 0, DXGI_FORMAT_R10G10B10A2_UNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+        };
+        UINT uNumElements = ARRAYSIZE(aLayouts);
+
+        // Create every requested variant, and the input layout from the first
+        HRESULT hr = createVariants(pDevice, aLayouts, uNumElements);
+        if (FAILED(hr))
+        {
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"The FX file %s cannot be compiled. Please run this executable from the directory that contains the FX file.",
+                m_pszFileName
+            );
+            MessageBox(
+                nullptr,
+                szMessage,
+                L"Error",
+                MB_OK
+            );
+            return hr;
+        }
+
+        return S_OK;
+    }
+}
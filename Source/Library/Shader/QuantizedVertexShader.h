@@ -0,0 +1,45 @@
+/*+===================================================================
+  File:      QUANTIZEDVERTEXSHADER.H
+
+  Summary:   QuantizedVertexShader header file contains declarations of 
+             QuantizedVertexShader class used for the lab samples of 
+             Game Graphics Programming course.
+
+  Classes: QuantizedVertexShader
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    QuantizedVertexShader
+
+      Summary:  Vertex shader reading QuantizedVertex streams
+
+      Methods:  Initialize
+                  Initializes the vertex shader and the input layout
+                QuantizedVertexShader
+                  Constructor.
+                ~QuantizedVertexShader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class QuantizedVertexShader : public VertexShader
+    {
+    public:
+        QuantizedVertexShader() = delete;
+        QuantizedVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
+        QuantizedVertexShader(const QuantizedVertexShader& other) = delete;
+        QuantizedVertexShader(QuantizedVertexShader&& other) = delete;
+        QuantizedVertexShader& operator=(const QuantizedVertexShader& other) = delete;
+        QuantizedVertexShader& operator=(QuantizedVertexShader&& other) = delete;
+        virtual ~QuantizedVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "Shader.h"
 
+#include "Shader/ShaderCache.h"
+#include "Shader/ShaderPermutation.h"
+
+#include <algorithm>
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -15,13 +20,23 @@ namespace library
               PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
+              UINT uFeatures
+                  SHADER_FEATURE_ switches the shader tests with #if
 
-      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel].
+      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel,
+                 m_uFeatures, m_requestedVariants, m_precompiledBlobs,
+                 m_compileMilliseconds, m_szCompileErrors].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    Shader::Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
+    Shader::Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures) :
         m_pszFileName(pszFileName),
         m_pszEntryPoint(pszEntryPoint),
-        m_pszShaderModel(pszShaderModel)
+        m_pszShaderModel(pszShaderModel),
+        m_uFeatures(uFeatures),
+        m_mutex(),
+        m_requestedVariants(),
+        m_precompiledBlobs(),
+        m_compileMilliseconds(0.0f),
+        m_szCompileErrors()
     {}
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -37,40 +52,347 @@ namespace library
         return m_pszFileName;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetFeatures
+
+      Summary:  Returns the feature switches the shader declares
+
+      Returns:  UINT
+                  SHADER_FEATURE_ bits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetFeatures() const
+    {
+        return m_uFeatures;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetVariantKey
+
+      Summary:  Returns the variant an object needing the given
+                features is drawn with. Features the shader does not
+                switch on are ignored
+
+      Args:     UINT uFeatures
+                  SHADER_FEATURE_ bits of the object
+
+      Returns:  UINT
+                  Variant key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetVariantKey(_In_ UINT uFeatures) const
+    {
+        return uFeatures & m_uFeatures;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::RequestVariant
+
+      Summary:  Marks the variant of the given features as used, so
+                the next Precompile and Initialize create it. Thread
+                safe
+
+      Args:     UINT uFeatures
+                  SHADER_FEATURE_ bits of the object
+
+      Modifies: [m_requestedVariants].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Shader::RequestVariant(_In_ UINT uFeatures)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requestedVariants.insert(GetVariantKey(uFeatures));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetNumVariants
+
+      Summary:  Returns the number of variants requested
+
+      Returns:  UINT
+                  Number of variants
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetNumVariants()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<UINT>(m_requestedVariants.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetCompileMilliseconds
+
+      Summary:  Returns the time Precompile took in total, cache hits
+                included
+
+      Returns:  FLOAT
+                  Milliseconds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT Shader::GetCompileMilliseconds()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_compileMilliseconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetCompileErrors
+
+      Summary:  Returns the variants the last Precompile failed to
+                compile, each with the messages of the compiler
+
+      Returns:  std::string
+                  Errors, empty if every variant compiled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::string Shader::GetCompileErrors()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_szCompileErrors;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::Precompile
+
+      Summary:  Compiles the requested variants that have no bytecode
+                yet and keeps it for compile. Needs no device, so it
+                can run on a worker thread while Initialize runs on the
+                device one. The variants are compiled in parallel when
+                a thread pool is given. Every variant is compiled even
+                if another fails, the failures are kept for
+                GetCompileErrors
+
+      Args:     ThreadPool* pThreadPool
+                  Pool to compile the variants on, nullptr to compile
+                  them on this thread
+
+      Modifies: [m_precompiledBlobs, m_compileMilliseconds,
+                 m_szCompileErrors].
+
+      Returns:  HRESULT
+                  Status code of the first variant that failed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Shader::Precompile(_In_opt_ ThreadPool* pThreadPool)
+    {
+        std::vector<UINT> aVariantKeys;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (UINT uVariantKey : m_requestedVariants)
+            {
+                if (!m_precompiledBlobs.contains(uVariantKey))
+                {
+                    aVariantKeys.push_back(uVariantKey);
+                }
+            }
+        }
+
+        LARGE_INTEGER startingTime = {};
+        LARGE_INTEGER endingTime = {};
+        LARGE_INTEGER frequency = {};
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        UINT uNumVariants = static_cast<UINT>(aVariantKeys.size());
+        std::vector<ComPtr<ID3DBlob>> aBlobs(uNumVariants);
+        std::vector<HRESULT> aResults(uNumVariants, S_OK);
+        std::vector<std::string> aMessages(uNumVariants);
+        auto compileVariants = [&](UINT uBegin, UINT uEnd)
+        {
+            for (UINT i = uBegin; i < uEnd; ++i)
+            {
+                aResults[i] = compileVariant(aVariantKeys[i], aBlobs[i].GetAddressOf(), &aMessages[i]);
+            }
+        };
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumVariants, 1u, compileVariants);
+        }
+        else
+        {
+            compileVariants(0u, uNumVariants);
+        }
+
+        QueryPerformanceCounter(&endingTime);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_compileMilliseconds += static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart);
+
+        m_szCompileErrors.clear();
+
+        HRESULT hr = S_OK;
+        for (UINT i = 0u; i < uNumVariants; ++i)
+        {
+            if (FAILED(aResults[i]))
+            {
+                hr = SUCCEEDED(hr) ? aResults[i] : hr;
+
+                CHAR szHeader[512];
+                sprintf_s(
+                    szHeader,
+                    "%s %s %s [%s] failed with 0x%08X\n",
+                    std::filesystem::path(m_pszFileName).string().c_str(),
+                    m_pszEntryPoint,
+                    m_pszShaderModel,
+                    GetShaderVariantName(aVariantKeys[i]).c_str(),
+                    static_cast<UINT>(aResults[i])
+                );
+                m_szCompileErrors += szHeader;
+                m_szCompileErrors += aMessages[i];
+                continue;
+            }
+            m_precompiledBlobs[aVariantKeys[i]] = aBlobs[i];
+        }
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetCompileDesc
+
+      Summary:  Returns what a variant is compiled from
+
+      Args:     UINT uVariantKey
+                  Variant to describe
+
+      Returns:  ShaderCompileDesc
+                  File, entry point, target, macros and flags
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCompileDesc Shader::GetCompileDesc(_In_ UINT uVariantKey) const
+    {
+        return ShaderCompileDesc
+        {
+            .FilePath = m_pszFileName,
+            .szEntryPoint = m_pszEntryPoint,
+            .szTarget = m_pszShaderModel,
+            .aDefines = GetShaderVariantDefines(uVariantKey),
+            .uFlags = GetDefaultShaderCompileFlags()
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::AddPrecompiledVariant
+
+      Summary:  Keeps bytecode compiled elsewhere, e.g. stored in a scene
+                snapshot, for a variant. Precompile and compile use it
+                instead of compiling. Thread safe
+
+      Args:     UINT uVariantKey
+                  Variant of the bytecode
+                const BYTE* pBytecode
+                  Bytecode, copied
+                SIZE_T uSize
+                  Size of the bytecode in bytes
+
+      Modifies: [m_precompiledBlobs].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Shader::AddPrecompiledVariant(_In_ UINT uVariantKey, _In_reads_bytes_(uSize) const BYTE* pBytecode, _In_ SIZE_T uSize)
+    {
+        ComPtr<ID3DBlob> blob;
+        HRESULT hr = D3DCreateBlob(uSize, blob.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        memcpy(blob->GetBufferPointer(), pBytecode, uSize);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_precompiledBlobs[uVariantKey] = blob;
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetPrecompiledVariants
+
+      Summary:  Returns the bytecode kept for every variant
+
+      Returns:  std::vector<std::pair<UINT, ComPtr<ID3DBlob>>>
+                  Variant keys and their bytecode, in ascending order
+                  of the keys
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::pair<UINT, ComPtr<ID3DBlob>>> Shader::GetPrecompiledVariants()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::pair<UINT, ComPtr<ID3DBlob>>> aVariants(m_precompiledBlobs.begin(), m_precompiledBlobs.end());
+        std::sort(aVariants.begin(), aVariants.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        return aVariants;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::getRequestedVariants
+
+      Summary:  Returns the keys of the requested variants
+
+      Returns:  std::vector<UINT>
+                  Variant keys, in ascending order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<UINT> Shader::getRequestedVariants()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<UINT> aVariantKeys(m_requestedVariants.begin(), m_requestedVariants.end());
+        std::sort(aVariantKeys.begin(), aVariantKeys.end());
+        return aVariantKeys;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Shader::compile
 
-      Summary:  Compiles the given shader file
+      Summary:  Returns the bytecode Precompile kept for a variant, or
+                compiles it now
 
-      Args:     ID3DBlob** ppOutBlob
+      Args:     UINT uVariantKey
+                  Variant to compile
+                ID3DBlob** ppOutBlob
                   Receives a pointer to the ID3DBlob interface that you
                   can use to access the compiled code
 
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Shader::compile(_Outptr_ ID3DBlob** ppOutBlob)
+    HRESULT Shader::compile(_In_ UINT uVariantKey, _Outptr_ ID3DBlob** ppOutBlob)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto iBlob = m_precompiledBlobs.find(uVariantKey);
+            if (iBlob != m_precompiledBlobs.end())
+            {
+                return iBlob->second.CopyTo(ppOutBlob);
+            }
+        }
+
+        return compileVariant(uVariantKey, ppOutBlob);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::compileVariant
+
+      Summary:  Compiles a variant through the ShaderCache, which skips
+                the compiler when the bytecode of the same source and
+                macros is on disk
+
+      Args:     UINT uVariantKey
+                  Variant to compile
+                ID3DBlob** ppOutBlob
+                  Receives a pointer to the ID3DBlob interface that you
+                  can use to access the compiled code
+                std::string* pOutMessages
+                  Receives the errors and warnings of the compiler, may
+                  be nullptr
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Shader::compileVariant(_In_ UINT uVariantKey, _Outptr_ ID3DBlob** ppOutBlob, _Out_opt_ std::string* pOutMessages) const
     {
         HRESULT hr = S_OK;
-        DWORD dwShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
-#ifdef _DEBUG
-        // Set the D3DCOMPILE_DEBUG flag to embed debug information in the shaders.
-        // Setting this flag improves the shader debugging experience, but still allows 
-        // the shaders to be optimized and to run exactly the way they will run in 
-        // the release configuration of this program.
-        dwShaderFlags |= D3DCOMPILE_DEBUG;
-
-        // Disable optimizations to further improve shader debugging
-        dwShaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
-
-        ComPtr<ID3DBlob> errorBlob(nullptr);
-        hr = D3DCompileFromFile(m_pszFileName, nullptr, nullptr, m_pszEntryPoint, m_pszShaderModel,
-            dwShaderFlags, 0, ppOutBlob, errorBlob.GetAddressOf());
+        std::vector<BYTE> aBytecode;
+        hr = ShaderCache::GetDefault().Compile(GetCompileDesc(uVariantKey), aBytecode, pOutMessages);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = D3DCreateBlob(aBytecode.size(), ppOutBlob);
         if (FAILED(hr))
         {
             return hr;
         }
+        memcpy((*ppOutBlob)->GetBufferPointer(), aBytecode.data(), aBytecode.size());
         return S_OK;
     }
 }
@@ -13,19 +13,50 @@
 
 #include "Common.h"
 
+#include "Shader/ShaderCompiler.h"
+#include "Utility/ThreadPool.h"
+
+#include <mutex>
+
 namespace library
 {
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    PixelShader
 
-      Summary:  Pixel shader
+      Summary:  Shader compiled into a variant for every combination
+                of its feature switches in use. Variants are requested
+                before loading, and only those are compiled
 
       Methods:  Initialize
                   Pure virtual function that initializes the shader
                 GetFileName
                   Returns the name of the shader file to be compiled
+                GetFeatures
+                  Returns the feature switches the shader declares
+                GetVariantKey
+                  Returns the variant drawing with the given features
+                RequestVariant
+                  Marks the variant of the given features as used
+                GetNumVariants
+                  Returns the number of variants requested
+                GetCompileMilliseconds
+                  Returns the time Precompile took
+                GetCompileErrors
+                  Returns the errors of the variants the last
+                  Precompile failed to compile
+                Precompile
+                  Compiles the requested variants ahead of Initialize,
+                  without the device
+                GetCompileDesc
+                  Returns what a variant is compiled from
+                AddPrecompiledVariant
+                  Keeps bytecode compiled elsewhere for a variant
+                GetPrecompiledVariants
+                  Returns the bytecode kept for every variant
+                getRequestedVariants
+                  Returns the keys of the requested variants
                 compile
-                  Compiles the given shader file
+                  Compiles a variant of the given shader file
                 Game
                   Constructor.
                 ~Game
@@ -35,7 +66,7 @@ namespace library
     {
     public:
         Shader() = delete;
-        Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
         Shader(const Shader& other) = delete;
         Shader(Shader&& other) = delete;
         Shader& operator=(const Shader& other) = delete;
@@ -44,12 +75,35 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) = 0;
         PCWSTR GetFileName() const;
+        UINT GetFeatures() const;
+        UINT GetVariantKey(_In_ UINT uFeatures) const;
+        void RequestVariant(_In_ UINT uFeatures);
+        UINT GetNumVariants();
+        FLOAT GetCompileMilliseconds();
+        std::string GetCompileErrors();
+        HRESULT Precompile(_In_opt_ ThreadPool* pThreadPool = nullptr);
+        ShaderCompileDesc GetCompileDesc(_In_ UINT uVariantKey) const;
+        HRESULT AddPrecompiledVariant(_In_ UINT uVariantKey, _In_reads_bytes_(uSize) const BYTE* pBytecode, _In_ SIZE_T uSize);
+        std::vector<std::pair<UINT, ComPtr<ID3DBlob>>> GetPrecompiledVariants();
 
     protected:
-        HRESULT compile(_Outptr_ ID3DBlob** ppOutBlob);
+        std::vector<UINT> getRequestedVariants();
+        HRESULT compile(_In_ UINT uVariantKey, _Outptr_ ID3DBlob** ppOutBlob);
+
+    private:
+        HRESULT compileVariant(_In_ UINT uVariantKey, _Outptr_ ID3DBlob** ppOutBlob, _Out_opt_ std::string* pOutMessages = nullptr) const;
 
+    protected:
         PCWSTR m_pszFileName;
         PCSTR m_pszEntryPoint;
         PCSTR m_pszShaderModel;
+        UINT m_uFeatures;
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_set<UINT> m_requestedVariants;
+        std::unordered_map<UINT, ComPtr<ID3DBlob>> m_precompiledBlobs;
+        FLOAT m_compileMilliseconds;
+        std::string m_szCompileErrors;
     };
 }
\ No newline at end of file
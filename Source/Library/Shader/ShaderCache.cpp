@@ -0,0 +1,524 @@
+#include "Shader/ShaderCache.h"
+
+#include "Utility/Hash.h"
+#include "Utility/MappedFile.h"
+
+#include <fstream>
+
+namespace library
+{
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: hashFile
+
+          Summary:  Hashes the contents of a file into a running hash
+
+          Args:     const std::filesystem::path& filePath
+                      Path to the file
+                    UINT64& ullHash
+                      Running hash, updated
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT hashFile(_In_ const std::filesystem::path& filePath, _Inout_ UINT64& ullHash)
+        {
+            MappedFile file;
+            HRESULT hr = file.Open(filePath);
+            if (hr == HRESULT_FROM_WIN32(ERROR_HANDLE_EOF))
+            {
+                // Empty files can't be mapped
+                return S_OK;
+            }
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            ullHash = HashBytes(file.GetData(), file.GetSize(), ullHash);
+            return S_OK;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: computeSourceHash
+
+          Summary:  Hashes the source file and the paths and contents of
+                    every file it included. The paths are relative to the
+                    source, so the hash does not depend on the working
+                    directory
+
+          Args:     const std::filesystem::path& sourcePath
+                      Path to the source file
+                    const std::vector<std::filesystem::path>& aIncludes
+                      Paths of the included files, relative to the
+                      directory of the source
+                    UINT64& ullOutHash
+                      Receives the hash
+
+          Returns:  HRESULT
+                      Status code, fails if a file is missing
+        -----------------------------------------------------------------F-F*/
+        HRESULT computeSourceHash(
+            _In_ const std::filesystem::path& sourcePath,
+            _In_ const std::vector<std::filesystem::path>& aIncludes,
+            _Out_ UINT64& ullOutHash
+        )
+        {
+            ullOutHash = FNV1A_OFFSET_BASIS;
+            HRESULT hr = hashFile(sourcePath, ullOutHash);
+            for (SIZE_T i = 0u; i < aIncludes.size() && SUCCEEDED(hr); ++i)
+            {
+                std::u8string szPath = aIncludes[i].generic_u8string();
+                ullOutHash = HashBytes(szPath.data(), szPath.size() + 1u, ullOutHash);
+                hr = hashFile(sourcePath.parent_path() / aIncludes[i], ullOutHash);
+            }
+
+            return hr;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: readIncludes
+
+          Summary:  Checks that a mapped cached shader was written by this
+                    version for the given compilation and reads the paths
+                    of its includes
+
+          Args:     const MappedFile& cacheFile
+                      Mapped cached shader
+                    UINT64 ullKey
+                      Key of the compilation
+                    std::vector<std::filesystem::path>& outIncludes
+                      Receives the paths of the included files, relative
+                      to the directory of the source
+
+          Returns:  BOOL
+                      TRUE if the header is valid for the compilation
+        -----------------------------------------------------------------F-F*/
+        BOOL readIncludes(_In_ const MappedFile& cacheFile, _In_ UINT64 ullKey, _Out_ std::vector<std::filesystem::path>& outIncludes)
+        {
+            outIncludes.clear();
+
+            const ShaderCacheHeader* pHeader = reinterpret_cast<const ShaderCacheHeader*>(cacheFile.GetData());
+            if (cacheFile.GetSize() < sizeof(ShaderCacheHeader) ||
+                pHeader->uMagic != SHADER_CACHE_MAGIC ||
+                pHeader->uVersion != SHADER_CACHE_VERSION ||
+                pHeader->ullKey != ullKey ||
+                pHeader->uIncludesSize > cacheFile.GetSize() - sizeof(ShaderCacheHeader) ||
+                pHeader->ullBytecodeSize != cacheFile.GetSize() - sizeof(ShaderCacheHeader) - pHeader->uIncludesSize)
+            {
+                return FALSE;
+            }
+
+            // Every include path is null terminated
+            PCSTR pszIncludes = reinterpret_cast<PCSTR>(cacheFile.GetData() + sizeof(ShaderCacheHeader));
+            UINT uOffset = 0u;
+            while (uOffset < pHeader->uIncludesSize)
+            {
+                std::string_view szPath(pszIncludes + uOffset, strnlen(pszIncludes + uOffset, pHeader->uIncludesSize - uOffset));
+                outIncludes.emplace_back(std::u8string(szPath.begin(), szPath.end()));
+                uOffset += static_cast<UINT>(szPath.size()) + 1u;
+            }
+
+            return outIncludes.size() == pHeader->uNumIncludes;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: saveEntry
+
+          Summary:  Writes a cached shader. The file is written under a
+                    temporary name of the calling thread and renamed at
+                    the end, so an entry is never seen half written, even
+                    when two threads compile the same shader
+
+          Args:     const std::filesystem::path& cachePath
+                      Path to write to
+                    UINT64 ullKey
+                      Key of the compilation
+                    UINT64 ullSourceHash
+                      Hash of the source and the includes
+                    const std::vector<std::filesystem::path>& aIncludes
+                      Paths of the included files, relative to the
+                      directory of the source
+                    const std::vector<BYTE>& aBytecode
+                      Compiled bytecode
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT saveEntry(
+            _In_ const std::filesystem::path& cachePath,
+            _In_ UINT64 ullKey,
+            _In_ UINT64 ullSourceHash,
+            _In_ const std::vector<std::filesystem::path>& aIncludes,
+            _In_ const std::vector<BYTE>& aBytecode
+        )
+        {
+            std::string szIncludes;
+            for (const std::filesystem::path& includePath : aIncludes)
+            {
+                std::u8string szPath = includePath.generic_u8string();
+                szIncludes.append(reinterpret_cast<const CHAR*>(szPath.data()), szPath.size());
+                szIncludes.push_back('\0');
+            }
+
+            ShaderCacheHeader header =
+            {
+                .uMagic = SHADER_CACHE_MAGIC,
+                .uVersion = SHADER_CACHE_VERSION,
+                .ullKey = ullKey,
+                .ullSourceHash = ullSourceHash,
+                .uNumIncludes = static_cast<UINT>(aIncludes.size()),
+                .uIncludesSize = static_cast<UINT>(szIncludes.size()),
+                .ullBytecodeSize = aBytecode.size()
+            };
+
+            std::error_code error;
+            std::filesystem::create_directories(cachePath.parent_path(), error);
+
+            std::filesystem::path tempPath = cachePath;
+            tempPath += L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+            {
+                std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+                if (!cacheFile.is_open())
+                {
+                    return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+                }
+
+                cacheFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+                cacheFile.write(szIncludes.data(), static_cast<std::streamsize>(szIncludes.size()));
+                cacheFile.write(reinterpret_cast<const CHAR*>(aBytecode.data()), static_cast<std::streamsize>(aBytecode.size()));
+                if (!cacheFile.good())
+                {
+                    cacheFile.close();
+                    std::filesystem::remove(tempPath, error);
+                    return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+                }
+            }
+
+            std::filesystem::rename(tempPath, cachePath, error);
+            if (error)
+            {
+                std::filesystem::remove(tempPath, error);
+                return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+            }
+
+            return S_OK;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeShaderCacheKey
+
+      Summary:  Hashes everything a compilation depends on besides the
+                contents of the files. The directory is left out, the
+                cache lives next to the source
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+
+      Returns:  UINT64
+                  Key of the compilation
+    -----------------------------------------------------------------F-F*/
+    UINT64 ComputeShaderCacheKey(_In_ const ShaderCompileDesc& desc)
+    {
+        std::u8string szFileName = desc.FilePath.filename().generic_u8string();
+        UINT64 ullKey = HashBytes(&SHADER_CACHE_VERSION, sizeof(SHADER_CACHE_VERSION));
+        ullKey = HashBytes(szFileName.data(), szFileName.size() + 1u, ullKey);
+        ullKey = HashBytes(desc.szEntryPoint.c_str(), desc.szEntryPoint.size() + 1u, ullKey);
+        ullKey = HashBytes(desc.szTarget.c_str(), desc.szTarget.size() + 1u, ullKey);
+        for (const ShaderDefine& define : desc.aDefines)
+        {
+            ullKey = HashBytes(define.szName.c_str(), define.szName.size() + 1u, ullKey);
+            ullKey = HashBytes(define.szValue.c_str(), define.szValue.size() + 1u, ullKey);
+        }
+
+        return HashBytes(&desc.uFlags, sizeof(desc.uFlags), ullKey);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetShaderCachePath
+
+      Summary:  Returns the path of the cached shader, in a Cache
+                directory next to the source
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+
+      Returns:  std::filesystem::path
+                  Path to the cached shader
+    -----------------------------------------------------------------F-F*/
+    std::filesystem::path GetShaderCachePath(_In_ const ShaderCompileDesc& desc)
+    {
+        WCHAR szKey[17];
+        swprintf_s(szKey, L"%016llX", static_cast<unsigned long long>(ComputeShaderCacheKey(desc)));
+
+        std::filesystem::path fileName = desc.FilePath.stem();
+        fileName += L".";
+        fileName += desc.szEntryPoint;
+        fileName += L".";
+        fileName += szKey;
+        fileName += L".cso";
+
+        return desc.FilePath.parent_path() / L"Cache" / fileName;
+    }
+
+#ifdef _WIN32
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::GetDefault
+
+      Summary:  Returns the cache shared by the library, compiling with
+                the D3D compiler
+
+      Returns:  ShaderCache&
+                  Shared cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCache& ShaderCache::GetDefault()
+    {
+        static D3DShaderCompiler s_d3dShaderCompiler;
+        static ShaderCache s_shaderCache(&s_d3dShaderCompiler);
+        return s_shaderCache;
+    }
+#endif
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::ShaderCache
+
+      Summary:  Constructor
+
+      Args:     ShaderCompiler* pCompiler
+                  Compiler of the misses, has to outlive the cache
+
+      Modifies: [m_mutex, m_pCompiler, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCache::ShaderCache(_In_ ShaderCompiler* pCompiler)
+        : m_mutex()
+        , m_pCompiler(pCompiler)
+        , m_stats()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Compile
+
+      Summary:  Loads the bytecode of a shader from the cache, or
+                compiles and stores it when it is missing or stale
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+                std::vector<BYTE>& outBytecode
+                  Receives the bytecode
+                std::string* pOutMessages
+                  Receives the errors and warnings of the compiler,
+                  empty on a hit. May be nullptr
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::Compile(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<BYTE>& outBytecode, _Out_opt_ std::string* pOutMessages)
+    {
+        if (Load(desc, outBytecode) == S_OK)
+        {
+            if (pOutMessages)
+            {
+                pOutMessages->clear();
+            }
+            return S_OK;
+        }
+
+        return Cook(desc, outBytecode, pOutMessages);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Load
+
+      Summary:  Loads the bytecode of a shader if its entry exists, was
+                written by this version for the same compilation and
+                the source and includes hash as they did then
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+                std::vector<BYTE>& outBytecode
+                  Receives the bytecode
+
+      Modifies: [m_stats].
+
+      Returns:  HRESULT
+                  S_OK on a hit, S_FALSE if the entry is missing, stale
+                  or corrupt
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::Load(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<BYTE>& outBytecode)
+    {
+        outBytecode.clear();
+
+        BOOL bHit = FALSE;
+        BOOL bStale = FALSE;
+        MappedFile cacheFile;
+        if (SUCCEEDED(cacheFile.Open(GetShaderCachePath(desc))))
+        {
+            const ShaderCacheHeader* pHeader = reinterpret_cast<const ShaderCacheHeader*>(cacheFile.GetData());
+            std::vector<std::filesystem::path> aIncludes;
+            bStale = TRUE;
+            if (readIncludes(cacheFile, ComputeShaderCacheKey(desc), aIncludes))
+            {
+                UINT64 ullSourceHash = 0ull;
+                if (SUCCEEDED(computeSourceHash(desc.FilePath, aIncludes, ullSourceHash)) &&
+                    ullSourceHash == pHeader->ullSourceHash)
+                {
+                    const BYTE* pBytecode = cacheFile.GetData() + sizeof(ShaderCacheHeader) + pHeader->uIncludesSize;
+                    outBytecode.assign(pBytecode, pBytecode + pHeader->ullBytecodeSize);
+                    bHit = TRUE;
+                    bStale = FALSE;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (bHit)
+        {
+            ++m_stats.uNumHits;
+            return S_OK;
+        }
+
+        ++m_stats.uNumMisses;
+        if (bStale)
+        {
+            ++m_stats.uNumStale;
+        }
+        return S_FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::GetIncludes
+
+      Summary:  Returns the files a cached shader read when it was
+                compiled, so callers can tell when it goes stale
+                without hashing the sources
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+                std::vector<std::filesystem::path>& outIncludes
+                  Receives the paths of the included files, relative
+                  to the directory of the source
+
+      Returns:  HRESULT
+                  Status code, HRESULT_FROM_WIN32(ERROR_FILE_INVALID)
+                  if the entry is not of this compilation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::GetIncludes(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<std::filesystem::path>& outIncludes)
+    {
+        outIncludes.clear();
+
+        MappedFile cacheFile;
+        HRESULT hr = cacheFile.Open(GetShaderCachePath(desc));
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return readIncludes(cacheFile, ComputeShaderCacheKey(desc), outIncludes) ? S_OK : HRESULT_FROM_WIN32(ERROR_FILE_INVALID);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Cook
+
+      Summary:  Compiles a shader and stores its bytecode with the hash
+                of the source and of the includes it read. A shader
+                that compiled but couldn't be stored is still returned
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+                std::vector<BYTE>& outBytecode
+                  Receives the bytecode
+                std::string* pOutMessages
+                  Receives the errors and warnings of the compiler, may
+                  be nullptr
+
+      Modifies: [m_stats].
+
+      Returns:  HRESULT
+                  Status code of the compilation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::Cook(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<BYTE>& outBytecode, _Out_opt_ std::string* pOutMessages)
+    {
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        std::vector<std::filesystem::path> aIncludes;
+        std::string szMessages;
+        HRESULT hr = m_pCompiler->Compile(desc, outBytecode, aIncludes, szMessages);
+        if (pOutMessages)
+        {
+            *pOutMessages = std::move(szMessages);
+        }
+        for (std::filesystem::path& includePath : aIncludes)
+        {
+            includePath = includePath.lexically_normal().lexically_relative(desc.FilePath.parent_path().lexically_normal());
+        }
+
+        QueryPerformanceCounter(&endingTime);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.CompileMilliseconds += static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart);
+            if (SUCCEEDED(hr))
+            {
+                ++m_stats.uNumCompiled;
+            }
+        }
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        UINT64 ullSourceHash = 0ull;
+        if (FAILED(computeSourceHash(desc.FilePath, aIncludes, ullSourceHash)) ||
+            FAILED(saveEntry(GetShaderCachePath(desc), ComputeShaderCacheKey(desc), ullSourceHash, aIncludes, outBytecode)))
+        {
+            OutputDebugString(L"Can't cache shader \"");
+            OutputDebugString(desc.FilePath.wstring().c_str());
+            OutputDebugString(L"\"\n");
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::GetStats
+
+      Summary:  Returns the lookups since the cache was created
+
+      Returns:  ShaderCacheStats
+                  Current statistics
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCacheStats ShaderCache::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::LogStats
+
+      Summary:  Writes the statistics to the debug output
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderCache::LogStats()
+    {
+        ShaderCacheStats stats = GetStats();
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Shader cache: %u hits, %u misses (%u stale), %u compiled in %.2f ms\n",
+            stats.uNumHits,
+            stats.uNumMisses,
+            stats.uNumStale,
+            stats.uNumCompiled,
+            stats.CompileMilliseconds
+        );
+        OutputDebugString(szMessage);
+    }
+}
@@ -0,0 +1,120 @@
+/*+===================================================================
+  File:      SHADERCACHE.H
+
+  Summary:   ShaderCache header file contains the layout of cached
+             shader bytecode files and the ShaderCache class that
+             loads them instead of compiling HLSL on every launch.
+
+  Classes: ShaderCache
+
+  Functions: ComputeShaderCacheKey, GetShaderCachePath
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/ShaderCompiler.h"
+
+#include <mutex>
+
+namespace library
+{
+    constexpr const UINT SHADER_CACHE_MAGIC = 0x52444853u; // "SHDR"
+    constexpr const UINT SHADER_CACHE_VERSION = 1u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCacheHeader
+
+      Summary:  First bytes of a cached shader. The paths of the
+                includes follow as null terminated UTF-8 strings, then
+                the bytecode
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCacheHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        UINT64 ullKey;
+        UINT64 ullSourceHash;
+        UINT uNumIncludes;
+        UINT uIncludesSize;
+        UINT64 ullBytecodeSize;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCacheStats
+
+      Summary:  Lookups since the cache was created. Stale entries, whose
+                source or includes changed, count as misses too
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCacheStats
+    {
+        UINT uNumHits;
+        UINT uNumMisses;
+        UINT uNumStale;
+        UINT uNumCompiled;
+        FLOAT CompileMilliseconds;
+    };
+
+    UINT64 ComputeShaderCacheKey(_In_ const ShaderCompileDesc& desc);
+    std::filesystem::path GetShaderCachePath(_In_ const ShaderCompileDesc& desc);
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShaderCache
+
+      Summary:  Bytecode of compiled shaders, in a Cache directory next
+                to their source. An entry is keyed by the file name, the
+                entry point, the target, the macros and the flags, and
+                is only used while the hash of the source and of every
+                file it included is the one it was compiled from. Thread
+                safe
+
+      Methods:  GetDefault
+                  Returns the cache shared by the library, on Windows
+                Compile
+                  Loads the bytecode, compiling it on a miss
+                Load
+                  Loads the bytecode if it is current
+                Cook
+                  Compiles the bytecode and stores it
+                GetIncludes
+                  Returns the files a cached shader was compiled from
+                GetStats
+                  Returns the lookups since the cache was created
+                LogStats
+                  Writes the statistics to the debug output
+                ShaderCache
+                  Constructor.
+                ~ShaderCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShaderCache final
+    {
+    public:
+#ifdef _WIN32
+        static ShaderCache& GetDefault();
+#endif
+
+        ShaderCache() = delete;
+        ShaderCache(_In_ ShaderCompiler* pCompiler);
+        ShaderCache(const ShaderCache& other) = delete;
+        ShaderCache(ShaderCache&& other) = delete;
+        ShaderCache& operator=(const ShaderCache& other) = delete;
+        ShaderCache& operator=(ShaderCache&& other) = delete;
+        ~ShaderCache() = default;
+
+        HRESULT Compile(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<BYTE>& outBytecode, _Out_opt_ std::string* pOutMessages = nullptr);
+        HRESULT Load(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<BYTE>& outBytecode);
+        HRESULT Cook(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<BYTE>& outBytecode, _Out_opt_ std::string* pOutMessages = nullptr);
+        HRESULT GetIncludes(_In_ const ShaderCompileDesc& desc, _Out_ std::vector<std::filesystem::path>& outIncludes);
+
+        ShaderCacheStats GetStats();
+        void LogStats();
+
+    private:
+        std::mutex m_mutex;
+        ShaderCompiler* m_pCompiler;
+        ShaderCacheStats m_stats;
+    };
+}
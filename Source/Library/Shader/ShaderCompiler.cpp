@@ -0,0 +1,193 @@
+#include "Shader/ShaderCompiler.h"
+
+#include "Utility/MappedFile.h"
+
+namespace library
+{
+    namespace
+    {
+        /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+          Class:    IncludeRecorder
+
+          Summary:  Maps the files a shader includes, relative to the file
+                    including them, and records their paths
+
+          Methods:  Open
+                      Maps an included file
+                    Close
+                      Unmaps an included file
+                    GetIncludes
+                      Returns the paths of every file opened
+        C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+        class IncludeRecorder final : public ID3DInclude
+        {
+        public:
+            IncludeRecorder(_In_ const std::filesystem::path& directory)
+                : m_directory(directory)
+                , m_files()
+                , m_aIncludes()
+            {
+            }
+
+            HRESULT __stdcall Open(
+                _In_ D3D_INCLUDE_TYPE includeType,
+                _In_ LPCSTR pFileName,
+                _In_opt_ LPCVOID pParentData,
+                _Out_ LPCVOID* ppData,
+                _Out_ UINT* pBytes
+            ) override
+            {
+                UNREFERENCED_PARAMETER(includeType);
+
+                auto parent = m_files.find(pParentData);
+                std::filesystem::path filePath = ((parent != m_files.end() ? parent->second.Directory : m_directory) / pFileName).lexically_normal();
+
+                std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>();
+                HRESULT hr = file->Open(filePath);
+                if (hr == HRESULT_FROM_WIN32(ERROR_HANDLE_EOF))
+                {
+                    // Empty files can't be mapped, and include nothing
+                    static const CHAR s_szEmpty[] = "";
+                    *ppData = s_szEmpty;
+                    *pBytes = 0u;
+                    m_aIncludes.push_back(filePath);
+                    return S_OK;
+                }
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                *ppData = file->GetData();
+                *pBytes = static_cast<UINT>(file->GetSize());
+                m_aIncludes.push_back(filePath);
+                m_files[*ppData] = { .File = std::move(file), .Directory = filePath.parent_path() };
+                return S_OK;
+            }
+
+            HRESULT __stdcall Close(_In_ LPCVOID pData) override
+            {
+                m_files.erase(pData);
+                return S_OK;
+            }
+
+            std::vector<std::filesystem::path>& GetIncludes()
+            {
+                return m_aIncludes;
+            }
+
+        private:
+            struct OpenInclude
+            {
+                std::unique_ptr<MappedFile> File;
+                std::filesystem::path Directory;
+            };
+
+            std::filesystem::path m_directory;
+            std::unordered_map<LPCVOID, OpenInclude> m_files;
+            std::vector<std::filesystem::path> m_aIncludes;
+        };
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetDefaultShaderCompileFlags
+
+      Summary:  Returns the D3DCOMPILE flags the library compiles its
+                shaders with, so the tools fill the cache with the same
+
+      Returns:  UINT
+                  Compile flags
+    -----------------------------------------------------------------F-F*/
+    UINT GetDefaultShaderCompileFlags()
+    {
+        UINT uShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
+#ifdef _DEBUG
+        // Set the D3DCOMPILE_DEBUG flag to embed debug information in the shaders.
+        // Setting this flag improves the shader debugging experience, but still allows 
+        // the shaders to be optimized and to run exactly the way they will run in 
+        // the release configuration of this program.
+        uShaderFlags |= D3DCOMPILE_DEBUG;
+
+        // Disable optimizations to further improve shader debugging
+        uShaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+        return uShaderFlags;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3DShaderCompiler::Compile
+
+      Summary:  Compiles the source file with D3DCompile. Errors and
+                warnings go to the debug output as well
+
+      Args:     const ShaderCompileDesc& desc
+                  File, entry point, target, macros and flags
+                std::vector<BYTE>& outBytecode
+                  Receives the bytecode
+                std::vector<std::filesystem::path>& outIncludes
+                  Receives the paths of the included files
+                std::string& outMessages
+                  Receives the errors and warnings of the compiler
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT D3DShaderCompiler::Compile(
+        _In_ const ShaderCompileDesc& desc,
+        _Out_ std::vector<BYTE>& outBytecode,
+        _Out_ std::vector<std::filesystem::path>& outIncludes,
+        _Out_ std::string& outMessages
+    )
+    {
+        outBytecode.clear();
+        outIncludes.clear();
+        outMessages.clear();
+
+        MappedFile sourceFile;
+        HRESULT hr = sourceFile.Open(desc.FilePath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        std::vector<D3D_SHADER_MACRO> aMacros;
+        aMacros.reserve(desc.aDefines.size() + 1u);
+        for (const ShaderDefine& define : desc.aDefines)
+        {
+            aMacros.push_back({ .Name = define.szName.c_str(), .Definition = define.szValue.c_str() });
+        }
+        aMacros.push_back({ .Name = nullptr, .Definition = nullptr });
+
+        IncludeRecorder includeRecorder(desc.FilePath.parent_path());
+        std::string szSourceName = desc.FilePath.string();
+        ComPtr<ID3DBlob> bytecodeBlob;
+        ComPtr<ID3DBlob> errorBlob;
+        hr = D3DCompile(
+            sourceFile.GetData(),
+            sourceFile.GetSize(),
+            szSourceName.c_str(),
+            aMacros.data(),
+            &includeRecorder,
+            desc.szEntryPoint.c_str(),
+            desc.szTarget.c_str(),
+            desc.uFlags,
+            0u,
+            bytecodeBlob.GetAddressOf(),
+            errorBlob.GetAddressOf()
+        );
+        if (errorBlob)
+        {
+            outMessages = static_cast<PCSTR>(errorBlob->GetBufferPointer());
+            OutputDebugStringA(outMessages.c_str());
+        }
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        const BYTE* pBytecode = static_cast<const BYTE*>(bytecodeBlob->GetBufferPointer());
+        outBytecode.assign(pBytecode, pBytecode + bytecodeBlob->GetBufferSize());
+        outIncludes = std::move(includeRecorder.GetIncludes());
+        return S_OK;
+    }
+}
@@ -0,0 +1,112 @@
+/*+===================================================================
+  File:      SHADERCOMPILER.H
+
+  Summary:   ShaderCompiler header file contains declarations of the
+             interface the ShaderCache compiles HLSL through, and of
+             the D3DShaderCompiler implementing it with the D3D
+             compiler.
+
+  Classes: ShaderCompiler, D3DShaderCompiler
+
+  Functions: GetDefaultShaderCompileFlags
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderDefine
+
+      Summary:  Preprocessor macro a shader is compiled with
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderDefine
+    {
+        std::string szName;
+        std::string szValue;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCompileDesc
+
+      Summary:  Everything a compilation depends on besides the contents
+                of the source file and of its includes
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCompileDesc
+    {
+        std::filesystem::path FilePath;
+        std::string szEntryPoint;
+        std::string szTarget;
+        std::vector<ShaderDefine> aDefines;
+        UINT uFlags;
+    };
+
+    UINT GetDefaultShaderCompileFlags();
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShaderCompiler
+
+      Summary:  Compiles a shader into bytecode and reports the files it
+                included, which the ShaderCache hashes with the source,
+                and the errors and warnings of the compiler.
+                Implementations are called from several threads at once
+
+      Methods:  Compile
+                  Compiles a shader
+                ShaderCompiler
+                  Constructor.
+                ~ShaderCompiler
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShaderCompiler
+    {
+    public:
+        ShaderCompiler() = default;
+        ShaderCompiler(const ShaderCompiler& other) = delete;
+        ShaderCompiler(ShaderCompiler&& other) = delete;
+        ShaderCompiler& operator=(const ShaderCompiler& other) = delete;
+        ShaderCompiler& operator=(ShaderCompiler&& other) = delete;
+        virtual ~ShaderCompiler() = default;
+
+        virtual HRESULT Compile(
+            _In_ const ShaderCompileDesc& desc,
+            _Out_ std::vector<BYTE>& outBytecode,
+            _Out_ std::vector<std::filesystem::path>& outIncludes,
+            _Out_ std::string& outMessages
+        ) = 0;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    D3DShaderCompiler
+
+      Summary:  Compiles with D3DCompile. Includes are resolved from the
+                directory of the file including them and recorded
+
+      Methods:  Compile
+                  Compiles a shader
+                D3DShaderCompiler
+                  Constructor.
+                ~D3DShaderCompiler
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class D3DShaderCompiler final : public ShaderCompiler
+    {
+    public:
+        D3DShaderCompiler() = default;
+        D3DShaderCompiler(const D3DShaderCompiler& other) = delete;
+        D3DShaderCompiler(D3DShaderCompiler&& other) = delete;
+        D3DShaderCompiler& operator=(const D3DShaderCompiler& other) = delete;
+        D3DShaderCompiler& operator=(D3DShaderCompiler&& other) = delete;
+        ~D3DShaderCompiler() = default;
+
+        HRESULT Compile(
+            _In_ const ShaderCompileDesc& desc,
+            _Out_ std::vector<BYTE>& outBytecode,
+            _Out_ std::vector<std::filesystem::path>& outIncludes,
+            _Out_ std::string& outMessages
+        ) override;
+    };
+}
@@ -0,0 +1,132 @@
+#include "Shader/ShaderPermutation.h"
+
+#include "Renderer/DataTypes.h"
+
+#include <bit>
+
+namespace library
+{
+    namespace
+    {
+        // Macros the HLSL tests, in the order of the feature bits
+        constexpr const PCSTR SHADER_FEATURE_NAMES[NUM_SHADER_FEATURES] =
+        {
+            "HAS_NORMAL_MAP",
+            "IS_INSTANCED",
+        };
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetShaderVariantDefines
+
+      Summary:  Returns the macros a variant is compiled with. Every
+                enabled feature is defined as 1, in the order of the
+                bits, followed by the constants shared with the C++
+                side. The ShaderCache keys on the list, so the tools
+                have to build it here too
+
+      Args:     UINT uVariantKey
+                  Enabled features of the variant
+
+      Returns:  std::vector<ShaderDefine>
+                  Macros of the variant
+    -----------------------------------------------------------------F-F*/
+    std::vector<ShaderDefine> GetShaderVariantDefines(_In_ UINT uVariantKey)
+    {
+        std::vector<ShaderDefine> aDefines;
+        for (UINT i = 0u; i < NUM_SHADER_FEATURES; ++i)
+        {
+            if (uVariantKey & (1u << i))
+            {
+                aDefines.push_back({ .szName = SHADER_FEATURE_NAMES[i], .szValue = "1" });
+            }
+        }
+
+        // Loops over the lights unroll to the count the constant buffer holds
+        aDefines.push_back({ .szName = "NUM_LIGHTS", .szValue = std::to_string(NUM_LIGHTS) });
+
+        return aDefines;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetShaderFeatureName
+
+      Summary:  Returns the macro of a feature switch
+
+      Args:     UINT uFeatureIndex
+                  Index of the feature bit
+
+      Returns:  PCSTR
+                  Macro name, nullptr past the last feature
+    -----------------------------------------------------------------F-F*/
+    PCSTR GetShaderFeatureName(_In_ UINT uFeatureIndex)
+    {
+        return uFeatureIndex < NUM_SHADER_FEATURES ? SHADER_FEATURE_NAMES[uFeatureIndex] : nullptr;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetShaderVariantKeyFromName
+
+      Summary:  Returns the feature bit a macro name switches on
+
+      Args:     const std::string& szName
+                  Macro name
+
+      Returns:  UINT
+                  Feature bit, 0 if the name is no feature switch
+    -----------------------------------------------------------------F-F*/
+    UINT GetShaderVariantKeyFromName(_In_ const std::string& szName)
+    {
+        for (UINT i = 0u; i < NUM_SHADER_FEATURES; ++i)
+        {
+            if (szName == SHADER_FEATURE_NAMES[i])
+            {
+                return 1u << i;
+            }
+        }
+        return 0u;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetShaderVariantName
+
+      Summary:  Returns the macros of the features of a variant joined
+                by spaces, for messages
+
+      Args:     UINT uVariantKey
+                  Enabled features of the variant
+
+      Returns:  std::string
+                  Name of the variant, "base" without features
+    -----------------------------------------------------------------F-F*/
+    std::string GetShaderVariantName(_In_ UINT uVariantKey)
+    {
+        std::string szName;
+        for (UINT i = 0u; i < NUM_SHADER_FEATURES; ++i)
+        {
+            if (uVariantKey & (1u << i))
+            {
+                szName += szName.empty() ? "" : " ";
+                szName += SHADER_FEATURE_NAMES[i];
+            }
+        }
+        return szName.empty() ? "base" : szName;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetNumShaderVariants
+
+      Summary:  Returns the number of variants a shader declaring the
+                given switches could be compiled into
+
+      Args:     UINT uFeatures
+                  Declared feature switches
+
+      Returns:  UINT
+                  Number of possible variants
+    -----------------------------------------------------------------F-F*/
+    UINT GetNumShaderVariants(_In_ UINT uFeatures)
+    {
+        return 1u << std::popcount(uFeatures);
+    }
+}
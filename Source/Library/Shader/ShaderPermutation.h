@@ -0,0 +1,34 @@
+/*+===================================================================
+  File:      SHADERPERMUTATION.H
+
+  Summary:   ShaderPermutation header file contains the feature
+             switches a shader can be specialized on, and the macros a
+             variant of a shader is compiled with.
+
+  Functions: GetShaderVariantDefines, GetShaderFeatureName,
+             GetShaderVariantKeyFromName, GetShaderVariantName,
+             GetNumShaderVariants
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/ShaderCompiler.h"
+
+namespace library
+{
+    // Feature switches. A shader declares the ones its HLSL tests with
+    // #if, a renderable reports the ones it needs, and the bits both
+    // have in common select the variant it is drawn with
+    constexpr const UINT SHADER_FEATURE_NORMAL_MAP = 1u << 0u;
+    constexpr const UINT SHADER_FEATURE_INSTANCED = 1u << 1u;
+    constexpr const UINT NUM_SHADER_FEATURES = 2u;
+
+    std::vector<ShaderDefine> GetShaderVariantDefines(_In_ UINT uVariantKey);
+    PCSTR GetShaderFeatureName(_In_ UINT uFeatureIndex);
+    UINT GetShaderVariantKeyFromName(_In_ const std::string& szName);
+    std::string GetShaderVariantName(_In_ UINT uVariantKey);
+    UINT GetNumShaderVariants(_In_ UINT uFeatures);
+}
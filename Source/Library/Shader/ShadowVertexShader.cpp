@@ -2,38 +2,13 @@
 
 namespace library
 {
-    ShadowVertexShader::ShadowVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
-        : VertexShader(pszFileName, pszEntryPoint, pszShaderModel)
+    ShadowVertexShader::ShadowVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures)
+        : VertexShader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures)
     {
     }
 
     HRESULT ShadowVertexShader::Initialize(_In_ ID3D11Device* pDevice)
     {
-        ComPtr<ID3DBlob> vsBlob;
-        HRESULT hr = compile(vsBlob.GetAddressOf());
-        if (FAILED(hr))
-        {
-            WCHAR szMessage[256];
-            swprintf_s(
-                szMessage,
-                L"The FX file %s cannot be compiled. Please run this executable from the directory that contains the FX file.",
-                m_pszFileName
-            );
-            MessageBox(
-                nullptr,
-                szMessage,
-                L"Error",
-                MB_OK
-            );
-            return hr;
-        }
-
-        hr = pDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, m_vertexShader.GetAddressOf());
-        if (FAILED(hr))
-        {
-            return hr;
-        }
-
         // Define the input layout
         D3D11_INPUT_ELEMENT_DESC aLayouts[] =
         {
@@ -49,13 +24,25 @@ namespace library
         };
         UINT uNumElements = ARRAYSIZE(aLayouts);
 
-        // Create the input layout
-        hr = pDevice->CreateInputLayout(aLayouts, uNumElements, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), m_vertexLayout.GetAddressOf());
+        // Create every requested variant, and the input layout from the first
+        HRESULT hr = createVariants(pDevice, aLayouts, uNumElements);
         if (FAILED(hr))
         {
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"The FX file %s cannot be compiled. Please run this executable from the directory that contains the FX file.",
+                m_pszFileName
+            );
+            MessageBox(
+                nullptr,
+                szMessage,
+                L"Error",
+                MB_OK
+            );
             return hr;
         }
 
-        return hr;
+        return S_OK;
     }
 }
\ No newline at end of file
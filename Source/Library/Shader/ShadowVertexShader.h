@@ -21,7 +21,7 @@ namespace library
     {
     public:
         ShadowVertexShader() = delete;
-        ShadowVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        ShadowVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
         ShadowVertexShader(const ShadowVertexShader& other) = delete;
         ShadowVertexShader(ShadowVertexShader&& other) = delete;
         ShadowVertexShader& operator=(const ShadowVertexShader& other) = delete;
@@ -2,15 +2,27 @@
 
 namespace library
 {
-    SkinningVertexShader::SkinningVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
-        : VertexShader(pszFileName, pszEntryPoint, pszShaderModel)
+    SkinningVertexShader::SkinningVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures)
+        : VertexShader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures)
     {
     }
 
     HRESULT SkinningVertexShader::Initialize(_In_ ID3D11Device* pDevice)
     {
-        ComPtr<ID3DBlob> vsBlob;
-        HRESULT hr = compile(vsBlob.GetAddressOf());
+        // Define the input layout
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 20, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+
+            { "BONEINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "BONEWEIGHTS", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 1, 4, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+        };
+        UINT uNumElements = ARRAYSIZE(aLayouts);
+
+        // Create every requested variant, and the input layout from the first
+        HRESULT hr = createVariants(pDevice, aLayouts, uNumElements);
         if (FAILED(hr))
         {
             WCHAR szMessage[256];
@@ -28,27 +40,6 @@ namespace library
             return hr;
         }
 
-        hr = pDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, m_vertexShader.GetAddressOf());
-        if (FAILED(hr))
-        {
-            return hr;
-        }
-
-        // Define the input layout
-        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
-        {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-            { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 20, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-
-            { "BONEINDICES", 0, DXGI_FORMAT_R32G32B32A32_UINT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-            { "BONEWEIGHTS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-        };
-        UINT uNumElements = ARRAYSIZE(aLayouts);
-
-        // Create the input layout
-        hr = pDevice->CreateInputLayout(aLayouts, uNumElements, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), m_vertexLayout.GetAddressOf());
-
-        return hr;
+        return S_OK;
     }
 }
\ No newline at end of file
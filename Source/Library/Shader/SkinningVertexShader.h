@@ -21,7 +21,7 @@ namespace library
     {
     public:
         SkinningVertexShader() = delete;
-        SkinningVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        SkinningVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
         SkinningVertexShader(const SkinningVertexShader& other) = delete;
         SkinningVertexShader(SkinningVertexShader&& other) = delete;
         SkinningVertexShader& operator=(const SkinningVertexShader& other) = delete;
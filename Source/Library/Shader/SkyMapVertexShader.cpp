@@ -15,9 +15,11 @@ namespace library
                 PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
+                UINT uFeatures
+                  SHADER_FEATURE_ switches the shader tests with #if
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    SkyMapVertexShader::SkyMapVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
-        VertexShader(pszFileName,pszEntryPoint,pszShaderModel)
+    SkyMapVertexShader::SkyMapVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures) :
+        VertexShader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures)
     {}
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -33,8 +35,15 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT SkyMapVertexShader::Initialize(_In_ ID3D11Device* pDevice)
     {
-        ComPtr<ID3DBlob> vsBlob;
-        HRESULT hr = compile(vsBlob.GetAddressOf());
+        // Define the input layout
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+        };
+        UINT uNumElements = ARRAYSIZE(aLayouts);
+
+        // Create every requested variant, and the input layout from the first
+        HRESULT hr = createVariants(pDevice, aLayouts, uNumElements);
         if (FAILED(hr))
         {
             WCHAR szMessage[256];
@@ -52,22 +61,6 @@ namespace library
             return hr;
         }
 
-        hr = pDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, m_vertexShader.GetAddressOf());
-        if (FAILED(hr))
-        {
-            return hr;
-        }
-
-        // Define the input layout
-        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
-        {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-        };
-        UINT uNumElements = ARRAYSIZE(aLayouts);
-
-        // Create the input layout
-        hr = pDevice->CreateInputLayout(aLayouts, uNumElements, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), m_vertexLayout.GetAddressOf());
-
-        return hr;
+        return S_OK;
     }
 }
\ No newline at end of file
@@ -33,7 +33,7 @@ namespace library
     {
     public:
         SkyMapVertexShader() = delete;
-        SkyMapVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        SkyMapVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
         SkyMapVertexShader(const SkyMapVertexShader& other) = delete;
         SkyMapVertexShader(SkyMapVertexShader&& other) = delete;
         SkyMapVertexShader& operator=(const SkyMapVertexShader& other) = delete;
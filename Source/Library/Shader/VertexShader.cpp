@@ -15,19 +15,22 @@ namespace library
                 PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
+                UINT uFeatures
+                  SHADER_FEATURE_ switches the shader tests with #if
 
-      Modifies: [m_vertexShader].[m_vertexLayout]
+      Modifies: [m_vertexShaders].[m_vertexLayout]
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    VertexShader::VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
-        Shader(pszFileName,pszEntryPoint,pszShaderModel),
-        m_vertexLayout(nullptr),
-        m_vertexShader(nullptr)
+    VertexShader::VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures) :
+        Shader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures),
+        m_vertexShaders(),
+        m_vertexLayout(nullptr)
     {}
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   VertexShader::Initialize
 
-      Summary:  Initializes the vertex shader and the input layout
+      Summary:  Initializes the vertex shader variants and the input
+                layout
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the vertex shader
@@ -37,26 +40,8 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT VertexShader::Initialize(_In_ ID3D11Device* pDevice)
     {
-        HRESULT hr = S_OK;
-        ComPtr<ID3DBlob> VSBlob;
-        //Compile a vertex shader
-        hr = compile(VSBlob.GetAddressOf());
-        if (FAILED(hr))
-        {
-            return hr;
-        }
-        //Create the Direct3D Vertex Shader object
-        hr = pDevice->CreateVertexShader(VSBlob->GetBufferPointer(),
-            VSBlob->GetBufferSize(),
-            nullptr, 
-            m_vertexShader.GetAddressOf()
-        );
-        if (FAILED(hr))
-        {
-            return hr;
-        }
         // Define the input layout
-        D3D11_INPUT_ELEMENT_DESC layout[] =
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
         {
             { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
             { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
@@ -66,32 +51,31 @@ namespace library
             { "INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 2, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
             { "INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 2, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
             { "INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 2, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
-            { "INSTANCE_TRANSFORM", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 2, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+            { "INSTANCE_TRANSFORM", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 2, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "INSTANCE_BLOCK_ID", 0, DXGI_FORMAT_R32_UINT, 2, 64, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
         };
-        UINT numElements = ARRAYSIZE(layout);
-        // Create the input layout
-        hr = pDevice->CreateInputLayout(layout,
-            numElements,
-            VSBlob->GetBufferPointer(),
-            VSBlob->GetBufferSize(),
-            &m_vertexLayout
-        );
-        if (FAILED(hr))
-            return hr;
-        return hr;
+        UINT uNumElements = ARRAYSIZE(aLayouts);
+
+        // Create every requested variant, and the input layout from the first
+        return createVariants(pDevice, aLayouts, uNumElements);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   VertexShader::GetVertexShader
 
-      Summary:  Returns the vertex shader
+      Summary:  Returns the variant drawing an object with the given
+                features
+
+      Args:     UINT uFeatures
+                  SHADER_FEATURE_ bits of the object
 
       Returns:  ComPtr<ID3D11VertexShader>&
-                  Vertex shader. Could be a nullptr
+                  Vertex shader. A nullptr if the variant was not
+                  requested before Initialize
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11VertexShader>& VertexShader::GetVertexShader()
+    ComPtr<ID3D11VertexShader>& VertexShader::GetVertexShader(_In_opt_ UINT uFeatures)
     {
-        return m_vertexShader;
+        return m_vertexShaders[GetVariantKey(uFeatures)];
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   VertexShader::GetVertexLayout
@@ -105,4 +89,62 @@ namespace library
     {
         return m_vertexLayout;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::createVariants
+
+      Summary:  Creates the requested variants that do not exist yet.
+                The switches only change code, not the inputs, so every
+                variant shares the input layout created from the first
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shaders
+                const D3D11_INPUT_ELEMENT_DESC* aLayouts
+                  Input layout elements
+                UINT uNumElements
+                  Number of elements
+
+      Modifies: [m_vertexShaders, m_vertexLayout].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VertexShader::createVariants(
+        _In_ ID3D11Device* pDevice,
+        _In_reads_(uNumElements) const D3D11_INPUT_ELEMENT_DESC* aLayouts,
+        _In_ UINT uNumElements
+    )
+    {
+        for (UINT uVariantKey : getRequestedVariants())
+        {
+            if (m_vertexShaders[uVariantKey])
+            {
+                continue;
+            }
+
+            ComPtr<ID3DBlob> vsBlob;
+            HRESULT hr = compile(uVariantKey, vsBlob.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = pDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, m_vertexShaders[uVariantKey].GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            if (!m_vertexLayout)
+            {
+                hr = pDevice->CreateInputLayout(aLayouts, uNumElements, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), m_vertexLayout.GetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        return S_OK;
+    }
 }
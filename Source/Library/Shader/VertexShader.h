@@ -23,11 +23,14 @@ namespace library
       Summary:  Vertex shader
 
       Methods:  Initialize
-                  Initializes the vertex shader and the input layout
+                  Initializes the vertex shader variants and the input
+                  layout
                 GetVertexShader
-                  Returns the vertex shader
+                  Returns the vertex shader variant of given features
                 GetVertexLayout
                   Returns the vertex input layout
+                createVariants
+                  Creates the requested variants and the input layout
                 Game
                   Constructor.
                 ~Game
@@ -37,7 +40,7 @@ namespace library
     {
     public:
         VertexShader() = delete;
-        VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_opt_ UINT uFeatures = 0u);
         VertexShader(const VertexShader& other) = delete;
         VertexShader(VertexShader&& other) = delete;
         VertexShader& operator=(const VertexShader& other) = delete;
@@ -46,11 +49,17 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
 
-        ComPtr<ID3D11VertexShader>& GetVertexShader();
+        ComPtr<ID3D11VertexShader>& GetVertexShader(_In_opt_ UINT uFeatures = 0u);
         ComPtr<ID3D11InputLayout>& GetVertexLayout();
 
     protected:
-        ComPtr<ID3D11VertexShader> m_vertexShader;
+        HRESULT createVariants(
+            _In_ ID3D11Device* pDevice,
+            _In_reads_(uNumElements) const D3D11_INPUT_ELEMENT_DESC* aLayouts,
+            _In_ UINT uNumElements
+        );
+
+        std::unordered_map<UINT, ComPtr<ID3D11VertexShader>> m_vertexShaders;
         ComPtr<ID3D11InputLayout> m_vertexLayout;
     };
 }
\ No newline at end of file
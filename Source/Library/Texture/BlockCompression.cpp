@@ -0,0 +1,1279 @@
+#include "Texture/BlockCompression.h"
+
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT COMPRESS_GRAIN_SIZE = 64u;
+        constexpr const UINT PRINCIPAL_AXIS_ITERATIONS = 8u;
+        constexpr const UINT REFINE_ITERATIONS = 2u;
+        constexpr const FLOAT COMPRESSION_EPSILON = 1e-6f;
+        constexpr const BYTE BC1_ALPHA_THRESHOLD = 128u;
+        constexpr const UINT BC7_MODE6_NUM_INDICES = 16u;
+        constexpr const UINT BC7_MODE6_WEIGHTS[BC7_MODE6_NUM_INDICES] =
+        {
+            0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: computeEndpoints
+
+          Summary:  Fits a line through the colors with the principal
+                    axis of their covariance, found by power iteration,
+                    and returns the extent of the colors along it. Only
+                    the channels set in the colors take part, so RGB
+                    blocks pass colors with a zero w
+
+          Args:     const XMVECTOR* aColors
+                      Colors in the range [0, 255]
+                    UINT uNumColors
+                      Number of colors, at least 1
+                    XMVECTOR& outEndpoint0
+                      Receives the end of the line the axis points to
+                    XMVECTOR& outEndpoint1
+                      Receives the other end of the line
+        -----------------------------------------------------------------F-F*/
+        void computeEndpoints(
+            _In_reads_(uNumColors) const XMVECTOR* aColors,
+            _In_ UINT uNumColors,
+            _Out_ XMVECTOR& outEndpoint0,
+            _Out_ XMVECTOR& outEndpoint1
+        )
+        {
+            XMVECTOR mean = XMVectorZero();
+            XMVECTOR minColor = aColors[0];
+            XMVECTOR maxColor = aColors[0];
+            for (UINT i = 0u; i < uNumColors; ++i)
+            {
+                mean = XMVectorAdd(mean, aColors[i]);
+                minColor = XMVectorMin(minColor, aColors[i]);
+                maxColor = XMVectorMax(maxColor, aColors[i]);
+            }
+            mean = XMVectorScale(mean, 1.0f / static_cast<FLOAT>(uNumColors));
+
+            // Rows of the symmetric covariance matrix
+            XMVECTOR aCovariance[4] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+            for (UINT i = 0u; i < uNumColors; ++i)
+            {
+                XMVECTOR offset = XMVectorSubtract(aColors[i], mean);
+                aCovariance[0] = XMVectorMultiplyAdd(offset, XMVectorSplatX(offset), aCovariance[0]);
+                aCovariance[1] = XMVectorMultiplyAdd(offset, XMVectorSplatY(offset), aCovariance[1]);
+                aCovariance[2] = XMVectorMultiplyAdd(offset, XMVectorSplatZ(offset), aCovariance[2]);
+                aCovariance[3] = XMVectorMultiplyAdd(offset, XMVectorSplatW(offset), aCovariance[3]);
+            }
+
+            XMVECTOR axis = XMVectorSubtract(maxColor, minColor);
+            for (UINT uIteration = 0u; uIteration < PRINCIPAL_AXIS_ITERATIONS; ++uIteration)
+            {
+                XMVECTOR next = XMVectorMultiply(aCovariance[0], XMVectorSplatX(axis));
+                next = XMVectorMultiplyAdd(aCovariance[1], XMVectorSplatY(axis), next);
+                next = XMVectorMultiplyAdd(aCovariance[2], XMVectorSplatZ(axis), next);
+                next = XMVectorMultiplyAdd(aCovariance[3], XMVectorSplatW(axis), next);
+
+                FLOAT lengthSquared = XMVectorGetX(XMVector4LengthSq(next));
+                if (lengthSquared < COMPRESSION_EPSILON)
+                {
+                    break;
+                }
+                axis = XMVectorScale(next, 1.0f / std::sqrt(lengthSquared));
+            }
+
+            FLOAT lengthSquared = XMVectorGetX(XMVector4LengthSq(axis));
+            if (lengthSquared < COMPRESSION_EPSILON)
+            {
+                outEndpoint0 = mean;
+                outEndpoint1 = mean;
+                return;
+            }
+            axis = XMVectorScale(axis, 1.0f / std::sqrt(lengthSquared));
+
+            FLOAT minProjection = std::numeric_limits<FLOAT>::max();
+            FLOAT maxProjection = -std::numeric_limits<FLOAT>::max();
+            for (UINT i = 0u; i < uNumColors; ++i)
+            {
+                FLOAT projection = XMVectorGetX(XMVector4Dot(XMVectorSubtract(aColors[i], mean), axis));
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+
+            XMVECTOR minValue = XMVectorZero();
+            XMVECTOR maxValue = XMVectorReplicate(255.0f);
+            outEndpoint0 = XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(maxProjection), mean), minValue, maxValue);
+            outEndpoint1 = XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(minProjection), mean), minValue, maxValue);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: fitLeastSquares
+
+          Summary:  Returns the two endpoints whose blend with the given
+                    per color weights is closest to the colors
+
+          Args:     const XMVECTOR* aColors
+                      Colors to fit
+                    const FLOAT* aWeights
+                      Weight of the first endpoint of each color, the
+                      second one gets the rest
+                    UINT uNumColors
+                      Number of colors
+                    XMVECTOR& inOutEndpoint0
+                      First endpoint, left as is if the weights can't
+                      separate the endpoints
+                    XMVECTOR& inOutEndpoint1
+                      Second endpoint
+
+          Returns:  BOOL
+                      TRUE if the endpoints were refitted
+        -----------------------------------------------------------------F-F*/
+        BOOL fitLeastSquares(
+            _In_reads_(uNumColors) const XMVECTOR* aColors,
+            _In_reads_(uNumColors) const FLOAT* aWeights,
+            _In_ UINT uNumColors,
+            _Inout_ XMVECTOR& inOutEndpoint0,
+            _Inout_ XMVECTOR& inOutEndpoint1
+        )
+        {
+            FLOAT sumAA = 0.0f;
+            FLOAT sumAB = 0.0f;
+            FLOAT sumBB = 0.0f;
+            XMVECTOR sumAX = XMVectorZero();
+            XMVECTOR sumBX = XMVectorZero();
+            for (UINT i = 0u; i < uNumColors; ++i)
+            {
+                FLOAT a = aWeights[i];
+                FLOAT b = 1.0f - a;
+                sumAA += a * a;
+                sumAB += a * b;
+                sumBB += b * b;
+                sumAX = XMVectorMultiplyAdd(aColors[i], XMVectorReplicate(a), sumAX);
+                sumBX = XMVectorMultiplyAdd(aColors[i], XMVectorReplicate(b), sumBX);
+            }
+
+            FLOAT determinant = sumAA * sumBB - sumAB * sumAB;
+            if (std::fabs(determinant) < COMPRESSION_EPSILON)
+            {
+                return FALSE;
+            }
+
+            FLOAT inverse = 1.0f / determinant;
+            XMVECTOR minValue = XMVectorZero();
+            XMVECTOR maxValue = XMVectorReplicate(255.0f);
+            inOutEndpoint0 = XMVectorClamp(
+                XMVectorScale(XMVectorSubtract(XMVectorScale(sumAX, sumBB), XMVectorScale(sumBX, sumAB)), inverse),
+                minValue,
+                maxValue
+            );
+            inOutEndpoint1 = XMVectorClamp(
+                XMVectorScale(XMVectorSubtract(XMVectorScale(sumBX, sumAA), XMVectorScale(sumAX, sumAB)), inverse),
+                minValue,
+                maxValue
+            );
+            return TRUE;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: quantize565
+
+          Summary:  Rounds a color to 5:6:5 bits
+
+          Args:     FXMVECTOR color
+                      Color in the range [0, 255]
+
+          Returns:  WORD
+                      Packed color
+        -----------------------------------------------------------------F-F*/
+        WORD quantize565(_In_ FXMVECTOR color)
+        {
+            XMFLOAT4 value;
+            XMStoreFloat4(&value, color);
+
+            UINT uRed = std::min(static_cast<UINT>(value.x * (31.0f / 255.0f) + 0.5f), 31u);
+            UINT uGreen = std::min(static_cast<UINT>(value.y * (63.0f / 255.0f) + 0.5f), 63u);
+            UINT uBlue = std::min(static_cast<UINT>(value.z * (31.0f / 255.0f) + 0.5f), 31u);
+            return static_cast<WORD>((uRed << 11u) | (uGreen << 5u) | uBlue);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: buildColorPalette
+
+          Summary:  Decodes the four colors of a BC1 color block
+
+          Args:     WORD uColor0
+                      First 5:6:5 endpoint
+                    WORD uColor1
+                      Second 5:6:5 endpoint
+                    BOOL bFourColors
+                      Whether the block interpolates two colors, or one
+                      color and transparent black
+                    BYTE aOutPalette[4][4]
+                      Receives the RGBA colors of the four indices
+        -----------------------------------------------------------------F-F*/
+        void buildColorPalette(_In_ WORD uColor0, _In_ WORD uColor1, _In_ BOOL bFourColors, _Out_ BYTE aOutPalette[4][4])
+        {
+            const WORD auColors[2] = { uColor0, uColor1 };
+            for (UINT i = 0u; i < 2u; ++i)
+            {
+                UINT uRed = (auColors[i] >> 11u) & 31u;
+                UINT uGreen = (auColors[i] >> 5u) & 63u;
+                UINT uBlue = auColors[i] & 31u;
+                aOutPalette[i][0] = static_cast<BYTE>((uRed << 3u) | (uRed >> 2u));
+                aOutPalette[i][1] = static_cast<BYTE>((uGreen << 2u) | (uGreen >> 4u));
+                aOutPalette[i][2] = static_cast<BYTE>((uBlue << 3u) | (uBlue >> 2u));
+                aOutPalette[i][3] = 255u;
+            }
+
+            for (UINT c = 0u; c < 3u; ++c)
+            {
+                UINT uValue0 = aOutPalette[0][c];
+                UINT uValue1 = aOutPalette[1][c];
+                if (bFourColors)
+                {
+                    aOutPalette[2][c] = static_cast<BYTE>((2u * uValue0 + uValue1 + 1u) / 3u);
+                    aOutPalette[3][c] = static_cast<BYTE>((uValue0 + 2u * uValue1 + 1u) / 3u);
+                }
+                else
+                {
+                    aOutPalette[2][c] = static_cast<BYTE>((uValue0 + uValue1 + 1u) / 2u);
+                    aOutPalette[3][c] = 0u;
+                }
+            }
+            aOutPalette[2][3] = 255u;
+            aOutPalette[3][3] = bFourColors ? 255u : 0u;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: buildAlphaPalette
+
+          Summary:  Decodes the eight values of a BC4 block
+
+          Args:     BYTE uValue0
+                      First endpoint
+                    BYTE uValue1
+                      Second endpoint
+                    BYTE aOutPalette[8]
+                      Receives the values of the eight indices. Blocks
+                      whose first endpoint is not greater interpolate
+                      six values and add 0 and 255
+        -----------------------------------------------------------------F-F*/
+        void buildAlphaPalette(_In_ BYTE uValue0, _In_ BYTE uValue1, _Out_writes_(8) BYTE* aOutPalette)
+        {
+            aOutPalette[0] = uValue0;
+            aOutPalette[1] = uValue1;
+            if (uValue0 > uValue1)
+            {
+                for (UINT i = 1u; i < 7u; ++i)
+                {
+                    aOutPalette[i + 1u] = static_cast<BYTE>(((7u - i) * uValue0 + i * uValue1 + 3u) / 7u);
+                }
+            }
+            else
+            {
+                for (UINT i = 1u; i < 5u; ++i)
+                {
+                    aOutPalette[i + 1u] = static_cast<BYTE>(((5u - i) * uValue0 + i * uValue1 + 2u) / 5u);
+                }
+                aOutPalette[6] = 0u;
+                aOutPalette[7] = 255u;
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: loadPaletteColor
+
+          Summary:  Loads a decoded palette color for the distance tests
+
+          Args:     const BYTE* pColor
+                      RGBA color
+
+          Returns:  XMVECTOR
+                      Color in the range [0, 255]
+        -----------------------------------------------------------------F-F*/
+        XMVECTOR loadPaletteColor(_In_reads_(4) const BYTE* pColor)
+        {
+            return XMVectorSet(
+                static_cast<FLOAT>(pColor[0]),
+                static_cast<FLOAT>(pColor[1]),
+                static_cast<FLOAT>(pColor[2]),
+                static_cast<FLOAT>(pColor[3])
+            );
+        }
+
+        struct ColorBlockFit
+        {
+            WORD uColor0;
+            WORD uColor1;
+            UINT uIndices;
+            BOOL bFourColors;
+            FLOAT Error;
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: evaluateColorBlock
+
+          Summary:  Quantizes two endpoints, orders them for the wanted
+                    mode and picks the closest palette color of every
+                    pixel
+
+          Args:     const XMVECTOR* aPixels
+                      RGB of the 16 pixels with a zero w
+                    const BOOL* abTransparent
+                      Pixels written with the transparent index
+                    FXMVECTOR endpoint0
+                      First endpoint
+                    FXMVECTOR endpoint1
+                      Second endpoint
+                    BOOL bPunchThrough
+                      Whether the block must keep the transparent index
+                    BOOL bAlwaysFourColors
+                      Whether the decoder ignores the endpoint order, as
+                      in the color half of BC3
+
+          Returns:  ColorBlockFit
+                      Encoded block and its squared error
+        -----------------------------------------------------------------F-F*/
+        ColorBlockFit evaluateColorBlock(
+            _In_reads_(BC_BLOCK_NUM_PIXELS) const XMVECTOR* aPixels,
+            _In_reads_(BC_BLOCK_NUM_PIXELS) const BOOL* abTransparent,
+            _In_ FXMVECTOR endpoint0,
+            _In_ FXMVECTOR endpoint1,
+            _In_ BOOL bPunchThrough,
+            _In_ BOOL bAlwaysFourColors
+        )
+        {
+            ColorBlockFit fit =
+            {
+                .uColor0 = quantize565(endpoint0),
+                .uColor1 = quantize565(endpoint1),
+                .uIndices = 0u,
+                .bFourColors = TRUE,
+                .Error = 0.0f
+            };
+
+            // BC1 picks the mode from the endpoint order
+            if (!bAlwaysFourColors)
+            {
+                if (bPunchThrough ? fit.uColor0 > fit.uColor1 : fit.uColor0 < fit.uColor1)
+                {
+                    std::swap(fit.uColor0, fit.uColor1);
+                }
+                fit.bFourColors = fit.uColor0 > fit.uColor1;
+            }
+
+            BYTE aPalette[4][4];
+            buildColorPalette(fit.uColor0, fit.uColor1, fit.bFourColors, aPalette);
+
+            XMVECTOR aPaletteColors[4];
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                aPaletteColors[i] = XMVectorSetW(loadPaletteColor(aPalette[i]), 0.0f);
+            }
+
+            UINT uNumOpaqueIndices = fit.bFourColors ? 4u : 3u;
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                UINT uBest = 3u;
+                if (!abTransparent[i])
+                {
+                    FLOAT bestError = std::numeric_limits<FLOAT>::max();
+                    for (UINT k = 0u; k < uNumOpaqueIndices; ++k)
+                    {
+                        FLOAT error = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(aPixels[i], aPaletteColors[k])));
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            uBest = k;
+                        }
+                    }
+                    fit.Error += bestError;
+                }
+                fit.uIndices |= uBest << (2u * i);
+            }
+
+            return fit;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: encodeColorBlock
+
+          Summary:  Encodes the RGB of a block as a BC1 color block. The
+                    endpoints start on the principal axis of the opaque
+                    pixels and are refitted to the chosen indices
+
+          Args:     const BYTE* aRgba
+                      RGBA of the 16 pixels
+                    BOOL bPunchThrough
+                      Whether pixels with alpha below 128 are written
+                      transparent
+                    BOOL bAlwaysFourColors
+                      Whether the block is the color half of BC3
+                    BYTE* pOutBlock
+                      Receives the 8 bytes of the block
+        -----------------------------------------------------------------F-F*/
+        void encodeColorBlock(
+            _In_reads_(BC_BLOCK_NUM_PIXELS * 4u) const BYTE* aRgba,
+            _In_ BOOL bPunchThrough,
+            _In_ BOOL bAlwaysFourColors,
+            _Out_writes_bytes_(8u) BYTE* pOutBlock
+        )
+        {
+            XMVECTOR aPixels[BC_BLOCK_NUM_PIXELS];
+            XMVECTOR aOpaquePixels[BC_BLOCK_NUM_PIXELS];
+            BOOL abTransparent[BC_BLOCK_NUM_PIXELS];
+            UINT uNumOpaque = 0u;
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                aPixels[i] = XMVectorSetW(loadPaletteColor(aRgba + i * 4u), 0.0f);
+                abTransparent[i] = bPunchThrough && aRgba[i * 4u + 3u] < BC1_ALPHA_THRESHOLD;
+                if (!abTransparent[i])
+                {
+                    aOpaquePixels[uNumOpaque++] = aPixels[i];
+                }
+            }
+
+            ColorBlockFit best =
+            {
+                .uColor0 = 0u,
+                .uColor1 = 0u,
+                .uIndices = 0xFFFFFFFFu,
+                .bFourColors = FALSE,
+                .Error = 0.0f
+            };
+
+            if (uNumOpaque > 0u)
+            {
+                XMVECTOR endpoint0;
+                XMVECTOR endpoint1;
+                computeEndpoints(aOpaquePixels, uNumOpaque, endpoint0, endpoint1);
+                best = evaluateColorBlock(aPixels, abTransparent, endpoint0, endpoint1, bPunchThrough, bAlwaysFourColors);
+
+                for (UINT uIteration = 0u; uIteration < REFINE_ITERATIONS && best.Error > 0.0f; ++uIteration)
+                {
+                    const FLOAT aIndexWeights[4] =
+                    {
+                        1.0f,
+                        0.0f,
+                        best.bFourColors ? 2.0f / 3.0f : 0.5f,
+                        1.0f / 3.0f
+                    };
+
+                    FLOAT aWeights[BC_BLOCK_NUM_PIXELS];
+                    UINT uNumWeights = 0u;
+                    for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+                    {
+                        if (!abTransparent[i])
+                        {
+                            aWeights[uNumWeights++] = aIndexWeights[(best.uIndices >> (2u * i)) & 3u];
+                        }
+                    }
+
+                    if (!fitLeastSquares(aOpaquePixels, aWeights, uNumOpaque, endpoint0, endpoint1))
+                    {
+                        break;
+                    }
+
+                    ColorBlockFit fit = evaluateColorBlock(aPixels, abTransparent, endpoint0, endpoint1, bPunchThrough, bAlwaysFourColors);
+                    if (fit.Error >= best.Error)
+                    {
+                        break;
+                    }
+                    best = fit;
+                }
+            }
+
+            pOutBlock[0] = static_cast<BYTE>(best.uColor0 & 0xFFu);
+            pOutBlock[1] = static_cast<BYTE>(best.uColor0 >> 8u);
+            pOutBlock[2] = static_cast<BYTE>(best.uColor1 & 0xFFu);
+            pOutBlock[3] = static_cast<BYTE>(best.uColor1 >> 8u);
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                pOutBlock[4u + i] = static_cast<BYTE>((best.uIndices >> (8u * i)) & 0xFFu);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: evaluateAlphaBlock
+
+          Summary:  Picks the closest palette value of every pixel for a
+                    pair of BC4 endpoints
+
+          Args:     const BYTE* aValues
+                      Values of the 16 pixels, 4 bytes apart
+                    BYTE uValue0
+                      First endpoint
+                    BYTE uValue1
+                      Second endpoint
+                    UINT64& outIndices
+                      Receives the 48 bits of indices
+
+          Returns:  UINT
+                      Squared error
+        -----------------------------------------------------------------F-F*/
+        UINT evaluateAlphaBlock(
+            _In_reads_(BC_BLOCK_NUM_PIXELS * 4u) const BYTE* aValues,
+            _In_ BYTE uValue0,
+            _In_ BYTE uValue1,
+            _Out_ UINT64& outIndices
+        )
+        {
+            BYTE aPalette[8];
+            buildAlphaPalette(uValue0, uValue1, aPalette);
+
+            UINT uError = 0u;
+            outIndices = 0ull;
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                INT iValue = aValues[i * 4u];
+                UINT uBest = 0u;
+                UINT uBestError = std::numeric_limits<UINT>::max();
+                for (UINT k = 0u; k < 8u; ++k)
+                {
+                    INT iDifference = iValue - static_cast<INT>(aPalette[k]);
+                    UINT uDifference = static_cast<UINT>(iDifference * iDifference);
+                    if (uDifference < uBestError)
+                    {
+                        uBestError = uDifference;
+                        uBest = k;
+                    }
+                }
+                uError += uBestError;
+                outIndices |= static_cast<UINT64>(uBest) << (3u * i);
+            }
+
+            return uError;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: encodeAlphaBlock
+
+          Summary:  Encodes one channel of a block as a BC4 block. Tries
+                    eight values between the extremes, and six values
+                    plus 0 and 255 between the other extremes
+
+          Args:     const BYTE* aValues
+                      Values of the 16 pixels, 4 bytes apart
+                    BYTE* pOutBlock
+                      Receives the 8 bytes of the block
+        -----------------------------------------------------------------F-F*/
+        void encodeAlphaBlock(_In_reads_(BC_BLOCK_NUM_PIXELS * 4u) const BYTE* aValues, _Out_writes_bytes_(8u) BYTE* pOutBlock)
+        {
+            BYTE uMin = 255u;
+            BYTE uMax = 0u;
+            BYTE uInnerMin = 255u;
+            BYTE uInnerMax = 0u;
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                BYTE uValue = aValues[i * 4u];
+                uMin = std::min(uMin, uValue);
+                uMax = std::max(uMax, uValue);
+                if (uValue != 0u && uValue != 255u)
+                {
+                    uInnerMin = std::min(uInnerMin, uValue);
+                    uInnerMax = std::max(uInnerMax, uValue);
+                }
+            }
+
+            BYTE uValue0 = uMax;
+            BYTE uValue1 = uMin;
+            UINT64 ullIndices = 0ull;
+            UINT uError = evaluateAlphaBlock(aValues, uValue0, uValue1, ullIndices);
+
+            if (uError > 0u && uInnerMin <= uInnerMax)
+            {
+                UINT64 ullSixIndices = 0ull;
+                UINT uSixError = evaluateAlphaBlock(aValues, uInnerMin, uInnerMax, ullSixIndices);
+                if (uSixError < uError)
+                {
+                    uValue0 = uInnerMin;
+                    uValue1 = uInnerMax;
+                    ullIndices = ullSixIndices;
+                }
+            }
+
+            pOutBlock[0] = uValue0;
+            pOutBlock[1] = uValue1;
+            for (UINT i = 0u; i < 6u; ++i)
+            {
+                pOutBlock[2u + i] = static_cast<BYTE>((ullIndices >> (8u * i)) & 0xFFu);
+            }
+        }
+
+        struct Bc7Fit
+        {
+            BYTE aEndpoints[2][4];
+            UINT auPBits[2];
+            BYTE auIndices[BC_BLOCK_NUM_PIXELS];
+            FLOAT Error;
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: quantizeBc7Endpoint
+
+          Summary:  Rounds an endpoint to 7 bits per channel and picks
+                    the shared low bit that loses the least
+
+          Args:     FXMVECTOR endpoint
+                      RGBA in the range [0, 255]
+                    BYTE* aOutEndpoint
+                      Receives the 8 bit RGBA the decoder will see
+                    UINT& outPBit
+                      Receives the shared low bit
+        -----------------------------------------------------------------F-F*/
+        void quantizeBc7Endpoint(_In_ FXMVECTOR endpoint, _Out_writes_(4) BYTE* aOutEndpoint, _Out_ UINT& outPBit)
+        {
+            XMFLOAT4 value;
+            XMStoreFloat4(&value, endpoint);
+            const FLOAT aValues[4] = { value.x, value.y, value.z, value.w };
+
+            FLOAT bestError = std::numeric_limits<FLOAT>::max();
+            outPBit = 0u;
+            for (UINT uPBit = 0u; uPBit < 2u; ++uPBit)
+            {
+                BYTE aCandidate[4];
+                FLOAT error = 0.0f;
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    FLOAT quantized = std::round((aValues[c] - static_cast<FLOAT>(uPBit)) * 0.5f);
+                    UINT uQuantized = static_cast<UINT>(std::clamp(quantized, 0.0f, 127.0f));
+                    aCandidate[c] = static_cast<BYTE>((uQuantized << 1u) | uPBit);
+
+                    FLOAT difference = static_cast<FLOAT>(aCandidate[c]) - aValues[c];
+                    error += difference * difference;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    outPBit = uPBit;
+                    std::copy(aCandidate, aCandidate + 4, aOutEndpoint);
+                }
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: evaluateBc7Block
+
+          Summary:  Quantizes two endpoints to mode 6 and picks the
+                    closest of the 16 interpolated colors of every pixel
+
+          Args:     const XMVECTOR* aPixels
+                      RGBA of the 16 pixels
+                    FXMVECTOR endpoint0
+                      First endpoint
+                    FXMVECTOR endpoint1
+                      Second endpoint
+
+          Returns:  Bc7Fit
+                      Quantized block and its squared error
+        -----------------------------------------------------------------F-F*/
+        Bc7Fit evaluateBc7Block(
+            _In_reads_(BC_BLOCK_NUM_PIXELS) const XMVECTOR* aPixels,
+            _In_ FXMVECTOR endpoint0,
+            _In_ FXMVECTOR endpoint1
+        )
+        {
+            Bc7Fit fit = {};
+            quantizeBc7Endpoint(endpoint0, fit.aEndpoints[0], fit.auPBits[0]);
+            quantizeBc7Endpoint(endpoint1, fit.aEndpoints[1], fit.auPBits[1]);
+
+            XMVECTOR aPaletteColors[BC7_MODE6_NUM_INDICES];
+            for (UINT k = 0u; k < BC7_MODE6_NUM_INDICES; ++k)
+            {
+                BYTE aColor[4];
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    aColor[c] = static_cast<BYTE>(
+                        ((64u - BC7_MODE6_WEIGHTS[k]) * fit.aEndpoints[0][c] + BC7_MODE6_WEIGHTS[k] * fit.aEndpoints[1][c] + 32u) >> 6u
+                    );
+                }
+                aPaletteColors[k] = loadPaletteColor(aColor);
+            }
+
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                FLOAT bestError = std::numeric_limits<FLOAT>::max();
+                for (UINT k = 0u; k < BC7_MODE6_NUM_INDICES; ++k)
+                {
+                    FLOAT error = XMVectorGetX(XMVector4LengthSq(XMVectorSubtract(aPixels[i], aPaletteColors[k])));
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        fit.auIndices[i] = static_cast<BYTE>(k);
+                    }
+                }
+                fit.Error += bestError;
+            }
+
+            return fit;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: writeBits
+
+          Summary:  Writes a value into a block, least significant bit
+                    first
+
+          Args:     BYTE* pBlock
+                      Block to write
+                    UINT& inOutBitOffset
+                      Offset of the first bit, advanced past the value
+                    UINT uValue
+                      Value to write
+                    UINT uNumBits
+                      Number of bits of the value
+        -----------------------------------------------------------------F-F*/
+        void writeBits(_Inout_updates_bytes_(16u) BYTE* pBlock, _Inout_ UINT& inOutBitOffset, _In_ UINT uValue, _In_ UINT uNumBits)
+        {
+            for (UINT i = 0u; i < uNumBits; ++i, ++inOutBitOffset)
+            {
+                if ((uValue >> i) & 1u)
+                {
+                    pBlock[inOutBitOffset >> 3u] |= static_cast<BYTE>(1u << (inOutBitOffset & 7u));
+                }
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: readBits
+
+          Summary:  Reads a value from a block, least significant bit
+                    first
+
+          Args:     const BYTE* pBlock
+                      Block to read
+                    UINT& inOutBitOffset
+                      Offset of the first bit, advanced past the value
+                    UINT uNumBits
+                      Number of bits of the value
+
+          Returns:  UINT
+                      Value read
+        -----------------------------------------------------------------F-F*/
+        UINT readBits(_In_reads_bytes_(16u) const BYTE* pBlock, _Inout_ UINT& inOutBitOffset, _In_ UINT uNumBits)
+        {
+            UINT uValue = 0u;
+            for (UINT i = 0u; i < uNumBits; ++i, ++inOutBitOffset)
+            {
+                uValue |= ((pBlock[inOutBitOffset >> 3u] >> (inOutBitOffset & 7u)) & 1u) << i;
+            }
+            return uValue;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: encodeBc7Block
+
+          Summary:  Encodes a block as BC7 mode 6, a single RGBA line with
+                    7 bit endpoints, shared low bits and 4 bit indices.
+                    The endpoints start on the principal axis and are
+                    refitted to the chosen indices
+
+          Args:     const BYTE* aRgba
+                      RGBA of the 16 pixels
+                    BYTE* pOutBlock
+                      Receives the 16 bytes of the block
+        -----------------------------------------------------------------F-F*/
+        void encodeBc7Block(_In_reads_(BC_BLOCK_NUM_PIXELS * 4u) const BYTE* aRgba, _Out_writes_bytes_(16u) BYTE* pOutBlock)
+        {
+            XMVECTOR aPixels[BC_BLOCK_NUM_PIXELS];
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                aPixels[i] = loadPaletteColor(aRgba + i * 4u);
+            }
+
+            XMVECTOR endpoint0;
+            XMVECTOR endpoint1;
+            computeEndpoints(aPixels, BC_BLOCK_NUM_PIXELS, endpoint0, endpoint1);
+            Bc7Fit best = evaluateBc7Block(aPixels, endpoint0, endpoint1);
+
+            for (UINT uIteration = 0u; uIteration < REFINE_ITERATIONS && best.Error > 0.0f; ++uIteration)
+            {
+                FLOAT aWeights[BC_BLOCK_NUM_PIXELS];
+                for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+                {
+                    aWeights[i] = static_cast<FLOAT>(64u - BC7_MODE6_WEIGHTS[best.auIndices[i]]) / 64.0f;
+                }
+
+                if (!fitLeastSquares(aPixels, aWeights, BC_BLOCK_NUM_PIXELS, endpoint0, endpoint1))
+                {
+                    break;
+                }
+
+                Bc7Fit fit = evaluateBc7Block(aPixels, endpoint0, endpoint1);
+                if (fit.Error >= best.Error)
+                {
+                    break;
+                }
+                best = fit;
+            }
+
+            // The high bit of the first index is implied to be 0
+            if (best.auIndices[0] >= BC7_MODE6_NUM_INDICES / 2u)
+            {
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    std::swap(best.aEndpoints[0][c], best.aEndpoints[1][c]);
+                }
+                std::swap(best.auPBits[0], best.auPBits[1]);
+                for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+                {
+                    best.auIndices[i] = static_cast<BYTE>(BC7_MODE6_NUM_INDICES - 1u - best.auIndices[i]);
+                }
+            }
+
+            std::fill(pOutBlock, pOutBlock + 16, static_cast<BYTE>(0u));
+            UINT uBitOffset = 0u;
+            writeBits(pOutBlock, uBitOffset, 1u << 6u, 7u);
+            for (UINT c = 0u; c < 4u; ++c)
+            {
+                writeBits(pOutBlock, uBitOffset, best.aEndpoints[0][c] >> 1u, 7u);
+                writeBits(pOutBlock, uBitOffset, best.aEndpoints[1][c] >> 1u, 7u);
+            }
+            writeBits(pOutBlock, uBitOffset, best.auPBits[0], 1u);
+            writeBits(pOutBlock, uBitOffset, best.auPBits[1], 1u);
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                writeBits(pOutBlock, uBitOffset, best.auIndices[i], i == 0u ? 3u : 4u);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: decodeColorBlock
+
+          Summary:  Decodes a BC1 color block into RGBA
+
+          Args:     const BYTE* pBlock
+                      8 bytes of the block
+                    BOOL bAlwaysFourColors
+                      Whether the block is the color half of BC3
+                    BYTE* aOutRgba
+                      Receives the RGBA of the 16 pixels
+        -----------------------------------------------------------------F-F*/
+        void decodeColorBlock(_In_reads_bytes_(8u) const BYTE* pBlock, _In_ BOOL bAlwaysFourColors, _Out_writes_(BC_BLOCK_NUM_PIXELS * 4u) BYTE* aOutRgba)
+        {
+            WORD uColor0 = static_cast<WORD>(pBlock[0] | (pBlock[1] << 8u));
+            WORD uColor1 = static_cast<WORD>(pBlock[2] | (pBlock[3] << 8u));
+            UINT uIndices = pBlock[4] | (pBlock[5] << 8u) | (pBlock[6] << 16u) | (static_cast<UINT>(pBlock[7]) << 24u);
+
+            BYTE aPalette[4][4];
+            buildColorPalette(uColor0, uColor1, bAlwaysFourColors || uColor0 > uColor1, aPalette);
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                std::copy(aPalette[(uIndices >> (2u * i)) & 3u], aPalette[(uIndices >> (2u * i)) & 3u] + 4, aOutRgba + i * 4u);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: decodeAlphaBlock
+
+          Summary:  Decodes a BC4 block into one channel
+
+          Args:     const BYTE* pBlock
+                      8 bytes of the block
+                    BYTE* aOutValues
+                      Receives the values of the 16 pixels, 4 bytes
+                      apart
+        -----------------------------------------------------------------F-F*/
+        void decodeAlphaBlock(_In_reads_bytes_(8u) const BYTE* pBlock, _Out_writes_(BC_BLOCK_NUM_PIXELS * 4u) BYTE* aOutValues)
+        {
+            BYTE aPalette[8];
+            buildAlphaPalette(pBlock[0], pBlock[1], aPalette);
+
+            UINT64 ullIndices = 0ull;
+            for (UINT i = 0u; i < 6u; ++i)
+            {
+                ullIndices |= static_cast<UINT64>(pBlock[2u + i]) << (8u * i);
+            }
+
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                aOutValues[i * 4u] = aPalette[(ullIndices >> (3u * i)) & 7u];
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: decodeBc7Block
+
+          Summary:  Decodes a BC7 block into RGBA. Only mode 6, the mode
+                    the encoder writes, is decoded; other modes decode
+                    to transparent black
+
+          Args:     const BYTE* pBlock
+                      16 bytes of the block
+                    BYTE* aOutRgba
+                      Receives the RGBA of the 16 pixels
+        -----------------------------------------------------------------F-F*/
+        void decodeBc7Block(_In_reads_bytes_(16u) const BYTE* pBlock, _Out_writes_(BC_BLOCK_NUM_PIXELS * 4u) BYTE* aOutRgba)
+        {
+            UINT uBitOffset = 0u;
+            if (readBits(pBlock, uBitOffset, 7u) != (1u << 6u))
+            {
+                std::fill(aOutRgba, aOutRgba + BC_BLOCK_NUM_PIXELS * 4u, static_cast<BYTE>(0u));
+                return;
+            }
+
+            BYTE aEndpoints[2][4];
+            for (UINT c = 0u; c < 4u; ++c)
+            {
+                aEndpoints[0][c] = static_cast<BYTE>(readBits(pBlock, uBitOffset, 7u) << 1u);
+                aEndpoints[1][c] = static_cast<BYTE>(readBits(pBlock, uBitOffset, 7u) << 1u);
+            }
+            UINT uPBit0 = readBits(pBlock, uBitOffset, 1u);
+            UINT uPBit1 = readBits(pBlock, uBitOffset, 1u);
+            for (UINT c = 0u; c < 4u; ++c)
+            {
+                aEndpoints[0][c] |= static_cast<BYTE>(uPBit0);
+                aEndpoints[1][c] |= static_cast<BYTE>(uPBit1);
+            }
+
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                UINT uWeight = BC7_MODE6_WEIGHTS[readBits(pBlock, uBitOffset, i == 0u ? 3u : 4u)];
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    aOutRgba[i * 4u + c] = static_cast<BYTE>(((64u - uWeight) * aEndpoints[0][c] + uWeight * aEndpoints[1][c] + 32u) >> 6u);
+                }
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetBlockBytes
+
+      Summary:  Returns the size of a 4x4 block of a format
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+
+      Returns:  UINT
+                  8 or 16 bytes
+    -----------------------------------------------------------------F-F*/
+    UINT GetBlockBytes(_In_ eCompressedFormat format)
+    {
+        return format == eCompressedFormat::BC1 || format == eCompressedFormat::BC4 ? 8u : 16u;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetBlockDxgiFormat
+
+      Summary:  Returns the DXGI format a texture of blocks is created
+                with
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+                BOOL bSrgb
+                  Whether the color is sRGB encoded, only BC1, BC3 and
+                  BC7 have sRGB variants
+
+      Returns:  DXGI_FORMAT
+                  Format of the texture
+    -----------------------------------------------------------------F-F*/
+    DXGI_FORMAT GetBlockDxgiFormat(_In_ eCompressedFormat format, _In_ BOOL bSrgb)
+    {
+        switch (format)
+        {
+        case eCompressedFormat::BC1:
+            return bSrgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        case eCompressedFormat::BC3:
+            return bSrgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        case eCompressedFormat::BC4:
+            return DXGI_FORMAT_BC4_UNORM;
+        case eCompressedFormat::BC5:
+            return DXGI_FORMAT_BC5_UNORM;
+        case eCompressedFormat::BC7:
+            return bSrgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        default:
+            return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetBlockNumChannels
+
+      Summary:  Returns how many of the RGBA channels a format keeps,
+                the channels PSNR is measured on
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+
+      Returns:  UINT
+                  1 to 4
+    -----------------------------------------------------------------F-F*/
+    UINT GetBlockNumChannels(_In_ eCompressedFormat format)
+    {
+        switch (format)
+        {
+        case eCompressedFormat::BC1:
+            return 3u;
+        case eCompressedFormat::BC4:
+            return 1u;
+        case eCompressedFormat::BC5:
+            return 2u;
+        default:
+            return 4u;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: EncodeBlock
+
+      Summary:  Encodes a 4x4 block of pixels. BC1 writes pixels with
+                alpha below 128 transparent when the block has any
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+                const BYTE* aRgba
+                  RGBA of the 16 pixels, row by row
+                BYTE* pOutBlock
+                  Receives GetBlockBytes(format) bytes
+    -----------------------------------------------------------------F-F*/
+    void EncodeBlock(
+        _In_ eCompressedFormat format,
+        _In_reads_(BC_BLOCK_NUM_PIXELS * 4u) const BYTE* aRgba,
+        _Out_writes_bytes_(16u) BYTE* pOutBlock
+    )
+    {
+        switch (format)
+        {
+        case eCompressedFormat::BC1:
+        {
+            BOOL bPunchThrough = FALSE;
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                bPunchThrough |= aRgba[i * 4u + 3u] < BC1_ALPHA_THRESHOLD;
+            }
+            encodeColorBlock(aRgba, bPunchThrough, FALSE, pOutBlock);
+            break;
+        }
+        case eCompressedFormat::BC3:
+            encodeAlphaBlock(aRgba + 3u, pOutBlock);
+            encodeColorBlock(aRgba, FALSE, TRUE, pOutBlock + 8u);
+            break;
+        case eCompressedFormat::BC4:
+            encodeAlphaBlock(aRgba, pOutBlock);
+            break;
+        case eCompressedFormat::BC5:
+            encodeAlphaBlock(aRgba, pOutBlock);
+            encodeAlphaBlock(aRgba + 1u, pOutBlock + 8u);
+            break;
+        case eCompressedFormat::BC7:
+            encodeBc7Block(aRgba, pOutBlock);
+            break;
+        default:
+            assert(FALSE);
+            break;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: DecodeBlock
+
+      Summary:  Decodes a 4x4 block as the sampler would return it,
+                channels the format does not store are 0 and alpha 255
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+                const BYTE* pBlock
+                  GetBlockBytes(format) bytes of the block
+                BYTE* aOutRgba
+                  Receives the RGBA of the 16 pixels, row by row
+    -----------------------------------------------------------------F-F*/
+    void DecodeBlock(
+        _In_ eCompressedFormat format,
+        _In_reads_bytes_(16u) const BYTE* pBlock,
+        _Out_writes_(BC_BLOCK_NUM_PIXELS * 4u) BYTE* aOutRgba
+    )
+    {
+        switch (format)
+        {
+        case eCompressedFormat::BC1:
+            decodeColorBlock(pBlock, FALSE, aOutRgba);
+            break;
+        case eCompressedFormat::BC3:
+            decodeColorBlock(pBlock + 8u, TRUE, aOutRgba);
+            decodeAlphaBlock(pBlock, aOutRgba + 3u);
+            break;
+        case eCompressedFormat::BC4:
+        case eCompressedFormat::BC5:
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                aOutRgba[i * 4u + 1u] = 0u;
+                aOutRgba[i * 4u + 2u] = 0u;
+                aOutRgba[i * 4u + 3u] = 255u;
+            }
+            decodeAlphaBlock(pBlock, aOutRgba);
+            if (format == eCompressedFormat::BC5)
+            {
+                decodeAlphaBlock(pBlock + 8u, aOutRgba + 1u);
+            }
+            break;
+        case eCompressedFormat::BC7:
+            decodeBc7Block(pBlock, aOutRgba);
+            break;
+        default:
+            assert(FALSE);
+            break;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CompressImage
+
+      Summary:  Encodes an image block by block. Blocks past the right
+                or bottom edge repeat the edge pixels. Runs on the
+                thread pool when given one
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+                const BYTE* pRgba
+                  RGBA8 image, rows tightly packed
+                UINT uWidth
+                  Width of the image
+                UINT uHeight
+                  Height of the image
+                BYTE* pOutBlocks
+                  Receives the blocks row by row, GetBlockBytes(format)
+                  bytes for each of the ceil(w / 4) * ceil(h / 4)
+                ThreadPool* pThreadPool
+                  Pool to encode on, nullptr encodes on the caller
+    -----------------------------------------------------------------F-F*/
+    void CompressImage(
+        _In_ eCompressedFormat format,
+        _In_reads_(uWidth * uHeight * 4u) const BYTE* pRgba,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _Out_ BYTE* pOutBlocks,
+        _In_opt_ ThreadPool* pThreadPool
+    )
+    {
+        UINT uNumBlocksX = (uWidth + BC_BLOCK_SIZE - 1u) / BC_BLOCK_SIZE;
+        UINT uNumBlocksY = (uHeight + BC_BLOCK_SIZE - 1u) / BC_BLOCK_SIZE;
+        UINT uBlockBytes = GetBlockBytes(format);
+
+        auto compressBlocks = [&](UINT uBegin, UINT uEnd)
+        {
+            BYTE aBlock[BC_BLOCK_NUM_PIXELS * 4u];
+            for (UINT uBlock = uBegin; uBlock < uEnd; ++uBlock)
+            {
+                UINT uBlockX = (uBlock % uNumBlocksX) * BC_BLOCK_SIZE;
+                UINT uBlockY = (uBlock / uNumBlocksX) * BC_BLOCK_SIZE;
+                for (UINT y = 0u; y < BC_BLOCK_SIZE; ++y)
+                {
+                    UINT uSourceY = std::min(uBlockY + y, uHeight - 1u);
+                    for (UINT x = 0u; x < BC_BLOCK_SIZE; ++x)
+                    {
+                        UINT uSourceX = std::min(uBlockX + x, uWidth - 1u);
+                        const BYTE* pSource = pRgba + (static_cast<SIZE_T>(uSourceY) * uWidth + uSourceX) * 4u;
+                        std::copy(pSource, pSource + 4, aBlock + (y * BC_BLOCK_SIZE + x) * 4u);
+                    }
+                }
+
+                EncodeBlock(format, aBlock, pOutBlocks + static_cast<SIZE_T>(uBlock) * uBlockBytes);
+            }
+        };
+
+        if (pThreadPool)
+        {
+            pThreadPool->ParallelFor(uNumBlocksX * uNumBlocksY, COMPRESS_GRAIN_SIZE, compressBlocks);
+        }
+        else
+        {
+            compressBlocks(0u, uNumBlocksX * uNumBlocksY);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: DecompressImage
+
+      Summary:  Decodes the blocks written by CompressImage
+
+      Args:     eCompressedFormat format
+                  Block compressed format
+                const BYTE* pBlocks
+                  Blocks row by row
+                UINT uWidth
+                  Width of the image
+                UINT uHeight
+                  Height of the image
+                BYTE* pOutRgba
+                  Receives the RGBA8 image, rows tightly packed
+    -----------------------------------------------------------------F-F*/
+    void DecompressImage(
+        _In_ eCompressedFormat format,
+        _In_ const BYTE* pBlocks,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _Out_writes_(uWidth * uHeight * 4u) BYTE* pOutRgba
+    )
+    {
+        UINT uNumBlocksX = (uWidth + BC_BLOCK_SIZE - 1u) / BC_BLOCK_SIZE;
+        UINT uNumBlocksY = (uHeight + BC_BLOCK_SIZE - 1u) / BC_BLOCK_SIZE;
+        UINT uBlockBytes = GetBlockBytes(format);
+
+        BYTE aBlock[BC_BLOCK_NUM_PIXELS * 4u];
+        for (UINT uBlockY = 0u; uBlockY < uNumBlocksY; ++uBlockY)
+        {
+            for (UINT uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+            {
+                DecodeBlock(format, pBlocks + (static_cast<SIZE_T>(uBlockY) * uNumBlocksX + uBlockX) * uBlockBytes, aBlock);
+
+                for (UINT y = 0u; y < BC_BLOCK_SIZE && uBlockY * BC_BLOCK_SIZE + y < uHeight; ++y)
+                {
+                    for (UINT x = 0u; x < BC_BLOCK_SIZE && uBlockX * BC_BLOCK_SIZE + x < uWidth; ++x)
+                    {
+                        SIZE_T uPixel = static_cast<SIZE_T>(uBlockY * BC_BLOCK_SIZE + y) * uWidth + uBlockX * BC_BLOCK_SIZE + x;
+                        std::copy(aBlock + (y * BC_BLOCK_SIZE + x) * 4u, aBlock + (y * BC_BLOCK_SIZE + x) * 4u + 4u, pOutRgba + uPixel * 4u);
+                    }
+                }
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputePsnr
+
+      Summary:  Returns the peak signal to noise ratio between two RGBA8
+                images over their first channels
+
+      Args:     const BYTE* pExpected
+                  Original image
+                const BYTE* pActual
+                  Decoded image
+                UINT uNumPixels
+                  Number of pixels of each image
+                UINT uNumChannels
+                  Number of leading channels compared, from
+                  GetBlockNumChannels
+
+      Returns:  FLOAT
+                  PSNR in dB, infinity if the images are equal
+    -----------------------------------------------------------------F-F*/
+    FLOAT ComputePsnr(
+        _In_reads_(uNumPixels * 4u) const BYTE* pExpected,
+        _In_reads_(uNumPixels * 4u) const BYTE* pActual,
+        _In_ UINT uNumPixels,
+        _In_ UINT uNumChannels
+    )
+    {
+        UINT64 ullSquaredError = 0ull;
+        for (SIZE_T i = 0u; i < uNumPixels; ++i)
+        {
+            for (UINT c = 0u; c < uNumChannels; ++c)
+            {
+                INT iDifference = static_cast<INT>(pExpected[i * 4u + c]) - static_cast<INT>(pActual[i * 4u + c]);
+                ullSquaredError += static_cast<UINT64>(iDifference * iDifference);
+            }
+        }
+
+        if (ullSquaredError == 0ull || uNumPixels == 0u || uNumChannels == 0u)
+        {
+            return std::numeric_limits<FLOAT>::infinity();
+        }
+
+        DOUBLE meanSquaredError = static_cast<DOUBLE>(ullSquaredError) / (static_cast<DOUBLE>(uNumPixels) * uNumChannels);
+        return static_cast<FLOAT>(10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+    }
+}
@@ -0,0 +1,83 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSION.H
+
+  Summary:   BlockCompression header file contains declarations of the
+             CPU encoders and decoders of the BC1, BC3, BC4, BC5 and
+             BC7 block compressed formats, used to cook textures
+             offline and to measure what the compression loses.
+
+  Functions: GetBlockBytes, GetBlockDxgiFormat, GetBlockNumChannels,
+             EncodeBlock, DecodeBlock, CompressImage,
+             DecompressImage, ComputePsnr
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    class ThreadPool;
+
+    constexpr const UINT BC_BLOCK_SIZE = 4u;
+    constexpr const UINT BC_BLOCK_NUM_PIXELS = BC_BLOCK_SIZE * BC_BLOCK_SIZE;
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eCompressedFormat
+
+      Summary:  Block compressed formats the encoders write. BC1 stores
+                RGB with 1 bit alpha in 8 bytes, BC3 adds a BC4 alpha
+                block, BC4 stores red, BC5 red and green (normal maps)
+                and BC7 RGBA in mode 6
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eCompressedFormat : UINT
+    {
+        BC1 = 0,
+        BC3,
+        BC4,
+        BC5,
+        BC7,
+        COUNT,
+    };
+
+    UINT GetBlockBytes(_In_ eCompressedFormat format);
+    DXGI_FORMAT GetBlockDxgiFormat(_In_ eCompressedFormat format, _In_ BOOL bSrgb);
+    UINT GetBlockNumChannels(_In_ eCompressedFormat format);
+
+    void EncodeBlock(
+        _In_ eCompressedFormat format,
+        _In_reads_(BC_BLOCK_NUM_PIXELS * 4u) const BYTE* aRgba,
+        _Out_writes_bytes_(16u) BYTE* pOutBlock
+    );
+
+    void DecodeBlock(
+        _In_ eCompressedFormat format,
+        _In_reads_bytes_(16u) const BYTE* pBlock,
+        _Out_writes_(BC_BLOCK_NUM_PIXELS * 4u) BYTE* aOutRgba
+    );
+
+    void CompressImage(
+        _In_ eCompressedFormat format,
+        _In_reads_(uWidth * uHeight * 4u) const BYTE* pRgba,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _Out_ BYTE* pOutBlocks,
+        _In_opt_ ThreadPool* pThreadPool
+    );
+
+    void DecompressImage(
+        _In_ eCompressedFormat format,
+        _In_ const BYTE* pBlocks,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _Out_writes_(uWidth * uHeight * 4u) BYTE* pOutRgba
+    );
+
+    FLOAT ComputePsnr(
+        _In_reads_(uNumPixels * 4u) const BYTE* pExpected,
+        _In_reads_(uNumPixels * 4u) const BYTE* pActual,
+        _In_ UINT uNumPixels,
+        _In_ UINT uNumChannels
+    );
+}
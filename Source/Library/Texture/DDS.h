@@ -0,0 +1,99 @@
+/*+===================================================================
+  File:      DDS.H
+
+  Summary:   DDS header file contains the layout of the headers at the
+             start of a DDS file and the flags the library writes, so
+             cooked textures can be written without the DirectXTex
+             library.
+
+  Structs:   DdsPixelFormat, DdsHeader, DdsHeaderDx10
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    constexpr const UINT DDS_MAGIC_NUMBER = 0x20534444u;     // "DDS "
+    constexpr const UINT DDS_FOURCC_DX10 = 0x30315844u;      // "DX10"
+
+    constexpr const UINT DDS_FLAG_CAPS = 0x00000001u;
+    constexpr const UINT DDS_FLAG_HEIGHT = 0x00000002u;
+    constexpr const UINT DDS_FLAG_WIDTH = 0x00000004u;
+    constexpr const UINT DDS_FLAG_PIXEL_FORMAT = 0x00001000u;
+    constexpr const UINT DDS_FLAG_MIP_COUNT = 0x00020000u;
+    constexpr const UINT DDS_FLAG_LINEAR_SIZE = 0x00080000u;
+
+    constexpr const UINT DDS_CAPS_COMPLEX = 0x00000008u;
+    constexpr const UINT DDS_CAPS_TEXTURE = 0x00001000u;
+    constexpr const UINT DDS_CAPS_MIPMAP = 0x00400000u;
+
+    constexpr const UINT DDS_PIXEL_FORMAT_FOURCC = 0x00000004u;
+
+    constexpr const UINT DDS_DIMENSION_TEXTURE2D = 3u;
+
+#pragma pack(push, 1)
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DdsPixelFormat
+
+      Summary:  Legacy pixel format of a DDS file. Cooked textures only
+                set the "DX10" four character code and describe their
+                format in DdsHeaderDx10
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DdsPixelFormat
+    {
+        UINT uSize;
+        UINT uFlags;
+        UINT uFourCC;
+        UINT uRgbBitCount;
+        UINT uRBitMask;
+        UINT uGBitMask;
+        UINT uBBitMask;
+        UINT uABitMask;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DdsHeader
+
+      Summary:  Header that follows the magic number of a DDS file
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DdsHeader
+    {
+        UINT uSize;
+        UINT uFlags;
+        UINT uHeight;
+        UINT uWidth;
+        UINT uPitchOrLinearSize;
+        UINT uDepth;
+        UINT uMipMapCount;
+        UINT auReserved1[11];
+        DdsPixelFormat PixelFormat;
+        UINT uCaps;
+        UINT uCaps2;
+        UINT uCaps3;
+        UINT uCaps4;
+        UINT uReserved2;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DdsHeaderDx10
+
+      Summary:  Extended header that follows DdsHeader when its four
+                character code is "DX10"
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DdsHeaderDx10
+    {
+        DXGI_FORMAT Format;
+        UINT uResourceDimension;
+        UINT uMiscFlag;
+        UINT uArraySize;
+        UINT uMiscFlags2;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(DdsPixelFormat) == 32u, "DDS pixel format must be 32 bytes");
+    static_assert(sizeof(DdsHeader) == 124u, "DDS header must be 124 bytes");
+    static_assert(sizeof(DdsHeaderDx10) == 20u, "DDS DX10 header must be 20 bytes");
+}
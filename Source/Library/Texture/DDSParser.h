@@ -0,0 +1,152 @@
+//--------------------------------------------------------------------------------------
+// File: DDSParser.h
+//
+// Platform-independent parsing of DDS files, so that the header validation and
+// subresource layout work on any view of the file bytes (such as a memory mapping)
+// without a copy, and without Direct3D
+//
+// Derived from DDSTextureLoader in the DirectX Tool Kit.
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+// http://go.microsoft.com/fwlink/?LinkId=248929
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+// The stand-in in Source/Linux, winadapter.h plus the SAL annotations
+#include <windows.h>
+#endif
+
+#include <dxgiformat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectX
+{
+#ifndef DDS_ALPHA_MODE_DEFINED
+#define DDS_ALPHA_MODE_DEFINED
+    enum DDS_ALPHA_MODE : uint32_t
+    {
+        DDS_ALPHA_MODE_UNKNOWN = 0,
+        DDS_ALPHA_MODE_STRAIGHT = 1,
+        DDS_ALPHA_MODE_PREMULTIPLIED = 2,
+        DDS_ALPHA_MODE_OPAQUE = 3,
+        DDS_ALPHA_MODE_CUSTOM = 4,
+    };
+#endif
+
+    //----------------------------------------------------------------------------------
+    // DDS file structure definitions
+    //
+    // See DDS.h in the 'Texconv' sample and the 'DirectXTex' library
+    //----------------------------------------------------------------------------------
+#pragma pack(push,1)
+
+    struct DDS_PIXELFORMAT
+    {
+        uint32_t    size;
+        uint32_t    flags;
+        uint32_t    fourCC;
+        uint32_t    RGBBitCount;
+        uint32_t    RBitMask;
+        uint32_t    GBitMask;
+        uint32_t    BBitMask;
+        uint32_t    ABitMask;
+    };
+
+    struct DDS_HEADER
+    {
+        uint32_t        size;
+        uint32_t        flags;
+        uint32_t        height;
+        uint32_t        width;
+        uint32_t        pitchOrLinearSize;
+        uint32_t        depth; // only if DDS_HEADER_FLAGS_VOLUME is set in flags
+        uint32_t        mipMapCount;
+        uint32_t        reserved1[11];
+        DDS_PIXELFORMAT ddspf;
+        uint32_t        caps;
+        uint32_t        caps2;
+        uint32_t        caps3;
+        uint32_t        caps4;
+        uint32_t        reserved2;
+    };
+
+    struct DDS_HEADER_DXT10
+    {
+        DXGI_FORMAT     dxgiFormat;
+        uint32_t        resourceDimension;
+        uint32_t        miscFlag; // see D3D11_RESOURCE_MISC_FLAG
+        uint32_t        arraySize;
+        uint32_t        miscFlags2;
+    };
+
+#pragma pack(pop)
+
+    // Same values as D3D11_RESOURCE_DIMENSION
+    enum DDS_RESOURCE_DIMENSION : uint32_t
+    {
+        DDS_RESOURCE_DIMENSION_UNKNOWN = 0,
+        DDS_RESOURCE_DIMENSION_TEXTURE1D = 2,
+        DDS_RESOURCE_DIMENSION_TEXTURE2D = 3,
+        DDS_RESOURCE_DIMENSION_TEXTURE3D = 4,
+    };
+
+    // What the headers of a DDS file describe. bitData points into the bytes that were
+    // parsed, which must outlive it
+    struct DDS_TEXTURE_DESC
+    {
+        const DDS_HEADER*       header;
+        const uint8_t*          bitData;
+        size_t                  bitSize;
+        DDS_RESOURCE_DIMENSION  resDim;
+        size_t                  width;
+        size_t                  height;
+        size_t                  depth;
+        size_t                  mipCount;
+        size_t                  arraySize;
+        DXGI_FORMAT             format;
+        bool                    isCubeMap;
+        DDS_ALPHA_MODE          alphaMode;
+    };
+
+    // One mip of one array item, pointing into the parsed bytes
+    struct DDS_SUBRESOURCE
+    {
+        const uint8_t*  pData;
+        size_t          rowPitch;
+        size_t          slicePitch;
+    };
+
+    // Validates the headers against the file size and the Direct3D 11 resource limits
+    HRESULT ParseDDSTexture(
+        _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+        _In_ size_t ddsDataSize,
+        _Out_ DDS_TEXTURE_DESC& desc) noexcept;
+
+    // Lays out every subresource, skipping the top mips larger than maxsize (0 keeps all)
+    HRESULT GetDDSSubresources(
+        _In_ const DDS_TEXTURE_DESC& desc,
+        _In_ size_t maxsize,
+        _Out_ size_t& twidth,
+        _Out_ size_t& theight,
+        _Out_ size_t& tdepth,
+        _Out_ size_t& skipMip,
+        _Out_writes_(desc.mipCount * desc.arraySize) DDS_SUBRESOURCE* subresources) noexcept;
+
+    size_t GetDDSBitsPerPixel(_In_ DXGI_FORMAT fmt) noexcept;
+
+    HRESULT GetDDSSurfaceInfo(
+        _In_ size_t width,
+        _In_ size_t height,
+        _In_ DXGI_FORMAT fmt,
+        _Out_opt_ size_t* outNumBytes,
+        _Out_opt_ size_t* outRowBytes,
+        _Out_opt_ size_t* outNumRows) noexcept;
+}
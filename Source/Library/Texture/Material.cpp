@@ -45,6 +45,23 @@ namespace library
 		return hr;
 	}
 
+	HRESULT Material::Prefetch()
+	{
+		for (const std::shared_ptr<Texture>& texture : { pDiffuse, pSpecularExponent, pNormal })
+		{
+			if (texture)
+			{
+				HRESULT hr = texture->Prefetch();
+				if (FAILED(hr))
+				{
+					return hr;
+				}
+			}
+		}
+
+		return S_OK;
+	}
+
 	std::wstring Material::GetName() const
 	{
 		return m_szName;
@@ -28,6 +28,7 @@ namespace library
 		virtual ~Material() = default;
 
 		virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+		HRESULT Prefetch();
 
 		std::wstring GetName() const;
 
@@ -0,0 +1,726 @@
+#include "Texture/MipGenerator.h"
+
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT MIP_GRAIN_SIZE = 8u;
+        constexpr const FLOAT KAISER_RADIUS = 3.0f;
+        constexpr const FLOAT KAISER_ALPHA = 4.0f;
+        constexpr const UINT BESSEL_TERMS = 20u;
+        constexpr const UINT ALPHA_COVERAGE_ITERATIONS = 16u;
+        constexpr const FLOAT MAX_ALPHA_SCALE = 16.0f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FilterTaps
+
+          Summary:  Source texels and weights of every destination texel
+                    along one axis. The taps of texel i are the entries
+                    from auFirst[i] up to auFirst[i + 1]
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FilterTaps
+        {
+            std::vector<UINT> auFirst;
+            std::vector<UINT> auIndex;
+            std::vector<FLOAT> aWeight;
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: besselI0
+
+          Summary:  Evaluates the zeroth order modified Bessel function
+                    of the first kind from its power series
+
+          Args:     FLOAT x
+                      Argument
+
+          Returns:  FLOAT
+                      I0(x)
+        -----------------------------------------------------------------F-F*/
+        FLOAT besselI0(_In_ FLOAT x)
+        {
+            FLOAT sum = 1.0f;
+            FLOAT term = 1.0f;
+            FLOAT halfX = x * 0.5f;
+            for (UINT k = 1u; k < BESSEL_TERMS; ++k)
+            {
+                FLOAT factor = halfX / static_cast<FLOAT>(k);
+                term *= factor * factor;
+                sum += term;
+            }
+            return sum;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: kaiser
+
+          Summary:  Evaluates a sinc windowed by a Kaiser window that
+                    reaches zero at KAISER_RADIUS
+
+          Args:     FLOAT t
+                      Distance from the center in destination texels
+
+          Returns:  FLOAT
+                      Unnormalized weight
+        -----------------------------------------------------------------F-F*/
+        FLOAT kaiser(_In_ FLOAT t)
+        {
+            if (std::abs(t) >= KAISER_RADIUS)
+            {
+                return 0.0f;
+            }
+
+            FLOAT sinc = 1.0f;
+            if (std::abs(t) > 1e-6f)
+            {
+                sinc = std::sin(XM_PI * t) / (XM_PI * t);
+            }
+
+            FLOAT ratio = t / KAISER_RADIUS;
+            return sinc * besselI0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / besselI0(KAISER_ALPHA);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: buildFilterTaps
+
+          Summary:  Computes the normalized taps that resample one axis
+                    from uSourceSize to uDestinationSize texels. Taps
+                    past the edges repeat the edge texel
+
+          Args:     eMipFilter filter
+                      Filter to sample with
+                    UINT uSourceSize
+                      Source texels along the axis
+                    UINT uDestinationSize
+                      Destination texels along the axis
+
+          Returns:  FilterTaps
+                      Taps of every destination texel
+        -----------------------------------------------------------------F-F*/
+        FilterTaps buildFilterTaps(_In_ eMipFilter filter, _In_ UINT uSourceSize, _In_ UINT uDestinationSize)
+        {
+            FilterTaps taps;
+            taps.auFirst.reserve(static_cast<SIZE_T>(uDestinationSize) + 1u);
+
+            FLOAT scale = static_cast<FLOAT>(uSourceSize) / static_cast<FLOAT>(uDestinationSize);
+            for (UINT i = 0u; i < uDestinationSize; ++i)
+            {
+                UINT uFirst = static_cast<UINT>(taps.auIndex.size());
+                taps.auFirst.push_back(uFirst);
+
+                if (uSourceSize == uDestinationSize)
+                {
+                    taps.auIndex.push_back(i);
+                    taps.aWeight.push_back(1.0f);
+                    continue;
+                }
+
+                FLOAT begin = static_cast<FLOAT>(i) * scale;
+                FLOAT end = begin + scale;
+                if (filter == eMipFilter::BOX)
+                {
+                    // Weight every source texel by how much of it the destination texel covers
+                    for (INT j = static_cast<INT>(std::floor(begin)); static_cast<FLOAT>(j) < end; ++j)
+                    {
+                        FLOAT overlap = std::min(static_cast<FLOAT>(j + 1), end) - std::max(static_cast<FLOAT>(j), begin);
+                        if (overlap > 0.0f)
+                        {
+                            taps.auIndex.push_back(static_cast<UINT>(std::clamp(j, 0, static_cast<INT>(uSourceSize) - 1)));
+                            taps.aWeight.push_back(overlap);
+                        }
+                    }
+                }
+                else
+                {
+                    FLOAT center = begin + scale * 0.5f;
+                    INT iFirst = static_cast<INT>(std::floor(center - KAISER_RADIUS * scale));
+                    INT iLast = static_cast<INT>(std::ceil(center + KAISER_RADIUS * scale));
+                    for (INT j = iFirst; j <= iLast; ++j)
+                    {
+                        FLOAT weight = kaiser((static_cast<FLOAT>(j) + 0.5f - center) / scale);
+                        if (weight != 0.0f)
+                        {
+                            taps.auIndex.push_back(static_cast<UINT>(std::clamp(j, 0, static_cast<INT>(uSourceSize) - 1)));
+                            taps.aWeight.push_back(weight);
+                        }
+                    }
+                }
+
+                FLOAT sum = 0.0f;
+                for (SIZE_T k = uFirst; k < taps.aWeight.size(); ++k)
+                {
+                    sum += taps.aWeight[k];
+                }
+                for (SIZE_T k = uFirst; k < taps.aWeight.size(); ++k)
+                {
+                    taps.aWeight[k] /= sum;
+                }
+            }
+            taps.auFirst.push_back(static_cast<UINT>(taps.auIndex.size()));
+
+            return taps;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: forEachRow
+
+          Summary:  Runs a function over chunks of rows on the pool, or
+                    on the caller when there is no pool
+
+          Args:     ThreadPool* pThreadPool
+                      Pool to run on, may be nullptr
+                    UINT uNumRows
+                      Number of rows
+                    const std::function<void(UINT, UINT)>& function
+                      Processes the rows [uBegin, uEnd)
+        -----------------------------------------------------------------F-F*/
+        void forEachRow(_In_opt_ ThreadPool* pThreadPool, _In_ UINT uNumRows, _In_ const std::function<void(UINT uBegin, UINT uEnd)>& function)
+        {
+            if (pThreadPool)
+            {
+                pThreadPool->ParallelFor(uNumRows, MIP_GRAIN_SIZE, function);
+            }
+            else
+            {
+                function(0u, uNumRows);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getSrgbToLinearTable
+
+          Summary:  Returns the linear value of every 8 bit sRGB value
+
+          Returns:  const std::array<FLOAT, 256>&
+                      Lookup table
+        -----------------------------------------------------------------F-F*/
+        const std::array<FLOAT, 256>& getSrgbToLinearTable()
+        {
+            static const std::array<FLOAT, 256> s_aTable = []()
+            {
+                std::array<FLOAT, 256> aTable = {};
+                for (UINT i = 0u; i < 256u; ++i)
+                {
+                    FLOAT value = static_cast<FLOAT>(i) / 255.0f;
+                    aTable[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+                return aTable;
+            }();
+            return s_aTable;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: loadLevel
+
+          Summary:  Converts the top mip to linear float RGBA. RGBA8
+                    normals are expanded from [0, 1] to [-1, 1]
+
+          Args:     eMipFormat format
+                      Format of the pixels
+                    const BYTE* pPixels
+                      Top mip
+                    UINT uWidth
+                      Width of the top mip
+                    UINT uHeight
+                      Height of the top mip
+                    BOOL bNormalMap
+                      Whether RGB hold a normal
+                    ThreadPool* pThreadPool
+                      Pool to convert on, may be nullptr
+                    std::vector<XMFLOAT4A>& outLevel
+                      Receives the linear texels
+        -----------------------------------------------------------------F-F*/
+        void loadLevel(
+            _In_ eMipFormat format,
+            _In_ const BYTE* pPixels,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ BOOL bNormalMap,
+            _In_opt_ ThreadPool* pThreadPool,
+            _Out_ std::vector<XMFLOAT4A>& outLevel
+        )
+        {
+            outLevel.resize(static_cast<SIZE_T>(uWidth) * uHeight);
+            const std::array<FLOAT, 256>& aSrgbToLinear = getSrgbToLinearTable();
+
+            forEachRow(pThreadPool, uHeight, [&](UINT uBegin, UINT uEnd)
+            {
+                for (SIZE_T i = static_cast<SIZE_T>(uBegin) * uWidth; i < static_cast<SIZE_T>(uEnd) * uWidth; ++i)
+                {
+                    XMVECTOR texel;
+                    if (format == eMipFormat::RGBA32_FLOAT)
+                    {
+                        texel = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pPixels) + i);
+                    }
+                    else
+                    {
+                        const BYTE* pTexel = pPixels + i * 4u;
+                        XMVECTORU32 bytes = { { { pTexel[0], pTexel[1], pTexel[2], pTexel[3] } } };
+                        texel = XMVectorScale(XMConvertVectorUIntToFloat(bytes, 0u), 1.0f / 255.0f);
+                        if (format == eMipFormat::RGBA8_UNORM_SRGB && !bNormalMap)
+                        {
+                            texel = XMVectorSet(aSrgbToLinear[pTexel[0]], aSrgbToLinear[pTexel[1]], aSrgbToLinear[pTexel[2]], XMVectorGetW(texel));
+                        }
+                        if (bNormalMap)
+                        {
+                            texel = XMVectorSelect(texel, XMVectorMultiplyAdd(texel, XMVectorReplicate(2.0f), XMVectorReplicate(-1.0f)), g_XMSelect1110);
+                        }
+                    }
+                    XMStoreFloat4A(&outLevel[i], texel);
+                }
+            });
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: downsampleLevel
+
+          Summary:  Resamples a linear level into the next one, filtering
+                    the columns of each destination row into a row of
+                    the source width and then that row across. Normals
+                    are renormalized
+
+          Args:     const std::vector<XMFLOAT4A>& aSource
+                      Source level
+                    UINT uSourceWidth
+                      Width of the source
+                    UINT uSourceHeight
+                      Height of the source
+                    UINT uWidth
+                      Width of the destination
+                    UINT uHeight
+                      Height of the destination
+                    const MipChainOptions& options
+                      Filter and whether texels are normals
+                    ThreadPool* pThreadPool
+                      Pool to filter on, may be nullptr
+                    std::vector<XMFLOAT4A>& outLevel
+                      Receives the destination level
+        -----------------------------------------------------------------F-F*/
+        void downsampleLevel(
+            _In_ const std::vector<XMFLOAT4A>& aSource,
+            _In_ UINT uSourceWidth,
+            _In_ UINT uSourceHeight,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ const MipChainOptions& options,
+            _In_opt_ ThreadPool* pThreadPool,
+            _Out_ std::vector<XMFLOAT4A>& outLevel
+        )
+        {
+            FilterTaps tapsX = buildFilterTaps(options.Filter, uSourceWidth, uWidth);
+            FilterTaps tapsY = buildFilterTaps(options.Filter, uSourceHeight, uHeight);
+            outLevel.resize(static_cast<SIZE_T>(uWidth) * uHeight);
+
+            forEachRow(pThreadPool, uHeight, [&](UINT uBegin, UINT uEnd)
+            {
+                std::vector<XMFLOAT4A> aRow(uSourceWidth);
+                for (UINT y = uBegin; y < uEnd; ++y)
+                {
+                    for (UINT x = 0u; x < uSourceWidth; ++x)
+                    {
+                        XMVECTOR sum = XMVectorZero();
+                        for (UINT k = tapsY.auFirst[y]; k < tapsY.auFirst[y + 1u]; ++k)
+                        {
+                            const XMFLOAT4A& texel = aSource[static_cast<SIZE_T>(tapsY.auIndex[k]) * uSourceWidth + x];
+                            sum = XMVectorMultiplyAdd(XMLoadFloat4A(&texel), XMVectorReplicate(tapsY.aWeight[k]), sum);
+                        }
+                        XMStoreFloat4A(&aRow[x], sum);
+                    }
+
+                    XMFLOAT4A* pDestination = outLevel.data() + static_cast<SIZE_T>(y) * uWidth;
+                    for (UINT x = 0u; x < uWidth; ++x)
+                    {
+                        XMVECTOR sum = XMVectorZero();
+                        for (UINT k = tapsX.auFirst[x]; k < tapsX.auFirst[x + 1u]; ++k)
+                        {
+                            sum = XMVectorMultiplyAdd(XMLoadFloat4A(&aRow[tapsX.auIndex[k]]), XMVectorReplicate(tapsX.aWeight[k]), sum);
+                        }
+
+                        if (options.bNormalMap && XMVectorGetX(XMVector3LengthSq(sum)) > 0.0f)
+                        {
+                            sum = XMVectorSelect(sum, XMVector3Normalize(sum), g_XMSelect1110);
+                        }
+                        XMStoreFloat4A(&pDestination[x], sum);
+                    }
+                }
+            });
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: computeAlphaCoverage
+
+          Summary:  Returns the fraction of texels whose scaled alpha
+                    passes an alpha test
+
+          Args:     const std::vector<XMFLOAT4A>& aLevel
+                      Linear texels
+                    FLOAT alphaScale
+                      Scale applied to the alpha
+                    FLOAT alphaReference
+                      Alpha test reference
+
+          Returns:  FLOAT
+                      Coverage in [0, 1]
+        -----------------------------------------------------------------F-F*/
+        FLOAT computeAlphaCoverage(_In_ const std::vector<XMFLOAT4A>& aLevel, _In_ FLOAT alphaScale, _In_ FLOAT alphaReference)
+        {
+            SIZE_T uNumCovered = 0u;
+            for (const XMFLOAT4A& texel : aLevel)
+            {
+                if (texel.w * alphaScale > alphaReference)
+                {
+                    ++uNumCovered;
+                }
+            }
+            return static_cast<FLOAT>(uNumCovered) / static_cast<FLOAT>(aLevel.size());
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: findAlphaScale
+
+          Summary:  Bisects the alpha scale that makes a level cover as
+                    much as the top mip
+
+          Args:     const std::vector<XMFLOAT4A>& aLevel
+                      Linear texels
+                    FLOAT coverage
+                      Coverage of the top mip
+                    FLOAT alphaReference
+                      Alpha test reference
+
+          Returns:  FLOAT
+                      Scale to apply to the alpha of the level
+        -----------------------------------------------------------------F-F*/
+        FLOAT findAlphaScale(_In_ const std::vector<XMFLOAT4A>& aLevel, _In_ FLOAT coverage, _In_ FLOAT alphaReference)
+        {
+            FLOAT minScale = 0.0f;
+            FLOAT maxScale = MAX_ALPHA_SCALE;
+            FLOAT bestScale = 1.0f;
+            FLOAT bestError = std::abs(computeAlphaCoverage(aLevel, 1.0f, alphaReference) - coverage);
+
+            for (UINT i = 0u; i < ALPHA_COVERAGE_ITERATIONS; ++i)
+            {
+                FLOAT scale = (minScale + maxScale) * 0.5f;
+                FLOAT levelCoverage = computeAlphaCoverage(aLevel, scale, alphaReference);
+                FLOAT error = std::abs(levelCoverage - coverage);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestScale = scale;
+                }
+
+                if (levelCoverage < coverage)
+                {
+                    minScale = scale;
+                }
+                else
+                {
+                    maxScale = scale;
+                }
+            }
+            return bestScale;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: storeLevel
+
+          Summary:  Converts a linear level back to the pixel format,
+                    clamping what the filter overshot
+
+          Args:     const std::vector<XMFLOAT4A>& aLevel
+                      Linear texels
+                    UINT uWidth
+                      Width of the level
+                    UINT uHeight
+                      Height of the level
+                    eMipFormat format
+                      Format to write
+                    BOOL bNormalMap
+                      Whether RGB hold a normal
+                    FLOAT alphaScale
+                      Scale applied to the alpha
+                    ThreadPool* pThreadPool
+                      Pool to convert on, may be nullptr
+                    MipLevel& outMip
+                      Receives the mip
+        -----------------------------------------------------------------F-F*/
+        void storeLevel(
+            _In_ const std::vector<XMFLOAT4A>& aLevel,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ eMipFormat format,
+            _In_ BOOL bNormalMap,
+            _In_ FLOAT alphaScale,
+            _In_opt_ ThreadPool* pThreadPool,
+            _Out_ MipLevel& outMip
+        )
+        {
+            outMip.uWidth = uWidth;
+            outMip.uHeight = uHeight;
+            outMip.aPixels.resize(static_cast<SIZE_T>(uWidth) * uHeight * GetMipFormatPixelBytes(format));
+
+            XMVECTOR scale = XMVectorSet(1.0f, 1.0f, 1.0f, alphaScale);
+            forEachRow(pThreadPool, uHeight, [&](UINT uBegin, UINT uEnd)
+            {
+                for (SIZE_T i = static_cast<SIZE_T>(uBegin) * uWidth; i < static_cast<SIZE_T>(uEnd) * uWidth; ++i)
+                {
+                    XMVECTOR texel = XMVectorMultiply(XMLoadFloat4A(&aLevel[i]), scale);
+                    if (bNormalMap)
+                    {
+                        texel = XMVectorSelect(texel, XMVectorMultiplyAdd(texel, g_XMOneHalf, g_XMOneHalf), g_XMSelect1110);
+                    }
+
+                    if (format == eMipFormat::RGBA32_FLOAT)
+                    {
+                        if (!bNormalMap)
+                        {
+                            texel = XMVectorSelect(XMVectorMax(texel, XMVectorZero()), XMVectorSaturate(texel), g_XMSelect0001);
+                        }
+                        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(outMip.aPixels.data()) + i, texel);
+                        continue;
+                    }
+
+                    texel = XMVectorSaturate(texel);
+                    if (format == eMipFormat::RGBA8_UNORM_SRGB && !bNormalMap)
+                    {
+                        texel = XMColorRGBToSRGB(texel);
+                    }
+
+                    XMVECTORU32 bytes;
+                    bytes.v = XMConvertVectorFloatToUInt(XMVectorMultiplyAdd(texel, XMVectorReplicate(255.0f), g_XMOneHalf), 0u);
+                    BYTE* pTexel = outMip.aPixels.data() + i * 4u;
+                    for (UINT c = 0u; c < 4u; ++c)
+                    {
+                        pTexel[c] = static_cast<BYTE>(std::min(bytes.u[c], 255u));
+                    }
+                }
+            });
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetMipCount
+
+      Summary:  Returns the length of the full mip chain of an image
+
+      Args:     UINT uWidth
+                  Width of the top mip
+                UINT uHeight
+                  Height of the top mip
+
+      Returns:  UINT
+                  Number of mips down to 1x1, including the top
+    -----------------------------------------------------------------F-F*/
+    UINT GetMipCount(_In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        UINT uNumMips = 1u;
+        while ((std::max(uWidth, uHeight) >> uNumMips) > 0u)
+        {
+            ++uNumMips;
+        }
+        return uNumMips;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetMipFormatPixelBytes
+
+      Summary:  Returns the size of a texel of a format
+
+      Args:     eMipFormat format
+                  Pixel format
+
+      Returns:  UINT
+                  Bytes per texel
+    -----------------------------------------------------------------F-F*/
+    UINT GetMipFormatPixelBytes(_In_ eMipFormat format)
+    {
+        return format == eMipFormat::RGBA32_FLOAT ? static_cast<UINT>(sizeof(XMFLOAT4)) : 4u;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetMipFormat
+
+      Summary:  Finds the generator format of a DXGI format
+
+      Args:     DXGI_FORMAT dxgiFormat
+                  Format of the image
+                eMipFormat& outFormat
+                  Receives the matching format
+
+      Returns:  BOOL
+                  TRUE if the generator can filter the format
+    -----------------------------------------------------------------F-F*/
+    BOOL GetMipFormat(_In_ DXGI_FORMAT dxgiFormat, _Out_ eMipFormat& outFormat)
+    {
+        switch (dxgiFormat)
+        {
+        // Alpha is last in either order, and the color channels are
+        // filtered alike
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            outFormat = eMipFormat::RGBA8_UNORM;
+            return TRUE;
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            outFormat = eMipFormat::RGBA8_UNORM_SRGB;
+            return TRUE;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            outFormat = eMipFormat::RGBA32_FLOAT;
+            return TRUE;
+        default:
+            outFormat = eMipFormat::COUNT;
+            return FALSE;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GenerateMipChain
+
+      Summary:  Builds every mip below the top of an image. Each level
+                is filtered from the one above in linear float, so sRGB
+                colors are averaged as light and rounding does not add
+                up down the chain. The rows of each level are spread
+                over the pool
+
+      Args:     eMipFormat format
+                  Format of the pixels, and of the mips
+                const BYTE* pPixels
+                  Top mip, rows tightly packed
+                UINT uWidth
+                  Width of the top mip
+                UINT uHeight
+                  Height of the top mip
+                const MipChainOptions& options
+                  Filter, normal maps and alpha coverage
+                ThreadPool* pThreadPool
+                  Pool to filter on, nullptr filters on the caller
+                std::vector<MipLevel>& outMips
+                  Receives mips 1 to GetMipCount - 1
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT GenerateMipChain(
+        _In_ eMipFormat format,
+        _In_ const BYTE* pPixels,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ const MipChainOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ std::vector<MipLevel>& outMips
+    )
+    {
+        outMips.clear();
+        if (!pPixels)
+        {
+            return E_POINTER;
+        }
+
+        if (format >= eMipFormat::COUNT || options.Filter >= eMipFilter::COUNT || uWidth == 0u || uHeight == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<XMFLOAT4A> aLevel;
+        std::vector<XMFLOAT4A> aNextLevel;
+        loadLevel(format, pPixels, uWidth, uHeight, options.bNormalMap, pThreadPool, aLevel);
+
+        FLOAT coverage = 0.0f;
+        if (options.bPreserveAlphaCoverage)
+        {
+            coverage = computeAlphaCoverage(aLevel, 1.0f, options.AlphaReference);
+        }
+
+        UINT uNumMips = GetMipCount(uWidth, uHeight);
+        outMips.resize(uNumMips - 1u);
+        for (UINT uMip = 1u; uMip < uNumMips; ++uMip)
+        {
+            UINT uMipWidth = std::max(uWidth / 2u, 1u);
+            UINT uMipHeight = std::max(uHeight / 2u, 1u);
+            downsampleLevel(aLevel, uWidth, uHeight, uMipWidth, uMipHeight, options, pThreadPool, aNextLevel);
+            aLevel.swap(aNextLevel);
+            uWidth = uMipWidth;
+            uHeight = uMipHeight;
+
+            // The scale only changes what is stored, the next mip is
+            // filtered from the unscaled alpha
+            FLOAT alphaScale = 1.0f;
+            if (options.bPreserveAlphaCoverage)
+            {
+                alphaScale = findAlphaScale(aLevel, coverage, options.AlphaReference);
+            }
+
+            storeLevel(aLevel, uWidth, uHeight, format, options.bNormalMap, alphaScale, pThreadPool, outMips[uMip - 1u]);
+        }
+
+        return S_OK;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ResampleImage
+
+      Summary:  Resizes an image to any size with the filter of the mip
+                chain, in linear float like the mips. Alpha coverage is
+                not preserved
+
+      Args:     eMipFormat format
+                  Format of the pixels, and of the result
+                const BYTE* pPixels
+                  Image, rows tightly packed
+                UINT uWidth
+                  Width of the image
+                UINT uHeight
+                  Height of the image
+                UINT uNewWidth
+                  Width to resize to
+                UINT uNewHeight
+                  Height to resize to
+                const MipChainOptions& options
+                  Filter and normal maps
+                ThreadPool* pThreadPool
+                  Pool to filter on, nullptr filters on the caller
+                MipLevel& outImage
+                  Receives the resized image
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT ResampleImage(
+        _In_ eMipFormat format,
+        _In_ const BYTE* pPixels,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uNewWidth,
+        _In_ UINT uNewHeight,
+        _In_ const MipChainOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ MipLevel& outImage
+    )
+    {
+        outImage = {};
+        if (!pPixels)
+        {
+            return E_POINTER;
+        }
+
+        if (format >= eMipFormat::COUNT || options.Filter >= eMipFilter::COUNT
+            || uWidth == 0u || uHeight == 0u || uNewWidth == 0u || uNewHeight == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<XMFLOAT4A> aLevel;
+        std::vector<XMFLOAT4A> aResampled;
+        loadLevel(format, pPixels, uWidth, uHeight, options.bNormalMap, pThreadPool, aLevel);
+        downsampleLevel(aLevel, uWidth, uHeight, uNewWidth, uNewHeight, options, pThreadPool, aResampled);
+        storeLevel(aResampled, uNewWidth, uNewHeight, format, options.bNormalMap, 1.0f, pThreadPool, outImage);
+
+        return S_OK;
+    }
+}
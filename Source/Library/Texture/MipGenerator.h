@@ -0,0 +1,114 @@
+/*+===================================================================
+  File:      MIPGENERATOR.H
+
+  Summary:   MipGenerator header file contains declarations of the
+             functions that build the mip chain of an image on the
+             CPU, filtering in linear space, so textures get their mips
+             without GenerateMips on the immediate context and cooked
+             textures get better filtered ones.
+
+  Structs:   MipChainOptions, MipLevel
+
+  Functions: GetMipCount, GetMipFormatPixelBytes, GetMipFormat,
+             GenerateMipChain, ResampleImage
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    class ThreadPool;
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eMipFormat
+
+      Summary:  Pixel formats the generator reads and writes. sRGB
+                colors are averaged after converting them to linear
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMipFormat : UINT
+    {
+        RGBA8_UNORM = 0,
+        RGBA8_UNORM_SRGB,
+        RGBA32_FLOAT,
+        COUNT,
+    };
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eMipFilter
+
+      Summary:  Downsampling filters. BOX averages the texels under
+                each mip texel, KAISER is a Kaiser windowed sinc that
+                keeps lower mips sharper
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMipFilter : UINT
+    {
+        BOX = 0,
+        KAISER,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MipChainOptions
+
+      Summary:  How the mips are built. Normal maps keep unit length
+                vectors in RGB. With bPreserveAlphaCoverage the alpha
+                of every mip is scaled so that as many texels pass an
+                alpha test against AlphaReference as in the top mip
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MipChainOptions
+    {
+        eMipFilter Filter;
+        BOOL bNormalMap;
+        BOOL bPreserveAlphaCoverage;
+        FLOAT AlphaReference;
+    };
+
+    constexpr const MipChainOptions DEFAULT_MIP_CHAIN_OPTIONS =
+    {
+        .Filter = eMipFilter::KAISER,
+        .bNormalMap = FALSE,
+        .bPreserveAlphaCoverage = FALSE,
+        .AlphaReference = 0.5f
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MipLevel
+
+      Summary:  One generated mip, its rows tightly packed
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MipLevel
+    {
+        UINT uWidth;
+        UINT uHeight;
+        std::vector<BYTE> aPixels;
+    };
+
+    UINT GetMipCount(_In_ UINT uWidth, _In_ UINT uHeight);
+    UINT GetMipFormatPixelBytes(_In_ eMipFormat format);
+    BOOL GetMipFormat(_In_ DXGI_FORMAT dxgiFormat, _Out_ eMipFormat& outFormat);
+
+    HRESULT GenerateMipChain(
+        _In_ eMipFormat format,
+        _In_ const BYTE* pPixels,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ const MipChainOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ std::vector<MipLevel>& outMips
+    );
+
+    HRESULT ResampleImage(
+        _In_ eMipFormat format,
+        _In_ const BYTE* pPixels,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uNewWidth,
+        _In_ UINT uNewHeight,
+        _In_ const MipChainOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ MipLevel& outImage
+    );
+}
@@ -1,5 +1,7 @@
 #include "RenderTexture.h"
 
+#include "Texture/TextureResidency.h"
+
 namespace library
 {
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -19,6 +21,17 @@ namespace library
 		m_samplerClamp(ComPtr<ID3D11SamplerState>())
 	{}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   RenderTexture::~RenderTexture
+
+	  Summary:  Destructor, removes the render target from the texture
+				residency
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	RenderTexture::~RenderTexture()
+	{
+		TextureResidency::GetDefault().Untrack(this);
+	}
+
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   RenderTexture::Initialize
@@ -53,6 +66,7 @@ namespace library
 		HRESULT hr = pDevice->CreateTexture2D(&textureDesc, NULL, m_texture2D.GetAddressOf());
 		if (FAILED(hr))
 			return hr;
+		TextureResidency::GetDefault().Track(this, textureDesc);
 		D3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc = 
 		{
 			.Format = textureDesc.Format,
@@ -23,7 +23,7 @@ namespace library
 		RenderTexture(RenderTexture&& other) = delete;
 		RenderTexture& operator=(const RenderTexture& other) = delete;
 		RenderTexture& operator=(RenderTexture&& other) = delete;
-		~RenderTexture() = default;
+		~RenderTexture();
 
 		HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
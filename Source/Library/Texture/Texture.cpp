@@ -1,12 +1,67 @@
 #include "Texture.h"
 
+#include "Texture/DDS.h"
+#include "Texture/DDSParser.h"
 #include "Texture/DDSTextureLoader.h"
+#include "Texture/MipGenerator.h"
+#include "Texture/TextureCache.h"
+#include "Texture/TextureCooker.h"
+#include "Texture/TextureResidency.h"
+#include "Texture/TextureStreamer.h"
 #include "Texture/WICTextureLoader.h"
+#include "Utility/MappedFile.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
 
 namespace library
 {
     ComPtr<ID3D11SamplerState> Texture::s_samplers[static_cast<size_t>(eTextureSamplerType::COUNT)];
 
+    constexpr const UINT STREAMING_TAIL_SIZE = 64u;
+
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: buildMips
+
+          Summary:  Builds the mips of a decoded image on the thread pool.
+                    They are filtered in linear space, cached with the
+                    image and spare the context a GenerateMips
+
+          Args:     WICDecodedImage& image
+                      Decoded image, receives the mips
+
+          Returns:  BOOL
+                      TRUE if the mips were built, FALSE if the format
+                      can't be filtered on the CPU
+        -----------------------------------------------------------------F-F*/
+        BOOL buildMips(_Inout_ WICDecodedImage& image)
+        {
+            eMipFormat mipFormat;
+            std::vector<MipLevel> aMips;
+            if (!GetMipFormat(image.Format, mipFormat)
+                || FAILED(GenerateMipChain(mipFormat, image.Pixels.data(), image.Width, image.Height, DEFAULT_MIP_CHAIN_OPTIONS, &ThreadPool::GetDefault(), aMips)))
+            {
+                return FALSE;
+            }
+
+            image.Mips.reserve(aMips.size());
+            for (MipLevel& mip : aMips)
+            {
+                image.Mips.push_back(
+                    {
+                        .Width = mip.uWidth,
+                        .Height = mip.uHeight,
+                        .RowPitch = mip.uWidth * GetMipFormatPixelBytes(mipFormat),
+                        .Pixels = std::move(mip.aPixels)
+                    }
+                );
+            }
+            return TRUE;
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Texture
 
@@ -16,48 +71,99 @@ namespace library
                   Path to the texture to use
                 eTextureSamplerType textureSamplerType
                   Texture sampler type of this texture
+                const TextureOptions& options
+                  How the file is decoded
 
-      Modifies: [m_filePath, m_textureRV, m_textureSamplerType].
+      Modifies: [m_filePath, m_textureRV, m_streamedTextureRV,
+                 m_textureSamplerType, m_options, m_file,
+                 m_ullResidentBytes, m_streamingPriority,
+                 m_uNumDroppedMips, m_bStreaming, m_snapshotPath,
+                 m_ullSnapshotOffset, m_uSnapshotSize, m_mutex].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    Texture::Texture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType) :
+    Texture::Texture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType, _In_opt_ const TextureOptions& options) :
         m_filePath(filePath),
         m_textureRV(nullptr),
-        m_textureSamplerType(textureSamplerType)
+        m_streamedTextureRV(nullptr),
+        m_textureSamplerType(textureSamplerType),
+        m_options(options),
+        m_file(),
+        m_ullResidentBytes(0ull),
+        m_streamingPriority(0.0f),
+        m_uNumDroppedMips(0u),
+        m_bStreaming(FALSE),
+        m_snapshotPath(),
+        m_ullSnapshotOffset(0ull),
+        m_uSnapshotSize(0u),
+        m_mutex()
     {}
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::~Texture
+
+      Summary:  Destructor, removes the texture from the texture
+                residency
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Texture::~Texture()
+    {
+        TextureResidency::GetDefault().Untrack(this);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Initialize
 
-      Summary:  Initializes the texture and samplers if not initialized
+      Summary:  Initializes the texture and samplers if not initialized.
+                A texture shared by several materials is only created
+                once. Uses the file mapped by Prefetch if there is one,
+                or the decoded image kept by the TextureCache. Safe to
+                call while another thread prefetches. When the
+                TextureStreamer is enabled, a texture owned by a
+                shared_ptr is created from its mip tail and its full
+                detail is queued
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_textureRV].
+      Modifies: [m_textureRV, m_file, m_ullResidentBytes,
+                 m_bStreaming].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
 		{
-        HRESULT hr = CreateWICTextureFromFile(
-            pDevice,
-            pImmediateContext,
-            m_filePath.c_str(),
-            nullptr,
-            m_textureRV.GetAddressOf()
-        );
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_textureRV)
+        {
+            return S_OK;
+        }
+
+        TextureStreamer& textureStreamer = TextureStreamer::GetDefault();
+        std::shared_ptr<Texture> texture = weak_from_this().lock();
+        HRESULT hr = S_FALSE;
+        if (texture && textureStreamer.IsEnabled())
+        {
+            hr = createTailView(pDevice, m_textureRV);
+        }
+
+        if (hr == S_OK)
+        {
+            m_bStreaming = TRUE;
+            textureStreamer.Add(texture);
+        }
+        else
+        {
+            m_textureRV.Reset();
+            hr = createTextureView(pDevice, pImmediateContext, m_textureRV);
+        }
         if (FAILED(hr))
         {
-            hr = CreateDDSTextureFromFile(pDevice, m_filePath.c_str(), nullptr, m_textureRV.GetAddressOf());
-            if (FAILED(hr))
-            {
-                OutputDebugString(L"Can't load texture from \"");
-                OutputDebugString(m_filePath.c_str());
-                OutputDebugString(L"\n");
-                return hr;
-            }
+            OutputDebugString(L"Can't load texture from \"");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L"\n");
+            return hr;
         }
 
+        updateResidentBytes();
+
         // Create the sample state
         if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].Get())
         {
@@ -106,6 +212,314 @@ namespace library
         return hr;
 		}
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Prefetch
+
+      Summary:  Maps the texture file and starts reading it, so that Initialize
+                only decodes and creates the texture. Does not touch
+                the device and can run on a worker thread. A texture
+                shared by several models, or whose decoded image is
+                still cached, is only read once. Reads the cooked
+                texture instead of the source when it is current
+
+      Modifies: [m_file].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::Prefetch()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_textureRV || m_file.IsOpen() || (!isCooked() && TextureCache::GetDefault().Contains(m_filePath, m_options)))
+        {
+            return S_OK;
+        }
+
+        return readFile();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::SetSnapshotRange
+
+      Summary:  Makes the texture read its DDS bytes from a range of a
+                scene snapshot instead of the cooked or source file.
+                The next read uses it, a file mapped already is kept.
+                Thread safe
+
+      Args:     const std::filesystem::path& snapshotPath
+                  Path to the scene snapshot
+                UINT64 ullOffset
+                  Offset of the DDS bytes in the snapshot
+                SIZE_T uSize
+                  Size of the DDS bytes
+
+      Modifies: [m_snapshotPath, m_ullSnapshotOffset, m_uSnapshotSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::SetSnapshotRange(_In_ const std::filesystem::path& snapshotPath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_snapshotPath = snapshotPath;
+        m_ullSnapshotOffset = ullOffset;
+        m_uSnapshotSize = uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::StreamFullDetail
+
+      Summary:  Creates the full texture of a texture showing its mip
+                tail, without the context. The view is kept aside until
+                CommitFullDetail. Runs on a worker thread
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+
+      Modifies: [m_streamedTextureRV, m_file].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::StreamFullDetail(_In_ ID3D11Device* pDevice)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_bStreaming)
+        {
+            return S_OK;
+        }
+
+        HRESULT hr = createTextureView(pDevice, nullptr, m_streamedTextureRV);
+        if (FAILED(hr))
+        {
+            OutputDebugString(L"Can't stream texture from \"");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L"\"\n");
+        }
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::CommitFullDetail
+
+      Summary:  Swaps the view made by StreamFullDetail in. A texture
+                whose full detail failed to load keeps its mip tail, or
+                its dropped mips. Called by the render thread between
+                frames
+
+      Modifies: [m_textureRV, m_streamedTextureRV, m_ullResidentBytes,
+                 m_uNumDroppedMips, m_bStreaming].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::CommitFullDetail()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_streamedTextureRV)
+        {
+            m_textureRV = std::move(m_streamedTextureRV);
+            m_uNumDroppedMips = 0u;
+            updateResidentBytes();
+        }
+        m_bStreaming = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::RequestDetail
+
+      Summary:  Records that the texture is drawn this frame at the
+                given size, which orders the streaming and keeps the
+                texture resident. A texture owned by a shared_ptr whose
+                top mips were dropped streams them back in. Called by
+                the render thread
+
+      Args:     FLOAT screenSize
+                  Projected radius of what the texture is drawn on,
+                  relative to half the height of the screen
+
+      Modifies: [m_streamingPriority, m_bStreaming].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::RequestDetail(_In_ FLOAT screenSize)
+    {
+        m_streamingPriority = std::max(m_streamingPriority, screenSize);
+        TextureResidency::GetDefault().MarkUsed(this);
+
+        // A worker holding the mutex is loading the texture, the draw
+        // does not wait for it and the next frame asks again
+        std::shared_ptr<Texture> texture;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+            if (!lock.owns_lock() || m_uNumDroppedMips == 0u || m_bStreaming)
+            {
+                return;
+            }
+
+            texture = weak_from_this().lock();
+            if (!texture)
+            {
+                return;
+            }
+            m_bStreaming = TRUE;
+        }
+        TextureStreamer::GetDefault().Add(texture);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::TakeStreamingPriority
+
+      Summary:  Returns the largest size requested since the last call
+                and starts over. Called by the render thread
+
+      Modifies: [m_streamingPriority].
+
+      Returns:  FLOAT
+                  Largest requested screen size, 0 if not drawn
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT Texture::TakeStreamingPriority()
+    {
+        FLOAT streamingPriority = m_streamingPriority;
+        m_streamingPriority = 0.0f;
+        return streamingPriority;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::IsStreaming
+
+      Summary:  Returns whether the texture still shows its mip tail
+
+      Returns:  BOOL
+                  TRUE until the full detail is swapped in
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::IsStreaming() const
+    {
+        return m_bStreaming;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::DropTopMips
+
+      Summary:  Replaces the texture with a copy of its smaller mips,
+                freeing the video memory of the largest ones. Every
+                slice and face is kept. Called by the render thread
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the kept mips with
+                UINT uNumMips
+                  Mips to drop, at least one mip is kept
+
+      Modifies: [m_textureRV, m_ullResidentBytes, m_uNumDroppedMips].
+
+      Returns:  HRESULT
+                  S_OK if the mips were dropped, S_FALSE if the texture
+                  is streaming, not created, has too few mips or a view
+                  that can't be rebased
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::DropTopMips(_In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uNumMips)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_bStreaming || !m_textureRV || uNumMips == 0u)
+        {
+            return S_FALSE;
+        }
+
+        ComPtr<ID3D11Resource> resource;
+        ComPtr<ID3D11Texture2D> texture2D;
+        m_textureRV->GetResource(resource.GetAddressOf());
+        if (FAILED(resource.As(&texture2D)))
+        {
+            return S_FALSE;
+        }
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        texture2D->GetDesc(&desc);
+        if (uNumMips >= desc.MipLevels)
+        {
+            return S_FALSE;
+        }
+
+        // The view keeps its dimension and slices, and sees every mip
+        // left from the new top
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        m_textureRV->GetDesc(&srvDesc);
+        switch (srvDesc.ViewDimension)
+        {
+        case D3D11_SRV_DIMENSION_TEXTURE2D:
+            srvDesc.Texture2D.MostDetailedMip = 0u;
+            srvDesc.Texture2D.MipLevels = static_cast<UINT>(-1);
+            break;
+        case D3D11_SRV_DIMENSION_TEXTURE2DARRAY:
+            srvDesc.Texture2DArray.MostDetailedMip = 0u;
+            srvDesc.Texture2DArray.MipLevels = static_cast<UINT>(-1);
+            break;
+        case D3D11_SRV_DIMENSION_TEXTURECUBE:
+            srvDesc.TextureCube.MostDetailedMip = 0u;
+            srvDesc.TextureCube.MipLevels = static_cast<UINT>(-1);
+            break;
+        case D3D11_SRV_DIMENSION_TEXTURECUBEARRAY:
+            srvDesc.TextureCubeArray.MostDetailedMip = 0u;
+            srvDesc.TextureCubeArray.MipLevels = static_cast<UINT>(-1);
+            break;
+        default:
+            return S_FALSE;
+        }
+
+        D3D11_TEXTURE2D_DESC reducedDesc = desc;
+        reducedDesc.Width = std::max(desc.Width >> uNumMips, 1u);
+        reducedDesc.Height = std::max(desc.Height >> uNumMips, 1u);
+        reducedDesc.MipLevels = desc.MipLevels - uNumMips;
+        reducedDesc.Usage = D3D11_USAGE_DEFAULT;
+        reducedDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        reducedDesc.CPUAccessFlags = 0u;
+        reducedDesc.MiscFlags = desc.MiscFlags & D3D11_RESOURCE_MISC_TEXTURECUBE;
+
+        ComPtr<ID3D11Device> device;
+        m_textureRV->GetDevice(device.GetAddressOf());
+
+        ComPtr<ID3D11Texture2D> reducedTexture;
+        HRESULT hr = device->CreateTexture2D(&reducedDesc, nullptr, reducedTexture.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        for (UINT uSlice = 0u; uSlice < desc.ArraySize; ++uSlice)
+        {
+            for (UINT uMip = 0u; uMip < reducedDesc.MipLevels; ++uMip)
+            {
+                pImmediateContext->CopySubresourceRegion(
+                    reducedTexture.Get(),
+                    D3D11CalcSubresource(uMip, uSlice, reducedDesc.MipLevels),
+                    0u,
+                    0u,
+                    0u,
+                    texture2D.Get(),
+                    D3D11CalcSubresource(uMip + uNumMips, uSlice, desc.MipLevels),
+                    nullptr
+                );
+            }
+        }
+
+        ComPtr<ID3D11ShaderResourceView> reducedTextureRV;
+        hr = device->CreateShaderResourceView(reducedTexture.Get(), &srvDesc, reducedTextureRV.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_textureRV = std::move(reducedTextureRV);
+        m_uNumDroppedMips += uNumMips;
+        updateResidentBytes();
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetNumDroppedMips
+
+      Summary:  Returns the top mips dropped to fit the budget
+
+      Returns:  UINT
+                  Mips missing until the full detail streams back in
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetNumDroppedMips() const
+    {
+        return m_uNumDroppedMips;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::GetTextureResourceView
 
@@ -119,6 +533,19 @@ namespace library
         return m_textureRV;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetFilePath
+
+      Summary:  Returns the path of the texture file
+
+      Returns:  const std::filesystem::path&
+                  Path given to the constructor
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Texture::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::GetSamplerType
 
@@ -131,4 +558,312 @@ namespace library
 		{
 			return m_textureSamplerType;
 		}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetOptions
+
+      Summary:  Returns the decoding options
+
+      Returns:  const TextureOptions&
+                  Decoding options
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TextureOptions& Texture::GetOptions() const
+    {
+        return m_options;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetResidentBytes
+
+      Summary:  Returns the video memory taken by the texture, 0 before
+                Initialize and only the mip tail while streaming
+
+      Returns:  UINT64
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Texture::GetResidentBytes() const
+    {
+        return m_ullResidentBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::isCooked
+
+      Summary:  Returns whether the texture reads ready DDS bytes, from
+                a scene snapshot or a current cooked DDS file, that are
+                never decoded by WIC. Called with the mutex held
+
+      Returns:  BOOL
+                  TRUE if the texture is cooked
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::isCooked() const
+    {
+        return !m_snapshotPath.empty() || IsCookedTextureCurrent(m_filePath);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::readFile
+
+      Summary:  Maps the range of the scene snapshot holding the
+                texture, or else the texture file, the cooked DDS file
+                if it was written after the source changed. A snapshot
+                that can't be mapped is given up for the files. Called
+                with the mutex held
+
+      Modifies: [m_file, m_snapshotPath].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::readFile()
+    {
+        if (!m_snapshotPath.empty())
+        {
+            if (SUCCEEDED(m_file.Open(m_snapshotPath, m_ullSnapshotOffset, m_uSnapshotSize)))
+            {
+                m_file.Prefetch();
+                return S_OK;
+            }
+            m_snapshotPath.clear();
+        }
+
+        std::filesystem::path filePath = IsCookedTextureCurrent(m_filePath) ? GetCookedTexturePath(m_filePath) : m_filePath;
+
+        HRESULT hr = m_file.Open(filePath);
+        if (FAILED(hr))
+        {
+            OutputDebugString(L"Can't read texture \"");
+            OutputDebugString(filePath.c_str());
+            OutputDebugString(L"\"\n");
+            return hr;
+        }
+
+        // Decoding and creation read straight from the view, which is
+        // only prefetched here instead of copied
+        m_file.Prefetch();
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::updateResidentBytes
+
+      Summary:  Recomputes the video memory taken by the texture from
+                its view and reports it to the texture residency. Called
+                with the mutex held
+
+      Modifies: [m_ullResidentBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::updateResidentBytes()
+    {
+        ComPtr<ID3D11Resource> resource;
+        ComPtr<ID3D11Texture2D> texture2D;
+        m_textureRV->GetResource(resource.GetAddressOf());
+        if (SUCCEEDED(resource.As(&texture2D)))
+        {
+            D3D11_TEXTURE2D_DESC desc = {};
+            texture2D->GetDesc(&desc);
+            m_ullResidentBytes = ComputeTextureBytes(desc);
+            TextureResidency::GetDefault().Track(this, desc, weak_from_this());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::createTailView
+
+      Summary:  Creates the texture from its mips of at most 64 texels,
+                the ones a cooked DDS file already holds, or from a
+                downsampled WIC decode with its mips built on the CPU.
+                The file stays mapped for the full load. Called with
+                the mutex held
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ComPtr<ID3D11ShaderResourceView>& outTextureRV
+                  Receives the view of the mip tail
+
+      Modifies: [m_file].
+
+      Returns:  HRESULT
+                  S_OK if the tail was created, S_FALSE if the texture
+                  is not worth streaming: it is small, has no mips, has
+                  its decoded image cached or can't be filtered on the
+                  CPU
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::createTailView(_In_ ID3D11Device* pDevice, _Out_ ComPtr<ID3D11ShaderResourceView>& outTextureRV)
+    {
+        BOOL bCooked = isCooked();
+        if (!bCooked && TextureCache::GetDefault().Contains(m_filePath, m_options))
+        {
+            return S_FALSE;
+        }
+
+        HRESULT hr = S_OK;
+        if (!m_file.IsOpen())
+        {
+            hr = readFile();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        if (m_file.GetSize() >= sizeof(DDS_MAGIC_NUMBER) && *reinterpret_cast<const UINT*>(m_file.GetData()) == DDS_MAGIC_NUMBER)
+        {
+            DDS_TEXTURE_DESC desc;
+            hr = ParseDDSTexture(m_file.GetData(), m_file.GetSize(), desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            if (desc.mipCount <= 1u || std::max(desc.width, desc.height) <= STREAMING_TAIL_SIZE)
+            {
+                return S_FALSE;
+            }
+
+            // The loader skips the mips larger than the given size and
+            // reads the rest in place
+            return CreateDDSTextureFromMemoryEx(
+                pDevice,
+                m_file.GetData(),
+                m_file.GetSize(),
+                STREAMING_TAIL_SIZE,
+                D3D11_USAGE_DEFAULT,
+                D3D11_BIND_SHADER_RESOURCE,
+                0u,
+                0u,
+                m_options.bForceSrgb,
+                nullptr,
+                outTextureRV.GetAddressOf()
+            );
+        }
+
+        if (!m_options.bGenerateMips)
+        {
+            return S_FALSE;
+        }
+
+        // WIC scales an image down to the longest side given, so one
+        // that comes out smaller was not scaled
+        WICDecodedImage image;
+        hr = DecodeWICTextureFromMemory(m_file.GetData(), m_file.GetSize(), STREAMING_TAIL_SIZE, m_options.bForceSrgb, image);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        if (std::max(image.Width, image.Height) < STREAMING_TAIL_SIZE || !buildMips(image))
+        {
+            return S_FALSE;
+        }
+
+        hr = CreateWICTextureFromDecodedImage(pDevice, nullptr, image, nullptr, outTextureRV.GetAddressOf());
+        return FAILED(hr) ? S_FALSE : S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::createTextureView
+
+      Summary:  Creates the texture from the cooked DDS file when it is
+                current, or else from the cached decoded image if there
+                is one. Otherwise loads the file bytes as DDS, or decodes
+                them with WIC, builds their mips on the CPU and caches
+                the image. Without a context the mips are always built
+                on the CPU, from an RGBA8 decode if need be. Images the
+                device cannot take as decoded go through the WIC loader,
+                which converts them. Called with the mutex held
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to generate the mipmaps of the
+                  formats the CPU can't filter, optional
+                ComPtr<ID3D11ShaderResourceView>& outTextureRV
+                  Receives the view of the texture
+
+      Modifies: [m_file].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::createTextureView(_In_ ID3D11Device* pDevice, _In_opt_ ID3D11DeviceContext* pImmediateContext, _Out_ ComPtr<ID3D11ShaderResourceView>& outTextureRV)
+    {
+        TextureCache& textureCache = TextureCache::GetDefault();
+        ID3D11DeviceContext* pMipContext = m_options.bGenerateMips ? pImmediateContext : nullptr;
+
+        BOOL bCooked = isCooked();
+        std::shared_ptr<const WICDecodedImage> image = bCooked ? nullptr : textureCache.Find(m_filePath, m_options);
+        if (image && image->Mips.empty() && m_options.bGenerateMips && !pMipContext)
+        {
+            // Cached without mips for the context to generate them
+            image.reset();
+        }
+        if (image && SUCCEEDED(CreateWICTextureFromDecodedImage(pDevice, pMipContext, *image, nullptr, outTextureRV.GetAddressOf())))
+        {
+            m_file.Close();
+            return S_OK;
+        }
+
+        HRESULT hr = S_OK;
+        if (!m_file.IsOpen())
+        {
+            hr = readFile();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        // Cooked textures carry their mips and are never decoded by WIC,
+        // which would expand the blocks
+        if (m_file.GetSize() >= sizeof(DDS_MAGIC_NUMBER) && *reinterpret_cast<const UINT*>(m_file.GetData()) == DDS_MAGIC_NUMBER)
+        {
+            hr = CreateDDSTextureFromMemoryEx(
+                pDevice,
+                m_file.GetData(),
+                m_file.GetSize(),
+                0,
+                D3D11_USAGE_DEFAULT,
+                D3D11_BIND_SHADER_RESOURCE,
+                0u,
+                0u,
+                m_options.bForceSrgb,
+                nullptr,
+                outTextureRV.GetAddressOf()
+            );
+            m_file.Close();
+            return hr;
+        }
+
+        std::shared_ptr<WICDecodedImage> decodedImage = std::make_shared<WICDecodedImage>();
+        hr = DecodeWICTextureFromMemory(m_file.GetData(), m_file.GetSize(), 0, m_options.bForceSrgb, *decodedImage);
+        BOOL bCacheable = TRUE;
+        if (SUCCEEDED(hr) && m_options.bGenerateMips && !buildMips(*decodedImage) && !pMipContext)
+        {
+            // Formats the generator can't filter fall back to the context.
+            // Without one, as on the streaming workers, the image is
+            // decoded again as RGBA8 so its mips are built on the CPU.
+            // That decode may have lost precision and is not cached
+            decodedImage = std::make_shared<WICDecodedImage>();
+            hr = DecodeWICTextureFromMemory(m_file.GetData(), m_file.GetSize(), 0, m_options.bForceSrgb, *decodedImage, true);
+            if (SUCCEEDED(hr))
+            {
+                buildMips(*decodedImage);
+            }
+            bCacheable = FALSE;
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = CreateWICTextureFromDecodedImage(pDevice, pMipContext, *decodedImage, nullptr, outTextureRV.GetAddressOf());
+            if (SUCCEEDED(hr) && bCacheable)
+            {
+                textureCache.Insert(m_filePath, m_options, std::move(decodedImage));
+            }
+            else if (FAILED(hr))
+            {
+                hr = CreateWICTextureFromMemory(pDevice, pMipContext, m_file.GetData(), m_file.GetSize(), nullptr, outTextureRV.GetAddressOf());
+            }
+        }
+
+        m_file.Close();
+        return hr;
+    }
 }
\ No newline at end of file
@@ -12,6 +12,10 @@
 
 #include "Common.h"
 
+#include "Utility/MappedFile.h"
+
+#include <mutex>
+
 namespace library
 {
     enum class eTextureSamplerType : size_t
@@ -21,29 +25,92 @@ namespace library
         COUNT,
     };
 
-    class Texture
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureOptions
+
+      Summary:  How a texture file is decoded. Part of the key of the
+                shared textures and of the decoded image cache
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureOptions
+    {
+        BOOL bForceSrgb;
+        BOOL bGenerateMips;
+    };
+
+    constexpr const TextureOptions DEFAULT_TEXTURE_OPTIONS =
+    {
+        .bForceSrgb = FALSE,
+        .bGenerateMips = TRUE
+    };
+
+    class Texture : public std::enable_shared_from_this<Texture>
     {
     public:
         Texture() = delete;
-        Texture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType = eTextureSamplerType::TRILINEAR_WRAP);
+        Texture(
+            _In_ const std::filesystem::path& filePath,
+            _In_opt_ eTextureSamplerType textureSamplerType = eTextureSamplerType::TRILINEAR_WRAP,
+            _In_opt_ const TextureOptions& options = DEFAULT_TEXTURE_OPTIONS
+        );
         Texture(const Texture& other) = delete;
         Texture(Texture&& other) = delete;
         Texture& operator=(const Texture& other) = delete;
         Texture& operator=(Texture&& other) = delete;
-        virtual ~Texture() = default;
+        virtual ~Texture();
 
         // Should be called once to load the texture
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
+        // Reads the file ahead of Initialize, may run on a worker thread
+        HRESULT Prefetch();
+
+        // Reads the DDS bytes from a range of a scene snapshot instead
+        // of the file
+        void SetSnapshotRange(_In_ const std::filesystem::path& snapshotPath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize);
+
+        // Loads the full detail of a texture created from its mip tail
+        // on a worker thread, and swaps it in on the render thread
+        HRESULT StreamFullDetail(_In_ ID3D11Device* pDevice);
+        void CommitFullDetail();
+        void RequestDetail(_In_ FLOAT screenSize);
+        FLOAT TakeStreamingPriority();
+        BOOL IsStreaming() const;
+
+        // Drops top mips to fit the TextureResidency budget, they are
+        // streamed back in once the texture is drawn again
+        HRESULT DropTopMips(_In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uNumMips);
+        UINT GetNumDroppedMips() const;
+
         ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
+        const std::filesystem::path& GetFilePath() const;
         eTextureSamplerType GetSamplerType() const;
+        const TextureOptions& GetOptions() const;
+        UINT64 GetResidentBytes() const;
 
     public:
         static ComPtr<ID3D11SamplerState> s_samplers[static_cast<size_t>(eTextureSamplerType::COUNT)];
 
+    protected:
+        BOOL isCooked() const;
+        HRESULT readFile();
+        void updateResidentBytes();
+        HRESULT createTailView(_In_ ID3D11Device* pDevice, _Out_ ComPtr<ID3D11ShaderResourceView>& outTextureRV);
+        HRESULT createTextureView(_In_ ID3D11Device* pDevice, _In_opt_ ID3D11DeviceContext* pImmediateContext, _Out_ ComPtr<ID3D11ShaderResourceView>& outTextureRV);
+
     protected:
         std::filesystem::path m_filePath;
         ComPtr<ID3D11ShaderResourceView> m_textureRV;
+        ComPtr<ID3D11ShaderResourceView> m_streamedTextureRV;
         eTextureSamplerType m_textureSamplerType;
+        TextureOptions m_options;
+        MappedFile m_file;
+        UINT64 m_ullResidentBytes;
+        FLOAT m_streamingPriority;
+        UINT m_uNumDroppedMips;
+        BOOL m_bStreaming;
+        std::filesystem::path m_snapshotPath;
+        UINT64 m_ullSnapshotOffset;
+        SIZE_T m_uSnapshotSize;
+        std::mutex m_mutex;
     };
 }
\ No newline at end of file
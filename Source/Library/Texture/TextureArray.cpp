@@ -0,0 +1,175 @@
+#include "Texture/TextureArray.h"
+
+#include <algorithm>
+
+namespace library
+{
+    namespace
+    {
+        // The Direct3D 11 limits (D3D11_REQ_*) a Texture2DArray has to
+        // fit in
+        constexpr const UINT REQ_TEXTURE2D_U_OR_V_DIMENSION = 16384u;
+        constexpr const UINT REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION = 2048u;
+
+#ifdef D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION
+        static_assert(REQ_TEXTURE2D_U_OR_V_DIMENSION == D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION
+            && REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION == D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION,
+            "Direct3D 11 limits mismatch");
+#endif
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: fillLevel
+
+          Summary:  Creates a level of a single color
+
+          Args:     eMipFormat format
+                      Pixel format
+                    const XMFLOAT4& color
+                      Color of every texel, in linear space
+                    UINT uWidth
+                      Width of the level
+                    UINT uHeight
+                      Height of the level
+                    MipLevel& outLevel
+                      Receives the level
+        -----------------------------------------------------------------F-F*/
+        void fillLevel(_In_ eMipFormat format, _In_ const XMFLOAT4& color, _In_ UINT uWidth, _In_ UINT uHeight, _Out_ MipLevel& outLevel)
+        {
+            BYTE aTexel[sizeof(XMFLOAT4)] = {};
+            UINT uPixelBytes = GetMipFormatPixelBytes(format);
+            if (format == eMipFormat::RGBA32_FLOAT)
+            {
+                memcpy(aTexel, &color, sizeof(XMFLOAT4));
+            }
+            else
+            {
+                XMVECTOR texel = XMVectorSaturate(XMLoadFloat4(&color));
+                if (format == eMipFormat::RGBA8_UNORM_SRGB)
+                {
+                    texel = XMColorRGBToSRGB(texel);
+                }
+
+                XMVECTORU32 bytes;
+                bytes.v = XMConvertVectorFloatToUInt(XMVectorMultiplyAdd(texel, XMVectorReplicate(255.0f), g_XMOneHalf), 0u);
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    aTexel[c] = static_cast<BYTE>(std::min(bytes.u[c], 255u));
+                }
+            }
+
+            outLevel.uWidth = uWidth;
+            outLevel.uHeight = uHeight;
+            outLevel.aPixels.resize(static_cast<SIZE_T>(uWidth) * uHeight * uPixelBytes);
+            for (SIZE_T uOffset = 0u; uOffset < outLevel.aPixels.size(); uOffset += uPixelBytes)
+            {
+                memcpy(outLevel.aPixels.data() + uOffset, aTexel, uPixelBytes);
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: PackTextureArray
+
+      Summary:  Packs images into the slices of an array with a full mip
+                chain. Images of another size are resampled to the size
+                of the array first, then every slice gets its own mips,
+                so no slice bleeds into another
+
+      Args:     eMipFormat format
+                  Format of the images, and of the array
+                const std::vector<TextureArraySlice>& aSlices
+                  Source of every slice, in order
+                UINT uWidth
+                  Width of the array
+                UINT uHeight
+                  Height of the array
+                const MipChainOptions& options
+                  Filter of the resampling and the mips
+                ThreadPool* pThreadPool
+                  Pool to filter on, nullptr filters on the caller
+                TextureArrayImage& outImage
+                  Receives the packed array
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT PackTextureArray(
+        _In_ eMipFormat format,
+        _In_ const std::vector<TextureArraySlice>& aSlices,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ const MipChainOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ TextureArrayImage& outImage
+    )
+    {
+        outImage = {};
+        if (format >= eMipFormat::COUNT || aSlices.empty() || aSlices.size() > REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION
+            || uWidth == 0u || uHeight == 0u || uWidth > REQ_TEXTURE2D_U_OR_V_DIMENSION || uHeight > REQ_TEXTURE2D_U_OR_V_DIMENSION)
+        {
+            return E_INVALIDARG;
+        }
+
+        outImage.Format = format;
+        outImage.uWidth = uWidth;
+        outImage.uHeight = uHeight;
+        outImage.uArraySize = static_cast<UINT>(aSlices.size());
+        outImage.uMipLevels = GetMipCount(uWidth, uHeight);
+        outImage.aSubresources.reserve(static_cast<SIZE_T>(outImage.uArraySize) * outImage.uMipLevels);
+
+        UINT uPixelBytes = GetMipFormatPixelBytes(format);
+        for (const TextureArraySlice& slice : aSlices)
+        {
+            if (!slice.pPixels)
+            {
+                // A single color stays the same down the chain
+                for (UINT uMip = 0u; uMip < outImage.uMipLevels; ++uMip)
+                {
+                    outImage.aSubresources.emplace_back();
+                    fillLevel(format, slice.FillColor, std::max(uWidth >> uMip, 1u), std::max(uHeight >> uMip, 1u), outImage.aSubresources.back());
+                }
+                continue;
+            }
+
+            if (slice.uWidth == 0u || slice.uHeight == 0u)
+            {
+                outImage = {};
+                return E_INVALIDARG;
+            }
+
+            MipLevel top;
+            HRESULT hr = S_OK;
+            if (slice.uWidth == uWidth && slice.uHeight == uHeight)
+            {
+                top.uWidth = uWidth;
+                top.uHeight = uHeight;
+                top.aPixels.assign(slice.pPixels, slice.pPixels + static_cast<SIZE_T>(uWidth) * uHeight * uPixelBytes);
+            }
+            else
+            {
+                hr = ResampleImage(format, slice.pPixels, slice.uWidth, slice.uHeight, uWidth, uHeight, options, pThreadPool, top);
+                if (FAILED(hr))
+                {
+                    outImage = {};
+                    return hr;
+                }
+            }
+
+            std::vector<MipLevel> aMips;
+            hr = GenerateMipChain(format, top.aPixels.data(), uWidth, uHeight, options, pThreadPool, aMips);
+            if (FAILED(hr))
+            {
+                outImage = {};
+                return hr;
+            }
+
+            outImage.aSubresources.push_back(std::move(top));
+            for (MipLevel& mip : aMips)
+            {
+                outImage.aSubresources.push_back(std::move(mip));
+            }
+        }
+
+        return S_OK;
+    }
+}
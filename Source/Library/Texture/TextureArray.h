@@ -0,0 +1,67 @@
+/*+===================================================================
+  File:      TEXTUREARRAY.H
+
+  Summary:   TextureArray header file contains declarations of the
+             functions that pack images of different sizes into the
+             slices of one Texture2DArray with full mip chains. Packing
+             runs on the CPU, TextureArrayResource.h creates the device
+             texture.
+
+  Structs:   TextureArraySlice, TextureArrayImage
+
+  Functions: PackTextureArray
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/MipGenerator.h"
+
+namespace library
+{
+    class ThreadPool;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureArraySlice
+
+      Summary:  Source of one slice, its rows tightly packed in the
+                format of the array. Without pixels the slice is filled
+                with FillColor, given in linear space
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureArraySlice
+    {
+        const BYTE* pPixels;
+        UINT uWidth;
+        UINT uHeight;
+        XMFLOAT4 FillColor;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureArrayImage
+
+      Summary:  Packed array. The subresources are ordered as Direct3D
+                numbers them, every mip of slice 0 first, so subresource
+                i is mip i % uMipLevels of slice i / uMipLevels
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureArrayImage
+    {
+        eMipFormat Format;
+        UINT uWidth;
+        UINT uHeight;
+        UINT uArraySize;
+        UINT uMipLevels;
+        std::vector<MipLevel> aSubresources;
+    };
+
+    HRESULT PackTextureArray(
+        _In_ eMipFormat format,
+        _In_ const std::vector<TextureArraySlice>& aSlices,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ const MipChainOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ TextureArrayImage& outImage
+    );
+}
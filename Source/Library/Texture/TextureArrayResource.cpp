@@ -0,0 +1,113 @@
+#include "Texture/TextureArrayResource.h"
+
+namespace library
+{
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getDxgiFormat
+
+          Summary:  Returns the DXGI format of a generator format
+
+          Args:     eMipFormat format
+                      Pixel format
+
+          Returns:  DXGI_FORMAT
+                      Matching format, DXGI_FORMAT_UNKNOWN if none
+        -----------------------------------------------------------------F-F*/
+        DXGI_FORMAT getDxgiFormat(_In_ eMipFormat format)
+        {
+            switch (format)
+            {
+            case eMipFormat::RGBA8_UNORM:
+                return DXGI_FORMAT_R8G8B8A8_UNORM;
+            case eMipFormat::RGBA8_UNORM_SRGB:
+                return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+            case eMipFormat::RGBA32_FLOAT:
+                return DXGI_FORMAT_R32G32B32A32_FLOAT;
+            default:
+                return DXGI_FORMAT_UNKNOWN;
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CreateTextureArray
+
+      Summary:  Uploads a packed array into an immutable Texture2DArray
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                const TextureArrayImage& image
+                  Packed array
+                ComPtr<ID3D11ShaderResourceView>& outTextureRV
+                  Receives the view of every slice and mip
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT CreateTextureArray(
+        _In_ ID3D11Device* pDevice,
+        _In_ const TextureArrayImage& image,
+        _Out_ ComPtr<ID3D11ShaderResourceView>& outTextureRV
+    )
+    {
+        outTextureRV.Reset();
+        DXGI_FORMAT format = getDxgiFormat(image.Format);
+        if (format == DXGI_FORMAT_UNKNOWN || image.aSubresources.size() != static_cast<SIZE_T>(image.uArraySize) * image.uMipLevels
+            || image.aSubresources.empty())
+        {
+            return E_INVALIDARG;
+        }
+
+        UINT uPixelBytes = GetMipFormatPixelBytes(image.Format);
+        std::vector<D3D11_SUBRESOURCE_DATA> aInitData;
+        aInitData.reserve(image.aSubresources.size());
+        for (const MipLevel& subresource : image.aSubresources)
+        {
+            aInitData.push_back(
+                {
+                    .pSysMem = subresource.aPixels.data(),
+                    .SysMemPitch = subresource.uWidth * uPixelBytes,
+                    .SysMemSlicePitch = static_cast<UINT>(subresource.aPixels.size())
+                }
+            );
+        }
+
+        D3D11_TEXTURE2D_DESC desc =
+        {
+            .Width = image.uWidth,
+            .Height = image.uHeight,
+            .MipLevels = image.uMipLevels,
+            .ArraySize = image.uArraySize,
+            .Format = format,
+            .SampleDesc = { .Count = 1u, .Quality = 0u },
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u
+        };
+
+        ComPtr<ID3D11Texture2D> texture;
+        HRESULT hr = pDevice->CreateTexture2D(&desc, aInitData.data(), texture.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc =
+        {
+            .Format = format,
+            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY,
+            .Texture2DArray =
+            {
+                .MostDetailedMip = 0u,
+                .MipLevels = image.uMipLevels,
+                .FirstArraySlice = 0u,
+                .ArraySize = image.uArraySize
+            }
+        };
+
+        return pDevice->CreateShaderResourceView(texture.Get(), &srvDesc, outTextureRV.GetAddressOf());
+    }
+}
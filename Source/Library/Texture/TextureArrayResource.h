@@ -0,0 +1,25 @@
+/*+===================================================================
+  File:      TEXTUREARRAYRESOURCE.H
+
+  Summary:   TextureArrayResource header file contains the declaration
+             of the function that uploads an array packed by
+             PackTextureArray into a Direct3D Texture2DArray.
+
+  Functions: CreateTextureArray
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/TextureArray.h"
+
+namespace library
+{
+    HRESULT CreateTextureArray(
+        _In_ ID3D11Device* pDevice,
+        _In_ const TextureArrayImage& image,
+        _Out_ ComPtr<ID3D11ShaderResourceView>& outTextureRV
+    );
+}
@@ -0,0 +1,287 @@
+#include "Texture/TextureCache.h"
+
+#include "Scene/AssetManager.h"
+
+namespace library
+{
+    constexpr const UINT64 DEFAULT_TEXTURE_CACHE_BUDGET = 64ull * 1024ull * 1024ull;
+
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getImageBytes
+
+          Summary:  Returns the bytes a decoded image takes with its mips
+
+          Args:     const WICDecodedImage& image
+                      Decoded image
+
+          Returns:  UINT64
+                      Bytes of the pixels of every mip
+        -----------------------------------------------------------------F-F*/
+        UINT64 getImageBytes(_In_ const WICDecodedImage& image)
+        {
+            UINT64 ullBytes = image.Pixels.size();
+            for (const WICDecodedMip& mip : image.Mips)
+            {
+                ullBytes += mip.Pixels.size();
+            }
+            return ullBytes;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetDefault
+
+      Summary:  Returns the cache shared by the library, with a budget
+                of 64 MB
+
+      Returns:  TextureCache&
+                  Shared cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCache& TextureCache::GetDefault()
+    {
+        static TextureCache s_textureCache(DEFAULT_TEXTURE_CACHE_BUDGET);
+        return s_textureCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::TextureCache
+
+      Summary:  Constructor
+
+      Args:     UINT64 ullBudgetBytes
+                  Bytes the decoded images may take, 0 caches nothing
+
+      Modifies: [m_mutex, m_entries, m_lookup, m_ullBudgetBytes,
+                 m_ullResidentBytes, m_ullBytesSaved, m_uNumHits,
+                 m_uNumMisses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCache::TextureCache(_In_ UINT64 ullBudgetBytes)
+        : m_mutex()
+        , m_entries()
+        , m_lookup()
+        , m_ullBudgetBytes(ullBudgetBytes)
+        , m_ullResidentBytes(0ull)
+        , m_ullBytesSaved(0ull)
+        , m_uNumHits(0u)
+        , m_uNumMisses(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::Find
+
+      Summary:  Returns the decoded image of the given file and options
+                and marks it as the most recently used
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureOptions& options
+                  Options it was decoded with
+
+      Modifies: [m_entries, m_ullBytesSaved, m_uNumHits, m_uNumMisses].
+
+      Returns:  std::shared_ptr<const WICDecodedImage>
+                  Decoded image, nullptr on a miss
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<const WICDecodedImage> TextureCache::Find(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options)
+    {
+        std::wstring szKey = getKey(filePath, options);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_lookup.find(szKey);
+        if (it == m_lookup.end())
+        {
+            ++m_uNumMisses;
+            return nullptr;
+        }
+
+        ++m_uNumHits;
+        m_ullBytesSaved += getImageBytes(*it->second->Image);
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+        return it->second->Image;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::Contains
+
+      Summary:  Returns whether the given file and options are cached,
+                without counting a lookup or touching the order
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureOptions& options
+                  Options it was decoded with
+
+      Returns:  BOOL
+                  TRUE if cached
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TextureCache::Contains(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options)
+    {
+        std::wstring szKey = getKey(filePath, options);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lookup.contains(szKey);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::Insert
+
+      Summary:  Adds a decoded image as the most recently used, replacing
+                any image of the same key, and evicts over the budget
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureOptions& options
+                  Options it was decoded with
+                std::shared_ptr<const WICDecodedImage> image
+                  Decoded image
+
+      Modifies: [m_entries, m_lookup, m_ullResidentBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::Insert(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options, _In_ std::shared_ptr<const WICDecodedImage> image)
+    {
+        std::wstring szKey = getKey(filePath, options);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (getImageBytes(*image) > m_ullBudgetBytes)
+        {
+            return;
+        }
+
+        auto it = m_lookup.find(szKey);
+        if (it != m_lookup.end())
+        {
+            m_ullResidentBytes -= getImageBytes(*it->second->Image);
+            m_entries.erase(it->second);
+            m_lookup.erase(it);
+        }
+
+        m_ullResidentBytes += getImageBytes(*image);
+        m_entries.push_front({ .szKey = szKey, .Image = std::move(image) });
+        m_lookup[szKey] = m_entries.begin();
+
+        evict();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::SetBudget
+
+      Summary:  Sets the bytes the decoded images may take and evicts
+                the least recently used ones over it
+
+      Args:     UINT64 ullBudgetBytes
+                  New budget, 0 caches nothing
+
+      Modifies: [m_entries, m_lookup, m_ullBudgetBytes,
+                 m_ullResidentBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::SetBudget(_In_ UINT64 ullBudgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ullBudgetBytes = ullBudgetBytes;
+        evict();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::Clear
+
+      Summary:  Drops every decoded image. Textures already created are
+                not affected
+
+      Modifies: [m_entries, m_lookup, m_ullResidentBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_lookup.clear();
+        m_ullResidentBytes = 0ull;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetStats
+
+      Summary:  Returns the hits and misses so far and the cached bytes
+
+      Returns:  TextureCacheStats
+                  Current stats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCacheStats TextureCache::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return
+        {
+            .uNumHits = m_uNumHits,
+            .uNumMisses = m_uNumMisses,
+            .uNumImages = static_cast<UINT>(m_entries.size()),
+            .ullResidentBytes = m_ullResidentBytes,
+            .ullBytesSaved = m_ullBytesSaved
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::LogStats
+
+      Summary:  Writes the stats to the debug output
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::LogStats()
+    {
+        TextureCacheStats stats = GetStats();
+        UINT uNumLookups = stats.uNumHits + stats.uNumMisses;
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Decoded textures: %.1f%% hit rate (%u of %u), %.2f MB not decoded again, %u images (%.2f MB) cached\n",
+            uNumLookups ? 100.0f * static_cast<FLOAT>(stats.uNumHits) / static_cast<FLOAT>(uNumLookups) : 0.0f,
+            stats.uNumHits,
+            uNumLookups,
+            static_cast<FLOAT>(stats.ullBytesSaved) / (1024.0f * 1024.0f),
+            stats.uNumImages,
+            static_cast<FLOAT>(stats.ullResidentBytes) / (1024.0f * 1024.0f)
+        );
+        OutputDebugString(szMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::getKey
+
+      Summary:  Returns the key of a file decoded with the given options.
+                The mips built on the CPU are cached with the image, so
+                they are part of the key along with the format
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureOptions& options
+                  Decoding options
+
+      Returns:  std::wstring
+                  Key of the image
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::wstring TextureCache::getKey(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options)
+    {
+        return AssetManager::GetCanonicalPath(filePath) + (options.bForceSrgb ? L"|srgb" : L"|linear") + (options.bGenerateMips ? L"|mips" : L"|nomips");
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::evict
+
+      Summary:  Drops the least recently used images until the rest fit
+                in the budget. Called with the mutex held
+
+      Modifies: [m_entries, m_lookup, m_ullResidentBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::evict()
+    {
+        while (m_ullResidentBytes > m_ullBudgetBytes && !m_entries.empty())
+        {
+            m_ullResidentBytes -= getImageBytes(*m_entries.back().Image);
+            m_lookup.erase(m_entries.back().szKey);
+            m_entries.pop_back();
+        }
+    }
+}
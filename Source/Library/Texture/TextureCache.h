@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      TEXTURECACHE.H
+
+  Summary:   TextureCache header file contains declarations of the
+             TextureCache class that keeps recently decoded images in
+             memory, so a texture that was freed can be created again
+             without reading and decoding its file.
+
+  Classes: TextureCache
+
+  Structs: TextureCacheStats
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/Texture.h"
+#include "Texture/WICTextureLoader.h"
+
+#include <list>
+#include <mutex>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureCacheStats
+
+      Summary:  Lookups that found a decoded image and lookups that had
+                to decode, the images held, and the decoded bytes the
+                hits did not have to produce again
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureCacheStats
+    {
+        UINT uNumHits;
+        UINT uNumMisses;
+        UINT uNumImages;
+        UINT64 ullResidentBytes;
+        UINT64 ullBytesSaved;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureCache
+
+      Summary:  Least recently used set of decoded images, keyed by
+                canonical path and decoded format. Images beyond the
+                budget are dropped oldest first, a budget of 0 turns the
+                cache off. Thread safe
+
+      Methods:  GetDefault
+                  Returns the cache shared by the library
+                Find
+                  Returns the decoded image of a file, nullptr on a miss
+                Contains
+                  Returns whether a file is cached, not counted as a
+                  lookup
+                Insert
+                  Adds a decoded image
+                SetBudget
+                  Sets the bytes the images may take
+                Clear
+                  Drops every image
+                GetStats
+                  Returns the hits, misses and bytes
+                LogStats
+                  Writes the stats to the debug output
+                TextureCache
+                  Constructor.
+                ~TextureCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureCache final
+    {
+    public:
+        static TextureCache& GetDefault();
+
+        TextureCache(_In_ UINT64 ullBudgetBytes);
+        TextureCache(const TextureCache& other) = delete;
+        TextureCache(TextureCache&& other) = delete;
+        TextureCache& operator=(const TextureCache& other) = delete;
+        TextureCache& operator=(TextureCache&& other) = delete;
+        ~TextureCache() = default;
+
+        std::shared_ptr<const WICDecodedImage> Find(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options);
+        BOOL Contains(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options);
+        void Insert(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options, _In_ std::shared_ptr<const WICDecodedImage> image);
+
+        void SetBudget(_In_ UINT64 ullBudgetBytes);
+        void Clear();
+
+        TextureCacheStats GetStats();
+        void LogStats();
+
+    private:
+        struct Entry
+        {
+            std::wstring szKey;
+            std::shared_ptr<const WICDecodedImage> Image;
+        };
+
+        static std::wstring getKey(_In_ const std::filesystem::path& filePath, _In_ const TextureOptions& options);
+        void evict();
+
+    private:
+        std::mutex m_mutex;
+        std::list<Entry> m_entries;
+        std::unordered_map<std::wstring, std::list<Entry>::iterator> m_lookup;
+        UINT64 m_ullBudgetBytes;
+        UINT64 m_ullResidentBytes;
+        UINT64 m_ullBytesSaved;
+        UINT m_uNumHits;
+        UINT m_uNumMisses;
+    };
+}
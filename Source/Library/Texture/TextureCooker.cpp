@@ -0,0 +1,403 @@
+#include "Texture/TextureCooker.h"
+
+#include "Texture/DDS.h"
+#include "Texture/MipGenerator.h"
+#include "Texture/WICTextureLoader.h"
+#include "Utility/MappedFile.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <fstream>
+
+namespace library
+{
+    namespace
+    {
+        constexpr PCWSTR COOKED_TEXTURE_EXTENSION = L".cooked.dds";
+        constexpr PCWSTR NORMAL_MAP_NAMES[] = { L"normal", L"_nrm", L"_n." };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: isNormalMapPath
+
+          Summary:  Returns whether the file name of a texture marks it
+                    as a tangent space normal map
+
+          Args:     const std::filesystem::path& sourcePath
+                      Path to the source image
+
+          Returns:  BOOL
+                      TRUE if the name contains "normal", "_nrm" or ends
+                      with "_n"
+        -----------------------------------------------------------------F-F*/
+        BOOL isNormalMapPath(_In_ const std::filesystem::path& sourcePath)
+        {
+            std::wstring szFileName = sourcePath.filename().wstring();
+            std::transform(szFileName.begin(), szFileName.end(), szFileName.begin(), [](WCHAR c) { return static_cast<WCHAR>(std::towlower(c)); });
+
+            for (PCWSTR pszName : NORMAL_MAP_NAMES)
+            {
+                if (szFileName.find(pszName) != std::wstring::npos)
+                {
+                    return TRUE;
+                }
+            }
+            return FALSE;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: appendBytes
+
+          Summary:  Appends the bytes of a header to a file image
+
+          Args:     std::vector<BYTE>& aFile
+                      File image
+                    const T& value
+                      Header to append
+        -----------------------------------------------------------------F-F*/
+        template <typename T>
+        void appendBytes(_Inout_ std::vector<BYTE>& aFile, _In_ const T& value)
+        {
+            const BYTE* pBytes = reinterpret_cast<const BYTE*>(&value);
+            aFile.insert(aFile.end(), pBytes, pBytes + sizeof(T));
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetCookedTexturePath
+
+      Summary:  Returns the path a source image is cooked to, the source
+                path with ".cooked.dds" appended. The extra suffix keeps
+                cooked files apart from the DDS files artists check in
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+
+      Returns:  std::filesystem::path
+                  Path to the cooked texture
+    -----------------------------------------------------------------F-F*/
+    std::filesystem::path GetCookedTexturePath(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::filesystem::path cookedPath = sourcePath;
+        cookedPath += COOKED_TEXTURE_EXTENSION;
+
+        return cookedPath;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: IsCookedTextureCurrent
+
+      Summary:  Returns whether a source image has a cooked texture
+                written after the source last changed
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+
+      Returns:  BOOL
+                  TRUE if the cooked texture can be loaded instead
+    -----------------------------------------------------------------F-F*/
+    BOOL IsCookedTextureCurrent(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type cookedTime = std::filesystem::last_write_time(GetCookedTexturePath(sourcePath), error);
+        if (error)
+        {
+            return FALSE;
+        }
+
+        std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, error);
+        return error || cookedTime >= sourceTime;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ChooseCompressedFormat
+
+      Summary:  Picks the format of a texture: BC5 for normal maps, BC1
+                for opaque images and BC7 for images with alpha
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image, its name marks normal maps
+                const BYTE* pRgba
+                  RGBA8 pixels of the image
+                UINT uNumPixels
+                  Number of pixels
+
+      Returns:  eCompressedFormat
+                  Format to cook with
+    -----------------------------------------------------------------F-F*/
+    eCompressedFormat ChooseCompressedFormat(
+        _In_ const std::filesystem::path& sourcePath,
+        _In_reads_(uNumPixels * 4u) const BYTE* pRgba,
+        _In_ UINT uNumPixels
+    )
+    {
+        if (isNormalMapPath(sourcePath))
+        {
+            return eCompressedFormat::BC5;
+        }
+
+        for (SIZE_T i = 0u; i < uNumPixels; ++i)
+        {
+            if (pRgba[i * 4u + 3u] != 255u)
+            {
+                return eCompressedFormat::BC7;
+            }
+        }
+        return eCompressedFormat::BC1;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CookImage
+
+      Summary:  Builds the full mip chain of an image with a Kaiser
+                filter in linear space, compresses every mip on the
+                thread pool and lays them out as a DDS file with a DX10
+                header. Does not touch the file system
+
+      Args:     const BYTE* pRgba
+                  RGBA8 image, rows tightly packed
+                UINT uWidth
+                  Width of the image, a multiple of 4
+                UINT uHeight
+                  Height of the image, a multiple of 4
+                eCompressedFormat format
+                  Format to compress to, BC5 mips are renormalized
+                BOOL bSrgb
+                  Whether the texture is created as sRGB, its mips are
+                  then averaged in linear space
+                BOOL bPreserveAlphaCoverage
+                  Whether the mips keep the alpha tested coverage of
+                  the top mip
+                ThreadPool* pThreadPool
+                  Pool to encode on, nullptr encodes on the caller
+                std::vector<BYTE>& outDdsFile
+                  Receives the DDS file
+                TextureCookStats& outStats
+                  Receives the sizes, throughput and PSNR
+
+      Returns:  HRESULT
+                  Status code, ERROR_NOT_SUPPORTED if the size can't be
+                  block compressed
+    -----------------------------------------------------------------F-F*/
+    HRESULT CookImage(
+        _In_reads_(uWidth * uHeight * 4u) const BYTE* pRgba,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ eCompressedFormat format,
+        _In_ BOOL bSrgb,
+        _In_ BOOL bPreserveAlphaCoverage,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ std::vector<BYTE>& outDdsFile,
+        _Out_ TextureCookStats& outStats
+    )
+    {
+        outDdsFile.clear();
+        outStats = {};
+
+        // Direct3D needs the top mip of a block compressed texture to be
+        // whole blocks
+        if (uWidth == 0u || uHeight == 0u || uWidth % BC_BLOCK_SIZE != 0u || uHeight % BC_BLOCK_SIZE != 0u)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        UINT uNumMips = GetMipCount(uWidth, uHeight);
+
+        UINT uBlockBytes = GetBlockBytes(format);
+        UINT64 ullTopMipBytes = static_cast<UINT64>(uWidth / BC_BLOCK_SIZE) * (uHeight / BC_BLOCK_SIZE) * uBlockBytes;
+
+        DdsHeader header =
+        {
+            .uSize = sizeof(DdsHeader),
+            .uFlags = DDS_FLAG_CAPS | DDS_FLAG_HEIGHT | DDS_FLAG_WIDTH | DDS_FLAG_PIXEL_FORMAT | DDS_FLAG_MIP_COUNT | DDS_FLAG_LINEAR_SIZE,
+            .uHeight = uHeight,
+            .uWidth = uWidth,
+            .uPitchOrLinearSize = static_cast<UINT>(ullTopMipBytes),
+            .uDepth = 0u,
+            .uMipMapCount = uNumMips,
+            .auReserved1 = {},
+            .PixelFormat =
+            {
+                .uSize = sizeof(DdsPixelFormat),
+                .uFlags = DDS_PIXEL_FORMAT_FOURCC,
+                .uFourCC = DDS_FOURCC_DX10,
+                .uRgbBitCount = 0u,
+                .uRBitMask = 0u,
+                .uGBitMask = 0u,
+                .uBBitMask = 0u,
+                .uABitMask = 0u
+            },
+            .uCaps = DDS_CAPS_TEXTURE | (uNumMips > 1u ? DDS_CAPS_COMPLEX | DDS_CAPS_MIPMAP : 0u),
+            .uCaps2 = 0u,
+            .uCaps3 = 0u,
+            .uCaps4 = 0u,
+            .uReserved2 = 0u
+        };
+        DdsHeaderDx10 headerDx10 =
+        {
+            .Format = GetBlockDxgiFormat(format, bSrgb),
+            .uResourceDimension = DDS_DIMENSION_TEXTURE2D,
+            .uMiscFlag = 0u,
+            .uArraySize = 1u,
+            .uMiscFlags2 = 0u
+        };
+
+        appendBytes(outDdsFile, DDS_MAGIC_NUMBER);
+        appendBytes(outDdsFile, header);
+        appendBytes(outDdsFile, headerDx10);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        MipChainOptions mipOptions = DEFAULT_MIP_CHAIN_OPTIONS;
+        mipOptions.bNormalMap = format == eCompressedFormat::BC5;
+        mipOptions.bPreserveAlphaCoverage = bPreserveAlphaCoverage;
+
+        std::vector<MipLevel> aMips;
+        QueryPerformanceCounter(&startingTime);
+        HRESULT hr = GenerateMipChain(bSrgb ? eMipFormat::RGBA8_UNORM_SRGB : eMipFormat::RGBA8_UNORM, pRgba, uWidth, uHeight, mipOptions, pThreadPool, aMips);
+        QueryPerformanceCounter(&endingTime);
+        if (FAILED(hr))
+        {
+            outDdsFile.clear();
+            return hr;
+        }
+        DOUBLE mipSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        std::vector<BYTE> aBlocks;
+        UINT64 ullEncodeTicks = 0ull;
+        UINT64 ullNumPixels = 0ull;
+        for (UINT uMip = 0u; uMip < uNumMips; ++uMip)
+        {
+            const BYTE* pMip = uMip == 0u ? pRgba : aMips[uMip - 1u].aPixels.data();
+            UINT uMipWidth = uMip == 0u ? uWidth : aMips[uMip - 1u].uWidth;
+            UINT uMipHeight = uMip == 0u ? uHeight : aMips[uMip - 1u].uHeight;
+            SIZE_T uMipBytes = static_cast<SIZE_T>(uMipWidth) * uMipHeight * 4u;
+
+            UINT uNumBlocks = ((uMipWidth + BC_BLOCK_SIZE - 1u) / BC_BLOCK_SIZE) * ((uMipHeight + BC_BLOCK_SIZE - 1u) / BC_BLOCK_SIZE);
+            aBlocks.resize(static_cast<SIZE_T>(uNumBlocks) * uBlockBytes);
+
+            QueryPerformanceCounter(&startingTime);
+            CompressImage(format, pMip, uMipWidth, uMipHeight, aBlocks.data(), pThreadPool);
+            QueryPerformanceCounter(&endingTime);
+            ullEncodeTicks += static_cast<UINT64>(endingTime.QuadPart - startingTime.QuadPart);
+
+            if (uMip == 0u)
+            {
+                std::vector<BYTE> aDecoded(uMipBytes);
+                DecompressImage(format, aBlocks.data(), uMipWidth, uMipHeight, aDecoded.data());
+                outStats.Psnr = ComputePsnr(pMip, aDecoded.data(), uMipWidth * uMipHeight, GetBlockNumChannels(format));
+            }
+
+            outDdsFile.insert(outDdsFile.end(), aBlocks.begin(), aBlocks.end());
+            outStats.ullUncompressedBytes += uMipBytes;
+            ullNumPixels += static_cast<UINT64>(uMipWidth) * uMipHeight;
+        }
+
+        DOUBLE seconds = static_cast<DOUBLE>(ullEncodeTicks) / static_cast<DOUBLE>(frequency.QuadPart);
+        outStats.Format = format;
+        outStats.uWidth = uWidth;
+        outStats.uHeight = uHeight;
+        outStats.uNumMips = uNumMips;
+        outStats.ullCookedBytes = outDdsFile.size();
+        outStats.MipMilliseconds = static_cast<FLOAT>(mipSeconds * 1000.0);
+        outStats.EncodeMilliseconds = static_cast<FLOAT>(seconds * 1000.0);
+        outStats.MegapixelsPerSecond = seconds > 0.0 ? static_cast<FLOAT>(static_cast<DOUBLE>(ullNumPixels) / seconds / 1e6) : 0.0f;
+
+        return S_OK;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CookTexture
+
+      Summary:  Decodes a source image with WIC, cooks it and writes the
+                DDS file to GetCookedTexturePath. The file is written
+                under a temporary name and renamed at the end, so a
+                texture being loaded never sees it half written
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+                const TextureCookOptions& options
+                  Format, color space and alpha coverage to cook with
+                ThreadPool* pThreadPool
+                  Pool to encode on, nullptr encodes on the caller
+                TextureCookStats* pOutStats
+                  Receives the sizes, throughput and PSNR, optional
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT CookTexture(
+        _In_ const std::filesystem::path& sourcePath,
+        _In_ const TextureCookOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_opt_ TextureCookStats* pOutStats
+    )
+    {
+        MappedFile sourceFile;
+        HRESULT hr = sourceFile.Open(sourcePath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        WICDecodedImage image;
+        hr = DecodeWICTextureFromMemory(sourceFile.GetData(), sourceFile.GetSize(), 0, false, image, true);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // Rows of 32 bit pixels are already tightly packed
+        assert(image.RowPitch == image.Width * 4u);
+
+        eCompressedFormat format = options.bChooseFormat
+            ? ChooseCompressedFormat(sourcePath, image.Pixels.data(), image.Width * image.Height)
+            : options.Format;
+
+        std::vector<BYTE> aDdsFile;
+        TextureCookStats stats;
+        hr = CookImage(image.Pixels.data(), image.Width, image.Height, format, options.bSrgb, options.bPreserveAlphaCoverage, pThreadPool, aDdsFile, stats);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        std::filesystem::path cookedPath = GetCookedTexturePath(sourcePath);
+        std::filesystem::path tempPath = cookedPath;
+        tempPath += L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+        {
+            std::ofstream cookedFile(tempPath, std::ios::binary | std::ios::trunc);
+            if (!cookedFile.is_open())
+            {
+                return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+            }
+
+            cookedFile.write(reinterpret_cast<const CHAR*>(aDdsFile.data()), static_cast<std::streamsize>(aDdsFile.size()));
+            if (!cookedFile.good())
+            {
+                cookedFile.close();
+                std::error_code error;
+                std::filesystem::remove(tempPath, error);
+                return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, cookedPath, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+        }
+
+        if (pOutStats)
+        {
+            *pOutStats = stats;
+        }
+        return S_OK;
+    }
+}
@@ -0,0 +1,102 @@
+/*+===================================================================
+  File:      TEXTURECOOKER.H
+
+  Summary:   TextureCooker header file contains declarations of the
+             functions that turn a source image into a mipmapped,
+             block compressed DDS file next to it, which Texture loads
+             instead of decoding the source at run time.
+
+  Structs:   TextureCookOptions, TextureCookStats
+
+  Functions: GetCookedTexturePath, IsCookedTextureCurrent,
+             ChooseCompressedFormat, CookImage, CookTexture
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/BlockCompression.h"
+
+#include <filesystem>
+
+namespace library
+{
+    class ThreadPool;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureCookOptions
+
+      Summary:  How a texture is cooked. With bChooseFormat the format
+                comes from ChooseCompressedFormat instead of Format.
+                bPreserveAlphaCoverage keeps alpha tested foliage from
+                thinning out in the lower mips
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureCookOptions
+    {
+        BOOL bChooseFormat;
+        eCompressedFormat Format;
+        BOOL bSrgb;
+        BOOL bPreserveAlphaCoverage;
+    };
+
+    constexpr const TextureCookOptions DEFAULT_TEXTURE_COOK_OPTIONS =
+    {
+        .bChooseFormat = TRUE,
+        .Format = eCompressedFormat::BC7,
+        .bSrgb = FALSE,
+        .bPreserveAlphaCoverage = FALSE
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureCookStats
+
+      Summary:  What cooking a texture produced: its format and mips,
+                the bytes of every mip before and after compression,
+                the time spent filtering the mips, the encoding
+                throughput over all mips and the PSNR of
+                the top mip over the channels the format keeps
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureCookStats
+    {
+        eCompressedFormat Format;
+        UINT uWidth;
+        UINT uHeight;
+        UINT uNumMips;
+        UINT64 ullUncompressedBytes;
+        UINT64 ullCookedBytes;
+        FLOAT MipMilliseconds;
+        FLOAT EncodeMilliseconds;
+        FLOAT MegapixelsPerSecond;
+        FLOAT Psnr;
+    };
+
+    std::filesystem::path GetCookedTexturePath(_In_ const std::filesystem::path& sourcePath);
+    BOOL IsCookedTextureCurrent(_In_ const std::filesystem::path& sourcePath);
+
+    eCompressedFormat ChooseCompressedFormat(
+        _In_ const std::filesystem::path& sourcePath,
+        _In_reads_(uNumPixels * 4u) const BYTE* pRgba,
+        _In_ UINT uNumPixels
+    );
+
+    HRESULT CookImage(
+        _In_reads_(uWidth * uHeight * 4u) const BYTE* pRgba,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ eCompressedFormat format,
+        _In_ BOOL bSrgb,
+        _In_ BOOL bPreserveAlphaCoverage,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_ std::vector<BYTE>& outDdsFile,
+        _Out_ TextureCookStats& outStats
+    );
+
+    HRESULT CookTexture(
+        _In_ const std::filesystem::path& sourcePath,
+        _In_ const TextureCookOptions& options,
+        _In_opt_ ThreadPool* pThreadPool,
+        _Out_opt_ TextureCookStats* pOutStats
+    );
+}
@@ -0,0 +1,556 @@
+#include "Texture/TextureResidency.h"
+
+#include "Texture/Texture.h"
+
+#include <algorithm>
+
+namespace library
+{
+    constexpr const UINT64 DEFAULT_TEXTURE_RESIDENCY_BUDGET = 0ull;
+    constexpr const UINT64 RESIDENCY_IDLE_FRAMES = 30ull;
+    constexpr const UINT RESIDENCY_MIN_SIZE = 64u;
+
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getBlockBytes
+
+          Summary:  Returns the size of a 4x4 block of a block compressed
+                    format
+
+          Args:     DXGI_FORMAT format
+                      Format of the texture
+
+          Returns:  UINT
+                      Bytes per block, 0 if the format is not block
+                      compressed
+        -----------------------------------------------------------------F-F*/
+        UINT getBlockBytes(_In_ DXGI_FORMAT format)
+        {
+            switch (format)
+            {
+            case DXGI_FORMAT_BC1_UNORM:
+            case DXGI_FORMAT_BC1_UNORM_SRGB:
+            case DXGI_FORMAT_BC4_UNORM:
+            case DXGI_FORMAT_BC4_SNORM:
+                return 8u;
+            case DXGI_FORMAT_BC2_UNORM:
+            case DXGI_FORMAT_BC2_UNORM_SRGB:
+            case DXGI_FORMAT_BC3_UNORM:
+            case DXGI_FORMAT_BC3_UNORM_SRGB:
+            case DXGI_FORMAT_BC5_UNORM:
+            case DXGI_FORMAT_BC5_SNORM:
+            case DXGI_FORMAT_BC6H_UF16:
+            case DXGI_FORMAT_BC6H_SF16:
+            case DXGI_FORMAT_BC7_UNORM:
+            case DXGI_FORMAT_BC7_UNORM_SRGB:
+                return 16u;
+            default:
+                return 0u;
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: isRenderTarget
+
+          Summary:  Returns whether an allocation is drawn to
+
+          Args:     const D3D11_TEXTURE2D_DESC& desc
+                      Description of the texture
+
+          Returns:  BOOL
+                      TRUE for render targets and depth buffers
+        -----------------------------------------------------------------F-F*/
+        BOOL isRenderTarget(_In_ const D3D11_TEXTURE2D_DESC& desc)
+        {
+            return (desc.BindFlags & (D3D11_BIND_RENDER_TARGET | D3D11_BIND_DEPTH_STENCIL)) != 0u;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeTextureBytes
+
+      Summary:  Returns the video memory taken by every mip and slice of
+                a 2D texture, block compressed formats count whole
+                blocks
+
+      Args:     const D3D11_TEXTURE2D_DESC& desc
+                  Description of the texture
+
+      Returns:  UINT64
+                  Size in bytes
+    -----------------------------------------------------------------F-F*/
+    UINT64 ComputeTextureBytes(_In_ const D3D11_TEXTURE2D_DESC& desc)
+    {
+        UINT uBlockBytes = getBlockBytes(desc.Format);
+        UINT uPixelBytes = 4u;
+        switch (desc.Format)
+        {
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_A8_UNORM:
+            uPixelBytes = 1u;
+            break;
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_B5G6R5_UNORM:
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            uPixelBytes = 2u;
+            break;
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R32G32_FLOAT:
+            uPixelBytes = 8u;
+            break;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            uPixelBytes = 16u;
+            break;
+        default:
+            break;
+        }
+
+        UINT64 ullBytes = 0ull;
+        for (UINT uMip = 0u; uMip < desc.MipLevels; ++uMip)
+        {
+            UINT uWidth = std::max(desc.Width >> uMip, 1u);
+            UINT uHeight = std::max(desc.Height >> uMip, 1u);
+            if (uBlockBytes > 0u)
+            {
+                ullBytes += static_cast<UINT64>((uWidth + 3u) / 4u) * ((uHeight + 3u) / 4u) * uBlockBytes;
+            }
+            else
+            {
+                ullBytes += static_cast<UINT64>(uWidth) * uHeight * uPixelBytes;
+            }
+        }
+
+        return ullBytes * desc.ArraySize * std::max(desc.SampleDesc.Count, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::GetDefault
+
+      Summary:  Returns the residency shared by the library, without a
+                budget until one is set
+
+      Returns:  TextureResidency&
+                  Shared residency
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureResidency& TextureResidency::GetDefault()
+    {
+        static TextureResidency s_textureResidency(DEFAULT_TEXTURE_RESIDENCY_BUDGET);
+        return s_textureResidency;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::TextureResidency
+
+      Summary:  Constructor
+
+      Args:     UINT64 ullBudgetBytes
+                  Bytes the textures may take, 0 evicts nothing
+
+      Modifies: [m_mutex, m_allocations, m_ullBudgetBytes,
+                 m_ullTextureBytes, m_ullRenderTargetBytes, m_ullFrame,
+                 m_uNumEvicted, m_ullEvictedBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureResidency::TextureResidency(_In_ UINT64 ullBudgetBytes)
+        : m_mutex()
+        , m_allocations()
+        , m_ullBudgetBytes(ullBudgetBytes)
+        , m_ullTextureBytes(0ull)
+        , m_ullRenderTargetBytes(0ull)
+        , m_ullFrame(0ull)
+        , m_uNumEvicted(0u)
+        , m_ullEvictedBytes(0ull)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::SetBudget
+
+      Summary:  Sets the bytes the textures may take. Render targets
+                are not part of the budget. The next Update evicts down
+                to it
+
+      Args:     UINT64 ullBudgetBytes
+                  Budget in bytes, 0 evicts nothing
+
+      Modifies: [m_ullBudgetBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidency::SetBudget(_In_ UINT64 ullBudgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ullBudgetBytes = ullBudgetBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::GetBudget
+
+      Summary:  Returns the bytes the textures may take
+
+      Returns:  UINT64
+                  Budget in bytes, 0 if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 TextureResidency::GetBudget()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ullBudgetBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::Track
+
+      Summary:  Records an allocation, or its new size when the owner
+                recreated it. A new allocation counts as used this frame.
+                One that grew back to more mips is no longer reduced
+
+      Args:     const void* pOwner
+                  Object owning the allocation
+                const D3D11_TEXTURE2D_DESC& desc
+                  Description of the allocated texture
+                const std::weak_ptr<Texture>& texture
+                  Texture that can drop its top mips, empty if the
+                  allocation can't be evicted
+
+      Modifies: [m_allocations, m_ullTextureBytes,
+                 m_ullRenderTargetBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidency::Track(_In_ const void* pOwner, _In_ const D3D11_TEXTURE2D_DESC& desc, _In_opt_ const std::weak_ptr<Texture>& texture)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_allocations.find(pOwner);
+        if (it == m_allocations.end())
+        {
+            it = m_allocations.emplace(
+                pOwner,
+                Allocation
+                {
+                    .Desc = desc,
+                    .ullBytes = 0ull,
+                    .ullLastUsedFrame = m_ullFrame,
+                    .uNumDroppedMips = 0u,
+                    .Evictable = texture
+                }
+            ).first;
+        }
+        else
+        {
+            (isRenderTarget(it->second.Desc) ? m_ullRenderTargetBytes : m_ullTextureBytes) -= it->second.ullBytes;
+            if (desc.MipLevels > it->second.Desc.MipLevels)
+            {
+                it->second.uNumDroppedMips = 0u;
+            }
+            it->second.Desc = desc;
+            it->second.Evictable = texture;
+        }
+
+        it->second.ullBytes = ComputeTextureBytes(desc);
+        (isRenderTarget(desc) ? m_ullRenderTargetBytes : m_ullTextureBytes) += it->second.ullBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::Untrack
+
+      Summary:  Forgets the allocation of an owner that released it
+
+      Args:     const void* pOwner
+                  Object owning the allocation
+
+      Modifies: [m_allocations, m_ullTextureBytes,
+                 m_ullRenderTargetBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidency::Untrack(_In_ const void* pOwner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_allocations.find(pOwner);
+        if (it != m_allocations.end())
+        {
+            (isRenderTarget(it->second.Desc) ? m_ullRenderTargetBytes : m_ullTextureBytes) -= it->second.ullBytes;
+            m_allocations.erase(it);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::MarkUsed
+
+      Summary:  Records that an allocation is drawn this frame, which
+                makes it the last to be evicted
+
+      Args:     const void* pOwner
+                  Object owning the allocation
+
+      Modifies: [m_allocations].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidency::MarkUsed(_In_ const void* pOwner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_allocations.find(pOwner);
+        if (it != m_allocations.end())
+        {
+            it->second.ullLastUsedFrame = m_ullFrame;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::Update
+
+      Summary:  Called once a frame, before anything is drawn. Starts a
+                new frame and, while the textures are over the budget,
+                drops the top mips of the ones drawn longest ago. A
+                texture drawn again streams its full detail back in
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the kept mips with
+
+      Modifies: [m_allocations, m_ullFrame, m_uNumEvicted,
+                 m_ullEvictedBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidency::Update(_In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        std::vector<Eviction> aEvictions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_ullFrame;
+            m_uNumEvicted = 0u;
+            m_ullEvictedBytes = 0ull;
+            aEvictions = planEvictions();
+        }
+
+        // Dropping the mips tracks the smaller texture, so the lock is
+        // not held while the textures are recreated
+        UINT uNumEvicted = 0u;
+        UINT64 ullEvictedBytes = 0ull;
+        std::vector<std::pair<const void*, UINT>> aDropped;
+        for (const Eviction& eviction : aEvictions)
+        {
+            if (eviction.Victim->DropTopMips(pImmediateContext, eviction.uNumMips) == S_OK)
+            {
+                ++uNumEvicted;
+                ullEvictedBytes += eviction.ullBytes;
+                aDropped.emplace_back(eviction.Victim.get(), eviction.uNumMips);
+            }
+        }
+
+        if (aEvictions.empty())
+        {
+            return;
+        }
+
+        UINT64 ullTextureBytes = 0ull;
+        UINT64 ullBudgetBytes = 0ull;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_uNumEvicted = uNumEvicted;
+            m_ullEvictedBytes = ullEvictedBytes;
+            for (const auto& [pOwner, uNumMips] : aDropped)
+            {
+                auto it = m_allocations.find(pOwner);
+                if (it != m_allocations.end())
+                {
+                    it->second.uNumDroppedMips += uNumMips;
+                }
+            }
+            ullTextureBytes = m_ullTextureBytes;
+            ullBudgetBytes = m_ullBudgetBytes;
+        }
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Evicted top mips of %u textures (%.2f MB), %.2f of %.2f MB of textures resident\n",
+            uNumEvicted,
+            static_cast<FLOAT>(ullEvictedBytes) / (1024.0f * 1024.0f),
+            static_cast<FLOAT>(ullTextureBytes) / (1024.0f * 1024.0f),
+            static_cast<FLOAT>(ullBudgetBytes) / (1024.0f * 1024.0f)
+        );
+        OutputDebugString(szMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::GetReport
+
+      Summary:  Returns the memory taken at the last Update, by kind and
+                by format, and what that Update evicted
+
+      Returns:  TextureResidencyReport
+                  Current report, formats ordered by size
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureResidencyReport TextureResidency::GetReport()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        TextureResidencyReport report =
+        {
+            .ullFrame = m_ullFrame,
+            .ullBudgetBytes = m_ullBudgetBytes,
+            .ullTextureBytes = m_ullTextureBytes,
+            .ullRenderTargetBytes = m_ullRenderTargetBytes,
+            .uNumTextures = 0u,
+            .uNumRenderTargets = 0u,
+            .uNumReducedTextures = 0u,
+            .uNumEvicted = m_uNumEvicted,
+            .ullEvictedBytes = m_ullEvictedBytes,
+            .aFormats = std::vector<TextureResidencyFormat>()
+        };
+
+        for (const auto& [pOwner, allocation] : m_allocations)
+        {
+            if (isRenderTarget(allocation.Desc))
+            {
+                ++report.uNumRenderTargets;
+            }
+            else
+            {
+                ++report.uNumTextures;
+            }
+            if (allocation.uNumDroppedMips > 0u)
+            {
+                ++report.uNumReducedTextures;
+            }
+
+            auto it = std::find_if(
+                report.aFormats.begin(),
+                report.aFormats.end(),
+                [&](const TextureResidencyFormat& format) { return format.Format == allocation.Desc.Format; }
+            );
+            if (it == report.aFormats.end())
+            {
+                report.aFormats.push_back({ .Format = allocation.Desc.Format, .uNumAllocations = 0u, .ullBytes = 0ull });
+                it = report.aFormats.end() - 1;
+            }
+            ++it->uNumAllocations;
+            it->ullBytes += allocation.ullBytes;
+        }
+
+        std::sort(
+            report.aFormats.begin(),
+            report.aFormats.end(),
+            [](const TextureResidencyFormat& a, const TextureResidencyFormat& b)
+            {
+                return a.ullBytes > b.ullBytes;
+            }
+        );
+
+        return report;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::LogReport
+
+      Summary:  Writes the report to the debug output
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidency::LogReport()
+    {
+        TextureResidencyReport report = GetReport();
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Texture residency: %u textures (%.2f MB, %u reduced), %u render targets (%.2f MB), budget %.2f MB\n",
+            report.uNumTextures,
+            static_cast<FLOAT>(report.ullTextureBytes) / (1024.0f * 1024.0f),
+            report.uNumReducedTextures,
+            report.uNumRenderTargets,
+            static_cast<FLOAT>(report.ullRenderTargetBytes) / (1024.0f * 1024.0f),
+            static_cast<FLOAT>(report.ullBudgetBytes) / (1024.0f * 1024.0f)
+        );
+        OutputDebugString(szMessage);
+
+        for (const TextureResidencyFormat& format : report.aFormats)
+        {
+            swprintf_s(
+                szMessage,
+                L"  DXGI format %u: %u allocations, %.2f MB\n",
+                static_cast<UINT>(format.Format),
+                format.uNumAllocations,
+                static_cast<FLOAT>(format.ullBytes) / (1024.0f * 1024.0f)
+            );
+            OutputDebugString(szMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidency::planEvictions
+
+      Summary:  Chooses the textures to reduce, least recently drawn
+                first. Textures drawn in the last RESIDENCY_IDLE_FRAMES
+                frames are kept. Each loses the fewest top mips that
+                bring the textures inside the budget, or as many as
+                leave a top of RESIDENCY_MIN_SIZE texels. Block
+                compressed tops stay multiples of the block size. Called
+                with the mutex held
+
+      Returns:  std::vector<Eviction>
+                  Textures, mips to drop and bytes saved
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<TextureResidency::Eviction> TextureResidency::planEvictions()
+    {
+        std::vector<Eviction> aEvictions;
+        if (m_ullBudgetBytes == 0ull || m_ullTextureBytes <= m_ullBudgetBytes)
+        {
+            return aEvictions;
+        }
+
+        std::vector<const Allocation*> aCandidates;
+        for (const auto& [pOwner, allocation] : m_allocations)
+        {
+            if (!allocation.Evictable.expired() && m_ullFrame - allocation.ullLastUsedFrame >= RESIDENCY_IDLE_FRAMES)
+            {
+                aCandidates.push_back(&allocation);
+            }
+        }
+        std::sort(
+            aCandidates.begin(),
+            aCandidates.end(),
+            [](const Allocation* a, const Allocation* b)
+            {
+                return a->ullLastUsedFrame != b->ullLastUsedFrame ? a->ullLastUsedFrame < b->ullLastUsedFrame : a->ullBytes > b->ullBytes;
+            }
+        );
+
+        UINT64 ullExcessBytes = m_ullTextureBytes - m_ullBudgetBytes;
+        for (const Allocation* pAllocation : aCandidates)
+        {
+            UINT uBlockBytes = getBlockBytes(pAllocation->Desc.Format);
+            UINT uNumMips = 0u;
+            UINT64 ullSavedBytes = 0ull;
+            for (UINT uDrop = 1u; uDrop < pAllocation->Desc.MipLevels && ullSavedBytes < ullExcessBytes; ++uDrop)
+            {
+                D3D11_TEXTURE2D_DESC desc = pAllocation->Desc;
+                desc.Width = std::max(desc.Width >> uDrop, 1u);
+                desc.Height = std::max(desc.Height >> uDrop, 1u);
+                desc.MipLevels -= uDrop;
+                if (std::max(desc.Width, desc.Height) < RESIDENCY_MIN_SIZE || (uBlockBytes > 0u && (desc.Width % 4u != 0u || desc.Height % 4u != 0u)))
+                {
+                    break;
+                }
+
+                uNumMips = uDrop;
+                ullSavedBytes = pAllocation->ullBytes - ComputeTextureBytes(desc);
+            }
+
+            if (uNumMips == 0u)
+            {
+                continue;
+            }
+
+            // Locked last, a texture released in between is destroyed by
+            // Update, outside of the mutex its destructor takes
+            std::shared_ptr<Texture> victim = pAllocation->Evictable.lock();
+            if (!victim)
+            {
+                continue;
+            }
+
+            aEvictions.push_back({ .Victim = std::move(victim), .uNumMips = uNumMips, .ullBytes = ullSavedBytes });
+            if (ullSavedBytes >= ullExcessBytes)
+            {
+                break;
+            }
+            ullExcessBytes -= ullSavedBytes;
+        }
+
+        return aEvictions;
+    }
+}
@@ -0,0 +1,147 @@
+/*+===================================================================
+  File:      TEXTURERESIDENCY.H
+
+  Summary:   TextureResidency header file contains declarations of the
+             TextureResidency class that accounts the video memory of
+             every texture and render target and keeps the textures
+             inside a budget by dropping the top mips of the ones not
+             drawn for the longest time.
+
+  Classes: TextureResidency
+
+  Functions: ComputeTextureBytes
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+namespace library
+{
+    class Texture;
+
+    UINT64 ComputeTextureBytes(_In_ const D3D11_TEXTURE2D_DESC& desc);
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureResidencyFormat
+
+      Summary:  Allocations of one format and the bytes they take
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureResidencyFormat
+    {
+        DXGI_FORMAT Format;
+        UINT uNumAllocations;
+        UINT64 ullBytes;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureResidencyReport
+
+      Summary:  Video memory of the textures and render targets at the
+                last Update, the textures that have top mips dropped and
+                what that Update evicted
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureResidencyReport
+    {
+        UINT64 ullFrame;
+        UINT64 ullBudgetBytes;
+        UINT64 ullTextureBytes;
+        UINT64 ullRenderTargetBytes;
+        UINT uNumTextures;
+        UINT uNumRenderTargets;
+        UINT uNumReducedTextures;
+        UINT uNumEvicted;
+        UINT64 ullEvictedBytes;
+        std::vector<TextureResidencyFormat> aFormats;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureResidency
+
+      Summary:  Allocations of the textures and render targets, keyed by
+                their owner. Textures over the budget lose top mips, the
+                least recently drawn first, and stream them back in
+                when they are drawn again. Render targets are counted
+                but never evicted. A budget of 0 evicts nothing. Thread
+                safe, Update is called by the render thread
+
+      Methods:  GetDefault
+                  Returns the residency shared by the library
+                SetBudget
+                  Sets the bytes the textures may take
+                GetBudget
+                  Returns the budget
+                Track
+                  Records or updates an allocation
+                Untrack
+                  Forgets an allocation
+                MarkUsed
+                  Records that an allocation is drawn this frame
+                Update
+                  Starts a frame and evicts down to the budget
+                GetReport
+                  Returns the memory and evictions of the last frame
+                LogReport
+                  Writes the report to the debug output
+                TextureResidency
+                  Constructor.
+                ~TextureResidency
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureResidency final
+    {
+    public:
+        static TextureResidency& GetDefault();
+
+        TextureResidency(_In_ UINT64 ullBudgetBytes);
+        TextureResidency(const TextureResidency& other) = delete;
+        TextureResidency(TextureResidency&& other) = delete;
+        TextureResidency& operator=(const TextureResidency& other) = delete;
+        TextureResidency& operator=(TextureResidency&& other) = delete;
+        ~TextureResidency() = default;
+
+        void SetBudget(_In_ UINT64 ullBudgetBytes);
+        UINT64 GetBudget();
+
+        void Track(_In_ const void* pOwner, _In_ const D3D11_TEXTURE2D_DESC& desc, _In_opt_ const std::weak_ptr<Texture>& texture = std::weak_ptr<Texture>());
+        void Untrack(_In_ const void* pOwner);
+        void MarkUsed(_In_ const void* pOwner);
+
+        void Update(_In_ ID3D11DeviceContext* pImmediateContext);
+
+        TextureResidencyReport GetReport();
+        void LogReport();
+
+    private:
+        struct Allocation
+        {
+            D3D11_TEXTURE2D_DESC Desc;
+            UINT64 ullBytes;
+            UINT64 ullLastUsedFrame;
+            UINT uNumDroppedMips;
+            std::weak_ptr<Texture> Evictable;
+        };
+
+        struct Eviction
+        {
+            std::shared_ptr<Texture> Victim;
+            UINT uNumMips;
+            UINT64 ullBytes;
+        };
+
+        std::vector<Eviction> planEvictions();
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<const void*, Allocation> m_allocations;
+        UINT64 m_ullBudgetBytes;
+        UINT64 m_ullTextureBytes;
+        UINT64 m_ullRenderTargetBytes;
+        UINT64 m_ullFrame;
+        UINT m_uNumEvicted;
+        UINT64 m_ullEvictedBytes;
+    };
+}
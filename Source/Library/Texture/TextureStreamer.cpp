@@ -0,0 +1,260 @@
+#include "Texture/TextureStreamer.h"
+
+#include "Texture/TextureResidency.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+
+namespace library
+{
+    constexpr const UINT DEFAULT_MAX_NUM_STREAMING_LOADS = 2u;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetDefault
+
+      Summary:  Returns the streamer shared by the library, loading two
+                textures at a time so the rest of the pool stays free
+
+      Returns:  TextureStreamer&
+                  Shared streamer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer& TextureStreamer::GetDefault()
+    {
+        // Constructed first so that it outlives the textures the
+        // streamer still holds at exit
+        TextureResidency::GetDefault();
+        static TextureStreamer s_textureStreamer(DEFAULT_MAX_NUM_STREAMING_LOADS);
+        return s_textureStreamer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::TextureStreamer
+
+      Summary:  Constructor. Streaming starts disabled
+
+      Args:     UINT uMaxNumLoads
+                  Textures loaded on the thread pool at the same time
+
+      Modifies: [m_mutex, m_loadedCondition, m_aQueued, m_aLoaded,
+                 m_uMaxNumLoads, m_uNumLoading, m_uNumStreamed,
+                 m_bEnabled, m_startingTime].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer::TextureStreamer(_In_ UINT uMaxNumLoads)
+        : m_mutex()
+        , m_loadedCondition()
+        , m_aQueued()
+        , m_aLoaded()
+        , m_uMaxNumLoads(std::max(uMaxNumLoads, 1u))
+        , m_uNumLoading(0u)
+        , m_uNumStreamed(0u)
+        , m_bEnabled(FALSE)
+        , m_startingTime()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::~TextureStreamer
+
+      Summary:  Destructor. Drops the queue and waits for the loads on
+                the thread pool, which point back at the streamer
+
+      Modifies: [m_aQueued].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer::~TextureStreamer()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_aQueued.clear();
+        m_loadedCondition.wait(
+            lock,
+            [this]()
+            {
+                return m_aLoaded.size() == m_uNumLoading;
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::SetEnabled
+
+      Summary:  Chooses whether the textures initialized from now on are
+                created from their mip tail and streamed. Textures
+                already queued are still loaded
+
+      Args:     BOOL bEnabled
+                  TRUE to stream
+
+      Modifies: [m_bEnabled].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::SetEnabled(_In_ BOOL bEnabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bEnabled = bEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::IsEnabled
+
+      Summary:  Returns whether textures are streamed
+
+      Returns:  BOOL
+                  TRUE if streaming is on
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TextureStreamer::IsEnabled() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::Add
+
+      Summary:  Queues the full detail of a texture created from its mip
+                tail. The queue does not keep the texture alive
+
+      Args:     const std::shared_ptr<Texture>& texture
+                  Texture to stream
+
+      Modifies: [m_aQueued, m_uNumStreamed, m_startingTime].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::Add(_In_ const std::shared_ptr<Texture>& texture)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_aQueued.empty() && m_uNumLoading == 0u)
+        {
+            m_uNumStreamed = 0u;
+            QueryPerformanceCounter(&m_startingTime);
+        }
+
+        m_aQueued.push_back(texture);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::Update
+
+      Summary:  Called once a frame, before anything is drawn. Swaps the
+                textures loaded since the last frame in, then sends the
+                queued textures that were requested at the largest
+                screen size to the thread pool, as many as there are
+                free loads. The projected size falls with the distance
+                to the camera, textures not drawn last frame come last
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the textures
+
+      Modifies: [m_aQueued, m_aLoaded, m_uNumLoading, m_uNumStreamed].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::Update(_In_ ID3D11Device* pDevice)
+    {
+        std::vector<std::shared_ptr<Texture>> aLoaded;
+        std::vector<std::weak_ptr<Texture>> aQueued;
+        UINT uNumFreeLoads = 0u;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            aLoaded.swap(m_aLoaded);
+            m_uNumLoading -= static_cast<UINT>(aLoaded.size());
+            uNumFreeLoads = m_uMaxNumLoads - m_uNumLoading;
+            if (uNumFreeLoads > 0u)
+            {
+                aQueued.swap(m_aQueued);
+            }
+        }
+
+        // The render thread is the only one reading the views, so they
+        // can be swapped here without stalling a draw
+        for (const std::shared_ptr<Texture>& texture : aLoaded)
+        {
+            texture->CommitFullDetail();
+        }
+
+        std::vector<std::pair<FLOAT, std::shared_ptr<Texture>>> aCandidates;
+        aCandidates.reserve(aQueued.size());
+        for (const std::weak_ptr<Texture>& weakTexture : aQueued)
+        {
+            std::shared_ptr<Texture> texture = weakTexture.lock();
+            if (texture)
+            {
+                aCandidates.emplace_back(texture->TakeStreamingPriority(), std::move(texture));
+            }
+        }
+        std::stable_sort(
+            aCandidates.begin(),
+            aCandidates.end(),
+            [](const std::pair<FLOAT, std::shared_ptr<Texture>>& a, const std::pair<FLOAT, std::shared_ptr<Texture>>& b)
+            {
+                return a.first > b.first;
+            }
+        );
+
+        UINT uNumStarted = std::min(uNumFreeLoads, static_cast<UINT>(aCandidates.size()));
+        BOOL bIdle = FALSE;
+        UINT uNumStreamed = 0u;
+        DOUBLE elapsedMilliseconds = 0.0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_uNumLoading += uNumStarted;
+            m_uNumStreamed += static_cast<UINT>(aLoaded.size());
+            for (SIZE_T i = uNumStarted; i < aCandidates.size(); ++i)
+            {
+                m_aQueued.push_back(aCandidates[i].second);
+            }
+
+            bIdle = !aLoaded.empty() && m_aQueued.empty() && m_uNumLoading == 0u;
+            if (bIdle)
+            {
+                uNumStreamed = m_uNumStreamed;
+                LARGE_INTEGER frequency;
+                LARGE_INTEGER endingTime;
+                QueryPerformanceFrequency(&frequency);
+                QueryPerformanceCounter(&endingTime);
+                elapsedMilliseconds = static_cast<DOUBLE>(endingTime.QuadPart - m_startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+            }
+        }
+
+        ComPtr<ID3D11Device> device(pDevice);
+        for (UINT i = 0u; i < uNumStarted; ++i)
+        {
+            std::shared_ptr<Texture> texture = std::move(aCandidates[i].second);
+            ThreadPool::GetDefault().Submit(
+                [this, device, texture]()
+                {
+                    // WIC is created through COM, which the workers have
+                    // not joined
+                    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+                    texture->StreamFullDetail(device.Get());
+                    if (SUCCEEDED(hr))
+                    {
+                        CoUninitialize();
+                    }
+
+                    // Notified under the lock, so the destructor can't
+                    // return before the task is done with the streamer
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_aLoaded.push_back(texture);
+                    m_loadedCondition.notify_all();
+                }
+            );
+        }
+
+        if (bIdle)
+        {
+            WCHAR szMessage[128];
+            swprintf_s(szMessage, L"Streamed %u textures in %.2f ms\n", uNumStreamed, elapsedMilliseconds);
+            OutputDebugString(szMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetNumPending
+
+      Summary:  Returns the textures queued, loading, or loaded but not
+                swapped in yet
+
+      Returns:  UINT
+                  Number of textures still showing their mip tail
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureStreamer::GetNumPending()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<UINT>(m_aQueued.size()) + m_uNumLoading;
+    }
+}
@@ -0,0 +1,82 @@
+/*+===================================================================
+  File:      TEXTURESTREAMER.H
+
+  Summary:   TextureStreamer header file contains declarations of the
+             TextureStreamer class that loads the full detail of the
+             textures on worker threads after they were created from
+             their lowest mips, so the first frame does not wait for
+             every texture to be read and decoded.
+
+  Classes: TextureStreamer
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/Texture.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureStreamer
+
+      Summary:  Queue of textures showing their mip tail. Each frame the
+                ones covering the most of the screen are sent to the
+                thread pool first, and the loaded ones are swapped in.
+                Thread safe, Update is called by the render thread
+
+      Methods:  GetDefault
+                  Returns the streamer shared by the library
+                SetEnabled
+                  Chooses whether textures are created from their mip
+                  tail and streamed
+                IsEnabled
+                  Returns whether streaming is on
+                Add
+                  Queues the full detail of a texture
+                Update
+                  Swaps in the loaded textures and starts new loads
+                GetNumPending
+                  Returns the textures still queued or loading
+                TextureStreamer
+                  Constructor.
+                ~TextureStreamer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureStreamer final
+    {
+    public:
+        static TextureStreamer& GetDefault();
+
+        TextureStreamer(_In_ UINT uMaxNumLoads);
+        TextureStreamer(const TextureStreamer& other) = delete;
+        TextureStreamer(TextureStreamer&& other) = delete;
+        TextureStreamer& operator=(const TextureStreamer& other) = delete;
+        TextureStreamer& operator=(TextureStreamer&& other) = delete;
+        ~TextureStreamer();
+
+        void SetEnabled(_In_ BOOL bEnabled);
+        BOOL IsEnabled() const;
+
+        void Add(_In_ const std::shared_ptr<Texture>& texture);
+        void Update(_In_ ID3D11Device* pDevice);
+
+        UINT GetNumPending();
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable m_loadedCondition;
+        std::vector<std::weak_ptr<Texture>> m_aQueued;
+        std::vector<std::shared_ptr<Texture>> m_aLoaded;
+        UINT m_uMaxNumLoads;
+        UINT m_uNumLoading;
+        UINT m_uNumStreamed;
+        BOOL m_bEnabled;
+        LARGE_INTEGER m_startingTime;
+    };
+}
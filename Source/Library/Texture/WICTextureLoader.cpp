@@ -503,7 +503,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             memset(&SRVDesc, 0, sizeof(SRVDesc));
             SRVDesc.Format = format;
             SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-            SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : 1;
+            SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : mipLevels;
 
             hr = d3dDevice->CreateShaderResourceView(tex, &SRVDesc, textureView);
             if (FAILED(hr))
@@ -688,4 +688,299 @@ HRESULT CreateWICTextureFromFile(_In_ ID3D11Device* d3dDevice,
 #endif
 
     return hr;
-}
\ No newline at end of file
+}
+//---------------------------------------------------------------------------------
+static DXGI_FORMAT _MakeSRGB(_In_ DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+        return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+        return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+
+    case DXGI_FORMAT_B8G8R8X8_UNORM:
+        return DXGI_FORMAT_B8G8R8X8_UNORM_SRGB;
+
+    default:
+        return format;
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// Device independent half of CreateWICTextureFromMemory. Without a device the format
+// support cannot be checked, so CreateWICTextureFromDecodedImage fails with
+// ERROR_NOT_SUPPORTED when the device cannot take the decoded format or size.
+// forceRGBA8 converts every image to 32bpp RGBA, for CPU side processing
+HRESULT DecodeWICTextureFromMemory(_In_bytecount_(wicDataSize) const uint8_t* wicData,
+    _In_ size_t wicDataSize,
+    _In_ size_t maxsize,
+    _In_ bool forceSRGB,
+    _Out_ WICDecodedImage& image,
+    _In_ bool forceRGBA8
+)
+{
+    image = {};
+
+    if (!wicData)
+    {
+        return E_INVALIDARG;
+    }
+
+    if (!wicDataSize)
+    {
+        return E_FAIL;
+    }
+
+#ifdef _M_AMD64
+    if (wicDataSize > 0xFFFFFFFF)
+        return HRESULT_FROM_WIN32(ERROR_FILE_TOO_LARGE);
+#endif
+
+    IWICImagingFactory* pWIC = _GetWIC();
+    if (!pWIC)
+        return E_NOINTERFACE;
+
+    ScopedObject<IWICStream> stream;
+    HRESULT hr = pWIC->CreateStream(&stream);
+    if (FAILED(hr))
+        return hr;
+
+    hr = stream->InitializeFromMemory(const_cast<uint8_t*>(wicData), static_cast<DWORD>(wicDataSize));
+    if (FAILED(hr))
+        return hr;
+
+    ScopedObject<IWICBitmapDecoder> decoder;
+    hr = pWIC->CreateDecoderFromStream(stream.Get(), 0, WICDecodeMetadataCacheOnDemand, &decoder);
+    if (FAILED(hr))
+        return hr;
+
+    ScopedObject<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame(0, &frame);
+    if (FAILED(hr))
+        return hr;
+
+    UINT width, height;
+    hr = frame->GetSize(&width, &height);
+    if (FAILED(hr))
+        return hr;
+
+    assert(width > 0 && height > 0);
+
+    if (!maxsize)
+    {
+        maxsize = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+    }
+
+    UINT twidth = width;
+    UINT theight = height;
+    if (width > maxsize || height > maxsize)
+    {
+        float ar = static_cast<float>(height) / static_cast<float>(width);
+        if (width > height)
+        {
+            twidth = static_cast<UINT>(maxsize);
+            theight = static_cast<UINT>(static_cast<float>(maxsize) * ar);
+        }
+        else
+        {
+            theight = static_cast<UINT>(maxsize);
+            twidth = static_cast<UINT>(static_cast<float>(maxsize) / ar);
+        }
+    }
+
+    WICPixelFormatGUID pixelFormat;
+    hr = frame->GetPixelFormat(&pixelFormat);
+    if (FAILED(hr))
+        return hr;
+
+    WICPixelFormatGUID convertGUID;
+    memcpy(&convertGUID, &pixelFormat, sizeof(WICPixelFormatGUID));
+
+    size_t bpp = 0;
+
+    DXGI_FORMAT format = _WICToDXGI(pixelFormat);
+    if (forceRGBA8)
+    {
+        memcpy(&convertGUID, &GUID_WICPixelFormat32bppRGBA, sizeof(WICPixelFormatGUID));
+        format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        bpp = 32;
+    }
+    else if (format == DXGI_FORMAT_UNKNOWN)
+    {
+        for (size_t i = 0; i < _countof(g_WICConvert); ++i)
+        {
+            if (memcmp(&g_WICConvert[i].source, &pixelFormat, sizeof(WICPixelFormatGUID)) == 0)
+            {
+                memcpy(&convertGUID, &g_WICConvert[i].target, sizeof(WICPixelFormatGUID));
+
+                format = _WICToDXGI(g_WICConvert[i].target);
+                assert(format != DXGI_FORMAT_UNKNOWN);
+                bpp = _WICBitsPerPixel(convertGUID);
+                break;
+            }
+        }
+
+        if (format == DXGI_FORMAT_UNKNOWN)
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+    }
+    else
+    {
+        bpp = _WICBitsPerPixel(pixelFormat);
+    }
+
+    if (!bpp)
+        return E_FAIL;
+
+    size_t rowPitch = (twidth * bpp + 7) / 8;
+    size_t imageSize = rowPitch * theight;
+    image.Pixels.resize(imageSize);
+
+    // Scale first if needed, then convert the format if needed
+    ScopedObject<IWICBitmapScaler> scaler;
+    IWICBitmapSource* source = frame.Get();
+    if (twidth != width || theight != height)
+    {
+        hr = pWIC->CreateBitmapScaler(&scaler);
+        if (FAILED(hr))
+            return hr;
+
+        hr = scaler->Initialize(frame.Get(), twidth, theight, WICBitmapInterpolationModeFant);
+        if (FAILED(hr))
+            return hr;
+
+        source = scaler.Get();
+    }
+
+    WICPixelFormatGUID sourceFormat;
+    hr = source->GetPixelFormat(&sourceFormat);
+    if (FAILED(hr))
+        return hr;
+
+    if (memcmp(&convertGUID, &sourceFormat, sizeof(GUID)) == 0)
+    {
+        hr = source->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), image.Pixels.data());
+    }
+    else
+    {
+        ScopedObject<IWICFormatConverter> FC;
+        hr = pWIC->CreateFormatConverter(&FC);
+        if (FAILED(hr))
+            return hr;
+
+        hr = FC->Initialize(source, convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom);
+        if (FAILED(hr))
+            return hr;
+
+        hr = FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), image.Pixels.data());
+    }
+    if (FAILED(hr))
+        return hr;
+
+    image.Width = twidth;
+    image.Height = theight;
+    image.RowPitch = static_cast<UINT>(rowPitch);
+    image.Format = forceSRGB ? _MakeSRGB(format) : format;
+
+    return S_OK;
+}
+
+//--------------------------------------------------------------------------------------
+// Device half of CreateWICTextureFromMemory. Mips decoded along with the image are
+// uploaded with it, otherwise they are generated if a context is given and the format
+// supports it
+HRESULT CreateWICTextureFromDecodedImage(_In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WICDecodedImage& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView
+)
+{
+    if (!d3dDevice || image.Pixels.empty() || (!texture && !textureView))
+    {
+        return E_INVALIDARG;
+    }
+
+    UINT support = 0;
+    HRESULT hr = d3dDevice->CheckFormatSupport(image.Format, &support);
+    if (FAILED(hr) || !(support & D3D11_FORMAT_SUPPORT_TEXTURE2D))
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+    if (!image.Mips.empty() && !(support & D3D11_FORMAT_SUPPORT_MIP))
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+    bool autogen = image.Mips.empty() && d3dContext != 0 && textureView != 0 && (support & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN);
+    UINT mipLevels = 1 + static_cast<UINT>(image.Mips.size());
+
+    D3D11_TEXTURE2D_DESC desc;
+    desc.Width = image.Width;
+    desc.Height = image.Height;
+    desc.MipLevels = (autogen) ? 0 : mipLevels;
+    desc.ArraySize = 1;
+    desc.Format = image.Format;
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = (autogen) ? (D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET) : (D3D11_BIND_SHADER_RESOURCE);
+    desc.CPUAccessFlags = 0;
+    desc.MiscFlags = (autogen) ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
+
+    std::unique_ptr<D3D11_SUBRESOURCE_DATA[]> initData(new (std::nothrow) D3D11_SUBRESOURCE_DATA[mipLevels]);
+    if (!initData)
+        return E_OUTOFMEMORY;
+
+    initData[0].pSysMem = image.Pixels.data();
+    initData[0].SysMemPitch = image.RowPitch;
+    initData[0].SysMemSlicePitch = static_cast<UINT>(image.Pixels.size());
+    for (size_t i = 0; i < image.Mips.size(); ++i)
+    {
+        initData[i + 1].pSysMem = image.Mips[i].Pixels.data();
+        initData[i + 1].SysMemPitch = image.Mips[i].RowPitch;
+        initData[i + 1].SysMemSlicePitch = static_cast<UINT>(image.Mips[i].Pixels.size());
+    }
+
+    ID3D11Texture2D* tex = nullptr;
+    hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : initData.get(), &tex);
+    if (FAILED(hr) || !tex)
+        return hr;
+
+    if (textureView != 0)
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc;
+        memset(&SRVDesc, 0, sizeof(SRVDesc));
+        SRVDesc.Format = image.Format;
+        SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : mipLevels;
+
+        hr = d3dDevice->CreateShaderResourceView(tex, &SRVDesc, textureView);
+        if (FAILED(hr))
+        {
+            tex->Release();
+            return hr;
+        }
+
+        if (autogen)
+        {
+            d3dContext->UpdateSubresource(tex, 0, nullptr, image.Pixels.data(), image.RowPitch, static_cast<UINT>(image.Pixels.size()));
+            d3dContext->GenerateMips(*textureView);
+        }
+    }
+
+    if (texture != 0)
+    {
+        *texture = tex;
+    }
+    else
+    {
+#if defined(_DEBUG) || defined(PROFILE)
+        tex->SetPrivateData(WKPDID_D3DDebugObjectName,
+            sizeof("WICTextureLoader") - 1,
+            "WICTextureLoader"
+        );
+#endif
+        tex->Release();
+    }
+
+    return S_OK;
+}
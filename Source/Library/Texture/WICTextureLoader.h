@@ -53,4 +53,43 @@ HRESULT CreateWICTextureFromFile(
     _Out_opt_ ID3D11Resource** texture,
     _Out_opt_ ID3D11ShaderResourceView** textureView,
     _In_ size_t maxsize = 0
-    );
\ No newline at end of file
+    );
+
+// One mip below the top of a decoded image, in the format of the image
+struct WICDecodedMip
+{
+    UINT Width;
+    UINT Height;
+    UINT RowPitch;
+    std::vector<uint8_t> Pixels;
+};
+
+// Pixels of the first frame of a WIC image, converted to a DXGI format but not yet
+// uploaded, so an image can be decoded once and turned into textures again later.
+// Mips are filled in by the caller when it builds the chain on the CPU
+struct WICDecodedImage
+{
+    UINT Width;
+    UINT Height;
+    UINT RowPitch;
+    DXGI_FORMAT Format;
+    std::vector<uint8_t> Pixels;
+    std::vector<WICDecodedMip> Mips;
+};
+
+HRESULT DecodeWICTextureFromMemory(
+    _In_bytecount_(wicDataSize) const uint8_t* wicData,
+    _In_ size_t wicDataSize,
+    _In_ size_t maxsize,
+    _In_ bool forceSRGB,
+    _Out_ WICDecodedImage& image,
+    _In_ bool forceRGBA8 = false
+    );
+
+HRESULT CreateWICTextureFromDecodedImage(
+    _In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WICDecodedImage& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView
+    );
@@ -0,0 +1,52 @@
+#include "Utility/Hash.h"
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: HashBytes
+
+      Summary:  64-bit FNV-1a hash of a block of memory. Passing the
+                result of a previous call as the seed hashes several
+                blocks as if they were contiguous
+
+      Args:     const void* pData
+                  Data to hash
+                SIZE_T uSize
+                  Size of the data in bytes
+                UINT64 ullSeed
+                  Starting value of the hash
+
+      Returns:  UINT64
+                  Hash value
+    -----------------------------------------------------------------F-F*/
+    UINT64 HashBytes(_In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize, _In_ UINT64 ullSeed)
+    {
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        UINT64 ullHash = ullSeed;
+        for (SIZE_T i = 0u; i < uSize; ++i)
+        {
+            ullHash ^= pBytes[i];
+            ullHash *= FNV1A_PRIME;
+        }
+
+        return ullHash;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: HashString
+
+      Summary:  64-bit FNV-1a hash of the characters of a string
+
+      Args:     const std::string& szString
+                  String to hash
+                UINT64 ullSeed
+                  Starting value of the hash
+
+      Returns:  UINT64
+                  Hash value
+    -----------------------------------------------------------------F-F*/
+    UINT64 HashString(_In_ const std::string& szString, _In_ UINT64 ullSeed)
+    {
+        return HashBytes(szString.data(), szString.size(), ullSeed);
+    }
+}
@@ -0,0 +1,22 @@
+/*+===================================================================
+  File:      HASH.H
+
+  Summary:   Hash header file contains declarations of the hash
+             functions used to key cooked data on disk.
+
+  Functions: HashBytes, HashString
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    constexpr const UINT64 FNV1A_OFFSET_BASIS = 0xCBF29CE484222325ull;
+    constexpr const UINT64 FNV1A_PRIME = 0x00000100000001B3ull;
+
+    UINT64 HashBytes(_In_reads_bytes_(uSize) const void* pData, _In_ SIZE_T uSize, _In_ UINT64 ullSeed = FNV1A_OFFSET_BASIS);
+    UINT64 HashString(_In_ const std::string& szString, _In_ UINT64 ullSeed = FNV1A_OFFSET_BASIS);
+}
@@ -0,0 +1,263 @@
+#include "Utility/LoadGraph.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::LoadGraph
+
+      Summary:  Constructor
+
+      Modifies: [m_aTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    LoadGraph::LoadGraph()
+        : m_aTasks()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::AddTask
+
+      Summary:  Adds a task without dependencies
+
+      Args:     const std::wstring& szName
+                  Name reported to the progress callback
+                eLoadQueue queue
+                  WORKER for CPU work that does not touch the immediate
+                  context, DEVICE otherwise
+                std::function<HRESULT()> function
+                  Work of the task
+
+      Modifies: [m_aTasks].
+
+      Returns:  UINT
+                  Index of the task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT LoadGraph::AddTask(_In_ const std::wstring& szName, _In_ eLoadQueue queue, _In_ std::function<HRESULT()> function)
+    {
+        m_aTasks.push_back(
+            {
+                .szName = szName,
+                .Queue = queue,
+                .Function = std::move(function),
+                .aDependents = {},
+                .uNumDependencies = 0u,
+                .Result = S_OK,
+                .Milliseconds = 0.0f
+            }
+        );
+
+        return static_cast<UINT>(m_aTasks.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::AddDependency
+
+      Summary:  Makes a task wait for another. The dependency has to be
+                added before the task, so the graph cannot have cycles
+
+      Args:     UINT uTask
+                  Task that waits
+                UINT uDependency
+                  Task it waits for
+
+      Modifies: [m_aTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void LoadGraph::AddDependency(_In_ UINT uTask, _In_ UINT uDependency)
+    {
+        assert(uDependency < uTask && uTask < m_aTasks.size());
+
+        m_aTasks[uDependency].aDependents.push_back(uTask);
+        ++m_aTasks[uTask].uNumDependencies;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::Run
+
+      Summary:  Runs every task once its dependencies are done. The
+                calling thread runs the DEVICE tasks and reports the
+                progress, so the callback needs no synchronization.
+                After a failure the remaining tasks are skipped
+
+      Args:     ThreadPool* pThreadPool
+                  Pool running the WORKER tasks, nullptr runs them on
+                  the calling thread as well
+                const ProgressCallback& progressCallback
+                  Called after every task, may be empty
+
+      Modifies: [m_aTasks].
+
+      Returns:  HRESULT
+                  Result of the first task that failed, S_OK otherwise
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT LoadGraph::Run(_In_opt_ ThreadPool* pThreadPool, _In_opt_ const ProgressCallback& progressCallback)
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<UINT> deviceQueue;
+        std::deque<UINT> finished;
+        HRESULT hrFirstFailure = S_OK;
+
+        std::vector<UINT> aNumPending(m_aTasks.size());
+        for (UINT i = 0u; i < m_aTasks.size(); ++i)
+        {
+            aNumPending[i] = m_aTasks[i].uNumDependencies;
+        }
+
+        // Called on this thread only. Once a task failed, everything left
+        // goes through the device queue, where it is skipped
+        auto dispatch = [&](UINT uTask)
+        {
+            if (m_aTasks[uTask].Queue == eLoadQueue::WORKER && pThreadPool && SUCCEEDED(hrFirstFailure))
+            {
+                pThreadPool->Submit([&, uTask]()
+                    {
+                        runTask(m_aTasks[uTask]);
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            finished.push_back(uTask);
+                        }
+                        condition.notify_one();
+                    }
+                );
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            deviceQueue.push_back(uTask);
+        };
+
+        for (UINT i = 0u; i < m_aTasks.size(); ++i)
+        {
+            if (aNumPending[i] == 0u)
+            {
+                dispatch(i);
+            }
+        }
+
+        for (UINT uNumDone = 0u; uNumDone < m_aTasks.size(); ++uNumDone)
+        {
+            UINT uTask = 0u;
+            BOOL bRunHere = FALSE;
+            {
+                // Finished tasks come first, they may unlock more workers
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return !finished.empty() || !deviceQueue.empty(); });
+                if (!finished.empty())
+                {
+                    uTask = finished.front();
+                    finished.pop_front();
+                }
+                else
+                {
+                    uTask = deviceQueue.front();
+                    deviceQueue.pop_front();
+                    bRunHere = TRUE;
+                }
+            }
+
+            Task& task = m_aTasks[uTask];
+            if (bRunHere)
+            {
+                if (SUCCEEDED(hrFirstFailure))
+                {
+                    runTask(task);
+                }
+                else
+                {
+                    task.Result = E_ABORT;
+                }
+            }
+
+            if (FAILED(task.Result) && SUCCEEDED(hrFirstFailure))
+            {
+                hrFirstFailure = task.Result;
+
+                WCHAR szMessage[256];
+                swprintf_s(szMessage, L"Loading %s failed with 0x%08X\n", task.szName.c_str(), static_cast<UINT>(task.Result));
+                OutputDebugString(szMessage);
+            }
+
+            if (progressCallback)
+            {
+                progressCallback(uNumDone + 1u, static_cast<UINT>(m_aTasks.size()), task.szName.c_str());
+            }
+
+            for (UINT uDependent : task.aDependents)
+            {
+                if (--aNumPending[uDependent] == 0u)
+                {
+                    dispatch(uDependent);
+                }
+            }
+        }
+
+        return hrFirstFailure;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::GetNumTasks
+
+      Summary:  Returns the number of tasks
+
+      Returns:  UINT
+                  Number of tasks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT LoadGraph::GetNumTasks() const
+    {
+        return static_cast<UINT>(m_aTasks.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::GetQueueMilliseconds
+
+      Summary:  Returns the time the tasks of a queue took in the last
+                Run, summed over all threads
+
+      Args:     eLoadQueue queue
+                  Queue to sum
+
+      Returns:  FLOAT
+                  Total milliseconds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT LoadGraph::GetQueueMilliseconds(_In_ eLoadQueue queue) const
+    {
+        FLOAT milliseconds = 0.0f;
+        for (const Task& task : m_aTasks)
+        {
+            if (task.Queue == queue)
+            {
+                milliseconds += task.Milliseconds;
+            }
+        }
+
+        return milliseconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   LoadGraph::runTask
+
+      Summary:  Runs a task and records its result and duration
+
+      Args:     Task& task
+                  Task to run
+
+      Modifies: [task].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void LoadGraph::runTask(_Inout_ Task& task)
+    {
+        LARGE_INTEGER startingTime = {};
+        LARGE_INTEGER endingTime = {};
+        LARGE_INTEGER frequency = {};
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        task.Result = task.Function();
+
+        QueryPerformanceCounter(&endingTime);
+        task.Milliseconds = static_cast<FLOAT>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0f / static_cast<FLOAT>(frequency.QuadPart);
+    }
+}
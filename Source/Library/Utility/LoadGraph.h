@@ -0,0 +1,92 @@
+/*+===================================================================
+  File:      LOADGRAPH.H
+
+  Summary:   LoadGraph header file contains declarations of the
+             LoadGraph class that runs the loading steps of a scene as
+             a dependency graph, CPU heavy steps on a thread pool and
+             the steps creating device objects one at a time on the
+             calling thread.
+
+  Classes: LoadGraph
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Utility/ThreadPool.h"
+
+#include <functional>
+
+namespace library
+{
+    enum class eLoadQueue : UINT
+    {
+        WORKER = 0,
+        DEVICE,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    LoadGraph
+
+      Summary:  Set of loading tasks with dependencies. A task starts
+                once all of its dependencies are done. WORKER tasks run
+                on the thread pool, DEVICE tasks run in order on the
+                thread calling Run, which is the only one touching the
+                immediate context
+
+      Methods:  AddTask
+                  Adds a task and returns its index
+                AddDependency
+                  Makes a task wait for an earlier one
+                Run
+                  Runs every task and returns the first failure
+                GetNumTasks
+                  Returns the number of tasks
+                GetQueueMilliseconds
+                  Returns the time the tasks of a queue took in total
+                LoadGraph
+                  Constructor.
+                ~LoadGraph
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class LoadGraph final
+    {
+    public:
+        using ProgressCallback = std::function<void(UINT uNumDone, UINT uNumTasks, PCWSTR pszTaskName)>;
+
+        LoadGraph();
+        LoadGraph(const LoadGraph& other) = delete;
+        LoadGraph(LoadGraph&& other) = delete;
+        LoadGraph& operator=(const LoadGraph& other) = delete;
+        LoadGraph& operator=(LoadGraph&& other) = delete;
+        ~LoadGraph() = default;
+
+        UINT AddTask(_In_ const std::wstring& szName, _In_ eLoadQueue queue, _In_ std::function<HRESULT()> function);
+        void AddDependency(_In_ UINT uTask, _In_ UINT uDependency);
+
+        HRESULT Run(_In_opt_ ThreadPool* pThreadPool, _In_opt_ const ProgressCallback& progressCallback);
+
+        UINT GetNumTasks() const;
+        FLOAT GetQueueMilliseconds(_In_ eLoadQueue queue) const;
+
+    private:
+        struct Task
+        {
+            std::wstring szName;
+            eLoadQueue Queue;
+            std::function<HRESULT()> Function;
+            std::vector<UINT> aDependents;
+            UINT uNumDependencies;
+            HRESULT Result;
+            FLOAT Milliseconds;
+        };
+
+        static void runTask(_Inout_ Task& task);
+
+    private:
+        std::vector<Task> m_aTasks;
+    };
+}
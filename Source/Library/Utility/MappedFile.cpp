@@ -0,0 +1,349 @@
+#include "Utility/MappedFile.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace library
+{
+#ifndef _WIN32
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: hresultFromErrno
+
+          Summary:  Returns the status code Windows gives for the same
+                    failure, so callers compare against one set of codes
+
+          Args:     INT iError
+                      Value of errno
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT hresultFromErrno(_In_ INT iError)
+        {
+            switch (iError)
+            {
+            case ENOENT:
+                return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+            case ENOTDIR:
+                return HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND);
+            case EACCES:
+            case EPERM:
+                return HRESULT_FROM_WIN32(ERROR_ACCESS_DENIED);
+            case ENOMEM:
+                return E_OUTOFMEMORY;
+            default:
+                return E_FAIL;
+            }
+        }
+    }
+
+#endif
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::MappedFile
+
+      Summary:  Constructor
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_pData, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MappedFile::MappedFile()
+#ifdef _WIN32
+        : m_hFile(INVALID_HANDLE_VALUE)
+        , m_hMapping(nullptr)
+#else
+        : m_iFile(-1)
+        , m_uViewSize(0u)
+#endif
+        , m_pView(nullptr)
+        , m_pData(nullptr)
+        , m_uSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::~MappedFile
+
+      Summary:  Destructor. Unmaps the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::Open
+
+      Summary:  Maps the whole file read-only. Any previously mapped file
+                is closed first
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_pData, m_uSize].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MappedFile::Open(_In_ const std::filesystem::path& filePath)
+    {
+        return Open(filePath, 0ull, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::Open
+
+      Summary:  Maps a range of a file read-only, so one file can hold
+                several blobs mapped on their own. The view starts at
+                the allocation granularity below the offset, GetData
+                points at the offset. Any previously mapped file is
+                closed first
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+                UINT64 ullOffset
+                  Offset of the range in bytes
+                SIZE_T uSize
+                  Size of the range in bytes, 0 for the rest of the file
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_pData, m_uSize].
+
+      Returns:  HRESULT
+                  Status code, HRESULT_FROM_WIN32(ERROR_HANDLE_EOF) if
+                  the range is empty or past the end of the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MappedFile::Open(_In_ const std::filesystem::path& filePath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize)
+    {
+        Close();
+
+#ifdef _WIN32
+        m_hFile = CreateFile(
+            filePath.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize))
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        UINT64 ullFileSize = static_cast<UINT64>(fileSize.QuadPart);
+        if (uSize == 0u && ullOffset < ullFileSize)
+        {
+            uSize = static_cast<SIZE_T>(ullFileSize - ullOffset);
+        }
+        if (uSize == 0u || ullOffset > ullFileSize || uSize > ullFileSize - ullOffset)
+        {
+            // Empty files and ranges cannot be mapped
+            Close();
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        m_hMapping = CreateFileMapping(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        SYSTEM_INFO systemInfo = {};
+        GetSystemInfo(&systemInfo);
+        UINT64 ullViewOffset = ullOffset - ullOffset % systemInfo.dwAllocationGranularity;
+        SIZE_T uViewSize = static_cast<SIZE_T>(ullOffset - ullViewOffset) + uSize;
+
+        m_pView = static_cast<const BYTE*>(MapViewOfFile(
+            m_hMapping,
+            FILE_MAP_READ,
+            static_cast<DWORD>(ullViewOffset >> 32ull),
+            static_cast<DWORD>(ullViewOffset & 0xFFFFFFFFull),
+            uViewSize
+        ));
+        if (!m_pView)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pData = m_pView + (ullOffset - ullViewOffset);
+        m_uSize = uSize;
+
+        return S_OK;
+#else
+        m_iFile = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_iFile < 0)
+        {
+            return hresultFromErrno(errno);
+        }
+
+        struct stat fileStatus = {};
+        if (fstat(m_iFile, &fileStatus) != 0)
+        {
+            HRESULT hr = hresultFromErrno(errno);
+            Close();
+            return hr;
+        }
+
+        UINT64 ullFileSize = static_cast<UINT64>(fileStatus.st_size);
+        if (uSize == 0u && ullOffset < ullFileSize)
+        {
+            uSize = static_cast<SIZE_T>(ullFileSize - ullOffset);
+        }
+        if (uSize == 0u || ullOffset > ullFileSize || uSize > ullFileSize - ullOffset)
+        {
+            // Empty files and ranges cannot be mapped
+            Close();
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        UINT64 ullPageSize = static_cast<UINT64>(sysconf(_SC_PAGESIZE));
+        UINT64 ullViewOffset = ullOffset - ullOffset % ullPageSize;
+        SIZE_T uViewSize = static_cast<SIZE_T>(ullOffset - ullViewOffset) + uSize;
+
+        void* pView = mmap(nullptr, uViewSize, PROT_READ, MAP_PRIVATE, m_iFile, static_cast<off_t>(ullViewOffset));
+        if (pView == MAP_FAILED)
+        {
+            HRESULT hr = hresultFromErrno(errno);
+            Close();
+            return hr;
+        }
+
+        m_pView = static_cast<const BYTE*>(pView);
+        m_uViewSize = uViewSize;
+        m_pData = m_pView + (ullOffset - ullViewOffset);
+        m_uSize = uSize;
+
+        return S_OK;
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::Close
+
+      Summary:  Unmaps the view and closes the handles
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_pData, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MappedFile::Close()
+    {
+#ifdef _WIN32
+        if (m_pView)
+        {
+            UnmapViewOfFile(m_pView);
+            m_pView = nullptr;
+        }
+        m_pData = nullptr;
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_pView)
+        {
+            munmap(const_cast<BYTE*>(m_pView), m_uViewSize);
+            m_pView = nullptr;
+            m_uViewSize = 0u;
+        }
+        m_pData = nullptr;
+
+        if (m_iFile >= 0)
+        {
+            close(m_iFile);
+            m_iFile = -1;
+        }
+#endif
+
+        m_uSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::Prefetch
+
+      Summary:  Asks the system to read the whole view in the background,
+                so that the first touch of each page does not wait on
+                the disk. Only a hint, failures are ignored
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MappedFile::Prefetch() const
+    {
+        if (!m_pData)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        WIN32_MEMORY_RANGE_ENTRY range =
+        {
+            .VirtualAddress = const_cast<BYTE*>(m_pData),
+            .NumberOfBytes = m_uSize
+        };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1u, &range, 0u);
+#else
+        madvise(const_cast<BYTE*>(m_pView), m_uViewSize, MADV_WILLNEED);
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::IsOpen
+
+      Summary:  Returns whether a file is mapped
+
+      Returns:  BOOL
+                  TRUE if a file is mapped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MappedFile::IsOpen() const
+    {
+        return m_pData != nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::GetData
+
+      Summary:  Returns the first byte of the view
+
+      Returns:  const BYTE*
+                  Mapped data, nullptr if no file is mapped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BYTE* MappedFile::GetData() const
+    {
+        return m_pData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::GetSize
+
+      Summary:  Returns the size of the mapped file or range
+
+      Returns:  SIZE_T
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SIZE_T MappedFile::GetSize() const
+    {
+        return m_uSize;
+    }
+}
@@ -0,0 +1,73 @@
+/*+===================================================================
+  File:      MAPPEDFILE.H
+
+  Summary:   MappedFile header file contains declarations of the
+             MappedFile class, a read-only memory mapped view of a
+             whole file or of a range of it. Maps with the Win32 file
+             mapping functions on Windows and with mmap elsewhere.
+
+  Classes: MappedFile
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MappedFile
+
+      Summary:  Owns the file, mapping and view handles of a read-only
+                memory mapped file and releases them on destruction
+
+      Methods:  Open
+                  Maps the given file, or a range of it
+                Close
+                  Unmaps the file
+                Prefetch
+                  Starts reading the whole view into memory
+                IsOpen
+                  Returns whether a file is mapped
+                GetData
+                  Returns the first byte of the view
+                GetSize
+                  Returns the size of the file in bytes
+                MappedFile
+                  Constructor.
+                ~MappedFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MappedFile final
+    {
+    public:
+        MappedFile();
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile(MappedFile&& other) = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+        MappedFile& operator=(MappedFile&& other) = delete;
+        ~MappedFile();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        HRESULT Open(_In_ const std::filesystem::path& filePath, _In_ UINT64 ullOffset, _In_ SIZE_T uSize);
+        void Close();
+        void Prefetch() const;
+
+        BOOL IsOpen() const;
+        const BYTE* GetData() const;
+        SIZE_T GetSize() const;
+
+    private:
+#ifdef _WIN32
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+#else
+        INT m_iFile;
+        SIZE_T m_uViewSize;
+#endif
+        const BYTE* m_pView;
+        const BYTE* m_pData;
+        SIZE_T m_uSize;
+    };
+}
@@ -0,0 +1,211 @@
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetDefault
+
+      Summary:  Returns the pool shared by the library, created on first
+                use with one worker less than the hardware threads since
+                the calling thread takes part in ParallelFor
+
+      Returns:  ThreadPool&
+                  Shared thread pool
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool& ThreadPool::GetDefault()
+    {
+        static ThreadPool s_threadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1u);
+        return s_threadPool;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ThreadPool
+
+      Summary:  Constructor
+
+      Args:     UINT uNumWorkers
+                  Number of worker threads to spawn
+
+      Modifies: [m_aWorkers, m_tasks, m_mutex, m_condition, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::ThreadPool(_In_ UINT uNumWorkers)
+        : m_aWorkers()
+        , m_tasks()
+        , m_mutex()
+        , m_condition()
+        , m_bStopping(FALSE)
+    {
+        m_aWorkers.reserve(uNumWorkers);
+        for (UINT i = 0u; i < uNumWorkers; ++i)
+        {
+            m_aWorkers.emplace_back(&ThreadPool::workerMain, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::~ThreadPool
+
+      Summary:  Destructor. Lets the workers drain the queue and joins
+                them
+
+      Modifies: [m_aWorkers, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStopping = TRUE;
+        }
+        m_condition.notify_all();
+
+        for (std::thread& worker : m_aWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::Submit
+
+      Summary:  Queues a task to be run on a worker thread. Runs it on
+                the calling thread when the pool has no worker
+
+      Args:     std::function<void()> task
+                  Task to run
+
+      Modifies: [m_tasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::Submit(_In_ std::function<void()> task)
+    {
+        if (m_aWorkers.empty())
+        {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_condition.notify_one();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ParallelFor
+
+      Summary:  Splits [0, uCount) into chunks of uGrainSize elements and
+                processes them on the workers and the calling thread.
+                Chunks are claimed from a shared counter, so calling it
+                from a worker thread cannot dead lock
+
+      Args:     UINT uCount
+                  Number of elements
+                UINT uGrainSize
+                  Number of elements per chunk
+                const std::function<void(UINT, UINT)>& function
+                  Called once per chunk with its [begin, end) range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::ParallelFor(_In_ UINT uCount, _In_ UINT uGrainSize, _In_ const std::function<void(UINT uBegin, UINT uEnd)>& function)
+    {
+        if (uCount == 0u)
+        {
+            return;
+        }
+
+        uGrainSize = std::max(uGrainSize, 1u);
+        UINT uNumChunks = (uCount + uGrainSize - 1u) / uGrainSize;
+        if (uNumChunks == 1u || m_aWorkers.empty())
+        {
+            function(0u, uCount);
+            return;
+        }
+
+        struct SharedState
+        {
+            std::atomic<UINT> uNextChunk;
+            std::atomic<UINT> uNumDone;
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+        std::shared_ptr<SharedState> pState = std::make_shared<SharedState>();
+        pState->uNextChunk = 0u;
+        pState->uNumDone = 0u;
+
+        auto runChunks = [pState, uCount, uGrainSize, uNumChunks, &function]()
+        {
+            for (UINT uChunk = pState->uNextChunk++; uChunk < uNumChunks; uChunk = pState->uNextChunk++)
+            {
+                UINT uBegin = uChunk * uGrainSize;
+                function(uBegin, std::min(uBegin + uGrainSize, uCount));
+                if (++pState->uNumDone == uNumChunks)
+                {
+                    std::lock_guard<std::mutex> lock(pState->mutex);
+                    pState->condition.notify_all();
+                }
+            }
+        };
+
+        UINT uNumHelpers = std::min(static_cast<UINT>(m_aWorkers.size()), uNumChunks - 1u);
+        for (UINT i = 0u; i < uNumHelpers; ++i)
+        {
+            // Helpers that start after every chunk was claimed return
+            // right away, so they never touch function after we return
+            Submit([pState, uNumChunks, runChunks]()
+                {
+                    if (pState->uNextChunk.load() < uNumChunks)
+                    {
+                        runChunks();
+                    }
+                }
+            );
+        }
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(pState->mutex);
+        pState->condition.wait(lock, [&pState, uNumChunks]() { return pState->uNumDone.load() == uNumChunks; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetNumThreads
+
+      Summary:  Returns the number of threads taking part in ParallelFor
+
+      Returns:  UINT
+                  Number of workers plus the calling thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ThreadPool::GetNumThreads() const
+    {
+        return static_cast<UINT>(m_aWorkers.size()) + 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::workerMain
+
+      Summary:  Worker loop, runs queued tasks until the pool stops
+
+      Modifies: [m_tasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::workerMain()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_bStopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+}
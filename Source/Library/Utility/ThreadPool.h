@@ -0,0 +1,72 @@
+/*+===================================================================
+  File:      THREADPOOL.H
+
+  Summary:   ThreadPool header file contains declarations of the
+             ThreadPool class used to run CPU heavy work of the
+             library on worker threads.
+
+  Classes: ThreadPool
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ThreadPool
+
+      Summary:  Fixed set of worker threads executing queued tasks
+
+      Methods:  GetDefault
+                  Returns the pool shared by the library
+                Submit
+                  Queues a task to be run on a worker thread
+                ParallelFor
+                  Splits a range into chunks and processes them on the
+                  workers and the calling thread, returns when done
+                GetNumThreads
+                  Returns the number of threads that can take part in
+                  a ParallelFor, including the caller
+                ThreadPool
+                  Constructor.
+                ~ThreadPool
+                  Destructor. Finishes queued tasks and joins workers
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ThreadPool final
+    {
+    public:
+        static ThreadPool& GetDefault();
+
+        ThreadPool() = delete;
+        ThreadPool(_In_ UINT uNumWorkers);
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) = delete;
+        ~ThreadPool();
+
+        void Submit(_In_ std::function<void()> task);
+        void ParallelFor(_In_ UINT uCount, _In_ UINT uGrainSize, _In_ const std::function<void(UINT uBegin, UINT uEnd)>& function);
+
+        UINT GetNumThreads() const;
+
+    private:
+        void workerMain();
+
+    private:
+        std::vector<std::thread> m_aWorkers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        BOOL m_bStopping;
+    };
+}
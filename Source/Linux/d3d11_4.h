@@ -0,0 +1,13 @@
+/*+===================================================================
+  File:      D3D11_4.H
+
+  Summary:   Stand-in so that Common.h compiles on Linux. Direct3D 11
+             is not available there, the files that use it are left
+             out of the Linux build. Only DXGI_FORMAT, which the CPU
+             side texture code uses, comes from DirectX-Headers.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <dxgiformat.h>
@@ -0,0 +1,10 @@
+/*+===================================================================
+  File:      D3DCOMPILER.H
+
+  Summary:   Empty stand-in so that Common.h compiles on Linux.
+             The D3D shader compiler is not available there, the
+             files that use it are left out of the Linux build.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
@@ -0,0 +1,11 @@
+/*+===================================================================
+  File:      DIRECTXCOLORS.H
+
+  Summary:   Lower case alias of DirectXMath's DirectXColors.h, the
+             Linux file system is case sensitive.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <DirectXColors.h>
@@ -0,0 +1,254 @@
+/*+===================================================================
+  File:      WINDOWS.H
+
+  Summary:   Stand-in for the Windows header when the platform
+             independent parts of the library are built on Linux. The
+             Windows types and status codes come from the WSL adapter
+             of DirectX-Headers, this adds the few annotations, CRT
+             and kernel32 functions the library uses on top of them.
+
+  Functions: OutputDebugStringW, swprintf_s, QueryPerformanceCounter,
+             QueryPerformanceFrequency, GetCurrentThreadId
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <wsl/winadapter.h>
+
+#if __has_include(<sal.h>)
+#include <sal.h>
+#endif
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <string>
+
+#include <unistd.h>
+
+// Windows widths, the same types winadapter uses where it has them
+typedef double DOUBLE;
+typedef uint16_t USHORT;
+typedef const char* PCSTR;
+
+#ifndef _In_
+#define _In_
+#endif
+#ifndef _In_z_
+#define _In_z_
+#endif
+#ifndef _In_opt_
+#define _In_opt_
+#endif
+#ifndef _In_opt_z_
+#define _In_opt_z_
+#endif
+#ifndef _Out_
+#define _Out_
+#endif
+#ifndef _Out_opt_
+#define _Out_opt_
+#endif
+#ifndef _Inout_
+#define _Inout_
+#endif
+#ifndef _In_reads_
+#define _In_reads_(size)
+#endif
+#ifndef _In_reads_opt_
+#define _In_reads_opt_(size)
+#endif
+#ifndef _In_reads_bytes_
+#define _In_reads_bytes_(size)
+#endif
+#ifndef _Out_writes_
+#define _Out_writes_(size)
+#endif
+#ifndef _Out_writes_bytes_
+#define _Out_writes_bytes_(size)
+#endif
+#ifndef _Inout_updates_
+#define _Inout_updates_(size)
+#endif
+#ifndef _Inout_updates_bytes_
+#define _Inout_updates_bytes_(size)
+#endif
+#ifndef _Use_decl_annotations_
+#define _Use_decl_annotations_
+#endif
+#ifndef _Analysis_assume_
+#define _Analysis_assume_(expression)
+#endif
+
+// Win32 error codes the library returns through HRESULT_FROM_WIN32
+#ifndef ERROR_FILE_NOT_FOUND
+#define ERROR_FILE_NOT_FOUND 2L
+#endif
+#ifndef ERROR_PATH_NOT_FOUND
+#define ERROR_PATH_NOT_FOUND 3L
+#endif
+#ifndef ERROR_ACCESS_DENIED
+#define ERROR_ACCESS_DENIED 5L
+#endif
+#ifndef ERROR_INVALID_DATA
+#define ERROR_INVALID_DATA 13L
+#endif
+#ifndef ERROR_WRITE_FAULT
+#define ERROR_WRITE_FAULT 29L
+#endif
+#ifndef ERROR_HANDLE_EOF
+#define ERROR_HANDLE_EOF 38L
+#endif
+#ifndef ERROR_NOT_SUPPORTED
+#define ERROR_NOT_SUPPORTED 50L
+#endif
+#ifndef ERROR_CANNOT_MAKE
+#define ERROR_CANNOT_MAKE 82L
+#endif
+#ifndef ERROR_ARITHMETIC_OVERFLOW
+#define ERROR_ARITHMETIC_OVERFLOW 534L
+#endif
+#ifndef ERROR_FILE_INVALID
+#define ERROR_FILE_INVALID 1006L
+#endif
+#ifndef HRESULT_FROM_WIN32
+#define HRESULT_FROM_WIN32(x) ((HRESULT)(x) <= 0 ? (HRESULT)(x) : (HRESULT)(((x) & 0x0000FFFF) | (7 << 16) | 0x80000000))
+#endif
+
+#ifndef ARRAYSIZE
+#define ARRAYSIZE(A) (sizeof(A) / sizeof((A)[0]))
+#endif
+#ifndef UNREFERENCED_PARAMETER
+#define UNREFERENCED_PARAMETER(P) (void)(P)
+#endif
+#ifndef ZeroMemory
+#define ZeroMemory(Destination, Length) std::memset((Destination), 0, (Length))
+#endif
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: OutputDebugStringW
+
+  Summary:  Writes the message to the standard error, there is no
+            debugger output to send it to. Characters outside ASCII
+            are replaced, the message is narrowed so stderr keeps its
+            byte orientation
+
+  Args:     LPCWSTR pszMessage
+              Message to write
+-----------------------------------------------------------------F-F*/
+inline void OutputDebugStringW(_In_ LPCWSTR pszMessage)
+{
+    for (; *pszMessage; ++pszMessage)
+    {
+        std::fputc(*pszMessage < 0x80 ? static_cast<char>(*pszMessage) : '?', stderr);
+    }
+}
+#define OutputDebugString OutputDebugStringW
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: swprintf_s
+
+  Summary:  Formats into a wide buffer like the CRT function. The CRT
+            reads %s and %c of a wide format as wide arguments, glibc
+            as narrow ones, so they get an l before being passed on
+
+  Args:     WCHAR (&szBuffer)[N]
+              Receives the message
+            LPCWSTR pszFormat
+              Format of the message, followed by its arguments
+
+  Returns:  int
+              Number of characters written, -1 on failure
+-----------------------------------------------------------------F-F*/
+template <size_t N>
+int swprintf_s(_Out_writes_(N) WCHAR (&szBuffer)[N], _In_z_ LPCWSTR pszFormat, ...)
+{
+    std::wstring szFormat;
+    for (LPCWSTR pszChar = pszFormat; *pszChar; ++pszChar)
+    {
+        szFormat += *pszChar;
+        if (*pszChar != L'%')
+        {
+            continue;
+        }
+
+        // Flags, width and precision up to the conversion
+        while (pszChar[1] && std::wcschr(L"-+ #0123456789.*", pszChar[1]))
+        {
+            szFormat += *++pszChar;
+        }
+        if (pszChar[1] == L's' || pszChar[1] == L'c')
+        {
+            szFormat += L'l';
+        }
+        if (pszChar[1])
+        {
+            szFormat += *++pszChar;
+        }
+    }
+
+    va_list args;
+    va_start(args, pszFormat);
+    int iResult = std::vswprintf(szBuffer, N, szFormat.c_str(), args);
+    va_end(args);
+    if (iResult < 0)
+    {
+        szBuffer[0] = L'\0';
+    }
+
+    return iResult;
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: QueryPerformanceCounter
+
+  Summary:  Reads the steady clock in nanoseconds
+
+  Args:     LARGE_INTEGER* pPerformanceCount
+              Receives the current count
+
+  Returns:  BOOL
+              TRUE
+-----------------------------------------------------------------F-F*/
+inline BOOL QueryPerformanceCounter(_Out_ LARGE_INTEGER* pPerformanceCount)
+{
+    pPerformanceCount->QuadPart = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+
+    return TRUE;
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: QueryPerformanceFrequency
+
+  Summary:  Returns the counts per second of QueryPerformanceCounter
+
+  Args:     LARGE_INTEGER* pFrequency
+              Receives the frequency
+
+  Returns:  BOOL
+              TRUE
+-----------------------------------------------------------------F-F*/
+inline BOOL QueryPerformanceFrequency(_Out_ LARGE_INTEGER* pFrequency)
+{
+    pFrequency->QuadPart = 1000000000;
+
+    return TRUE;
+}
+
+/*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+  Function: GetCurrentThreadId
+
+  Summary:  Returns the id the kernel gives the calling thread
+
+  Returns:  DWORD
+              Thread id, unique among the running threads
+-----------------------------------------------------------------F-F*/
+inline DWORD GetCurrentThreadId()
+{
+    return static_cast<DWORD>(gettid());
+}
@@ -0,0 +1,18 @@
+/*+===================================================================
+  File:      WRL.H
+
+  Summary:   Stand-in for the WRL header on Linux. Brings in the ComPtr
+             of DirectX-Headers when it has one, Common.h only needs
+             the namespace to exist.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#if __has_include(<wsl/wrladapter.h>)
+#include <wsl/wrladapter.h>
+#endif
+
+namespace Microsoft::WRL
+{
+}
@@ -0,0 +1,199 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Command line tool that compiles the shaders listed in
+             manifests into the shader cache next to their source, so
+             the game loads their bytecode instead of compiling HLSL
+
+  Usage:     ShaderCooker [--force] <manifest>...
+
+             Every line of a manifest names a shader file, relative to
+             the manifest, its entry point, its target and the macros
+             it is compiled with:
+               VoxelShaders.fxh PSVoxel ps_5_0 [FEATURE]... [NAME=VALUE]...
+             FEATURE is the macro of a feature switch, e.g.
+             HAS_NORMAL_MAP, and selects the variant the library
+             compiles for it. Lines starting with # are comments
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "Shader/ShaderCache.h"
+#include "Shader/ShaderPermutation.h"
+
+namespace
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: readManifest
+
+      Summary:  Reads the shaders listed in a manifest. The macros of
+                a variant come first and in the order the library
+                passes them, so both hit the same cache entries
+
+      Args:     const std::filesystem::path& manifestPath
+                  Path to the manifest
+                std::vector<library::ShaderCompileDesc>& aDescs
+                  Receives the shaders, appended
+
+      Returns:  BOOL
+                  TRUE if every line could be read
+    -----------------------------------------------------------------F-F*/
+    BOOL readManifest(_In_ const std::filesystem::path& manifestPath, _Inout_ std::vector<library::ShaderCompileDesc>& aDescs)
+    {
+        std::ifstream manifestFile(manifestPath);
+        if (!manifestFile.is_open())
+        {
+            wprintf(L"%s: can't be read\n", manifestPath.c_str());
+            return FALSE;
+        }
+
+        BOOL bValid = TRUE;
+        UINT uLine = 0u;
+        std::string szLine;
+        while (std::getline(manifestFile, szLine))
+        {
+            ++uLine;
+            std::istringstream lineStream(szLine);
+            std::string szFileName;
+            if (!(lineStream >> szFileName) || szFileName.starts_with('#'))
+            {
+                continue;
+            }
+
+            library::ShaderCompileDesc desc =
+            {
+                .FilePath = manifestPath.parent_path() / szFileName,
+                .szEntryPoint = std::string(),
+                .szTarget = std::string(),
+                .aDefines = std::vector<library::ShaderDefine>(),
+                .uFlags = library::GetDefaultShaderCompileFlags()
+            };
+            if (!(lineStream >> desc.szEntryPoint >> desc.szTarget))
+            {
+                wprintf(L"%s(%u): expected a file, an entry point and a target\n", manifestPath.c_str(), uLine);
+                bValid = FALSE;
+                continue;
+            }
+
+            UINT uVariantKey = 0u;
+            std::vector<library::ShaderDefine> aExtraDefines;
+            std::string szDefine;
+            while (lineStream >> szDefine)
+            {
+                SIZE_T uEquals = szDefine.find('=');
+                UINT uFeature = uEquals == std::string::npos ? library::GetShaderVariantKeyFromName(szDefine) : 0u;
+                if (uFeature != 0u)
+                {
+                    uVariantKey |= uFeature;
+                    continue;
+                }
+
+                aExtraDefines.push_back(
+                    {
+                        .szName = szDefine.substr(0u, uEquals),
+                        .szValue = uEquals == std::string::npos ? "1" : szDefine.substr(uEquals + 1u)
+                    }
+                );
+            }
+            desc.aDefines = library::GetShaderVariantDefines(uVariantKey);
+            desc.aDefines.insert(desc.aDefines.end(), aExtraDefines.begin(), aExtraDefines.end());
+            aDescs.push_back(std::move(desc));
+        }
+
+        return bValid;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printUsage
+
+      Summary:  Writes the command line usage to the console
+    -----------------------------------------------------------------F-F*/
+    void printUsage()
+    {
+        wprintf(
+            L"Usage: ShaderCooker [--force] <manifest>...\n"
+            L"  --force  Compile shaders whose cached bytecode is current\n"
+            L"  Every manifest line is: <file> <entry point> <target> [FEATURE]... [NAME=VALUE]...\n"
+        );
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+
+  Summary:  Entry point of the tool. Compiles every shader of the
+            manifests given, skipping the ones whose cached bytecode
+            is current
+
+  Args:     INT argc
+              Number of arguments
+            WCHAR* argv[]
+              Arguments
+
+  Returns:  INT
+              0 if every shader was compiled, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+    BOOL bForce = FALSE;
+    BOOL bValid = TRUE;
+    std::vector<library::ShaderCompileDesc> aDescs;
+
+    for (INT i = 1; i < argc; ++i)
+    {
+        std::wstring szArgument = argv[i];
+        if (szArgument == L"--force")
+        {
+            bForce = TRUE;
+        }
+        else if (szArgument.starts_with(L"--"))
+        {
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            bValid = readManifest(szArgument, aDescs) && bValid;
+        }
+    }
+
+    if (aDescs.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    library::ShaderCache& shaderCache = library::ShaderCache::GetDefault();
+    UINT uNumFailed = bValid ? 0u : 1u;
+    for (const library::ShaderCompileDesc& desc : aDescs)
+    {
+        std::vector<BYTE> aBytecode;
+        if (!bForce && shaderCache.Load(desc, aBytecode) == S_OK)
+        {
+            wprintf(L"%s %S %S: up to date\n", desc.FilePath.c_str(), desc.szEntryPoint.c_str(), desc.szTarget.c_str());
+            continue;
+        }
+
+        std::string szMessages;
+        HRESULT hr = shaderCache.Cook(desc, aBytecode, &szMessages);
+        if (FAILED(hr))
+        {
+            wprintf(L"%s %S %S: failed (0x%08X)\n%S", desc.FilePath.c_str(), desc.szEntryPoint.c_str(), desc.szTarget.c_str(), static_cast<UINT>(hr), szMessages.c_str());
+            ++uNumFailed;
+            continue;
+        }
+
+        wprintf(L"%s %S %S: %zu bytes\n", desc.FilePath.c_str(), desc.szEntryPoint.c_str(), desc.szTarget.c_str(), aBytecode.size());
+    }
+
+    library::ShaderCacheStats stats = shaderCache.GetStats();
+    wprintf(L"Compiled %u shaders in %.2f ms, %u up to date, %u failed\n", stats.uNumCompiled, stats.CompileMilliseconds, stats.uNumHits, uNumFailed);
+
+    return uNumFailed > 0u ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Runs the unit tests of the library
+
+  Usage:     Tests [name filter]
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include "TestFramework.h"
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Entry point of the tests. Runs every test, or the ones
+            whose name contains the first argument
+
+  Args:     INT argc
+              Number of arguments
+            CHAR* argv[]
+              Arguments
+
+  Returns:  INT
+              0 if every test passed, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT main(_In_ INT argc, _In_reads_(argc) CHAR* argv[])
+{
+    INT iNumFailed = library::test::RunTests(argc > 1 ? argv[1] : nullptr);
+
+    return iNumFailed == 0 ? 0 : 1;
+}
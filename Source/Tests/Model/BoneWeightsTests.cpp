@@ -0,0 +1,171 @@
+#include "TestFramework.h"
+
+#include "Model/BoneWeights.h"
+
+#include <cstddef>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        UINT sumWeights(_In_ const AnimationData& packed)
+        {
+            UINT uSum = 0u;
+            for (UINT i = 0u; i < NUM_BONE_INFLUENCES; ++i)
+            {
+                uSum += packed.aBoneWeights[i];
+            }
+            return uSum;
+        }
+    }
+
+    // Only the four strongest influences are kept, strongest first, and
+    // renormalized among themselves
+    TEST_CASE(PackBoneWeights_KeepsFourStrongestInfluences)
+    {
+        const UINT aBoneIds[] = { 7u, 3u, 12u, 200u, 5u, 9u };
+        const FLOAT aWeights[] = { 0.05f, 0.3f, 0.1f, 0.25f, 0.2f, 0.1f };
+
+        AnimationData packed = PackBoneWeights(aBoneIds, aWeights, 6u);
+
+        // Ties are broken by bone id, 9 beats 12
+        CHECK(packed.aBoneIndices[0] == 3u);
+        CHECK(packed.aBoneIndices[1] == 200u);
+        CHECK(packed.aBoneIndices[2] == 5u);
+        CHECK(packed.aBoneIndices[3] == 9u);
+
+        UINT aUnpackedIds[NUM_BONE_INFLUENCES];
+        FLOAT aUnpackedWeights[NUM_BONE_INFLUENCES];
+        UnpackBoneWeights(packed, aUnpackedIds, aUnpackedWeights);
+
+        const FLOAT kept = 0.3f + 0.25f + 0.2f + 0.1f;
+        CHECK_NEAR(aUnpackedWeights[0], 0.3f / kept, 2.0 / PACKED_BONE_WEIGHT_ONE);
+        CHECK_NEAR(aUnpackedWeights[1], 0.25f / kept, 1.0 / PACKED_BONE_WEIGHT_ONE);
+        CHECK_NEAR(aUnpackedWeights[2], 0.2f / kept, 1.0 / PACKED_BONE_WEIGHT_ONE);
+        CHECK_NEAR(aUnpackedWeights[3], 0.1f / kept, 1.0 / PACKED_BONE_WEIGHT_ONE);
+        CHECK(sumWeights(packed) == PACKED_BONE_WEIGHT_ONE);
+    }
+
+    // Influences past MAX_NUM_BONES_PER_VERTEX are ignored
+    TEST_CASE(PackBoneWeights_ClampsInfluenceCount)
+    {
+        UINT aBoneIds[MAX_NUM_BONES_PER_VERTEX + 4u];
+        FLOAT aWeights[MAX_NUM_BONES_PER_VERTEX + 4u];
+        for (UINT i = 0u; i < MAX_NUM_BONES_PER_VERTEX + 4u; ++i)
+        {
+            aBoneIds[i] = i;
+            aWeights[i] = i < MAX_NUM_BONES_PER_VERTEX ? 0.01f : 1.0f;
+        }
+
+        AnimationData packed = PackBoneWeights(aBoneIds, aWeights, MAX_NUM_BONES_PER_VERTEX + 4u);
+
+        for (UINT i = 0u; i < NUM_BONE_INFLUENCES; ++i)
+        {
+            CHECK(packed.aBoneIndices[i] == i);
+        }
+        CHECK(sumWeights(packed) == PACKED_BONE_WEIGHT_ONE);
+    }
+
+    // Fewer than four influences leave the remaining slots empty
+    TEST_CASE(PackBoneWeights_PadsMissingInfluences)
+    {
+        const UINT aBoneIds[] = { 42u, 17u };
+        const FLOAT aWeights[] = { 0.5f, 1.5f };
+
+        AnimationData packed = PackBoneWeights(aBoneIds, aWeights, 2u);
+
+        CHECK(packed.aBoneIndices[0] == 17u);
+        CHECK(packed.aBoneIndices[1] == 42u);
+        CHECK(packed.aBoneIndices[2] == 0u && packed.aBoneWeights[2] == 0u);
+        CHECK(packed.aBoneIndices[3] == 0u && packed.aBoneWeights[3] == 0u);
+        CHECK_NEAR(packed.aBoneWeights[0], 0.75 * PACKED_BONE_WEIGHT_ONE, 1.0);
+        CHECK(sumWeights(packed) == PACKED_BONE_WEIGHT_ONE);
+    }
+
+    // A vertex without weight stays all zero, the shaders skip it
+    TEST_CASE(PackBoneWeights_ZeroTotalWeight)
+    {
+        const UINT aBoneIds[] = { 1u, 2u, 3u, 4u, 5u };
+        const FLOAT aZeroWeights[] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        const FLOAT aNegativeWeights[] = { -0.5f, 0.0f, -1.0f, 0.0f, 0.0f };
+
+        for (const FLOAT* aWeights : { aZeroWeights, aNegativeWeights })
+        {
+            AnimationData packed = PackBoneWeights(aBoneIds, aWeights, 5u);
+            for (UINT i = 0u; i < NUM_BONE_INFLUENCES; ++i)
+            {
+                CHECK(packed.aBoneIndices[i] == 0u);
+                CHECK(packed.aBoneWeights[i] == 0u);
+            }
+        }
+
+        AnimationData empty = PackBoneWeights(nullptr, nullptr, 0u);
+        CHECK(sumWeights(empty) == 0u);
+    }
+
+    // Rounding every weight to the nearest unorm16 can miss one; the
+    // packer gives the difference to the dominant influence
+    TEST_CASE(PackBoneWeights_SumIsExactlyOneAfterRounding)
+    {
+        // Rounded separately, quarters add up to 65536, halves to 65536,
+        // thirds to exactly 65535 and 3:3:1 to 65534
+        const FLOAT aQuarters[] = { 0.25f, 0.25f, 0.25f, 0.25f };
+        const FLOAT aHalves[] = { 1.0f, 1.0f };
+        const FLOAT aThirds[] = { 1.0f, 1.0f, 1.0f };
+        const FLOAT aSevenths[] = { 3.0f, 3.0f, 1.0f };
+        const UINT aBoneIds[] = { 0u, 1u, 2u, 3u };
+
+        CHECK(sumWeights(PackBoneWeights(aBoneIds, aQuarters, 4u)) == PACKED_BONE_WEIGHT_ONE);
+        CHECK(sumWeights(PackBoneWeights(aBoneIds, aHalves, 2u)) == PACKED_BONE_WEIGHT_ONE);
+        CHECK(sumWeights(PackBoneWeights(aBoneIds, aThirds, 3u)) == PACKED_BONE_WEIGHT_ONE);
+        CHECK(sumWeights(PackBoneWeights(aBoneIds, aSevenths, 3u)) == PACKED_BONE_WEIGHT_ONE);
+
+        std::mt19937 generator(26u);
+        std::uniform_real_distribution<FLOAT> weightDistribution(0.0f, 1.0f);
+        std::uniform_int_distribution<UINT> countDistribution(1u, MAX_NUM_BONES_PER_VERTEX);
+        for (UINT uTrial = 0u; uTrial < 10000u; ++uTrial)
+        {
+            UINT aIds[MAX_NUM_BONES_PER_VERTEX];
+            FLOAT aWeights[MAX_NUM_BONES_PER_VERTEX];
+            UINT uNumBones = countDistribution(generator);
+            for (UINT i = 0u; i < uNumBones; ++i)
+            {
+                aIds[i] = (uTrial * 31u + i * 7u) % MAX_NUM_BONES;
+                aWeights[i] = weightDistribution(generator);
+            }
+
+            AnimationData packed = PackBoneWeights(aIds, aWeights, uNumBones);
+            if (!CHECK(sumWeights(packed) == PACKED_BONE_WEIGHT_ONE))
+            {
+                break;
+            }
+        }
+    }
+
+    // The skinning input layout reads the indices as R8G8B8A8_UINT at
+    // offset 0 and the weights as R16G16B16A16_UNORM at offset 4
+    TEST_CASE(PackBoneWeights_IndexByteLayout)
+    {
+        CHECK(sizeof(AnimationData) == 12u);
+        CHECK(offsetof(AnimationData, aBoneIndices) == 0u);
+        CHECK(offsetof(AnimationData, aBoneWeights) == 4u);
+
+        const UINT aBoneIds[] = { 0x11u, 0x22u, 0x33u, 0xFFu };
+        const FLOAT aWeights[] = { 0.4f, 0.3f, 0.2f, 0.1f };
+        AnimationData packed = PackBoneWeights(aBoneIds, aWeights, 4u);
+
+        const BYTE* pBytes = reinterpret_cast<const BYTE*>(&packed);
+        CHECK(pBytes[0] == 0x11u);
+        CHECK(pBytes[1] == 0x22u);
+        CHECK(pBytes[2] == 0x33u);
+        CHECK(pBytes[3] == 0xFFu);
+
+        // Little endian unorm16 weights right after the indices
+        for (UINT i = 0u; i < NUM_BONE_INFLUENCES; ++i)
+        {
+            USHORT uWeight = static_cast<USHORT>(pBytes[4u + i * 2u] | (pBytes[5u + i * 2u] << 8u));
+            CHECK(uWeight == packed.aBoneWeights[i]);
+        }
+    }
+}
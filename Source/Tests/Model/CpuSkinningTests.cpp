@@ -0,0 +1,182 @@
+#include "TestFramework.h"
+
+#include "Model/BoneWeights.h"
+#include "Model/CpuSkinning.h"
+#include "Utility/ThreadPool.h"
+
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT NUM_TEST_BONES = 64u;
+        constexpr const FLOAT SKINNING_TOLERANCE = 1e-4f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   SkinnedMesh
+
+          Summary:  Random bind pose vertices with packed weights and a
+                    random bone palette
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct SkinnedMesh
+        {
+            std::vector<SimpleVertex> aVertices;
+            std::vector<NormalData> aNormalData;
+            std::vector<AnimationData> aAnimationData;
+            std::vector<XMMATRIX> aBoneTransforms;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   SkinnedOutput
+
+          Summary:  Owns the arrays SkinnedVertexStreams points into
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct SkinnedOutput
+        {
+            std::vector<FLOAT> aArrays[9];
+            SkinnedVertexStreams streams;
+
+            explicit SkinnedOutput(_In_ UINT uNumVertices)
+            {
+                for (std::vector<FLOAT>& aArray : aArrays)
+                {
+                    aArray.assign(uNumVertices, -1.0f);
+                }
+                streams =
+                {
+                    .aPositionX = aArrays[0].data(), .aPositionY = aArrays[1].data(), .aPositionZ = aArrays[2].data(),
+                    .aNormalX = aArrays[3].data(), .aNormalY = aArrays[4].data(), .aNormalZ = aArrays[5].data(),
+                    .aTangentX = aArrays[6].data(), .aTangentY = aArrays[7].data(), .aTangentZ = aArrays[8].data()
+                };
+            }
+        };
+
+        SkinnedMesh createSkinnedMesh(_In_ UINT uNumVertices, _In_ UINT uSeed)
+        {
+            std::mt19937 generator(uSeed);
+            std::uniform_real_distribution<FLOAT> unitDistribution(-1.0f, 1.0f);
+            std::uniform_int_distribution<UINT> boneDistribution(0u, NUM_TEST_BONES - 1u);
+            std::uniform_int_distribution<UINT> countDistribution(1u, 6u);
+
+            SkinnedMesh mesh;
+            for (UINT i = 0u; i < NUM_TEST_BONES; ++i)
+            {
+                XMVECTOR rotation = XMQuaternionNormalize(XMVectorSet(unitDistribution(generator), unitDistribution(generator), unitDistribution(generator), unitDistribution(generator) + 1.5f));
+                XMVECTOR scale = XMVectorReplicate(1.0f + 0.25f * unitDistribution(generator));
+                XMVECTOR translation = XMVectorSet(unitDistribution(generator), unitDistribution(generator), unitDistribution(generator), 0.0f) * 10.0f;
+                mesh.aBoneTransforms.push_back(XMMatrixAffineTransformation(scale, g_XMZero, rotation, translation));
+            }
+
+            for (UINT i = 0u; i < uNumVertices; ++i)
+            {
+                XMFLOAT3 position(unitDistribution(generator) * 5.0f, unitDistribution(generator) * 5.0f, unitDistribution(generator) * 5.0f);
+                XMFLOAT3 normal;
+                XMFLOAT3 tangent;
+                XMStoreFloat3(&normal, XMVector3Normalize(XMVectorSet(unitDistribution(generator), unitDistribution(generator), unitDistribution(generator) + 2.0f, 0.0f)));
+                XMStoreFloat3(&tangent, XMVector3Normalize(XMVector3Cross(XMLoadFloat3(&normal), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))));
+                mesh.aVertices.push_back({ .Position = position, .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = normal });
+                mesh.aNormalData.push_back({ .Tangent = tangent, .Bitangent = XMFLOAT3(0.0f, 1.0f, 0.0f) });
+
+                UINT aBoneIds[6];
+                FLOAT aWeights[6];
+                UINT uNumBones = countDistribution(generator);
+                for (UINT j = 0u; j < uNumBones; ++j)
+                {
+                    aBoneIds[j] = boneDistribution(generator);
+                    aWeights[j] = unitDistribution(generator) + 1.0f;
+                }
+                mesh.aAnimationData.push_back(PackBoneWeights(aBoneIds, aWeights, uNumBones));
+            }
+
+            return mesh;
+        }
+
+        // Largest absolute difference between the outputs
+        FLOAT compareOutputs(_In_ const SkinnedOutput& a, _In_ const SkinnedOutput& b)
+        {
+            FLOAT maxDifference = 0.0f;
+            for (UINT uArray = 0u; uArray < 9u; ++uArray)
+            {
+                for (SIZE_T i = 0u; i < a.aArrays[uArray].size(); ++i)
+                {
+                    maxDifference = std::max(maxDifference, std::fabs(a.aArrays[uArray][i] - b.aArrays[uArray][i]));
+                }
+            }
+            return maxDifference;
+        }
+    }
+
+    // The SIMD kernel agrees with the scalar reference, on one thread
+    // and split across a pool, including a partial last range
+    TEST_CASE(SkinVertices_MatchesReference)
+    {
+        const UINT uNumVertices = 10007u;
+        SkinnedMesh mesh = createSkinnedMesh(uNumVertices, 27u);
+
+        SkinnedOutput reference(uNumVertices);
+        SkinVerticesReference(mesh.aVertices.data(), mesh.aNormalData.data(), mesh.aAnimationData.data(), uNumVertices,
+            mesh.aBoneTransforms.data(), NUM_TEST_BONES, reference.streams);
+
+        SkinnedOutput serial(uNumVertices);
+        SkinVertices(mesh.aVertices.data(), mesh.aNormalData.data(), mesh.aAnimationData.data(), uNumVertices,
+            mesh.aBoneTransforms.data(), NUM_TEST_BONES, serial.streams, nullptr);
+        CHECK_NEAR(compareOutputs(serial, reference), 0.0f, SKINNING_TOLERANCE);
+
+        ThreadPool threadPool(3u);
+        SkinnedOutput parallel(uNumVertices);
+        SkinVertices(mesh.aVertices.data(), mesh.aNormalData.data(), mesh.aAnimationData.data(), uNumVertices,
+            mesh.aBoneTransforms.data(), NUM_TEST_BONES, parallel.streams, &threadPool);
+        CHECK_NEAR(compareOutputs(parallel, reference), 0.0f, SKINNING_TOLERANCE);
+        CHECK(compareOutputs(parallel, serial) == 0.0f);
+    }
+
+    // Normals and tangents stay unit length under the scaled bones
+    TEST_CASE(SkinVertices_NormalizesDirections)
+    {
+        const UINT uNumVertices = 512u;
+        SkinnedMesh mesh = createSkinnedMesh(uNumVertices, 2700u);
+
+        SkinnedOutput output(uNumVertices);
+        SkinVertices(mesh.aVertices.data(), mesh.aNormalData.data(), mesh.aAnimationData.data(), uNumVertices,
+            mesh.aBoneTransforms.data(), NUM_TEST_BONES, output.streams, nullptr);
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            const SkinnedVertexStreams& s = output.streams;
+            FLOAT normalLength = std::sqrt(s.aNormalX[i] * s.aNormalX[i] + s.aNormalY[i] * s.aNormalY[i] + s.aNormalZ[i] * s.aNormalZ[i]);
+            FLOAT tangentLength = std::sqrt(s.aTangentX[i] * s.aTangentX[i] + s.aTangentY[i] * s.aTangentY[i] + s.aTangentZ[i] * s.aTangentZ[i]);
+            if (!CHECK_NEAR(normalLength, 1.0f, 1e-5f) || !CHECK_NEAR(tangentLength, 1.0f, 1e-5f))
+            {
+                break;
+            }
+        }
+    }
+
+    // A single full weight bone is a plain matrix transform, a vertex
+    // without weight collapses to the origin like in the shader, and
+    // null tangent streams are skipped
+    TEST_CASE(SkinVertices_SingleBoneAndUnweighted)
+    {
+        SkinnedMesh mesh = createSkinnedMesh(2u, 270u);
+        const UINT uBone = 5u;
+        const FLOAT fullWeight = 1.0f;
+        mesh.aAnimationData[0] = PackBoneWeights(&uBone, &fullWeight, 1u);
+        mesh.aAnimationData[1] = AnimationData{};
+
+        SkinnedOutput output(2u);
+        SkinnedVertexStreams streams = output.streams;
+        streams.aTangentX = streams.aTangentY = streams.aTangentZ = nullptr;
+        SkinVertices(mesh.aVertices.data(), mesh.aNormalData.data(), mesh.aAnimationData.data(), 2u,
+            mesh.aBoneTransforms.data(), NUM_TEST_BONES, streams, nullptr);
+
+        XMFLOAT3 expected;
+        XMStoreFloat3(&expected, XMVector3Transform(XMLoadFloat3(&mesh.aVertices[0].Position), mesh.aBoneTransforms[uBone]));
+        CHECK_NEAR(output.aArrays[0][0], expected.x, SKINNING_TOLERANCE);
+        CHECK_NEAR(output.aArrays[1][0], expected.y, SKINNING_TOLERANCE);
+        CHECK_NEAR(output.aArrays[2][0], expected.z, SKINNING_TOLERANCE);
+
+        CHECK(output.aArrays[0][1] == 0.0f && output.aArrays[1][1] == 0.0f && output.aArrays[2][1] == 0.0f);
+        CHECK(output.aArrays[6][0] == -1.0f && output.aArrays[7][1] == -1.0f);
+    }
+}
@@ -0,0 +1,182 @@
+#include "TestFramework.h"
+
+#include "Model/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT GRID_SIZE = 32u;
+
+        // GRID_SIZE x GRID_SIZE quads in the xz plane facing up, with
+        // their triangles shuffled as an unoptimized import would be
+        void createShuffledGrid(_Out_ std::vector<XMFLOAT3>& outPositions, _Out_ std::vector<UINT>& outIndices)
+        {
+            outPositions.clear();
+            outIndices.clear();
+            for (UINT z = 0u; z <= GRID_SIZE; ++z)
+            {
+                for (UINT x = 0u; x <= GRID_SIZE; ++x)
+                {
+                    outPositions.push_back(XMFLOAT3(static_cast<FLOAT>(x), 0.0f, static_cast<FLOAT>(z)));
+                }
+            }
+
+            std::vector<std::array<UINT, 3>> aTriangles;
+            for (UINT z = 0u; z < GRID_SIZE; ++z)
+            {
+                for (UINT x = 0u; x < GRID_SIZE; ++x)
+                {
+                    UINT uCorner = z * (GRID_SIZE + 1u) + x;
+                    aTriangles.push_back({ uCorner, uCorner + GRID_SIZE + 1u, uCorner + 1u });
+                    aTriangles.push_back({ uCorner + 1u, uCorner + GRID_SIZE + 1u, uCorner + GRID_SIZE + 2u });
+                }
+            }
+            std::shuffle(aTriangles.begin(), aTriangles.end(), std::mt19937(30u));
+            for (const std::array<UINT, 3>& triangle : aTriangles)
+            {
+                outIndices.insert(outIndices.end(), triangle.begin(), triangle.end());
+            }
+        }
+
+        // Triangles rotated to start at their smallest index, which keeps
+        // the winding, and sorted, so two lists compare equal exactly
+        // when they hold the same triangles
+        std::vector<std::array<UINT, 3>> getTriangleSet(_In_ const std::vector<UINT>& aIndices)
+        {
+            std::vector<std::array<UINT, 3>> aTriangles;
+            for (SIZE_T i = 0u; i < aIndices.size(); i += 3u)
+            {
+                std::array<UINT, 3> triangle = { aIndices[i], aIndices[i + 1u], aIndices[i + 2u] };
+                std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+                aTriangles.push_back(triangle);
+            }
+            std::sort(aTriangles.begin(), aTriangles.end());
+            return aTriangles;
+        }
+
+        VertexCacheStats analyze(_In_ const std::vector<UINT>& aIndices, _In_ UINT uNumVertices)
+        {
+            return AnalyzeVertexCache(aIndices.data(), static_cast<UINT>(aIndices.size()), uNumVertices, VERTEX_CACHE_SIZE);
+        }
+    }
+
+    // Every vertex that missed the FIFO is one transform, and a vertex
+    // pushed out by newer ones is transformed again
+    TEST_CASE(AnalyzeVertexCache_CountsFifoMisses)
+    {
+        std::vector<UINT> aIndices = { 0u, 1u, 2u, 2u, 1u, 3u };
+        VertexCacheStats stats = analyze(aIndices, 4u);
+        CHECK(stats.uNumTransforms == 4u);
+        CHECK_NEAR(stats.Acmr, 2.0f, 1e-6);
+        CHECK_NEAR(stats.Atvr, 1.0f, 1e-6);
+
+        // With a 3 entry cache, vertex 0 is gone by the third triangle
+        aIndices = { 0u, 1u, 2u, 3u, 4u, 5u, 0u, 4u, 5u };
+        stats = AnalyzeVertexCache(aIndices.data(), static_cast<UINT>(aIndices.size()), 6u, 3u);
+        CHECK(stats.uNumTransforms == 7u);
+        CHECK_NEAR(stats.Atvr, 7.0f / 6.0f, 1e-6);
+    }
+
+    // Reordering keeps every triangle with its winding, marks the first
+    // triangle of each cluster and brings the ACMR of a shuffled grid
+    // close to its 0.5 ideal
+    TEST_CASE(OptimizeVertexCache_KeepsTrianglesAndLowersAcmr)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createShuffledGrid(aPositions, aIndices);
+        const UINT uNumVertices = static_cast<UINT>(aPositions.size());
+
+        std::vector<UINT> aOptimizedIndices(aIndices.size());
+        std::vector<UINT> aClusters;
+        OptimizeVertexCache(aIndices.data(), static_cast<UINT>(aIndices.size()), uNumVertices, VERTEX_CACHE_SIZE, aOptimizedIndices.data(), &aClusters);
+        CHECK(getTriangleSet(aOptimizedIndices) == getTriangleSet(aIndices));
+        CHECK(!aClusters.empty() && aClusters[0] == 0u && std::is_sorted(aClusters.begin(), aClusters.end()));
+        CHECK(aClusters.back() < aIndices.size() / 3u);
+
+        VertexCacheStats before = analyze(aIndices, uNumVertices);
+        VertexCacheStats after = analyze(aOptimizedIndices, uNumVertices);
+        CHECK(before.Acmr > 1.5f);
+        CHECK(after.Acmr < 0.8f && after.Acmr < before.Acmr);
+        CHECK(after.Atvr < before.Atvr);
+    }
+
+    // Sorting clusters for overdraw keeps the triangles and stays close
+    // to the cache optimized ACMR
+    TEST_CASE(OptimizeOverdraw_KeepsTrianglesAndCacheEfficiency)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createShuffledGrid(aPositions, aIndices);
+        const UINT uNumVertices = static_cast<UINT>(aPositions.size());
+        const UINT uNumIndices = static_cast<UINT>(aIndices.size());
+
+        std::vector<UINT> aCacheIndices(uNumIndices);
+        std::vector<UINT> aClusters;
+        OptimizeVertexCache(aIndices.data(), uNumIndices, uNumVertices, VERTEX_CACHE_SIZE, aCacheIndices.data(), &aClusters);
+
+        std::vector<UINT> aOverdrawIndices(uNumIndices);
+        OptimizeOverdraw(
+            aCacheIndices.data(),
+            uNumIndices,
+            aPositions.data(),
+            sizeof(XMFLOAT3),
+            uNumVertices,
+            aClusters,
+            VERTEX_CACHE_SIZE,
+            OVERDRAW_THRESHOLD,
+            aOverdrawIndices.data()
+        );
+        CHECK(getTriangleSet(aOverdrawIndices) == getTriangleSet(aIndices));
+        CHECK(analyze(aOverdrawIndices, uNumVertices).Acmr < analyze(aIndices, uNumVertices).Acmr);
+    }
+
+    // Vertices are renumbered in order of first use, the remap is a
+    // permutation and the renumbered triangles are the same triangles
+    TEST_CASE(OptimizeVertexFetch_RenumbersInFirstUseOrder)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createShuffledGrid(aPositions, aIndices);
+        // Two more vertices that no triangle uses, they have to end up
+        // last
+        const UINT uNumVertices = static_cast<UINT>(aPositions.size()) + 2u;
+        std::vector<UINT> aFetchIndices = aIndices;
+        std::vector<UINT> aRemap;
+        OptimizeVertexFetch(aFetchIndices.data(), static_cast<UINT>(aFetchIndices.size()), uNumVertices, aRemap);
+        REQUIRE(aRemap.size() == uNumVertices);
+
+        std::vector<UINT> aSorted = aRemap;
+        std::sort(aSorted.begin(), aSorted.end());
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            REQUIRE(aSorted[i] == i);
+        }
+
+        UINT uNextNew = 0u;
+        std::vector<UINT> aRemapped(aFetchIndices.size());
+        for (SIZE_T i = 0u; i < aFetchIndices.size(); ++i)
+        {
+            REQUIRE(aFetchIndices[i] <= uNextNew);
+            uNextNew = std::max(uNextNew, aFetchIndices[i] + 1u);
+            aRemapped[i] = aRemap[aFetchIndices[i]];
+        }
+        CHECK(aRemapped == aIndices);
+
+        std::vector<BOOL> aUsed(uNumVertices, FALSE);
+        for (UINT uIndex : aIndices)
+        {
+            aUsed[uIndex] = TRUE;
+        }
+        CHECK(uNextNew == uNumVertices - 2u);
+        for (UINT i = uNextNew; i < uNumVertices; ++i)
+        {
+            CHECK(!aUsed[aRemap[i]]);
+        }
+    }
+}
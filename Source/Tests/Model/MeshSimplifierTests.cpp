@@ -0,0 +1,159 @@
+#include "TestFramework.h"
+
+#include "Model/MeshSimplifier.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT GRID_SIZE = 32u;
+
+        // GRID_SIZE x GRID_SIZE quads in the xz plane facing up, with
+        // heights of amplitude bumpiness
+        void createGrid(_In_ FLOAT bumpiness, _Out_ std::vector<XMFLOAT3>& outPositions, _Out_ std::vector<UINT>& outIndices)
+        {
+            outPositions.clear();
+            outIndices.clear();
+            for (UINT z = 0u; z <= GRID_SIZE; ++z)
+            {
+                for (UINT x = 0u; x <= GRID_SIZE; ++x)
+                {
+                    FLOAT height = bumpiness * std::sin(static_cast<FLOAT>(x) * 0.4f) * std::cos(static_cast<FLOAT>(z) * 0.3f);
+                    outPositions.push_back(XMFLOAT3(static_cast<FLOAT>(x), height, static_cast<FLOAT>(z)));
+                }
+            }
+            for (UINT z = 0u; z < GRID_SIZE; ++z)
+            {
+                for (UINT x = 0u; x < GRID_SIZE; ++x)
+                {
+                    UINT uCorner = z * (GRID_SIZE + 1u) + x;
+                    outIndices.insert(outIndices.end(), { uCorner, uCorner + GRID_SIZE + 1u, uCorner + 1u });
+                    outIndices.insert(outIndices.end(), { uCorner + 1u, uCorner + GRID_SIZE + 1u, uCorner + GRID_SIZE + 2u });
+                }
+            }
+        }
+
+        // Directed edges used by one triangle only, the open border
+        std::set<std::pair<UINT, UINT>> getBorderEdges(_In_ const std::vector<UINT>& aIndices)
+        {
+            std::multiset<std::pair<UINT, UINT>> edges;
+            for (SIZE_T i = 0u; i < aIndices.size(); i += 3u)
+            {
+                for (UINT j = 0u; j < 3u; ++j)
+                {
+                    edges.insert(std::make_pair(aIndices[i + j], aIndices[i + (j + 1u) % 3u]));
+                }
+            }
+
+            std::set<std::pair<UINT, UINT>> borderEdges;
+            for (const std::pair<UINT, UINT>& edge : edges)
+            {
+                if (edges.count(std::make_pair(edge.second, edge.first)) == 0u)
+                {
+                    borderEdges.insert(edge);
+                }
+            }
+            return borderEdges;
+        }
+
+        XMVECTOR getNormal(_In_ const std::vector<XMFLOAT3>& aPositions, _In_ const UINT* pTriangle)
+        {
+            XMVECTOR a = XMLoadFloat3(&aPositions[pTriangle[0]]);
+            XMVECTOR b = XMLoadFloat3(&aPositions[pTriangle[1]]);
+            XMVECTOR c = XMLoadFloat3(&aPositions[pTriangle[2]]);
+            return XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(c, a));
+        }
+
+        void simplify(
+            _In_ const std::vector<XMFLOAT3>& aPositions,
+            _In_ const std::vector<UINT>& aIndices,
+            _In_ UINT uTargetNumIndices,
+            _In_ FLOAT maxError,
+            _Out_ std::vector<UINT>& outIndices,
+            _Out_ FLOAT& outError
+        )
+        {
+            SimplifyMesh(
+                aIndices.data(),
+                static_cast<UINT>(aIndices.size()),
+                aPositions.data(),
+                sizeof(XMFLOAT3),
+                static_cast<UINT>(aPositions.size()),
+                uTargetNumIndices,
+                maxError,
+                outIndices,
+                &outError
+            );
+        }
+    }
+
+    // A flat grid simplifies down to the target without moving the
+    // surface, and the result indexes the same vertices
+    TEST_CASE(SimplifyMesh_ReachesTargetOnFlatGrid)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createGrid(0.0f, aPositions, aIndices);
+
+        const UINT uTargetNumIndices = static_cast<UINT>(aIndices.size()) / 4u / 3u * 3u;
+        std::vector<UINT> aSimplified;
+        FLOAT error = -1.0f;
+        simplify(aPositions, aIndices, uTargetNumIndices, 1.0f, aSimplified, error);
+
+        CHECK(aSimplified.size() % 3u == 0u);
+        CHECK(aSimplified.size() <= uTargetNumIndices && aSimplified.size() > 0u);
+        CHECK_NEAR(error, 0.0f, 1e-5);
+        CHECK(std::all_of(aSimplified.begin(), aSimplified.end(), [&](UINT uIndex) { return uIndex < aPositions.size(); }));
+    }
+
+    // Open borders are locked: the simplified mesh has exactly the
+    // border edges of the source, with the same direction
+    TEST_CASE(SimplifyMesh_KeepsBorderIntact)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createGrid(0.5f, aPositions, aIndices);
+
+        std::vector<UINT> aSimplified;
+        FLOAT error = 0.0f;
+        simplify(aPositions, aIndices, static_cast<UINT>(aIndices.size()) / 4u / 3u * 3u, 1.0f, aSimplified, error);
+
+        REQUIRE(aSimplified.size() < aIndices.size());
+        CHECK(getBorderEdges(aIndices).size() == 4u * GRID_SIZE);
+        CHECK(getBorderEdges(aSimplified) == getBorderEdges(aIndices));
+    }
+
+    // Collapses never leave a triangle with a repeated corner, no area
+    // or folded under the surface, and stop at maxError. Triangles of
+    // three border vertices stand upright, so a normal may be level
+    TEST_CASE(SimplifyMesh_ProducesNoDegenerateTriangles)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createGrid(0.5f, aPositions, aIndices);
+
+        for (FLOAT maxError : { 0.05f, 1.0f })
+        {
+            std::vector<UINT> aSimplified;
+            FLOAT error = 0.0f;
+            simplify(aPositions, aIndices, 3u * 64u, maxError, aSimplified, error);
+            CHECK(aSimplified.size() < aIndices.size() && error <= maxError);
+
+            for (SIZE_T i = 0u; i < aSimplified.size(); i += 3u)
+            {
+                const UINT* pTriangle = &aSimplified[i];
+                BOOL bValid = CHECK(pTriangle[0] != pTriangle[1] && pTriangle[1] != pTriangle[2] && pTriangle[2] != pTriangle[0]) &&
+                    CHECK(XMVectorGetX(XMVector3Length(getNormal(aPositions, pTriangle))) > 1e-6f) &&
+                    CHECK(XMVectorGetY(getNormal(aPositions, pTriangle)) >= 0.0f);
+                if (!bValid)
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
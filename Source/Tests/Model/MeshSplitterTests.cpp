@@ -0,0 +1,157 @@
+#include "TestFramework.h"
+
+#include "Model/MeshSplitter.h"
+
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // Triangulated grid, neighbouring triangles share vertices
+        std::vector<UINT> createGrid(_In_ UINT uWidth, _In_ UINT uHeight)
+        {
+            std::vector<UINT> aIndices;
+            for (UINT y = 0u; y + 1u < uHeight; ++y)
+            {
+                for (UINT x = 0u; x + 1u < uWidth; ++x)
+                {
+                    UINT uCorner = y * uWidth + x;
+                    aIndices.insert(aIndices.end(), { uCorner, uCorner + uWidth, uCorner + 1u });
+                    aIndices.insert(aIndices.end(), { uCorner + 1u, uCorner + uWidth, uCorner + uWidth + 1u });
+                }
+            }
+            return aIndices;
+        }
+
+        // Checks that every submesh is addressable with 16-bit indices
+        // and that the submeshes, mapped back to the source vertices,
+        // hold the source triangles in their order
+        BOOL checkSplit(_In_ const std::vector<UINT>& aIndices, _In_ UINT uNumVertices, _Out_ std::vector<Submesh>& outSubmeshes)
+        {
+            SplitMeshForIndex16(aIndices.data(), static_cast<UINT>(aIndices.size()), uNumVertices, outSubmeshes);
+
+            std::vector<UINT> aRemappedIndices;
+            std::vector<UINT> aSeenInSubmesh(uNumVertices, 0u);
+            for (UINT uSubmesh = 0u; uSubmesh < outSubmeshes.size(); ++uSubmesh)
+            {
+                const Submesh& submesh = outSubmeshes[uSubmesh];
+                if (!CHECK(!submesh.aIndices.empty() && submesh.aIndices.size() % 3u == 0u) ||
+                    !CHECK(submesh.aVertexRemap.size() <= MAX_INDEX16_VERTICES))
+                {
+                    return FALSE;
+                }
+
+                // No source vertex appears twice in the same submesh
+                for (UINT uVertex : submesh.aVertexRemap)
+                {
+                    if (!CHECK(uVertex < uNumVertices && aSeenInSubmesh[uVertex] != uSubmesh + 1u))
+                    {
+                        return FALSE;
+                    }
+                    aSeenInSubmesh[uVertex] = uSubmesh + 1u;
+                }
+
+                for (UINT uIndex : submesh.aIndices)
+                {
+                    if (!CHECK(uIndex < submesh.aVertexRemap.size()))
+                    {
+                        return FALSE;
+                    }
+                    aRemappedIndices.push_back(submesh.aVertexRemap[uIndex]);
+                }
+            }
+
+            return CHECK(aRemappedIndices == aIndices);
+        }
+    }
+
+    // 65535 is the largest index that still fits in 16 bits
+    TEST_CASE(NeedsIndex32_Boundary)
+    {
+        const UINT aSmall[] = { 0u, 1u, 65535u };
+        const UINT aLarge[] = { 0u, 65536u, 1u };
+
+        CHECK(!NeedsIndex32(aSmall, 3u));
+        CHECK(NeedsIndex32(aLarge, 3u));
+        CHECK(!NeedsIndex32(nullptr, 0u));
+    }
+
+    // A mesh that fits stays in one submesh with its own indices
+    TEST_CASE(SplitMeshForIndex16_SmallMeshIsOneSubmesh)
+    {
+        std::vector<UINT> aIndices = createGrid(16u, 16u);
+        std::vector<Submesh> aSubmeshes;
+
+        CHECK(checkSplit(aIndices, 256u, aSubmeshes));
+        CHECK(aSubmeshes.size() == 1u);
+        CHECK(aSubmeshes[0].aVertexRemap.size() == 256u);
+    }
+
+    // A 400x400 grid has 160000 vertices, so it needs at least three
+    // submeshes; the seams duplicate only a few rows
+    TEST_CASE(SplitMeshForIndex16_LargeGrid)
+    {
+        const UINT uSide = 400u;
+        std::vector<UINT> aIndices = createGrid(uSide, uSide);
+        std::vector<Submesh> aSubmeshes;
+
+        CHECK(NeedsIndex32(aIndices.data(), static_cast<UINT>(aIndices.size())));
+        CHECK(checkSplit(aIndices, uSide * uSide, aSubmeshes));
+        CHECK(aSubmeshes.size() >= 3u && aSubmeshes.size() <= 4u);
+
+        SIZE_T uNumSubmeshVertices = 0u;
+        for (const Submesh& submesh : aSubmeshes)
+        {
+            uNumSubmeshVertices += submesh.aVertexRemap.size();
+        }
+        CHECK(uNumSubmeshVertices < uSide * uSide + 4u * uSide);
+    }
+
+    // Triangles over random vertices, so almost every triangle brings
+    // new vertices and submeshes fill up to the limit
+    TEST_CASE(SplitMeshForIndex16_ScatteredTriangles)
+    {
+        const UINT uNumVertices = 200000u;
+        std::mt19937 generator(29u);
+        std::uniform_int_distribution<UINT> vertexDistribution(0u, uNumVertices - 1u);
+
+        std::vector<UINT> aIndices(3u * 90000u);
+        for (UINT& uIndex : aIndices)
+        {
+            uIndex = vertexDistribution(generator);
+        }
+
+        std::vector<Submesh> aSubmeshes;
+        CHECK(checkSplit(aIndices, uNumVertices, aSubmeshes));
+        for (SIZE_T i = 0u; i + 1u < aSubmeshes.size(); ++i)
+        {
+            CHECK(aSubmeshes[i].aVertexRemap.size() + 3u > MAX_INDEX16_VERTICES);
+        }
+    }
+
+    // A triangle that repeats a vertex only needs one new slot, so it
+    // still fits when the submesh is one vertex short of the limit
+    TEST_CASE(SplitMeshForIndex16_ExactlyFullSubmesh)
+    {
+        const UINT uNumVertices = MAX_INDEX16_VERTICES + 1u;
+        std::vector<UINT> aIndices;
+        for (UINT i = 0u; i + 2u < MAX_INDEX16_VERTICES; i += 3u)
+        {
+            aIndices.insert(aIndices.end(), { i, i + 1u, i + 2u });
+        }
+        aIndices.insert(aIndices.end(), { MAX_INDEX16_VERTICES - 1u, MAX_INDEX16_VERTICES - 1u, 0u });
+        aIndices.insert(aIndices.end(), { 1u, 2u, 3u });
+
+        std::vector<Submesh> aSubmeshes;
+        CHECK(checkSplit(aIndices, uNumVertices, aSubmeshes));
+        CHECK(aSubmeshes.size() == 1u);
+        CHECK(aSubmeshes[0].aVertexRemap.size() == MAX_INDEX16_VERTICES);
+
+        // One more vertex does not fit and starts the next submesh
+        aIndices.insert(aIndices.end(), { 0u, 1u, MAX_INDEX16_VERTICES });
+        CHECK(checkSplit(aIndices, uNumVertices, aSubmeshes));
+        CHECK(aSubmeshes.size() == 2u);
+        CHECK(aSubmeshes[1].aVertexRemap.size() == 3u);
+    }
+}
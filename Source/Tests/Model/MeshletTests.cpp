@@ -0,0 +1,165 @@
+#include "TestFramework.h"
+
+#include "Model/Meshlet.h"
+
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // Closed unit sphere with outward facing triangles
+        void createSphere(_In_ UINT uSlices, _In_ UINT uStacks, _Out_ std::vector<XMFLOAT3>& outPositions, _Out_ std::vector<UINT>& outIndices)
+        {
+            outPositions.clear();
+            outIndices.clear();
+            for (UINT uStack = 0u; uStack <= uStacks; ++uStack)
+            {
+                FLOAT phi = XM_PI * static_cast<FLOAT>(uStack) / static_cast<FLOAT>(uStacks);
+                for (UINT uSlice = 0u; uSlice <= uSlices; ++uSlice)
+                {
+                    FLOAT theta = XM_2PI * static_cast<FLOAT>(uSlice) / static_cast<FLOAT>(uSlices);
+                    outPositions.push_back(XMFLOAT3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)));
+                }
+            }
+            for (UINT uStack = 0u; uStack < uStacks; ++uStack)
+            {
+                for (UINT uSlice = 0u; uSlice < uSlices; ++uSlice)
+                {
+                    UINT uCorner = uStack * (uSlices + 1u) + uSlice;
+                    outIndices.insert(outIndices.end(), { uCorner, uCorner + 1u, uCorner + uSlices + 1u });
+                    outIndices.insert(outIndices.end(), { uCorner + 1u, uCorner + uSlices + 2u, uCorner + uSlices + 1u });
+                }
+            }
+        }
+
+        // Whether a point is inside the clip volume of D3D, by margin
+        BOOL isInsideClipVolume(_In_ const XMVECTOR& position, _In_ const XMMATRIX& viewProjection, _In_ FLOAT margin)
+        {
+            XMFLOAT4 clip;
+            XMStoreFloat4(&clip, XMVector4Transform(XMVectorSetW(position, 1.0f), viewProjection));
+            FLOAT limit = clip.w * (1.0f - margin);
+            return std::abs(clip.x) < limit && std::abs(clip.y) < limit && clip.z > clip.w * margin && clip.z < limit;
+        }
+    }
+
+    // A point is on the inner side of all six planes exactly when it is
+    // inside the clip volume
+    TEST_CASE(ComputeFrustumPlanes_MatchClipVolume)
+    {
+        XMMATRIX viewProjection = XMMatrixLookAtLH(XMVectorSet(3.0f, 1.0f, -5.0f, 1.0f), XMVectorSet(0.0f, 0.5f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) *
+            XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.5f, 20.0f);
+        XMVECTOR aPlanes[6];
+        ComputeFrustumPlanes(viewProjection, aPlanes);
+
+        std::mt19937 generator(370u);
+        std::uniform_real_distribution<FLOAT> distribution(-25.0f, 25.0f);
+        UINT uNumInside = 0u;
+        for (UINT i = 0u; i < 20000u; ++i)
+        {
+            XMVECTOR position = XMVectorSet(distribution(generator), distribution(generator), distribution(generator), 1.0f);
+            FLOAT minDistance = FLT_MAX;
+            for (const XMVECTOR& plane : aPlanes)
+            {
+                minDistance = std::min(minDistance, XMVectorGetX(XMPlaneDotCoord(plane, position)));
+            }
+
+            // Points right on a plane can go either way
+            if (std::abs(minDistance) < 1e-3f)
+            {
+                continue;
+            }
+            BOOL bInside = isInsideClipVolume(position, viewProjection, 0.0f);
+            uNumInside += bInside ? 1u : 0u;
+            if (!CHECK((minDistance > 0.0f) == bInside))
+            {
+                break;
+            }
+        }
+        CHECK(uNumInside > 100u);
+    }
+
+    // Against a brute force check per triangle: a meshlet with any
+    // triangle that faces the eye and has a corner inside the frustum is
+    // never culled. The sphere and cone tests still cull a good part of
+    // the meshlets from every camera
+    TEST_CASE(IsMeshletVisible_NeverCullsVisibleTriangles)
+    {
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<UINT> aIndices;
+        createSphere(64u, 32u, aPositions, aIndices);
+
+        std::vector<UINT> aMeshletIndices(aIndices.size());
+        std::vector<Meshlet> aMeshlets;
+        BuildMeshlets(aIndices.data(), static_cast<UINT>(aIndices.size()), aPositions.data(), sizeof(XMFLOAT3),
+            static_cast<UINT>(aPositions.size()), aMeshletIndices.data(), aMeshlets);
+        CHECK(aMeshlets.size() > 10u);
+
+        std::mt19937 generator(3701u);
+        std::uniform_real_distribution<FLOAT> distribution(-1.0f, 1.0f);
+        UINT uNumTested = 0u;
+        UINT uNumCulled = 0u;
+        for (UINT uCamera = 0u; uCamera < 64u; ++uCamera)
+        {
+            XMVECTOR eye = XMVector3Normalize(XMVectorSet(distribution(generator), distribution(generator), distribution(generator), 0.0f)) *
+                (1.5f + 3.0f * std::abs(distribution(generator)));
+            XMVECTOR focus = XMVectorSet(distribution(generator), distribution(generator), distribution(generator), 0.0f) * 0.8f;
+            XMMATRIX viewProjection = XMMatrixLookAtLH(XMVectorSetW(eye, 1.0f), XMVectorSetW(focus, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) *
+                XMMatrixPerspectiveFovLH(XMConvertToRadians(40.0f), 1.0f, 0.1f, 100.0f);
+            XMVECTOR aPlanes[6];
+            ComputeFrustumPlanes(viewProjection, aPlanes);
+
+            for (const Meshlet& meshlet : aMeshlets)
+            {
+                BOOL bMustBeVisible = FALSE;
+                for (UINT i = meshlet.uBaseIndex; i < meshlet.uBaseIndex + meshlet.uNumIndices && !bMustBeVisible; i += 3u)
+                {
+                    XMVECTOR p0 = XMLoadFloat3(&aPositions[aMeshletIndices[i]]);
+                    XMVECTOR p1 = XMLoadFloat3(&aPositions[aMeshletIndices[i + 1u]]);
+                    XMVECTOR p2 = XMLoadFloat3(&aPositions[aMeshletIndices[i + 2u]]);
+                    XMVECTOR normal = XMVector3Normalize(XMVector3Cross(p1 - p0, p2 - p0));
+                    BOOL bFacesEye = XMVectorGetX(XMVector3Dot(normal, XMVector3Normalize(p0 - eye))) < -1e-3f;
+                    BOOL bInFrustum = isInsideClipVolume(p0, viewProjection, 1e-3f) ||
+                        isInsideClipVolume(p1, viewProjection, 1e-3f) ||
+                        isInsideClipVolume(p2, viewProjection, 1e-3f);
+                    bMustBeVisible = bFacesEye && bInFrustum;
+                }
+
+                BOOL bVisible = IsMeshletVisible(meshlet, aPlanes, eye, TRUE);
+                ++uNumTested;
+                uNumCulled += bVisible ? 0u : 1u;
+                if (bMustBeVisible && !CHECK(bVisible))
+                {
+                    return;
+                }
+            }
+        }
+
+        CHECK(uNumCulled * 4u > uNumTested);
+    }
+
+    // Without cone culling only the frustum decides, so a meshlet facing
+    // away in front of the camera stays visible
+    TEST_CASE(IsMeshletVisible_ConeCullingSwitch)
+    {
+        Meshlet meshlet =
+        {
+            .Center = XMFLOAT3(0.0f, 0.0f, 5.0f),
+            .Radius = 0.5f,
+            .ConeAxis = XMFLOAT3(0.0f, 0.0f, 1.0f),
+            .ConeCutoff = 0.2f,
+            .uBaseIndex = 0u,
+            .uNumIndices = 3u
+        };
+        XMMATRIX viewProjection = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 1.0f, 0.1f, 100.0f);
+        XMVECTOR aPlanes[6];
+        ComputeFrustumPlanes(viewProjection, aPlanes);
+
+        CHECK(!IsMeshletVisible(meshlet, aPlanes, XMVectorZero(), TRUE));
+        CHECK(IsMeshletVisible(meshlet, aPlanes, XMVectorZero(), FALSE));
+
+        // Behind the camera it is culled by the frustum either way
+        meshlet.Center.z = -5.0f;
+        CHECK(!IsMeshletVisible(meshlet, aPlanes, XMVectorZero(), FALSE));
+    }
+}
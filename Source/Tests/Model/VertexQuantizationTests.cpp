@@ -0,0 +1,223 @@
+#include "TestFramework.h"
+
+#include "Model/VertexQuantization.h"
+
+#include <cmath>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // Largest angle errors over 2M random frames were 0.237 and 0.285
+        // degrees. A 10:10 octahedral normal is off by up to a quarter
+        // degree, the 10-bit tangent angle adds half a step of 0.18
+        constexpr const FLOAT NORMAL_DEGREES = 0.25f;
+        constexpr const FLOAT TANGENT_DEGREES = 0.35f;
+
+        // Degrees to the cosine bound the direction tests check against
+        FLOAT cosineOfDegrees(_In_ FLOAT degrees)
+        {
+            return std::cos(XMConvertToRadians(degrees));
+        }
+
+        FLOAT dot(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        XMFLOAT3 randomDirection(_Inout_ std::mt19937& generator)
+        {
+            std::normal_distribution<FLOAT> distribution;
+            XMFLOAT3 direction;
+            XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSet(distribution(generator), distribution(generator), distribution(generator), 0.0f)));
+            return direction;
+        }
+
+        // Random orthonormal tangent frame of either handedness
+        void randomFrame(_Inout_ std::mt19937& generator, _Out_ XMFLOAT3& outNormal, _Out_ NormalData& outNormalData)
+        {
+            outNormal = randomDirection(generator);
+            XMFLOAT3 direction = randomDirection(generator);
+            XMVECTOR normal = XMLoadFloat3(&outNormal);
+            XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(normal, XMLoadFloat3(&direction)));
+            XMVECTOR bitangent = XMVector3Cross(normal, tangent);
+            if (generator() & 1u)
+            {
+                bitangent = XMVectorNegate(bitangent);
+            }
+            XMStoreFloat3(&outNormalData.Tangent, tangent);
+            XMStoreFloat3(&outNormalData.Bitangent, bitangent);
+        }
+    }
+
+    // Positions come back within half a unorm16 step of their axis
+    TEST_CASE(QuantizeVertices_PositionErrorBound)
+    {
+        std::mt19937 generator(31u);
+        std::uniform_real_distribution<FLOAT> distribution(-1.0f, 1.0f);
+
+        std::vector<SimpleVertex> aVertices(4096u);
+        for (SimpleVertex& vertex : aVertices)
+        {
+            vertex.Position = XMFLOAT3(distribution(generator) * 250.0f + 40.0f, distribution(generator) * 0.01f, distribution(generator) * 3.0f);
+            vertex.Normal = XMFLOAT3(0.0f, 0.0f, 1.0f);
+        }
+        aVertices[0].Position = XMFLOAT3(-210.0f, -0.01f, -3.0f);
+        aVertices[1].Position = XMFLOAT3(290.0f, 0.01f, 3.0f);
+
+        QuantizationBounds bounds = ComputeQuantizationBounds(aVertices.data(), static_cast<UINT>(aVertices.size()));
+        CHECK_NEAR(bounds.Min.x, -210.0f, 1e-4f);
+        CHECK_NEAR(bounds.Extent.x, 500.0f, 1e-4f);
+
+        std::vector<QuantizedVertex> aQuantized(aVertices.size());
+        QuantizeVertices(aVertices.data(), nullptr, static_cast<UINT>(aVertices.size()), bounds, aQuantized.data());
+
+        const FLOAT aExtents[] = { bounds.Extent.x, bounds.Extent.y, bounds.Extent.z };
+        for (SIZE_T i = 0u; i < aVertices.size(); ++i)
+        {
+            SimpleVertex decoded;
+            NormalData decodedNormalData;
+            DequantizeVertex(aQuantized[i], bounds, decoded, decodedNormalData);
+
+            const FLOAT aSource[] = { aVertices[i].Position.x, aVertices[i].Position.y, aVertices[i].Position.z };
+            const FLOAT aDecoded[] = { decoded.Position.x, decoded.Position.y, decoded.Position.z };
+            for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+            {
+                // Half a step, plus float rounding of the decode
+                DOUBLE tolerance = 0.5 / 65535.0 * aExtents[uAxis] + 1e-6 * (std::fabs(aSource[uAxis]) + aExtents[uAxis]);
+                if (!CHECK_NEAR(aDecoded[uAxis], aSource[uAxis], tolerance))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    // A flat axis keeps a finite extent and decodes to its value
+    TEST_CASE(QuantizeVertices_FlatAxis)
+    {
+        SimpleVertex aVertices[2] = {};
+        aVertices[0].Position = XMFLOAT3(1.0f, 5.0f, -2.0f);
+        aVertices[1].Position = XMFLOAT3(3.0f, 5.0f, -2.0f);
+
+        QuantizationBounds bounds = ComputeQuantizationBounds(aVertices, 2u);
+        CHECK(bounds.Extent.y > 0.0f && bounds.Extent.z > 0.0f);
+
+        QuantizedVertex aQuantized[2];
+        QuantizeVertices(aVertices, nullptr, 2u, bounds, aQuantized);
+        SimpleVertex decoded;
+        NormalData decodedNormalData;
+        DequantizeVertex(aQuantized[1], bounds, decoded, decodedNormalData);
+        CHECK_NEAR(decoded.Position.y, 5.0f, 1e-5f);
+        CHECK_NEAR(decoded.Position.z, -2.0f, 1e-5f);
+    }
+
+    // Texture coordinates are half floats, within 2^-11 relative error
+    // including repeated ones outside [0, 1]
+    TEST_CASE(QuantizeVertices_TexCoordErrorBound)
+    {
+        std::mt19937 generator(310u);
+        std::uniform_real_distribution<FLOAT> distribution(-4.0f, 4.0f);
+
+        std::vector<SimpleVertex> aVertices(4096u);
+        for (SimpleVertex& vertex : aVertices)
+        {
+            vertex.TexCoord = XMFLOAT2(distribution(generator), distribution(generator) * 0.25f);
+            vertex.Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+        }
+        aVertices[0].TexCoord = XMFLOAT2(0.0f, 1.0f);
+
+        QuantizationBounds bounds = ComputeQuantizationBounds(aVertices.data(), static_cast<UINT>(aVertices.size()));
+        std::vector<QuantizedVertex> aQuantized(aVertices.size());
+        QuantizeVertices(aVertices.data(), nullptr, static_cast<UINT>(aVertices.size()), bounds, aQuantized.data());
+
+        for (SIZE_T i = 0u; i < aVertices.size(); ++i)
+        {
+            SimpleVertex decoded;
+            NormalData decodedNormalData;
+            DequantizeVertex(aQuantized[i], bounds, decoded, decodedNormalData);
+
+            const XMFLOAT2& source = aVertices[i].TexCoord;
+            if (!CHECK_NEAR(decoded.TexCoord.x, source.x, std::ldexp(std::fabs(source.x), -11) + 1e-7) ||
+                !CHECK_NEAR(decoded.TexCoord.y, source.y, std::ldexp(std::fabs(source.y), -11) + 1e-7))
+            {
+                return;
+            }
+        }
+
+        SimpleVertex decoded;
+        NormalData decodedNormalData;
+        DequantizeVertex(aQuantized[0], bounds, decoded, decodedNormalData);
+        CHECK(decoded.TexCoord.x == 0.0f && decoded.TexCoord.y == 1.0f);
+    }
+
+    // Normals stay within NORMAL_DEGREES of the source. Tangents stay
+    // within TANGENT_DEGREES and exactly perpendicular to the decoded
+    // normal, and the handedness survives
+    TEST_CASE(QuantizeVertices_TangentFrameErrorBound)
+    {
+        std::mt19937 generator(3100u);
+        const UINT uNumVertices = 20000u;
+        std::vector<SimpleVertex> aVertices(uNumVertices);
+        std::vector<NormalData> aNormalData(uNumVertices);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            randomFrame(generator, aVertices[i].Normal, aNormalData[i]);
+        }
+
+        // The octahedron's folds and poles
+        const XMFLOAT3 aAxes[] =
+        {
+            XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 0.0f, -1.0f), XMFLOAT3(1.0f, 0.0f, 0.0f),
+            XMFLOAT3(0.0f, -1.0f, 0.0f), XMFLOAT3(0.70710678f, 0.0f, -0.70710678f)
+        };
+        for (UINT i = 0u; i < ARRAYSIZE(aAxes); ++i)
+        {
+            aVertices[i].Normal = aAxes[i];
+            XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(XMLoadFloat3(&aAxes[i]), XMVectorSet(0.3f, 0.5f, 0.8f, 0.0f)));
+            XMStoreFloat3(&aNormalData[i].Tangent, tangent);
+            XMStoreFloat3(&aNormalData[i].Bitangent, XMVector3Cross(XMLoadFloat3(&aAxes[i]), tangent));
+        }
+
+        QuantizationBounds bounds = ComputeQuantizationBounds(aVertices.data(), uNumVertices);
+        std::vector<QuantizedVertex> aQuantized(uNumVertices);
+        QuantizeVertices(aVertices.data(), aNormalData.data(), uNumVertices, bounds, aQuantized.data());
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            SimpleVertex decoded;
+            NormalData decodedNormalData;
+            DequantizeVertex(aQuantized[i], bounds, decoded, decodedNormalData);
+
+            BOOL bPassed =
+                CHECK(dot(decoded.Normal, aVertices[i].Normal) >= cosineOfDegrees(NORMAL_DEGREES)) &&
+                CHECK(dot(decodedNormalData.Tangent, aNormalData[i].Tangent) >= cosineOfDegrees(TANGENT_DEGREES)) &&
+                CHECK_NEAR(dot(decodedNormalData.Tangent, decoded.Normal), 0.0f, 1e-5f) &&
+                CHECK_NEAR(dot(decodedNormalData.Tangent, decodedNormalData.Tangent), 1.0f, 1e-5f) &&
+                CHECK(dot(decodedNormalData.Bitangent, aNormalData[i].Bitangent) > 0.99f);
+            if (!bPassed)
+            {
+                return;
+            }
+        }
+    }
+
+    // Vertices without tangents still decode to a unit frame
+    TEST_CASE(QuantizeVertices_MissingTangents)
+    {
+        SimpleVertex vertex = {};
+        vertex.Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+        QuantizationBounds bounds = ComputeQuantizationBounds(&vertex, 1u);
+
+        QuantizedVertex quantized;
+        QuantizeVertices(&vertex, nullptr, 1u, bounds, &quantized);
+
+        SimpleVertex decoded;
+        NormalData decodedNormalData;
+        DequantizeVertex(quantized, bounds, decoded, decodedNormalData);
+        CHECK(dot(decoded.Normal, vertex.Normal) >= cosineOfDegrees(NORMAL_DEGREES));
+        CHECK_NEAR(dot(decodedNormalData.Tangent, decodedNormalData.Tangent), 1.0f, 1e-5f);
+        CHECK_NEAR(dot(decodedNormalData.Bitangent, decodedNormalData.Bitangent), 1.0f, 1e-5f);
+    }
+}
@@ -0,0 +1,144 @@
+#include "TestFramework.h"
+
+#include "Renderer/Bounds.h"
+#include "Renderer/DataTypes.h"
+
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // Interleaved vertices, so the stride is not sizeof(XMFLOAT3)
+        std::vector<SimpleVertex> createVertices(_In_ UINT uNumVertices, _In_ UINT uSeed)
+        {
+            std::mt19937 generator(uSeed);
+            std::uniform_real_distribution<FLOAT> distribution(-1.0f, 1.0f);
+
+            std::vector<SimpleVertex> aVertices(uNumVertices);
+            for (SimpleVertex& vertex : aVertices)
+            {
+                vertex.Position = XMFLOAT3(distribution(generator) * 30.0f + 7.0f, distribution(generator) * 2.0f, distribution(generator) * 0.5f - 100.0f);
+            }
+            return aVertices;
+        }
+
+        void bruteForceMinMax(_In_ const std::vector<SimpleVertex>& aVertices, _Out_ XMFLOAT3& outMin, _Out_ XMFLOAT3& outMax)
+        {
+            outMin = outMax = aVertices[0].Position;
+            for (const SimpleVertex& vertex : aVertices)
+            {
+                outMin = XMFLOAT3(std::min(outMin.x, vertex.Position.x), std::min(outMin.y, vertex.Position.y), std::min(outMin.z, vertex.Position.z));
+                outMax = XMFLOAT3(std::max(outMax.x, vertex.Position.x), std::max(outMax.y, vertex.Position.y), std::max(outMax.z, vertex.Position.z));
+            }
+        }
+
+        BOOL checkBox(_In_ const BoundingBox& box, _In_ const XMFLOAT3& minimum, _In_ const XMFLOAT3& maximum)
+        {
+            constexpr const FLOAT TOLERANCE = 1e-4f;
+            return CHECK_NEAR(box.Center.x - box.Extents.x, minimum.x, TOLERANCE) &&
+                CHECK_NEAR(box.Center.y - box.Extents.y, minimum.y, TOLERANCE) &&
+                CHECK_NEAR(box.Center.z - box.Extents.z, minimum.z, TOLERANCE) &&
+                CHECK_NEAR(box.Center.x + box.Extents.x, maximum.x, TOLERANCE) &&
+                CHECK_NEAR(box.Center.y + box.Extents.y, maximum.y, TOLERANCE) &&
+                CHECK_NEAR(box.Center.z + box.Extents.z, maximum.z, TOLERANCE);
+        }
+    }
+
+    // The unrolled reduction matches a plain loop for counts around its
+    // four accumulators and with an interleaved stride
+    TEST_CASE(ComputeBoundingBox_MatchesBruteForce)
+    {
+        for (UINT uNumVertices : { 1u, 3u, 4u, 5u, 7u, 8u, 1001u })
+        {
+            std::vector<SimpleVertex> aVertices = createVertices(uNumVertices, 37u + uNumVertices);
+            XMFLOAT3 minimum;
+            XMFLOAT3 maximum;
+            bruteForceMinMax(aVertices, minimum, maximum);
+
+            BoundingBox box = ComputeBoundingBox(&aVertices[0].Position, sizeof(SimpleVertex), uNumVertices);
+            if (!checkBox(box, minimum, maximum))
+            {
+                break;
+            }
+        }
+
+        BoundingBox empty = ComputeBoundingBox(nullptr, sizeof(XMFLOAT3), 0u);
+        CHECK(empty.Extents.x == 0.0f && empty.Extents.y == 0.0f && empty.Extents.z == 0.0f);
+    }
+
+    // The sphere is the farthest vertex from the given center, so every
+    // vertex is inside and one is on its surface
+    TEST_CASE(ComputeBoundingSphere_MatchesBruteForce)
+    {
+        for (UINT uNumVertices : { 1u, 4u, 6u, 1001u })
+        {
+            std::vector<SimpleVertex> aVertices = createVertices(uNumVertices, 370u + uNumVertices);
+            BoundingBox box = ComputeBoundingBox(&aVertices[0].Position, sizeof(SimpleVertex), uNumVertices);
+            BoundingSphere sphere = ComputeBoundingSphere(&aVertices[0].Position, sizeof(SimpleVertex), uNumVertices, box.Center);
+
+            FLOAT maxDistance = 0.0f;
+            for (const SimpleVertex& vertex : aVertices)
+            {
+                maxDistance = std::max(maxDistance, XMVectorGetX(XMVector3Length(XMLoadFloat3(&vertex.Position) - XMLoadFloat3(&box.Center))));
+            }
+            CHECK_NEAR(sphere.Radius, maxDistance, 1e-4f);
+
+            // Never larger than the sphere around the box
+            CHECK(sphere.Radius <= XMVectorGetX(XMVector3Length(XMLoadFloat3(&box.Extents))) + 1e-4f);
+        }
+    }
+
+    // The merged box is the box of all corners of the merged boxes
+    TEST_CASE(MergeBoundingBoxes_MatchesBruteForce)
+    {
+        std::mt19937 generator(3700u);
+        std::uniform_real_distribution<FLOAT> distribution(-10.0f, 10.0f);
+
+        std::vector<BoundingBox> aBoxes;
+        std::vector<SimpleVertex> aCorners;
+        for (UINT i = 0u; i < 9u; ++i)
+        {
+            XMFLOAT3 center(distribution(generator), distribution(generator), distribution(generator));
+            XMFLOAT3 extents(std::abs(distribution(generator)), std::abs(distribution(generator)), 0.0f);
+            aBoxes.push_back(BoundingBox(center, extents));
+
+            XMFLOAT3 aBoxCorners[BoundingBox::CORNER_COUNT];
+            aBoxes.back().GetCorners(aBoxCorners);
+            for (const XMFLOAT3& corner : aBoxCorners)
+            {
+                aCorners.push_back({ .Position = corner, .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, 0.0f) });
+            }
+        }
+
+        XMFLOAT3 minimum;
+        XMFLOAT3 maximum;
+        bruteForceMinMax(aCorners, minimum, maximum);
+        checkBox(MergeBoundingBoxes(aBoxes.data(), static_cast<UINT>(aBoxes.size())), minimum, maximum);
+
+        BoundingBox single = MergeBoundingBoxes(aBoxes.data(), 1u);
+        CHECK(single.Center.x == aBoxes[0].Center.x && single.Extents.y == aBoxes[0].Extents.y);
+
+        BoundingBox empty = MergeBoundingBoxes(nullptr, 0u);
+        CHECK(empty.Extents.x == 0.0f && empty.Extents.y == 0.0f && empty.Extents.z == 0.0f);
+    }
+
+    // A sphere's screen size is its radius over the distance, scaled by
+    // the projection, and stays finite with the eye at the center
+    TEST_CASE(ComputeScreenSize_ProjectedRadius)
+    {
+        BoundingSphere sphere(XMFLOAT3(0.0f, 0.0f, 10.0f), 2.0f);
+        FLOAT projectionScale = 1.0f / std::tan(XMConvertToRadians(30.0f));
+
+        CHECK_NEAR(ComputeScreenSize(sphere, XMVectorZero(), projectionScale), 0.2f * projectionScale, 1e-5f);
+        CHECK_NEAR(ComputeScreenSize(sphere, XMVectorSet(0.0f, 0.0f, 30.0f, 1.0f), projectionScale), 0.1f * projectionScale, 1e-5f);
+
+        // Brute force: the projected half height of the sphere seen head on
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 1.0f, 0.1f, 100.0f);
+        XMVECTOR top = XMVector3TransformCoord(XMVectorSet(0.0f, 2.0f, 10.0f, 1.0f), projection);
+        CHECK_NEAR(ComputeScreenSize(sphere, XMVectorZero(), projectionScale), XMVectorGetY(top), 1e-5f);
+
+        FLOAT size = ComputeScreenSize(sphere, XMLoadFloat3(&sphere.Center), projectionScale);
+        CHECK(std::isfinite(size) && size > 1.0f);
+    }
+}
@@ -0,0 +1,189 @@
+#include "TestFramework.h"
+
+#include "Renderer/TangentSpace.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        // Unit sphere with u around the y axis and v from the top down,
+        // the normal is the position
+        void createSphere(_In_ UINT uSlices, _In_ UINT uStacks, _Out_ std::vector<SimpleVertex>& outVertices, _Out_ std::vector<WORD>& outIndices)
+        {
+            outVertices.clear();
+            outIndices.clear();
+            for (UINT uStack = 0u; uStack <= uStacks; ++uStack)
+            {
+                FLOAT v = static_cast<FLOAT>(uStack) / static_cast<FLOAT>(uStacks);
+                for (UINT uSlice = 0u; uSlice <= uSlices; ++uSlice)
+                {
+                    FLOAT u = static_cast<FLOAT>(uSlice) / static_cast<FLOAT>(uSlices);
+                    FLOAT phi = XM_PI * v;
+                    FLOAT theta = XM_2PI * u;
+                    XMFLOAT3 position(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                    outVertices.push_back({ .Position = position, .TexCoord = XMFLOAT2(u, v), .Normal = position });
+                }
+            }
+            for (UINT uStack = 0u; uStack < uStacks; ++uStack)
+            {
+                for (UINT uSlice = 0u; uSlice < uSlices; ++uSlice)
+                {
+                    WORD uCorner = static_cast<WORD>(uStack * (uSlices + 1u) + uSlice);
+                    WORD uBelow = static_cast<WORD>(uCorner + uSlices + 1u);
+                    outIndices.insert(outIndices.end(), { uCorner, static_cast<WORD>(uCorner + 1u), uBelow });
+                    outIndices.insert(outIndices.end(), { static_cast<WORD>(uCorner + 1u), static_cast<WORD>(uBelow + 1u), uBelow });
+                }
+            }
+        }
+
+        std::vector<NormalData> calculate(_In_ const std::vector<SimpleVertex>& aVertices, _In_ const std::vector<WORD>& aIndices, _In_opt_ ThreadPool* pThreadPool)
+        {
+            std::vector<NormalData> aNormalData(aVertices.size());
+            CalculateTangentFrames(aVertices.data(), static_cast<UINT>(aVertices.size()), aIndices.data(), static_cast<UINT>(aIndices.size()), aNormalData.data(), pThreadPool);
+            return aNormalData;
+        }
+
+        // Whether a vertex is off the poles, where the tangent is undefined
+        BOOL isRegular(_In_ const SimpleVertex& vertex)
+        {
+            return vertex.TexCoord.y > 0.0f && vertex.TexCoord.y < 1.0f;
+        }
+    }
+
+    // Splitting the faces and vertices over workers gives exactly the
+    // single threaded result, with several grains of faces and vertices
+    TEST_CASE(CalculateTangentFrames_MatchesReference)
+    {
+        std::vector<SimpleVertex> aVertices;
+        std::vector<WORD> aIndices;
+        createSphere(96u, 48u, aVertices, aIndices);
+
+        std::vector<NormalData> aReference(aVertices.size());
+        CalculateTangentFramesReference(aVertices.data(), static_cast<UINT>(aVertices.size()), aIndices.data(), static_cast<UINT>(aIndices.size()), aReference.data());
+
+        ThreadPool threadPool(3u);
+        for (ThreadPool* pThreadPool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+        {
+            std::vector<NormalData> aNormalData = calculate(aVertices, aIndices, pThreadPool);
+            CHECK(std::memcmp(aNormalData.data(), aReference.data(), aReference.size() * sizeof(NormalData)) == 0);
+        }
+    }
+
+    // On a sphere the tangent follows the longitude and the bitangent
+    // the latitude, both orthogonal to the normal and to each other. The
+    // flat faces tilt them by up to half a slice, 1.4 degrees here
+    TEST_CASE(CalculateTangentFrames_FollowsTextureSpace)
+    {
+        std::vector<SimpleVertex> aVertices;
+        std::vector<WORD> aIndices;
+        createSphere(128u, 64u, aVertices, aIndices);
+        std::vector<NormalData> aNormalData = calculate(aVertices, aIndices, nullptr);
+
+        const FLOAT minCosine = std::cos(XMConvertToRadians(1.5f));
+        for (SIZE_T i = 0u; i < aVertices.size(); ++i)
+        {
+            const SimpleVertex& vertex = aVertices[i];
+            XMVECTOR normal = XMLoadFloat3(&vertex.Normal);
+            XMVECTOR tangent = XMLoadFloat3(&aNormalData[i].Tangent);
+            XMVECTOR bitangent = XMLoadFloat3(&aNormalData[i].Bitangent);
+
+            BOOL bOrthonormal = CHECK_NEAR(XMVectorGetX(XMVector3Length(tangent)), 1.0f, 1e-4f) &&
+                CHECK_NEAR(XMVectorGetX(XMVector3Length(bitangent)), 1.0f, 1e-4f) &&
+                CHECK_NEAR(XMVectorGetX(XMVector3Dot(tangent, normal)), 0.0f, 1e-4f) &&
+                CHECK_NEAR(XMVectorGetX(XMVector3Dot(bitangent, normal)), 0.0f, 1e-4f) &&
+                CHECK_NEAR(XMVectorGetX(XMVector3Dot(tangent, bitangent)), 0.0f, 1e-4f);
+            if (!bOrthonormal)
+            {
+                break;
+            }
+            if (!isRegular(vertex))
+            {
+                continue;
+            }
+
+            FLOAT phi = XM_PI * vertex.TexCoord.y;
+            FLOAT theta = XM_2PI * vertex.TexCoord.x;
+            XMVECTOR expectedTangent = XMVectorSet(-std::sin(theta), 0.0f, std::cos(theta), 0.0f);
+            XMVECTOR expectedBitangent = XMVectorSet(std::cos(phi) * std::cos(theta), -std::sin(phi), std::cos(phi) * std::sin(theta), 0.0f);
+            if (!CHECK(XMVectorGetX(XMVector3Dot(tangent, expectedTangent)) > minCosine) ||
+                !CHECK(XMVectorGetX(XMVector3Dot(bitangent, expectedBitangent)) > minCosine))
+            {
+                break;
+            }
+        }
+    }
+
+    // Mirroring u reverses the tangent and the handedness of the frame,
+    // the bitangent stays
+    TEST_CASE(CalculateTangentFrames_MirroredTexCoords)
+    {
+        std::vector<SimpleVertex> aVertices;
+        std::vector<WORD> aIndices;
+        createSphere(32u, 16u, aVertices, aIndices);
+        std::vector<NormalData> aNormalData = calculate(aVertices, aIndices, nullptr);
+
+        std::vector<SimpleVertex> aMirroredVertices = aVertices;
+        for (SimpleVertex& vertex : aMirroredVertices)
+        {
+            vertex.TexCoord.x = 1.0f - vertex.TexCoord.x;
+        }
+        std::vector<NormalData> aMirroredNormalData = calculate(aMirroredVertices, aIndices, nullptr);
+
+        for (SIZE_T i = 0u; i < aVertices.size(); ++i)
+        {
+            if (!isRegular(aVertices[i]))
+            {
+                continue;
+            }
+
+            XMVECTOR normal = XMLoadFloat3(&aVertices[i].Normal);
+            FLOAT handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(normal, XMLoadFloat3(&aNormalData[i].Tangent)), XMLoadFloat3(&aNormalData[i].Bitangent)));
+            FLOAT mirroredHandedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(normal, XMLoadFloat3(&aMirroredNormalData[i].Tangent)), XMLoadFloat3(&aMirroredNormalData[i].Bitangent)));
+            BOOL bMirrored = CHECK(handedness * mirroredHandedness < 0.0f) &&
+                CHECK_NEAR(XMVectorGetX(XMVector3Dot(XMLoadFloat3(&aNormalData[i].Tangent), XMLoadFloat3(&aMirroredNormalData[i].Tangent))), -1.0f, 1e-4f) &&
+                CHECK_NEAR(XMVectorGetX(XMVector3Dot(XMLoadFloat3(&aNormalData[i].Bitangent), XMLoadFloat3(&aMirroredNormalData[i].Bitangent))), 1.0f, 1e-4f);
+            if (!bMirrored)
+            {
+                break;
+            }
+        }
+    }
+
+    // Every face adds to its vertices, none overwrites them, so the frames
+    // do not depend on the order of the faces beyond rounding
+    TEST_CASE(CalculateTangentFrames_IndependentOfFaceOrder)
+    {
+        std::vector<SimpleVertex> aVertices;
+        std::vector<WORD> aIndices;
+        createSphere(32u, 16u, aVertices, aIndices);
+        std::vector<NormalData> aNormalData = calculate(aVertices, aIndices, nullptr);
+
+        std::vector<UINT> aFaces(aIndices.size() / 3u);
+        for (UINT i = 0u; i < aFaces.size(); ++i)
+        {
+            aFaces[i] = i;
+        }
+        std::shuffle(aFaces.begin(), aFaces.end(), std::mt19937(38u));
+
+        std::vector<WORD> aShuffledIndices;
+        for (UINT uFace : aFaces)
+        {
+            aShuffledIndices.insert(aShuffledIndices.end(), aIndices.begin() + uFace * 3u, aIndices.begin() + uFace * 3u + 3u);
+        }
+        std::vector<NormalData> aShuffledNormalData = calculate(aVertices, aShuffledIndices, nullptr);
+
+        for (SIZE_T i = 0u; i < aVertices.size(); ++i)
+        {
+            if (!CHECK_NEAR(XMVectorGetX(XMVector3Dot(XMLoadFloat3(&aNormalData[i].Tangent), XMLoadFloat3(&aShuffledNormalData[i].Tangent))), 1.0f, 1e-5f) ||
+                !CHECK_NEAR(XMVectorGetX(XMVector3Dot(XMLoadFloat3(&aNormalData[i].Bitangent), XMLoadFloat3(&aShuffledNormalData[i].Bitangent))), 1.0f, 1e-5f))
+            {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#include "TestFramework.h"
+
+#include "Scene/AssetManager.h"
+#include "Shader/PixelShader.h"
+
+#include <latch>
+#include <thread>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT NUM_REQUESTING_THREADS = 8u;
+        constexpr const UINT NUM_REQUESTS_PER_THREAD = 64u;
+
+        // Calls request from every thread at once and keeps every
+        // returned asset alive until all threads are done
+        template <class T>
+        std::vector<std::shared_ptr<T>> requestConcurrently(_In_ const std::function<std::shared_ptr<T>()>& request)
+        {
+            std::vector<std::shared_ptr<T>> aAssets(NUM_REQUESTING_THREADS * NUM_REQUESTS_PER_THREAD);
+            std::latch start(NUM_REQUESTING_THREADS);
+            std::vector<std::thread> aThreads;
+            for (UINT uThread = 0u; uThread < NUM_REQUESTING_THREADS; ++uThread)
+            {
+                aThreads.emplace_back(
+                    [&, uThread]()
+                    {
+                        start.arrive_and_wait();
+                        for (UINT i = 0u; i < NUM_REQUESTS_PER_THREAD; ++i)
+                        {
+                            aAssets[uThread * NUM_REQUESTS_PER_THREAD + i] = request();
+                        }
+                    }
+                );
+            }
+            for (std::thread& thread : aThreads)
+            {
+                thread.join();
+            }
+
+            return aAssets;
+        }
+    }
+
+    // Threads asking for the same texture at the same time share one
+    // texture, which was created by exactly one of them
+    TEST_CASE(AssetManager_ConcurrentTextureRequestsLoadOnce)
+    {
+        AssetManager assetManager;
+        std::vector<std::shared_ptr<Texture>> aTextures = requestConcurrently<Texture>(
+            [&]()
+            {
+                return assetManager.GetTexture(L"Content/Cube/diffuse.png");
+            }
+        );
+
+        AssetStats stats = assetManager.GetStats();
+        CHECK(stats.uNumMisses == 1u);
+        CHECK(stats.uNumHits == NUM_REQUESTING_THREADS * NUM_REQUESTS_PER_THREAD - 1u);
+        CHECK(stats.uNumTextures == 1u);
+        for (const std::shared_ptr<Texture>& texture : aTextures)
+        {
+            if (!CHECK(texture && texture == aTextures[0]))
+            {
+                break;
+            }
+        }
+    }
+
+    // Another spelling of the same path is the same request, other
+    // decoding options are a different one
+    TEST_CASE(AssetManager_TextureKeys)
+    {
+        AssetManager assetManager;
+        std::shared_ptr<Texture> texture = assetManager.GetTexture(L"Content/Cube/diffuse.png");
+
+        CHECK(assetManager.GetTexture(L"Content/Cube/../Cube/diffuse.png") == texture);
+        CHECK(assetManager.GetTexture(L"Content/Cube/diffuse.png", eTextureSamplerType::TRILINEAR_WRAP, TextureOptions{ .bForceSrgb = TRUE }) != texture);
+
+        AssetStats stats = assetManager.GetStats();
+        CHECK(stats.uNumMisses == 2u);
+        CHECK(stats.uNumHits == 1u);
+    }
+
+    // Shaders of the same file, entry point and features are shared
+    // between concurrent requests too, other features get their own
+    TEST_CASE(AssetManager_ConcurrentShaderRequestsLoadOnce)
+    {
+        AssetManager assetManager;
+        std::vector<std::shared_ptr<PixelShader>> aShaders = requestConcurrently<PixelShader>(
+            [&]()
+            {
+                return assetManager.GetShader<PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
+            }
+        );
+
+        AssetStats stats = assetManager.GetStats();
+        CHECK(stats.uNumMisses == 1u);
+        CHECK(stats.uNumShaders == 1u);
+        for (const std::shared_ptr<PixelShader>& shader : aShaders)
+        {
+            if (!CHECK(shader && shader == aShaders[0]))
+            {
+                break;
+            }
+        }
+
+        CHECK(assetManager.GetShader<PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0", SHADER_FEATURE_NORMAL_MAP) != aShaders[0]);
+    }
+
+    // The registry only holds weak references, so a request after the
+    // last user let go creates the asset again
+    TEST_CASE(AssetManager_ReloadsAfterLastRelease)
+    {
+        AssetManager assetManager;
+        std::weak_ptr<Texture> weakTexture = assetManager.GetTexture(L"Content/Cube/diffuse.png");
+        CHECK(weakTexture.expired());
+
+        std::shared_ptr<Texture> texture = assetManager.GetTexture(L"Content/Cube/diffuse.png");
+        CHECK(texture != nullptr);
+
+        AssetStats stats = assetManager.GetStats();
+        CHECK(stats.uNumMisses == 2u);
+        CHECK(stats.uNumHits == 0u);
+        CHECK(stats.uNumTextures == 1u);
+    }
+}
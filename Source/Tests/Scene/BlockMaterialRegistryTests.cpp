@@ -0,0 +1,180 @@
+#include "TestFramework.h"
+
+#include "Scene/BlockMaterialRegistry.h"
+#include "Texture/TextureArray.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT LAYER_SIZE = 8u;
+
+        eBlockType getBlockType(_In_ UINT uBlockId)
+        {
+            return static_cast<eBlockType>(static_cast<INT>(eBlockType::GRASSLAND) + static_cast<INT>(uBlockId));
+        }
+
+        // Marks every texel of a block with its id in red, so a layer
+        // tells which block it came from whatever the filter did to the
+        // other channels
+        std::vector<BYTE> createBlockImage(_In_ UINT uBlockId, _In_ UINT uSize)
+        {
+            std::vector<BYTE> aPixels(static_cast<SIZE_T>(uSize) * uSize * 4u);
+            for (UINT uTexel = 0u; uTexel < uSize * uSize; ++uTexel)
+            {
+                aPixels[uTexel * 4u] = static_cast<BYTE>(uBlockId * 16u);
+                aPixels[uTexel * 4u + 1u] = static_cast<BYTE>(uTexel * 3u);
+                aPixels[uTexel * 4u + 2u] = static_cast<BYTE>(uTexel * 7u);
+                aPixels[uTexel * 4u + 3u] = 255u;
+            }
+            return aPixels;
+        }
+
+        // A fill color per block made of 0 and 1 so it packs exactly
+        XMFLOAT4 getFillColor(_In_ UINT uBlockId)
+        {
+            return XMFLOAT4(
+                static_cast<FLOAT>(uBlockId & 1u),
+                static_cast<FLOAT>((uBlockId >> 1u) & 1u),
+                static_cast<FLOAT>((uBlockId >> 2u) & 1u),
+                static_cast<FLOAT>((uBlockId >> 3u) & 1u)
+            );
+        }
+
+        BOOL isFilled(_In_ const MipLevel& level, _In_ const XMFLOAT4& color)
+        {
+            const BYTE aTexel[] =
+            {
+                static_cast<BYTE>(color.x * 255.0f),
+                static_cast<BYTE>(color.y * 255.0f),
+                static_cast<BYTE>(color.z * 255.0f),
+                static_cast<BYTE>(color.w * 255.0f)
+            };
+            for (SIZE_T uOffset = 0u; uOffset < level.aPixels.size(); uOffset += 4u)
+            {
+                if (memcmp(level.aPixels.data() + uOffset, aTexel, sizeof(aTexel)) != 0)
+                {
+                    return FALSE;
+                }
+            }
+            return !level.aPixels.empty();
+        }
+    }
+
+    // The block types map onto the block ids 0 to NUM_BLOCK_TYPES - 1 in
+    // order, so every type has a layer and a color of its own
+    TEST_CASE(BlockMaterialRegistry_BlockIdsAreDense)
+    {
+        CHECK(static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND) == NUM_BLOCK_TYPES);
+        for (UINT uBlockId = 0u; uBlockId < NUM_BLOCK_TYPES; ++uBlockId)
+        {
+            if (!CHECK(BlockMaterialRegistry::GetBlockId(getBlockType(uBlockId)) == uBlockId))
+            {
+                break;
+            }
+        }
+    }
+
+    // Setting the material of one block type leaves the others as they
+    // were, and only a normal map turns on the normal array
+    TEST_CASE(BlockMaterialRegistry_MaterialsStayWithTheirBlock)
+    {
+        BlockMaterialRegistry registry;
+        CHECK(!registry.HasNormalMaps());
+
+        registry.SetColor(eBlockType::OCEAN, XMFLOAT4(0.0f, 0.25f, 0.5f, 1.0f));
+        registry.SetTextures(eBlockType::SAND, L"Content/Sand/diffuse.png");
+        CHECK(!registry.HasNormalMaps());
+
+        registry.SetTextures(eBlockType::TAIGA, L"Content/Taiga/diffuse.png", L"Content/Taiga/normal.png");
+        CHECK(registry.HasNormalMaps());
+
+        for (UINT uBlockId = 0u; uBlockId < NUM_BLOCK_TYPES; ++uBlockId)
+        {
+            eBlockType blockType = getBlockType(uBlockId);
+            const BlockMaterial& material = registry.GetMaterial(blockType);
+
+            XMFLOAT4 expectedColor = blockType == eBlockType::OCEAN ? XMFLOAT4(0.0f, 0.25f, 0.5f, 1.0f) : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+            std::filesystem::path expectedDiffusePath =
+                blockType == eBlockType::SAND ? L"Content/Sand/diffuse.png" : blockType == eBlockType::TAIGA ? L"Content/Taiga/diffuse.png" : L"";
+            std::filesystem::path expectedNormalPath = blockType == eBlockType::TAIGA ? L"Content/Taiga/normal.png" : L"";
+
+            BOOL bMatches = CHECK(memcmp(&material.Color, &expectedColor, sizeof(XMFLOAT4)) == 0) &&
+                CHECK(material.DiffusePath == expectedDiffusePath) &&
+                CHECK(material.NormalPath == expectedNormalPath);
+            if (!bMatches)
+            {
+                break;
+            }
+        }
+    }
+
+    // Packing one slice per block id puts every block in its own layer:
+    // images land unchanged in the top mip of their layer, a smaller
+    // image is resampled into it and blocks without one get their fill
+    // color down the whole chain
+    TEST_CASE(BlockMaterialRegistry_PacksEveryBlockIntoItsLayer)
+    {
+        const UINT aTexturedBlockIds[] = { 0u, 3u, 7u, 14u };
+        const UINT uResampledBlockId = 7u;
+
+        std::vector<std::vector<BYTE>> aImages(NUM_BLOCK_TYPES);
+        std::vector<TextureArraySlice> aSlices(NUM_BLOCK_TYPES);
+        for (UINT uBlockId = 0u; uBlockId < NUM_BLOCK_TYPES; ++uBlockId)
+        {
+            aSlices[uBlockId] = { .pPixels = nullptr, .uWidth = 0u, .uHeight = 0u, .FillColor = getFillColor(uBlockId) };
+        }
+        for (UINT uBlockId : aTexturedBlockIds)
+        {
+            UINT uSize = uBlockId == uResampledBlockId ? LAYER_SIZE / 2u : LAYER_SIZE;
+            aImages[uBlockId] = createBlockImage(uBlockId, uSize);
+            aSlices[uBlockId].pPixels = aImages[uBlockId].data();
+            aSlices[uBlockId].uWidth = uSize;
+            aSlices[uBlockId].uHeight = uSize;
+        }
+
+        TextureArrayImage image;
+        if (!CHECK(SUCCEEDED(PackTextureArray(eMipFormat::RGBA8_UNORM, aSlices, LAYER_SIZE, LAYER_SIZE, DEFAULT_MIP_CHAIN_OPTIONS, nullptr, image))))
+        {
+            return;
+        }
+        if (!CHECK(image.uArraySize == NUM_BLOCK_TYPES) || !CHECK(image.uMipLevels == 4u) ||
+            !CHECK(image.aSubresources.size() == NUM_BLOCK_TYPES * image.uMipLevels))
+        {
+            return;
+        }
+
+        for (UINT uBlockId = 0u; uBlockId < NUM_BLOCK_TYPES; ++uBlockId)
+        {
+            const MipLevel* pLayer = &image.aSubresources[uBlockId * image.uMipLevels];
+            for (UINT uMip = 0u; uMip < image.uMipLevels; ++uMip)
+            {
+                CHECK(pLayer[uMip].uWidth == LAYER_SIZE >> uMip && pLayer[uMip].uHeight == LAYER_SIZE >> uMip);
+            }
+
+            if (!aSlices[uBlockId].pPixels)
+            {
+                for (UINT uMip = 0u; uMip < image.uMipLevels; ++uMip)
+                {
+                    CHECK(isFilled(pLayer[uMip], aSlices[uBlockId].FillColor));
+                }
+                continue;
+            }
+
+            if (uBlockId != uResampledBlockId)
+            {
+                CHECK(pLayer[0].aPixels == aImages[uBlockId]);
+            }
+            for (UINT uMip = 0u; uMip < image.uMipLevels; ++uMip)
+            {
+                for (SIZE_T uOffset = 0u; uOffset < pLayer[uMip].aPixels.size(); uOffset += 4u)
+                {
+                    if (!CHECK_NEAR(pLayer[uMip].aPixels[uOffset], uBlockId * 16.0f, 1.0f))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
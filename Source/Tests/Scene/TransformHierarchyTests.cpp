@@ -0,0 +1,209 @@
+#include "TestFramework.h"
+
+#include "Scene/TransformHierarchy.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT NUM_CHILDREN = 4u;
+
+        XMFLOAT3 getWorldPosition(_In_ const TransformHierarchy& hierarchy, _In_ UINT uNode)
+        {
+            XMFLOAT3 position;
+            XMStoreFloat3(&position, XMVector3Transform(XMVectorZero(), hierarchy.GetWorldMatrix(uNode)));
+            return position;
+        }
+
+        BOOL checkPosition(_In_ const TransformHierarchy& hierarchy, _In_ UINT uNode, _In_ const XMFLOAT3& expected)
+        {
+            XMFLOAT3 position = getWorldPosition(hierarchy, uNode);
+            return CHECK_NEAR(position.x, expected.x, 1e-4) && CHECK_NEAR(position.y, expected.y, 1e-4) && CHECK_NEAR(position.z, expected.z, 1e-4);
+        }
+
+        BOOL checkMatrix(_In_ FXMMATRIX actual, _In_ CXMMATRIX expected)
+        {
+            XMFLOAT4X4 actualValues;
+            XMFLOAT4X4 expectedValues;
+            XMStoreFloat4x4(&actualValues, actual);
+            XMStoreFloat4x4(&expectedValues, expected);
+            for (UINT uRow = 0u; uRow < 4u; ++uRow)
+            {
+                for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+                {
+                    if (!CHECK_NEAR(actualValues.m[uRow][uColumn], expectedValues.m[uRow][uColumn], 1e-4))
+                    {
+                        return FALSE;
+                    }
+                }
+            }
+            return TRUE;
+        }
+
+        // Node i > 0 is a child of (i - 1) / NUM_CHILDREN, each one step
+        // along x from its parent
+        void buildTree(_Inout_ TransformHierarchy& hierarchy, _In_ UINT uNumNodes)
+        {
+            for (UINT i = 0u; i < uNumNodes; ++i)
+            {
+                UINT uNode = hierarchy.AddNode(i == 0u ? TransformHierarchy::INVALID_NODE : static_cast<INT>((i - 1u) / NUM_CHILDREN));
+                hierarchy.SetTranslation(uNode, XMFLOAT3(1.0f, 0.0f, 0.0f));
+            }
+        }
+    }
+
+    // A child's world transform is its local one in the space of its
+    // parent, even when the child was added before the parent
+    TEST_CASE(TransformHierarchy_ComposesParentBeforeChild)
+    {
+        TransformHierarchy hierarchy;
+        UINT uChild = hierarchy.AddNode();
+        UINT uRoot = hierarchy.AddNode();
+        REQUIRE(SUCCEEDED(hierarchy.SetParent(uChild, static_cast<INT>(uRoot))));
+
+        // A quarter turn about y takes the child's x offset to -z
+        hierarchy.SetTranslation(uRoot, XMFLOAT3(10.0f, 0.0f, 0.0f));
+        hierarchy.SetRotation(uRoot, XMFLOAT4(0.0f, 0.70710678f, 0.0f, 0.70710678f));
+        hierarchy.SetScale(uRoot, XMFLOAT3(2.0f, 2.0f, 2.0f));
+        hierarchy.SetTranslation(uChild, XMFLOAT3(1.0f, 0.0f, 0.0f));
+        hierarchy.Update();
+
+        CHECK(hierarchy.GetNumUpdatedNodes() == 2u);
+        CHECK(hierarchy.GetParent(uChild) == static_cast<INT>(uRoot) && hierarchy.GetParent(uRoot) == TransformHierarchy::INVALID_NODE);
+        checkPosition(hierarchy, uRoot, XMFLOAT3(10.0f, 0.0f, 0.0f));
+        checkPosition(hierarchy, uChild, XMFLOAT3(10.0f, 0.0f, -2.0f));
+    }
+
+    // Only the dirty nodes and their descendants are recomputed, and a
+    // matrix equal to the current local one changes nothing
+    TEST_CASE(TransformHierarchy_UpdatesOnlyDirtySubtrees)
+    {
+        // 1 + 4 + 16 nodes, each node on the second level has 4 children
+        TransformHierarchy hierarchy;
+        buildTree(hierarchy, 21u);
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 21u);
+        checkPosition(hierarchy, 20u, XMFLOAT3(3.0f, 0.0f, 0.0f));
+
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 0u);
+
+        hierarchy.SetTranslation(1u, XMFLOAT3(0.0f, 1.0f, 0.0f));
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 5u);
+        checkPosition(hierarchy, 5u, XMFLOAT3(2.0f, 1.0f, 0.0f));
+        checkPosition(hierarchy, 9u, XMFLOAT3(3.0f, 0.0f, 0.0f));
+
+        hierarchy.SetScale(2u, XMFLOAT3(1.0f, 1.0f, 1.0f));
+        hierarchy.SetScale(20u, XMFLOAT3(1.0f, 1.0f, 1.0f));
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 6u);
+
+        hierarchy.SetLocalMatrix(3u, XMMatrixTranslation(1.0f, 0.0f, 0.0f));
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 0u);
+
+        hierarchy.SetLocalMatrix(3u, XMMatrixTranslation(1.0f, 0.0f, 5.0f));
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 5u);
+        checkPosition(hierarchy, 13u, XMFLOAT3(3.0f, 0.0f, 5.0f));
+    }
+
+    // A parent rotated and then scaled along its parent's axes is
+    // sheared, no scale, rotate and translate transform reproduces it.
+    // The matrix is kept as given and its children are placed by it
+    TEST_CASE(TransformHierarchy_KeepsShearOfLocalMatrices)
+    {
+        TransformHierarchy hierarchy;
+        UINT uRoot = hierarchy.AddNode();
+        UINT uParent = hierarchy.AddNode(static_cast<INT>(uRoot));
+        UINT uChild = hierarchy.AddNode(static_cast<INT>(uParent));
+
+        XMMATRIX root = XMMatrixTranslation(0.0f, 0.0f, 3.0f);
+        XMMATRIX parent = XMMatrixRotationZ(XM_PIDIV4) * XMMatrixScaling(2.0f, 1.0f, 0.5f) * XMMatrixTranslation(1.0f, 2.0f, 0.0f);
+        XMMATRIX child = XMMatrixRotationY(XM_PIDIV4) * XMMatrixTranslation(1.0f, 1.0f, 0.0f);
+        hierarchy.SetLocalMatrix(uRoot, root);
+        hierarchy.SetLocalMatrix(uParent, parent);
+        hierarchy.SetLocalMatrix(uChild, child);
+        hierarchy.Update();
+
+        CHECK(hierarchy.GetNumUpdatedNodes() == 3u);
+        checkMatrix(hierarchy.GetWorldMatrix(uParent), parent * root);
+        checkMatrix(hierarchy.GetWorldMatrix(uChild), child * parent * root);
+        checkPosition(hierarchy, uChild, XMFLOAT3(1.0f, 2.0f + 1.41421356f, 3.0f));
+
+        // The x-axis and y-axis of the parent are (sqrt(2), sqrt(2) / 2,
+        // 0) and (-sqrt(2), sqrt(2) / 2, 0), no longer perpendicular
+        XMMATRIX parentWorld = hierarchy.GetWorldMatrix(uParent);
+        CHECK_NEAR(XMVectorGetX(XMVector3Dot(parentWorld.r[0], parentWorld.r[1])), -1.5f, 1e-4);
+
+        hierarchy.SetLocalMatrix(uParent, parent);
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 0u);
+
+        // Setting a component rebuilds the matrix from the decomposition
+        hierarchy.SetTranslation(uParent, XMFLOAT3(0.0f, 0.0f, 0.0f));
+        hierarchy.Update();
+        CHECK(hierarchy.GetNumUpdatedNodes() == 2u);
+        checkPosition(hierarchy, uParent, XMFLOAT3(0.0f, 0.0f, 3.0f));
+    }
+
+    // A node can't be moved under itself or its own subtree, and a moved
+    // subtree follows its new parent
+    TEST_CASE(TransformHierarchy_ReparentsWithoutCycles)
+    {
+        TransformHierarchy hierarchy;
+        buildTree(hierarchy, 21u);
+        hierarchy.Update();
+
+        CHECK(hierarchy.SetParent(0u, 0) == E_INVALIDARG);
+        CHECK(hierarchy.SetParent(1u, 5) == E_INVALIDARG);
+        CHECK(hierarchy.SetParent(21u, 0) == E_INVALIDARG);
+        CHECK(hierarchy.SetParent(1u, 21) == E_INVALIDARG);
+        CHECK(hierarchy.GetParent(1u) == 0);
+
+        // Node 1 with its 4 children moves under node 20, 2 levels down
+        REQUIRE(SUCCEEDED(hierarchy.SetParent(1u, 20)));
+        hierarchy.Update();
+        CHECK(hierarchy.GetParent(1u) == 20);
+        checkPosition(hierarchy, 1u, XMFLOAT3(4.0f, 0.0f, 0.0f));
+        checkPosition(hierarchy, 5u, XMFLOAT3(5.0f, 0.0f, 0.0f));
+        checkPosition(hierarchy, 9u, XMFLOAT3(3.0f, 0.0f, 0.0f));
+
+        REQUIRE(SUCCEEDED(hierarchy.SetParent(1u, TransformHierarchy::INVALID_NODE)));
+        hierarchy.Update();
+        checkPosition(hierarchy, 5u, XMFLOAT3(2.0f, 0.0f, 0.0f));
+    }
+
+    // Levels large enough to be split across the pool give the same
+    // matrices as the calling thread alone
+    TEST_CASE(TransformHierarchy_PoolMatchesCallingThread)
+    {
+        const UINT uNumNodes = 1u + NUM_CHILDREN + NUM_CHILDREN * TransformHierarchy::PARALLEL_LEVEL_SIZE;
+        TransformHierarchy serialHierarchy;
+        TransformHierarchy pooledHierarchy;
+        buildTree(serialHierarchy, uNumNodes);
+        buildTree(pooledHierarchy, uNumNodes);
+        for (TransformHierarchy* pHierarchy : { &serialHierarchy, &pooledHierarchy })
+        {
+            pHierarchy->SetRotation(0u, XMFLOAT4(0.0f, 0.0998f, 0.0f, 0.995f));
+        }
+
+        ThreadPool threadPool(3u);
+        serialHierarchy.Update();
+        pooledHierarchy.Update(&threadPool);
+        CHECK(pooledHierarchy.GetNumUpdatedNodes() == uNumNodes);
+
+        for (UINT uNode = 0u; uNode < uNumNodes; ++uNode)
+        {
+            XMFLOAT4X4 serialWorld;
+            XMFLOAT4X4 pooledWorld;
+            XMStoreFloat4x4(&serialWorld, serialHierarchy.GetWorldMatrix(uNode));
+            XMStoreFloat4x4(&pooledWorld, pooledHierarchy.GetWorldMatrix(uNode));
+            if (!CHECK(memcmp(&serialWorld, &pooledWorld, sizeof(XMFLOAT4X4)) == 0))
+            {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,265 @@
+#include "TestFramework.h"
+
+#include "Shader/ShaderCache.h"
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+
+namespace library
+{
+    namespace
+    {
+        // Stands in for the D3D compiler: expands the quoted #include
+        // lines relative to the including file and returns the expanded
+        // text, after everything in the description, as the bytecode. A
+        // #error line fails the compilation
+        class TextShaderCompiler final : public ShaderCompiler
+        {
+        public:
+            HRESULT Compile(
+                _In_ const ShaderCompileDesc& desc,
+                _Out_ std::vector<BYTE>& outBytecode,
+                _Out_ std::vector<std::filesystem::path>& outIncludes,
+                _Out_ std::string& outMessages
+            ) override
+            {
+                ++m_uNumCompiles;
+                outBytecode.clear();
+                outIncludes.clear();
+                outMessages.clear();
+
+                std::string szText = desc.szEntryPoint + " " + desc.szTarget + " " + std::to_string(desc.uFlags) + "\n";
+                for (const ShaderDefine& define : desc.aDefines)
+                {
+                    szText += define.szName + "=" + define.szValue + "\n";
+                }
+
+                HRESULT hr = expand(desc.FilePath, szText, outIncludes, outMessages);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                outBytecode.assign(szText.begin(), szText.end());
+                return S_OK;
+            }
+
+            UINT GetNumCompiles() const
+            {
+                return m_uNumCompiles;
+            }
+
+        private:
+            HRESULT expand(
+                _In_ const std::filesystem::path& filePath,
+                _Inout_ std::string& szText,
+                _Inout_ std::vector<std::filesystem::path>& aIncludes,
+                _Inout_ std::string& szMessages
+            )
+            {
+                std::ifstream file(filePath);
+                if (!file.is_open())
+                {
+                    szMessages += filePath.generic_string() + ": can't open\n";
+                    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+                }
+
+                std::string szLine;
+                while (std::getline(file, szLine))
+                {
+                    if (szLine.starts_with("#error"))
+                    {
+                        szMessages += filePath.generic_string() + ": " + szLine + "\n";
+                        return E_FAIL;
+                    }
+                    if (szLine.starts_with("#include \""))
+                    {
+                        std::filesystem::path includePath = (filePath.parent_path() / szLine.substr(10u, szLine.size() - 11u)).lexically_normal();
+                        aIncludes.push_back(includePath);
+
+                        HRESULT hr = expand(includePath, szText, aIncludes, szMessages);
+                        if (FAILED(hr))
+                        {
+                            return hr;
+                        }
+                        continue;
+                    }
+                    szText += szLine + "\n";
+                }
+
+                return S_OK;
+            }
+
+        private:
+            std::atomic<UINT> m_uNumCompiles = 0u;
+        };
+
+        void writeFile(_In_ const std::filesystem::path& filePath, _In_ const std::string& szText)
+        {
+            std::filesystem::create_directories(filePath.parent_path());
+            std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+            file << szText;
+        }
+
+        // A lit pixel shader including a header from a sibling directory,
+        // in a fresh directory of its own
+        std::filesystem::path createShaders(_In_z_ PCSTR pszTestName)
+        {
+            std::filesystem::path directory = std::filesystem::temp_directory_path() / "ShaderCacheTests" / pszTestName;
+            std::error_code error;
+            std::filesystem::remove_all(directory, error);
+
+            writeFile(directory / "Common" / "Lighting.hlsli", "float4 Light() { return 1; }\n");
+            writeFile(directory / "Shaders" / "Lit.fx", "#include \"../Common/Lighting.hlsli\"\nfloat4 PSLit() { return Light(); }\n");
+            return directory;
+        }
+
+        ShaderCompileDesc createDesc(_In_ const std::filesystem::path& directory)
+        {
+            return ShaderCompileDesc
+            {
+                .FilePath = directory / "Shaders" / "Lit.fx",
+                .szEntryPoint = "PSLit",
+                .szTarget = "ps_5_0",
+                .aDefines = { {.szName = "NUM_LIGHTS", .szValue = "2" } },
+                .uFlags = 0u
+            };
+        }
+    }
+
+    // The first compilation misses and stores its entry in Cache next to
+    // the source, a new cache then loads the same bytecode without
+    // compiling, however the path to the source is spelled
+    TEST_CASE(ShaderCache_HitsAfterMiss)
+    {
+        std::filesystem::path directory = createShaders("HitsAfterMiss");
+        ShaderCompileDesc desc = createDesc(directory);
+
+        TextShaderCompiler compiler;
+        std::vector<BYTE> aBytecode;
+        {
+            ShaderCache cache(&compiler);
+            REQUIRE(SUCCEEDED(cache.Compile(desc, aBytecode)));
+
+            ShaderCacheStats stats = cache.GetStats();
+            CHECK(stats.uNumMisses == 1u && stats.uNumHits == 0u && stats.uNumStale == 0u && stats.uNumCompiled == 1u);
+            CHECK(compiler.GetNumCompiles() == 1u);
+            CHECK(GetShaderCachePath(desc).parent_path() == directory / "Shaders" / "Cache");
+            CHECK(std::filesystem::exists(GetShaderCachePath(desc)));
+        }
+
+        ShaderCache cache(&compiler);
+        for (const std::filesystem::path& filePath : { desc.FilePath, directory / "Common" / ".." / "Shaders" / "." / "Lit.fx" })
+        {
+            ShaderCompileDesc respelledDesc = desc;
+            respelledDesc.FilePath = filePath;
+
+            std::vector<BYTE> aCachedBytecode;
+            std::string szMessages = "not cleared";
+            CHECK(cache.Compile(respelledDesc, aCachedBytecode, &szMessages) == S_OK);
+            CHECK(aCachedBytecode == aBytecode && szMessages.empty());
+        }
+        CHECK(cache.GetStats().uNumHits == 2u && cache.GetStats().uNumMisses == 0u);
+        CHECK(compiler.GetNumCompiles() == 1u);
+
+        std::vector<std::filesystem::path> aIncludes;
+        CHECK(SUCCEEDED(cache.GetIncludes(desc, aIncludes)));
+        CHECK(aIncludes.size() == 1u && aIncludes[0].generic_string() == "../Common/Lighting.hlsli");
+    }
+
+    // Another entry point, target, macro value or set of flags is
+    // another entry, and each hits once compiled
+    TEST_CASE(ShaderCache_KeysOnEntryDefinesAndFlags)
+    {
+        std::filesystem::path directory = createShaders("KeysOnEntryDefinesAndFlags");
+        std::vector<ShaderCompileDesc> aDescs(5u, createDesc(directory));
+        aDescs[1].szEntryPoint = "PSLitTextured";
+        aDescs[2].szTarget = "ps_5_1";
+        aDescs[3].aDefines = { { .szName = "NUM_LIGHTS", .szValue = "4" } };
+        aDescs[4].uFlags = 1u;
+
+        TextShaderCompiler compiler;
+        ShaderCache cache(&compiler);
+        for (UINT uPass = 0u; uPass < 2u; ++uPass)
+        {
+            for (const ShaderCompileDesc& desc : aDescs)
+            {
+                std::vector<BYTE> aBytecode;
+                CHECK(SUCCEEDED(cache.Compile(desc, aBytecode)));
+            }
+        }
+
+        for (SIZE_T i = 0u; i < aDescs.size(); ++i)
+        {
+            for (SIZE_T j = i + 1u; j < aDescs.size(); ++j)
+            {
+                CHECK(ComputeShaderCacheKey(aDescs[i]) != ComputeShaderCacheKey(aDescs[j]));
+            }
+        }
+        ShaderCacheStats stats = cache.GetStats();
+        CHECK(stats.uNumMisses == aDescs.size() && stats.uNumHits == aDescs.size());
+        CHECK(compiler.GetNumCompiles() == aDescs.size());
+    }
+
+    // Editing the source or a file it includes, or damaging the entry,
+    // makes the entry stale, and the recompiled one hits again
+    TEST_CASE(ShaderCache_InvalidatesChangedSources)
+    {
+        std::filesystem::path directory = createShaders("InvalidatesChangedSources");
+        ShaderCompileDesc desc = createDesc(directory);
+
+        TextShaderCompiler compiler;
+        ShaderCache cache(&compiler);
+        std::vector<BYTE> aBytecode;
+        REQUIRE(SUCCEEDED(cache.Compile(desc, aBytecode)));
+
+        const std::function<void()> aEdits[] =
+        {
+            [&]() { writeFile(directory / "Common" / "Lighting.hlsli", "float4 Light() { return 0.5; }\n"); },
+            [&]() { writeFile(desc.FilePath, "#include \"../Common/Lighting.hlsli\"\nfloat4 PSLit() { return 2 * Light(); }\n"); },
+            [&]() { std::filesystem::resize_file(GetShaderCachePath(desc), sizeof(ShaderCacheHeader) + 4u); },
+        };
+        UINT uNumStale = 0u;
+        for (const std::function<void()>& edit : aEdits)
+        {
+            edit();
+
+            UINT uNumCompiles = compiler.GetNumCompiles();
+            CHECK(SUCCEEDED(cache.Compile(desc, aBytecode)));
+            CHECK(cache.GetStats().uNumStale == ++uNumStale);
+            CHECK(compiler.GetNumCompiles() == uNumCompiles + 1u);
+
+            CHECK(cache.Load(desc, aBytecode) == S_OK);
+            CHECK(compiler.GetNumCompiles() == uNumCompiles + 1u);
+        }
+
+        std::vector<BYTE> aExpectedBytecode;
+        std::vector<std::filesystem::path> aIncludes;
+        std::string szMessages;
+        compiler.Compile(desc, aExpectedBytecode, aIncludes, szMessages);
+        CHECK(aBytecode == aExpectedBytecode);
+    }
+
+    // A shader that doesn't compile reports its errors and leaves no
+    // entry behind, so it is compiled again next time
+    TEST_CASE(ShaderCache_DoesNotCacheFailures)
+    {
+        std::filesystem::path directory = createShaders("DoesNotCacheFailures");
+        ShaderCompileDesc desc = createDesc(directory);
+        writeFile(directory / "Common" / "Lighting.hlsli", "#error Light is not defined\n");
+
+        TextShaderCompiler compiler;
+        ShaderCache cache(&compiler);
+        for (UINT uAttempt = 1u; uAttempt <= 2u; ++uAttempt)
+        {
+            std::vector<BYTE> aBytecode;
+            std::string szMessages;
+            CHECK(FAILED(cache.Compile(desc, aBytecode, &szMessages)));
+            CHECK(szMessages.find("Light is not defined") != std::string::npos);
+            CHECK(!std::filesystem::exists(GetShaderCachePath(desc)));
+            CHECK(compiler.GetNumCompiles() == uAttempt);
+        }
+        CHECK(cache.GetStats().uNumCompiled == 0u && cache.GetStats().uNumMisses == 2u);
+    }
+}
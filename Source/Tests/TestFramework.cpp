@@ -0,0 +1,158 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace library::test
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   TestCase
+
+          Summary:  Registered test
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct TestCase
+        {
+            PCSTR pszName;
+            TestFunction pfnTest;
+        };
+
+        // Function local so registrars of other translation units can
+        // run before main in any order
+        std::vector<TestCase>& getTestCases()
+        {
+            static std::vector<TestCase> s_aTestCases;
+            return s_aTestCases;
+        }
+
+        UINT s_uNumFailedChecks = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TestRegistrar::TestRegistrar
+
+      Summary:  Constructor. Registers the test
+
+      Args:     PCSTR pszName
+                  Name of the test, the filter of RunTests matches it
+                TestFunction pfnTest
+                  Body of the test
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TestRegistrar::TestRegistrar(_In_z_ PCSTR pszName, _In_ TestFunction pfnTest)
+    {
+        getTestCases().push_back({ .pszName = pszName, .pfnTest = pfnTest });
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CheckCondition
+
+      Summary:  Counts and prints a failed check
+
+      Args:     BOOL bPassed
+                  Result of the check
+                PCSTR pszExpression
+                  Checked expression
+                PCSTR pszFile
+                  Source file of the check
+                INT iLine
+                  Line of the check
+
+      Returns:  BOOL
+                  bPassed
+    -----------------------------------------------------------------F-F*/
+    BOOL CheckCondition(_In_ BOOL bPassed, _In_z_ PCSTR pszExpression, _In_z_ PCSTR pszFile, _In_ INT iLine)
+    {
+        if (!bPassed)
+        {
+            std::printf("%s(%d): CHECK(%s) failed\n", pszFile, iLine, pszExpression);
+            ++s_uNumFailedChecks;
+        }
+        return bPassed;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CheckNear
+
+      Summary:  Checks that a value is within a tolerance of the
+                expected one, printing both when it is not
+
+      Args:     DOUBLE actual
+                  Computed value
+                DOUBLE expected
+                  Expected value
+                DOUBLE tolerance
+                  Largest accepted absolute difference
+                PCSTR pszExpression
+                  Checked expressions
+                PCSTR pszFile
+                  Source file of the check
+                INT iLine
+                  Line of the check
+
+      Returns:  BOOL
+                  TRUE if the check passed
+    -----------------------------------------------------------------F-F*/
+    BOOL CheckNear(
+        _In_ DOUBLE actual,
+        _In_ DOUBLE expected,
+        _In_ DOUBLE tolerance,
+        _In_z_ PCSTR pszExpression,
+        _In_z_ PCSTR pszFile,
+        _In_ INT iLine
+    )
+    {
+        // Written so that NaN fails
+        BOOL bPassed = std::fabs(actual - expected) <= tolerance;
+        if (!bPassed)
+        {
+            std::printf("%s(%d): CHECK_NEAR(%s) failed, %.9g vs %.9g, tolerance %.3g\n", pszFile, iLine, pszExpression, actual, expected, tolerance);
+            ++s_uNumFailedChecks;
+        }
+        return bPassed;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: RunTests
+
+      Summary:  Runs the registered tests whose name contains the filter
+
+      Args:     PCSTR pszFilter
+                  Part of the names of the tests to run, nullptr runs
+                  every test
+
+      Returns:  INT
+                  Number of failed tests
+    -----------------------------------------------------------------F-F*/
+    INT RunTests(_In_opt_z_ PCSTR pszFilter)
+    {
+        UINT uNumRun = 0u;
+        UINT uNumFailed = 0u;
+        for (const TestCase& testCase : getTestCases())
+        {
+            if (pszFilter && !std::strstr(testCase.pszName, pszFilter))
+            {
+                continue;
+            }
+
+            UINT uNumFailedChecks = s_uNumFailedChecks;
+            testCase.pfnTest();
+            ++uNumRun;
+
+            if (s_uNumFailedChecks != uNumFailedChecks)
+            {
+                std::printf("[  FAILED  ] %s\n", testCase.pszName);
+                ++uNumFailed;
+            }
+            else
+            {
+                std::printf("[       OK ] %s\n", testCase.pszName);
+            }
+            std::fflush(stdout);
+        }
+
+        std::printf("%u of %u tests passed\n", uNumRun - uNumFailed, uNumRun);
+        return static_cast<INT>(uNumFailed);
+    }
+}
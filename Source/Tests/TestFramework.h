@@ -0,0 +1,64 @@
+/*+===================================================================
+  File:      TESTFRAMEWORK.H
+
+  Summary:   TestFramework header file contains the macros that
+             register and check the unit tests of the library, and
+             declarations of the functions that run them.
+
+  Classes: TestRegistrar
+
+  Functions: CheckCondition, CheckNear, RunTests
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library::test
+{
+    using TestFunction = void (*)();
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TestRegistrar
+
+      Summary:  Adds a test to the list RunTests goes through. One
+                static instance per test, created by TEST_CASE
+
+      Methods:  TestRegistrar
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TestRegistrar final
+    {
+    public:
+        TestRegistrar(_In_z_ PCSTR pszName, _In_ TestFunction pfnTest);
+    };
+
+    BOOL CheckCondition(_In_ BOOL bPassed, _In_z_ PCSTR pszExpression, _In_z_ PCSTR pszFile, _In_ INT iLine);
+    BOOL CheckNear(
+        _In_ DOUBLE actual,
+        _In_ DOUBLE expected,
+        _In_ DOUBLE tolerance,
+        _In_z_ PCSTR pszExpression,
+        _In_z_ PCSTR pszFile,
+        _In_ INT iLine
+    );
+
+    INT RunTests(_In_opt_z_ PCSTR pszFilter);
+}
+
+// Defines and registers a test, the body follows the macro
+#define TEST_CASE(Name) \
+    static void Name(); \
+    static const ::library::test::TestRegistrar s_##Name##Registrar(#Name, Name); \
+    static void Name()
+
+// Record a failure and keep going, both return whether the check passed
+#define CHECK(Expression) \
+    ::library::test::CheckCondition(static_cast<BOOL>(!!(Expression)), #Expression, __FILE__, __LINE__)
+#define CHECK_NEAR(Actual, Expected, Tolerance) \
+    ::library::test::CheckNear(static_cast<DOUBLE>(Actual), static_cast<DOUBLE>(Expected), static_cast<DOUBLE>(Tolerance), #Actual " ~ " #Expected, __FILE__, __LINE__)
+
+// Records a failure and leaves the test
+#define REQUIRE(Expression) \
+    do { if (!CHECK(Expression)) { return; } } while (false)
@@ -0,0 +1,214 @@
+#include "TestFramework.h"
+
+#include "Texture/BlockCompression.h"
+#include "Utility/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        typedef std::array<BYTE, BC_BLOCK_NUM_PIXELS * 4u> RgbaBlock;
+
+        RgbaBlock roundTrip(_In_ eCompressedFormat format, _In_ const RgbaBlock& aRgba)
+        {
+            BYTE aBlock[16];
+            RgbaBlock aDecoded;
+            EncodeBlock(format, aRgba.data(), aBlock);
+            DecodeBlock(format, aBlock, aDecoded.data());
+            return aDecoded;
+        }
+
+        // Largest difference over the channels [uFirstChannel,
+        // uFirstChannel + uNumChannels) of every pixel
+        INT getMaxError(_In_ const BYTE* pExpected, _In_ const BYTE* pActual, _In_ UINT uNumPixels, _In_ UINT uFirstChannel, _In_ UINT uNumChannels)
+        {
+            INT iMaxError = 0;
+            for (UINT i = 0u; i < uNumPixels; ++i)
+            {
+                for (UINT c = uFirstChannel; c < uFirstChannel + uNumChannels; ++c)
+                {
+                    iMaxError = std::max(iMaxError, std::abs(static_cast<INT>(pExpected[i * 4u + c]) - static_cast<INT>(pActual[i * 4u + c])));
+                }
+            }
+            return iMaxError;
+        }
+
+        // Colors on a line ramping along x and alpha ramping along y,
+        // content a single pair of endpoints fits
+        RgbaBlock createGradientBlock(_In_ UINT uSeed)
+        {
+            std::mt19937 generator(uSeed);
+            std::uniform_int_distribution<INT> distribution(0, 255);
+            INT aStart[4] = { distribution(generator), distribution(generator), distribution(generator), distribution(generator) };
+            INT aEnd[4] = { distribution(generator), distribution(generator), distribution(generator), distribution(generator) };
+
+            RgbaBlock aRgba;
+            for (UINT i = 0u; i < BC_BLOCK_NUM_PIXELS; ++i)
+            {
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    UINT uStep = c < 3u ? i % BC_BLOCK_SIZE : i / BC_BLOCK_SIZE;
+                    aRgba[i * 4u + c] = static_cast<BYTE>(aStart[c] + (aEnd[c] - aStart[c]) * static_cast<INT>(uStep) / 3);
+                }
+            }
+            return aRgba;
+        }
+
+        // Smooth RGBA image, sums of low frequency waves per channel
+        std::vector<BYTE> createSmoothImage(_In_ UINT uWidth, _In_ UINT uHeight)
+        {
+            std::vector<BYTE> aRgba(static_cast<SIZE_T>(uWidth) * uHeight * 4u);
+            for (UINT y = 0u; y < uHeight; ++y)
+            {
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    for (UINT c = 0u; c < 4u; ++c)
+                    {
+                        FLOAT value = 0.5f + 0.25f * std::sin(static_cast<FLOAT>(x) * (0.05f + 0.02f * c)) + 0.25f * std::cos(static_cast<FLOAT>(y) * (0.07f - 0.01f * c));
+                        aRgba[(static_cast<SIZE_T>(y) * uWidth + x) * 4u + c] = static_cast<BYTE>(value * 255.0f + 0.5f);
+                    }
+                }
+            }
+            return aRgba;
+        }
+    }
+
+    // A block of one color comes back within the endpoint precision:
+    // 5:6:5 for BC1 and BC3 colors, exact for the 8 bit alpha and BC5
+    // channels
+    TEST_CASE(BlockCompression_RoundTripsSolidBlocks)
+    {
+        std::mt19937 generator(40u);
+        for (UINT i = 0u; i < 64u; ++i)
+        {
+            RgbaBlock aRgba;
+            BYTE aColor[4] = { static_cast<BYTE>(generator()), static_cast<BYTE>(generator()), static_cast<BYTE>(generator()), static_cast<BYTE>(generator()) };
+            for (UINT j = 0u; j < BC_BLOCK_NUM_PIXELS; ++j)
+            {
+                std::memcpy(&aRgba[j * 4u], aColor, 4u);
+            }
+            // BC1 keeps alpha as a single bit
+            RgbaBlock aOpaque = aRgba;
+            for (UINT j = 0u; j < BC_BLOCK_NUM_PIXELS; ++j)
+            {
+                aOpaque[j * 4u + 3u] = 255u;
+            }
+
+            RgbaBlock aBc1 = roundTrip(eCompressedFormat::BC1, aOpaque);
+            RgbaBlock aBc3 = roundTrip(eCompressedFormat::BC3, aRgba);
+            RgbaBlock aBc5 = roundTrip(eCompressedFormat::BC5, aRgba);
+            BOOL bPassed = CHECK(getMaxError(aOpaque.data(), aBc1.data(), BC_BLOCK_NUM_PIXELS, 0u, 4u) <= 4) &&
+                CHECK(getMaxError(aRgba.data(), aBc3.data(), BC_BLOCK_NUM_PIXELS, 0u, 3u) <= 4) &&
+                CHECK(getMaxError(aRgba.data(), aBc3.data(), BC_BLOCK_NUM_PIXELS, 3u, 1u) == 0) &&
+                CHECK(getMaxError(aRgba.data(), aBc5.data(), BC_BLOCK_NUM_PIXELS, 0u, 2u) == 0);
+            if (!bPassed)
+            {
+                break;
+            }
+        }
+    }
+
+    // Four colors on a line are the two endpoints and the two
+    // interpolated entries, so BC1 and BC3 only lose the 5:6:5
+    // rounding. Alpha and BC5 ramps stay within half a step of the 8
+    // entry palette, at most 255 / 14 plus rounding
+    TEST_CASE(BlockCompression_RoundTripsGradientBlocks)
+    {
+        for (UINT uSeed = 0u; uSeed < 64u; ++uSeed)
+        {
+            RgbaBlock aRgba = createGradientBlock(uSeed);
+            RgbaBlock aOpaque = aRgba;
+            for (UINT j = 0u; j < BC_BLOCK_NUM_PIXELS; ++j)
+            {
+                aOpaque[j * 4u + 3u] = 255u;
+            }
+
+            RgbaBlock aBc1 = roundTrip(eCompressedFormat::BC1, aOpaque);
+            RgbaBlock aBc3 = roundTrip(eCompressedFormat::BC3, aRgba);
+            RgbaBlock aBc5 = roundTrip(eCompressedFormat::BC5, aRgba);
+            BOOL bPassed = CHECK(getMaxError(aOpaque.data(), aBc1.data(), BC_BLOCK_NUM_PIXELS, 0u, 4u) <= 8) &&
+                CHECK(getMaxError(aRgba.data(), aBc3.data(), BC_BLOCK_NUM_PIXELS, 0u, 3u) <= 8) &&
+                CHECK(getMaxError(aRgba.data(), aBc3.data(), BC_BLOCK_NUM_PIXELS, 3u, 1u) <= 20) &&
+                CHECK(getMaxError(aRgba.data(), aBc5.data(), BC_BLOCK_NUM_PIXELS, 0u, 2u) <= 20);
+            if (!bPassed)
+            {
+                break;
+            }
+        }
+    }
+
+    // A whole image keeps a PSNR in the range the formats reach on
+    // smooth content, and the pool writes the same blocks as the
+    // calling thread
+    TEST_CASE(BlockCompression_KeepsPsnrOnSmoothImage)
+    {
+        // Not a multiple of the block size, the edge blocks are partial
+        const UINT uWidth = 70u;
+        const UINT uHeight = 45u;
+        const UINT uNumPixels = uWidth * uHeight;
+        std::vector<BYTE> aRgba = createSmoothImage(uWidth, uHeight);
+        const SIZE_T uNumBlocks = static_cast<SIZE_T>((uWidth + 3u) / 4u) * ((uHeight + 3u) / 4u);
+
+        // BC1 would punch through the low alpha, it gets the image opaque
+        std::vector<BYTE> aOpaque = aRgba;
+        for (UINT i = 0u; i < uNumPixels; ++i)
+        {
+            aOpaque[i * 4u + 3u] = 255u;
+        }
+
+        ThreadPool threadPool(3u);
+        struct FormatCase
+        {
+            eCompressedFormat Format;
+            const std::vector<BYTE>* pSource;
+            FLOAT MinPsnr;
+        };
+        const FormatCase aCases[] =
+        {
+            { eCompressedFormat::BC1, &aOpaque, 38.0f },
+            { eCompressedFormat::BC3, &aRgba, 38.0f },
+            { eCompressedFormat::BC5, &aRgba, 48.0f },
+        };
+        for (const FormatCase& formatCase : aCases)
+        {
+            const std::vector<BYTE>& aSource = *formatCase.pSource;
+            std::vector<BYTE> aBlocks(uNumBlocks * GetBlockBytes(formatCase.Format));
+            std::vector<BYTE> aPooledBlocks(aBlocks.size());
+            CompressImage(formatCase.Format, aSource.data(), uWidth, uHeight, aBlocks.data(), nullptr);
+            CompressImage(formatCase.Format, aSource.data(), uWidth, uHeight, aPooledBlocks.data(), &threadPool);
+            CHECK(aBlocks == aPooledBlocks);
+
+            std::vector<BYTE> aDecoded(aSource.size());
+            DecompressImage(formatCase.Format, aBlocks.data(), uWidth, uHeight, aDecoded.data());
+            FLOAT psnr = ComputePsnr(aSource.data(), aDecoded.data(), uNumPixels, GetBlockNumChannels(formatCase.Format));
+            CHECK(psnr > formatCase.MinPsnr);
+        }
+    }
+
+    // Pixels below the alpha threshold switch BC1 to its 3 color mode
+    // and decode fully transparent, the others stay opaque
+    TEST_CASE(BlockCompression_Bc1KeepsPunchThroughAlpha)
+    {
+        RgbaBlock aRgba = createGradientBlock(7u);
+        for (UINT j = 0u; j < BC_BLOCK_NUM_PIXELS; ++j)
+        {
+            aRgba[j * 4u + 3u] = j % 3u == 0u ? 0u : 255u;
+        }
+
+        RgbaBlock aDecoded = roundTrip(eCompressedFormat::BC1, aRgba);
+        for (UINT j = 0u; j < BC_BLOCK_NUM_PIXELS; ++j)
+        {
+            if (!CHECK(aDecoded[j * 4u + 3u] == aRgba[j * 4u + 3u]))
+            {
+                break;
+            }
+        }
+    }
+}
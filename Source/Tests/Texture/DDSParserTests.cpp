@@ -0,0 +1,243 @@
+#include "TestFramework.h"
+
+#include "Texture/DDSParser.h"
+
+#include <cstring>
+#include <random>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT DDS_MAGIC_NUMBER = 0x20534444u;
+        constexpr const UINT FOURCC_DX10 = 0x30315844u;
+        constexpr const UINT FOURCC_DXT5 = 0x35545844u;
+
+        template <class T>
+        void appendBytes(_Inout_ std::vector<uint8_t>& aFile, _In_ const T& value)
+        {
+            const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(&value);
+            aFile.insert(aFile.end(), pBytes, pBytes + sizeof(T));
+        }
+
+        // A DDS file of the given format and layout with every mip
+        // present, legacy headers for a DXT5 fourCC and DX10 otherwise
+        std::vector<uint8_t> createDds(_In_ DXGI_FORMAT format, _In_ UINT uWidth, _In_ UINT uHeight, _In_ UINT uNumMips, _In_ UINT uArraySize, _In_ BOOL bCubeMap)
+        {
+            BOOL bLegacy = format == DXGI_FORMAT_BC3_UNORM;
+
+            DirectX::DDS_HEADER header = {};
+            header.size = sizeof(DirectX::DDS_HEADER);
+            header.flags = 0x00021007u;
+            header.width = uWidth;
+            header.height = uHeight;
+            header.mipMapCount = uNumMips;
+            header.ddspf.size = sizeof(DirectX::DDS_PIXELFORMAT);
+            header.ddspf.flags = 0x00000004u;
+            header.ddspf.fourCC = bLegacy ? FOURCC_DXT5 : FOURCC_DX10;
+            header.caps = 0x00401008u;
+
+            DirectX::DDS_HEADER_DXT10 headerDx10 =
+            {
+                .dxgiFormat = format,
+                .resourceDimension = DirectX::DDS_RESOURCE_DIMENSION_TEXTURE2D,
+                .miscFlag = bCubeMap ? 0x4u : 0u,
+                .arraySize = uArraySize,
+                .miscFlags2 = 0u
+            };
+
+            std::vector<uint8_t> aFile;
+            aFile.reserve(sizeof(UINT) + sizeof(header) + sizeof(headerDx10));
+            appendBytes(aFile, DDS_MAGIC_NUMBER);
+            appendBytes(aFile, header);
+            if (!bLegacy)
+            {
+                appendBytes(aFile, headerDx10);
+            }
+
+            UINT uNumItems = uArraySize * (bCubeMap ? 6u : 1u);
+            for (UINT uItem = 0u; uItem < uNumItems; ++uItem)
+            {
+                for (UINT uMip = 0u; uMip < uNumMips; ++uMip)
+                {
+                    size_t numBytes = 0u;
+                    DirectX::GetDDSSurfaceInfo(std::max(uWidth >> uMip, 1u), std::max(uHeight >> uMip, 1u), format, &numBytes, nullptr, nullptr);
+                    for (size_t i = 0u; i < numBytes; ++i)
+                    {
+                        aFile.push_back(static_cast<uint8_t>(uItem * 31u + uMip * 7u + i));
+                    }
+                }
+            }
+            return aFile;
+        }
+
+        // Parses and lays out a file the way the loaders do
+        HRESULT parse(_In_ const std::vector<uint8_t>& aFile, _In_ size_t maxSize, _Out_ DirectX::DDS_TEXTURE_DESC& outDesc, _Out_ std::vector<DirectX::DDS_SUBRESOURCE>& outSubresources, _Out_ size_t& outSkipMip)
+        {
+            outSubresources.clear();
+            outSkipMip = 0u;
+
+            HRESULT hr = DirectX::ParseDDSTexture(aFile.data(), aFile.size(), outDesc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            outSubresources.resize(outDesc.mipCount * outDesc.arraySize);
+            size_t width = 0u;
+            size_t height = 0u;
+            size_t depth = 0u;
+            hr = DirectX::GetDDSSubresources(outDesc, maxSize, width, height, depth, outSkipMip, outSubresources.data());
+            outSubresources.resize(SUCCEEDED(hr) ? (outDesc.mipCount - outSkipMip) * outDesc.arraySize : 0u);
+
+            return hr;
+        }
+
+        // Whether the bits and every subresource lie inside the file
+        BOOL isInBounds(_In_ const std::vector<uint8_t>& aFile, _In_ const DirectX::DDS_TEXTURE_DESC& desc, _In_ const std::vector<DirectX::DDS_SUBRESOURCE>& aSubresources)
+        {
+            if (desc.bitData < aFile.data() || desc.bitData + desc.bitSize != aFile.data() + aFile.size())
+            {
+                return FALSE;
+            }
+            for (const DirectX::DDS_SUBRESOURCE& subresource : aSubresources)
+            {
+                if (subresource.pData < desc.bitData ||
+                    static_cast<size_t>(subresource.pData - desc.bitData) + subresource.slicePitch * desc.depth > desc.bitSize)
+                {
+                    return FALSE;
+                }
+            }
+            return TRUE;
+        }
+    }
+
+    // The subresources of valid files follow each other without gaps
+    // and end at the end of the file, and maxsize skips the top mips
+    TEST_CASE(ParseDDSTexture_LaysOutSubresources)
+    {
+        struct Layout
+        {
+            DXGI_FORMAT Format;
+            UINT uWidth;
+            UINT uHeight;
+            UINT uNumMips;
+            UINT uArraySize;
+            BOOL bCubeMap;
+        };
+        const Layout aLayouts[] =
+        {
+            { DXGI_FORMAT_BC1_UNORM, 256u, 64u, 9u, 1u, FALSE },
+            { DXGI_FORMAT_BC3_UNORM, 60u, 20u, 6u, 1u, FALSE },
+            { DXGI_FORMAT_BC7_UNORM_SRGB, 128u, 128u, 8u, 3u, FALSE },
+            { DXGI_FORMAT_R8G8B8A8_UNORM, 32u, 32u, 6u, 1u, TRUE },
+        };
+
+        for (const Layout& layout : aLayouts)
+        {
+            std::vector<uint8_t> aFile = createDds(layout.Format, layout.uWidth, layout.uHeight, layout.uNumMips, layout.uArraySize, layout.bCubeMap);
+            DirectX::DDS_TEXTURE_DESC desc;
+            std::vector<DirectX::DDS_SUBRESOURCE> aSubresources;
+            size_t skipMip;
+            if (!CHECK(SUCCEEDED(parse(aFile, 0u, desc, aSubresources, skipMip))) || !CHECK(isInBounds(aFile, desc, aSubresources)))
+            {
+                break;
+            }
+
+            CHECK(desc.format == layout.Format && desc.width == layout.uWidth && desc.height == layout.uHeight);
+            CHECK(desc.mipCount == layout.uNumMips && desc.isCubeMap == layout.bCubeMap);
+            CHECK(desc.arraySize == layout.uArraySize * (layout.bCubeMap ? 6u : 1u));
+
+            const uint8_t* pExpected = desc.bitData;
+            for (const DirectX::DDS_SUBRESOURCE& subresource : aSubresources)
+            {
+                CHECK(subresource.pData == pExpected);
+                pExpected += subresource.slicePitch;
+            }
+            CHECK(pExpected == aFile.data() + aFile.size());
+
+            CHECK(SUCCEEDED(parse(aFile, std::max(layout.uWidth, layout.uHeight) / 4u, desc, aSubresources, skipMip)));
+            CHECK(skipMip == 2u);
+        }
+    }
+
+    // A file cut short anywhere, even by one byte, is rejected by the
+    // parse or the layout
+    TEST_CASE(ParseDDSTexture_RejectsTruncatedFiles)
+    {
+        for (DXGI_FORMAT format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT })
+        {
+            std::vector<uint8_t> aFile = createDds(format, 16u, 8u, 5u, 1u, FALSE);
+            for (size_t size = 0u; size < aFile.size(); ++size)
+            {
+                std::vector<uint8_t> aTruncated(aFile.begin(), aFile.begin() + size);
+
+                DirectX::DDS_TEXTURE_DESC desc;
+                std::vector<DirectX::DDS_SUBRESOURCE> aSubresources;
+                size_t skipMip;
+                if (!CHECK(FAILED(parse(aTruncated, 0u, desc, aSubresources, skipMip))))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    // Random bytes and extreme values written over the headers are
+    // either rejected or describe subresources inside the file
+    TEST_CASE(ParseDDSTexture_SurvivesCorruptedHeaders)
+    {
+        const std::vector<uint8_t> aFiles[] =
+        {
+            createDds(DXGI_FORMAT_BC1_UNORM, 32u, 16u, 6u, 1u, FALSE),
+            createDds(DXGI_FORMAT_BC3_UNORM, 16u, 16u, 5u, 1u, FALSE),
+            createDds(DXGI_FORMAT_BC7_UNORM, 16u, 16u, 3u, 2u, FALSE),
+            createDds(DXGI_FORMAT_R8G8B8A8_UNORM, 8u, 8u, 4u, 1u, TRUE),
+        };
+        const UINT aExtremes[] = { 0u, 1u, 2u, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu, 16384u, 16385u };
+
+        std::mt19937 generator(41u);
+        UINT uNumAccepted = 0u;
+        for (UINT i = 0u; i < 40000u; ++i)
+        {
+            std::vector<uint8_t> aFile = aFiles[i % ARRAYSIZE(aFiles)];
+            size_t headerSize = std::min<size_t>(aFile.size(), sizeof(UINT) + sizeof(DirectX::DDS_HEADER) + sizeof(DirectX::DDS_HEADER_DXT10));
+
+            UINT uNumMutations = 1u + generator() % 4u;
+            for (UINT uMutation = 0u; uMutation < uNumMutations; ++uMutation)
+            {
+                size_t offset = generator() % headerSize;
+                if (generator() % 2u)
+                {
+                    aFile[offset] = static_cast<uint8_t>(generator());
+                }
+                else
+                {
+                    offset = std::min(offset & ~size_t(3u), headerSize - sizeof(UINT));
+                    std::memcpy(&aFile[offset], &aExtremes[generator() % ARRAYSIZE(aExtremes)], sizeof(UINT));
+                }
+            }
+            if (generator() % 4u == 0u)
+            {
+                aFile.resize(generator() % aFile.size());
+            }
+
+            DirectX::DDS_TEXTURE_DESC desc;
+            std::vector<DirectX::DDS_SUBRESOURCE> aSubresources;
+            size_t skipMip;
+            if (FAILED(parse(aFile, generator() % 2u ? 0u : 8u, desc, aSubresources, skipMip)))
+            {
+                continue;
+            }
+            if (!CHECK(isInBounds(aFile, desc, aSubresources)))
+            {
+                break;
+            }
+            ++uNumAccepted;
+        }
+
+        // Enough mutations land on unused header bytes to exercise the
+        // accepting path too
+        CHECK(uNumAccepted > 1000u);
+    }
+}
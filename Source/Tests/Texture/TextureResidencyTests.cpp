@@ -0,0 +1,212 @@
+#include "TestFramework.h"
+
+#include "Texture/Texture.h"
+#include "Texture/TextureResidency.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT EVICTABLE_TEXTURE_SIZE = 512u;
+
+        D3D11_TEXTURE2D_DESC createDesc(_In_ DXGI_FORMAT format, _In_ UINT uSize, _In_ UINT uMipLevels, _In_ UINT uBindFlags)
+        {
+            return D3D11_TEXTURE2D_DESC
+            {
+                .Width = uSize,
+                .Height = uSize,
+                .MipLevels = uMipLevels,
+                .ArraySize = 1u,
+                .Format = format,
+                .SampleDesc = {.Count = 1u, .Quality = 0u },
+                .Usage = D3D11_USAGE_DEFAULT,
+                .BindFlags = uBindFlags,
+                .CPUAccessFlags = 0u,
+                .MiscFlags = 0u
+            };
+        }
+
+        // Texture with a full mip chain created on the device instead of
+        // loaded from a file, tracked by the default residency as loaded
+        // textures are
+        class ResidentTexture final : public Texture
+        {
+        public:
+            ResidentTexture()
+                : Texture(L"ResidentTexture")
+            {
+            }
+
+            HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override
+            {
+                UNREFERENCED_PARAMETER(pImmediateContext);
+
+                D3D11_TEXTURE2D_DESC desc = createDesc(DXGI_FORMAT_R8G8B8A8_UNORM, EVICTABLE_TEXTURE_SIZE, 0u, D3D11_BIND_SHADER_RESOURCE);
+                ComPtr<ID3D11Texture2D> texture;
+                HRESULT hr = pDevice->CreateTexture2D(&desc, nullptr, texture.GetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                hr = pDevice->CreateShaderResourceView(texture.Get(), nullptr, m_textureRV.GetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                updateResidentBytes();
+                return S_OK;
+            }
+        };
+
+        // Device that creates resources and draws nothing, enough for the
+        // residency to recreate textures with fewer mips
+        HRESULT createNullDevice(_Out_ ComPtr<ID3D11Device>& outDevice, _Out_ ComPtr<ID3D11DeviceContext>& outImmediateContext)
+        {
+            return D3D11CreateDevice(
+                nullptr,
+                D3D_DRIVER_TYPE_NULL,
+                nullptr,
+                0u,
+                nullptr,
+                0u,
+                D3D11_SDK_VERSION,
+                outDevice.GetAddressOf(),
+                nullptr,
+                outImmediateContext.GetAddressOf()
+            );
+        }
+    }
+
+    // Every mip, slice and sample counts, block compressed mips count
+    // whole 4x4 blocks
+    TEST_CASE(ComputeTextureBytes_CountsMipsAndBlocks)
+    {
+        D3D11_TEXTURE2D_DESC desc = createDesc(DXGI_FORMAT_R8G8B8A8_UNORM, 256u, 9u, D3D11_BIND_SHADER_RESOURCE);
+        CHECK(ComputeTextureBytes(desc) == 349524ull);
+
+        desc.ArraySize = 6u;
+        CHECK(ComputeTextureBytes(desc) == 6ull * 349524ull);
+
+        desc = createDesc(DXGI_FORMAT_BC1_UNORM, 64u, 7u, D3D11_BIND_SHADER_RESOURCE);
+        CHECK(ComputeTextureBytes(desc) == (256ull + 64ull + 16ull + 4ull + 1ull + 1ull + 1ull) * 8ull);
+
+        desc = createDesc(DXGI_FORMAT_R16G16B16A16_FLOAT, 100u, 1u, D3D11_BIND_RENDER_TARGET);
+        desc.SampleDesc.Count = 4u;
+        CHECK(ComputeTextureBytes(desc) == 100ull * 100ull * 8ull * 4ull);
+    }
+
+    // Render targets are counted apart from the budget, and nothing is
+    // evicted without a budget or without an evictable texture
+    TEST_CASE(TextureResidency_AccountsAgainstBudget)
+    {
+        TextureResidency residency(0ull);
+        const INT aOwners[3] = {};
+
+        D3D11_TEXTURE2D_DESC textureDesc = createDesc(DXGI_FORMAT_R8G8B8A8_UNORM, 256u, 9u, D3D11_BIND_SHADER_RESOURCE);
+        D3D11_TEXTURE2D_DESC renderTargetDesc = createDesc(DXGI_FORMAT_R8G8B8A8_UNORM, 1024u, 1u, D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE);
+        residency.Track(&aOwners[0], textureDesc);
+        residency.Track(&aOwners[1], textureDesc);
+        residency.Track(&aOwners[2], renderTargetDesc);
+
+        TextureResidencyReport report = residency.GetReport();
+        CHECK(report.ullTextureBytes == 2ull * 349524ull && report.uNumTextures == 2u);
+        CHECK(report.ullRenderTargetBytes == 1024ull * 1024ull * 4ull && report.uNumRenderTargets == 1u);
+        CHECK(report.aFormats.size() == 1u && report.aFormats[0].uNumAllocations == 3u);
+
+        for (UINT64 ullBudgetBytes : { 0ull, 1ull })
+        {
+            residency.SetBudget(ullBudgetBytes);
+            for (UINT uFrame = 0u; uFrame < 64u; ++uFrame)
+            {
+                residency.Update(nullptr);
+            }
+            report = residency.GetReport();
+            CHECK(report.uNumEvicted == 0u && report.uNumReducedTextures == 0u);
+        }
+        CHECK(residency.GetReport().ullFrame == 128ull);
+
+        // Recreating with other mips replaces the old size
+        textureDesc.MipLevels = 1u;
+        residency.Track(&aOwners[0], textureDesc);
+        residency.Untrack(&aOwners[1]);
+        residency.Untrack(&aOwners[2]);
+        report = residency.GetReport();
+        CHECK(report.ullTextureBytes == 256ull * 256ull * 4ull && report.uNumTextures == 1u);
+        CHECK(report.ullRenderTargetBytes == 0ull && report.uNumRenderTargets == 0u);
+    }
+
+    // Over the budget, the textures drawn longest ago lose top mips
+    // first, down to 64 texels, and a texture drawn in the last frames
+    // keeps all of them
+    TEST_CASE(TextureResidency_EvictsLeastRecentlyUsedFirst)
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        if (!CHECK(SUCCEEDED(createNullDevice(device, immediateContext))))
+        {
+            return;
+        }
+
+        TextureResidency& residency = TextureResidency::GetDefault();
+        const UINT64 ullPreviousBudgetBytes = residency.GetBudget();
+        const UINT64 ullPreviousTextureBytes = residency.GetReport().ullTextureBytes;
+        residency.SetBudget(0ull);
+        {
+            std::shared_ptr<Texture> aTextures[3];
+            for (std::shared_ptr<Texture>& texture : aTextures)
+            {
+                texture = std::make_shared<ResidentTexture>();
+                if (!CHECK(SUCCEEDED(texture->Initialize(device.Get(), immediateContext.Get()))))
+                {
+                    residency.SetBudget(ullPreviousBudgetBytes);
+                    return;
+                }
+            }
+
+            // The first is drawn for 5 frames, the second for 10 and the
+            // last every frame
+            for (UINT uFrame = 0u; uFrame < 40u; ++uFrame)
+            {
+                const UINT aNumUsedFrames[] = { 5u, 10u, 40u };
+                for (UINT i = 0u; i < ARRAYSIZE(aTextures); ++i)
+                {
+                    if (uFrame < aNumUsedFrames[i])
+                    {
+                        residency.MarkUsed(aTextures[i].get());
+                    }
+                }
+                residency.Update(immediateContext.Get());
+            }
+            CHECK(residency.GetReport().uNumEvicted == 0u);
+
+            // One byte over costs the oldest one mip
+            residency.SetBudget(residency.GetReport().ullTextureBytes - 1ull);
+            residency.MarkUsed(aTextures[2].get());
+            residency.Update(immediateContext.Get());
+
+            TextureResidencyReport report = residency.GetReport();
+            CHECK(report.uNumEvicted == 1u && report.ullEvictedBytes == 1048576ull);
+            CHECK(aTextures[0]->GetNumDroppedMips() == 1u);
+            CHECK(aTextures[1]->GetNumDroppedMips() == 0u && aTextures[2]->GetNumDroppedMips() == 0u);
+
+            // The oldest stops at 64x64, two mips more, and the next
+            // oldest covers the rest
+            residency.SetBudget(residency.GetReport().ullTextureBytes - 400000ull);
+            residency.MarkUsed(aTextures[2].get());
+            residency.Update(immediateContext.Get());
+
+            report = residency.GetReport();
+            CHECK(report.uNumEvicted == 2u && report.uNumReducedTextures == 2u);
+            CHECK(aTextures[0]->GetNumDroppedMips() == 3u && aTextures[0]->GetResidentBytes() == 21844ull);
+            CHECK(aTextures[1]->GetNumDroppedMips() == 1u);
+            CHECK(aTextures[2]->GetNumDroppedMips() == 0u);
+            CHECK(report.ullTextureBytes <= report.ullBudgetBytes);
+        }
+
+        // Released textures leave the residency
+        CHECK(residency.GetReport().ullTextureBytes == ullPreviousTextureBytes);
+        residency.SetBudget(ullPreviousBudgetBytes);
+    }
+}
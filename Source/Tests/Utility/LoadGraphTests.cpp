@@ -0,0 +1,133 @@
+#include "TestFramework.h"
+
+#include "Utility/LoadGraph.h"
+
+#include <atomic>
+#include <thread>
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   TaskLog
+
+          Summary:  Order and thread every task of a graph ran on
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct TaskLog
+        {
+            std::atomic<UINT> uNextSlot{ 1u };
+            UINT aSlots[16] = {};
+            std::thread::id aThreads[16];
+        };
+
+        std::function<HRESULT()> logTask(_Inout_ TaskLog& log, _In_ UINT uTask, _In_ HRESULT hr = S_OK)
+        {
+            return [&log, uTask, hr]()
+            {
+                log.aThreads[uTask] = std::this_thread::get_id();
+                log.aSlots[uTask] = log.uNextSlot++;
+                return hr;
+            };
+        }
+
+        // Two parsed models, each created on the device, and a shader
+        // compile the second model also waits for:
+        //   0 parse A (worker) -> 1 create A (device)
+        //   2 parse B (worker) -> 4 create B (device)
+        //   3 compile (worker) -> 4, 5 create shaders (device)
+        void buildSceneGraph(_Inout_ LoadGraph& graph, _Inout_ TaskLog& log, _In_ HRESULT hrParseB = S_OK)
+        {
+            graph.AddTask(L"parse A", eLoadQueue::WORKER, logTask(log, 0u));
+            graph.AddTask(L"create A", eLoadQueue::DEVICE, logTask(log, 1u));
+            graph.AddTask(L"parse B", eLoadQueue::WORKER, logTask(log, 2u, hrParseB));
+            graph.AddTask(L"compile", eLoadQueue::WORKER, logTask(log, 3u));
+            graph.AddTask(L"create B", eLoadQueue::DEVICE, logTask(log, 4u));
+            graph.AddTask(L"create shaders", eLoadQueue::DEVICE, logTask(log, 5u));
+            graph.AddDependency(1u, 0u);
+            graph.AddDependency(4u, 2u);
+            graph.AddDependency(4u, 3u);
+            graph.AddDependency(5u, 3u);
+        }
+    }
+
+    // Tasks start after their dependencies, with and without a pool, and
+    // DEVICE tasks always run on the thread calling Run
+    TEST_CASE(LoadGraph_RunsDependenciesFirst)
+    {
+        ThreadPool threadPool(3u);
+        for (ThreadPool* pThreadPool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+        {
+            TaskLog log;
+            LoadGraph graph;
+            buildSceneGraph(graph, log);
+
+            CHECK(graph.GetNumTasks() == 6u);
+            CHECK(SUCCEEDED(graph.Run(pThreadPool, nullptr)));
+
+            for (UINT i = 0u; i < 6u; ++i)
+            {
+                CHECK(log.aSlots[i] != 0u);
+            }
+            CHECK(log.aSlots[1] > log.aSlots[0]);
+            CHECK(log.aSlots[4] > log.aSlots[2] && log.aSlots[4] > log.aSlots[3]);
+            CHECK(log.aSlots[5] > log.aSlots[3]);
+
+            std::thread::id callingThread = std::this_thread::get_id();
+            CHECK(log.aThreads[1] == callingThread && log.aThreads[4] == callingThread && log.aThreads[5] == callingThread);
+        }
+    }
+
+    // The progress callback sees every task exactly once, in order of
+    // completion, on the calling thread
+    TEST_CASE(LoadGraph_ReportsProgress)
+    {
+        ThreadPool threadPool(2u);
+        TaskLog log;
+        LoadGraph graph;
+        buildSceneGraph(graph, log);
+
+        UINT uNumCalls = 0u;
+        BOOL bInOrder = TRUE;
+        std::thread::id callingThread = std::this_thread::get_id();
+        graph.Run(
+            &threadPool,
+            [&](UINT uNumDone, UINT uNumTasks, PCWSTR pszTaskName)
+            {
+                bInOrder = bInOrder && uNumDone == ++uNumCalls && uNumTasks == 6u && pszTaskName && std::this_thread::get_id() == callingThread;
+            }
+        );
+
+        CHECK(uNumCalls == 6u);
+        CHECK(bInOrder);
+    }
+
+    // A failed task returns its error and its dependents are skipped
+    // but still reported, so the progress reaches the end
+    TEST_CASE(LoadGraph_FailureSkipsDependents)
+    {
+        ThreadPool threadPool(3u);
+        for (ThreadPool* pThreadPool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+        {
+            TaskLog log;
+            LoadGraph graph;
+            buildSceneGraph(graph, log, E_INVALIDARG);
+
+            UINT uLastDone = 0u;
+            HRESULT hr = graph.Run(
+                pThreadPool,
+                [&](UINT uNumDone, UINT uNumTasks, PCWSTR pszTaskName)
+                {
+                    UNREFERENCED_PARAMETER(uNumTasks);
+                    UNREFERENCED_PARAMETER(pszTaskName);
+                    uLastDone = uNumDone;
+                }
+            );
+
+            CHECK(hr == E_INVALIDARG);
+            CHECK(uLastDone == 6u);
+            CHECK(log.aSlots[2] != 0u);
+            CHECK(log.aSlots[4] == 0u);
+        }
+    }
+}
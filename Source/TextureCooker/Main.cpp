@@ -0,0 +1,208 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Command line tool that cooks source images into mipmapped,
+             block compressed DDS files next to them, and reports the
+             encoding throughput and PSNR of each
+
+  Usage:     TextureCooker [--format auto|bc1|bc3|bc5|bc7] [--srgb]
+                           [--alpha-coverage] [--force]
+                           <image or directory>...
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cwctype>
+
+#include "Texture/TextureCooker.h"
+#include "Utility/ThreadPool.h"
+
+namespace
+{
+    constexpr PCWSTR FORMAT_NAMES[] = { L"bc1", L"bc3", L"bc4", L"bc5", L"bc7" };
+    constexpr PCWSTR SOURCE_EXTENSIONS[] = { L".png", L".jpg", L".jpeg", L".bmp", L".tif", L".tiff", L".gif" };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: isSourceImage
+
+      Summary:  Returns whether a file is an image WIC can decode
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+
+      Returns:  BOOL
+                  TRUE if the extension is a source image
+    -----------------------------------------------------------------F-F*/
+    BOOL isSourceImage(_In_ const std::filesystem::path& filePath)
+    {
+        std::wstring szExtension = filePath.extension().wstring();
+        std::transform(szExtension.begin(), szExtension.end(), szExtension.begin(), [](WCHAR c) { return static_cast<WCHAR>(std::towlower(c)); });
+
+        for (PCWSTR pszSourceExtension : SOURCE_EXTENSIONS)
+        {
+            if (szExtension == pszSourceExtension)
+            {
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printUsage
+
+      Summary:  Writes the command line usage to the console
+    -----------------------------------------------------------------F-F*/
+    void printUsage()
+    {
+        wprintf(
+            L"Usage: TextureCooker [--format auto|bc1|bc3|bc5|bc7] [--srgb] [--alpha-coverage] [--force] <image or directory>...\n"
+            L"  --format          Block compression, auto picks BC5 for normal maps,\n"
+            L"                    BC1 for opaque and BC7 for transparent images\n"
+            L"  --srgb            Create the textures as sRGB\n"
+            L"  --alpha-coverage  Keep the alpha tested coverage in every mip\n"
+            L"  --force           Cook images whose cooked texture is current\n"
+        );
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+
+  Summary:  Entry point of the tool. Cooks every image given and every
+            image under the directories given, skipping the ones whose
+            cooked texture is current
+
+  Args:     INT argc
+              Number of arguments
+            WCHAR* argv[]
+              Arguments
+
+  Returns:  INT
+              0 if every image was cooked, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+    library::TextureCookOptions options = library::DEFAULT_TEXTURE_COOK_OPTIONS;
+    BOOL bForce = FALSE;
+    std::vector<std::filesystem::path> aSourcePaths;
+
+    for (INT i = 1; i < argc; ++i)
+    {
+        std::wstring szArgument = argv[i];
+        if (szArgument == L"--format" && i + 1 < argc)
+        {
+            std::wstring szFormat = argv[++i];
+            options.bChooseFormat = szFormat == L"auto";
+            if (!options.bChooseFormat)
+            {
+                auto it = std::find(std::begin(FORMAT_NAMES), std::end(FORMAT_NAMES), szFormat);
+                if (it == std::end(FORMAT_NAMES))
+                {
+                    printUsage();
+                    return 1;
+                }
+                options.Format = static_cast<library::eCompressedFormat>(it - std::begin(FORMAT_NAMES));
+            }
+        }
+        else if (szArgument == L"--srgb")
+        {
+            options.bSrgb = TRUE;
+        }
+        else if (szArgument == L"--alpha-coverage")
+        {
+            options.bPreserveAlphaCoverage = TRUE;
+        }
+        else if (szArgument == L"--force")
+        {
+            bForce = TRUE;
+        }
+        else if (szArgument.starts_with(L"--"))
+        {
+            printUsage();
+            return 1;
+        }
+        else if (std::filesystem::is_directory(szArgument))
+        {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(szArgument))
+            {
+                if (entry.is_regular_file() && isSourceImage(entry.path()))
+                {
+                    aSourcePaths.push_back(entry.path());
+                }
+            }
+        }
+        else
+        {
+            aSourcePaths.push_back(szArgument);
+        }
+    }
+
+    if (aSourcePaths.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // WIC is created through COM
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(hr))
+    {
+        return 1;
+    }
+
+    library::ThreadPool& threadPool = library::ThreadPool::GetDefault();
+    wprintf(L"Cooking %zu images on %u threads\n", aSourcePaths.size(), threadPool.GetNumThreads());
+
+    UINT uNumFailed = 0u;
+    UINT64 ullUncompressedBytes = 0ull;
+    UINT64 ullCookedBytes = 0ull;
+    for (const std::filesystem::path& sourcePath : aSourcePaths)
+    {
+        if (!bForce && library::IsCookedTextureCurrent(sourcePath))
+        {
+            wprintf(L"%s: up to date\n", sourcePath.c_str());
+            continue;
+        }
+
+        library::TextureCookStats stats;
+        hr = library::CookTexture(sourcePath, options, &threadPool, &stats);
+        if (FAILED(hr))
+        {
+            wprintf(L"%s: failed (0x%08X)\n", sourcePath.c_str(), static_cast<UINT>(hr));
+            ++uNumFailed;
+            continue;
+        }
+
+        wprintf(
+            L"%s: %ux%u %s, %u mips, %.2f MB -> %.2f MB, mips %.1f ms, %.1f ms (%.1f MPix/s), PSNR %.2f dB\n",
+            sourcePath.c_str(),
+            stats.uWidth,
+            stats.uHeight,
+            FORMAT_NAMES[static_cast<UINT>(stats.Format)],
+            stats.uNumMips,
+            static_cast<FLOAT>(stats.ullUncompressedBytes) / (1024.0f * 1024.0f),
+            static_cast<FLOAT>(stats.ullCookedBytes) / (1024.0f * 1024.0f),
+            stats.MipMilliseconds,
+            stats.EncodeMilliseconds,
+            stats.MegapixelsPerSecond,
+            stats.Psnr
+        );
+        ullUncompressedBytes += stats.ullUncompressedBytes;
+        ullCookedBytes += stats.ullCookedBytes;
+    }
+
+    wprintf(
+        L"Cooked %.2f MB of mips into %.2f MB, %u failed\n",
+        static_cast<FLOAT>(ullUncompressedBytes) / (1024.0f * 1024.0f),
+        static_cast<FLOAT>(ullCookedBytes) / (1024.0f * 1024.0f),
+        uNumFailed
+    );
+
+    CoUninitialize();
+    return uNumFailed > 0u ? 1 : 0;
+}